@@ -12,6 +12,8 @@ extern "C" {
 #include "c_cdd_export.h"
 /* clang-format on */
 
+struct ProjectIndex;
+
 /**
  * @brief Configuration for transformations.
  */
@@ -22,6 +24,7 @@ typedef struct cdd_transform_config_t {
                                  of alloca */
   int target_c89;             /**< If 1, strictly target C89 semantics. */
   int target_c99;             /**< If 1, target C99 semantics. */
+  const struct ProjectIndex *project_index; /**< Cross-file facts, or NULL */
 } cdd_transform_config_t;
 
 /**
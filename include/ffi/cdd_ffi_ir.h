@@ -71,12 +71,17 @@ typedef struct cdd_ffi_type_t {
   int pointer_depth;
   /** @brief Name of the struct/enum/typedef if applicable */
   char *ref_name;
-  /** @brief If it's an array, the fixed size (-1 if dynamic/unknown) */
+  /** @brief If it's an array, the fixed size (-1 if dynamic/unknown, e.g. a
+   * flexible array member) */
   long array_size;
   /** @brief Template parameters (if CDD_FFI_KIND_TEMPLATE_STRUCT_REF) */
   struct cdd_ffi_type_t *template_args;
   /** @brief Number of template parameters */
   size_t template_args_count;
+  /** @brief Declared C spelling of a struct member whose width depends on
+   * the ABI (`long`, `size_t`) or that names another type; only the layout
+   * engine reads it, `kind`/`ref_name` keep the schema-derived type */
+  char *c_name;
 } cdd_ffi_type_t;
 
 /**
@@ -106,6 +111,8 @@ typedef struct cdd_ffi_field_t {
   /** @brief Reference to another field defining the array length (if
    * applicable) */
   char *array_length_ref;
+  /** @brief Bit-field width (struct/union members), 0 if not a bit-field */
+  int bit_width;
 } cdd_ffi_field_t;
 
 /**
@@ -236,6 +243,10 @@ typedef struct cdd_ffi_ir_t {
   size_t nodes_count;
   /** @brief Capacity of the nodes array */
   size_t nodes_capacity;
+  /** @brief Every file merged into the IR, the input first (may be NULL) */
+  char **sources;
+  /** @brief Number of source paths */
+  size_t sources_count;
 } cdd_ffi_ir_t;
 
 /**
@@ -246,6 +257,49 @@ typedef struct cdd_ffi_ir_t {
  */
 C_CDD_EXPORT cdd_c_error_t cdd_ffi_ir_topological_sort(cdd_ffi_ir_t *ir);
 
+/**
+ * @brief Reports whether a parameter name reads like an element count.
+ *
+ * Matches `n`, `len`, `length`, `count`, `size`, `nelem`, `num`, the
+ * `num_` / `n_` prefixes and the `_len` / `_length` / `_count` / `_size` /
+ * `_n` suffixes.
+ * @param name The parameter name (may be NULL).
+ * @return 1 if length-like, 0 otherwise.
+ */
+C_CDD_EXPORT int cdd_ffi_is_length_name(const char *name);
+
+/**
+ * @brief Finds the element count paired with a pointer parameter.
+ *
+ * Parameter `j` is a buffer when it is a single-level, non-array pointer
+ * and either its `array_length_ref` names an integral parameter of `fn`,
+ * or, with no `array_length_ref`, the parameter right after it is integral
+ * with a length-like name, as in `(T *data, size_t n)`.
+ * @param fn The function node.
+ * @param j The index of the pointer parameter.
+ * @return The index of the length parameter, or -1 if `j` is no buffer.
+ */
+C_CDD_EXPORT long cdd_ffi_buffer_length_index(const cdd_ffi_ir_node_t *fn,
+                                              size_t j);
+
+/**
+ * @brief Reports whether parameter `k` carries the length of some buffer
+ * parameter of `fn`, so emitters taking a whole buffer can drop it.
+ * @param fn The function node.
+ * @param k The parameter index.
+ * @return 1 if it is a buffer length, 0 otherwise.
+ */
+C_CDD_EXPORT int cdd_ffi_is_buffer_length(const cdd_ffi_ir_node_t *fn,
+                                          size_t k);
+
+/**
+ * @brief Records every pointer+length pair found by naming convention as
+ * the pointer's `array_length_ref`, so all emitters see the same pairing.
+ * @param ir The IR to annotate.
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_ffi_ir_infer_buffers(cdd_ffi_ir_t *ir);
+
 /**
  * @brief Frees all memory associated with the FFI IR.
  * @param ir The IR to free.
@@ -3,6 +3,7 @@
 #include "cdd_api.h"
 #include "functions/parse/cst.h"
 #include "functions/parse/fs.h"
+#include "functions/parse/parallel.h"
 
 #ifdef CDD_BUILD_TESTS
 #endif
@@ -21,6 +22,7 @@
 #include "functions/ffi/cdd_ffi_emit_cpp.h"
 #include "functions/ffi/cdd_ffi_emit_crystal.h"
 #include "functions/ffi/cdd_ffi_emit_csharp.h"
+#include "functions/ffi/cdd_ffi_emit_csharp_libimport.h"
 #include "functions/ffi/cdd_ffi_emit_d.h"
 #include "functions/ffi/cdd_ffi_emit_dart.h"
 #include "functions/ffi/cdd_ffi_emit_delphi.h"
@@ -32,6 +34,7 @@
 #include "functions/ffi/cdd_ffi_emit_groovy.h"
 #include "functions/ffi/cdd_ffi_emit_haskell.h"
 #include "functions/ffi/cdd_ffi_emit_java.h"
+#include "functions/ffi/cdd_ffi_emit_java_ffm.h"
 #include "functions/ffi/cdd_ffi_emit_julia.h"
 #include "functions/ffi/cdd_ffi_emit_kotlin.h"
 #include "functions/ffi/cdd_ffi_emit_lua.h"
@@ -44,6 +47,7 @@
 #include "functions/ffi/cdd_ffi_emit_perl.h"
 #include "functions/ffi/cdd_ffi_emit_php.h"
 #include "functions/ffi/cdd_ffi_emit_python.h"
+#include "functions/ffi/cdd_ffi_emit_python_capi.h"
 #include "functions/ffi/cdd_ffi_emit_r.h"
 #include "functions/ffi/cdd_ffi_emit_racket.h"
 #include "functions/ffi/cdd_ffi_emit_ruby.h"
@@ -56,12 +60,14 @@
 #include "functions/ffi/cdd_ffi_emit_vlang.h"
 #include "functions/ffi/cdd_ffi_emit_webassembly.h"
 #include "functions/ffi/cdd_ffi_emit_zig.h"
+#include "functions/ffi/cdd_ffi_ir_cache.h"
 #include "functions/ffi/cdd_ffi_ir_extractor.h"
 /* clang-format on */
 #ifdef CDD_BUILD_TESTS
 C_CDD_EXPORT int g_cdd_fail_alloc = 0;
 C_CDD_EXPORT int g_cdd_fprintf_fail = 0;
 C_CDD_EXPORT int g_cdd_mock_dlopen_success = 0;
+extern volatile int g_fail_io_after;
 #endif
 
 #define MAX_ARGS 32
@@ -193,10 +199,288 @@ static cdd_c_error_t has_lang(const char *langs, const char *lang,
   return CDD_C_SUCCESS;
 }
 
+/**
+ * @brief Signature shared by every `cdd_ffi_emit_*` backend.
+ */
+typedef cdd_c_error_t (*cdd_ffi_emit_fn)(
+    cdd_ffi_ir_t *ir, const cdd_generate_bindings_config_t *config);
+
+/**
+ * @brief A bindings backend selectable through `target_langs`.
+ */
+struct BindingsEmitter {
+  const char *name;     /**< Name matched in `target_langs` */
+  const char *alias;    /**< Alternative name, or NULL */
+  int in_all;           /**< Whether "all" / "*" selects it */
+  cdd_ffi_emit_fn emit; /**< The backend */
+};
+
+/**
+ * @brief Every emitter, in commit order.
+ *
+ * Emitters that write the same file (`csharp` and `csharp-libraryimport`)
+ * resolve exactly as a serial run would: the later entry wins.
+ */
+static const struct BindingsEmitter bindings_emitters[] = {
+    {"python", NULL, 1, cdd_ffi_emit_python},
+    {"python-capi", NULL, 1, cdd_ffi_emit_python_capi},
+    {"rust", NULL, 1, cdd_ffi_emit_rust},
+    {"csharp", NULL, 1, cdd_ffi_emit_csharp},
+    {"csharp-libraryimport", NULL, 0, cdd_ffi_emit_csharp_libimport},
+    {"typescript", NULL, 1, cdd_ffi_emit_typescript},
+    {"napi", NULL, 1, cdd_ffi_emit_napi},
+    {"java", NULL, 1, cdd_ffi_emit_java},
+    {"java-ffm", NULL, 1, cdd_ffi_emit_java_ffm},
+    {"cpp", NULL, 1, cdd_ffi_emit_cpp},
+    {"go", NULL, 1, cdd_ffi_emit_go},
+    {"swift", NULL, 1, cdd_ffi_emit_swift},
+    {"dart", NULL, 1, cdd_ffi_emit_dart},
+    {"ruby", NULL, 1, cdd_ffi_emit_ruby},
+    {"kotlin", NULL, 1, cdd_ffi_emit_kotlin},
+    {"php", NULL, 1, cdd_ffi_emit_php},
+    {"lua", NULL, 1, cdd_ffi_emit_lua},
+    {"zig", NULL, 1, cdd_ffi_emit_zig},
+    {"odin", NULL, 1, cdd_ffi_emit_odin},
+    {"julia", NULL, 1, cdd_ffi_emit_julia},
+    {"r", NULL, 1, cdd_ffi_emit_r},
+    {"matlab", NULL, 1, cdd_ffi_emit_matlab},
+    {"haskell", NULL, 1, cdd_ffi_emit_haskell},
+    {"ocaml", NULL, 1, cdd_ffi_emit_ocaml},
+    {"elixir", NULL, 1, cdd_ffi_emit_elixir},
+    {"erlang", NULL, 1, cdd_ffi_emit_erlang},
+    {"common_lisp", NULL, 1, cdd_ffi_emit_common_lisp},
+    {"racket", NULL, 1, cdd_ffi_emit_racket},
+    {"scheme", NULL, 1, cdd_ffi_emit_scheme},
+    {"scala", NULL, 1, cdd_ffi_emit_scala},
+    {"fsharp", NULL, 1, cdd_ffi_emit_fsharp},
+    {"clojure", NULL, 1, cdd_ffi_emit_clojure},
+    {"groovy", NULL, 1, cdd_ffi_emit_groovy},
+    {"webassembly", "wasm", 1, cdd_ffi_emit_webassembly},
+    {"nim", NULL, 1, cdd_ffi_emit_nim},
+    {"vlang", NULL, 1, cdd_ffi_emit_vlang},
+    {"dlang", NULL, 1, cdd_ffi_emit_d},
+    {"perl", NULL, 1, cdd_ffi_emit_perl},
+    {"tcl", NULL, 1, cdd_ffi_emit_tcl},
+    {"fortran", NULL, 1, cdd_ffi_emit_fortran},
+    {"delphi", "pascal", 1, cdd_ffi_emit_delphi},
+    {"ada", NULL, 1, cdd_ffi_emit_ada},
+    {"objc", "objective-c", 1, cdd_ffi_emit_objc},
+    {"crystal", NULL, 1, cdd_ffi_emit_crystal}};
+
+/** @brief Number of entries in `bindings_emitters`. */
+#define BINDINGS_N_EMITTERS                                                    \
+  (sizeof(bindings_emitters) / sizeof(bindings_emitters[0]))
+
+/** @brief Prefix of the per-emitter staging directories in `output_dir`. */
+#define BINDINGS_STAGE_PREFIX ".cdd-stage-"
+
+/**
+ * @brief One selected emitter and its outcome.
+ */
+struct BindingsJob {
+  const struct BindingsEmitter *emitter; /**< Backend to run */
+  char *stage_dir;                       /**< Private output directory */
+  cdd_c_error_t rc;                      /**< Result of the backend */
+  double elapsed_ms;                     /**< Wall time the backend took */
+};
+
+/**
+ * @brief State shared by the emitter workers; read-only while they run.
+ */
+struct BindingsRun {
+  cdd_ffi_ir_t *ir;                             /**< Sorted FFI IR */
+  const cdd_generate_bindings_config_t *config; /**< Caller's config */
+  struct BindingsJob *jobs;                     /**< Selected emitters */
+};
+
+/**
+ * @brief A staging directory being drained.
+ */
+struct BindingsStage {
+  size_t stage_len;       /**< Length of the staging directory's path */
+  const char *output_dir; /**< Where entries move to; NULL discards them */
+};
+
+/**
+ * @brief Decide whether `target_langs` selects an emitter.
+ */
+static cdd_c_error_t bindings_selected(const struct BindingsEmitter *emitter,
+                                       const char *langs, int *out_selected) {
+  cdd_c_error_t rc;
+
+  *out_selected = emitter->in_all &&
+                  (strcmp(langs, "all") == 0 || strcmp(langs, "*") == 0);
+  if (*out_selected)
+    return CDD_C_SUCCESS;
+  rc = has_lang(langs, emitter->name, out_selected);
+  if (rc == CDD_C_SUCCESS && !*out_selected && emitter->alias)
+    rc = has_lang(langs, emitter->alias, out_selected);
+  return rc;
+}
+
+/**
+ * @brief Map a path inside the staging directory to `output_dir`.
+ */
+static cdd_c_error_t bindings_stage_target(const struct BindingsStage *st,
+                                           const char *path, char **out) {
+  const char *rel = path + st->stage_len;
+
+  *out = (char *)C_CDD_MALLOC(strlen(st->output_dir) + strlen(rel) + 1);
+  if (!*out)
+    return CDD_C_ERROR_MEMORY;
+  sprintf(*out, "%s%s", st->output_dir, rel);
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Move (or delete) one staged file.
+ */
+static cdd_c_error_t bindings_stage_file_cb(const char *path,
+                                            void *user_data) {
+  const struct BindingsStage *st = (const struct BindingsStage *)user_data;
+  char *dst = NULL;
+  char *dir = NULL;
+  cdd_c_error_t rc;
+
+  if (!st->output_dir) {
+    /* Best effort: a failed run must not mask its own error */
+    (void)remove(path);
+    return CDD_C_SUCCESS;
+  }
+
+  rc = bindings_stage_target(st, path, &dst);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  /* Directories are reported after their contents, so create it here */
+  rc = get_dirname(dst, &dir);
+  if (rc == CDD_C_SUCCESS) {
+    rc = makedirs(dir);
+    C_CDD_FREE(dir);
+  }
+  if (rc == CDD_C_SUCCESS)
+    rc = fs_replace_file(dst, path);
+  C_CDD_FREE(dst);
+  return rc;
+}
+
+/**
+ * @brief Mirror one (now empty) staged directory, then remove it.
+ */
+static cdd_c_error_t bindings_stage_dir_cb(const char *path, void *user_data) {
+  const struct BindingsStage *st = (const struct BindingsStage *)user_data;
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+
+  if (st->output_dir) {
+    char *dst = NULL;
+    rc = bindings_stage_target(st, path, &dst);
+    if (rc == CDD_C_SUCCESS) {
+      /* Emitters may leave empty directories (e.g. rust's `tests/`) */
+      rc = makedirs(dst);
+      C_CDD_FREE(dst);
+    }
+  }
+  (void)rmdir(path);
+  return rc;
+}
+
+/**
+ * @brief Empty a staging directory into `output_dir` (or discard its
+ * contents when `output_dir` is NULL), then remove it.
+ */
+static cdd_c_error_t bindings_stage_drain(const char *stage_dir,
+                                          const char *output_dir) {
+  struct BindingsStage st;
+  cdd_c_error_t rc;
+
+  st.stage_len = strlen(stage_dir);
+  st.output_dir = output_dir;
+  rc = walk_directory_post(stage_dir, bindings_stage_file_cb,
+                           bindings_stage_dir_cb, &st);
+  (void)rmdir(stage_dir);
+  return rc;
+}
+
+/**
+ * @brief Create an empty staging directory for `name` inside `output_dir`.
+ */
+static cdd_c_error_t bindings_stage_create(const char *output_dir,
+                                           const char *name, char **out_dir) {
+  char *dir;
+  int is_dir = 0;
+  cdd_c_error_t rc;
+
+  dir = (char *)C_CDD_MALLOC(strlen(output_dir) + sizeof(PATH_SEP) +
+                             sizeof(BINDINGS_STAGE_PREFIX) + strlen(name));
+  if (!dir)
+    return CDD_C_ERROR_MEMORY;
+  sprintf(dir, "%s" PATH_SEP BINDINGS_STAGE_PREFIX "%s", output_dir, name);
+
+  /* Left behind by an interrupted run */
+  if (fs_is_directory(dir, &is_dir) == CDD_C_SUCCESS && is_dir)
+    (void)bindings_stage_drain(dir, NULL);
+
+  rc = makedir(dir);
+  if (rc != CDD_C_SUCCESS) {
+    C_CDD_FREE(dir);
+    return rc;
+  }
+  *out_dir = dir;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Worker body: run one emitter into its staging directory.
+ */
+static cdd_c_error_t bindings_emit_cb(size_t index, void *user_data) {
+  struct BindingsRun *run = (struct BindingsRun *)user_data;
+  struct BindingsJob *job = &run->jobs[index];
+  cdd_generate_bindings_config_t staged = *run->config;
+  double start_ms = 0, end_ms = 0;
+
+  staged.output_dir = job->stage_dir;
+  (void)cdd_parallel_clock_ms(&start_ms);
+  job->rc = job->emitter->emit(run->ir, &staged);
+  (void)cdd_parallel_clock_ms(&end_ms);
+  job->elapsed_ms = end_ms - start_ms;
+  return job->rc;
+}
+
+/**
+ * @brief Print the `--stats` report.
+ */
+static cdd_c_error_t bindings_print_stats(const struct BindingsJob *jobs,
+                                          size_t n_jobs, size_t n_threads,
+                                          double ir_ms, int ir_cached,
+                                          double emit_ms, double total_ms) {
+  double sum_ms = 0;
+  size_t i;
+
+  printf("Emitter timings (%lu threads):\n", (unsigned long)n_threads);
+  printf("  %-22s %10.3f ms\n", ir_cached ? "IR (cached)" : "IR (extracted)",
+         ir_ms);
+  for (i = 0; i < n_jobs; ++i) {
+    printf("  %-22s %10.3f ms%s\n", jobs[i].emitter->name, jobs[i].elapsed_ms,
+           jobs[i].rc != CDD_C_SUCCESS ? "  (failed)" : "");
+    sum_ms += jobs[i].elapsed_ms;
+  }
+  printf("  %-22s %10.3f ms\n", "sum of emitters", sum_ms);
+  printf("  %-22s %10.3f ms\n", "emit (wall)", emit_ms);
+  printf("  %-22s %10.3f ms\n", "total (wall)", total_ms);
+  return CDD_C_SUCCESS;
+}
+
 cdd_c_error_t
 cdd_generate_bindings(const cdd_generate_bindings_config_t *config) {
+  struct BindingsJob jobs[BINDINGS_N_EMITTERS];
+  struct BindingsRun run;
+  size_t n_jobs = 0;
+  size_t n_threads = 0;
+  size_t i;
+  double start_ms = 0, ir_end_ms = 0, emit_start_ms = 0, emit_end_ms = 0,
+         end_ms = 0;
 
   cdd_ffi_ir_t *ir = NULL;
+  int ir_cached = 0;
   int rc;
 
   char *file_content = NULL;
@@ -206,6 +490,7 @@ cdd_generate_bindings(const cdd_generate_bindings_config_t *config) {
       !config->target_langs) {
     return CDD_C_ERROR_UNKNOWN; /* EINVAL */
   }
+  (void)cdd_parallel_clock_ms(&start_ms);
 
   /* Read file to string */
   rc = read_to_file(config->input, "rb", &file_content, &file_size);
@@ -213,675 +498,115 @@ cdd_generate_bindings(const cdd_generate_bindings_config_t *config) {
     return rc;
   }
 
-  /* Extract exports into FFI IR */
-  rc = cdd_ffi_ir_extract_exports(config->input, file_content, config, &ir);
-  if (rc != 0) {
-    C_CDD_FREE(file_content);
-    return rc;
-  }
-
-  /* Sort IR dependencies */
-  rc = cdd_ffi_ir_topological_sort(ir);
-  if (rc != 0) {
-    cdd_ffi_ir_free(ir);
-    C_CDD_FREE(ir);
-    C_CDD_FREE(file_content);
-    return rc;
+  /* Reuse the sorted IR from a previous run while its sources are unchanged */
+  if (config->cache_dir) {
+    rc = cdd_ffi_ir_cache_load(config, file_content, file_size, &ir,
+                               &ir_cached);
+    if (rc != 0) {
+      C_CDD_FREE(file_content);
+      return rc;
+    }
   }
 
-  /* Dispatch to Emitters */
-  {
-    int out_result = 0;
-    if ((has_lang(config->target_langs, "python", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_python(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter python with %d\n", rc);
-      }
-      if (rc != 0) {
-        printf("Failed at python, rc = %d\n", rc);
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "rust", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_rust(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter rust with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "csharp", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_csharp(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter csharp with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "typescript", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_typescript(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter typescript with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "napi", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_napi(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter napi with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "java", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_java(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter java with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "cpp", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_cpp(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter cpp with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "go", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_go(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter go with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "swift", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_swift(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter swift with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "dart", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_dart(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter dart with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
+  if (!ir_cached) {
+    /* Extract exports into FFI IR */
+    rc = cdd_ffi_ir_extract_exports(config->input, file_content, config, &ir);
+    if (rc != 0) {
+      C_CDD_FREE(file_content);
+      return rc;
     }
-    if ((has_lang(config->target_langs, "ruby", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_ruby(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter ruby with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "kotlin", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_kotlin(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter kotlin with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "php", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_php(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter php with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "lua", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_lua(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter lua with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "zig", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_zig(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter zig with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "odin", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_odin(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter odin with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "julia", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_julia(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter julia with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "r", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_r(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter r with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "matlab", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_matlab(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter matlab with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "haskell", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_haskell(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter haskell with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "ocaml", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_ocaml(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter ocaml with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "elixir", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_elixir(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter elixir with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "erlang", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_erlang(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter erlang with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "common_lisp", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_common_lisp(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter common_lisp with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "racket", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_racket(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter racket with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "scheme", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_scheme(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter scheme with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "scala", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_scala(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter scala with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "fsharp", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_fsharp(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter fsharp with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "clojure", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_clojure(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter clojure with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "groovy", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_groovy(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter groovy with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "webassembly", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "wasm") == 0 ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_webassembly(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter webassembly with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "nim", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_nim(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter nim with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "vlang", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_vlang(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter vlang with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "dlang", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_d(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter d with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "perl", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_perl(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter perl with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "tcl", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_tcl(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter tcl with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "fortran", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_fortran(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter fortran with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
-    }
-    if ((has_lang(config->target_langs, "delphi", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "pascal") == 0 ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_delphi(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter delphi with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
+
+    /* Sort IR dependencies */
+    rc = cdd_ffi_ir_topological_sort(ir);
+    if (rc == 0) {
+      /* Pair `(T *data, size_t n)` parameters for zero-copy buffer views */
+      rc = cdd_ffi_ir_infer_buffers(ir);
     }
-    if ((has_lang(config->target_langs, "ada", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_ada(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter ada with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
-      }
+    if (rc != 0) {
+      cdd_ffi_ir_free(ir);
+      C_CDD_FREE(ir);
+      C_CDD_FREE(file_content);
+      return rc;
     }
-    if ((has_lang(config->target_langs, "objc", &out_result) == CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "objective-c") == 0 ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_objc(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter objc with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
+
+    /* A cache that cannot be written only costs the next run its speed-up */
+    if (config->cache_dir)
+      (void)cdd_ffi_ir_cache_store(config, file_content, file_size, ir);
+  }
+  (void)cdd_parallel_clock_ms(&ir_end_ms);
+
+  /* Select emitters and give each a private staging directory */
+  for (i = 0; rc == 0 && i < BINDINGS_N_EMITTERS; ++i) {
+    int selected = 0;
+    rc = bindings_selected(&bindings_emitters[i], config->target_langs,
+                           &selected);
+    if (rc != 0 || !selected)
+      continue;
+    jobs[n_jobs].emitter = &bindings_emitters[i];
+    jobs[n_jobs].stage_dir = NULL;
+    jobs[n_jobs].rc = CDD_C_SUCCESS;
+    jobs[n_jobs].elapsed_ms = 0;
+    rc = bindings_stage_create(config->output_dir, bindings_emitters[i].name,
+                               &jobs[n_jobs].stage_dir);
+    if (rc != 0)
+      printf("Failed emitter %s with %d\n", bindings_emitters[i].name, rc);
+    ++n_jobs;
+  }
+
+  /* Emit concurrently; the IR is shared read-only */
+  if (rc == 0 && n_jobs > 0) {
+    n_threads = config->jobs > 0 ? (size_t)config->jobs : 0;
+    if (n_threads == 0)
+      rc = cdd_parallel_default_jobs(&n_threads);
+#ifdef CDD_BUILD_TESTS
+    /* The I/O fault countdown is one shared global; keep injection exact */
+    if (g_fail_io_after > 0)
+      n_threads = 1;
+#endif
+    if (n_threads > n_jobs)
+      n_threads = n_jobs;
+    run.ir = ir;
+    run.config = config;
+    run.jobs = jobs;
+    (void)cdd_parallel_clock_ms(&emit_start_ms);
+    if (rc == 0)
+      (void)cdd_parallel_for(n_jobs, n_threads, bindings_emit_cb, &run);
+    (void)cdd_parallel_clock_ms(&emit_end_ms);
+    for (i = 0; i < n_jobs; ++i) {
+      if (jobs[i].rc != 0) {
+        printf("Failed emitter %s with %d\n", jobs[i].emitter->name,
+               jobs[i].rc);
+        if (rc == 0)
+          rc = jobs[i].rc;
       }
     }
-    if ((has_lang(config->target_langs, "crystal", &out_result) ==
-             CDD_C_SUCCESS &&
-         out_result) ||
-        strcmp(config->target_langs, "all") == 0 ||
-        strcmp(config->target_langs, "*") == 0) {
-      rc = cdd_ffi_emit_crystal(ir, config);
-      if (rc != 0) {
-        printf("Failed emitter crystal with %d\n", rc);
-      }
-      if (rc != 0) {
-        cdd_ffi_ir_free(ir);
-        C_CDD_FREE(ir);
-        C_CDD_FREE(file_content);
-        return rc;
+  }
+
+  /* Move staged files into place in table order, or discard on failure */
+  for (i = 0; i < n_jobs; ++i) {
+    if (jobs[i].stage_dir) {
+      cdd_c_error_t drain_rc = bindings_stage_drain(
+          jobs[i].stage_dir, rc == 0 ? config->output_dir : NULL);
+      if (rc == 0 && drain_rc != 0) {
+        printf("Failed to commit emitter %s with %d\n", jobs[i].emitter->name,
+               drain_rc);
+        rc = drain_rc;
       }
+      C_CDD_FREE(jobs[i].stage_dir);
     }
   }
+  (void)cdd_parallel_clock_ms(&end_ms);
+
+  if (config->stats && n_threads > 0)
+    (void)bindings_print_stats(jobs, n_jobs, n_threads, ir_end_ms - start_ms,
+                               ir_cached, emit_end_ms - emit_start_ms,
+                               end_ms - start_ms);
 
   /* Cleanup */
   cdd_ffi_ir_free(ir);
   C_CDD_FREE(ir);
   C_CDD_FREE(file_content);
 
-  return CDD_C_SUCCESS;
+  return rc;
 }
 C_CDD_EXPORT int g_cdd_alloc_fail = 0;
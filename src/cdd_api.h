@@ -89,6 +89,13 @@ typedef struct cdd_generate_bindings_config {
   int generate_tests;
   /** @brief Recursively parse and merge #include files into FFI IR */
   int recursive_includes;
+  /** @brief Emitters to run at once; 0 picks `CDD_C_JOBS` or the CPU count */
+  int jobs;
+  /** @brief Print per-emitter timings once generation finishes */
+  int stats;
+  /** @brief Directory caching the extracted FFI IR, or NULL to always
+   * extract */
+  const char *cache_dir;
   /** @brief cdd_generate_bindings_config_t */
 } cdd_generate_bindings_config_t;
 
@@ -127,6 +134,12 @@ cdd_serve_json_rpc(const cdd_serve_json_rpc_config_t *config);
 
 /**
  * @brief Generate SWIG-like FFI bindings for multiple target languages.
+ *
+ * The selected emitters run concurrently (see `jobs`), each writing into its
+ * own staging directory under `output_dir`. Only once every emitter has
+ * succeeded are the staged files renamed into place, in the fixed emitter
+ * order, so a failed run leaves `output_dir` untouched.
+ *
  * @param config The configuration struct.
  * @return 0 on success, non-zero on failure.
  */
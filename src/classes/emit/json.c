@@ -108,7 +108,7 @@ write_struct_to_json_func(FILE *fp, const char *struct_name,
   for (i = 0; i < sf->size; ++i) {
     const char *n = sf->fields[i].name;
     const char *t = sf->fields[i].type;
-    const char *r = sf->fields[i].ref;
+    const char *r = sf->fields[i].ref ? sf->fields[i].ref : "";
 
     if (sf->fields[i].write_only)
       continue;
@@ -354,7 +354,7 @@ write_struct_from_jsonObject_func(FILE *fp, const char *struct_name,
       tmp_needed = 1;
     }
     if (sf->fields[i].has_min_len || sf->fields[i].has_max_len ||
-        sf->fields[i].pattern[0] != '\0') {
+        sf->fields[i].pattern) {
       len_needed = 1;
     }
   }
@@ -387,7 +387,7 @@ write_struct_from_jsonObject_func(FILE *fp, const char *struct_name,
   for (i = 0; i < sf->size; ++i) {
     const char *n = sf->fields[i].name;
     const char *t = sf->fields[i].type;
-    const char *r = sf->fields[i].ref;
+    const char *r = sf->fields[i].ref ? sf->fields[i].ref : "";
     struct StructField *f = &sf->fields[i];
 
     if (f->read_only)
@@ -470,7 +470,7 @@ write_struct_from_jsonObject_func(FILE *fp, const char *struct_name,
                             "      if (!ret->%s) { %s_cleanup(ret); return "
                             "CDD_C_ERROR_MEMORY; }\n",
                             n, n, struct_name));
-      if (f->has_min_len || f->has_max_len || f->pattern[0]) {
+      if (f->has_min_len || f->has_max_len || f->pattern) {
         CHECK_IO(FPRINTF_HOOK(fp, "      len = strlen(ret->%s);\n", n));
         if (f->has_min_len)
           CHECK_IO(FPRINTF_HOOK(
@@ -484,77 +484,33 @@ write_struct_from_jsonObject_func(FILE *fp, const char *struct_name,
               "      if (len > %" CDD_SIZE_T_FMT
               ") { %s_cleanup(ret); return CDD_C_ERROR_INVALID_ARGUMENT; }\n",
               (size_t)f->max_len, struct_name));
-        if (f->pattern[0]) {
-          if (strncmp(f->pattern, "^", 1) == 0 &&
-              f->pattern[(size_t)strlen(f->pattern) - 1] ==
-                  '$') { /* exact mismatch */
+        if (f->pattern) {
+          const size_t plen = strlen(f->pattern);
+          if (f->pattern[0] == '^' && plen > 1 &&
+              f->pattern[plen - 1] == '$') { /* exact mismatch */
             /* strip anchors */
-            char pat[256];
-            size_t pl = (size_t)strlen(f->pattern) - 2;
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-            strncpy_s(pat, sizeof(pat), f->pattern + 1, pl);
-#else
-#if defined(_MSC_VER)
-            strncpy_s(pat, sizeof(pat), f->pattern + 1, pl);
-#else
-#if defined(_MSC_VER)
-            strncpy_s(pat, sizeof(pat), f->pattern + 1, pl);
-#else
-#if defined(_MSC_VER)
-            strncpy_s(pat, sizeof(pat), f->pattern + 1, pl);
-#else
-#if defined(_MSC_VER)
-            strncpy_s(pat, sizeof(pat), f->pattern + 1, pl);
-#else
-#if defined(_MSC_VER)
-            strncpy_s(pat, sizeof(pat), f->pattern + 1, pl);
-#else
-#if defined(_MSC_VER)
-            strncpy_s(pat, sizeof(pat), f->pattern + 1, pl);
-#else
-            strncpy(pat, f->pattern + 1, pl);
-#endif
-#endif
-#endif
-#endif
-#endif
-#endif
-#endif
-            pat[pl] = 0;
             CHECK_IO(FPRINTF_HOOK(
                 fp,
-                "      if (strcmp(ret->%s, \"%s\") != 0) { "
+                "      if (strcmp(ret->%s, \"%.*s\") != 0) { "
                 "%s_cleanup(ret); return CDD_C_ERROR_INVALID_ARGUMENT; }\n",
-                n, pat, struct_name));
-          } else if (strncmp(f->pattern, "^", 1) == 0) { /* prefix */
+                n, (int)(plen - 2), f->pattern + 1, struct_name));
+          } else if (f->pattern[0] == '^') { /* prefix */
             CHECK_IO(FPRINTF_HOOK(
                 fp,
                 "      if (strncmp(ret->%s, \"%s\", %" CDD_SIZE_T_FMT
                 ") != 0) { "
                 "%s_cleanup(ret); return CDD_C_ERROR_INVALID_ARGUMENT; }\n",
-                n, f->pattern + 1, (size_t)strlen(f->pattern) - 1,
-                struct_name));
-          } else if (f->pattern[(size_t)strlen(f->pattern) - 1] ==
-                     '$') { /* suffix */
-            char pat[256];
-            size_t pl = (size_t)strlen(f->pattern) - 1;
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-            strncpy_s(pat, sizeof(pat), f->pattern, pl);
-#else
-#if defined(_MSC_VER)
-            strncpy_s(pat, sizeof(pat), f->pattern, pl);
-#else
-            memcpy(pat, f->pattern, pl);
-#endif
-#endif
-            pat[pl] = 0;
+                n, f->pattern + 1, (size_t)plen - 1, struct_name));
+          } else if (f->pattern[plen - 1] == '$') { /* suffix */
+            const size_t pl = plen - 1;
             CHECK_IO(FPRINTF_HOOK(fp,
                                   "      if (len < %" CDD_SIZE_T_FMT
                                   " || strcmp(ret->%s + len - %" CDD_SIZE_T_FMT
                                   ", "
-                                  "\"%s\") != 0) { %s_cleanup(ret); return "
+                                  "\"%.*s\") != 0) { %s_cleanup(ret); return "
                                   "CDD_C_ERROR_INVALID_ARGUMENT; }\n",
-                                  (size_t)pl, n, (size_t)pl, pat, struct_name));
+                                  (size_t)pl, n, (size_t)pl, (int)pl,
+                                  f->pattern, struct_name));
           } else { /* contains */
             CHECK_IO(FPRINTF_HOOK(
                 fp,
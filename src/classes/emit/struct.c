@@ -19,8 +19,10 @@
 #include "classes/emit/struct.h"
 #include "classes/parse/numeric.h"
 #include "functions/parse/str.h"
+#include "openapi/parse/json_fragment.h"
 #include "functions/str_includes.h" /* For NUM_LONG_FMT macros if needed, here mostly standard */
 #include "c_cdd/log.h"
+#include "c_cdd/memory.h"
 #include "c_cdd_export.h"
 #include <stdarg.h>
 
@@ -110,6 +112,8 @@ cdd_c_error_t struct_fields_init(struct StructFields *sf) {
     return CDD_C_ERROR_INVALID_ARGUMENT;
   sf->size = 0;
   sf->capacity = 8;
+  sf->strings = NULL;
+  sf->index = NULL;
 #ifdef CDD_BUILD_TESTS
   if (g_struct_fields_init_fail && --g_struct_fields_init_fail == 0) {
     sf->fields = NULL;
@@ -128,7 +132,7 @@ cdd_c_error_t struct_fields_init(struct StructFields *sf) {
   sf->enum_members.members = NULL;
   sf->enum_members.size = 0;
   sf->enum_members.capacity = 0;
-  sf->schema_extra_json = NULL;
+  sf->schema_extra = NULL;
   sf->is_union = 0;
   sf->union_is_anyof = 0;
   sf->union_discriminator = NULL;
@@ -137,6 +141,238 @@ cdd_c_error_t struct_fields_init(struct StructFields *sf) {
   return CDD_C_SUCCESS;
 }
 
+/* --- String Interning --- */
+
+/** @brief Smallest arena chunk backing interned strings. */
+#define STRUCT_FIELD_STRINGS_CHUNK 4096
+
+/**
+ * @brief Arena chunk holding interned string bytes.
+ */
+struct StructFieldStringChunk {
+  struct StructFieldStringChunk *next; /**< Previously filled chunk */
+  size_t used;                         /**< Bytes handed out */
+  size_t capacity;                     /**< Bytes available in data */
+  char data[1];                        /**< Storage (over-allocated) */
+};
+
+/**
+ * @brief Per-container string pool: an open-addressed set over an arena.
+ */
+struct StructFieldStrings {
+  const char **slots;                   /**< Hash slots (NULL = empty) */
+  size_t n_slots;                       /**< Power of two */
+  size_t n_used;                        /**< Occupied slots */
+  struct StructFieldStringChunk *chunk; /**< Current chunk */
+};
+
+/**
+ * @brief FNV-1a hash of a NUL-terminated string.
+ */
+static size_t struct_field_strings_hash(const char *str, size_t *_out_len) {
+  unsigned long h = 2166136261UL;
+  const char *p;
+  for (p = str; *p; ++p) {
+    h ^= (unsigned char)*p;
+    h = (h * 16777619UL) & 0xFFFFFFFFUL;
+  }
+  *_out_len = (size_t)(p - str);
+  return (size_t)h;
+}
+
+/**
+ * @brief Frees the pool and every string it owns.
+ */
+static void struct_field_strings_free(struct StructFieldStrings *pool) {
+  struct StructFieldStringChunk *c;
+  if (!pool)
+    return;
+  c = pool->chunk;
+  while (c) {
+    struct StructFieldStringChunk *next = c->next;
+    C_CDD_FREE(c);
+    c = next;
+  }
+  C_CDD_FREE((void *)pool->slots);
+  C_CDD_FREE(pool);
+}
+
+/**
+ * @brief Doubles the slot table, rehashing every entry.
+ */
+static cdd_c_error_t
+struct_field_strings_grow(struct StructFieldStrings *pool) {
+  const size_t new_n = pool->n_slots ? pool->n_slots * 2 : 64;
+  const char **new_slots =
+      (const char **)C_CDD_CALLOC(new_n, sizeof(const char *));
+  size_t i;
+  if (!new_slots)
+    return CDD_C_ERROR_MEMORY;
+  for (i = 0; i < pool->n_slots; ++i) {
+    const char *str = pool->slots[i];
+    if (str) {
+      size_t len;
+      size_t j = struct_field_strings_hash(str, &len) & (new_n - 1);
+      while (new_slots[j])
+        j = (j + 1) & (new_n - 1);
+      new_slots[j] = str;
+    }
+  }
+  C_CDD_FREE((void *)pool->slots);
+  pool->slots = new_slots;
+  pool->n_slots = new_n;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Copies `len + 1` bytes of `str` into the arena.
+ */
+static char *struct_field_strings_store(struct StructFieldStrings *pool,
+                                        const char *str, size_t len) {
+  struct StructFieldStringChunk *c = pool->chunk;
+  char *out;
+  if (!c || c->capacity - c->used < len + 1) {
+    size_t cap = STRUCT_FIELD_STRINGS_CHUNK;
+    if (cap < len + 1)
+      cap = len + 1;
+    c = (struct StructFieldStringChunk *)C_CDD_MALLOC(
+        sizeof(struct StructFieldStringChunk) + cap);
+    if (!c)
+      return NULL;
+    c->next = pool->chunk;
+    c->used = 0;
+    c->capacity = cap;
+    pool->chunk = c;
+  }
+  out = c->data + c->used;
+  memcpy(out, str, len + 1);
+  c->used += len + 1;
+  return out;
+}
+
+/**
+ * @brief Interns a string in the container's pool.
+ */
+cdd_c_error_t struct_fields_intern(struct StructFields *sf, const char *str,
+                                   const char **_out_val) {
+  struct StructFieldStrings *pool;
+  size_t len;
+  size_t i;
+  char *copy;
+  if (!sf || !_out_val)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *_out_val = NULL;
+  if (!str || !*str)
+    return CDD_C_SUCCESS;
+
+  pool = sf->strings;
+  if (!pool) {
+    pool = (struct StructFieldStrings *)C_CDD_CALLOC(1, sizeof(*pool));
+    if (!pool)
+      return CDD_C_ERROR_MEMORY;
+    sf->strings = pool;
+  }
+  /* Keep the load factor at or below one half */
+  if ((pool->n_used + 1) * 2 > pool->n_slots) {
+    if (struct_field_strings_grow(pool) != CDD_C_SUCCESS) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      return CDD_C_ERROR_MEMORY;
+    }
+  }
+
+  i = struct_field_strings_hash(str, &len) & (pool->n_slots - 1);
+  while (pool->slots[i]) {
+    if (strcmp(pool->slots[i], str) == 0) {
+      *_out_val = pool->slots[i];
+      return CDD_C_SUCCESS;
+    }
+    i = (i + 1) & (pool->n_slots - 1);
+  }
+  copy = struct_field_strings_store(pool, str, len);
+  if (!copy) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+  pool->slots[i] = copy;
+  pool->n_used++;
+  *_out_val = copy;
+  return CDD_C_SUCCESS;
+}
+
+/* --- Name Index --- */
+
+/** @brief Field count at which struct_fields_add starts indexing names. */
+#define STRUCT_FIELDS_INDEX_MIN 16
+
+/**
+ * @brief Open-addressed name -> position table over `StructFields::fields`.
+ */
+struct StructFieldIndex {
+  size_t *slots;    /**< Field position + 1, 0 = empty */
+  size_t n_slots;   /**< Power of two */
+  size_t n_indexed; /**< Leading fields covered by the table */
+};
+
+/**
+ * @brief Frees a name index.
+ */
+static void struct_field_index_free(struct StructFieldIndex *index) {
+  if (!index)
+    return;
+  free(index->slots);
+  free(index);
+}
+
+/**
+ * @brief Records field `pos` unless an earlier field has the same name.
+ */
+static void struct_field_index_put(struct StructFieldIndex *index,
+                                   const struct StructField *fields,
+                                   size_t pos) {
+  size_t len;
+  size_t i = struct_field_strings_hash(fields[pos].name, &len) &
+             (index->n_slots - 1);
+  while (index->slots[i]) {
+    if (strcmp(fields[index->slots[i] - 1].name, fields[pos].name) == 0)
+      return;
+    i = (i + 1) & (index->n_slots - 1);
+  }
+  index->slots[i] = pos + 1;
+}
+
+/**
+ * @brief Indexes every field not yet covered, growing the table as needed.
+ *
+ * On allocation failure the index is dropped; lookups then fall back to a
+ * linear scan.
+ */
+static void struct_fields_reindex(struct StructFields *sf) {
+  struct StructFieldIndex *index = sf->index;
+  size_t want = 64;
+  while (want < sf->size * 2)
+    want *= 2;
+  if (!index) {
+    index = (struct StructFieldIndex *)calloc(1, sizeof(*index));
+    if (!index)
+      return;
+    sf->index = index;
+  }
+  if (index->n_slots < want || index->n_indexed > sf->size) {
+    size_t *slots = (size_t *)calloc(want, sizeof(size_t));
+    if (!slots) {
+      struct_field_index_free(index);
+      sf->index = NULL;
+      return;
+    }
+    free(index->slots);
+    index->slots = slots;
+    index->n_slots = want;
+    index->n_indexed = 0;
+  }
+  for (; index->n_indexed < sf->size; ++index->n_indexed)
+    struct_field_index_put(index, sf->fields, index->n_indexed);
+}
+
 /**
  * @brief Executes the struct fields free operation.
  */
@@ -144,13 +380,13 @@ void struct_fields_free(struct StructFields *sf) {
   if (sf && sf->fields) {
     size_t i;
     for (i = 0; i < sf->size; ++i) {
-      if (sf->fields[i].schema_extra_json) {
-        free(sf->fields[i].schema_extra_json);
-        sf->fields[i].schema_extra_json = NULL;
+      if (sf->fields[i].schema_extra) {
+        json_value_free(sf->fields[i].schema_extra);
+        sf->fields[i].schema_extra = NULL;
       }
-      if (sf->fields[i].items_extra_json) {
-        free(sf->fields[i].items_extra_json);
-        sf->fields[i].items_extra_json = NULL;
+      if (sf->fields[i].items_extra) {
+        json_value_free(sf->fields[i].items_extra);
+        sf->fields[i].items_extra = NULL;
       }
       if (sf->fields[i].type_union) {
         free_string_array(sf->fields[i].type_union, sf->fields[i].n_type_union);
@@ -168,9 +404,9 @@ void struct_fields_free(struct StructFields *sf) {
     sf->fields = NULL;
   }
   if (sf) {
-    if (sf->schema_extra_json) {
-      free(sf->schema_extra_json);
-      sf->schema_extra_json = NULL;
+    if (sf->schema_extra) {
+      json_value_free(sf->schema_extra);
+      sf->schema_extra = NULL;
     }
     if (sf->union_discriminator) {
       free(sf->union_discriminator);
@@ -199,6 +435,10 @@ void struct_fields_free(struct StructFields *sf) {
       sf->union_variants = NULL;
       sf->n_union_variants = 0;
     }
+    struct_field_strings_free(sf->strings);
+    sf->strings = NULL;
+    struct_field_index_free(sf->index);
+    sf->index = NULL;
     enum_members_free(&sf->enum_members);
     sf->is_enum = 0;
     sf->is_union = 0;
@@ -245,38 +485,57 @@ cdd_c_error_t struct_fields_add(struct StructFields *sf, const char *name,
   f = &sf->fields[sf->size];
   /* Zero out new slot to clear constraints/flags */
   memset(f, 0, sizeof(struct StructField));
+  f->name = "";
+  f->type = "";
 
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-  strncpy_s(f->name, sizeof(f->name), name, _TRUNCATE);
-  strncpy_s(f->type, sizeof(f->type), type, _TRUNCATE);
-  if (ref) {
-    strncpy_s(f->ref, sizeof(f->ref), ref, _TRUNCATE);
-  }
-  if (default_val) {
-    strncpy_s(f->default_val, sizeof(f->default_val), default_val, _TRUNCATE);
-  }
-  if (bit_width) {
-    strncpy_s(f->bit_width, sizeof(f->bit_width), bit_width, _TRUNCATE);
-  }
-#else
-  strncpy(f->name, name, sizeof(f->name) - 1);
-  f->name[sizeof(f->name) - 1] = '\0';
-  strncpy(f->type, type, sizeof(f->type) - 1);
-  f->type[sizeof(f->type) - 1] = '\0';
-  if (ref) {
-    strncpy(f->ref, ref, sizeof(f->ref) - 1);
-    f->ref[sizeof(f->ref) - 1] = '\0';
-  }
-  if (default_val) {
-    strncpy(f->default_val, default_val, sizeof(f->default_val) - 1);
-    f->default_val[sizeof(f->default_val) - 1] = '\0';
-  }
-  if (bit_width) {
-    strncpy(f->bit_width, bit_width, sizeof(f->bit_width) - 1);
-    f->bit_width[sizeof(f->bit_width) - 1] = '\0';
+  {
+    const char *h;
+    cdd_c_error_t rc;
+    if ((rc = struct_fields_intern(sf, name, &h)) != CDD_C_SUCCESS)
+      return rc;
+    if (h)
+      f->name = h;
+    if ((rc = struct_fields_intern(sf, type, &h)) != CDD_C_SUCCESS)
+      return rc;
+    if (h)
+      f->type = h;
+    if ((rc = struct_fields_intern(sf, ref, &f->ref)) != CDD_C_SUCCESS ||
+        (rc = struct_fields_intern(sf, default_val, &f->default_val)) !=
+            CDD_C_SUCCESS ||
+        (rc = struct_fields_intern(sf, bit_width, &f->bit_width)) !=
+            CDD_C_SUCCESS)
+      return rc;
   }
-#endif
   sf->size++;
+  if (sf->index || sf->size >= STRUCT_FIELDS_INDEX_MIN)
+    struct_fields_reindex(sf);
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Removes one field, releasing what it owns.
+ */
+cdd_c_error_t struct_fields_remove(struct StructFields *sf, size_t idx) {
+  struct StructField *f;
+  if (!sf || idx >= sf->size)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  f = &sf->fields[idx];
+  if (f->schema_extra)
+    json_value_free(f->schema_extra);
+  if (f->items_extra)
+    json_value_free(f->items_extra);
+  if (f->type_union)
+    free_string_array(f->type_union, f->n_type_union);
+  if (f->items_type_union)
+    free_string_array(f->items_type_union, f->n_items_type_union);
+  memmove(f, f + 1, (sf->size - idx - 1) * sizeof(struct StructField));
+  sf->size--;
+  if (sf->index) {
+    /* Positions after idx shifted; rebuild from scratch */
+    memset(sf->index->slots, 0, sf->index->n_slots * sizeof(size_t));
+    sf->index->n_indexed = 0;
+    struct_fields_reindex(sf);
+  }
   return CDD_C_SUCCESS;
 }
 
@@ -290,6 +549,22 @@ cdd_c_error_t struct_fields_get(const struct StructFields *sf, const char *name,
     *_out_val = NULL;
     return CDD_C_SUCCESS;
   }
+  /* The index is only trusted while it covers exactly the current fields */
+  if (sf->index && sf->index->n_indexed == sf->size) {
+    const struct StructFieldIndex *index = sf->index;
+    size_t len;
+    i = struct_field_strings_hash(name, &len) & (index->n_slots - 1);
+    while (index->slots[i]) {
+      struct StructField *f = &sf->fields[index->slots[i] - 1];
+      if (strcmp(f->name, name) == 0) {
+        *_out_val = f;
+        return CDD_C_SUCCESS;
+      }
+      i = (i + 1) & (index->n_slots - 1);
+    }
+    *_out_val = NULL;
+    return CDD_C_SUCCESS;
+  }
   for (i = 0; i < sf->size; ++i) {
     if (strcmp(sf->fields[i].name, name) == 0) {
       *_out_val = &sf->fields[i];
@@ -302,6 +577,107 @@ cdd_c_error_t struct_fields_get(const struct StructFields *sf, const char *name,
   }
 }
 
+/**
+ * @brief Duplicates a string array.
+ */
+static cdd_c_error_t copy_string_array(char ***dest, size_t *n_dest,
+                                       char *const *src, size_t n_src) {
+  size_t i;
+  *dest = NULL;
+  *n_dest = 0;
+  if (!src || n_src == 0)
+    return CDD_C_SUCCESS;
+  *dest = (char **)calloc(n_src, sizeof(char *));
+  if (!*dest)
+    return CDD_C_ERROR_MEMORY;
+  for (i = 0; i < n_src; ++i) {
+    if (src[i]) {
+      c_cdd_strdup(src[i], &(*dest)[i]);
+      if (!(*dest)[i]) {
+        free_string_array(*dest, n_src);
+        *dest = NULL;
+        return CDD_C_ERROR_MEMORY;
+      }
+    }
+  }
+  *n_dest = n_src;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Copies a field into another container, re-interning its strings.
+ */
+cdd_c_error_t struct_field_copy(struct StructFields *dest_sf,
+                                struct StructField *dest,
+                                const struct StructField *src) {
+  struct StructField tmp;
+  const char *h;
+  cdd_c_error_t rc;
+  if (!dest_sf || !dest || !src)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  tmp = *src;
+  tmp.name = "";
+  tmp.type = "";
+  tmp.schema_extra = NULL;
+  tmp.items_extra = NULL;
+  tmp.type_union = NULL;
+  tmp.n_type_union = 0;
+  tmp.items_type_union = NULL;
+  tmp.n_items_type_union = 0;
+
+  if ((rc = struct_fields_intern(dest_sf, src->name, &h)) != CDD_C_SUCCESS)
+    return rc;
+  if (h)
+    tmp.name = h;
+  if ((rc = struct_fields_intern(dest_sf, src->type, &h)) != CDD_C_SUCCESS)
+    return rc;
+  if (h)
+    tmp.type = h;
+  if ((rc = struct_fields_intern(dest_sf, src->ref, &tmp.ref)) != 0 ||
+      (rc = struct_fields_intern(dest_sf, src->default_val,
+                                 &tmp.default_val)) != 0 ||
+      (rc = struct_fields_intern(dest_sf, src->pattern, &tmp.pattern)) != 0 ||
+      (rc = struct_fields_intern(dest_sf, src->format, &tmp.format)) != 0 ||
+      (rc = struct_fields_intern(dest_sf, src->description,
+                                 &tmp.description)) != 0 ||
+      (rc = struct_fields_intern(dest_sf, src->bit_width, &tmp.bit_width)) !=
+          0 ||
+      (rc = struct_fields_intern(dest_sf, src->c_type, &tmp.c_type)) != 0)
+    return rc;
+
+  if (json_value_clone(src->schema_extra, &tmp.schema_extra) != 0 ||
+      json_value_clone(src->items_extra, &tmp.items_extra) != 0)
+    goto oom;
+  if (copy_string_array(&tmp.type_union, &tmp.n_type_union, src->type_union,
+                        src->n_type_union) != CDD_C_SUCCESS ||
+      copy_string_array(&tmp.items_type_union, &tmp.n_items_type_union,
+                        src->items_type_union,
+                        src->n_items_type_union) != CDD_C_SUCCESS)
+    goto oom;
+
+  if (dest->schema_extra)
+    json_value_free(dest->schema_extra);
+  if (dest->items_extra)
+    json_value_free(dest->items_extra);
+  if (dest->type_union)
+    free_string_array(dest->type_union, dest->n_type_union);
+  if (dest->items_type_union)
+    free_string_array(dest->items_type_union, dest->n_items_type_union);
+  *dest = tmp;
+  return CDD_C_SUCCESS;
+
+oom:
+  if (tmp.schema_extra)
+    json_value_free(tmp.schema_extra);
+  if (tmp.items_extra)
+    json_value_free(tmp.items_extra);
+  if (tmp.type_union)
+    free_string_array(tmp.type_union, tmp.n_type_union);
+  C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+  return CDD_C_ERROR_MEMORY;
+}
+
 /* --- Generation Implementing --- */
 
 /**
@@ -336,7 +712,7 @@ write_struct_cleanup_func(FILE *fp, const char *struct_name,
   for (i = 0; i < sf->size; ++i) {
     const char *n = sf->fields[i].name;
     const char *t = sf->fields[i].type;
-    char *r = sf->fields[i].ref;
+    const char *r = sf->fields[i].ref ? sf->fields[i].ref : "";
 
     if (strcmp(t, "string") == 0) {
       CHECK_IO(
@@ -537,7 +913,7 @@ write_struct_default_func(FILE *fp, const char *struct_name,
 
   /* Check if we need 'rc' variable */
   for (i = 0; i < sf->size; ++i) {
-    if (sf->fields[i].default_val[0] != '\0' &&
+    if (sf->fields[i].default_val &&
         strcmp(sf->fields[i].type, "enum") == 0) {
       rc_needed = 1;
       break;
@@ -559,7 +935,7 @@ write_struct_default_func(FILE *fp, const char *struct_name,
 
   for (i = 0; i < sf->size; ++i) {
     const char *def = sf->fields[i].default_val;
-    if (def[0] != '\0') {
+    if (def) {
       const char *n = sf->fields[i].name;
       const char *t = sf->fields[i].type;
       char *r = NULL;
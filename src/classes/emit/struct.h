@@ -29,6 +29,8 @@ extern "C" {
 #include <stddef.h>
 #include <stdio.h>
 
+#include <parson.h>
+
 #include "c_cdd_export.h"
 #include "cdd_c_error.h"
 #include "classes/emit/enum.h"
@@ -37,54 +39,63 @@ extern "C" {
 /**
  * @brief Represents a single field within a struct.
  * Used to drive generation logic based on type traits.
+ *
+ * String attributes are borrowed pointers, normally handles interned in the
+ * owning `StructFields` (see struct_fields_intern) that stay valid until the
+ * container is freed; string literals may be assigned directly. `name` and
+ * `type` are never NULL for fields created by struct_fields_add; the other
+ * strings are NULL when absent.
  */
 struct StructField {
-  char name[64]; /**< Field identifier */
-  char type[64]; /**< C or Logical Field type (e.g. "string", "integer",
-                    "object") */
-  char ref[64];  /**< Reference type name (for objects/enums) or item type (for
-                    arrays) */
+  const char *name;        /**< Field identifier */
+  const char *type;        /**< C or Logical Field type (e.g. "string",
+                              "integer", "object") */
+  const char *ref;         /**< Reference type name (for objects/enums) or item
+                              type (for arrays) */
+  const char *default_val; /**< Default value literal (e.g. "5", "0b101",
+                              "nullptr") */
+  const char *pattern;     /**< Regex pattern string */
+  const char *format;      /**< Optional JSON Schema format (e.g. "uuid") */
+  const char *description; /**< Optional field description */
+  const char *bit_width;   /**< Bit-field width literal (e.g. "3", "8") */
+  const char *c_type;      /**< Declared C type (e.g. "unsigned long*"),
+                              NULL when not parsed from C */
   char **type_union;       /**< Optional type array (e.g. ["string","null"]) */
   size_t n_type_union;     /**< Count of type_union entries */
-  char default_val[64];    /**< Default value literal (e.g. "5", "0b101",
-                              "nullptr") or empty */
-  char *schema_extra_json; /**< Serialized JSON for extra schema keywords */
-  char *items_extra_json;  /**< Serialized JSON for array items keywords */
-  char **items_type_union; /**< Optional items type array for arrays */
+  JSON_Value *schema_extra; /**< Owned object of extra schema keywords */
+  JSON_Value *items_extra;  /**< Owned object of array items keywords */
+  char **items_type_union;  /**< Optional items type array for arrays */
   size_t n_items_type_union; /**< Count of items_type_union entries */
 
   /* Validation Constraints */
-  int has_min;           /**< 1 if minimum constraint exists */
-  double min_val;        /**< Minimum value */
-  int exclusive_min;     /**< 1 if exclusive minimum */
-  int has_max;           /**< 1 if maximum constraint exists */
-  double max_val;        /**< Maximum value */
-  int exclusive_max;     /**< 1 if exclusive maximum */
-  int has_min_len;       /**< 1 if minLength constraint exists */
-  size_t min_len;        /**< Minimum length for strings */
-  int has_max_len;       /**< 1 if maxLength constraint exists */
-  size_t max_len;        /**< Maximum length for strings */
-  char pattern[256];     /**< Regex pattern string */
-  char format[32];       /**< Optional JSON Schema format (e.g. "uuid") */
-  char description[256]; /**< Optional field description */
-  int deprecated;        /**< 1 if deprecated=true */
-  int deprecated_set;    /**< 1 if deprecated explicitly set */
-  int read_only;         /**< 1 if readOnly=true */
-  int read_only_set;     /**< 1 if readOnly explicitly set */
-  int write_only;        /**< 1 if writeOnly=true */
-  int write_only_set;    /**< 1 if writeOnly explicitly set */
-  int has_min_items;     /**< 1 if minItems constraint exists */
-  size_t min_items;      /**< Minimum items for arrays */
-  int has_max_items;     /**< 1 if maxItems constraint exists */
-  size_t max_items;      /**< Maximum items for arrays */
-  int unique_items;      /**< 1 if uniqueItems constraint exists */
-  int required;          /**< 1 if required in schema, 0 optional */
+  double min_val;   /**< Minimum value */
+  double max_val;   /**< Maximum value */
+  size_t min_len;   /**< Minimum length for strings */
+  size_t max_len;   /**< Maximum length for strings */
+  size_t min_items; /**< Minimum items for arrays */
+  size_t max_items; /**< Maximum items for arrays */
+
+  /* Flags */
+  unsigned int has_min : 1;        /**< 1 if minimum constraint exists */
+  unsigned int exclusive_min : 1;  /**< 1 if exclusive minimum */
+  unsigned int has_max : 1;        /**< 1 if maximum constraint exists */
+  unsigned int exclusive_max : 1;  /**< 1 if exclusive maximum */
+  unsigned int has_min_len : 1;    /**< 1 if minLength constraint exists */
+  unsigned int has_max_len : 1;    /**< 1 if maxLength constraint exists */
+  unsigned int deprecated : 1;     /**< 1 if deprecated=true */
+  unsigned int deprecated_set : 1; /**< 1 if deprecated explicitly set */
+  unsigned int read_only : 1;      /**< 1 if readOnly=true */
+  unsigned int read_only_set : 1;  /**< 1 if readOnly explicitly set */
+  unsigned int write_only : 1;     /**< 1 if writeOnly=true */
+  unsigned int write_only_set : 1; /**< 1 if writeOnly explicitly set */
+  unsigned int has_min_items : 1;  /**< 1 if minItems constraint exists */
+  unsigned int has_max_items : 1;  /**< 1 if maxItems constraint exists */
+  unsigned int unique_items : 1;   /**< 1 if uniqueItems constraint exists */
+  unsigned int required : 1;       /**< 1 if required in schema, 0 optional */
 
   /* C Type Properties */
-  int is_flexible_array; /**< 1 if field is a Flexible Array Member `type
-                            name[]`, 0 otherwise */
-  char bit_width[16]; /**< Bit-field width literal (e.g. "3", "8"), or empty if
-                         not a bit-field */
+  unsigned int is_flexible_array : 1; /**< 1 if field is a Flexible Array
+                                         Member `type name[]`, 0 otherwise */
 };
 
 /**
@@ -122,12 +133,14 @@ struct StructFields {
   struct StructField *fields;      /**< dynamic array of fields */
   int is_enum;                     /**< 1 if schema is an enum */
   struct EnumMembers enum_members; /**< Enum values when is_enum=1 */
-  char *schema_extra_json; /**< Serialized JSON for extra schema keywords */
-  int is_union;            /**< 1 if schema represents a union (oneOf/anyOf) */
-  int union_is_anyof;      /**< 1 if union came from anyOf (else oneOf) */
+  JSON_Value *schema_extra; /**< Owned object of extra schema keywords */
+  int is_union;             /**< 1 if schema represents a union (oneOf/anyOf) */
+  int union_is_anyof;       /**< 1 if union came from anyOf (else oneOf) */
   char *union_discriminator; /**< Discriminator property name, if any */
   struct UnionVariantMeta *union_variants; /**< Per-variant metadata */
   size_t n_union_variants;                 /**< Count of union variants */
+  struct StructFieldStrings *strings;      /**< Interned field strings */
+  struct StructFieldIndex *index;          /**< Lazy name lookup table */
 };
 
 /**
@@ -175,6 +188,9 @@ extern C_CDD_EXPORT cdd_c_error_t struct_fields_add(
  * @param[out] _out_val Pointer to store the result
  * @brief Search for a field by name.
  *
+ * Containers past a few fields keep a name index, so lookups stay constant
+ * time on wide schemas; the first field with a matching name is returned.
+ *
  * @param[in] sf Pointer to the container.
  * @param[in] name Field name to find.
  * @return Pointer to the field if found, NULL otherwise.
@@ -183,6 +199,51 @@ extern C_CDD_EXPORT cdd_c_error_t
 struct_fields_get(const struct StructFields *sf, const char *name,
                   struct StructField **_out_val);
 
+/**
+ * @brief Remove the field at `idx`, keeping the order of the others.
+ *
+ * Use this instead of moving entries of `sf->fields` by hand so the name
+ * index stays consistent.
+ *
+ * @param[in,out] sf Container.
+ * @param[in] idx Position of the field to remove.
+ * @return 0 on success, EINVAL if `sf` is NULL or `idx` is out of range.
+ */
+extern C_CDD_EXPORT cdd_c_error_t struct_fields_remove(struct StructFields *sf,
+                                                       size_t idx);
+
+/**
+ * @brief Intern a string in the container's string pool.
+ *
+ * Equal strings share one copy, so repeated types and refs cost a pointer
+ * per field. Use this to set any string attribute of a field in `sf`.
+ *
+ * @param[in,out] sf Owning container.
+ * @param[in] str String to intern (nullable).
+ * @param[out] _out_val Receives the handle, or NULL if `str` is NULL or
+ * empty.
+ * @return 0 on success, EINVAL if `sf` or `_out_val` is NULL, ENOMEM on
+ * failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t struct_fields_intern(struct StructFields *sf,
+                                                       const char *str,
+                                                       const char **_out_val);
+
+/**
+ * @brief Copy a field into another container.
+ *
+ * Strings are re-interned in `dest_sf` and owned arrays are duplicated, so
+ * `dest` stays valid after the source container is freed.
+ *
+ * @param[in,out] dest_sf Container owning `dest`.
+ * @param[out] dest Field to overwrite.
+ * @param[in] src Field to copy.
+ * @return 0 on success, EINVAL on NULL input, ENOMEM on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+struct_field_copy(struct StructFields *dest_sf, struct StructField *dest,
+                  const struct StructField *src);
+
 /* --- Generator Functions --- */
 
 /**
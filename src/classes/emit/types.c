@@ -76,7 +76,7 @@ write_union_to_json_func(FILE *fp, const char *union_name,
     if (strcmp(t, "object") == 0) {
       needs_nested_rc = 1;
     } else if (strcmp(t, "array") == 0) {
-      const char *item = sf->fields[i].ref;
+      const char *item = sf->fields[i].ref ? sf->fields[i].ref : "";
       if ((strcmp(item, "integer") != 0 && strcmp(item, "number") != 0 &&
            strcmp(item, "string") != 0 && strcmp(item, "boolean") != 0))
         needs_nested_rc = 1;
@@ -101,7 +101,7 @@ write_union_to_json_func(FILE *fp, const char *union_name,
   for (i = 0; i < sf->size; ++i) {
     const char *name = sf->fields[i].name;
     const char *type = sf->fields[i].type;
-    const char *ref = sf->fields[i].ref;
+    const char *ref = sf->fields[i].ref ? sf->fields[i].ref : "";
 
     CHECK_IO(FPRINTF_HOOK(fp, "    case %s_%s:\n", union_name, name));
     if (strcmp(type, "integer") == 0) {
@@ -278,7 +278,7 @@ write_union_from_jsonObject_func(FILE *fp, const char *union_name,
     for (i = 0; i < sf->size; ++i) {
       const char *name = sf->fields[i].name;
       const char *type = sf->fields[i].type;
-      const char *ref = sf->fields[i].ref;
+      const char *ref = sf->fields[i].ref ? sf->fields[i].ref : "";
       const char *disc_val = NULL;
       if (sf->union_variants && i < sf->n_union_variants)
         disc_val = sf->union_variants[i].disc_value;
@@ -371,7 +371,7 @@ write_union_from_jsonObject_func(FILE *fp, const char *union_name,
   for (i = 0; i < sf->size; ++i) {
     const char *name = sf->fields[i].name;
     const char *type = sf->fields[i].type;
-    const char *ref = sf->fields[i].ref;
+    const char *ref = sf->fields[i].ref ? sf->fields[i].ref : "";
     if (strcmp(type, "object") != 0)
       continue;
     CHECK_IO(FPRINTF_HOOK(fp, "    case %" CDD_SIZE_T_FMT ":\n", (size_t)i));
@@ -478,7 +478,7 @@ write_union_from_json_func(FILE *fp, const char *union_name,
       null_count++;
       break;
     case UNION_JSON_ARRAY: {
-      const char *item = sf->fields[i].ref;
+      const char *item = sf->fields[i].ref ? sf->fields[i].ref : "";
       if (array_count == 0)
         array_idx = i;
       array_count++;
@@ -536,7 +536,8 @@ write_union_from_json_func(FILE *fp, const char *union_name,
                               "      return CDD_C_ERROR_INVALID_ARGUMENT;\n"));
   } else {
     const char *name = sf->fields[array_idx].name;
-    const char *ref = sf->fields[array_idx].ref;
+    const char *ref =
+        sf->fields[array_idx].ref ? sf->fields[array_idx].ref : "";
     CHECK_IO(
         FPRINTF_HOOK(fp,
                      "      {\n"
@@ -858,7 +859,7 @@ write_union_cleanup_func(FILE *fp, const char *union_name,
            _ast_get_type_from_ref_5),
           name));
     } else if (strcmp(sf->fields[i].type, "array") == 0) {
-      const char *r = sf->fields[i].ref;
+      const char *r = sf->fields[i].ref ? sf->fields[i].ref : "";
       if (strcmp(r, "string") == 0 ||
           (strcmp(r, "integer") != 0 && strcmp(r, "boolean") != 0 &&
            strcmp(r, "number") != 0)) {
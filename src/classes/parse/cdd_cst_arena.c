@@ -0,0 +1,115 @@
+/**
+ * @file cdd_cst_arena.c
+ * @brief Implementation of the CST bump allocator.
+ */
+
+/* clang-format off */
+#include "cdd_cst_arena.h"
+#include <string.h>
+
+#include "c_cdd/log.h"
+#include "c_cdd/memory.h"
+/* clang-format on */
+
+/** @brief Strictest alignment the arena hands out. */
+typedef union cdd_cst_arena_align_t {
+  void *p;
+  double d;
+  long l;
+  size_t s;
+} cdd_cst_arena_align_t;
+
+/** @brief Usable bytes in a regular block. */
+#define CDD_CST_ARENA_BLOCK_SIZE 4000
+
+struct cdd_cst_arena_block_t {
+  cdd_cst_arena_block_t *next; /**< Older block */
+  size_t used;                 /**< Bytes handed out */
+  size_t size;                 /**< Usable bytes */
+};
+
+/** @brief Offset of the data area, rounded up to the alignment. */
+#define ARENA_HEADER_SIZE                                                      \
+  ((sizeof(cdd_cst_arena_block_t) + sizeof(cdd_cst_arena_align_t) - 1) /      \
+   sizeof(cdd_cst_arena_align_t) * sizeof(cdd_cst_arena_align_t))
+
+#define ARENA_DATA(block) ((char *)(block) + ARENA_HEADER_SIZE)
+
+void cdd_cst_arena_init(cdd_cst_arena_t *arena) {
+  if (arena)
+    arena->head = NULL;
+}
+
+cdd_c_error_t cdd_cst_arena_alloc(cdd_cst_arena_t *arena, size_t size,
+                                  void **out_ptr) {
+  const size_t align = sizeof(cdd_cst_arena_align_t);
+  cdd_cst_arena_block_t *block;
+  size_t cap;
+
+  if (!arena || !out_ptr)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out_ptr = NULL;
+  if (size == 0)
+    size = 1;
+  if (size > (size_t)-1 - align - ARENA_HEADER_SIZE)
+    return CDD_C_ERROR_MEMORY;
+  size = (size + align - 1) / align * align;
+
+  block = arena->head;
+  if (block && block->size - block->used >= size) {
+    *out_ptr = ARENA_DATA(block) + block->used;
+    block->used += size;
+    return CDD_C_SUCCESS;
+  }
+
+  cap = size > CDD_CST_ARENA_BLOCK_SIZE / 4 ? size : CDD_CST_ARENA_BLOCK_SIZE;
+  block = (cdd_cst_arena_block_t *)C_CDD_MALLOC(ARENA_HEADER_SIZE + cap);
+  if (!block) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+  block->used = size;
+  block->size = cap;
+  if (cap == size && arena->head) {
+    /* Oversized request: keep filling the current block afterwards */
+    block->next = arena->head->next;
+    arena->head->next = block;
+  } else {
+    block->next = arena->head;
+    arena->head = block;
+  }
+  *out_ptr = ARENA_DATA(block);
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t cdd_cst_arena_strndup(cdd_cst_arena_t *arena, const char *str,
+                                    size_t len, const char **out_str) {
+  void *mem = NULL;
+  cdd_c_error_t rc;
+
+  if (!out_str)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out_str = NULL;
+  if (!str)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  rc = cdd_cst_arena_alloc(arena, len + 1, &mem);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  memcpy(mem, str, len);
+  ((char *)mem)[len] = '\0';
+  *out_str = (const char *)mem;
+  return CDD_C_SUCCESS;
+}
+
+void cdd_cst_arena_free(cdd_cst_arena_t *arena) {
+  cdd_cst_arena_block_t *block;
+  if (!arena)
+    return;
+  block = arena->head;
+  while (block) {
+    cdd_cst_arena_block_t *next = block->next;
+    C_CDD_FREE(block);
+    block = next;
+  }
+  arena->head = NULL;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file cdd_cst_arena.h
+ * @brief Bump allocator for memory that lives as long as a tree or a pass.
+ *
+ * Each cdd_cst_tree_t carries one in `strings` for the text of synthesized
+ * tokens, so transformers working on different trees never share
+ * allocator state. Passes can keep their own arena on the stack for
+ * scratch data and release it in one call.
+ *
+ * @author Samuel Marks
+ */
+
+#ifndef CDD_CST_ARENA_H
+#define CDD_CST_ARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include <stddef.h>
+
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+/* clang-format on */
+
+/** @brief Opaque chunk of arena memory. */
+typedef struct cdd_cst_arena_block_t cdd_cst_arena_block_t;
+
+/**
+ * @brief Arena handle. A zero-filled arena is empty and ready to use.
+ */
+typedef struct cdd_cst_arena_t {
+  cdd_cst_arena_block_t *head; /**< Block currently being filled */
+} cdd_cst_arena_t;
+
+/**
+ * @brief Initialise an empty arena.
+ * @param arena The arena.
+ */
+C_CDD_EXPORT void cdd_cst_arena_init(cdd_cst_arena_t *arena);
+
+/**
+ * @brief Allocate `size` bytes, suitably aligned for any object.
+ * @param arena The arena.
+ * @param size Bytes to allocate.
+ * @param[out] out_ptr Receives the memory; valid until the arena is freed.
+ * @return 0 on success, CDD_C_ERROR_MEMORY on allocation failure.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_cst_arena_alloc(cdd_cst_arena_t *arena,
+                                               size_t size, void **out_ptr);
+
+/**
+ * @brief Copy `len` bytes of `str` into the arena and NUL-terminate them.
+ * @param arena The arena.
+ * @param str Source bytes.
+ * @param len Number of bytes to copy.
+ * @param[out] out_str Receives the copy.
+ * @return 0 on success, CDD_C_ERROR_MEMORY on allocation failure.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_cst_arena_strndup(cdd_cst_arena_t *arena,
+                                                 const char *str, size_t len,
+                                                 const char **out_str);
+
+/**
+ * @brief Release every allocation and leave the arena empty.
+ * @param arena The arena (may be NULL).
+ */
+C_CDD_EXPORT void cdd_cst_arena_free(cdd_cst_arena_t *arena);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CDD_CST_ARENA_H */
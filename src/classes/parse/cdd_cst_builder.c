@@ -461,7 +461,6 @@ cdd_c_error_t cdd_cst_bld_block_close(cdd_cst_builder_t *builder) {
 
 static cdd_c_error_t pool_string(cdd_cst_tree_t *tree, const char *str,
                                  const char **out_str) {
-  char *dup;
 #ifdef CDD_BUILD_TESTS
   extern int g_cdd_cst_alloc_token_fail;
 #endif
@@ -473,24 +472,7 @@ static cdd_c_error_t pool_string(cdd_cst_tree_t *tree, const char *str,
   if (!tree)
     return CDD_C_ERROR_INVALID_ARGUMENT;
 
-  dup = C_CDD_STRDUP(str);
-  if (!dup)
-    return CDD_C_ERROR_MEMORY;
-  if (tree->num_strings >= tree->string_capacity) {
-    size_t new_cap =
-        tree->string_capacity == 0 ? 32 : tree->string_capacity * 2;
-    char **new_pool =
-        (char **)C_CDD_REALLOC(tree->string_pool, new_cap * sizeof(char *));
-    if (!new_pool) {
-      C_CDD_FREE(dup);
-      return CDD_C_ERROR_MEMORY;
-    }
-    tree->string_pool = new_pool;
-    tree->string_capacity = new_cap;
-  }
-  tree->string_pool[tree->num_strings++] = dup;
-  *out_str = dup;
-  return CDD_C_SUCCESS;
+  return cdd_cst_arena_strndup(&tree->strings, str, strlen(str), out_str);
 }
 
 cdd_c_error_t cdd_cst_bld_snippet(cdd_cst_builder_t *builder,
@@ -2,6 +2,7 @@
 #include "cdd_cst_cfg.h"
 #include <errno.h>
 #include <stdlib.h>
+#include <string.h>
 #include "c_cdd/log.h"
 /* clang-format on */
 #ifdef CDD_BUILD_TESTS
@@ -88,28 +89,15 @@ static cdd_c_error_t add_edge(cdd_cst_cfg_block_t *from,
   return CDD_C_SUCCESS;
 }
 
-static cdd_c_error_t build_block(cdd_cst_cfg_t *cfg,
-                                 cdd_cst_cfg_block_t *curr_block,
-                                 cdd_cst_node_t *stmt) {
-  /* This is a skeletal stub that linearly links everything into one block
-     and handles simple returns by routing them to the exit block. */
-  cdd_c_error_t rc;
-  size_t i;
-  int is_return = 0;
-
-  /* Check for return token inside the node */
-  for (i = 0; i < stmt->num_children; i++) {
-    if (stmt->children[i].kind == CDD_CST_CHILD_TOKEN) {
-      if (stmt->children[i].val.token->kind == CDD_TOKEN_KEYWORD_RETURN) {
-        is_return = 1;
-        break;
-      }
-    }
-  }
-
-  if (curr_block->num_statements >= curr_block->capacity) {
+/* Adds children [begin, end) of `stmt` to a block. */
+static cdd_c_error_t append_stmt(cdd_cst_cfg_block_t *curr_block,
+                                 cdd_cst_node_t *stmt, size_t begin,
+                                 size_t end) {
+  size_t n = curr_block->num_statements;
+  if (n >= curr_block->capacity) {
     size_t new_cap = curr_block->capacity == 0 ? 8 : curr_block->capacity * 2;
     cdd_cst_node_t **new_arr;
+    cdd_cst_cfg_span_t *new_spans;
 #ifdef CDD_BUILD_TESTS
     if (g_cdd_cfg_alloc_fail && --g_cdd_cfg_alloc_fail == 0)
       new_arr = NULL;
@@ -122,59 +110,577 @@ static cdd_c_error_t build_block(cdd_cst_cfg_t *cfg,
       return CDD_C_ERROR_MEMORY;
     }
     curr_block->statements = new_arr;
+#ifdef CDD_BUILD_TESTS
+    if (g_cdd_cfg_alloc_fail && --g_cdd_cfg_alloc_fail == 0)
+      new_spans = NULL;
+    else
+#endif
+      new_spans = (cdd_cst_cfg_span_t *)realloc(
+          curr_block->spans, new_cap * sizeof(cdd_cst_cfg_span_t));
+    if (!new_spans) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      return CDD_C_ERROR_MEMORY;
+    }
+    curr_block->spans = new_spans;
     curr_block->capacity = new_cap;
   }
 
-  curr_block->statements[curr_block->num_statements++] = stmt;
+  curr_block->statements[n] = stmt;
+  curr_block->spans[n].begin = begin;
+  curr_block->spans[n].end = end;
+  curr_block->num_statements = n + 1;
+  return CDD_C_SUCCESS;
+}
+
+/* How a statement transfers control, from its leading token(s). */
+enum stmt_kind_t {
+  STMT_EMPTY,
+  STMT_PLAIN,
+  STMT_COMPOUND,
+  STMT_IF,
+  STMT_ELSE,
+  STMT_WHILE,
+  STMT_DO,
+  STMT_FOR,
+  STMT_SWITCH,
+  STMT_CASE,
+  STMT_LABEL,
+  STMT_RETURN,
+  STMT_BREAK,
+  STMT_CONTINUE,
+  STMT_GOTO
+};
+
+/* A label, or a `goto` waiting for its label to be seen. */
+typedef struct cfg_label_t {
+  const cdd_token_t *name;
+  cdd_cst_cfg_block_t *block;
+} cfg_label_t;
+
+typedef struct cfg_builder_t {
+  cdd_cst_cfg_t *cfg;
+  cdd_cst_cfg_block_t *cur; /* Fall-through block, NULL after a jump */
+  cdd_cst_cfg_block_t *break_to;
+  cdd_cst_cfg_block_t *continue_to;
+  cdd_cst_cfg_block_t *switch_head;
+  int switch_has_default;
+  cfg_label_t *labels;
+  size_t num_labels, labels_capacity;
+  cfg_label_t *gotos;
+  size_t num_gotos, gotos_capacity;
+} cfg_builder_t;
+
+static int token_is(const cdd_token_t *tok, const char *text) {
+  size_t len = strlen(text);
+  return tok && tok->length == len && memcmp(tok->start, text, len) == 0;
+}
+
+static const cdd_token_t *child_token(const cdd_cst_node_t *node, size_t i) {
+  if (i < node->num_children && node->children[i].kind == CDD_CST_CHILD_TOKEN)
+    return node->children[i].val.token;
+  return NULL;
+}
+
+static cdd_cst_node_t *body_block(const cdd_cst_node_t *node) {
+  size_t i = node->num_children;
+  while (i > 0) {
+    --i;
+    if (node->children[i].kind == CDD_CST_CHILD_NODE &&
+        node->children[i].val.node->kind == CDD_CST_BLOCK)
+      return node->children[i].val.node;
+  }
+  return NULL;
+}
+
+/* Index just past the parenthesised group opening at or after `from`. */
+static size_t skip_parens(const cdd_cst_node_t *node, size_t from) {
+  size_t i;
+  int depth = 0;
+  for (i = from; i < node->num_children; i++) {
+    const cdd_token_t *tok = child_token(node, i);
+    if (!tok)
+      continue;
+    if (tok->kind == CDD_TOKEN_LPAREN) {
+      depth++;
+    } else if (tok->kind == CDD_TOKEN_RPAREN) {
+      if (--depth <= 0)
+        return i + 1;
+    }
+  }
+  return node->num_children;
+}
+
+/* Finds the two `;` separating the clauses of `for (init; cond; step)`. */
+static int for_clauses(const cdd_cst_node_t *node, size_t *out_semi1,
+                       size_t *out_semi2) {
+  size_t i, found = 0;
+  int depth = 0;
+  for (i = 1; i < node->num_children; i++) {
+    const cdd_token_t *tok = child_token(node, i);
+    if (!tok)
+      continue;
+    if (tok->kind == CDD_TOKEN_LPAREN) {
+      depth++;
+    } else if (tok->kind == CDD_TOKEN_RPAREN) {
+      if (--depth <= 0)
+        break;
+    } else if (tok->kind == CDD_TOKEN_SEMICOLON && depth == 1) {
+      if (found++ == 0)
+        *out_semi1 = i;
+      else
+        *out_semi2 = i;
+    }
+  }
+  return found == 2;
+}
 
-  if (is_return) {
-    rc = add_edge(curr_block, cfg->exit_block, 0, 0);
+static enum stmt_kind_t classify(const cdd_cst_node_t *node, size_t at) {
+  const cdd_token_t *tok;
+  const cdd_token_t *next;
+  if (at >= node->num_children)
+    return STMT_EMPTY;
+  tok = child_token(node, at);
+  if (!tok) {
+    const cdd_cst_node_t *child = node->children[at].val.node;
+    return child->kind == CDD_CST_BLOCK ? STMT_COMPOUND : STMT_PLAIN;
+  }
+  next = child_token(node, at + 1);
+  switch (tok->kind) {
+  case CDD_TOKEN_KEYWORD_IF:
+    return STMT_IF;
+  case CDD_TOKEN_KEYWORD_ELSE:
+    return STMT_ELSE;
+  case CDD_TOKEN_KEYWORD_RETURN:
+    return STMT_RETURN;
+  case CDD_TOKEN_KEYWORD_GOTO:
+    return STMT_GOTO;
+  case CDD_TOKEN_IDENTIFIER:
+    break;
+  default:
+    return STMT_PLAIN;
+  }
+  if (token_is(tok, "while"))
+    return STMT_WHILE;
+  if (token_is(tok, "do"))
+    return STMT_DO;
+  if (token_is(tok, "for"))
+    return STMT_FOR;
+  if (token_is(tok, "switch"))
+    return STMT_SWITCH;
+  if (token_is(tok, "case") || token_is(tok, "default"))
+    return STMT_CASE;
+  if (token_is(tok, "break"))
+    return STMT_BREAK;
+  if (token_is(tok, "continue"))
+    return STMT_CONTINUE;
+  if (next && next->kind == CDD_TOKEN_COLON) {
+    const cdd_token_t *after = child_token(node, at + 2);
+    if (!after || after->kind != CDD_TOKEN_COLON)
+      return STMT_LABEL;
+  }
+  return STMT_PLAIN;
+}
+
+static cdd_c_error_t push_label(cfg_label_t **arr, size_t *count,
+                                size_t *capacity, const cdd_token_t *name,
+                                cdd_cst_cfg_block_t *block) {
+  if (*count >= *capacity) {
+    size_t new_cap = *capacity == 0 ? 4 : *capacity * 2;
+    cfg_label_t *new_arr;
+#ifdef CDD_BUILD_TESTS
+    if (g_cdd_cfg_alloc_fail && --g_cdd_cfg_alloc_fail == 0)
+      new_arr = NULL;
+    else
+#endif
+      new_arr = (cfg_label_t *)realloc(*arr, new_cap * sizeof(cfg_label_t));
+    if (!new_arr)
+      return CDD_C_ERROR_MEMORY;
+    *arr = new_arr;
+    *capacity = new_cap;
+  }
+  (*arr)[*count].name = name;
+  (*arr)[*count].block = block;
+  ++*count;
+  return CDD_C_SUCCESS;
+}
+
+/* Makes sure there is a block to append to; code after a jump gets a
+ * block without predecessors. */
+static cdd_c_error_t ensure_cur(cfg_builder_t *b) {
+  if (b->cur)
+    return CDD_C_SUCCESS;
+  return alloc_block(b->cfg, CDD_CST_CFG_BLOCK_NORMAL, &b->cur);
+}
+
+/* Starts a new block, falling through into it from the current one. */
+static cdd_c_error_t start_block(cfg_builder_t *b,
+                                 enum cdd_cst_cfg_block_kind_t kind) {
+  cdd_cst_cfg_block_t *block = NULL;
+  cdd_c_error_t rc = alloc_block(b->cfg, kind, &block);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  if (b->cur) {
+    rc = add_edge(b->cur, block, 0, 0);
     if (rc != CDD_C_SUCCESS)
       return rc;
   }
+  b->cur = block;
+  return CDD_C_SUCCESS;
+}
+
+/* If the statement at `at` is a jump, adds its edge from `from` and sets
+ * *out_jumped. */
+static cdd_c_error_t jump_edge(cfg_builder_t *b, const cdd_cst_node_t *node,
+                               size_t at, cdd_cst_cfg_block_t *from,
+                               int is_cond, int cond_val, int *out_jumped) {
+  cdd_cst_cfg_block_t *target = NULL;
+  *out_jumped = 1;
+  switch (classify(node, at)) {
+  case STMT_RETURN:
+    target = b->cfg->exit_block;
+    break;
+  case STMT_BREAK:
+    target = b->break_to ? b->break_to : b->cfg->exit_block;
+    break;
+  case STMT_CONTINUE:
+    target = b->continue_to ? b->continue_to : b->cfg->exit_block;
+    break;
+  case STMT_GOTO: {
+    const cdd_token_t *label = child_token(node, at + 1);
+    if (!label || label->kind != CDD_TOKEN_IDENTIFIER) {
+      target = b->cfg->exit_block;
+      break;
+    }
+    /* Resolved once every label has been seen; the edge is unconditional
+     * from a block of its own so it can be added later. */
+    if (is_cond) {
+      cdd_cst_cfg_block_t *via = NULL;
+      cdd_c_error_t rc = alloc_block(b->cfg, CDD_CST_CFG_BLOCK_NORMAL, &via);
+      if (rc != CDD_C_SUCCESS)
+        return rc;
+      rc = add_edge(from, via, is_cond, cond_val);
+      if (rc != CDD_C_SUCCESS)
+        return rc;
+      from = via;
+    }
+    return push_label(&b->gotos, &b->num_gotos, &b->gotos_capacity, label,
+                      from);
+  }
+  default:
+    *out_jumped = 0;
+    return CDD_C_SUCCESS;
+  }
+  return add_edge(from, target, is_cond, cond_val);
+}
 
+static cdd_c_error_t build_seq(cfg_builder_t *b, cdd_cst_node_t *block_node);
+static cdd_c_error_t build_stmt(cfg_builder_t *b, cdd_cst_node_t *list,
+                                size_t *idx);
+
+/* The sibling after `*idx` in `list` if it starts with `kind`. */
+static cdd_cst_node_t *next_sibling(const cdd_cst_node_t *list, size_t *idx,
+                                    enum stmt_kind_t kind) {
+  size_t i;
+  for (i = *idx + 1; i < list->num_children; i++) {
+    cdd_cst_node_t *node;
+    if (list->children[i].kind != CDD_CST_CHILD_NODE)
+      continue;
+    node = list->children[i].val.node;
+    if (classify(node, 0) != kind)
+      return NULL;
+    *idx = i;
+    return node;
+  }
+  return NULL;
+}
+
+/* Appends a simple statement from child `at` on, following it if it jumps. */
+static cdd_c_error_t build_simple(cfg_builder_t *b, cdd_cst_node_t *node,
+                                  size_t at) {
+  int jumped = 0;
+  cdd_c_error_t rc;
+  if (classify(node, at) == STMT_EMPTY && at > 0)
+    return CDD_C_SUCCESS;
+  if ((rc = ensure_cur(b)) != CDD_C_SUCCESS)
+    return rc;
+  if ((rc = append_stmt(b->cur, node, at, node->num_children)) !=
+      CDD_C_SUCCESS)
+    return rc;
+  if ((rc = jump_edge(b, node, at, b->cur, 0, 0, &jumped)) != CDD_C_SUCCESS)
+    return rc;
+  if (jumped)
+    b->cur = NULL;
   return CDD_C_SUCCESS;
 }
 
-static cdd_c_error_t walk_function_body(cdd_cst_cfg_t *cfg,
-                                        cdd_cst_node_t *function_node) {
-  cdd_cst_cfg_block_t *current = NULL;
-  size_t i, j;
+/* Builds the body of a control statement: its `{}` block, or the unbraced
+ * statement sharing its node from child `at`. */
+static cdd_c_error_t build_body(cfg_builder_t *b, cdd_cst_node_t *node,
+                                size_t at) {
+  cdd_cst_node_t *body = body_block(node);
+  if (body)
+    return build_seq(b, body);
+  return build_simple(b, node, at);
+}
+
+/* `if (c) ... [else ...]`, the `if` keyword being child `at` of `node`. */
+static cdd_c_error_t build_if(cfg_builder_t *b, cdd_cst_node_t *list,
+                              size_t *idx, cdd_cst_node_t *node, size_t at) {
+  cdd_cst_cfg_block_t *cond, *then_end = NULL, *else_end = NULL;
+  cdd_cst_node_t *else_node;
+  size_t body_at = skip_parens(node, at);
   cdd_c_error_t rc;
 
-  rc = alloc_block(cfg, CDD_CST_CFG_BLOCK_NORMAL, &current);
-  if (rc != CDD_C_SUCCESS)
+  if ((rc = start_block(b, CDD_CST_CFG_BLOCK_CONDITION)) != CDD_C_SUCCESS)
+    return rc;
+  cond = b->cur;
+  if ((rc = append_stmt(cond, node, at, body_at)) != CDD_C_SUCCESS)
     return rc;
 
-  rc = add_edge(cfg->entry_block, current, 0, 0);
-  if (rc != CDD_C_SUCCESS)
+  if ((rc = alloc_block(b->cfg, CDD_CST_CFG_BLOCK_NORMAL, &b->cur)) !=
+          CDD_C_SUCCESS ||
+      (rc = add_edge(cond, b->cur, 1, 1)) != CDD_C_SUCCESS)
+    return rc;
+  if ((rc = build_body(b, node, body_at)) != CDD_C_SUCCESS)
     return rc;
+  then_end = b->cur;
 
-  for (i = 0; i < function_node->num_children; i++) {
-    if (function_node->children[i].kind == CDD_CST_CHILD_NODE) {
-      cdd_cst_node_t *block_node = function_node->children[i].val.node;
-      if (block_node->kind == CDD_CST_BLOCK) {
-        for (j = 0; j < block_node->num_children; j++) {
-          if (block_node->children[j].kind == CDD_CST_CHILD_NODE) {
-            rc = build_block(cfg, current, block_node->children[j].val.node);
-            if (rc != CDD_C_SUCCESS)
-              return rc;
-          }
-        }
-      }
+  else_node = list ? next_sibling(list, idx, STMT_ELSE) : NULL;
+  if (else_node) {
+    if ((rc = alloc_block(b->cfg, CDD_CST_CFG_BLOCK_NORMAL, &b->cur)) !=
+            CDD_C_SUCCESS ||
+        (rc = add_edge(cond, b->cur, 1, 0)) != CDD_C_SUCCESS)
+      return rc;
+    if (classify(else_node, 1) == STMT_IF)
+      rc = build_if(b, list, idx, else_node, 1);
+    else
+      rc = build_body(b, else_node, 1);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    else_end = b->cur;
+  } else {
+    else_end = cond;
+  }
+
+  b->cur = NULL;
+  if (!then_end && !else_end)
+    return CDD_C_SUCCESS;
+  if ((rc = alloc_block(b->cfg, CDD_CST_CFG_BLOCK_NORMAL, &b->cur)) !=
+      CDD_C_SUCCESS)
+    return rc;
+  if (then_end && (rc = add_edge(then_end, b->cur, 0, 0)) != CDD_C_SUCCESS)
+    return rc;
+  if (else_end)
+    rc = add_edge(else_end, b->cur, else_end == cond, 0);
+  return rc;
+}
+
+/* `while (c) ...`, `for (...) ...`, `switch (c) ...` and `do ... while
+ * (c);`, whose tail is the sibling after `*idx`. */
+static cdd_c_error_t build_loop(cfg_builder_t *b, cdd_cst_node_t *list,
+                                size_t *idx, cdd_cst_node_t *node,
+                                enum stmt_kind_t kind) {
+  cdd_cst_cfg_block_t *head = NULL, *after = NULL, *body = NULL;
+  cdd_cst_cfg_block_t *latch = NULL;
+  size_t body_at = kind == STMT_DO ? 1 : skip_parens(node, 0);
+  size_t semi1 = 0, semi2 = 0;
+  cdd_cst_cfg_block_t *saved_break = b->break_to;
+  cdd_cst_cfg_block_t *saved_continue = b->continue_to;
+  cdd_cst_cfg_block_t *saved_switch = b->switch_head;
+  int saved_default = b->switch_has_default;
+  cdd_cst_node_t *tail = NULL;
+  cdd_c_error_t rc;
+
+  if (kind == STMT_DO) {
+    tail = next_sibling(list, idx, STMT_WHILE);
+    if ((rc = start_block(b, CDD_CST_CFG_BLOCK_NORMAL)) != CDD_C_SUCCESS)
+      return rc;
+    body = b->cur;
+    if ((rc = alloc_block(b->cfg, CDD_CST_CFG_BLOCK_CONDITION, &head)) !=
+        CDD_C_SUCCESS)
+      return rc;
+  } else if (kind == STMT_FOR && for_clauses(node, &semi1, &semi2)) {
+    /* The init runs once before the condition, the step in a latch block
+     * that `continue` and the end of the body lead to. */
+    if ((rc = ensure_cur(b)) != CDD_C_SUCCESS ||
+        (rc = append_stmt(b->cur, node, 0, semi1 + 1)) != CDD_C_SUCCESS ||
+        (rc = start_block(b, CDD_CST_CFG_BLOCK_CONDITION)) != CDD_C_SUCCESS)
+      return rc;
+    head = b->cur;
+    if ((rc = append_stmt(head, node, semi1 + 1, semi2 + 1)) !=
+            CDD_C_SUCCESS ||
+        (rc = alloc_block(b->cfg, CDD_CST_CFG_BLOCK_NORMAL, &latch)) !=
+            CDD_C_SUCCESS ||
+        (rc = append_stmt(latch, node, semi2 + 1, body_at)) !=
+            CDD_C_SUCCESS ||
+        (rc = add_edge(latch, head, 0, 0)) != CDD_C_SUCCESS)
+      return rc;
+  } else {
+    if ((rc = start_block(b, CDD_CST_CFG_BLOCK_CONDITION)) != CDD_C_SUCCESS)
+      return rc;
+    head = b->cur;
+    if ((rc = append_stmt(head, node, 0, body_at)) != CDD_C_SUCCESS)
+      return rc;
+  }
+  if ((rc = alloc_block(b->cfg, CDD_CST_CFG_BLOCK_NORMAL, &after)) !=
+      CDD_C_SUCCESS)
+    return rc;
+
+  b->break_to = after;
+  if (kind == STMT_SWITCH) {
+    b->switch_head = head;
+    b->switch_has_default = 0;
+    b->cur = NULL;
+  } else {
+    b->continue_to = latch ? latch : head;
+    if (kind != STMT_DO) {
+      if ((rc = alloc_block(b->cfg, CDD_CST_CFG_BLOCK_NORMAL, &body)) !=
+              CDD_C_SUCCESS ||
+          (rc = add_edge(head, body, 1, 1)) != CDD_C_SUCCESS)
+        return rc;
+      b->cur = body;
+    }
+  }
+  rc = build_body(b, node, body_at);
+  if (rc == CDD_C_SUCCESS && b->cur)
+    rc = add_edge(b->cur, kind == STMT_SWITCH ? after : b->continue_to, 0, 0);
+  if (rc == CDD_C_SUCCESS && kind == STMT_DO) {
+    if (tail)
+      rc = append_stmt(head, tail, 0, tail->num_children);
+    if (rc == CDD_C_SUCCESS)
+      rc = add_edge(head, body, 1, 1);
+  }
+  if (rc == CDD_C_SUCCESS && (kind != STMT_SWITCH || !b->switch_has_default))
+    rc = add_edge(head, after, 1, 0);
+
+  b->break_to = saved_break;
+  b->continue_to = saved_continue;
+  b->switch_head = saved_switch;
+  b->switch_has_default = saved_default;
+  b->cur = after;
+  return rc;
+}
+
+static cdd_c_error_t build_stmt(cfg_builder_t *b, cdd_cst_node_t *list,
+                                size_t *idx) {
+  cdd_cst_node_t *node = list->children[*idx].val.node;
+  enum stmt_kind_t kind = classify(node, 0);
+  int jumped = 0;
+  cdd_c_error_t rc;
+
+  switch (kind) {
+  case STMT_EMPTY:
+    return CDD_C_SUCCESS;
+  case STMT_COMPOUND:
+    return build_seq(b, node->children[0].val.node);
+  case STMT_IF:
+    return build_if(b, list, idx, node, 0);
+  case STMT_WHILE:
+  case STMT_FOR:
+  case STMT_DO:
+  case STMT_SWITCH:
+    return build_loop(b, list, idx, node, kind);
+  case STMT_ELSE:
+    /* Dangling `else`: keep its statements reachable */
+    return build_body(b, node, 1);
+  case STMT_CASE:
+  case STMT_LABEL: {
+    size_t at = 0;
+    if ((rc = start_block(b, CDD_CST_CFG_BLOCK_NORMAL)) != CDD_C_SUCCESS)
+      return rc;
+    if (kind == STMT_LABEL) {
+      rc = push_label(&b->labels, &b->num_labels, &b->labels_capacity,
+                      child_token(node, 0), b->cur);
+    } else if (b->switch_head) {
+      if (token_is(child_token(node, 0), "default"))
+        b->switch_has_default = 1;
+      rc = add_edge(b->switch_head, b->cur, 1, 1);
     }
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    if ((rc = append_stmt(b->cur, node, 0, node->num_children)) !=
+        CDD_C_SUCCESS)
+      return rc;
+    while (at < node->num_children) {
+      const cdd_token_t *tok = child_token(node, at++);
+      if (tok && tok->kind == CDD_TOKEN_COLON)
+        break;
+    }
+    if ((rc = jump_edge(b, node, at, b->cur, 0, 0, &jumped)) !=
+        CDD_C_SUCCESS)
+      return rc;
+    if (jumped)
+      b->cur = NULL;
+    return CDD_C_SUCCESS;
+  }
+  default:
+    return build_simple(b, node, 0);
   }
+}
 
-  /* Add edge to exit if current block doesn't unconditionally return */
-  if (current->successors == NULL) {
-    rc = add_edge(current, cfg->exit_block, 0, 0);
+static cdd_c_error_t build_seq(cfg_builder_t *b, cdd_cst_node_t *block_node) {
+  size_t i;
+  cdd_c_error_t rc;
+  for (i = 0; i < block_node->num_children; i++) {
+    if (block_node->children[i].kind != CDD_CST_CHILD_NODE)
+      continue;
+    rc = build_stmt(b, block_node, &i);
     if (rc != CDD_C_SUCCESS)
       return rc;
   }
+  return CDD_C_SUCCESS;
+}
 
+static cdd_c_error_t resolve_gotos(cfg_builder_t *b) {
+  size_t i, j;
+  cdd_c_error_t rc;
+  for (i = 0; i < b->num_gotos; i++) {
+    cdd_cst_cfg_block_t *target = b->cfg->exit_block;
+    const cdd_token_t *name = b->gotos[i].name;
+    for (j = 0; j < b->num_labels; j++) {
+      const cdd_token_t *label = b->labels[j].name;
+      if (label->length == name->length &&
+          memcmp(label->start, name->start, name->length) == 0) {
+        target = b->labels[j].block;
+        break;
+      }
+    }
+    rc = add_edge(b->gotos[i].block, target, 0, 0);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
   return CDD_C_SUCCESS;
 }
 
+static cdd_c_error_t walk_function_body(cdd_cst_cfg_t *cfg,
+                                        cdd_cst_node_t *function_node) {
+  cfg_builder_t b;
+  size_t i;
+  cdd_c_error_t rc;
+
+  memset(&b, 0, sizeof(b));
+  b.cfg = cfg;
+  rc = alloc_block(cfg, CDD_CST_CFG_BLOCK_NORMAL, &b.cur);
+  if (rc == CDD_C_SUCCESS)
+    rc = add_edge(cfg->entry_block, b.cur, 0, 0);
+
+  for (i = 0; rc == CDD_C_SUCCESS && i < function_node->num_children; i++) {
+    if (function_node->children[i].kind == CDD_CST_CHILD_NODE &&
+        function_node->children[i].val.node->kind == CDD_CST_BLOCK)
+      rc = build_seq(&b, function_node->children[i].val.node);
+  }
+
+  if (rc == CDD_C_SUCCESS)
+    rc = resolve_gotos(&b);
+  /* Falling off the end of the body */
+  if (rc == CDD_C_SUCCESS && b.cur)
+    rc = add_edge(b.cur, cfg->exit_block, 0, 0);
+
+  free(b.labels);
+  free(b.gotos);
+  return rc;
+}
+
 cdd_c_error_t cdd_cst_cfg_build(cdd_cst_node_t *function_node,
                                 cdd_cst_cfg_t **out_cfg) {
   cdd_cst_cfg_t *cfg;
@@ -236,6 +742,7 @@ void cdd_cst_cfg_free(cdd_cst_cfg_t *cfg) {
     }
     if (block->statements)
       free(block->statements);
+    free(block->spans);
     free(block);
   }
 
@@ -243,3 +750,36 @@ void cdd_cst_cfg_free(cdd_cst_cfg_t *cfg) {
     free(cfg->blocks);
   free(cfg);
 }
+
+cdd_c_error_t cdd_cst_cfg_condition(const cdd_cst_node_t *stmt,
+                                    size_t *out_begin, size_t *out_end) {
+  size_t at = 0, end;
+  const cdd_token_t *open;
+  if (!stmt || !out_begin || !out_end)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (classify(stmt, at) == STMT_ELSE)
+    at++;
+  switch (classify(stmt, at)) {
+  case STMT_IF:
+  case STMT_WHILE:
+  case STMT_FOR:
+  case STMT_SWITCH:
+    break;
+  default:
+    return CDD_C_ERROR_NOT_FOUND;
+  }
+  open = child_token(stmt, at + 1);
+  if (!open || open->kind != CDD_TOKEN_LPAREN)
+    return CDD_C_ERROR_NOT_FOUND;
+  end = skip_parens(stmt, at + 1);
+  *out_begin = at + 2;
+  *out_end = end > at + 2 ? end - 1 : at + 2;
+  if (classify(stmt, at) == STMT_FOR && at == 0) {
+    size_t semi1, semi2;
+    if (for_clauses(stmt, &semi1, &semi2)) {
+      *out_begin = semi1 + 1;
+      *out_end = semi2;
+    }
+  }
+  return CDD_C_SUCCESS;
+}
@@ -25,6 +25,14 @@ enum cdd_cst_cfg_block_kind_t {
 typedef struct cdd_cst_cfg_edge_t cdd_cst_cfg_edge_t;
 typedef struct cdd_cst_cfg_block_t cdd_cst_cfg_block_t;
 
+/**
+ * @brief The direct children of a statement that belong to a block.
+ */
+typedef struct cdd_cst_cfg_span_t {
+  size_t begin; /**< First child index */
+  size_t end;   /**< One past the last child index */
+} cdd_cst_cfg_span_t;
+
 /** @brief Struct definition */
 struct cdd_cst_cfg_edge_t {
   /** @brief target field */
@@ -48,6 +56,7 @@ struct cdd_cst_cfg_block_t {
   size_t num_statements;
   /** @brief capacity field */
   size_t capacity;                /**< capacity */
+  cdd_cst_cfg_span_t *spans;      /**< Per statement: its children here */
   cdd_cst_cfg_edge_t *successors; /**< successors */
   /** @brief entry_block field */
   cdd_cst_cfg_edge_t *predecessors;
@@ -70,6 +79,14 @@ struct cdd_cst_cfg_t {
 
 /**
  * @brief Constructs a Control Flow Graph (CFG) from a function definition node.
+ *
+ * `if`/`else`, `while`, `for`, `do`, `switch`/`case`, `break`, `continue`,
+ * `return`, `goto` and labels each end a basic block. A block holds the
+ * statements' direct tokens only, as a braced body is laid out in blocks of
+ * its own. Where one node spans several blocks (`if (c) x = 1;`, the init,
+ * condition and step of a `for`), each block gets the span of children it
+ * owns. Conditional edges carry the branch taken.
+ *
  * @param function_node The AST node representing the function.
  * @param out_cfg Pointer to store the constructed CFG.
  * @return 0 on success.
@@ -77,6 +94,19 @@ struct cdd_cst_cfg_t {
 C_CDD_EXPORT cdd_c_error_t cdd_cst_cfg_build(cdd_cst_node_t *function_node,
                                              cdd_cst_cfg_t **out_cfg);
 
+/**
+ * @brief Locates the controlling expression of an `if`, `else if`, `while`,
+ * `for` (its middle clause) or `switch` statement, or of a `do`-`while`
+ * tail.
+ * @param stmt A statement of a CFG block.
+ * @param out_begin Receives the index of its first child inside the parens.
+ * @param out_end Receives the index one past its last child.
+ * @return 0 on success, CDD_C_ERROR_NOT_FOUND for other statements.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_cst_cfg_condition(const cdd_cst_node_t *stmt,
+                                                 size_t *out_begin,
+                                                 size_t *out_end);
+
 /**
  * @brief Frees a CFG and all its blocks and edges.
  * @param cfg The CFG to free.
@@ -0,0 +1,680 @@
+/**
+ * @file cdd_cst_dataflow.c
+ * @brief Worklist solver, def/use table, reaching definitions and liveness.
+ * @author Samuel Marks
+ */
+
+/* clang-format off */
+#include <stdlib.h>
+#include <string.h>
+
+#include "cdd_cst_dataflow.h"
+#include "c_cdd/log.h"
+/* clang-format on */
+
+#ifdef CDD_BUILD_TESTS
+C_CDD_EXPORT int g_cdd_dataflow_alloc_fail = 0;
+#define DF_ALLOC_FAILS()                                                       \
+  (g_cdd_dataflow_alloc_fail && --g_cdd_dataflow_alloc_fail == 0)
+#else
+#define DF_ALLOC_FAILS() 0
+#endif
+
+enum { ROW_GEN, ROW_KILL, ROW_IN, ROW_OUT, ROWS_PER_BLOCK };
+
+static void *df_calloc(size_t n, size_t size) {
+  if (DF_ALLOC_FAILS())
+    return NULL;
+  return calloc(n ? n : 1, size);
+}
+
+static void *df_realloc(void *p, size_t n, size_t size) {
+  if (DF_ALLOC_FAILS())
+    return NULL;
+  return realloc(p, (n ? n : 1) * size);
+}
+
+static cdd_cst_bitset_word_t *row(const cdd_cst_dataflow_t *df, size_t block,
+                                  int which) {
+  return df->sets + (block * ROWS_PER_BLOCK + (size_t)which) * df->n_words;
+}
+
+cdd_c_error_t cdd_cst_dataflow_init(cdd_cst_dataflow_t *df,
+                                    const cdd_cst_cfg_t *cfg, size_t n_facts,
+                                    enum cdd_cst_dataflow_direction_t direction,
+                                    enum cdd_cst_dataflow_meet_t meet) {
+  size_t n_rows;
+  if (!df || !cfg)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  memset(df, 0, sizeof(*df));
+  df->cfg = cfg;
+  df->direction = direction;
+  df->meet = meet;
+  df->n_facts = n_facts;
+  df->n_words = CDD_CST_BITSET_WORDS(n_facts);
+  n_rows = cfg->num_blocks * ROWS_PER_BLOCK + 1;
+  df->sets = (cdd_cst_bitset_word_t *)df_calloc(
+      n_rows * df->n_words, sizeof(cdd_cst_bitset_word_t));
+  if (!df->sets) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+  return CDD_C_SUCCESS;
+}
+
+void cdd_cst_dataflow_free(cdd_cst_dataflow_t *df) {
+  if (!df)
+    return;
+  free(df->sets);
+  df->sets = NULL;
+}
+
+cdd_cst_bitset_word_t *cdd_cst_dataflow_gen(const cdd_cst_dataflow_t *df,
+                                            size_t block) {
+  return row(df, block, ROW_GEN);
+}
+
+cdd_cst_bitset_word_t *cdd_cst_dataflow_kill(const cdd_cst_dataflow_t *df,
+                                             size_t block) {
+  return row(df, block, ROW_KILL);
+}
+
+cdd_cst_bitset_word_t *cdd_cst_dataflow_in(const cdd_cst_dataflow_t *df,
+                                           size_t block) {
+  return row(df, block, ROW_IN);
+}
+
+cdd_cst_bitset_word_t *cdd_cst_dataflow_out(const cdd_cst_dataflow_t *df,
+                                            size_t block) {
+  return row(df, block, ROW_OUT);
+}
+
+cdd_cst_bitset_word_t *
+cdd_cst_dataflow_boundary(const cdd_cst_dataflow_t *df) {
+  return row(df, df->cfg->num_blocks, ROW_GEN);
+}
+
+void cdd_cst_dataflow_apply_gen(cdd_cst_dataflow_t *df, size_t block,
+                                size_t fact) {
+  CDD_CST_BITSET_SET(row(df, block, ROW_GEN), fact);
+}
+
+void cdd_cst_dataflow_apply_kill(cdd_cst_dataflow_t *df, size_t block,
+                                 size_t fact) {
+  CDD_CST_BITSET_CLEAR(row(df, block, ROW_GEN), fact);
+  CDD_CST_BITSET_SET(row(df, block, ROW_KILL), fact);
+}
+
+/* Blocks in reverse postorder of the flow direction, unreachable ones
+ * last, so most blocks see their inputs before they are visited. */
+static cdd_c_error_t flow_order(const cdd_cst_dataflow_t *df,
+                                size_t *order) {
+  const cdd_cst_cfg_t *cfg = df->cfg;
+  const int forward = df->direction == CDD_CST_DATAFLOW_FORWARD;
+  const size_t n = cfg->num_blocks;
+  cdd_cst_cfg_edge_t **stack_edge;
+  size_t *stack_block;
+  unsigned char *seen;
+  size_t depth = 0, post = n, i;
+  const cdd_cst_cfg_block_t *start =
+      forward ? cfg->entry_block : cfg->exit_block;
+
+  stack_edge = (cdd_cst_cfg_edge_t **)df_calloc(n, sizeof(*stack_edge));
+  stack_block = (size_t *)df_calloc(n, sizeof(size_t));
+  seen = (unsigned char *)df_calloc(n, 1);
+  if (!stack_edge || !stack_block || !seen) {
+    free(stack_edge);
+    free(stack_block);
+    free(seen);
+    return CDD_C_ERROR_MEMORY;
+  }
+
+  if (start) {
+    seen[start->id] = 1;
+    stack_block[0] = (size_t)start->id;
+    stack_edge[0] = forward ? start->successors : start->predecessors;
+    depth = 1;
+  }
+  while (depth > 0) {
+    cdd_cst_cfg_edge_t *e = stack_edge[depth - 1];
+    if (!e) {
+      order[--post] = stack_block[--depth];
+      continue;
+    }
+    stack_edge[depth - 1] = e->next;
+    if (!seen[e->target->id]) {
+      seen[e->target->id] = 1;
+      stack_block[depth] = (size_t)e->target->id;
+      stack_edge[depth] =
+          forward ? e->target->successors : e->target->predecessors;
+      depth++;
+    }
+  }
+  /* Reached blocks fill order[post, n); the unreachable ones go after */
+  {
+    size_t reached = n - post, k = 0;
+    memmove(order, order + post, reached * sizeof(size_t));
+    for (i = 0; i < n; i++) {
+      if (!seen[i])
+        order[reached + k++] = i;
+    }
+  }
+  free(stack_edge);
+  free(stack_block);
+  free(seen);
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t cdd_cst_dataflow_solve(cdd_cst_dataflow_t *df) {
+  const cdd_cst_cfg_t *cfg;
+  const int forward = df && df->direction == CDD_CST_DATAFLOW_FORWARD;
+  const int must = df && df->meet == CDD_CST_DATAFLOW_INTERSECTION;
+  size_t n, w, i, head = 0, queued;
+  size_t *queue;
+  unsigned char *in_queue;
+  cdd_cst_bitset_word_t tail_mask;
+  cdd_c_error_t rc;
+
+  if (!df || !df->sets)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  cfg = df->cfg;
+  n = cfg->num_blocks;
+  df->iterations = 0;
+  if (n == 0)
+    return CDD_C_SUCCESS;
+
+  tail_mask = df->n_facts % CDD_CST_BITSET_WORD_BITS
+                  ? (1UL << (df->n_facts % CDD_CST_BITSET_WORD_BITS)) - 1
+                  : ~0UL;
+
+  queue = (size_t *)df_calloc(n, sizeof(size_t));
+  in_queue = (unsigned char *)df_calloc(n, 1);
+  if (!queue || !in_queue) {
+    free(queue);
+    free(in_queue);
+    return CDD_C_ERROR_MEMORY;
+  }
+  rc = flow_order(df, queue);
+  if (rc != CDD_C_SUCCESS) {
+    free(queue);
+    free(in_queue);
+    return rc;
+  }
+
+  /* "May" problems start from nothing, "must" problems from everything */
+  for (i = 0; i < n; i++) {
+    cdd_cst_bitset_word_t *result =
+        row(df, i, forward ? ROW_OUT : ROW_IN);
+    for (w = 0; w < df->n_words; w++)
+      result[w] = must ? ~0UL : 0UL;
+    if (must && df->n_words)
+      result[df->n_words - 1] &= tail_mask;
+    in_queue[i] = 1;
+  }
+
+  queued = n;
+  while (queued > 0) {
+    const size_t b = queue[head];
+    const cdd_cst_cfg_block_t *block = cfg->blocks[b];
+    const cdd_cst_cfg_edge_t *e =
+        forward ? block->predecessors : block->successors;
+    cdd_cst_bitset_word_t *meet_row = row(df, b, forward ? ROW_IN : ROW_OUT);
+    cdd_cst_bitset_word_t *result = row(df, b, forward ? ROW_OUT : ROW_IN);
+    const cdd_cst_bitset_word_t *gen = row(df, b, ROW_GEN);
+    const cdd_cst_bitset_word_t *kill = row(df, b, ROW_KILL);
+    int changed = 0;
+
+    head = (head + 1) % n;
+    queued--;
+    in_queue[b] = 0;
+    df->iterations++;
+
+    if (!e || block == (forward ? cfg->entry_block : cfg->exit_block)) {
+      memcpy(meet_row, cdd_cst_dataflow_boundary(df),
+             df->n_words * sizeof(cdd_cst_bitset_word_t));
+    } else {
+      for (w = 0; w < df->n_words; w++)
+        meet_row[w] = must ? ~0UL : 0UL;
+      for (; e; e = e->next) {
+        const cdd_cst_bitset_word_t *other =
+            row(df, (size_t)e->target->id, forward ? ROW_OUT : ROW_IN);
+        for (w = 0; w < df->n_words; w++) {
+          if (must)
+            meet_row[w] &= other[w];
+          else
+            meet_row[w] |= other[w];
+        }
+      }
+      if (must && df->n_words)
+        meet_row[df->n_words - 1] &= tail_mask;
+    }
+
+    for (w = 0; w < df->n_words; w++) {
+      const cdd_cst_bitset_word_t next = gen[w] | (meet_row[w] & ~kill[w]);
+      if (next != result[w]) {
+        result[w] = next;
+        changed = 1;
+      }
+    }
+
+    if (changed) {
+      for (e = forward ? block->successors : block->predecessors; e;
+           e = e->next) {
+        const size_t t = (size_t)e->target->id;
+        if (!in_queue[t]) {
+          in_queue[t] = 1;
+          queue[(head + queued) % n] = t;
+          queued++;
+        }
+      }
+    }
+  }
+
+  free(queue);
+  free(in_queue);
+  return CDD_C_SUCCESS;
+}
+
+/* --- def/use --- */
+
+static const char *const TYPE_WORDS[] = {
+    "_Bool",  "auto",     "bool",   "char",     "const",  "double",
+    "enum",   "extern",   "float",  "inline",   "long",   "register",
+    "restrict", "short",  "signed", "static",   "typedef", "union",
+    "unsigned", "void",   "volatile", NULL};
+
+static const char *const STMT_WORDS[] = {
+    "break", "case",  "continue", "default", "do",
+    "for",   "sizeof", "switch",  "while",   NULL};
+
+static int in_words(const cdd_token_t *tok, const char *const *words) {
+  for (; *words; words++) {
+    const size_t len = strlen(*words);
+    if (tok->length == len && memcmp(tok->start, *words, len) == 0)
+      return 1;
+  }
+  return 0;
+}
+
+static const cdd_token_t *tok_at(const cdd_cst_node_t *stmt, size_t i) {
+  if (i < stmt->num_children && stmt->children[i].kind == CDD_CST_CHILD_TOKEN)
+    return stmt->children[i].val.token;
+  return NULL;
+}
+
+static const cdd_token_t *tok_before(const cdd_cst_node_t *stmt, size_t i) {
+  return i > 0 ? tok_at(stmt, i - 1) : NULL;
+}
+
+static int is_type_word(const cdd_token_t *tok) {
+  if (!tok)
+    return 0;
+  if ((tok->kind >= CDD_TOKEN_KEYWORD_INT &&
+       tok->kind <= CDD_TOKEN_KEYWORD_STRUCT))
+    return 1;
+  return tok->kind == CDD_TOKEN_IDENTIFIER && in_words(tok, TYPE_WORDS);
+}
+
+static int is_variable_word(const cdd_token_t *tok) {
+  return tok && tok->kind == CDD_TOKEN_IDENTIFIER &&
+         !in_words(tok, TYPE_WORDS) && !in_words(tok, STMT_WORDS);
+}
+
+static int adjacent(const cdd_token_t *a, const cdd_token_t *b) {
+  return a && b && a->offset + a->length == b->offset;
+}
+
+static int is_op(const cdd_token_t *tok, char c) {
+  return tok && tok->length == 1 && tok->start[0] == c;
+}
+
+/* `++`/`--` as two adjacent tokens starting at child i */
+static int is_step_op(const cdd_cst_node_t *stmt, size_t i) {
+  const cdd_token_t *a = tok_at(stmt, i), *b = tok_at(stmt, i + 1);
+  return adjacent(a, b) && ((is_op(a, '+') && is_op(b, '+')) ||
+                            (is_op(a, '-') && is_op(b, '-')));
+}
+
+static int is_qualifier(const cdd_token_t *tok) {
+  return tok && tok->kind == CDD_TOKEN_IDENTIFIER &&
+         ((tok->length == 5 && memcmp(tok->start, "const", 5) == 0) ||
+          (tok->length == 8 && (memcmp(tok->start, "volatile", 8) == 0 ||
+                                memcmp(tok->start, "restrict", 8) == 0)));
+}
+
+static int token_is(const cdd_token_t *tok, const char *text) {
+  const size_t len = strlen(text);
+  return tok && tok->length == len && memcmp(tok->start, text, len) == 0;
+}
+
+/* Whether the name at child i is the declarator of a declaration: after a
+ * type (then `*`s and qualifiers) that starts the statement or `for (`. */
+static int is_declarator(const cdd_cst_node_t *stmt, size_t i) {
+  size_t j = i;
+  const cdd_token_t *t;
+  while (j > 0 && (t = tok_at(stmt, j - 1)) != NULL &&
+         (t->kind == CDD_TOKEN_STAR || is_qualifier(t)))
+    j--;
+  t = tok_before(stmt, j);
+  if (!t || !(is_type_word(t) || is_variable_word(t)))
+    return 0;
+  j--;
+  while (j > 0 && is_type_word(tok_at(stmt, j - 1)))
+    j--;
+  t = tok_before(stmt, j);
+  if (!t)
+    return 1;
+  if (t->kind == CDD_TOKEN_SEMICOLON || t->kind == CDD_TOKEN_LBRACE)
+    return 1;
+  return t->kind == CDD_TOKEN_LPAREN &&
+         token_is(tok_before(stmt, j - 1), "for");
+}
+
+cdd_c_error_t cdd_cst_defuse_classify(const cdd_cst_node_t *stmt, size_t i,
+                                      unsigned *out_flags) {
+  const cdd_token_t *tok, *prev, *next, *after;
+  if (!stmt || !out_flags)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out_flags = 0;
+  tok = tok_at(stmt, i);
+  if (!is_variable_word(tok))
+    return CDD_C_ERROR_NOT_FOUND;
+  prev = tok_before(stmt, i);
+  next = tok_at(stmt, i + 1);
+  after = tok_at(stmt, i + 2);
+
+  if (next && next->kind == CDD_TOKEN_LPAREN)
+    return CDD_C_ERROR_NOT_FOUND; /* callee */
+  if (prev && (prev->kind == CDD_TOKEN_DOT || prev->kind == CDD_TOKEN_ARROW))
+    return CDD_C_ERROR_NOT_FOUND; /* member */
+  if (prev && (prev->kind == CDD_TOKEN_KEYWORD_GOTO ||
+               prev->kind == CDD_TOKEN_KEYWORD_STRUCT ||
+               token_is(prev, "enum") || token_is(prev, "union")))
+    return CDD_C_ERROR_NOT_FOUND; /* label or tag */
+  if (prev && prev->kind == CDD_TOKEN_COLON && i >= 2 &&
+      tok_at(stmt, i - 2) && tok_at(stmt, i - 2)->kind == CDD_TOKEN_COLON)
+    return CDD_C_ERROR_NOT_FOUND; /* qualified name */
+  if (i == 0 && next && next->kind == CDD_TOKEN_COLON &&
+      !(after && after->kind == CDD_TOKEN_COLON))
+    return CDD_C_ERROR_NOT_FOUND; /* label */
+  if (next && is_variable_word(next))
+    return CDD_C_ERROR_NOT_FOUND; /* type name of a declaration */
+
+  if (is_declarator(stmt, i)) {
+    *out_flags = CDD_CST_DEFUSE_DEF;
+    return CDD_C_SUCCESS;
+  }
+  if (prev && prev->kind == CDD_TOKEN_STAR && !is_step_op(stmt, i + 1)) {
+    /* `*x = e` writes through x */
+    *out_flags = CDD_CST_DEFUSE_USE;
+    return CDD_C_SUCCESS;
+  }
+  if (next && next->kind == CDD_TOKEN_ASSIGN) {
+    *out_flags = CDD_CST_DEFUSE_DEF;
+    return CDD_C_SUCCESS;
+  }
+  /* x += e, x -= e, x *= e, x /= e, x %= e, x &= e, x |= e, x ^= e */
+  if (next && after && after->kind == CDD_TOKEN_ASSIGN &&
+      adjacent(next, after) &&
+      (is_op(next, '+') || is_op(next, '-') || is_op(next, '*') ||
+       is_op(next, '/') || is_op(next, '%') || is_op(next, '&') ||
+       is_op(next, '|') || is_op(next, '^'))) {
+    *out_flags = CDD_CST_DEFUSE_DEF | CDD_CST_DEFUSE_USE;
+    return CDD_C_SUCCESS;
+  }
+  if (is_step_op(stmt, i + 1) || (i >= 2 && is_step_op(stmt, i - 2))) {
+    *out_flags = CDD_CST_DEFUSE_DEF | CDD_CST_DEFUSE_USE;
+    return CDD_C_SUCCESS;
+  }
+  *out_flags = CDD_CST_DEFUSE_USE;
+  return CDD_C_SUCCESS;
+}
+
+static size_t hash_name(const char *name, size_t len) {
+  size_t h = 2166136261u, i;
+  for (i = 0; i < len; i++)
+    h = (h ^ (unsigned char)name[i]) * 16777619u;
+  return h;
+}
+
+static size_t *find_slot(const cdd_cst_defuse_t *du, const char *name,
+                         size_t len) {
+  size_t i = hash_name(name, len) & (du->n_slots - 1);
+  for (;;) {
+    size_t *slot = &du->var_slots[i];
+    if (*slot == 0)
+      return slot;
+    {
+      const cdd_token_t *var = du->vars[*slot - 1];
+      if (var->length == len && memcmp(var->start, name, len) == 0)
+        return slot;
+    }
+    i = (i + 1) & (du->n_slots - 1);
+  }
+}
+
+/* Slots hold var index + 1, 0 meaning empty; kept under half full */
+static cdd_c_error_t intern_var(cdd_cst_defuse_t *du, const cdd_token_t *tok,
+                                size_t *vars_capacity, size_t *out_var) {
+  size_t *slot;
+  if ((du->n_vars + 1) * 2 > du->n_slots) {
+    const size_t n_slots = du->n_slots ? du->n_slots * 2 : 64;
+    size_t *slots = (size_t *)df_calloc(n_slots, sizeof(size_t));
+    size_t i;
+    if (!slots)
+      return CDD_C_ERROR_MEMORY;
+    free(du->var_slots);
+    du->var_slots = slots;
+    du->n_slots = n_slots;
+    for (i = 0; i < du->n_vars; i++)
+      *find_slot(du, (const char *)du->vars[i]->start, du->vars[i]->length) =
+          i + 1;
+  }
+  slot = find_slot(du, (const char *)tok->start, tok->length);
+  if (*slot) {
+    *out_var = *slot - 1;
+    return CDD_C_SUCCESS;
+  }
+  if (du->n_vars >= *vars_capacity) {
+    const size_t cap = *vars_capacity ? *vars_capacity * 2 : 16;
+    const cdd_token_t **vars =
+        (const cdd_token_t **)df_realloc((void *)du->vars, cap, sizeof(*vars));
+    size_t *first_def;
+    if (!vars)
+      return CDD_C_ERROR_MEMORY;
+    du->vars = vars;
+    first_def = (size_t *)df_realloc(du->first_def, cap, sizeof(size_t));
+    if (!first_def)
+      return CDD_C_ERROR_MEMORY;
+    du->first_def = first_def;
+    *vars_capacity = cap;
+  }
+  du->vars[du->n_vars] = tok;
+  du->first_def[du->n_vars] = (size_t)-1;
+  *slot = ++du->n_vars;
+  *out_var = du->n_vars - 1;
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t cdd_cst_defuse_build(const cdd_cst_cfg_t *cfg,
+                                   cdd_cst_defuse_t *out) {
+  size_t b, s, i, vars_capacity = 0, defs_capacity = 0;
+  size_t *last_def = NULL;
+  size_t last_capacity = 0;
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+
+  if (!cfg || !out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  memset(out, 0, sizeof(*out));
+  out->block_defs =
+      (size_t *)df_calloc(cfg->num_blocks + 1, sizeof(size_t));
+  if (!out->block_defs)
+    return CDD_C_ERROR_MEMORY;
+
+  for (b = 0; b < cfg->num_blocks && rc == CDD_C_SUCCESS; b++) {
+    const cdd_cst_cfg_block_t *block = cfg->blocks[b];
+    out->block_defs[b] = out->n_defs;
+    for (s = 0; s < block->num_statements && rc == CDD_C_SUCCESS; s++) {
+      cdd_cst_node_t *stmt = block->statements[s];
+      for (i = block->spans[s].begin; i < block->spans[s].end; i++) {
+        unsigned flags = 0;
+        size_t var = 0;
+        cdd_cst_def_t *def;
+        if (cdd_cst_defuse_classify(stmt, i, &flags) != CDD_C_SUCCESS)
+          continue;
+        rc = intern_var(out, stmt->children[i].val.token, &vars_capacity,
+                        &var);
+        if (rc != CDD_C_SUCCESS)
+          break;
+        if (!(flags & CDD_CST_DEFUSE_DEF))
+          continue;
+        if (out->n_defs >= defs_capacity) {
+          const size_t cap = defs_capacity ? defs_capacity * 2 : 16;
+          cdd_cst_def_t *defs = (cdd_cst_def_t *)df_realloc(
+              out->defs, cap, sizeof(cdd_cst_def_t));
+          if (!defs) {
+            rc = CDD_C_ERROR_MEMORY;
+            break;
+          }
+          out->defs = defs;
+          defs_capacity = cap;
+        }
+        if (out->n_vars > last_capacity) {
+          const size_t cap = vars_capacity;
+          size_t *grown = (size_t *)df_realloc(last_def, cap, sizeof(size_t));
+          if (!grown) {
+            rc = CDD_C_ERROR_MEMORY;
+            break;
+          }
+          last_def = grown;
+          last_capacity = cap;
+        }
+        def = &out->defs[out->n_defs];
+        def->stmt = stmt;
+        def->child = i;
+        def->block = b;
+        def->var = var;
+        def->next_of_var = (size_t)-1;
+        def->is_declaration = is_declarator(stmt, i);
+        def->tok = stmt->children[i].val.token;
+        if (out->first_def[var] == (size_t)-1)
+          out->first_def[var] = out->n_defs;
+        else
+          out->defs[last_def[var]].next_of_var = out->n_defs;
+        last_def[var] = out->n_defs;
+        out->n_defs++;
+      }
+    }
+  }
+  free(last_def);
+  if (rc != CDD_C_SUCCESS) {
+    cdd_cst_defuse_free(out);
+    return rc;
+  }
+  out->block_defs[cfg->num_blocks] = out->n_defs;
+
+  /* "None" is n_defs, which is only known now */
+  for (i = 0; i < out->n_vars; i++) {
+    if (out->first_def[i] == (size_t)-1)
+      out->first_def[i] = out->n_defs;
+  }
+  for (i = 0; i < out->n_defs; i++) {
+    if (out->defs[i].next_of_var == (size_t)-1)
+      out->defs[i].next_of_var = out->n_defs;
+  }
+  return CDD_C_SUCCESS;
+}
+
+void cdd_cst_defuse_free(cdd_cst_defuse_t *du) {
+  if (!du)
+    return;
+  free((void *)du->vars);
+  free(du->first_def);
+  free(du->defs);
+  free(du->block_defs);
+  free(du->var_slots);
+  memset(du, 0, sizeof(*du));
+}
+
+cdd_c_error_t cdd_cst_defuse_find_var(const cdd_cst_defuse_t *du,
+                                      const char *name, size_t len,
+                                      size_t *out_var) {
+  size_t *slot;
+  if (!du || !name || !out_var)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (du->n_slots == 0)
+    return CDD_C_ERROR_NOT_FOUND;
+  slot = find_slot(du, name, len);
+  if (*slot == 0)
+    return CDD_C_ERROR_NOT_FOUND;
+  *out_var = *slot - 1;
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t cdd_cst_dataflow_reaching_defs(const cdd_cst_cfg_t *cfg,
+                                             const cdd_cst_defuse_t *du,
+                                             cdd_cst_dataflow_t *out) {
+  size_t b, d, other;
+  cdd_c_error_t rc;
+  if (!cfg || !du || !out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  rc = cdd_cst_dataflow_init(out, cfg, du->n_defs, CDD_CST_DATAFLOW_FORWARD,
+                             CDD_CST_DATAFLOW_UNION);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  for (b = 0; b < cfg->num_blocks; b++) {
+    for (d = du->block_defs[b]; d < du->block_defs[b + 1]; d++) {
+      for (other = du->first_def[du->defs[d].var]; other < du->n_defs;
+           other = du->defs[other].next_of_var)
+        cdd_cst_dataflow_apply_kill(out, b, other);
+      cdd_cst_dataflow_apply_gen(out, b, d);
+    }
+  }
+  rc = cdd_cst_dataflow_solve(out);
+  if (rc != CDD_C_SUCCESS)
+    cdd_cst_dataflow_free(out);
+  return rc;
+}
+
+cdd_c_error_t cdd_cst_dataflow_liveness(const cdd_cst_cfg_t *cfg,
+                                        const cdd_cst_defuse_t *du,
+                                        cdd_cst_dataflow_t *out) {
+  size_t b, s, i;
+  cdd_c_error_t rc;
+  if (!cfg || !du || !out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  rc = cdd_cst_dataflow_init(out, cfg, du->n_vars, CDD_CST_DATAFLOW_BACKWARD,
+                             CDD_CST_DATAFLOW_UNION);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  for (b = 0; b < cfg->num_blocks; b++) {
+    const cdd_cst_cfg_block_t *block = cfg->blocks[b];
+    for (s = block->num_statements; s > 0; s--) {
+      const cdd_cst_node_t *stmt = block->statements[s - 1];
+      int pass;
+      /* Backwards through a statement: its writes, then its reads */
+      for (pass = 0; pass < 2; pass++) {
+        for (i = block->spans[s - 1].begin; i < block->spans[s - 1].end;
+             i++) {
+          unsigned flags = 0;
+          size_t var = 0;
+          const cdd_token_t *tok;
+          if (cdd_cst_defuse_classify(stmt, i, &flags) != CDD_C_SUCCESS)
+            continue;
+          tok = stmt->children[i].val.token;
+          if (cdd_cst_defuse_find_var(du, (const char *)tok->start,
+                                      tok->length, &var) != CDD_C_SUCCESS)
+            continue;
+          if (pass == 0 && (flags & CDD_CST_DEFUSE_DEF))
+            cdd_cst_dataflow_apply_kill(out, b, var);
+          else if (pass == 1 && (flags & CDD_CST_DEFUSE_USE))
+            cdd_cst_dataflow_apply_gen(out, b, var);
+        }
+      }
+    }
+  }
+  rc = cdd_cst_dataflow_solve(out);
+  if (rc != CDD_C_SUCCESS)
+    cdd_cst_dataflow_free(out);
+  return rc;
+}
@@ -0,0 +1,267 @@
+/**
+ * @file cdd_cst_dataflow.h
+ * @brief Bit-vector dataflow analyses over the blocks of a `cdd_cst_cfg_t`.
+ *
+ * A problem is a set of numbered facts, a direction and a meet operator.
+ * The client records per-block gen/kill sets (`cdd_cst_dataflow_apply_*`,
+ * statement by statement) and `cdd_cst_dataflow_solve` computes the fixed
+ * point with a worklist seeded in reverse postorder. Every set is a row of
+ * `n_words` words in one allocation, so a meet or transfer is a loop over
+ * words rather than over facts.
+ *
+ * Two classic problems are provided over a def/use table of the function's
+ * variables (identifiers compared by spelling; scopes are not modelled):
+ * reaching definitions and live variables. Clients with their own facts
+ * (e.g. "this allocation has been NULL-checked") use the solver directly.
+ *
+ * @author Samuel Marks
+ */
+
+#ifndef CDD_CST_DATAFLOW_H
+#define CDD_CST_DATAFLOW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include <limits.h>
+#include <stddef.h>
+
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+#include "cdd_cst_cfg.h"
+#include "cdd_cst_node.h"
+/* clang-format on */
+
+/** @brief Word of a dense bitset. */
+typedef unsigned long cdd_cst_bitset_word_t;
+
+/** @brief Bits per bitset word. */
+#define CDD_CST_BITSET_WORD_BITS (sizeof(cdd_cst_bitset_word_t) * CHAR_BIT)
+/** @brief Words needed for `n` bits. */
+#define CDD_CST_BITSET_WORDS(n)                                                \
+  (((n) + CDD_CST_BITSET_WORD_BITS - 1) / CDD_CST_BITSET_WORD_BITS)
+/** @brief Tests bit `i` of `set`. */
+#define CDD_CST_BITSET_TEST(set, i)                                            \
+  (((set)[(i) / CDD_CST_BITSET_WORD_BITS] >>                                   \
+    ((i) % CDD_CST_BITSET_WORD_BITS)) &                                        \
+   1UL)
+/** @brief Sets bit `i` of `set`. */
+#define CDD_CST_BITSET_SET(set, i)                                             \
+  ((set)[(i) / CDD_CST_BITSET_WORD_BITS] |= 1UL                                \
+                                            << ((i) % CDD_CST_BITSET_WORD_BITS))
+/** @brief Clears bit `i` of `set`. */
+#define CDD_CST_BITSET_CLEAR(set, i)                                           \
+  ((set)[(i) / CDD_CST_BITSET_WORD_BITS] &=                                    \
+   ~(1UL << ((i) % CDD_CST_BITSET_WORD_BITS)))
+
+/**
+ * @brief Direction in which facts flow.
+ */
+enum cdd_cst_dataflow_direction_t {
+  CDD_CST_DATAFLOW_FORWARD, /**< From predecessors, e.g. reaching defs */
+  CDD_CST_DATAFLOW_BACKWARD /**< From successors, e.g. liveness */
+};
+
+/**
+ * @brief How facts from several edges combine.
+ */
+enum cdd_cst_dataflow_meet_t {
+  CDD_CST_DATAFLOW_UNION,       /**< Holds on some path ("may") */
+  CDD_CST_DATAFLOW_INTERSECTION /**< Holds on every path ("must") */
+};
+
+/**
+ * @brief A dataflow problem and, once solved, its solution.
+ */
+typedef struct cdd_cst_dataflow_t {
+  const cdd_cst_cfg_t *cfg;                    /**< Graph being analysed */
+  enum cdd_cst_dataflow_direction_t direction; /**< Flow direction */
+  enum cdd_cst_dataflow_meet_t meet;           /**< Meet operator */
+  size_t n_facts;                              /**< Facts per set */
+  size_t n_words;                              /**< Words per set */
+  /**
+   * @brief gen, kill, in and out rows of every block, then the boundary
+   * row (facts holding at entry, or at exit when backward; empty unless set)
+   */
+  cdd_cst_bitset_word_t *sets;
+  size_t iterations; /**< Blocks visited by the last solve */
+} cdd_cst_dataflow_t;
+
+/**
+ * @brief Prepares a problem with empty gen/kill sets.
+ * @param df The problem to initialize.
+ * @param cfg The graph; block ids must be indices into `cfg->blocks`.
+ * @param n_facts Number of facts.
+ * @param direction Flow direction.
+ * @param meet Meet operator.
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_cst_dataflow_init(cdd_cst_dataflow_t *df, const cdd_cst_cfg_t *cfg,
+                      size_t n_facts,
+                      enum cdd_cst_dataflow_direction_t direction,
+                      enum cdd_cst_dataflow_meet_t meet);
+
+/**
+ * @brief Releases the sets of a problem.
+ * @param df The problem.
+ */
+C_CDD_EXPORT void cdd_cst_dataflow_free(cdd_cst_dataflow_t *df);
+
+/** @brief Gen set of a block. */
+C_CDD_EXPORT cdd_cst_bitset_word_t *
+cdd_cst_dataflow_gen(const cdd_cst_dataflow_t *df, size_t block);
+/** @brief Kill set of a block. */
+C_CDD_EXPORT cdd_cst_bitset_word_t *
+cdd_cst_dataflow_kill(const cdd_cst_dataflow_t *df, size_t block);
+/** @brief Facts holding on entry to a block. */
+C_CDD_EXPORT cdd_cst_bitset_word_t *
+cdd_cst_dataflow_in(const cdd_cst_dataflow_t *df, size_t block);
+/** @brief Facts holding on exit from a block. */
+C_CDD_EXPORT cdd_cst_bitset_word_t *
+cdd_cst_dataflow_out(const cdd_cst_dataflow_t *df, size_t block);
+/** @brief Facts holding at the function entry (exit when backward). */
+C_CDD_EXPORT cdd_cst_bitset_word_t *
+cdd_cst_dataflow_boundary(const cdd_cst_dataflow_t *df);
+
+/**
+ * @brief Records that a statement of `block` generates `fact`. Statements
+ * are applied in the order facts flow: program order when forward, reverse
+ * order when backward.
+ * @param df The problem.
+ * @param block The block id.
+ * @param fact The fact.
+ */
+C_CDD_EXPORT void cdd_cst_dataflow_apply_gen(cdd_cst_dataflow_t *df,
+                                             size_t block, size_t fact);
+
+/**
+ * @brief Records that a statement of `block` kills `fact`, in the same
+ * order as cdd_cst_dataflow_apply_gen.
+ * @param df The problem.
+ * @param block The block id.
+ * @param fact The fact.
+ */
+C_CDD_EXPORT void cdd_cst_dataflow_apply_kill(cdd_cst_dataflow_t *df,
+                                              size_t block, size_t fact);
+
+/**
+ * @brief Computes the in and out sets of every block to the fixed point.
+ * @param df The problem, gen/kill sets filled in.
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_cst_dataflow_solve(cdd_cst_dataflow_t *df);
+
+/**
+ * @brief One assignment or declaration of a variable.
+ */
+typedef struct cdd_cst_def_t {
+  cdd_cst_node_t *stmt;   /**< Statement containing it */
+  size_t child;           /**< Index of the name among `stmt`'s children */
+  size_t block;           /**< Id of the statement's block */
+  size_t var;             /**< Index into `cdd_cst_defuse_t.vars` */
+  size_t next_of_var;     /**< Next def of the same variable, or n_defs */
+  int is_declaration;     /**< 1 for `T x` / `T x = e`, 0 for `x = e` etc. */
+  const cdd_token_t *tok; /**< The defined name */
+} cdd_cst_def_t;
+
+/**
+ * @brief Variables and definitions of one function's CFG.
+ *
+ * A definition is a name declared in a statement (`T x;`, `T *x = e;`,
+ * `T x[N];`) or directly assigned (`x = e`, `x += e`, `x++`, `--x`).
+ * Assignments through pointers, members or `&x` arguments are not
+ * definitions of `x`. Other identifiers outside callee and member
+ * position are uses.
+ */
+typedef struct cdd_cst_defuse_t {
+  const cdd_token_t **vars; /**< First occurrence of each distinct name */
+  size_t n_vars;            /**< Number of variables */
+  size_t *first_def;        /**< Per variable: first def, or n_defs */
+  cdd_cst_def_t *defs;      /**< Definitions, in block then program order */
+  size_t n_defs;            /**< Number of definitions */
+  size_t *block_defs; /**< Per block b: defs of b are [block_defs[b],
+                         block_defs[b + 1]) */
+  size_t *var_slots;  /**< Open-addressed name table into `vars` */
+  size_t n_slots;     /**< Table size, a power of two */
+} cdd_cst_defuse_t;
+
+/**
+ * @brief Collects the variables and definitions of a CFG in one pass over
+ * its statements.
+ * @param cfg The graph.
+ * @param out The table to fill.
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_cst_defuse_build(const cdd_cst_cfg_t *cfg,
+                                                cdd_cst_defuse_t *out);
+
+/**
+ * @brief Releases a def/use table.
+ * @param du The table.
+ */
+C_CDD_EXPORT void cdd_cst_defuse_free(cdd_cst_defuse_t *du);
+
+/**
+ * @brief Finds the variable with a given spelling.
+ * @param du The table.
+ * @param name The name (need not be NUL-terminated).
+ * @param len Its length.
+ * @param out_var Receives the variable index.
+ * @return 0 on success, or CDD_C_ERROR_NOT_FOUND.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_cst_defuse_find_var(const cdd_cst_defuse_t *du,
+                                                   const char *name,
+                                                   size_t len,
+                                                   size_t *out_var);
+
+/** @brief cdd_cst_defuse_classify flag: the variable is read. */
+#define CDD_CST_DEFUSE_USE 1u
+/** @brief cdd_cst_defuse_classify flag: the variable is written. */
+#define CDD_CST_DEFUSE_DEF 2u
+
+/**
+ * @brief Classifies child `i` of a statement as a definition and/or use of
+ * a variable (`x += 1` is both).
+ * @param stmt The statement.
+ * @param i The child index.
+ * @param out_flags Receives CDD_CST_DEFUSE_USE and/or CDD_CST_DEFUSE_DEF.
+ * @return 0 on success, CDD_C_ERROR_NOT_FOUND if child `i` is no variable
+ * (not an identifier, or a keyword, type, callee, member or label).
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_cst_defuse_classify(const cdd_cst_node_t *stmt,
+                                                   size_t i,
+                                                   unsigned *out_flags);
+
+/**
+ * @brief Reaching definitions: facts are indices into `du->defs`; forward,
+ * union. A definition kills every other definition of its variable.
+ * @param cfg The graph.
+ * @param du Its def/use table.
+ * @param out Receives the solved problem.
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_cst_dataflow_reaching_defs(const cdd_cst_cfg_t *cfg,
+                               const cdd_cst_defuse_t *du,
+                               cdd_cst_dataflow_t *out);
+
+/**
+ * @brief Live variables: facts are indices into `du->vars`; backward,
+ * union. Within a statement, uses are read before its definitions.
+ * @param cfg The graph.
+ * @param du Its def/use table.
+ * @param out Receives the solved problem.
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_cst_dataflow_liveness(const cdd_cst_cfg_t *cfg,
+                                                     const cdd_cst_defuse_t *du,
+                                                     cdd_cst_dataflow_t *out);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CDD_CST_DATAFLOW_H */
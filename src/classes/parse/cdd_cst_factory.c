@@ -6,6 +6,7 @@
 /* clang-format off */
 #include "cdd_cst_factory.h"
 #include "cdd_cst_mutate.h"
+#include "cdd_cst_query.h"
 #include <errno.h>
 #include <stdarg.h>
 #include <stdlib.h>
@@ -136,6 +137,7 @@ cdd_c_error_t cdd_cst_append_child_node(cdd_cst_node_t *parent,
   parent->children[parent->num_children].val.node = child;
   child->parent = parent;
   parent->num_children++;
+  cdd_cst_node_invalidate(parent);
   return CDD_C_SUCCESS;
 }
 
@@ -169,6 +171,7 @@ cdd_c_error_t cdd_cst_append_child_token(cdd_cst_node_t *parent,
   parent->children[parent->num_children].kind = CDD_CST_CHILD_TOKEN;
   parent->children[parent->num_children].val.token = token;
   parent->num_children++;
+  cdd_cst_node_invalidate(parent);
   return CDD_C_SUCCESS;
 }
 
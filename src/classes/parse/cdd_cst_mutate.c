@@ -1,6 +1,7 @@
 /* clang-format off */
 #include "cdd_cst_mutate.h"
 #include "cdd_cst_factory.h"
+#include "cdd_cst_query.h"
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
@@ -169,6 +170,7 @@ cdd_c_error_t cdd_cst_replace_node(cdd_cst_tree_t *tree,
   new_node->parent = parent;
 
   old_node->parent = NULL;
+  cdd_cst_tree_invalidate(tree);
 
   /* Note: old_node is NOT freed here. Caller's responsibility if they want to
    * discard it. */
@@ -213,6 +215,7 @@ cdd_c_error_t cdd_cst_insert_child_node_at(cdd_cst_node_t *parent, size_t idx,
   parent->children[idx].val.node = new_node;
   new_node->parent = parent;
   parent->num_children++;
+  cdd_cst_node_invalidate(parent);
 
   return CDD_C_SUCCESS;
 }
@@ -282,6 +285,7 @@ cdd_c_error_t cdd_cst_detach_node(cdd_cst_tree_t *tree, cdd_cst_node_t *node) {
   parent->num_children--;
 
   node->parent = NULL; /* explicitly detach */
+  cdd_cst_tree_invalidate(tree);
 
   return CDD_C_SUCCESS;
 }
@@ -401,6 +405,7 @@ cdd_c_error_t cdd_cst_remove_child(cdd_cst_node_t *node, size_t idx) {
     node->children[i] = node->children[i + 1];
   }
   node->num_children--;
+  cdd_cst_node_invalidate(node);
   return CDD_C_SUCCESS;
 }
 
@@ -411,5 +416,6 @@ cdd_c_error_t cdd_cst_replace_token_child(cdd_cst_node_t *node, size_t idx,
   if (node->children[idx].kind != CDD_CST_CHILD_TOKEN)
     return CDD_C_ERROR_INVALID_ARGUMENT;
   node->children[idx].val.token = new_tok;
+  cdd_cst_node_invalidate(node);
   return CDD_C_SUCCESS;
 }
@@ -6,6 +6,7 @@
 /* clang-format off */
 #include "cdd_cst_mutate.h"
 #include "cdd_cst_factory.h"
+#include "cdd_cst_query.h"
 #include <string.h>
 #include <stdio.h>
 #include <errno.h>
@@ -108,6 +109,8 @@ cdd_c_error_t cdd_cst_splice_children(cdd_cst_tree_t *tree,
 
   if (node == tree->root) {
     tree->root = new_node;
+    new_node->tree = tree;
+    cdd_cst_tree_invalidate(tree);
     rc = CDD_C_SUCCESS;
   } else {
     rc = cdd_cst_replace_node(tree, node, new_node);
@@ -6,6 +6,7 @@ extern "C" {
 #endif /* __cplusplus */
 
 /* clang-format off */
+#include "cdd_cst_arena.h"
 #include "cdd_token.h"
 #include <stddef.h>
 /* clang-format on */
@@ -49,6 +50,8 @@ enum cdd_cst_node_kind_t {
 };
 
 typedef struct cdd_cst_node_t cdd_cst_node_t;
+struct cdd_cst_tree_t;
+struct cdd_cst_index_t;
 
 /**
  * @brief Represents a child of a CST node (either a Token or another Node).
@@ -91,6 +94,7 @@ struct cdd_cst_node_t {
   /** @brief field */
   /** @brief field */
   cdd_cst_node_t *parent;
+  struct cdd_cst_tree_t *tree; /**< Owning tree; set on the root node only */
 };
 
 /**
@@ -116,6 +120,9 @@ struct cdd_cst_tree_t {
   size_t num_strings;
   /** @brief string_capacity field */
   size_t string_capacity;
+  cdd_cst_arena_t strings;       /**< Text of synthesized tokens */
+  size_t revision;               /**< Bumped by every structural mutation */
+  struct cdd_cst_index_t *index; /**< Lazy kind/callee index, or NULL */
 };
 
 #ifdef __cplusplus
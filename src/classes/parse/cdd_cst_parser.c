@@ -1,5 +1,6 @@
 /* clang-format off */
 #include "cdd_cst_parser.h"
+#include "cdd_cst_query.h"
 #include "cdd_lexer.h"
 #include <errno.h>
 #include <stdlib.h>
@@ -798,16 +799,25 @@ static cdd_c_error_t parse_declaration_or_statement(parser_state_t *s,
     enum cdd_cst_node_kind_t node_kind = CDD_CST_UNKNOWN;
     cdd_token_t *class_name_tok = NULL;
 
-    for (i = s->pos; i < s->list->size; i++) {
-      if (s->list->tokens[i].kind == CDD_TOKEN_SEMICOLON) {
-        break;
-      }
-      if (s->list->tokens[i].kind == CDD_TOKEN_LBRACE) {
-        is_func = 1;
-        break;
+    {
+      int paren_depth = 0;
+      for (i = s->pos; i < s->list->size; i++) {
+        /* `for (a; b; c) {` */
+        if (s->list->tokens[i].kind == CDD_TOKEN_LPAREN)
+          paren_depth++;
+        else if (s->list->tokens[i].kind == CDD_TOKEN_RPAREN)
+          paren_depth--;
+        if (s->list->tokens[i].kind == CDD_TOKEN_SEMICOLON &&
+            paren_depth <= 0) {
+          break;
+        }
+        if (s->list->tokens[i].kind == CDD_TOKEN_LBRACE) {
+          is_func = 1;
+          break;
+        }
+        if (s->list->tokens[i].kind == CDD_TOKEN_RBRACE)
+          break; /* syntax error fallback */
       }
-      if (s->list->tokens[i].kind == CDD_TOKEN_RBRACE)
-        break; /* syntax error fallback */
     }
 
     for (i = s->pos; i < s->list->size; i++) {
@@ -958,9 +968,10 @@ static cdd_c_error_t parse_declaration_or_statement(parser_state_t *s,
           }
           if (nxt->kind == CDD_TOKEN_RBRACE && paren_depth <= 0) {
             if (n->num_children == 0) {
+              /* Stray `}` */
               free_node(n);
               *out_node = NULL;
-              return CDD_C_ERROR_MEMORY;
+              return CDD_C_ERROR_PARSE;
             }
             break;
           }
@@ -1009,6 +1020,7 @@ cdd_c_error_t cdd_cst_parse(az_span source, cdd_cst_tree_t **out_tree) {
     cdd_cst_tree_free(tree);
     return rc;
   }
+  tree->root->tree = tree;
 
   while (state.pos < state.list->size) {
     cdd_token_t *t = NULL;
@@ -1053,6 +1065,7 @@ void cdd_cst_tree_free(cdd_cst_tree_t *tree) {
   size_t i;
   if (!tree)
     return;
+  cdd_cst_index_free(tree->index);
   if (tree->root)
     free_node(tree->root);
   if (tree->base_tokens)
@@ -1084,5 +1097,6 @@ void cdd_cst_tree_free(cdd_cst_tree_t *tree) {
     }
     C_CDD_FREE(tree->string_pool);
   }
+  cdd_cst_arena_free(&tree->strings);
   C_CDD_FREE(tree);
 }
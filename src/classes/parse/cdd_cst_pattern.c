@@ -0,0 +1,691 @@
+/**
+ * @file cdd_cst_pattern.c
+ * @brief Compiler and batched matcher for CST pattern queries.
+ */
+
+/* clang-format off */
+#include "cdd_cst_pattern.h"
+#include "cdd_cst_query.h"
+#include <stdlib.h>
+#include <string.h>
+#include "c_cdd/log.h"
+#include "c_cdd/memory.h"
+/* clang-format on */
+
+/** @brief Dispatch buckets: one per node kind, then one for `(_)` */
+#define PATTERN_KINDS ((size_t)CDD_CST_UNKNOWN + 1)
+#define PATTERN_WILDCARD PATTERN_KINDS
+
+/** @brief What a step matches */
+enum pattern_step_type {
+  PATTERN_STEP_NODE,       /**< A node, with child steps */
+  PATTERN_STEP_TEXT,       /**< A token with exact text */
+  PATTERN_STEP_TOKEN_KIND, /**< A token of a kind */
+  PATTERN_STEP_ANY         /**< Any child */
+};
+
+/** @brief One compiled element; a pattern is a pre-order run of steps. */
+typedef struct pattern_step_t {
+  enum pattern_step_type type; /**< What to match */
+  int kind;            /**< Node kind (-1 for any) or token kind */
+  int anchored;        /**< Must directly follow the previous sibling match */
+  int anchor_end;      /**< Last child step must match the last child */
+  char *text;          /**< Token text for PATTERN_STEP_TEXT */
+  size_t text_len;     /**< Length of `text` */
+  size_t num_children; /**< Direct child steps */
+  size_t span;         /**< Steps in this subtree, including this one */
+  size_t capture;      /**< Capture id plus one, or 0 */
+} pattern_step_t;
+
+/** @brief Growable list of pattern ids */
+typedef struct pattern_bucket_t {
+  size_t *ids;     /**< Pattern ids in order of addition */
+  size_t size;     /**< Used entries */
+  size_t capacity; /**< Allocated entries */
+} pattern_bucket_t;
+
+struct cdd_cst_pattern_set_t {
+  pattern_step_t *steps; /**< Steps of all patterns */
+  size_t num_steps;      /**< Used steps */
+  size_t steps_capacity; /**< Allocated steps */
+  size_t *first_step;    /**< First step of each pattern */
+  size_t num_patterns;   /**< Patterns added */
+  size_t patterns_capacity;
+  char **capture_names; /**< Capture names, indexed by id */
+  size_t num_captures;  /**< Distinct capture names */
+  size_t captures_capacity;
+  pattern_bucket_t buckets[PATTERN_KINDS + 1]; /**< Patterns by root kind */
+};
+
+static const char *const pattern_kind_names[PATTERN_KINDS] = {
+    "translation_unit",
+    "declaration",
+    "function_definition",
+    "statement",
+    "expression",
+    "preproc_conditional",
+    "preproc_directive",
+    "type_specifier",
+    "identifier",
+    "literal",
+    "binary_expr",
+    "unary_expr",
+    "call_expr",
+    "block",
+    "asm_statement",
+    "class_declaration",
+    "access_specifier",
+    "constructor",
+    "destructor",
+    "operator_overload",
+    "namespace_declaration",
+    "using_directive",
+    "template_declaration",
+    "template_parameter_list",
+    "template_parameter",
+    "base_class_list",
+    "base_class_specifier",
+    "try_block",
+    "catch_block",
+    "throw_expression",
+    "noexcept_specifier",
+    "unknown"};
+
+/* --- Compiler --- */
+
+/** @brief Compiler state for one pattern */
+typedef struct pattern_parser_t {
+  cdd_cst_pattern_set_t *set; /**< Destination set */
+  const char *src;            /**< Pattern text */
+  size_t pos;                 /**< Read position */
+} pattern_parser_t;
+
+static int pattern_is_word(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_' || c == '-';
+}
+
+static void pattern_skip_space(pattern_parser_t *p) {
+  for (;;) {
+    char c = p->src[p->pos];
+    if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+      p->pos++;
+    } else if (c == ';') {
+      while (p->src[p->pos] && p->src[p->pos] != '\n')
+        p->pos++;
+    } else {
+      return;
+    }
+  }
+}
+
+/** @brief Reads a bare word; capture names may also contain dots. */
+static size_t pattern_read_word(pattern_parser_t *p, int allow_dot) {
+  size_t start = p->pos;
+  while (pattern_is_word(p->src[p->pos]) ||
+         (allow_dot && p->src[p->pos] == '.' && p->pos > start))
+    p->pos++;
+  return p->pos - start;
+}
+
+static cdd_c_error_t pattern_push_step(cdd_cst_pattern_set_t *set,
+                                       enum pattern_step_type type,
+                                       size_t *out_index) {
+  pattern_step_t *step;
+  if (set->num_steps >= set->steps_capacity) {
+    size_t new_cap = set->steps_capacity == 0 ? 16 : set->steps_capacity * 2;
+    pattern_step_t *grown = (pattern_step_t *)C_CDD_REALLOC(
+        set->steps, new_cap * sizeof(pattern_step_t));
+    if (!grown) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      return CDD_C_ERROR_MEMORY;
+    }
+    set->steps = grown;
+    set->steps_capacity = new_cap;
+  }
+  step = &set->steps[set->num_steps];
+  memset(step, 0, sizeof(*step));
+  step->type = type;
+  step->span = 1;
+  *out_index = set->num_steps++;
+  return CDD_C_SUCCESS;
+}
+
+static cdd_c_error_t pattern_intern_capture(cdd_cst_pattern_set_t *set,
+                                            const char *name, size_t len,
+                                            size_t *out_id) {
+  size_t i;
+  char *copy;
+  for (i = 0; i < set->num_captures; i++) {
+    if (strlen(set->capture_names[i]) == len &&
+        memcmp(set->capture_names[i], name, len) == 0) {
+      *out_id = i;
+      return CDD_C_SUCCESS;
+    }
+  }
+  if (set->num_captures >= set->captures_capacity) {
+    size_t new_cap =
+        set->captures_capacity == 0 ? 4 : set->captures_capacity * 2;
+    char **grown = (char **)C_CDD_REALLOC(set->capture_names,
+                                          new_cap * sizeof(char *));
+    if (!grown) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      return CDD_C_ERROR_MEMORY;
+    }
+    set->capture_names = grown;
+    set->captures_capacity = new_cap;
+  }
+  copy = (char *)C_CDD_MALLOC(len + 1);
+  if (!copy) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+  memcpy(copy, name, len);
+  copy[len] = '\0';
+  set->capture_names[set->num_captures] = copy;
+  *out_id = set->num_captures++;
+  return CDD_C_SUCCESS;
+}
+
+static cdd_c_error_t pattern_parse_string(pattern_parser_t *p,
+                                          size_t step_index) {
+  size_t start = ++p->pos;
+  size_t len = 0;
+  size_t i;
+  char *text;
+  while (p->src[p->pos] != '"') {
+    if (!p->src[p->pos])
+      return CDD_C_ERROR_PARSE;
+    if (p->src[p->pos] == '\\' && p->src[p->pos + 1])
+      p->pos++;
+    p->pos++;
+    len++;
+  }
+  text = (char *)C_CDD_MALLOC(len + 1);
+  if (!text) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+  for (i = 0; start < p->pos; i++) {
+    if (p->src[start] == '\\')
+      start++;
+    text[i] = p->src[start++];
+  }
+  text[len] = '\0';
+  p->pos++; /* closing quote */
+  p->set->steps[step_index].text = text;
+  p->set->steps[step_index].text_len = len;
+  return CDD_C_SUCCESS;
+}
+
+static cdd_c_error_t pattern_parse_element(pattern_parser_t *p, int anchored,
+                                           size_t *out_index);
+
+static cdd_c_error_t pattern_parse_node(pattern_parser_t *p,
+                                        size_t step_index) {
+  const char *word;
+  size_t len, k;
+  int anchor_next = 0;
+  cdd_c_error_t rc;
+
+  p->pos++; /* '(' */
+  pattern_skip_space(p);
+  word = p->src + p->pos;
+  len = pattern_read_word(p, 0);
+  if (len == 1 && word[0] == '_') {
+    p->set->steps[step_index].kind = -1;
+  } else {
+    for (k = 0; k < PATTERN_KINDS; k++) {
+      if (strlen(pattern_kind_names[k]) == len &&
+          memcmp(pattern_kind_names[k], word, len) == 0)
+        break;
+    }
+    if (k == PATTERN_KINDS) {
+      p->pos -= len;
+      return CDD_C_ERROR_PARSE;
+    }
+    p->set->steps[step_index].kind = (int)k;
+  }
+
+  for (;;) {
+    size_t child;
+    pattern_skip_space(p);
+    if (p->src[p->pos] == ')') {
+      p->pos++;
+      break;
+    }
+    if (p->src[p->pos] == '.') {
+      p->pos++;
+      pattern_skip_space(p);
+      if (p->src[p->pos] == ')')
+        p->set->steps[step_index].anchor_end = 1;
+      else
+        anchor_next = 1;
+      continue;
+    }
+    rc = pattern_parse_element(p, anchor_next, &child);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    p->set->steps[step_index].num_children++;
+    anchor_next = 0;
+  }
+  p->set->steps[step_index].span = p->set->num_steps - step_index;
+  return CDD_C_SUCCESS;
+}
+
+static cdd_c_error_t pattern_parse_element(pattern_parser_t *p, int anchored,
+                                           size_t *out_index) {
+  static const struct {
+    const char *name;
+    enum cdd_token_kind_t kind;
+  } token_kinds[] = {{"IDENTIFIER", CDD_TOKEN_IDENTIFIER},
+                     {"NUMBER", CDD_TOKEN_NUMBER},
+                     {"STRING", CDD_TOKEN_STRING},
+                     {"CHAR", CDD_TOKEN_CHAR}};
+  char c;
+  size_t index;
+  cdd_c_error_t rc;
+
+  pattern_skip_space(p);
+  c = p->src[p->pos];
+  if (c == '(') {
+    rc = pattern_push_step(p->set, PATTERN_STEP_NODE, &index);
+    if (rc == CDD_C_SUCCESS)
+      rc = pattern_parse_node(p, index);
+  } else if (c == '"') {
+    rc = pattern_push_step(p->set, PATTERN_STEP_TEXT, &index);
+    if (rc == CDD_C_SUCCESS)
+      rc = pattern_parse_string(p, index);
+  } else {
+    const char *word = p->src + p->pos;
+    size_t len = pattern_read_word(p, 0);
+    size_t k;
+    if (len == 1 && word[0] == '_') {
+      rc = pattern_push_step(p->set, PATTERN_STEP_ANY, &index);
+    } else {
+      for (k = 0; k < sizeof(token_kinds) / sizeof(token_kinds[0]); k++) {
+        if (strlen(token_kinds[k].name) == len &&
+            memcmp(token_kinds[k].name, word, len) == 0)
+          break;
+      }
+      if (k == sizeof(token_kinds) / sizeof(token_kinds[0])) {
+        p->pos -= len;
+        return CDD_C_ERROR_PARSE;
+      }
+      rc = pattern_push_step(p->set, PATTERN_STEP_TOKEN_KIND, &index);
+      if (rc == CDD_C_SUCCESS)
+        p->set->steps[index].kind = (int)token_kinds[k].kind;
+    }
+  }
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  p->set->steps[index].anchored = anchored;
+
+  pattern_skip_space(p);
+  if (p->src[p->pos] == '@') {
+    const char *name;
+    size_t len, id;
+    p->pos++;
+    name = p->src + p->pos;
+    len = pattern_read_word(p, 1);
+    if (len == 0)
+      return CDD_C_ERROR_PARSE;
+    rc = pattern_intern_capture(p->set, name, len, &id);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    p->set->steps[index].capture = id + 1;
+  }
+  *out_index = index;
+  return CDD_C_SUCCESS;
+}
+
+static cdd_c_error_t pattern_bucket_add(pattern_bucket_t *bucket, size_t id) {
+  if (bucket->size >= bucket->capacity) {
+    size_t new_cap = bucket->capacity == 0 ? 4 : bucket->capacity * 2;
+    size_t *grown =
+        (size_t *)C_CDD_REALLOC(bucket->ids, new_cap * sizeof(size_t));
+    if (!grown) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      return CDD_C_ERROR_MEMORY;
+    }
+    bucket->ids = grown;
+    bucket->capacity = new_cap;
+  }
+  bucket->ids[bucket->size++] = id;
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t cdd_cst_pattern_set_new(cdd_cst_pattern_set_t **out_set) {
+  if (!out_set)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out_set = (cdd_cst_pattern_set_t *)C_CDD_CALLOC(
+      1, sizeof(cdd_cst_pattern_set_t));
+  if (!*out_set) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+  return CDD_C_SUCCESS;
+}
+
+/** @brief Drops steps and capture names added after a failed compile. */
+static void pattern_set_truncate(cdd_cst_pattern_set_t *set, size_t num_steps,
+                                 size_t num_captures) {
+  while (set->num_steps > num_steps) {
+    pattern_step_t *step = &set->steps[--set->num_steps];
+    if (step->text)
+      C_CDD_FREE(step->text);
+  }
+  while (set->num_captures > num_captures)
+    C_CDD_FREE(set->capture_names[--set->num_captures]);
+}
+
+void cdd_cst_pattern_set_free(cdd_cst_pattern_set_t *set) {
+  size_t k;
+  if (!set)
+    return;
+  pattern_set_truncate(set, 0, 0);
+  if (set->steps)
+    C_CDD_FREE(set->steps);
+  if (set->first_step)
+    C_CDD_FREE(set->first_step);
+  if (set->capture_names)
+    C_CDD_FREE(set->capture_names);
+  for (k = 0; k <= PATTERN_KINDS; k++) {
+    if (set->buckets[k].ids)
+      C_CDD_FREE(set->buckets[k].ids);
+  }
+  C_CDD_FREE(set);
+}
+
+cdd_c_error_t cdd_cst_pattern_set_add(cdd_cst_pattern_set_t *set,
+                                      const char *source, size_t *out_id,
+                                      size_t *out_error_pos) {
+  pattern_parser_t p;
+  size_t num_steps, num_captures, root = 0;
+  size_t bucket;
+  cdd_c_error_t rc;
+
+  if (!set || !source)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  p.set = set;
+  p.src = source;
+  p.pos = 0;
+  num_steps = set->num_steps;
+  num_captures = set->num_captures;
+
+  pattern_skip_space(&p);
+  if (source[p.pos] != '(') {
+    rc = CDD_C_ERROR_PARSE;
+  } else {
+    rc = pattern_parse_element(&p, 0, &root);
+    pattern_skip_space(&p);
+    if (rc == CDD_C_SUCCESS && source[p.pos] != '\0')
+      rc = CDD_C_ERROR_PARSE;
+  }
+
+  if (rc == CDD_C_SUCCESS && set->num_patterns >= set->patterns_capacity) {
+    size_t new_cap =
+        set->patterns_capacity == 0 ? 8 : set->patterns_capacity * 2;
+    size_t *grown =
+        (size_t *)C_CDD_REALLOC(set->first_step, new_cap * sizeof(size_t));
+    if (!grown) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      rc = CDD_C_ERROR_MEMORY;
+    } else {
+      set->first_step = grown;
+      set->patterns_capacity = new_cap;
+    }
+  }
+  if (rc == CDD_C_SUCCESS) {
+    bucket = set->steps[root].kind < 0 ? PATTERN_WILDCARD
+                                       : (size_t)set->steps[root].kind;
+    rc = pattern_bucket_add(&set->buckets[bucket], set->num_patterns);
+  }
+  if (rc != CDD_C_SUCCESS) {
+    if (rc == CDD_C_ERROR_PARSE && out_error_pos)
+      *out_error_pos = p.pos;
+    pattern_set_truncate(set, num_steps, num_captures);
+    return rc;
+  }
+
+  set->first_step[set->num_patterns] = root;
+  if (out_id)
+    *out_id = set->num_patterns;
+  set->num_patterns++;
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t cdd_cst_pattern_capture_id(const cdd_cst_pattern_set_t *set,
+                                         const char *name, size_t *out_id) {
+  size_t i;
+  if (!set || !name || !out_id)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  for (i = 0; i < set->num_captures; i++) {
+    if (strcmp(set->capture_names[i], name) == 0) {
+      *out_id = i;
+      return CDD_C_SUCCESS;
+    }
+  }
+  return CDD_C_ERROR_NOT_FOUND;
+}
+
+cdd_cst_node_t *
+cdd_cst_pattern_capture_node(const cdd_cst_pattern_match_t *match,
+                             size_t capture_id) {
+  if (!match || capture_id >= match->num_captures ||
+      match->captures[capture_id].kind != CDD_CST_CHILD_NODE)
+    return NULL;
+  return match->captures[capture_id].val.node;
+}
+
+cdd_token_t *
+cdd_cst_pattern_capture_token(const cdd_cst_pattern_match_t *match,
+                              size_t capture_id) {
+  if (!match || capture_id >= match->num_captures ||
+      match->captures[capture_id].kind != CDD_CST_CHILD_TOKEN)
+    return NULL;
+  return match->captures[capture_id].val.token;
+}
+
+/* --- Matcher --- */
+
+static int pattern_match_step(const cdd_cst_pattern_set_t *set, size_t s,
+                              const cdd_cst_child_t *child,
+                              cdd_cst_child_t *captures);
+
+/**
+ * @brief Matches `left` sibling steps from `s` against the children of
+ * `node` starting at `from`, backtracking over the unanchored positions.
+ */
+static int pattern_match_seq(const cdd_cst_pattern_set_t *set, size_t parent,
+                             size_t s, size_t left, const cdd_cst_node_t *node,
+                             size_t from, cdd_cst_child_t *captures) {
+  const pattern_step_t *step;
+  size_t i, last;
+  if (left == 0)
+    return !set->steps[parent].anchor_end || from == node->num_children;
+  step = &set->steps[s];
+  last = step->anchored ? from + 1 : node->num_children;
+  if (last > node->num_children)
+    last = node->num_children;
+  for (i = from; i < last; i++) {
+    if (pattern_match_step(set, s, &node->children[i], captures) &&
+        pattern_match_seq(set, parent, s + step->span, left - 1, node, i + 1,
+                          captures))
+      return 1;
+  }
+  return 0;
+}
+
+static int pattern_match_step(const cdd_cst_pattern_set_t *set, size_t s,
+                              const cdd_cst_child_t *child,
+                              cdd_cst_child_t *captures) {
+  const pattern_step_t *step = &set->steps[s];
+  int ok;
+  switch (step->type) {
+  case PATTERN_STEP_NODE:
+    ok = child->kind == CDD_CST_CHILD_NODE && child->val.node &&
+         (step->kind < 0 || (int)child->val.node->kind == step->kind) &&
+         pattern_match_seq(set, s, s + 1, step->num_children, child->val.node,
+                           0, captures);
+    break;
+  case PATTERN_STEP_TEXT:
+    ok = child->kind == CDD_CST_CHILD_TOKEN && child->val.token &&
+         child->val.token->length == step->text_len &&
+         memcmp(child->val.token->start, step->text, step->text_len) == 0;
+    break;
+  case PATTERN_STEP_TOKEN_KIND:
+    ok = child->kind == CDD_CST_CHILD_TOKEN && child->val.token &&
+         (int)child->val.token->kind == step->kind;
+    break;
+  default:
+    ok = 1;
+    break;
+  }
+  if (ok && step->capture)
+    captures[step->capture - 1] = *child;
+  return ok;
+}
+
+/** @brief Traversal state shared by cdd_cst_pattern_run's visitor */
+typedef struct pattern_run_ctx_t {
+  const cdd_cst_pattern_set_t *set; /**< Patterns */
+  cdd_cst_pattern_match_fn on_match;
+  void *user_data;
+  cdd_cst_child_t *captures; /**< Scratch captures for the current match */
+} pattern_run_ctx_t;
+
+static cdd_c_error_t pattern_try(pattern_run_ctx_t *ctx, size_t id,
+                                 cdd_cst_node_t *node) {
+  const cdd_cst_pattern_set_t *set = ctx->set;
+  cdd_cst_pattern_match_t match;
+  cdd_cst_child_t self;
+
+  if (set->num_captures)
+    memset(ctx->captures, 0, set->num_captures * sizeof(cdd_cst_child_t));
+  self.kind = CDD_CST_CHILD_NODE;
+  self.val.node = node;
+  if (!pattern_match_step(set, set->first_step[id], &self, ctx->captures))
+    return CDD_C_SUCCESS;
+
+  match.pattern = id;
+  match.node = node;
+  match.captures = ctx->captures;
+  match.num_captures = set->num_captures;
+  return ctx->on_match(&match, ctx->user_data);
+}
+
+static cdd_c_error_t pattern_visitor(cdd_cst_node_t *node, void *user_data) {
+  pattern_run_ctx_t *ctx = (pattern_run_ctx_t *)user_data;
+  const pattern_bucket_t *wild = &ctx->set->buckets[PATTERN_WILDCARD];
+  const pattern_bucket_t *kind = NULL;
+  size_t a = 0, b = 0;
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+
+  if ((size_t)node->kind < PATTERN_KINDS)
+    kind = &ctx->set->buckets[node->kind];
+  /* Merge the two id-ordered buckets so patterns run in order of addition */
+  while (rc == CDD_C_SUCCESS &&
+         ((kind && a < kind->size) || b < wild->size)) {
+    if (kind && a < kind->size &&
+        (b >= wild->size || kind->ids[a] < wild->ids[b]))
+      rc = pattern_try(ctx, kind->ids[a++], node);
+    else
+      rc = pattern_try(ctx, wild->ids[b++], node);
+  }
+  return rc;
+}
+
+cdd_c_error_t cdd_cst_pattern_run(const cdd_cst_pattern_set_t *set,
+                                  cdd_cst_node_t *root,
+                                  cdd_cst_pattern_match_fn on_match,
+                                  void *user_data) {
+  pattern_run_ctx_t ctx;
+  cdd_c_error_t rc;
+  if (!set || !root || !on_match)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (set->num_patterns == 0)
+    return CDD_C_SUCCESS;
+
+  ctx.set = set;
+  ctx.on_match = on_match;
+  ctx.user_data = user_data;
+  ctx.captures = NULL;
+  if (set->num_captures) {
+    ctx.captures = (cdd_cst_child_t *)C_CDD_MALLOC(set->num_captures *
+                                                   sizeof(cdd_cst_child_t));
+    if (!ctx.captures) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      return CDD_C_ERROR_MEMORY;
+    }
+  }
+  rc = cdd_cst_traverse_preorder(root, pattern_visitor, &ctx);
+  if (ctx.captures)
+    C_CDD_FREE(ctx.captures);
+  return rc;
+}
+
+static cdd_c_error_t pattern_collect_cb(const cdd_cst_pattern_match_t *match,
+                                        void *user_data) {
+  cdd_cst_pattern_results_t *res = (cdd_cst_pattern_results_t *)user_data;
+  size_t n = match->num_captures;
+  if (res->size >= res->capacity) {
+    size_t new_cap = res->capacity == 0 ? 16 : res->capacity * 2;
+    cdd_cst_pattern_match_t *grown = (cdd_cst_pattern_match_t *)C_CDD_REALLOC(
+        res->matches, new_cap * sizeof(cdd_cst_pattern_match_t));
+    if (!grown) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      return CDD_C_ERROR_MEMORY;
+    }
+    res->matches = grown;
+    if (n) {
+      cdd_cst_child_t *caps = (cdd_cst_child_t *)C_CDD_REALLOC(
+          res->captures, new_cap * n * sizeof(cdd_cst_child_t));
+      if (!caps) {
+        C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+        return CDD_C_ERROR_MEMORY;
+      }
+      res->captures = caps;
+    }
+    res->capacity = new_cap;
+  }
+  res->matches[res->size] = *match;
+  if (n)
+    memcpy(res->captures + res->size * n, match->captures,
+           n * sizeof(cdd_cst_child_t));
+  res->size++;
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t cdd_cst_pattern_collect(const cdd_cst_pattern_set_t *set,
+                                      cdd_cst_node_t *root,
+                                      cdd_cst_pattern_results_t *out_results) {
+  cdd_c_error_t rc;
+  size_t i;
+  if (!out_results)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  memset(out_results, 0, sizeof(*out_results));
+
+  rc = cdd_cst_pattern_run(set, root, pattern_collect_cb, out_results);
+  if (rc != CDD_C_SUCCESS) {
+    cdd_cst_pattern_results_free(out_results);
+    return rc;
+  }
+  /* The capture store moved while growing; point matches into it now */
+  for (i = 0; i < out_results->size; i++) {
+    cdd_cst_pattern_match_t *m = &out_results->matches[i];
+    m->captures = m->num_captures ? out_results->captures + i * m->num_captures
+                                  : NULL;
+  }
+  return CDD_C_SUCCESS;
+}
+
+void cdd_cst_pattern_results_free(cdd_cst_pattern_results_t *results) {
+  if (!results)
+    return;
+  if (results->matches)
+    C_CDD_FREE(results->matches);
+  if (results->captures)
+    C_CDD_FREE(results->captures);
+  memset(results, 0, sizeof(*results));
+}
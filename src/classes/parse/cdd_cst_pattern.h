@@ -0,0 +1,185 @@
+/**
+ * @file cdd_cst_pattern.h
+ * @brief Declarative CST pattern queries, batched into a single traversal.
+ *
+ * Patterns are S-expressions in the style of tree-sitter queries:
+ *
+ *     (call_expr "strcpy" . "(") @call
+ *     (function_definition IDENTIFIER @name . "(")
+ *     (preproc_directive "#include" _ @path)
+ *
+ * - `(kind child...)` matches a node of that kind (the enum name without
+ *   `CDD_CST_`, lower-case) or of any kind for `(_)`. Listed children must
+ *   appear in order but need not be adjacent.
+ * - `"text"` matches a token with exactly that text; `\"` and `\\` escape.
+ * - `IDENTIFIER`, `NUMBER`, `STRING` and `CHAR` match a token of that kind.
+ * - `_` matches any single child, token or node.
+ * - `.` before a child anchors it directly after the previous match (or to
+ *   the first child); `.` before `)` anchors the last match to the end.
+ * - `@name` after any element captures the child it matched.
+ * - `;` starts a comment that runs to the end of the line.
+ *
+ * Every pattern added to a set is compiled to a flat array of steps and
+ * filed under the node kind of its root. A run walks the tree once and, at
+ * each node, tries only the patterns rooted at that node's kind plus the
+ * `(_)` patterns, so adding patterns does not add traversals.
+ *
+ * @author Samuel Marks
+ */
+
+#ifndef CDD_CST_PATTERN_H
+#define CDD_CST_PATTERN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include <stddef.h>
+
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+#include "cdd_cst_node.h"
+/* clang-format on */
+
+/** @brief Opaque set of compiled patterns. */
+typedef struct cdd_cst_pattern_set_t cdd_cst_pattern_set_t;
+
+/**
+ * @brief One match of one pattern.
+ */
+typedef struct cdd_cst_pattern_match_t {
+  size_t pattern;       /**< Id returned by cdd_cst_pattern_set_add */
+  cdd_cst_node_t *node; /**< Node matched by the pattern root */
+  /**
+   * @brief Captured children, indexed by capture id. Entries for captures
+   * of other patterns in the set are zeroed.
+   */
+  const cdd_cst_child_t *captures;
+  size_t num_captures; /**< Capture names in the set */
+} cdd_cst_pattern_match_t;
+
+/**
+ * @brief Receives matches during cdd_cst_pattern_run.
+ *
+ * The tree must not be changed from inside the callback; collect matches
+ * with cdd_cst_pattern_collect to edit afterwards.
+ * @param match The match; valid only for the duration of the call.
+ * @param user_data Passed through from cdd_cst_pattern_run.
+ * @return 0 to continue, non-zero to stop the run with that value.
+ */
+typedef cdd_c_error_t (*cdd_cst_pattern_match_fn)(
+    const cdd_cst_pattern_match_t *match, void *user_data);
+
+/**
+ * @brief Matches gathered by cdd_cst_pattern_collect.
+ */
+typedef struct cdd_cst_pattern_results_t {
+  cdd_cst_pattern_match_t *matches; /**< Matches in traversal order */
+  size_t size;                      /**< Number of matches */
+  size_t capacity;                  /**< Allocated matches */
+  cdd_cst_child_t *captures;        /**< Backing store for all captures */
+} cdd_cst_pattern_results_t;
+
+/**
+ * @brief Create an empty pattern set.
+ * @param[out] out_set Receives the set.
+ * @return 0 on success, CDD_C_ERROR_MEMORY on allocation failure.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_cst_pattern_set_new(cdd_cst_pattern_set_t **out_set);
+
+/**
+ * @brief Free a pattern set.
+ * @param set The set (may be NULL).
+ */
+C_CDD_EXPORT void cdd_cst_pattern_set_free(cdd_cst_pattern_set_t *set);
+
+/**
+ * @brief Compile a pattern and add it to the set.
+ * @param set The set.
+ * @param source Pattern text, as described in the file comment.
+ * @param[out] out_id Optional; receives the pattern id (0, 1, ... in order
+ * of addition).
+ * @param[out] out_error_pos Optional; on a syntax error, receives the byte
+ * offset in `source` where compilation stopped.
+ * @return 0 on success, CDD_C_ERROR_PARSE on a syntax error,
+ * CDD_C_ERROR_MEMORY on allocation failure. The set is unchanged on error.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_cst_pattern_set_add(cdd_cst_pattern_set_t *set,
+                                                   const char *source,
+                                                   size_t *out_id,
+                                                   size_t *out_error_pos);
+
+/**
+ * @brief Look up the id of a capture name (without the `@`).
+ *
+ * Names are shared by all patterns in a set.
+ * @param set The set.
+ * @param name Capture name.
+ * @param[out] out_id Receives the index into `captures`.
+ * @return 0 on success, CDD_C_ERROR_NOT_FOUND if no pattern uses the name.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_cst_pattern_capture_id(
+    const cdd_cst_pattern_set_t *set, const char *name, size_t *out_id);
+
+/**
+ * @brief Get a captured node.
+ * @param match The match.
+ * @param capture_id Capture id.
+ * @return The node, or NULL if the capture is unset or holds a token.
+ */
+C_CDD_EXPORT cdd_cst_node_t *
+cdd_cst_pattern_capture_node(const cdd_cst_pattern_match_t *match,
+                             size_t capture_id);
+
+/**
+ * @brief Get a captured token.
+ * @param match The match.
+ * @param capture_id Capture id.
+ * @return The token, or NULL if the capture is unset or holds a node.
+ */
+C_CDD_EXPORT cdd_token_t *
+cdd_cst_pattern_capture_token(const cdd_cst_pattern_match_t *match,
+                              size_t capture_id);
+
+/**
+ * @brief Run every pattern in the set over a tree in one pre-order walk.
+ *
+ * Matches are reported node by node; at one node, patterns are tried in
+ * the order they were added. A pattern matches a node at most once.
+ * @param set The set.
+ * @param root Root of the (sub)tree to search.
+ * @param on_match Callback for each match.
+ * @param user_data Passed to the callback.
+ * @return 0 on success, the callback's non-zero result, or an error.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_cst_pattern_run(const cdd_cst_pattern_set_t *set, cdd_cst_node_t *root,
+                    cdd_cst_pattern_match_fn on_match, void *user_data);
+
+/**
+ * @brief Run the set and keep every match, e.g. to feed cdd_cst_replace_node
+ * once the walk is over.
+ * @param set The set.
+ * @param root Root of the (sub)tree to search.
+ * @param[out] out_results Receives the matches; release with
+ * cdd_cst_pattern_results_free.
+ * @return 0 on success, CDD_C_ERROR_MEMORY on allocation failure.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_cst_pattern_collect(const cdd_cst_pattern_set_t *set, cdd_cst_node_t *root,
+                        cdd_cst_pattern_results_t *out_results);
+
+/**
+ * @brief Free the storage of collected matches.
+ * @param results The results (may be NULL).
+ */
+C_CDD_EXPORT void
+cdd_cst_pattern_results_free(cdd_cst_pattern_results_t *results);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CDD_CST_PATTERN_H */
@@ -13,11 +13,90 @@ C_CDD_EXPORT int g_cdd_query_err_fail = 0;
 #include "c_cdd/log.h"
 /* clang-format on */
 
+/* --- Traversal --- */
+
+/** @brief Frames held inline before a walk's stack moves to the heap */
+#define CDD_CST_WALK_INLINE 64
+
+/** @brief cdd_cst_walk_frame_t struct */
+typedef struct cdd_cst_walk_frame_t {
+  cdd_cst_node_t *node; /**< Node whose children are being walked */
+  size_t next;          /**< Index of the next child to look at */
+} cdd_cst_walk_frame_t;
+
+/** @brief Explicit stack replacing recursion in the traversals */
+typedef struct cdd_cst_walk_t {
+  cdd_cst_walk_frame_t *frames; /**< `fixed` or a heap block */
+  size_t size;                  /**< Frames in use */
+  size_t capacity;              /**< Frames available */
+  cdd_cst_walk_frame_t fixed[CDD_CST_WALK_INLINE]; /**< Initial storage */
+} cdd_cst_walk_t;
+
+static void walk_init(cdd_cst_walk_t *walk) {
+  walk->frames = walk->fixed;
+  walk->size = 0;
+  walk->capacity = CDD_CST_WALK_INLINE;
+}
+
+static void walk_free(cdd_cst_walk_t *walk) {
+  if (walk->frames != walk->fixed)
+    C_CDD_FREE(walk->frames);
+  walk->frames = walk->fixed;
+  walk->size = 0;
+}
+
+static cdd_c_error_t walk_push(cdd_cst_walk_t *walk, cdd_cst_node_t *node) {
+  if (!node)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (walk->size >= walk->capacity) {
+    size_t new_cap = walk->capacity * 2;
+    cdd_cst_walk_frame_t *grown;
+    if (walk->frames == walk->fixed) {
+      grown = (cdd_cst_walk_frame_t *)C_CDD_MALLOC(
+          new_cap * sizeof(cdd_cst_walk_frame_t));
+      if (grown)
+        memcpy(grown, walk->fixed, walk->size * sizeof(cdd_cst_walk_frame_t));
+    } else {
+      grown = (cdd_cst_walk_frame_t *)C_CDD_REALLOC(
+          walk->frames, new_cap * sizeof(cdd_cst_walk_frame_t));
+    }
+    if (!grown) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      return CDD_C_ERROR_MEMORY;
+    }
+    walk->frames = grown;
+    walk->capacity = new_cap;
+  }
+  walk->frames[walk->size].node = node;
+  walk->frames[walk->size].next = 0;
+  walk->size++;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Advances the top frame to its next node child.
+ *
+ * Children are re-read on every step, so a visitor may edit the node it was
+ * handed exactly as it could under the recursive walk.
+ * @return 1 with `*out_child` set, or 0 once the frame is exhausted.
+ */
+static int walk_next_child(cdd_cst_walk_t *walk, cdd_cst_node_t **out_child) {
+  cdd_cst_walk_frame_t *top = &walk->frames[walk->size - 1];
+  while (top->next < top->node->num_children) {
+    cdd_cst_child_t *child = &top->node->children[top->next++];
+    if (child->kind == CDD_CST_CHILD_NODE) {
+      *out_child = child->val.node;
+      return 1;
+    }
+  }
+  return 0;
+}
+
 cdd_c_error_t cdd_cst_traverse_preorder(cdd_cst_node_t *root,
                                         cdd_cst_visitor_fn visitor,
                                         void *user_data) {
-  size_t i;
-  int rc;
+  cdd_cst_walk_t walk;
+  cdd_c_error_t rc;
   if (!root || !visitor)
     return CDD_C_ERROR_INVALID_ARGUMENT;
 
@@ -25,36 +104,47 @@ cdd_c_error_t cdd_cst_traverse_preorder(cdd_cst_node_t *root,
   if (rc != 0)
     return rc;
 
-  for (i = 0; i < root->num_children; i++) {
-    if (root->children[i].kind == CDD_CST_CHILD_NODE) {
-      rc = cdd_cst_traverse_preorder(root->children[i].val.node, visitor,
-                                     user_data);
-      if (rc != 0)
-        return rc;
+  walk_init(&walk);
+  rc = walk_push(&walk, root);
+  while (rc == CDD_C_SUCCESS && walk.size > 0) {
+    cdd_cst_node_t *child;
+    if (!walk_next_child(&walk, &child)) {
+      walk.size--;
+      continue;
+    }
+    if (!child) {
+      rc = CDD_C_ERROR_INVALID_ARGUMENT;
+      break;
     }
+    rc = visitor(child, user_data);
+    if (rc == CDD_C_SUCCESS)
+      rc = walk_push(&walk, child);
   }
-
-  return CDD_C_SUCCESS;
+  walk_free(&walk);
+  return rc;
 }
 
 cdd_c_error_t cdd_cst_traverse_postorder(cdd_cst_node_t *root,
                                          cdd_cst_visitor_fn visitor,
                                          void *user_data) {
-  size_t i;
-  int rc;
+  cdd_cst_walk_t walk;
+  cdd_c_error_t rc;
   if (!root || !visitor)
     return CDD_C_ERROR_INVALID_ARGUMENT;
 
-  for (i = 0; i < root->num_children; i++) {
-    if (root->children[i].kind == CDD_CST_CHILD_NODE) {
-      rc = cdd_cst_traverse_postorder(root->children[i].val.node, visitor,
-                                      user_data);
-      if (rc != 0)
-        return rc;
+  walk_init(&walk);
+  rc = walk_push(&walk, root);
+  while (rc == CDD_C_SUCCESS && walk.size > 0) {
+    cdd_cst_node_t *child;
+    if (walk_next_child(&walk, &child)) {
+      rc = walk_push(&walk, child);
+    } else {
+      cdd_cst_node_t *done = walk.frames[--walk.size].node;
+      rc = visitor(done, user_data);
     }
   }
-
-  return visitor(root, user_data);
+  walk_free(&walk);
+  return rc;
 }
 
 static cdd_c_error_t append_result(cdd_cst_query_result_t *res,
@@ -250,3 +340,341 @@ cdd_cst_find_function_calls_named(cdd_cst_node_t *root, const char *func_name,
 
   return CDD_C_SUCCESS;
 }
+
+/* --- Tree Index --- */
+
+/** @brief Number of node kinds indexed */
+#define CDD_CST_INDEX_KINDS ((size_t)CDD_CST_UNKNOWN + 1)
+
+/** @brief A call site recorded under its callee name */
+typedef struct cdd_cst_index_site_t {
+  const char *name;     /**< Callee token text (not NUL-terminated) */
+  size_t len;           /**< Length of `name` */
+  cdd_cst_node_t *node; /**< Call node */
+  size_t next;          /**< Next site of the same callee plus one, or 0 */
+} cdd_cst_index_site_t;
+
+/** @brief Callee table slot; site indices are stored plus one, 0 = empty */
+typedef struct cdd_cst_index_slot_t {
+  size_t head;  /**< First site */
+  size_t tail;  /**< Last site */
+  size_t count; /**< Sites in the chain */
+} cdd_cst_index_slot_t;
+
+/** @brief Per-tree index of nodes by kind and calls by callee */
+struct cdd_cst_index_t {
+  cdd_cst_node_t *root;   /**< Root the index was built from */
+  size_t revision;        /**< Tree revision the index reflects */
+  cdd_cst_node_t **nodes; /**< All nodes grouped by kind, pre-order within */
+  size_t num_nodes;       /**< Entries in `nodes` */
+  size_t capacity;        /**< Allocated entries in `nodes` */
+  /** @brief Offset of each kind's run in `nodes` */
+  size_t kind_start[CDD_CST_INDEX_KINDS + 1];
+  cdd_cst_index_site_t *sites; /**< Call sites in pre-order */
+  size_t num_sites;            /**< Entries in `sites` */
+  size_t sites_capacity;       /**< Allocated entries in `sites` */
+  cdd_cst_index_slot_t *slots; /**< Open-addressed callee table */
+  size_t num_slots;            /**< Power of two, or 0 */
+};
+
+static size_t index_hash(const char *name, size_t len) {
+  size_t h = 2166136261u;
+  size_t i;
+  for (i = 0; i < len; i++) {
+    h ^= (unsigned char)name[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+/** @brief Returns the slot for a callee: its chain, or the empty slot. */
+static cdd_cst_index_slot_t *index_slot(const struct cdd_cst_index_t *index,
+                                        const char *name, size_t len) {
+  size_t mask = index->num_slots - 1;
+  size_t i = index_hash(name, len) & mask;
+  for (;;) {
+    cdd_cst_index_slot_t *slot = &index->slots[i];
+    const cdd_cst_index_site_t *site;
+    if (slot->head == 0)
+      return slot;
+    site = &index->sites[slot->head - 1];
+    if (site->len == len && memcmp(site->name, name, len) == 0)
+      return slot;
+    i = (i + 1) & mask;
+  }
+}
+
+static cdd_c_error_t index_add_site(struct cdd_cst_index_t *index,
+                                    cdd_cst_node_t *node,
+                                    const cdd_token_t *tok) {
+  size_t i;
+  /* A node is listed once per distinct name; its sites are contiguous */
+  for (i = index->num_sites; i > 0 && index->sites[i - 1].node == node; i--) {
+    if (index->sites[i - 1].len == tok->length &&
+        memcmp(index->sites[i - 1].name, tok->start, tok->length) == 0)
+      return CDD_C_SUCCESS;
+  }
+  if (index->num_sites >= index->sites_capacity) {
+    size_t new_cap =
+        index->sites_capacity == 0 ? 16 : index->sites_capacity * 2;
+    cdd_cst_index_site_t *grown = (cdd_cst_index_site_t *)C_CDD_REALLOC(
+        index->sites, new_cap * sizeof(cdd_cst_index_site_t));
+    if (!grown) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      return CDD_C_ERROR_MEMORY;
+    }
+    index->sites = grown;
+    index->sites_capacity = new_cap;
+  }
+  index->sites[index->num_sites].name = (const char *)tok->start;
+  index->sites[index->num_sites].len = tok->length;
+  index->sites[index->num_sites].node = node;
+  index->sites[index->num_sites].next = 0;
+  index->num_sites++;
+  return CDD_C_SUCCESS;
+}
+
+/** @brief Records the names call_visitor would match this node under. */
+static cdd_c_error_t index_add_calls(struct cdd_cst_index_t *index,
+                                     cdd_cst_node_t *node) {
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+  size_t i;
+  for (i = 0; i < node->num_children && rc == CDD_C_SUCCESS; i++) {
+    const cdd_cst_child_t *child = &node->children[i];
+    const cdd_token_t *tok = NULL;
+    if (node->kind == CDD_CST_CALL_EXPR) {
+      if (child->kind == CDD_CST_CHILD_TOKEN) {
+        tok = child->val.token;
+      } else if (child->val.node &&
+                 child->val.node->kind == CDD_CST_IDENTIFIER &&
+                 child->val.node->num_children > 0 &&
+                 child->val.node->children[0].kind == CDD_CST_CHILD_TOKEN) {
+        tok = child->val.node->children[0].val.token;
+      }
+    } else if (child->kind == CDD_CST_CHILD_TOKEN &&
+               i + 1 < node->num_children &&
+               node->children[i + 1].kind == CDD_CST_CHILD_TOKEN &&
+               node->children[i + 1].val.token->kind == CDD_TOKEN_LPAREN) {
+      tok = child->val.token;
+    }
+    if (tok && tok->kind == CDD_TOKEN_IDENTIFIER)
+      rc = index_add_site(index, node, tok);
+  }
+  return rc;
+}
+
+static cdd_c_error_t index_visitor(cdd_cst_node_t *node, void *user_data) {
+  struct cdd_cst_index_t *index = (struct cdd_cst_index_t *)user_data;
+  if (index->num_nodes >= index->capacity) {
+    size_t new_cap = index->capacity == 0 ? 64 : index->capacity * 2;
+    cdd_cst_node_t **grown = (cdd_cst_node_t **)C_CDD_REALLOC(
+        index->nodes, new_cap * sizeof(cdd_cst_node_t *));
+    if (!grown) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      return CDD_C_ERROR_MEMORY;
+    }
+    index->nodes = grown;
+    index->capacity = new_cap;
+  }
+  index->nodes[index->num_nodes++] = node;
+  if ((size_t)node->kind < CDD_CST_INDEX_KINDS)
+    index->kind_start[node->kind + 1]++;
+  if (node->kind == CDD_CST_CALL_EXPR || node->kind == CDD_CST_UNKNOWN)
+    return index_add_calls(index, node);
+  return CDD_C_SUCCESS;
+}
+
+/** @brief Stable counting sort of `nodes` by kind. */
+static cdd_c_error_t index_group_kinds(struct cdd_cst_index_t *index) {
+  size_t fill[CDD_CST_INDEX_KINDS];
+  cdd_cst_node_t **grouped;
+  size_t k, i;
+  for (k = 0; k < CDD_CST_INDEX_KINDS; k++)
+    index->kind_start[k + 1] += index->kind_start[k];
+  if (index->num_nodes == 0)
+    return CDD_C_SUCCESS;
+  grouped = (cdd_cst_node_t **)C_CDD_MALLOC(index->num_nodes *
+                                            sizeof(cdd_cst_node_t *));
+  if (!grouped) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+  memcpy(fill, index->kind_start, sizeof(fill));
+  for (i = 0; i < index->num_nodes; i++) {
+    size_t kind = (size_t)index->nodes[i]->kind;
+    if (kind < CDD_CST_INDEX_KINDS)
+      grouped[fill[kind]++] = index->nodes[i];
+  }
+  C_CDD_FREE(index->nodes);
+  index->nodes = grouped;
+  index->capacity = index->num_nodes;
+  return CDD_C_SUCCESS;
+}
+
+/** @brief Chains call sites by callee name. */
+static cdd_c_error_t index_group_calls(struct cdd_cst_index_t *index) {
+  size_t i;
+  if (index->num_sites == 0)
+    return CDD_C_SUCCESS;
+  index->num_slots = 16;
+  while (index->num_slots < index->num_sites * 2)
+    index->num_slots *= 2;
+  index->slots = (cdd_cst_index_slot_t *)C_CDD_CALLOC(
+      index->num_slots, sizeof(cdd_cst_index_slot_t));
+  if (!index->slots) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    index->num_slots = 0;
+    return CDD_C_ERROR_MEMORY;
+  }
+  for (i = 0; i < index->num_sites; i++) {
+    cdd_cst_index_site_t *site = &index->sites[i];
+    cdd_cst_index_slot_t *slot = index_slot(index, site->name, site->len);
+    if (slot->head == 0)
+      slot->head = i + 1;
+    else
+      index->sites[slot->tail - 1].next = i + 1;
+    slot->tail = i + 1;
+    slot->count++;
+  }
+  return CDD_C_SUCCESS;
+}
+
+void cdd_cst_index_free(struct cdd_cst_index_t *index) {
+  if (!index)
+    return;
+  if (index->nodes)
+    C_CDD_FREE(index->nodes);
+  if (index->sites)
+    C_CDD_FREE(index->sites);
+  if (index->slots)
+    C_CDD_FREE(index->slots);
+  C_CDD_FREE(index);
+}
+
+void cdd_cst_tree_invalidate(cdd_cst_tree_t *tree) {
+  if (tree)
+    tree->revision++;
+}
+
+void cdd_cst_node_invalidate(cdd_cst_node_t *node) {
+  if (!node)
+    return;
+  while (node->parent)
+    node = node->parent;
+  if (node->tree && node->tree->root == node)
+    cdd_cst_tree_invalidate(node->tree);
+}
+
+/** @brief Returns the tree's index, rebuilding it if the tree has changed. */
+static cdd_c_error_t index_get(cdd_cst_tree_t *tree,
+                               struct cdd_cst_index_t **out_index) {
+  struct cdd_cst_index_t *index = tree->index;
+  cdd_c_error_t rc;
+
+  if (index && index->root == tree->root && index->revision == tree->revision) {
+    *out_index = index;
+    return CDD_C_SUCCESS;
+  }
+  cdd_cst_index_free(index);
+  tree->index = NULL;
+
+  index = (struct cdd_cst_index_t *)C_CDD_CALLOC(
+      1, sizeof(struct cdd_cst_index_t));
+  if (!index) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+  /* Adopt the root so that node-level edits can reach this tree */
+  tree->root->tree = tree;
+
+  rc = cdd_cst_traverse_preorder(tree->root, index_visitor, index);
+  if (rc == CDD_C_SUCCESS)
+    rc = index_group_kinds(index);
+  if (rc == CDD_C_SUCCESS)
+    rc = index_group_calls(index);
+  if (rc != CDD_C_SUCCESS) {
+    cdd_cst_index_free(index);
+    return rc;
+  }
+  index->root = tree->root;
+  index->revision = tree->revision;
+  tree->index = index;
+  *out_index = index;
+  return CDD_C_SUCCESS;
+}
+
+/** @brief Copies `count` nodes into a fresh result. */
+static cdd_c_error_t index_copy_out(cdd_cst_node_t *const *nodes,
+                                    const cdd_cst_index_site_t *sites,
+                                    size_t first, size_t count,
+                                    cdd_cst_query_result_t *out_result) {
+  size_t i;
+  if (count == 0)
+    return CDD_C_SUCCESS;
+#ifdef CDD_BUILD_TESTS
+  if (g_cdd_query_err_fail)
+    return CDD_C_ERROR_MEMORY;
+#endif
+  out_result->nodes =
+      (cdd_cst_node_t **)C_CDD_MALLOC(count * sizeof(cdd_cst_node_t *));
+  if (!out_result->nodes) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+  if (nodes) {
+    memcpy(out_result->nodes, nodes + first, count * sizeof(cdd_cst_node_t *));
+  } else {
+    for (i = 0; i < count; i++) {
+      out_result->nodes[i] = sites[first - 1].node;
+      first = sites[first - 1].next;
+    }
+  }
+  out_result->size = count;
+  out_result->capacity = count;
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t
+cdd_cst_tree_find_nodes_by_type(cdd_cst_tree_t *tree,
+                                enum cdd_cst_node_kind_t kind,
+                                cdd_cst_query_result_t *out_result) {
+  struct cdd_cst_index_t *index;
+  cdd_c_error_t rc;
+  if (!tree || !tree->root || !out_result)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if ((size_t)kind >= CDD_CST_INDEX_KINDS)
+    return cdd_cst_find_nodes_by_type(tree->root, kind, out_result);
+
+  out_result->nodes = NULL;
+  out_result->size = 0;
+  out_result->capacity = 0;
+
+  rc = index_get(tree, &index);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  return index_copy_out(index->nodes, NULL, index->kind_start[kind],
+                        index->kind_start[kind + 1] - index->kind_start[kind],
+                        out_result);
+}
+
+cdd_c_error_t
+cdd_cst_tree_find_function_calls_named(cdd_cst_tree_t *tree,
+                                       const char *func_name,
+                                       cdd_cst_query_result_t *out_result) {
+  struct cdd_cst_index_t *index;
+  const cdd_cst_index_slot_t *slot;
+  cdd_c_error_t rc;
+  if (!tree || !tree->root || !func_name || !out_result)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  out_result->nodes = NULL;
+  out_result->size = 0;
+  out_result->capacity = 0;
+
+  rc = index_get(tree, &index);
+  if (rc != CDD_C_SUCCESS || index->num_slots == 0)
+    return rc;
+  slot = index_slot(index, func_name, strlen(func_name));
+  return index_copy_out(NULL, index->sites, slot->head, slot->count,
+                        out_result);
+}
@@ -22,6 +22,9 @@ typedef cdd_c_error_t (*cdd_cst_visitor_fn)(cdd_cst_node_t *node,
 
 /**
  * @brief Traverses the CST in pre-order.
+ *
+ * The walk keeps its own stack, so nesting depth is bounded by memory rather
+ * than by the C call stack.
  * @param root The root node to start traversal.
  * @param visitor The callback function.
  * @param user_data Passed to the callback.
@@ -32,7 +35,7 @@ C_CDD_EXPORT cdd_c_error_t cdd_cst_traverse_preorder(cdd_cst_node_t *root,
                                                      void *user_data);
 
 /**
- * @brief Traverses the CST in post-order.
+ * @brief Traverses the CST in post-order, without recursion.
  * @param root The root node to start traversal.
  * @param visitor The callback function.
  * @param user_data Passed to the callback.
@@ -82,6 +85,61 @@ C_CDD_EXPORT cdd_c_error_t
 cdd_cst_find_function_calls_named(cdd_cst_node_t *root, const char *func_name,
                                   cdd_cst_query_result_t *out_result);
 
+/**
+ * @brief Finds all nodes of a kind in a tree using its index.
+ *
+ * The first query after a mutation rebuilds the tree's index in one pass
+ * that records every node by kind and every call by callee name; further
+ * queries copy the matching list out in O(k). Results are in pre-order and
+ * equal those of cdd_cst_find_nodes_by_type on `tree->root`.
+ * @param tree The tree to search.
+ * @param kind The kind of node to find.
+ * @param out_result Pointer to result struct to be populated. Caller must free
+ * out_result->nodes.
+ * @return 0 on success.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_cst_tree_find_nodes_by_type(cdd_cst_tree_t *tree,
+                                enum cdd_cst_node_kind_t kind,
+                                cdd_cst_query_result_t *out_result);
+
+/**
+ * @brief Finds all calls to a function in a tree using its index.
+ * @param tree The tree to search.
+ * @param func_name The name of the function to find calls for.
+ * @param out_result Pointer to result struct. Caller must free
+ * out_result->nodes.
+ * @return 0 on success.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_cst_tree_find_function_calls_named(cdd_cst_tree_t *tree,
+                                       const char *func_name,
+                                       cdd_cst_query_result_t *out_result);
+
+/**
+ * @brief Marks a tree as modified so that its index is rebuilt on next use.
+ *
+ * The functions in cdd_cst_mutate.h and cdd_cst_factory.h call this; code
+ * that edits `children` or `kind` directly on an attached node must too.
+ * @param tree The modified tree (may be NULL).
+ */
+C_CDD_EXPORT void cdd_cst_tree_invalidate(cdd_cst_tree_t *tree);
+
+/**
+ * @brief Marks the tree owning a node as modified.
+ *
+ * Walks up to the topmost ancestor; nodes not attached to a tree are
+ * ignored.
+ * @param node The modified node (may be NULL).
+ */
+C_CDD_EXPORT void cdd_cst_node_invalidate(cdd_cst_node_t *node);
+
+/**
+ * @brief Frees a tree index. Called by cdd_cst_tree_free.
+ * @param index The index to free (may be NULL).
+ */
+C_CDD_EXPORT void cdd_cst_index_free(struct cdd_cst_index_t *index);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -26,7 +26,7 @@ cdd_c_error_t cdd_transform_extern_c(cdd_cst_tree_t *tree,
   }
 
   /* 1. Check if __cplusplus is already checked */
-  rc = cdd_cst_find_nodes_by_type(tree->root, CDD_CST_PREPROC_DIRECTIVE, &res);
+  rc = cdd_cst_tree_find_nodes_by_type(tree, CDD_CST_PREPROC_DIRECTIVE, &res);
   if (rc == 0) {
     for (i = 0; i < res.size; i++) {
       cdd_cst_node_t *dir = res.nodes[i];
@@ -131,7 +131,7 @@ cdd_c_error_t cdd_transform_msvc(cdd_cst_tree_t *tree,
   }
 
   /* 1. Wrap unistd.h and sys/time.h */
-  rc = cdd_cst_find_nodes_by_type(tree->root, CDD_CST_PREPROC_DIRECTIVE, &res);
+  rc = cdd_cst_tree_find_nodes_by_type(tree, CDD_CST_PREPROC_DIRECTIVE, &res);
   if (rc == 0) {
     for (i = 0; i < res.size; i++) {
       cdd_cst_node_t *dir = res.nodes[i];
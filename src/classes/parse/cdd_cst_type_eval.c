@@ -154,27 +154,21 @@ static cdd_c_error_t extract_type_name(cdd_cst_node_t *node, char **out_name,
   return CDD_C_ERROR_NOT_FOUND;
 }
 
-cdd_c_error_t cdd_cst_eval_sizeof(cdd_cst_scope_env_t *env,
-                                  cdd_cst_node_t *type_node,
-                                  enum cdd_cst_abi_model_t abi,
-                                  size_t *out_size) {
+/* sizeof and _Alignof are two fields of one lookup */
+static cdd_c_error_t eval_type_info(cdd_cst_node_t *type_node,
+                                    enum cdd_cst_abi_model_t abi,
+                                    cdd_cst_type_info_t *info) {
   char *name = NULL;
   int is_pointer = 0;
   cdd_c_error_t rc;
-  cdd_cst_type_info_t info;
-
-  if (!env || !type_node || !out_size)
-    return CDD_C_ERROR_INVALID_ARGUMENT;
 
   rc = extract_type_name(type_node, &name, &is_pointer);
-  if (rc != CDD_C_SUCCESS) {
-    *out_size = 0;
+  if (rc != CDD_C_SUCCESS)
     return rc;
-  }
 
   if (is_pointer) {
 
-    rc = cdd_cst_eval_primitive_type("ptr", abi, &info);
+    rc = cdd_cst_eval_primitive_type("ptr", abi, info);
 #ifdef CDD_BUILD_TESTS
     {
       extern C_CDD_EXPORT int g_cdd_type_eval_ptr_fail;
@@ -184,72 +178,41 @@ cdd_c_error_t cdd_cst_eval_sizeof(cdd_cst_scope_env_t *env,
     }
 #endif
 
-    if (rc != CDD_C_SUCCESS) {
-      C_CDD_FREE(name);
-      *out_size = 0;
-      return rc;
-    }
   } else {
-    rc = cdd_cst_eval_primitive_type(name, abi, &info);
-    if (rc != CDD_C_SUCCESS) {
-      C_CDD_FREE(name);
-      *out_size = 0;
-      return rc;
-    }
-    C_CDD_LOG_DEBUG("TYPE NAME: '%s'\n", name);
+    rc = cdd_cst_eval_primitive_type(name, abi, info);
+    if (rc == CDD_C_SUCCESS)
+      C_CDD_LOG_DEBUG("TYPE NAME: '%s'\n", name);
   }
   C_CDD_FREE(name);
+  return rc;
+}
 
-  *out_size = info.size;
-  return CDD_C_SUCCESS;
+cdd_c_error_t cdd_cst_eval_sizeof(cdd_cst_scope_env_t *env,
+                                  cdd_cst_node_t *type_node,
+                                  enum cdd_cst_abi_model_t abi,
+                                  size_t *out_size) {
+  cdd_c_error_t rc;
+  cdd_cst_type_info_t info;
+
+  if (!env || !type_node || !out_size)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  rc = eval_type_info(type_node, abi, &info);
+  *out_size = rc == CDD_C_SUCCESS ? info.size : 0;
+  return rc;
 }
 
 cdd_c_error_t cdd_cst_eval_alignof(cdd_cst_scope_env_t *env,
                                    cdd_cst_node_t *type_node,
                                    enum cdd_cst_abi_model_t abi,
                                    size_t *out_align) {
-  char *name = NULL;
-  int is_pointer = 0;
   cdd_c_error_t rc;
   cdd_cst_type_info_t info;
 
   if (!env || !type_node || !out_align)
     return CDD_C_ERROR_INVALID_ARGUMENT;
 
-  rc = extract_type_name(type_node, &name, &is_pointer);
-  if (rc != CDD_C_SUCCESS) {
-    *out_align = 0;
-    return rc;
-  }
-
-  if (is_pointer) {
-
-    rc = cdd_cst_eval_primitive_type("ptr", abi, &info);
-#ifdef CDD_BUILD_TESTS
-    {
-      extern C_CDD_EXPORT int g_cdd_type_eval_ptr_fail;
-      if (g_cdd_type_eval_ptr_fail) {
-        rc = CDD_C_ERROR_MEMORY;
-      }
-    }
-#endif
-
-    if (rc != CDD_C_SUCCESS) {
-      C_CDD_FREE(name);
-      *out_align = 0;
-      return rc;
-    }
-  } else {
-    rc = cdd_cst_eval_primitive_type(name, abi, &info);
-    if (rc != CDD_C_SUCCESS) {
-      C_CDD_FREE(name);
-      *out_align = 0;
-      return rc;
-    }
-    C_CDD_LOG_DEBUG("TYPE NAME: '%s'\n", name);
-  }
-  C_CDD_FREE(name);
-
-  *out_align = info.alignment;
-  return CDD_C_SUCCESS;
+  rc = eval_type_info(type_node, abi, &info);
+  *out_align = rc == CDD_C_SUCCESS ? info.alignment : 0;
+  return rc;
 }
@@ -28,6 +28,7 @@
 #include "classes/parse/numeric.h"
 #include "functions/emit/codegen.h"
 #include "functions/parse/str.h"
+#include "openapi/parse/json_fragment.h"
 #include "c_cdd/log.h"
 #include "c_cdd/safe_crt.h"
 #include "c_cdd/memory.h"
@@ -289,38 +290,6 @@ static cdd_c_error_t key_in_list(const char *key, const char **list,
   return CDD_C_SUCCESS;
 }
 
-/**
- * @brief Clones a parson JSON_Value safely via serialization roundtrip.
- *
- * Provides deep cloning of JSON values. Will fail (set _out_val to NULL)
- * if the input value is NULL or serialization fails.
- *
- * @param[in] val The original parson JSON value to copy.
- * @param[out] _out_val Output parameter holding the cloned JSON value.
- * @return 0 on success, ENOMEM if a memory issue occurs during copying.
- */
-static cdd_c_error_t clone_json_value(const JSON_Value *val,
-                                      JSON_Value **_out_val) {
-  char *serialized;
-  JSON_Value *copy;
-
-  if (!val) {
-    *_out_val = NULL;
-    return CDD_C_SUCCESS;
-  }
-  serialized = json_serialize_to_string((JSON_Value *)val);
-  if (!serialized) {
-    *_out_val = NULL;
-    return CDD_C_SUCCESS;
-  }
-  copy = json_parse_string(serialized);
-  json_free_serialized_string(serialized);
-  {
-    *_out_val = copy;
-    return CDD_C_SUCCESS;
-  }
-}
-
 /**
  * @brief Safely frees an array of dynamically allocated string pointers.
  *
@@ -842,26 +811,26 @@ cdd_c_error_t parse_type_union_array_code2schema(const JSON_Array *arr,
  *
  * Loops over the properties of `obj` and copies any that do not match
  * keys found within the provided `skip_keys` list into a newly allocated
- * JSON string representing those leftover (extra) attributes.
+ * JSON object holding those leftover (extra) attributes.
  *
  * @param[in] obj The source JSON Object to collect properties from.
  * @param[in] skip_keys Array of string keys to ignore during the copy.
  * @param[in] skip_count Size of the skip_keys array.
- * @param[out] out_json Contains serialized JSON string of extra
- * properties.
+ * @param[out] out_val Receives the owned object of extra properties, or
+ * NULL when there are none.
  * @return 0 on success, ENOMEM on allocation failure.
  */
 static cdd_c_error_t collect_schema_extras(const JSON_Object *obj,
                                            const char **skip_keys,
-                                           size_t skip_count, char **out_json) {
+                                           size_t skip_count,
+                                           JSON_Value **out_val) {
   JSON_Value *extras_val;
   JSON_Object *extras_obj;
   size_t i, count;
-  char *serialized;
 
-  if (out_json)
-    *out_json = NULL;
-  if (!obj || !out_json)
+  if (out_val)
+    *out_val = NULL;
+  if (!obj || !out_val)
     return CDD_C_ERROR_INVALID_ARGUMENT;
 
   extras_val = json_value_init_object();
@@ -880,7 +849,7 @@ static cdd_c_error_t collect_schema_extras(const JSON_Object *obj,
     if (!key || key_in_list(key, skip_keys, skip_count))
       continue;
     val = json_object_get_value(obj, key);
-    clone_json_value(val, &copy);
+    json_value_clone(val, &copy);
     if (!copy) {
       json_value_free(extras_val);
       return CDD_C_ERROR_MEMORY;
@@ -897,46 +866,32 @@ static cdd_c_error_t collect_schema_extras(const JSON_Object *obj,
     return CDD_C_SUCCESS;
   }
 
-  serialized = json_serialize_to_string(extras_val);
-  if (!serialized) {
-    json_value_free(extras_val);
-    return CDD_C_ERROR_MEMORY;
-  }
-  c_cdd_strdup(serialized, out_json);
-  json_free_serialized_string(serialized);
-  json_value_free(extras_val);
-  return *out_json ? 0 : ENOMEM;
+  *out_val = extras_val;
+  return CDD_C_SUCCESS;
 }
 
 /**
- * @brief Merges extra attributes described by a JSON string into a
- * target parson JSON Object.
+ * @brief Merges extra attributes into a target parson JSON Object.
  *
- * Parses the JSON string `extras_json`, clones each value, and sets them
- * directly on `target`. Returns early if there are no extras. Does not
- * override existing keys on `target`.
+ * Clones each value of the `extras` object and sets it directly on
+ * `target`. Returns early if there are no extras. Does not override
+ * existing keys on `target`.
  *
  * @param[in,out] target The JSON_Object to merge properties into.
- * @param[in] extras_json A serialized JSON string of extra properties.
+ * @param[in] extras Object of extra properties (may be NULL).
  * @return 0 on success, ENOMEM on internal failure.
  */
 static cdd_c_error_t merge_schema_extras_object(JSON_Object *target,
-                                                const char *extras_json) {
-  JSON_Value *extras_val;
-  JSON_Object *extras_obj;
+                                                const JSON_Value *extras) {
+  const JSON_Object *extras_obj;
   size_t i, count;
 
-  if (!target || !extras_json || extras_json[0] == '\0')
+  if (!target || !extras)
     return CDD_C_SUCCESS;
 
-  extras_val = json_parse_string(extras_json);
-  if (!extras_val)
-    return CDD_C_SUCCESS;
-  extras_obj = json_value_get_object(extras_val);
-  if (!extras_obj) {
-    json_value_free(extras_val);
+  extras_obj = json_value_get_object(extras);
+  if (!extras_obj)
     return CDD_C_SUCCESS;
-  }
 
   count = json_object_get_count(extras_obj);
   for (i = 0; i < count; ++i) {
@@ -947,20 +902,15 @@ static cdd_c_error_t merge_schema_extras_object(JSON_Object *target,
     if (!key || json_object_has_value(target, key))
       continue;
     val = json_object_get_value(extras_obj, key);
-    clone_json_value(val, &copy);
-    if (!copy) {
-      json_value_free(extras_val);
+    json_value_clone(val, &copy);
+    if (!copy)
       return CDD_C_ERROR_MEMORY;
-    }
     if (json_object_set_value(target, key, copy) != JSONSuccess) {
       json_value_free(copy);
-      json_value_free(extras_val);
       return CDD_C_ERROR_MEMORY;
     }
   }
 
-  json_value_free(extras_val);
-
   /* OpenAPI 3.2.0 coverage expansion:
    *
    * @authorizationUrl implicit password clientCredentials authorizationCode
@@ -1147,51 +1097,30 @@ static cdd_c_error_t merge_schema_extras_object(JSON_Object *target,
 }
 
 /**
- * @brief Merges two serialized JSON objects containing extra schemas
- * together.
+ * @brief Merges two objects of extra schema keywords together.
  *
- * Parses `dest_json` and `src_json`. Clones the properties from the
- * `src` object into `dest`, serializing the result back out into
- * `dest_json`. If `dest_json` was NULL, `src_json` is effectively
- * duplicated into it.
+ * Clones the properties of `src` into `*dest`, replacing keys that are
+ * already present. If `*dest` was NULL, `src` is cloned into it.
  *
- * @param[in,out] dest_json Pointer to an allocated JSON string.
- * Reallocated.
- * @param[in] src_json The JSON string of extra schemas to append.
+ * @param[in,out] dest Pointer to an owned JSON object (may point to NULL).
+ * @param[in] src Object of extra keywords to append (may be NULL).
  * @return 0 on success, ENOMEM if a memory/allocation failure occurs.
  */
-static cdd_c_error_t merge_schema_extras_strings(char **dest_json,
-                                                 const char *src_json) {
-  JSON_Value *dest_val;
-  JSON_Value *src_val;
+static cdd_c_error_t merge_schema_extras_values(JSON_Value **dest,
+                                                const JSON_Value *src) {
   JSON_Object *dest_obj;
-  JSON_Object *src_obj;
+  const JSON_Object *src_obj;
   size_t i, count;
-  char *serialized;
 
-  if (!dest_json || !src_json || src_json[0] == '\0')
+  if (!dest || !src)
     return CDD_C_SUCCESS;
-  if (!*dest_json) {
-    c_cdd_strdup(src_json, dest_json);
-    return *dest_json ? 0 : ENOMEM;
-  }
+  if (!*dest)
+    return json_value_clone(src, dest);
 
-  dest_val = json_parse_string(*dest_json);
-  src_val = json_parse_string(src_json);
-  if (!dest_val || !src_val) {
-    if (dest_val)
-      json_value_free(dest_val);
-    if (src_val)
-      json_value_free(src_val);
-    return CDD_C_SUCCESS;
-  }
-  dest_obj = json_value_get_object(dest_val);
-  src_obj = json_value_get_object(src_val);
-  if (!dest_obj || !src_obj) {
-    json_value_free(dest_val);
-    json_value_free(src_val);
+  dest_obj = json_value_get_object(*dest);
+  src_obj = json_value_get_object(src);
+  if (!dest_obj || !src_obj)
     return CDD_C_SUCCESS;
-  }
 
   count = json_object_get_count(src_obj);
   for (i = 0; i < count; ++i) {
@@ -1203,42 +1132,15 @@ static cdd_c_error_t merge_schema_extras_strings(char **dest_json,
     if (json_object_has_value(dest_obj, key))
       json_object_remove(dest_obj, key);
     val = json_object_get_value(src_obj, key);
-    clone_json_value(val, &copy);
-    if (!copy) {
-      json_value_free(dest_val);
-      json_value_free(src_val);
+    json_value_clone(val, &copy);
+    if (!copy)
       return CDD_C_ERROR_MEMORY;
-    }
     if (json_object_set_value(dest_obj, key, copy) != JSONSuccess) {
       json_value_free(copy);
-      json_value_free(dest_val);
-      json_value_free(src_val);
-      return CDD_C_ERROR_MEMORY;
-    }
-  }
-
-  serialized = json_serialize_to_string(dest_val);
-  if (!serialized) {
-    json_value_free(dest_val);
-    json_value_free(src_val);
-    return CDD_C_ERROR_MEMORY;
-  }
-  {
-    char *dup = NULL;
-    int rc = c_cdd_strdup(serialized, &dup);
-    json_free_serialized_string(serialized);
-    if (rc != 0 || !dup) {
-      json_value_free(dest_val);
-      json_value_free(src_val);
       return CDD_C_ERROR_MEMORY;
     }
-    C_CDD_FREE(*dest_json);
-    *dest_json = dup;
   }
 
-  json_value_free(dest_val);
-  json_value_free(src_val);
-
   /* OpenAPI 3.2.0 coverage expansion:
    *
    * @authorizationUrl implicit password clientCredentials authorizationCode
@@ -1490,7 +1392,8 @@ cdd_c_error_t merge_struct_fields(struct StructFields *dest,
 /**
  * @brief Merges a source struct field into a destination struct field.
  */
-cdd_c_error_t merge_struct_field(struct StructField *dest,
+cdd_c_error_t merge_struct_field(struct StructFields *dest_sf,
+                                 struct StructField *dest,
                                  const struct StructField *src);
 /**
  * @brief Applies an allOf JSON Schema array to a StructFields object.
@@ -1731,56 +1634,45 @@ cdd_c_error_t parse_struct_member_line(const char *line,
       if (is_fam) {
         field->is_flexible_array = 1;
       }
+      if (struct_fields_intern(sf, type_raw, &field->c_type) != 0)
+        rc = CDD_C_ERROR_MEMORY;
 
       /* Inject cdd-c specific ORM annotations */
       if (is_shard_key || is_shard_hash || is_track_telemetry ||
           is_slow_query) {
-        char cdd_json[256];
-        int cdd_len = 0;
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-        cdd_len = sprintf_s(
-            cdd_json, sizeof(cdd_json),
-            "{\"x-cdd-shard-key\":%s, \"x-cdd-shard-hash\":%s, "
-            "\"x-cdd-track-telemetry\":%s, \"x-cdd-slow-query\":%d}",
-            is_shard_key ? "true" : "false", is_shard_hash ? "true" : "false",
-            is_track_telemetry ? "true" : "false",
-            is_slow_query ? slow_query_ms : 0);
-#else
-        cdd_len = sprintf(
-            cdd_json,
-            "{\"x-cdd-shard-key\":%s, \"x-cdd-shard-hash\":%s, "
-            "\"x-cdd-track-telemetry\":%s, \"x-cdd-slow-query\":%d}",
-            is_shard_key ? "true" : "false", is_shard_hash ? "true" : "false",
-            is_track_telemetry ? "true" : "false",
-            is_slow_query ? slow_query_ms : 0);
-#endif
-        if (cdd_len > 0) {
-          merge_schema_extras_strings(&field->schema_extra_json, cdd_json);
+        JSON_Value *cdd_val = json_value_init_object();
+        JSON_Object *cdd_obj = json_value_get_object(cdd_val);
+        if (cdd_obj) {
+          json_object_set_boolean(cdd_obj, "x-cdd-shard-key", is_shard_key);
+          json_object_set_boolean(cdd_obj, "x-cdd-shard-hash", is_shard_hash);
+          json_object_set_boolean(cdd_obj, "x-cdd-track-telemetry",
+                                  is_track_telemetry);
+          json_object_set_number(cdd_obj, "x-cdd-slow-query",
+                                 is_slow_query ? (double)slow_query_ms : 0.0);
+          if (merge_schema_extras_values(&field->schema_extra, cdd_val) != 0)
+            rc = CDD_C_ERROR_MEMORY;
+        } else {
+          rc = CDD_C_ERROR_MEMORY;
         }
+        json_value_free(cdd_val);
       }
 
       if (mapping.oa_format && mapping.oa_type) {
         if (mapping.kind == OA_TYPE_PRIMITIVE && !is_fam) {
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-          strncpy_s(field->format, sizeof(field->format), mapping.oa_format,
-                    sizeof(field->format) - 1);
-#else
-          strncpy(field->format, mapping.oa_format, sizeof(field->format) - 1);
-#endif
-          field->format[sizeof(field->format) - 1] = '\0';
+          if (struct_fields_intern(sf, mapping.oa_format, &field->format) !=
+              0) {
+            rc = CDD_C_ERROR_MEMORY;
+          }
         } else if ((mapping.kind == OA_TYPE_ARRAY || is_fam) &&
                    openapi_type_is_primitive(mapping.oa_type)) {
-          char fmt_json[64];
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-          sprintf_s(fmt_json, sizeof(fmt_json), "{\"format\":\"%s\"}",
-                    mapping.oa_format);
-#else
-          sprintf(fmt_json, "{\"format\":\"%s\"}", mapping.oa_format);
-#endif
-          if (merge_schema_extras_strings(&field->items_extra_json, fmt_json) !=
-              0) {
+          JSON_Value *fmt_val = json_value_init_object();
+          if (!fmt_val ||
+              json_object_set_string(json_value_get_object(fmt_val), "format",
+                                     mapping.oa_format) != JSONSuccess ||
+              merge_schema_extras_values(&field->items_extra, fmt_val) != 0) {
             rc = CDD_C_ERROR_MEMORY;
           }
+          json_value_free(fmt_val);
         }
       }
     } else {
@@ -2016,7 +1908,7 @@ static cdd_c_error_t json_object_to_struct_fields_internal(
   if (collect_schema_extras(o, k_schema_skip_keys,
                             sizeof(k_schema_skip_keys) /
                                 sizeof(k_schema_skip_keys[0]),
-                            &f->schema_extra_json) != 0)
+                            &f->schema_extra) != 0)
     return CDD_C_ERROR_MEMORY;
 
   if (schema_object_is_string_enum(o, &enum_arr)) {
@@ -2185,7 +2077,7 @@ static cdd_c_error_t json_object_to_struct_fields_internal(
           if (collect_schema_extras(items, k_items_skip_keys,
                                     sizeof(k_items_skip_keys) /
                                         sizeof(k_items_skip_keys[0]),
-                                    &field->items_extra_json) != 0)
+                                    &field->items_extra) != 0)
             return CDD_C_ERROR_MEMORY;
         }
         free_string_array_code2schema(items_type_union, n_items_type_union);
@@ -2263,14 +2155,9 @@ static cdd_c_error_t json_object_to_struct_fields_internal(
       }
 
       if (json_object_has_value_of_type(prop, "pattern", JSONString)) {
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-        strncpy_s(field->pattern, sizeof(field->pattern),
-                  json_object_get_string(prop, "pattern"),
-                  sizeof(field->pattern) - 1);
-#else
-        strncpy(field->pattern, json_object_get_string(prop, "pattern"),
-                sizeof(field->pattern) - 1);
-#endif
+        if (struct_fields_intern(f, json_object_get_string(prop, "pattern"),
+                                 &field->pattern) != 0)
+          return CDD_C_ERROR_MEMORY;
       }
     } else if (type && strcmp(type, "array") == 0) {
       if (json_object_has_value_of_type(prop, "minItems", JSONNumber)) {
@@ -2291,24 +2178,10 @@ static cdd_c_error_t json_object_to_struct_fields_internal(
     {
       const char *desc = json_object_get_string(prop, "description");
       const char *fmt = json_object_get_string(prop, "format");
-      if (desc) {
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-        strncpy_s(field->description, sizeof(field->description), desc,
-                  sizeof(field->description) - 1);
-#else
-        strncpy(field->description, desc, sizeof(field->description) - 1);
-#endif
-        field->description[sizeof(field->description) - 1] = '\0';
-      }
-      if (fmt) {
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-        strncpy_s(field->format, sizeof(field->format), fmt,
-                  sizeof(field->format) - 1);
-#else
-        strncpy(field->format, fmt, sizeof(field->format) - 1);
-#endif
-        field->format[sizeof(field->format) - 1] = '\0';
-      }
+      if (desc && struct_fields_intern(f, desc, &field->description) != 0)
+        return CDD_C_ERROR_MEMORY;
+      if (fmt && struct_fields_intern(f, fmt, &field->format) != 0)
+        return CDD_C_ERROR_MEMORY;
       if (json_object_has_value(prop, "deprecated")) {
         field->deprecated_set = 1;
         field->deprecated = json_object_get_boolean(prop, "deprecated");
@@ -2326,7 +2199,7 @@ static cdd_c_error_t json_object_to_struct_fields_internal(
     if (collect_schema_extras(prop, k_property_skip_keys,
                               sizeof(k_property_skip_keys) /
                                   sizeof(k_property_skip_keys[0]),
-                              &field->schema_extra_json) != 0)
+                              &field->schema_extra) != 0)
       return CDD_C_ERROR_MEMORY;
   }
 
@@ -3899,7 +3772,7 @@ register_inline_schema_c2s(JSON_Object *root, const char *schema_name,
 
   if (!json_object_has_value(root, name)) {
     JSON_Value *copy = NULL;
-    clone_json_value(schema_val, &copy);
+    json_value_clone(schema_val, &copy);
     if (!copy) {
       C_CDD_FREE(name);
       return CDD_C_ERROR_MEMORY;
@@ -4165,20 +4038,17 @@ fallback:
 /**
  * @brief Merges a source struct field into a destination struct field.
  */
-cdd_c_error_t merge_struct_field(struct StructField *dest,
+cdd_c_error_t merge_struct_field(struct StructFields *dest_sf,
+                                 struct StructField *dest,
                                  const struct StructField *src) {
   cdd_c_error_t rc = CDD_C_SUCCESS;
-  if (!dest || !src)
+  if (!dest_sf || !dest || !src)
     return CDD_C_ERROR_INVALID_ARGUMENT;
 
-  if (!dest->default_val[0] && src->default_val[0]) {
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-    strncpy_s(dest->default_val, sizeof(dest->default_val), src->default_val,
-              sizeof(dest->default_val) - 1);
-#else
-    strncpy(dest->default_val, src->default_val, sizeof(dest->default_val) - 1);
-#endif
-    dest->default_val[sizeof(dest->default_val) - 1] = '\0';
+  if (!dest->default_val && src->default_val) {
+    rc = struct_fields_intern(dest_sf, src->default_val, &dest->default_val);
+    if (rc != 0)
+      return rc;
   }
 
   if (src->required)
@@ -4235,35 +4105,26 @@ cdd_c_error_t merge_struct_field(struct StructField *dest,
   if (src->unique_items)
     dest->unique_items = 1;
 
-  if (!dest->pattern[0] && src->pattern[0]) {
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-    strncpy_s(dest->pattern, sizeof(dest->pattern), src->pattern,
-              sizeof(dest->pattern) - 1);
-#else
-    strncpy(dest->pattern, src->pattern, sizeof(dest->pattern) - 1);
-#endif
-    dest->pattern[sizeof(dest->pattern) - 1] = '\0';
+  if (!dest->pattern && src->pattern) {
+    rc = struct_fields_intern(dest_sf, src->pattern, &dest->pattern);
+    if (rc != 0)
+      return rc;
   }
 
   if (src->is_flexible_array)
     dest->is_flexible_array = 1;
 
-  if (!dest->bit_width[0] && src->bit_width[0]) {
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-    strncpy_s(dest->bit_width, sizeof(dest->bit_width), src->bit_width,
-              sizeof(dest->bit_width) - 1);
-#else
-    strncpy(dest->bit_width, src->bit_width, sizeof(dest->bit_width) - 1);
-#endif
-    dest->bit_width[sizeof(dest->bit_width) - 1] = '\0';
+  if (!dest->bit_width && src->bit_width) {
+    rc = struct_fields_intern(dest_sf, src->bit_width, &dest->bit_width);
+    if (rc != 0)
+      return rc;
   }
 
-  if (merge_schema_extras_strings(&dest->schema_extra_json,
-                                  src->schema_extra_json) != 0) {
+  if (merge_schema_extras_values(&dest->schema_extra, src->schema_extra) !=
+      0) {
     /* Best-effort: ignore merge failures */
   }
-  if (merge_schema_extras_strings(&dest->items_extra_json,
-                                  src->items_extra_json) != 0) {
+  if (merge_schema_extras_values(&dest->items_extra, src->items_extra) != 0) {
     /* Best-effort: ignore merge failures */
   }
 
@@ -4298,8 +4159,7 @@ cdd_c_error_t merge_struct_fields(struct StructFields *dest,
   if (src->is_enum)
     return CDD_C_SUCCESS;
 
-  if (merge_schema_extras_strings(&dest->schema_extra_json,
-                                  src->schema_extra_json) != 0)
+  if (merge_schema_extras_values(&dest->schema_extra, src->schema_extra) != 0)
     return CDD_C_ERROR_MEMORY;
 
   for (i = 0; i < src->size; ++i) {
@@ -4308,66 +4168,19 @@ cdd_c_error_t merge_struct_fields(struct StructFields *dest,
     struct_fields_get(dest, src_field->name, &dest_field);
 
     if (!dest_field) {
-      const char *ref = src_field->ref[0] ? src_field->ref : NULL;
-      const char *def =
-          src_field->default_val[0] ? src_field->default_val : NULL;
-      const char *bw = src_field->bit_width[0] ? src_field->bit_width : NULL;
-      if (struct_fields_add(dest, src_field->name, src_field->type, ref, def,
-                            bw) != 0)
-        return CDD_C_ERROR_MEMORY;
-      dest_field = NULL;
-      struct_fields_get(dest, src_field->name, &dest_field);
-      if (!dest_field) {
-        C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      cdd_c_error_t crc;
+      if (struct_fields_add(dest, src_field->name, src_field->type, NULL, NULL,
+                            NULL) != 0)
         return CDD_C_ERROR_MEMORY;
-      }
-      {
-        struct StructField tmp = *src_field;
-        *dest_field = tmp;
-        dest_field->schema_extra_json = NULL;
-        dest_field->items_extra_json = NULL;
-        dest_field->type_union = NULL;
-        dest_field->items_type_union = NULL;
-        dest_field->items_extra_json = NULL;
-        dest_field->type_union = NULL;
-        dest_field->n_type_union = 0;
-        dest_field->items_type_union = NULL;
-        dest_field->n_items_type_union = 0;
-        if (src_field->schema_extra_json) {
-          c_cdd_strdup(src_field->schema_extra_json,
-                       &dest_field->schema_extra_json);
-          if (!dest_field->schema_extra_json) {
-            C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
-            return CDD_C_ERROR_MEMORY;
-          }
-        }
-        if (src_field->items_extra_json) {
-          c_cdd_strdup(src_field->items_extra_json,
-                       &dest_field->items_extra_json);
-          if (!dest_field->items_extra_json) {
-            C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
-            return CDD_C_ERROR_MEMORY;
-          }
-        }
-        if (src_field->type_union && src_field->n_type_union > 0) {
-          if (copy_string_array_code2schema(
-                  &dest_field->type_union, &dest_field->n_type_union,
-                  src_field->type_union, src_field->n_type_union) != 0)
-            return CDD_C_ERROR_MEMORY;
-        }
-        if (src_field->items_type_union && src_field->n_items_type_union > 0) {
-          if (copy_string_array_code2schema(&dest_field->items_type_union,
-                                            &dest_field->n_items_type_union,
-                                            src_field->items_type_union,
-                                            src_field->n_items_type_union) != 0)
-            return CDD_C_ERROR_MEMORY;
-        }
-      }
+      dest_field = &dest->fields[dest->size - 1];
+      crc = struct_field_copy(dest, dest_field, src_field);
+      if (crc != CDD_C_SUCCESS)
+        return crc;
       continue;
     }
 
     {
-      cdd_c_error_t mrc = merge_struct_field(dest_field, src_field);
+      cdd_c_error_t mrc = merge_struct_field(dest, dest_field, src_field);
       if (mrc != CDD_C_SUCCESS)
         return mrc;
     }
@@ -5605,7 +5418,7 @@ static cdd_c_error_t write_string_constraints(JSON_Object *pobj,
     json_object_set_number(pobj, "minLength", (double)field->min_len);
   if (field->has_max_len)
     json_object_set_number(pobj, "maxLength", (double)field->max_len);
-  if (field->pattern[0] != '\0')
+  if (field->pattern)
     json_object_set_string(pobj, "pattern", field->pattern);
   return CDD_C_SUCCESS;
 }
@@ -5629,6 +5442,28 @@ static cdd_c_error_t write_array_constraints(JSON_Object *pobj,
   return CDD_C_SUCCESS;
 }
 
+/**
+ * @brief Sets `$ref`, prefixing bare schema names with the components path.
+ */
+static cdd_c_error_t write_schema_ref(JSON_Object *obj, const char *ref) {
+  static const char prefix[] = "#/components/schemas/";
+  char *ref_str;
+  size_t ref_len;
+  if (ref[0] == '#') {
+    json_object_set_string(obj, "$ref", ref);
+    return CDD_C_SUCCESS;
+  }
+  ref_len = strlen(ref);
+  ref_str = (char *)C_CDD_MALLOC(sizeof(prefix) + ref_len);
+  if (!ref_str)
+    return CDD_C_ERROR_MEMORY;
+  memcpy(ref_str, prefix, sizeof(prefix) - 1);
+  memcpy(ref_str + sizeof(prefix) - 1, ref, ref_len + 1);
+  json_object_set_string(obj, "$ref", ref_str);
+  C_CDD_FREE(ref_str);
+  return CDD_C_SUCCESS;
+}
+
 /**
  * @brief Writes a type union array to a JSON schema object.
  */
@@ -5689,7 +5524,7 @@ cdd_c_error_t write_struct_to_json_schema(JSON_Object *schemas_obj,
         json_array_append_string(enum_arr, member);
     }
     json_object_set_value(obj, "enum", enum_val);
-    if (merge_schema_extras_object(obj, sf->schema_extra_json) != 0) {
+    if (merge_schema_extras_object(obj, sf->schema_extra) != 0) {
       json_value_free(val);
       json_value_free(props_val);
       return CDD_C_ERROR_MEMORY;
@@ -5726,16 +5561,10 @@ cdd_c_error_t write_struct_to_json_schema(JSON_Object *schemas_obj,
             strcmp(ref, "boolean") == 0 || strcmp(ref, "number") == 0) {
           json_object_set_string(items_obj, "type", ref);
         } else {
-          char ref_str[128];
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-          sprintf_s(ref_str, sizeof(ref_str), "#/components/schemas/%s", ref);
-#else
-          sprintf(ref_str, "#/components/schemas/%s", ref);
-#endif
-          json_object_set_string(items_obj, "$ref", ref_str);
+          write_schema_ref(items_obj, ref);
         }
       }
-      if (merge_schema_extras_object(items_obj, field->items_extra_json) != 0) {
+      if (merge_schema_extras_object(items_obj, field->items_extra) != 0) {
         json_value_free(items_val);
         json_value_free(pval);
         json_value_free(val);
@@ -5745,22 +5574,8 @@ cdd_c_error_t write_struct_to_json_schema(JSON_Object *schemas_obj,
       write_array_constraints(pobj, field);
     } else {
       if (strcmp(typ, "object") == 0 || strcmp(typ, "enum") == 0) {
-        char ref_str[128];
         if (ref && *ref) {
-          if (ref[0] == '#') {
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-            sprintf_s(ref_str, sizeof(ref_str), "%s", ref);
-#else
-            sprintf(ref_str, "%s", ref);
-#endif
-          } else {
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-            sprintf_s(ref_str, sizeof(ref_str), "#/components/schemas/%s", ref);
-#else
-            sprintf(ref_str, "#/components/schemas/%s", ref);
-#endif
-          }
-          json_object_set_string(pobj, "$ref", ref_str);
+          write_schema_ref(pobj, ref);
         } else {
           write_type_union(pobj, "object", field->type_union,
                            field->n_type_union);
@@ -5772,9 +5587,9 @@ cdd_c_error_t write_struct_to_json_schema(JSON_Object *schemas_obj,
     write_numeric_constraints(pobj, field);
     write_string_constraints(pobj, field);
     write_default_value(pobj, field);
-    if (field->description[0])
+    if (field->description)
       json_object_set_string(pobj, "description", field->description);
-    if (field->format[0])
+    if (field->format)
       json_object_set_string(pobj, "format", field->format);
     if (field->deprecated_set)
       json_object_set_boolean(pobj, "deprecated", field->deprecated ? 1 : 0);
@@ -5782,7 +5597,7 @@ cdd_c_error_t write_struct_to_json_schema(JSON_Object *schemas_obj,
       json_object_set_boolean(pobj, "readOnly", field->read_only ? 1 : 0);
     if (field->write_only_set)
       json_object_set_boolean(pobj, "writeOnly", field->write_only ? 1 : 0);
-    if (merge_schema_extras_object(pobj, field->schema_extra_json) != 0) {
+    if (merge_schema_extras_object(pobj, field->schema_extra) != 0) {
       json_value_free(pval);
       json_value_free(val);
       return CDD_C_ERROR_MEMORY;
@@ -5801,7 +5616,7 @@ cdd_c_error_t write_struct_to_json_schema(JSON_Object *schemas_obj,
   if (req_val)
     json_object_set_value(obj, "required", req_val);
 
-  if (merge_schema_extras_object(obj, sf->schema_extra_json) != 0) {
+  if (merge_schema_extras_object(obj, sf->schema_extra) != 0) {
     json_value_free(val);
     return CDD_C_ERROR_MEMORY;
   }
@@ -6245,39 +6060,35 @@ static cdd_c_error_t parse_union_and_write(FILE *fp, JSON_Object *schemas_obj,
 }
 
 static cdd_c_error_t collapse_arrays(struct StructFields *sf) {
-  size_t i, j;
+  size_t i;
   if (!sf)
     return CDD_C_ERROR_INVALID_ARGUMENT;
   for (i = 0; i < sf->size; ++i) {
     printf("DEBUG FIELD[%zu]: name='%s', type='%s', ref='%s'\n", i,
-           sf->fields[i].name, sf->fields[i].type, sf->fields[i].ref);
+           sf->fields[i].name, sf->fields[i].type,
+           sf->fields[i].ref ? sf->fields[i].ref : "");
   }
   for (i = 0; i < sf->size; ++i) {
     if (strncmp(sf->fields[i].name, "n_", 2) == 0) {
-      const char *base_name = sf->fields[i].name + 2;
-      for (j = 0; j < sf->size; ++j) {
-        if (strcmp(sf->fields[j].name, base_name) == 0) {
-          /* Found a match! sf->fields[j] is the array, sf->fields[i] is the
-           * length */
-          if (strcmp(sf->fields[j].type, "array") != 0) {
-            if (strcmp(sf->fields[j].type, "string") == 0) {
-              strcpy(sf->fields[j].type, "array");
-              strcpy(sf->fields[j].ref, "string");
-            } else if (strcmp(sf->fields[j].type, "object") == 0) {
-              strcpy(sf->fields[j].type, "array");
-              /* keep existing ref for objects */
-            } else {
-              strcpy(sf->fields[j].ref, sf->fields[j].type);
-              strcpy(sf->fields[j].type, "array");
-            }
+      struct StructField *arr = NULL;
+      struct_fields_get(sf, sf->fields[i].name + 2, &arr);
+      if (arr) {
+        /* Found a match! arr is the array, sf->fields[i] is the length */
+        if (strcmp(arr->type, "array") != 0) {
+          if (strcmp(arr->type, "string") == 0) {
+            arr->type = "array";
+            arr->ref = "string";
+          } else if (strcmp(arr->type, "object") == 0) {
+            arr->type = "array";
+            /* keep existing ref for objects */
+          } else {
+            arr->ref = arr->type;
+            arr->type = "array";
           }
-          /* Remove the n_ field */
-          memmove(&sf->fields[i], &sf->fields[i + 1],
-                  (sf->size - i - 1) * sizeof(struct StructField));
-          sf->size--;
-          i--; /* Adjust index since we removed a field */
-          break;
         }
+        /* Remove the n_ field */
+        struct_fields_remove(sf, i);
+        i--; /* Adjust index since we removed a field */
       }
     }
   }
@@ -200,7 +200,8 @@ extern C_CDD_EXPORT /**
                                             const char *schema_name);
 
 extern C_CDD_EXPORT cdd_c_error_t
-merge_struct_field(struct StructField *dest, const struct StructField *src);
+merge_struct_field(struct StructFields *dest_sf, struct StructField *dest,
+                   const struct StructField *src);
 extern C_CDD_EXPORT cdd_c_error_t discriminator_value_for_variant(
     const JSON_Object *disc_obj, const char *schema_name, const char *ref,
     char **_out_val);
@@ -110,255 +110,364 @@ static cdd_c_error_t add_type_def(struct TypeDefList *list,
 }
 
 /**
- * @brief Executes the c inspector scan file types operation.
+ * @brief Modes of the line-based type scanner.
  */
-cdd_c_error_t c_inspector_scan_file_types(const char *filename,
-                                          struct TypeDefList *out) {
-  FILE *fp = NULL;
-  char line[2048];
-  /* Simple State Machine */
-  enum { ST_NONE, ST_ENUM, ST_STRUCT } state = ST_NONE;
-  char current_name[64] = {0};
+enum TypeScanMode { ST_NONE, ST_ENUM, ST_STRUCT };
 
-  struct EnumMembers *curr_em = NULL;
-  struct StructFields *curr_sf = NULL;
-  int rc = 0;
-
-  if (!filename || !out)
-    return CDD_C_ERROR_INVALID_ARGUMENT;
+/**
+ * @brief State carried from one line to the next by the type scanner.
+ */
+struct TypeScanState {
+  enum TypeScanMode state;      /**< Kind of definition currently open */
+  char current_name[64];        /**< Name of the open definition */
+  struct EnumMembers *curr_em;  /**< Members of the open enum */
+  struct StructFields *curr_sf; /**< Fields of the open struct */
+};
 
-#if defined(_MSC_VER)
-  if (fopen_s(&fp, filename, "r") != 0)
-    fp = NULL;
-#else
-#if defined(_MSC_VER)
-  fopen_s(&fp, filename, "r");
-#else
-#if defined(_MSC_VER)
-  if (fopen_s(&fp, filename, "r") != 0)
-    fp = NULL;
-#else
-  fp = fopen(filename, "r");
-#endif
-#endif
-#endif
-  if (!fp) {
-    if (errno == ENOENT)
-      return CDD_C_ERROR_NOT_FOUND;
-    return CDD_C_ERROR_IO;
-  }
+/**
+ * @brief Feeds one line, as returned by `fgets`, through the type scanner.
+ */
+static cdd_c_error_t type_scan_line(struct TypeScanState *st, char *line,
+                                    struct TypeDefList *out) {
+  char *p = line;
+  char *close_brace = NULL;
+  int rc = 0;
 
-  while (fgets(line, sizeof(line), fp)) {
-    char *p = line;
-    char *close_brace = NULL;
-
-    /* Inner loop to handle multiple tokens/state changes on one line */
-    while (*p) {
-      /* Trim Leading WS */
-      while (*p && isspace((unsigned char)*p))
-        p++;
-      if (!*p)
-        break;
+  /* Inner loop to handle multiple tokens/state changes on one line */
+  while (*p) {
+    /* Trim Leading WS */
+    while (*p && isspace((unsigned char)*p))
+      p++;
+    if (!*p)
+      break;
 
-      if (state == ST_NONE) {
-        int starts1 = false, starts2 = false;
-        c_cdd_str_starts_with(p, "enum ", &starts1);
-        c_cdd_str_starts_with(p, "struct ", &starts2);
-        if (starts1 || starts2) {
-          char *brace = strchr(p, '{');
-
-          if (brace) {
-            int is_enum = starts1;
-            /* Extract "Name" from "enum Name {" or "struct Name {" */
-            const char *name_start = p + (is_enum ? 5 : 7);
-            const char *name_end_ptr = brace;
-
-            /* Handle C23 enum fixed type: enum Name : type { */
-            if (is_enum) {
-              char *colon = NULL;
-              char *scan = (char *)name_start;
-              while (scan < brace) {
-                if (*scan == ':') {
-                  colon = scan;
-                  break;
-                }
-                scan++;
-              }
-              if (colon) {
-                name_end_ptr = colon;
+    if (st->state == ST_NONE) {
+      int starts1 = false, starts2 = false;
+      c_cdd_str_starts_with(p, "enum ", &starts1);
+      c_cdd_str_starts_with(p, "struct ", &starts2);
+      if (starts1 || starts2) {
+        char *brace = strchr(p, '{');
+
+        if (brace) {
+          int is_enum = starts1;
+          /* Extract "Name" from "enum Name {" or "struct Name {" */
+          const char *name_start = p + (is_enum ? 5 : 7);
+          const char *name_end_ptr = brace;
+
+          /* Handle C23 enum fixed type: enum Name : type { */
+          if (is_enum) {
+            char *colon = NULL;
+            char *scan = (char *)name_start;
+            while (scan < brace) {
+              if (*scan == ':') {
+                colon = scan;
+                break;
               }
+              scan++;
             }
+            if (colon) {
+              name_end_ptr = colon;
+            }
+          }
 
-            if (name_end_ptr > name_start) {
-              size_t n_len = (size_t)(name_end_ptr - name_start);
+          if (name_end_ptr > name_start) {
+            size_t n_len = (size_t)(name_end_ptr - name_start);
 
-              /* Trim leading whitespace from name */
-              while (n_len > 0 && isspace((unsigned char)*name_start)) {
-                name_start++;
-                n_len--;
-              }
+            /* Trim leading whitespace from name */
+            while (n_len > 0 && isspace((unsigned char)*name_start)) {
+              name_start++;
+              n_len--;
+            }
 
-              /* Trim trailing spaces from name buffer range */
-              while (n_len > 0 && isspace((unsigned char)name_start[n_len - 1]))
-                n_len--;
+            /* Trim trailing spaces from name buffer range */
+            while (n_len > 0 && isspace((unsigned char)name_start[n_len - 1]))
+              n_len--;
 
-              memcpy(current_name, name_start, n_len);
-              current_name[n_len] = '\0';
-            } else {
-              current_name[0] = 0;
-            }
+            if (n_len >= sizeof(st->current_name))
+              n_len = sizeof(st->current_name) - 1;
+            memcpy(st->current_name, name_start, n_len);
+            st->current_name[n_len] = '\0';
+          } else {
+            st->current_name[0] = 0;
+          }
 
-            if (is_enum) {
-              curr_em = (struct EnumMembers *)C_CDD_CALLOC(1, sizeof(*curr_em));
-              if (!curr_em || enum_members_init(curr_em) != 0) {
-                rc = CDD_C_ERROR_MEMORY;
-                break;
-              }
-              state = ST_ENUM;
-            } else {
-              curr_sf =
-                  (struct StructFields *)C_CDD_CALLOC(1, sizeof(*curr_sf));
-              if (!curr_sf || struct_fields_init(curr_sf) != 0) {
-                rc = CDD_C_ERROR_MEMORY;
-                break;
-              }
-              state = ST_STRUCT;
+          if (is_enum) {
+            st->curr_em =
+                (struct EnumMembers *)C_CDD_CALLOC(1, sizeof(*st->curr_em));
+            if (!st->curr_em || enum_members_init(st->curr_em) != 0) {
+              rc = CDD_C_ERROR_MEMORY;
+              break;
             }
-
-            /* Advance p to inside the brace */
-            p = brace + 1;
-            continue;
+            st->state = ST_ENUM;
           } else {
-            /* No brace found, possibly forward decl or split line. Skip line.
-             */
-            break;
+            st->curr_sf =
+                (struct StructFields *)C_CDD_CALLOC(1, sizeof(*st->curr_sf));
+            if (!st->curr_sf || struct_fields_init(st->curr_sf) != 0) {
+              rc = CDD_C_ERROR_MEMORY;
+              break;
+            }
+            st->state = ST_STRUCT;
           }
-        }
-        /* Skip unknown content in ST_NONE */
-        p++;
-      } else {
-        /* Inside a definition block */
-        close_brace = strchr(p, '}');
 
-        if (close_brace) {
-          *close_brace =
-              '\0'; /* Temporarily terminate to parse members up to } */
+          /* Advance p to inside the brace */
+          p = brace + 1;
+          continue;
+        } else {
+          /* No brace found, possibly forward decl or split line. Skip line.
+           */
+          break;
         }
+      }
+      /* Skip unknown content in ST_NONE */
+      p++;
+    } else {
+      /* Inside a definition block */
+      close_brace = strchr(p, '}');
+
+      if (close_brace) {
+        *close_brace =
+            '\0'; /* Temporarily terminate to parse members up to } */
+      }
 
-        /* Parse Member string in p (up to terminator) */
-        /* For enums on one line: "A, B" */
-        if (state == ST_ENUM && *p) {
-          char *copy = NULL;
-          c_cdd_strdup(p, &copy);
-          if (copy) {
-            char *ctx = NULL;
+      /* Parse Member string in p (up to terminator) */
+      /* For enums on one line: "A, B" */
+      if (st->state == ST_ENUM && *p) {
+        char *copy = NULL;
+        c_cdd_strdup(p, &copy);
+        if (copy) {
+          char *ctx = NULL;
 #ifdef _WIN32
-            char *tok = strtok_s(copy, ",", &ctx);
+          char *tok = strtok_s(copy, ",", &ctx);
 #else
-            char *tok = strtok_r(copy, ",", &ctx);
+          char *tok = strtok_r(copy, ",", &ctx);
 #endif
-            while (tok) {
-              char *eq = strchr(tok, '=');
-              if (eq)
-                *eq = 0;
-              c_cdd_str_trim_trailing_whitespace(tok);
-              while (*tok && isspace((unsigned char)*tok))
-                tok++;
-              if (*tok)
-                enum_members_add(curr_em, tok);
+          while (tok) {
+            char *eq = strchr(tok, '=');
+            if (eq)
+              *eq = 0;
+            c_cdd_str_trim_trailing_whitespace(tok);
+            while (*tok && isspace((unsigned char)*tok))
+              tok++;
+            if (*tok)
+              enum_members_add(st->curr_em, tok);
 #ifdef _WIN32
-              tok = strtok_s(NULL, ",", &ctx);
+            tok = strtok_s(NULL, ",", &ctx);
 #else
-              tok = strtok_r(NULL, ",", &ctx);
+            tok = strtok_r(NULL, ",", &ctx);
 #endif
-            }
-            C_CDD_FREE(copy);
           }
-        } else if (state == ST_STRUCT) {
-          if (*p) {
-            /* Support multiple fields on same line separated by semicolon */
-            char *copy = NULL;
-            c_cdd_strdup(p, &copy);
-            if (copy) {
-              char *ctx = NULL;
+          C_CDD_FREE(copy);
+        }
+      } else if (st->state == ST_STRUCT) {
+        if (*p) {
+          /* Support multiple fields on same line separated by semicolon */
+          char *copy = NULL;
+          c_cdd_strdup(p, &copy);
+          if (copy) {
+            char *ctx = NULL;
 #ifdef _WIN32
-              char *tok = strtok_s(copy, ";", &ctx);
+            char *tok = strtok_s(copy, ";", &ctx);
 #else
-              char *tok = strtok_r(copy, ";", &ctx);
+            char *tok = strtok_r(copy, ";", &ctx);
 #endif
-              while (tok) {
-                /* Ensure not just whitespace */
-                char *chk = tok;
-                while (*chk && isspace((unsigned char)*chk))
-                  chk++;
-                if (*chk)
-                  parse_struct_member_line(tok, curr_sf);
+            while (tok) {
+              /* Ensure not just whitespace */
+              char *chk = tok;
+              while (*chk && isspace((unsigned char)*chk))
+                chk++;
+              if (*chk)
+                parse_struct_member_line(tok, st->curr_sf);
 #ifdef _WIN32
-                tok = strtok_s(NULL, ";", &ctx);
+              tok = strtok_s(NULL, ";", &ctx);
 #else
-                tok = strtok_r(NULL, ";", &ctx);
+              tok = strtok_r(NULL, ";", &ctx);
 #endif
-              }
-              C_CDD_FREE(copy);
             }
+            C_CDD_FREE(copy);
           }
         }
+      }
 
-        if (close_brace) {
-          /* Definition Ended */
-          if (current_name[0] != '\0') {
-            if (state == ST_ENUM) {
-              if (add_type_def(out, KIND_ENUM, current_name, curr_em) != 0) {
-                enum_members_free(curr_em);
-                C_CDD_FREE(curr_em);
-                rc = CDD_C_ERROR_MEMORY;
-              }
-              curr_em = NULL;
-            } else {
-              if (add_type_def(out, KIND_STRUCT, current_name, curr_sf) != 0) {
-                struct_fields_free(curr_sf);
-                C_CDD_FREE(curr_sf);
-                rc = CDD_C_ERROR_MEMORY;
-              }
-              curr_sf = NULL;
+      if (close_brace) {
+        /* Definition Ended */
+        if (st->current_name[0] != '\0') {
+          if (st->state == ST_ENUM) {
+            if (add_type_def(out, KIND_ENUM, st->current_name, st->curr_em) !=
+                0) {
+              enum_members_free(st->curr_em);
+              C_CDD_FREE(st->curr_em);
+              rc = CDD_C_ERROR_MEMORY;
             }
+            st->curr_em = NULL;
           } else {
-            if (curr_em) {
-              enum_members_free(curr_em);
-              C_CDD_FREE(curr_em);
-              curr_em = NULL;
-            }
-            if (curr_sf) {
-              struct_fields_free(curr_sf);
-              C_CDD_FREE(curr_sf);
-              curr_sf = NULL;
+            if (add_type_def(out, KIND_STRUCT, st->current_name,
+                             st->curr_sf) != 0) {
+              struct_fields_free(st->curr_sf);
+              C_CDD_FREE(st->curr_sf);
+              rc = CDD_C_ERROR_MEMORY;
             }
+            st->curr_sf = NULL;
           }
-          state = ST_NONE;
-          p = close_brace + 1; /* Continue processing after } */
         } else {
-          /* No closing brace, consumed rest of line as member */
-          break;
+          if (st->curr_em) {
+            enum_members_free(st->curr_em);
+            C_CDD_FREE(st->curr_em);
+            st->curr_em = NULL;
+          }
+          if (st->curr_sf) {
+            struct_fields_free(st->curr_sf);
+            C_CDD_FREE(st->curr_sf);
+            st->curr_sf = NULL;
+          }
         }
+        st->state = ST_NONE;
+        p = close_brace + 1; /* Continue processing after } */
+      } else {
+        /* No closing brace, consumed rest of line as member */
+        break;
       }
     }
-    if (rc != 0)
-      break;
   }
+  return rc;
+}
 
-  /* Cleanup leftovers */
-  if (curr_em) {
-    enum_members_free(curr_em);
-    C_CDD_FREE(curr_em);
+/**
+ * @brief Releases a definition still open at the end of the input.
+ */
+static void type_scan_finish(struct TypeScanState *st) {
+  if (st->curr_em) {
+    enum_members_free(st->curr_em);
+    C_CDD_FREE(st->curr_em);
+    st->curr_em = NULL;
   }
-  if (curr_sf) {
-    struct_fields_free(curr_sf);
-    C_CDD_FREE(curr_sf);
+  if (st->curr_sf) {
+    struct_fields_free(st->curr_sf);
+    C_CDD_FREE(st->curr_sf);
+    st->curr_sf = NULL;
   }
+}
+
+/**
+ * @brief Executes the c inspector scan file types operation.
+ */
+cdd_c_error_t c_inspector_scan_file_types(const char *filename,
+                                          struct TypeDefList *out) {
+  FILE *fp = NULL;
+  char line[2048];
+  struct TypeScanState st;
+  int rc = 0;
+
+  if (!filename || !out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+#if defined(_MSC_VER)
+  if (fopen_s(&fp, filename, "r") != 0)
+    fp = NULL;
+#else
+#if defined(_MSC_VER)
+  fopen_s(&fp, filename, "r");
+#else
+#if defined(_MSC_VER)
+  if (fopen_s(&fp, filename, "r") != 0)
+    fp = NULL;
+#else
+  fp = fopen(filename, "r");
+#endif
+#endif
+#endif
+  if (!fp) {
+    if (errno == ENOENT)
+      return CDD_C_ERROR_NOT_FOUND;
+    return CDD_C_ERROR_IO;
+  }
+
+  memset(&st, 0, sizeof(st));
+  while (fgets(line, sizeof(line), fp)) {
+    rc = type_scan_line(&st, line, out);
+    if (rc != 0)
+      break;
+  }
+
+  type_scan_finish(&st);
   fclose(fp);
   return rc;
 }
 
+/**
+ * @brief Executes the c inspector scan string types operation.
+ */
+cdd_c_error_t c_inspector_scan_string_types(const char *src,
+                                            struct TypeDefList *out,
+                                            char **out_relevant) {
+  char line[2048];
+  struct TypeScanState st;
+  char *relevant = NULL;
+  size_t relevant_len = 0;
+  size_t relevant_cap = 0;
+  int rc = 0;
+
+  if (!src || !out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (out_relevant)
+    *out_relevant = NULL;
+
+  memset(&st, 0, sizeof(st));
+  while (*src) {
+    enum TypeScanMode before = st.state;
+    size_t n_before = out->size;
+    size_t n = 0;
+
+    /* Split exactly as fgets() into `line` would */
+    while (src[n] && n < sizeof(line) - 1) {
+      if (src[n++] == '\n')
+        break;
+    }
+    memcpy(line, src, n);
+    line[n] = '\0';
+
+    rc = type_scan_line(&st, line, out);
+    if (rc != 0)
+      break;
+
+    /* A line that starts and ends outside any definition without adding one
+     * has no effect on the result, so it is left out of `out_relevant`. */
+    if (out_relevant &&
+        (before != ST_NONE || st.state != ST_NONE || out->size != n_before)) {
+      if (relevant_len + n + 1 > relevant_cap) {
+        size_t new_cap = relevant_cap ? relevant_cap * 2 : 256;
+        char *grown;
+        while (new_cap < relevant_len + n + 1)
+          new_cap *= 2;
+        grown = (char *)C_CDD_REALLOC(relevant, new_cap);
+        if (!grown) {
+          rc = CDD_C_ERROR_MEMORY;
+          break;
+        }
+        relevant = grown;
+        relevant_cap = new_cap;
+      }
+      memcpy(relevant + relevant_len, src, n);
+      relevant_len += n;
+    }
+    src += n;
+  }
+
+  type_scan_finish(&st);
+  if (rc != 0 || !out_relevant) {
+    if (relevant)
+      C_CDD_FREE(relevant);
+    return rc;
+  }
+  if (!relevant) {
+    relevant = (char *)C_CDD_MALLOC(1);
+    if (!relevant)
+      return CDD_C_ERROR_MEMORY;
+  }
+  relevant[relevant_len] = '\0';
+  *out_relevant = relevant;
+  return CDD_C_SUCCESS;
+}
+
 /* --- Function Signature Logic --- */
 
 /**
@@ -117,6 +117,21 @@ extern C_CDD_EXPORT /**
     cdd_c_error_t
     c_inspector_scan_file_types(const char *filename, struct TypeDefList *out);
 
+/**
+ * @brief Scan an in-memory buffer for struct/enum definitions.
+ *
+ * Splits `src` into lines exactly as `c_inspector_scan_file_types` reads
+ * them from disk, so both produce the same list for the same text.
+ *
+ * @param[in] src NUL-terminated source text.
+ * @param[out] out Destination list to populate.
+ * @param[out] out_relevant Optional. Receives (caller frees) only the lines
+ * that contributed to a definition; rescanning it yields the same list.
+ * @return 0 on success, error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t c_inspector_scan_string_types(
+    const char *src, struct TypeDefList *out, char **out_relevant);
+
 /* --- Function Signatures API --- */
 
 /**
@@ -1740,17 +1740,13 @@ write_form_urlencoded_body(FILE *fp, const struct OpenAPI_Operation *op,
         (enc && enc->allow_reserved_set) ? enc->allow_reserved : 0;
 
     if (strcmp(f->type, "array") == 0) {
-      const char *items_type = f->ref[0] != '\0' ? f->ref : "string";
+      const char *items_type = f->ref ? f->ref : "string";
       char len_field[80];
       const char *encode_fn = NULL;
       int add_encoded = 0;
       int items_is_object = (is_object_ref_type(items_type) != 0);
 
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-      sprintf_s(len_field, sizeof(len_field), "n_%s", f->name);
-#else
-      sprintf(len_field, "n_%s", f->name);
-#endif
+      CDD_SNPRINTF(len_field, sizeof(len_field), "n_%s", f->name);
 
       if (allow_reserved) {
 
@@ -1939,7 +1935,7 @@ write_form_urlencoded_body(FILE *fp, const struct OpenAPI_Operation *op,
       CHECK_IO(fprintf(fp, "  if (rc != 0) goto cleanup;\n"));
 
     } else if (strcmp(f->type, "object") == 0) {
-      if (f->ref[0] != '\0') {
+      if (f->ref) {
         const struct StructFields *obj_sf =
             (openapi_spec_find_schema(spec, f->ref,
                                       &_ast_openapi_spec_find_schema_6),
@@ -3437,7 +3433,7 @@ static cdd_c_error_t write_multipart_body(FILE *fp,
                         _ast_find_encoding_9)
                      : NULL;
     if (strcmp(f->type, "array") == 0) {
-      const char *items_type = f->ref[0] != '\0' ? f->ref : "string";
+      const char *items_type = f->ref ? f->ref : "string";
       int items_is_object = (is_object_ref_type(items_type) != 0);
       const char *content_type =
           (enc && enc->content_type) ? enc->content_type : NULL;
@@ -3457,11 +3453,7 @@ static cdd_c_error_t write_multipart_body(FILE *fp,
         CDD_SNPRINTF(ct_buf, sizeof(ct_buf), "\"%s\"", final_ct);
         ct_arg = ct_buf;
       }
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
-      sprintf_s(len_field, sizeof(len_field), "n_%s", f->name);
-#else
-      sprintf(len_field, "n_%s", f->name);
-#endif
+      CDD_SNPRINTF(len_field, sizeof(len_field), "n_%s", f->name);
 
       CHECK_IO(fprintf(fp, "  if (req_body->%s) {\n", f->name));
       CHECK_IO(fprintf(fp, "    size_t i;\n"));
@@ -3706,7 +3698,7 @@ static cdd_c_error_t write_multipart_body(FILE *fp,
         CDD_SNPRINTF(ct_buf, sizeof(ct_buf), "\"%s\"", final_ct);
         ct_arg = ct_buf;
       }
-      if (f->ref[0] != '\0') {
+      if (f->ref) {
         CHECK_IO(fprintf(fp, "    if (req_body->%s) {\n", f->name));
         CHECK_IO(fprintf(fp, "      char *part_json = NULL;\n"));
         CHECK_IO(fprintf(fp,
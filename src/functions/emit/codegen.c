@@ -114,7 +114,7 @@ cdd_c_error_t write_union_declaration_h(FILE *hfile, const char *union_name,
     const struct StructField *field = &sf->fields[i];
     const char *n = field->name;
     const char *t = field->type;
-    const char *r = field->ref;
+    const char *r = field->ref ? field->ref : "";
 
     if (strcmp(t, "string") == 0) {
       CHECK_IO(fprintf(hfile, "    const char *%s;\n", n));
@@ -202,7 +202,7 @@ cdd_c_error_t write_struct_declaration_h(FILE *hfile, const char *struct_name,
     const struct StructField *field = &sf->fields[i];
     const char *n = field->name;
     const char *t = field->type;
-    const char *r = field->ref;
+    const char *r = field->ref ? field->ref : "";
 
     if (strcmp(t, "string") == 0) {
       CHECK_IO(fprintf(hfile, "  const char *%s;\n", n));
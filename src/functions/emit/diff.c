@@ -13,7 +13,7 @@
 #include <string.h>
 
 #include "functions/emit/diff.h"
-#include "c_cdd/format_specifiers.h"
+#include "functions/emit/line_diff.h"
 /* clang-format on */
 
 /** @brief DiffLine struct */
@@ -213,19 +213,45 @@ append_to_diff(char **diff_str, size_t *diff_len, size_t *diff_cap,
   return CDD_C_SUCCESS;
 }
 
-static size_t find_line_for_token(const struct Token *tok,
-                                  const struct DiffLine *old_lines,
-                                  size_t old_line_count) {
-  size_t i;
-  for (i = 0; i < old_line_count; i++) {
-    const char *line_start = old_lines[i].text;
-    const char *line_end = line_start + old_lines[i].len;
-    if ((const char *)tok->start >= line_start &&
-        (const char *)tok->start <= line_end) {
-      return i + 1; /* 1-based */
-    }
+/** @brief Routes line_diff output into an append_to_diff buffer. */
+struct DiffSink {
+  char **str;  /**< Buffer */
+  size_t *len; /**< Bytes used */
+  size_t *cap; /**< Bytes allocated */
+};
+
+/**
+ * @brief line_diff_write_fn appending to a DiffSink.
+ */
+static cdd_c_error_t diff_sink_write(void *user_data, const char *text,
+                                     size_t len) {
+  struct DiffSink *sink = (struct DiffSink *)user_data;
+  return append_to_diff(sink->str, sink->len, sink->cap, "%.*s", (int)len,
+                        text);
+}
+
+/**
+ * @brief Counts the lines in a NUL-terminated string.
+ */
+static size_t count_lines(const char *str) {
+  size_t count = 0;
+  const char *nl;
+  while ((nl = strchr(str, '\n')) != NULL) {
+    ++count;
+    str = nl + 1;
   }
-  return 1;
+  return *str ? count + 1 : count;
+}
+
+/**
+ * @brief Find the 1-based line on which a token starts.
+ */
+static size_t find_line_for_token(const struct TokenList *tokens, size_t idx,
+                                  size_t old_line_count) {
+  size_t line = 1;
+  size_t col;
+  (void)token_list_position(tokens, tokens->tokens[idx].start, &line, &col);
+  return line > old_line_count ? old_line_count : line;
 }
 
 /**
@@ -234,6 +260,17 @@ static size_t find_line_for_token(const struct Token *tok,
 cdd_c_error_t patch_list_to_diff(struct PatchList *list,
                                  const struct TokenList *tokens,
                                  const char *filename, char **out_diff) {
+  return patch_list_to_diff_context(list, tokens, filename,
+                                    LINE_DIFF_DEFAULT_CONTEXT, out_diff);
+}
+
+/**
+ * @brief Diffs each patched region with the given amount of context.
+ */
+cdd_c_error_t patch_list_to_diff_context(struct PatchList *list,
+                                         const struct TokenList *tokens,
+                                         const char *filename, size_t context,
+                                         char **out_diff) {
   struct DiffLine *old_lines = NULL;
   size_t old_line_count = 0;
   const char *orig_src;
@@ -246,6 +283,8 @@ cdd_c_error_t patch_list_to_diff(struct PatchList *list,
   size_t diff_cap = 0;
   size_t p;
   size_t current_line_delta = 0;
+  struct DiffSink sink;
+  cdd_c_error_t rc = CDD_C_SUCCESS;
 
   if (!list || !tokens || !out_diff)
     return CDD_C_ERROR_INVALID_ARGUMENT;
@@ -275,20 +314,21 @@ cdd_c_error_t patch_list_to_diff(struct PatchList *list,
   /* Build blocks */
   for (p = 0; p < list->size; p++) {
     struct Patch *patch = &list->patches[p];
-    size_t p_start = find_line_for_token(
-        &tokens->tokens[patch->start_token_idx], old_lines, old_line_count);
+    size_t p_start =
+        find_line_for_token(tokens, patch->start_token_idx, old_line_count);
     size_t p_end;
     size_t ctx_start, ctx_end;
 
     if (patch->end_token_idx > patch->start_token_idx) {
-      p_end = find_line_for_token(&tokens->tokens[patch->end_token_idx - 1],
-                                  old_lines, old_line_count);
+      p_end = find_line_for_token(tokens, patch->end_token_idx - 1,
+                                  old_line_count);
     } else {
       p_end = p_start;
     }
 
-    ctx_start = (p_start > 3) ? p_start - 3 : 1;
-    ctx_end = (p_end + 3 <= old_line_count) ? p_end + 3 : old_line_count;
+    ctx_start = (p_start > context) ? p_start - context : 1;
+    ctx_end = (p_end + context <= old_line_count) ? p_end + context
+                                                  : old_line_count;
 
     if (block_count > 0 && ctx_start <= blocks[block_count - 1].old_end_line) {
       if (ctx_end > blocks[block_count - 1].old_end_line)
@@ -310,95 +350,34 @@ cdd_c_error_t patch_list_to_diff(struct PatchList *list,
 
   (void)append_to_diff(&diff_str, &diff_len, &diff_cap, "--- %s\n+++ %s\n",
                        filename, filename);
+  sink.str = &diff_str;
+  sink.len = &diff_len;
+  sink.cap = &diff_cap;
+
+  /* Only the lines around each group of patches are compared */
+  for (p = 0; p < block_count && rc == CDD_C_SUCCESS; p++) {
+    const struct Block *b = &blocks[p];
+    const char *old_start = old_lines[b->old_start_line - 1].text;
+    const size_t old_count = b->old_end_line - b->old_start_line + 1;
+    const size_t old_len =
+        (size_t)(old_lines[b->old_end_line - 1].text +
+                 old_lines[b->old_end_line - 1].len - old_start);
+    struct LineDiffOptions opts;
+    char *new_text = NULL;
 
-  for (p = 0; p < block_count; p++) {
-    struct Block *b = &blocks[p];
-    char *new_text;
-    struct DiffLine *new_lines = NULL;
-    size_t new_line_count = 0;
-    size_t i;
-    size_t min_mod_line, max_mod_line, keep_start_count, keep_end_count;
-
-    cdd_c_error_t rc;
-    new_text = NULL;
     rc = generate_block_new_text(b, list, tokens, old_lines, &new_text);
-
     if (rc != CDD_C_SUCCESS || !new_text)
       break;
-    (void)split_lines(new_text, strlen(new_text), &new_lines, &new_line_count);
-
-    (void)append_to_diff(&diff_str, &diff_len, &diff_cap,
-                         "@@ -%" CDD_PRIz ",%" CDD_PRIz " +%" CDD_PRIz
-                         ",%" CDD_PRIz " @@\n",
-                         (size_t)b->old_start_line,
-                         (size_t)(b->old_end_line - b->old_start_line + 1),
-                         (size_t)(b->old_start_line + current_line_delta),
-                         (size_t)new_line_count);
-
-    min_mod_line = find_line_for_token(
-        &tokens->tokens[list->patches[b->patch_start_idx].start_token_idx],
-        old_lines, old_line_count);
-    if (list->patches[b->patch_end_idx - 1].end_token_idx > 0) {
-      max_mod_line = find_line_for_token(
-          &tokens
-               ->tokens[list->patches[b->patch_end_idx - 1].end_token_idx - 1],
-          old_lines, old_line_count);
-    } else {
-      max_mod_line =
-          find_line_for_token(&tokens->tokens[0], old_lines, old_line_count);
-    }
-    if (max_mod_line < min_mod_line)
-      max_mod_line = min_mod_line;
-
-    keep_start_count = (min_mod_line > b->old_start_line)
-                           ? min_mod_line - b->old_start_line
-                           : 0;
-    keep_end_count =
-        (b->old_end_line > max_mod_line) ? b->old_end_line - max_mod_line : 0;
-
-    for (i = b->old_start_line; i < min_mod_line && i <= b->old_end_line; i++) {
-      (void)append_to_diff(&diff_str, &diff_len, &diff_cap, " %.*s",
-                           (int)old_lines[i - 1].len, old_lines[i - 1].text);
-      if (old_lines[i - 1].text[old_lines[i - 1].len - 1] != '\n') {
-        (void)append_to_diff(&diff_str, &diff_len, &diff_cap,
-                             "\n\\ No newline at end of file\n");
-      }
-    }
-
-    for (i = min_mod_line; i <= max_mod_line && i <= b->old_end_line; i++) {
-      (void)append_to_diff(&diff_str, &diff_len, &diff_cap, "-%.*s",
-                           (int)old_lines[i - 1].len, old_lines[i - 1].text);
-      if (old_lines[i - 1].text[old_lines[i - 1].len - 1] != '\n') {
-        (void)append_to_diff(&diff_str, &diff_len, &diff_cap,
-                             "\n\\ No newline at end of file\n");
-      }
-    }
 
-    for (i = keep_start_count; i < new_line_count - keep_end_count; i++) {
-      (void)append_to_diff(&diff_str, &diff_len, &diff_cap, "+%.*s",
-                           (int)new_lines[i].len, new_lines[i].text);
-      if (new_lines[i].text[new_lines[i].len - 1] != '\n') {
-        (void)append_to_diff(&diff_str, &diff_len, &diff_cap,
-                             "\n\\ No newline at end of file\n");
-      }
-    }
+    line_diff_options_init(&opts);
+    opts.context = context;
+    opts.old_line = b->old_start_line;
+    opts.new_line = b->old_start_line + current_line_delta;
+    rc = line_diff_unified(old_start, old_len, new_text, strlen(new_text),
+                           &opts, diff_sink_write, &sink, NULL);
 
-    for (i = b->old_end_line - keep_end_count + 1; i <= b->old_end_line; i++) {
-      (void)append_to_diff(&diff_str, &diff_len, &diff_cap, " %.*s",
-                           (int)old_lines[i - 1].len, old_lines[i - 1].text);
-      if (old_lines[i - 1].text[old_lines[i - 1].len - 1] != '\n') {
-        (void)append_to_diff(&diff_str, &diff_len, &diff_cap,
-                             "\n\\ No newline at end of file\n");
-      }
-    }
-
-    current_line_delta +=
-        new_line_count - (b->old_end_line - b->old_start_line + 1);
-
-    if (new_text)
-      free(new_text);
-    if (new_lines)
-      free(new_lines);
+    current_line_delta += count_lines(new_text) - old_count;
+    free(new_text);
   }
 
   if (old_lines)
@@ -406,6 +385,10 @@ cdd_c_error_t patch_list_to_diff(struct PatchList *list,
   if (blocks)
     free(blocks);
 
+  if (rc != CDD_C_SUCCESS) {
+    free(diff_str);
+    return rc;
+  }
   *out_diff = diff_str;
   return CDD_C_SUCCESS;
 }
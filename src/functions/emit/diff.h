@@ -1,6 +1,6 @@
 /**
  * @file diff.h
- * @brief Simple Unified Diff generator for PatchLists.
+ * @brief Unified Diff generator for PatchLists.
  *
  * @author Samuel Marks
  */
@@ -35,6 +35,26 @@ extern C_CDD_EXPORT cdd_c_error_t
 patch_list_to_diff(struct PatchList *list, const struct TokenList *tokens,
                    const char *filename, char **out_diff);
 
+/**
+ * @brief Generate a Unified Diff with a chosen number of context lines.
+ *
+ * Only the lines around each group of patches are rebuilt and compared, with
+ * a Myers line diff (see line_diff.h), so the cost follows the size of the
+ * patched regions rather than the size of the file. Hunks report lines of
+ * the whole file.
+ *
+ * @param[in] list The patch list (will be sorted internally).
+ * @param[in] tokens The original token stream.
+ * @param[in] filename The name of the file to put in the diff header.
+ * @param[in] context Unchanged lines shown around each change.
+ * @param[out] out_diff Pointer to a char* where the diff string will be stored.
+ * @return 0 on success, error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+patch_list_to_diff_context(struct PatchList *list,
+                           const struct TokenList *tokens, const char *filename,
+                           size_t context, char **out_diff);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -11,20 +11,30 @@
 #include <string.h>
 
 #include "functions/emit/diff_generator.h"
+#include "c_cdd/format_specifiers.h"
 #include "c_cdd/log.h"
 /* clang-format on */
 
+/** @brief Room kept free for one hunk header line. */
+#define DIFF_HUNK_HEADER_MAX 96
+
 cdd_c_error_t patch_list_generate_diff(const struct TokenList *tokens,
                                        const struct PatchList *list,
                                        const char *filename, char **out_diff) {
   char *diff_buf = NULL;
   size_t diff_cap = 4096;
   size_t diff_len = 0;
+  size_t header_len;
   size_t i;
 
   if (!tokens || !list || !filename || !out_diff)
     return CDD_C_ERROR_INVALID_ARGUMENT;
 
+  /* "--- a/%s\n+++ b/%s\n" and the first hunk header must fit up front */
+  header_len = 2 * strlen(filename) + sizeof("--- a/\n+++ b/\n");
+  if (header_len + DIFF_HUNK_HEADER_MAX > diff_cap)
+    diff_cap = header_len + DIFF_HUNK_HEADER_MAX;
+
 #ifdef CDD_BUILD_TESTS
   {
     extern C_CDD_EXPORT int g_cdd_fail_alloc;
@@ -59,14 +69,22 @@ cdd_c_error_t patch_list_generate_diff(const struct TokenList *tokens,
 #endif
   for (i = 0; i < list->size; ++i) {
     const struct Patch *p = &list->patches[i];
-    /* Find line numbers to give context */
-    /* This is a simplification; we'll output a chunk */
+    size_t line = 1;
+    size_t col = 1;
+    /* Line and column of the first replaced token, from the line index */
+    if (p->start_token_idx < tokens->size)
+      (void)token_list_position(tokens,
+                                tokens->tokens[p->start_token_idx].start,
+                                &line, &col);
 #if defined(_MSC_VER) && !defined(__INTEL_COMPILER) ||                         \
     defined(__STDC_LIB_EXT1__) && __STDC_WANT_LIB_EXT1__
     diff_len += sprintf_s(diff_buf + diff_len, diff_cap - diff_len,
-                          "@@ -patch %d @@\n", (int)i);
+                          "@@ -patch %d @@ %" CDD_PRIz ":%" CDD_PRIz "\n",
+                          (int)i, line, col);
 #else
-    diff_len += sprintf(diff_buf + diff_len, "@@ -patch %d @@\n", (int)i);
+    diff_len += sprintf(diff_buf + diff_len,
+                        "@@ -patch %d @@ %" CDD_PRIz ":%" CDD_PRIz "\n",
+                        (int)i, line, col);
 #endif
 
     /* Emit old tokens (we prefix with '-') */
@@ -75,7 +93,8 @@ cdd_c_error_t patch_list_generate_diff(const struct TokenList *tokens,
     {
       size_t j;
       for (j = p->start_token_idx; j < p->end_token_idx; ++j) {
-        if (diff_len + tokens->tokens[j].length + 10 > diff_cap) {
+        if (diff_len + tokens->tokens[j].length + DIFF_HUNK_HEADER_MAX >
+            diff_cap) {
           diff_cap *= 2;
           {
 #ifdef CDD_BUILD_TESTS
@@ -105,7 +124,7 @@ cdd_c_error_t patch_list_generate_diff(const struct TokenList *tokens,
     diff_buf[diff_len] = '\0';
 
     /* Emit new tokens (we prefix with '+') */
-    if (diff_len + strlen(p->text) + 10 > diff_cap) {
+    if (diff_len + strlen(p->text) + DIFF_HUNK_HEADER_MAX > diff_cap) {
       diff_cap = diff_cap * 2 + strlen(p->text);
       {
 #ifdef CDD_BUILD_TESTS
@@ -0,0 +1,473 @@
+/**
+ * @file line_diff.c
+ * @brief Implementation of the line-based Myers diff.
+ *
+ * @author Samuel Marks
+ */
+
+/* clang-format off */
+#include <stdio.h>
+#include <string.h>
+
+#include "functions/emit/line_diff.h"
+#include "c_cdd/format_specifiers.h"
+#include "c_cdd/log.h"
+#include "c_cdd/memory.h"
+/* clang-format on */
+
+/** @brief One line of either side, hashed once. */
+struct LineDiffLine {
+  const char *text;   /**< Start of the line */
+  size_t len;         /**< Length including its newline, if any */
+  unsigned long hash; /**< FNV-1a of the line */
+};
+
+/** @brief A pair of line ranges still to be compared. */
+struct LineDiffRange {
+  size_t a0; /**< First old line */
+  size_t a1; /**< One past the last old line */
+  size_t b0; /**< First new line */
+  size_t b1; /**< One past the last new line */
+};
+
+/** @brief State shared by the comparison and output passes. */
+struct LineDiffCtx {
+  struct LineDiffLine *a;      /**< Old lines */
+  size_t na;                   /**< Number of old lines */
+  struct LineDiffLine *b;      /**< New lines */
+  size_t nb;                   /**< Number of new lines */
+  unsigned char *a_changed;    /**< Old line is deleted */
+  unsigned char *b_changed;    /**< New line is inserted */
+  long *v1;                    /**< Forward furthest-reaching x per diagonal */
+  long *v2;                    /**< Reverse furthest-reaching x */
+  struct LineDiffRange *stack; /**< Ranges awaiting comparison */
+  size_t stack_size;           /**< Ranges on the stack */
+  size_t stack_cap;            /**< Allocated ranges */
+  line_diff_write_fn write;    /**< Output callback */
+  void *user_data;             /**< Passed to `write` */
+};
+
+/* --- Lines --- */
+
+/**
+ * @brief Splits text into hashed lines.
+ */
+static cdd_c_error_t line_diff_split(const char *text, size_t len,
+                                     struct LineDiffLine **out,
+                                     size_t *out_n) {
+  const char *p = text;
+  const char *end;
+  size_t n = 0;
+
+  *out = NULL;
+  *out_n = 0;
+  if (!text || len == 0)
+    return CDD_C_SUCCESS;
+  end = text + len;
+
+  while (p < end) {
+    const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+    ++n;
+    if (!nl)
+      break;
+    p = nl + 1;
+  }
+
+  *out = (struct LineDiffLine *)C_CDD_MALLOC(n * sizeof(struct LineDiffLine));
+  if (!*out) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+
+  for (p = text; p < end; ++*out_n) {
+    const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+    const char *stop = nl ? nl + 1 : end;
+    struct LineDiffLine *line = &(*out)[*out_n];
+    unsigned long h = 2166136261UL;
+    const char *q;
+    for (q = p; q < stop; ++q) {
+      h ^= (unsigned char)*q;
+      h = (h * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    line->text = p;
+    line->len = (size_t)(stop - p);
+    line->hash = h;
+    p = stop;
+  }
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Compares two lines, hash first.
+ */
+static int line_diff_equal(const struct LineDiffLine *x,
+                           const struct LineDiffLine *y) {
+  return x->hash == y->hash && x->len == y->len &&
+         memcmp(x->text, y->text, x->len) == 0;
+}
+
+/* --- Comparison --- */
+
+/**
+ * @brief Pushes a pair of ranges onto the work stack.
+ */
+static cdd_c_error_t line_diff_push(struct LineDiffCtx *c, size_t a0,
+                                    size_t a1, size_t b0, size_t b1) {
+  struct LineDiffRange *r;
+  if (c->stack_size == c->stack_cap) {
+    size_t cap = c->stack_cap ? c->stack_cap * 2 : 16;
+    struct LineDiffRange *grown = (struct LineDiffRange *)C_CDD_REALLOC(
+        c->stack, cap * sizeof(struct LineDiffRange));
+    if (!grown) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      return CDD_C_ERROR_MEMORY;
+    }
+    c->stack = grown;
+    c->stack_cap = cap;
+  }
+  r = &c->stack[c->stack_size++];
+  r->a0 = a0;
+  r->a1 = a1;
+  r->b0 = b0;
+  r->b1 = b1;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Finds the middle snake of an edit path between two ranges.
+ *
+ * Both ranges are non-empty and differ in their first and last lines.
+ * Searches forward from the start and backward from the end until the two
+ * frontiers overlap, keeping only the furthest x reached on each diagonal.
+ *
+ * @return 1 with the split point in `out_x`/`out_y` (relative to the
+ * ranges), 0 if the ranges share no line.
+ */
+static int line_diff_bisect(const struct LineDiffCtx *c,
+                            const struct LineDiffRange *r, size_t *out_x,
+                            size_t *out_y) {
+  const struct LineDiffLine *a = c->a + r->a0;
+  const struct LineDiffLine *b = c->b + r->b0;
+  const long n = (long)(r->a1 - r->a0);
+  const long m = (long)(r->b1 - r->b0);
+  const long max_d = (n + m + 1) / 2;
+  const long v_off = max_d;
+  const long v_len = 2 * max_d + 2;
+  const long delta = n - m;
+  const int front = (delta < 0 ? -delta : delta) % 2 != 0;
+  long k1start = 0, k1end = 0, k2start = 0, k2end = 0;
+  long d, k, i;
+
+  for (i = 0; i < v_len; ++i) {
+    c->v1[i] = -1;
+    c->v2[i] = -1;
+  }
+  c->v1[v_off + 1] = 0;
+  c->v2[v_off + 1] = 0;
+
+  for (d = 0; d < max_d; ++d) {
+    /* Forward path */
+    for (k = -d + k1start; k <= d - k1end; k += 2) {
+      const long k_off = v_off + k;
+      long x, y;
+      if (k == -d || (k != d && c->v1[k_off - 1] < c->v1[k_off + 1]))
+        x = c->v1[k_off + 1];
+      else
+        x = c->v1[k_off - 1] + 1;
+      y = x - k;
+      while (x < n && y >= 0 && y < m && line_diff_equal(&a[x], &b[y])) {
+        ++x;
+        ++y;
+      }
+      c->v1[k_off] = x;
+      if (x > n) {
+        k1end += 2;
+      } else if (y > m) {
+        k1start += 2;
+      } else if (front) {
+        const long k2_off = v_off + delta - k;
+        if (k2_off >= 0 && k2_off < v_len && c->v2[k2_off] != -1 &&
+            x >= n - c->v2[k2_off]) {
+          *out_x = (size_t)x;
+          *out_y = (size_t)y;
+          return 1;
+        }
+      }
+    }
+
+    /* Reverse path */
+    for (k = -d + k2start; k <= d - k2end; k += 2) {
+      const long k_off = v_off + k;
+      long x, y;
+      if (k == -d || (k != d && c->v2[k_off - 1] < c->v2[k_off + 1]))
+        x = c->v2[k_off + 1];
+      else
+        x = c->v2[k_off - 1] + 1;
+      y = x - k;
+      while (x < n && y >= 0 && y < m &&
+             line_diff_equal(&a[n - x - 1], &b[m - y - 1])) {
+        ++x;
+        ++y;
+      }
+      c->v2[k_off] = x;
+      if (x > n) {
+        k2end += 2;
+      } else if (y > m) {
+        k2start += 2;
+      } else if (!front) {
+        const long k1_off = v_off + delta - k;
+        if (k1_off >= 0 && k1_off < v_len && c->v1[k1_off] != -1) {
+          const long x1 = c->v1[k1_off];
+          const long y1 = v_off + x1 - k1_off;
+          if (x1 >= n - x) {
+            *out_x = (size_t)x1;
+            *out_y = (size_t)y1;
+            return 1;
+          }
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Marks every line that is not part of a longest common subsequence.
+ *
+ * Works through an explicit stack of range pairs. Each pair is trimmed of
+ * common leading and trailing lines and, if both sides remain, split at its
+ * middle snake.
+ */
+static cdd_c_error_t line_diff_compare(struct LineDiffCtx *c) {
+  cdd_c_error_t rc = line_diff_push(c, 0, c->na, 0, c->nb);
+
+  while (rc == CDD_C_SUCCESS && c->stack_size > 0) {
+    struct LineDiffRange r = c->stack[--c->stack_size];
+    size_t x, y;
+
+    while (r.a0 < r.a1 && r.b0 < r.b1 &&
+           line_diff_equal(&c->a[r.a0], &c->b[r.b0])) {
+      ++r.a0;
+      ++r.b0;
+    }
+    while (r.a0 < r.a1 && r.b0 < r.b1 &&
+           line_diff_equal(&c->a[r.a1 - 1], &c->b[r.b1 - 1])) {
+      --r.a1;
+      --r.b1;
+    }
+
+    if (r.a0 < r.a1 && r.b0 < r.b1 && line_diff_bisect(c, &r, &x, &y) &&
+        x <= r.a1 - r.a0 && y <= r.b1 - r.b0 && (x != 0 || y != 0) &&
+        (x != r.a1 - r.a0 || y != r.b1 - r.b0)) {
+      rc = line_diff_push(c, r.a0, r.a0 + x, r.b0, r.b0 + y);
+      if (rc == CDD_C_SUCCESS)
+        rc = line_diff_push(c, r.a0 + x, r.a1, r.b0 + y, r.b1);
+      continue;
+    }
+
+    /* One side is empty, or nothing is shared */
+    if (r.a1 > r.a0)
+      memset(c->a_changed + r.a0, 1, r.a1 - r.a0);
+    if (r.b1 > r.b0)
+      memset(c->b_changed + r.b0, 1, r.b1 - r.b0);
+  }
+  return rc;
+}
+
+/* --- Output --- */
+
+/**
+ * @brief Writes one line with its prefix and a missing-newline marker.
+ */
+static cdd_c_error_t line_diff_emit_line(const struct LineDiffCtx *c,
+                                         char prefix,
+                                         const struct LineDiffLine *line) {
+  static const char no_nl[] = "\n\\ No newline at end of file\n";
+  cdd_c_error_t rc = c->write(c->user_data, &prefix, 1);
+  if (rc == CDD_C_SUCCESS)
+    rc = c->write(c->user_data, line->text, line->len);
+  if (rc == CDD_C_SUCCESS && line->text[line->len - 1] != '\n')
+    rc = c->write(c->user_data, no_nl, sizeof(no_nl) - 1);
+  return rc;
+}
+
+/**
+ * @brief Finds the next run of changed lines at or after (`*i`, `*j`).
+ *
+ * @return 1 with the run in `g` and `*i`/`*j` moved past it, 0 at the end.
+ */
+static int line_diff_next_change(const struct LineDiffCtx *c, size_t *i,
+                                 size_t *j, struct LineDiffRange *g) {
+  while (*i < c->na && *j < c->nb && !c->a_changed[*i] && !c->b_changed[*j]) {
+    ++*i;
+    ++*j;
+  }
+  if (*i >= c->na && *j >= c->nb)
+    return 0;
+  g->a0 = *i;
+  g->b0 = *j;
+  while (*i < c->na && c->a_changed[*i])
+    ++*i;
+  while (*j < c->nb && c->b_changed[*j])
+    ++*j;
+  g->a1 = *i;
+  g->b1 = *j;
+  return g->a1 > g->a0 || g->b1 > g->b0;
+}
+
+/**
+ * @brief Writes one `@@` hunk covering the given ranges.
+ */
+static cdd_c_error_t line_diff_emit_hunk(const struct LineDiffCtx *c,
+                                         const struct LineDiffRange *h,
+                                         const struct LineDiffOptions *opts) {
+  char header[128];
+  size_t a_count = h->a1 - h->a0;
+  size_t b_count = h->b1 - h->b0;
+  size_t a_start = opts->old_line + h->a0 - (a_count == 0 ? 1 : 0);
+  size_t b_start = opts->new_line + h->b0 - (b_count == 0 ? 1 : 0);
+  size_t i = h->a0;
+  size_t j = h->b0;
+  cdd_c_error_t rc;
+
+#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
+  sprintf_s(header, sizeof(header),
+            "@@ -%" CDD_PRIz ",%" CDD_PRIz " +%" CDD_PRIz ",%" CDD_PRIz
+            " @@\n",
+            a_start, a_count, b_start, b_count);
+#else
+  sprintf(header,
+          "@@ -%" CDD_PRIz ",%" CDD_PRIz " +%" CDD_PRIz ",%" CDD_PRIz " @@\n",
+          a_start, a_count, b_start, b_count);
+#endif
+  rc = c->write(c->user_data, header, strlen(header));
+
+  while (rc == CDD_C_SUCCESS && (i < h->a1 || j < h->b1)) {
+    if (i < h->a1 && j < h->b1 && !c->a_changed[i] && !c->b_changed[j]) {
+      rc = line_diff_emit_line(c, ' ', &c->a[i]);
+      ++i;
+      ++j;
+      continue;
+    }
+    if (!(i < h->a1 && c->a_changed[i]) && !(j < h->b1 && c->b_changed[j]))
+      break; /* Unpaired unchanged line; cannot happen */
+    while (rc == CDD_C_SUCCESS && i < h->a1 && c->a_changed[i])
+      rc = line_diff_emit_line(c, '-', &c->a[i++]);
+    while (rc == CDD_C_SUCCESS && j < h->b1 && c->b_changed[j])
+      rc = line_diff_emit_line(c, '+', &c->b[j++]);
+  }
+  return rc;
+}
+
+/**
+ * @brief Groups changes that are close together into hunks and writes them.
+ */
+static cdd_c_error_t line_diff_emit(const struct LineDiffCtx *c,
+                                    const struct LineDiffOptions *opts,
+                                    size_t *out_hunks) {
+  struct LineDiffRange g;
+  size_t i = 0, j = 0;
+  int have = line_diff_next_change(c, &i, &j, &g);
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+
+  while (have && rc == CDD_C_SUCCESS) {
+    struct LineDiffRange h;
+    struct LineDiffRange last = g;
+    size_t lead = g.a0 < opts->context ? g.a0 : opts->context;
+    size_t trail;
+
+    h.a0 = g.a0 - lead;
+    h.b0 = g.b0 - lead;
+    for (;;) {
+      i = last.a1;
+      j = last.b1;
+      have = line_diff_next_change(c, &i, &j, &g);
+      if (!have || g.a0 - last.a1 > 2 * opts->context)
+        break;
+      last = g;
+    }
+    trail = c->na - last.a1;
+    if (trail > opts->context)
+      trail = opts->context;
+    h.a1 = last.a1 + trail;
+    h.b1 = last.b1 + trail;
+
+    rc = line_diff_emit_hunk(c, &h, opts);
+    if (out_hunks)
+      ++*out_hunks;
+  }
+  return rc;
+}
+
+/* --- Public API --- */
+
+void line_diff_options_init(struct LineDiffOptions *opts) {
+  if (!opts)
+    return;
+  opts->context = LINE_DIFF_DEFAULT_CONTEXT;
+  opts->old_line = 1;
+  opts->new_line = 1;
+}
+
+cdd_c_error_t line_diff_unified(const char *old_text, size_t old_len,
+                                const char *new_text, size_t new_len,
+                                const struct LineDiffOptions *opts,
+                                line_diff_write_fn write, void *user_data,
+                                size_t *out_hunks) {
+  struct LineDiffOptions defaults;
+  struct LineDiffCtx c;
+  size_t v_len;
+  cdd_c_error_t rc;
+
+  if (out_hunks)
+    *out_hunks = 0;
+  if ((!old_text && old_len) || (!new_text && new_len) || !write)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (!opts) {
+    line_diff_options_init(&defaults);
+    opts = &defaults;
+  }
+
+  memset(&c, 0, sizeof(c));
+  c.write = write;
+  c.user_data = user_data;
+
+  rc = line_diff_split(old_text, old_len, &c.a, &c.na);
+  if (rc == CDD_C_SUCCESS)
+    rc = line_diff_split(new_text, new_len, &c.b, &c.nb);
+  if (rc != CDD_C_SUCCESS)
+    goto cleanup;
+
+  v_len = 2 * ((c.na + c.nb + 1) / 2) + 2;
+  c.a_changed = (unsigned char *)C_CDD_CALLOC(c.na + 1, 1);
+  c.b_changed = (unsigned char *)C_CDD_CALLOC(c.nb + 1, 1);
+  c.v1 = (long *)C_CDD_MALLOC(v_len * sizeof(long));
+  c.v2 = (long *)C_CDD_MALLOC(v_len * sizeof(long));
+  if (!c.a_changed || !c.b_changed || !c.v1 || !c.v2) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    rc = CDD_C_ERROR_MEMORY;
+    goto cleanup;
+  }
+
+  rc = line_diff_compare(&c);
+  if (rc == CDD_C_SUCCESS)
+    rc = line_diff_emit(&c, opts, out_hunks);
+
+cleanup:
+  C_CDD_FREE(c.a);
+  C_CDD_FREE(c.b);
+  C_CDD_FREE(c.a_changed);
+  C_CDD_FREE(c.b_changed);
+  C_CDD_FREE(c.v1);
+  C_CDD_FREE(c.v2);
+  C_CDD_FREE(c.stack);
+  return rc;
+}
+
+cdd_c_error_t line_diff_write_file(void *user_data, const char *text,
+                                   size_t len) {
+  FILE *fp = (FILE *)user_data;
+  if (!fp)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  return fwrite(text, 1, len, fp) == len ? CDD_C_SUCCESS : CDD_C_ERROR_IO;
+}
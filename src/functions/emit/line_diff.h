@@ -0,0 +1,102 @@
+/**
+ * @file line_diff.h
+ * @brief Line-based Myers diff with unified output.
+ *
+ * Lines are hashed once and compared by hash, length and then bytes. Common
+ * leading and trailing lines are trimmed before the search, so unchanged
+ * regions cost a single comparison per line. The remaining middle is
+ * compared with the linear-space variant of Myers' O(ND) algorithm, which
+ * needs only two diagonal vectors and one flag per line.
+ *
+ * Output is written through a callback as it is produced, so neither side
+ * needs to be copied and no diff string is assembled unless the caller
+ * wants one.
+ *
+ * @author Samuel Marks
+ */
+
+#ifndef C_CDD_LINE_DIFF_H
+#define C_CDD_LINE_DIFF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include <stddef.h>
+
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+/* clang-format on */
+
+/** @brief Context lines used when none are configured. */
+#define LINE_DIFF_DEFAULT_CONTEXT 3
+
+/**
+ * @brief Receives a chunk of diff output.
+ *
+ * @param[in] user_data Caller state.
+ * @param[in] text Bytes to write; not NUL-terminated.
+ * @param[in] len Number of bytes.
+ * @return 0 on success; any other value stops the diff and is returned.
+ */
+typedef cdd_c_error_t (*line_diff_write_fn)(void *user_data, const char *text,
+                                            size_t len);
+
+/**
+ * @brief Options for line_diff_unified.
+ */
+struct LineDiffOptions {
+  size_t context;  /**< Unchanged lines shown around each change */
+  size_t old_line; /**< 1-based line number of the first old line */
+  size_t new_line; /**< 1-based line number of the first new line */
+};
+
+/**
+ * @brief Set default options: three lines of context, both sides at line 1.
+ *
+ * @param[out] opts Options to initialize.
+ */
+extern C_CDD_EXPORT void line_diff_options_init(struct LineDiffOptions *opts);
+
+/**
+ * @brief Write the hunks of a unified diff between two texts.
+ *
+ * Only `@@` hunks are written; the `---`/`+++` header is left to the caller
+ * so that several regions of one file can share it. Setting `old_line` and
+ * `new_line` lets a caller diff an excerpt and still report file lines.
+ *
+ * @param[in] old_text Original text (need not be NUL-terminated).
+ * @param[in] old_len Length of `old_text`.
+ * @param[in] new_text Changed text (need not be NUL-terminated).
+ * @param[in] new_len Length of `new_text`.
+ * @param[in] opts Options, or NULL for the defaults.
+ * @param[in] write Output callback.
+ * @param[in] user_data Passed to `write`.
+ * @param[out] out_hunks Optional; receives the number of hunks written.
+ * @return 0 on success, CDD_C_ERROR_MEMORY on allocation failure, or the
+ * first non-zero value returned by `write`.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+line_diff_unified(const char *old_text, size_t old_len, const char *new_text,
+                  size_t new_len, const struct LineDiffOptions *opts,
+                  line_diff_write_fn write, void *user_data,
+                  size_t *out_hunks);
+
+/**
+ * @brief line_diff_write_fn that writes to a `FILE*` passed as user data.
+ *
+ * @param[in] user_data The `FILE*` sink.
+ * @param[in] text Bytes to write.
+ * @param[in] len Number of bytes.
+ * @return 0 on success, CDD_C_ERROR_IO on a short write.
+ */
+extern C_CDD_EXPORT cdd_c_error_t line_diff_write_file(void *user_data,
+                                                       const char *text,
+                                                       size_t len);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* C_CDD_LINE_DIFF_H */
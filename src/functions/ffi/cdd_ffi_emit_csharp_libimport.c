@@ -0,0 +1,657 @@
+extern volatile int g_fail_io_after;
+/* clang-format off */
+#include "cdd_ffi_emit_csharp_libimport.h"
+#include "cdd_ffi_layout.h"
+#include "../parse/fs.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "c_cdd/memory.h"
+#include "c_cdd/safe_crt.h"
+/* clang-format on */
+
+/** @brief Emission state shared by the passes over one IR. */
+typedef struct cs_ctx_t {
+  const cdd_ffi_ir_t *ir;         /**< The IR being emitted */
+  unsigned char *ok;              /**< Per node: record is blittable */
+  cdd_ffi_layout_cache_t *layout; /**< C layouts of the IR's records */
+} cs_ctx_t;
+
+static const char *const cs_keywords[] = {
+    "abstract", "as", "base", "bool", "break", "byte", "case", "catch", "char",
+    "checked", "class", "const", "continue", "decimal", "default", "delegate",
+    "do", "double", "else", "enum", "event", "explicit", "extern", "false",
+    "finally", "fixed", "float", "for", "foreach", "goto", "if", "implicit",
+    "in", "int", "interface", "internal", "is", "lock", "long", "namespace",
+    "new", "null", "object", "operator", "out", "override", "params", "private",
+    "protected", "public", "readonly", "ref", "return", "sbyte", "sealed",
+    "short", "sizeof", "stackalloc", "static", "string", "struct", "switch",
+    "this", "throw", "true", "try", "typeof", "uint", "ulong", "unchecked",
+    "unsafe", "ushort", "using", "virtual", "void", "volatile", "while"};
+
+static const char *record_ident(const char *name) {
+  if (strncmp(name, "struct ", 7) == 0)
+    return name + 7;
+  if (strncmp(name, "union ", 6) == 0)
+    return name + 6;
+  if (strncmp(name, "enum ", 5) == 0)
+    return name + 5;
+  return name;
+}
+
+/**
+ * @brief Records with a plain C layout. C++ classes and template instances
+ * need runtime marshalling or have no C spelling.
+ */
+static int is_exportable_record(const cdd_ffi_ir_node_t *node) {
+  return (node->kind == CDD_FFI_NODE_STRUCT ||
+          node->kind == CDD_FFI_NODE_UNION) &&
+         node->name && node->fields_count > 0 &&
+         node->base_classes_count == 0 && node->virtual_methods_count == 0 &&
+         !strchr(node->name, '<') && !strchr(node->name, ':');
+}
+
+static const cdd_ffi_ir_node_t *find_node(const cdd_ffi_ir_t *ir,
+                                          cdd_ffi_node_kind_t kind,
+                                          const char *name) {
+  size_t i;
+  if (!name)
+    return NULL;
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    if (node->kind == kind && node->name &&
+        strcmp(record_ident(node->name), record_ident(name)) == 0)
+      return node;
+  }
+  return NULL;
+}
+
+/** @brief The emitted struct or union named `name`, if any. */
+static const cdd_ffi_ir_node_t *find_record(const cs_ctx_t *ctx,
+                                            const char *name) {
+  size_t i;
+  if (!name)
+    return NULL;
+  for (i = 0; i < ctx->ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ctx->ir->nodes[i];
+    if (is_exportable_record(node) &&
+        strcmp(record_ident(node->name), record_ident(name)) == 0)
+      return ctx->ok[i] ? node : NULL;
+  }
+  return NULL;
+}
+
+/** @brief Write `name` as a C# identifier; keywords get the `@` prefix. */
+static void cs_ident(char *out, size_t out_size, const char *name) {
+  char tmp[256];
+  size_t i = 0, k;
+  for (; name[i] && i + 1 < sizeof(tmp); i++) {
+    char c = name[i];
+    tmp[i] = (isalnum((unsigned char)c) || c == '_') ? c : '_';
+  }
+  tmp[i] = '\0';
+  for (k = 0; k < sizeof(cs_keywords) / sizeof(cs_keywords[0]); k++) {
+    if (strcmp(tmp, cs_keywords[k]) == 0) {
+      CDD_SNPRINTF(out, out_size, "@%s", tmp);
+      return;
+    }
+  }
+  CDD_SNPRINTF(out, out_size, "%s", tmp);
+}
+
+/** @brief Blittable spelling of a C scalar; C bool is one byte. */
+static const char *cs_scalar(cdd_ffi_primitive_kind_t kind) {
+  switch (kind) {
+  case CDD_FFI_KIND_BOOL:
+  case CDD_FFI_KIND_UINT8:
+    return "byte";
+  case CDD_FFI_KIND_INT8:
+    return "sbyte";
+  case CDD_FFI_KIND_INT16:
+    return "short";
+  case CDD_FFI_KIND_UINT16:
+    return "ushort";
+  case CDD_FFI_KIND_INT32:
+    return "int";
+  case CDD_FFI_KIND_UINT32:
+    return "uint";
+  case CDD_FFI_KIND_INT64:
+    return "long";
+  case CDD_FFI_KIND_UINT64:
+    return "ulong";
+  case CDD_FFI_KIND_FLOAT32:
+    return "float";
+  case CDD_FFI_KIND_FLOAT64:
+    return "double";
+  default:
+    return NULL;
+  }
+}
+
+/**
+ * @brief Spell a type as a blittable C# type, resolving typedefs.
+ * @param ctx The emission state.
+ * @param type The type; fixed-size arrays are left to the caller.
+ * @param extra_depth Pointer levels added by the context.
+ * @param[out] out Buffer for the spelling.
+ * @param out_size Size of `out`.
+ * @return 1 when the type is representable, else 0.
+ */
+static int cs_type(const cs_ctx_t *ctx, const cdd_ffi_type_t *type,
+                   int extra_depth, char *out, size_t out_size) {
+  int depth = type->pointer_depth + extra_depth;
+  const char *base;
+  char name[256];
+  size_t len;
+
+  switch (type->kind) {
+  case CDD_FFI_KIND_VOID:
+    base = "void";
+    break;
+  case CDD_FFI_KIND_OPAQUE_PTR:
+  case CDD_FFI_KIND_FUNCTION_PTR:
+    /* Already a pointer; the signature of a callback is not in the IR */
+    base = "nint";
+    if (depth > 0)
+      depth--;
+    break;
+  case CDD_FFI_KIND_TYPEDEF_REF: {
+    const cdd_ffi_ir_node_t *td =
+        find_node(ctx->ir, CDD_FFI_NODE_TYPEDEF, type->ref_name);
+    if (td)
+      return td->return_or_base_type.kind != CDD_FFI_KIND_TYPEDEF_REF &&
+             cs_type(ctx, &td->return_or_base_type, depth, out, out_size);
+  }
+  /* FALLTHROUGH */
+  case CDD_FFI_KIND_STRUCT_REF:
+  case CDD_FFI_KIND_ENUM_REF:
+    if (find_node(ctx->ir, CDD_FFI_NODE_ENUM, type->ref_name) ||
+        find_record(ctx, type->ref_name)) {
+      cs_ident(name, sizeof(name), record_ident(type->ref_name));
+      base = name;
+    } else if (type->kind == CDD_FFI_KIND_ENUM_REF) {
+      base = "int";
+    } else if (depth > 0) {
+      base = "void"; /* Opaque handle */
+    } else {
+      return 0;
+    }
+    break;
+  default:
+    base = cs_scalar(type->kind);
+    if (!base) {
+      if (depth == 0)
+        return 0;
+      base = "void"; /* Pointer to a C++ library type */
+    }
+    break;
+  }
+  CDD_SNPRINTF(out, out_size, "%s", base);
+  len = strlen(out);
+  for (; depth > 0 && len + 1 < out_size; depth--)
+    out[len++] = '*';
+  out[len] = '\0';
+  return 1;
+}
+
+/**
+ * @brief Spell a member; fixed arrays are spelled by emit_record(). C# has
+ * no bit-fields, and a flexible array member is not part of the struct.
+ */
+static int cs_field_type(const cs_ctx_t *ctx, const cdd_ffi_field_t *field,
+                         char *out, size_t out_size) {
+  return field->name && field->bit_width <= 0 &&
+         field->type.array_size >= 0 &&
+         cs_type(ctx, &field->type, 0, out, out_size) &&
+         strcmp(out, "void") != 0;
+}
+
+/** @brief Element types C# allows in a `fixed` buffer. */
+static int is_fixed_buffer_type(const cdd_ffi_type_t *type) {
+  return type->pointer_depth == 0 && cs_scalar(type->kind) != NULL;
+}
+
+/**
+ * @brief The C layout of a record, when every ABI agrees on it; otherwise
+ * the struct is left to the runtime's sequential layout.
+ */
+static const cdd_ffi_record_layout_t *
+fixed_layout(const cs_ctx_t *ctx, const cdd_ffi_ir_node_t *node) {
+  const cdd_ffi_record_layout_t *rec;
+  int portable = 0;
+  if (cdd_ffi_layout_is_portable(ctx->layout, node, &portable) !=
+          CDD_C_SUCCESS ||
+      !portable ||
+      cdd_ffi_layout_record(ctx->layout, node, CDD_CST_ABI_LP64, &rec) !=
+          CDD_C_SUCCESS)
+    return NULL;
+  return rec;
+}
+
+/**
+ * @brief Decide which records get a blittable struct. Starts from every
+ * exportable record and drops those with a member that has no blittable
+ * spelling until nothing changes, so pointers between records resolve
+ * without recursion.
+ */
+static void mark_records(cs_ctx_t *ctx) {
+  size_t i, j;
+  int changed = 1;
+  char buf[256];
+
+  for (i = 0; i < ctx->ir->nodes_count; i++)
+    ctx->ok[i] = (unsigned char)is_exportable_record(&ctx->ir->nodes[i]);
+  while (changed) {
+    changed = 0;
+    for (i = 0; i < ctx->ir->nodes_count; i++) {
+      const cdd_ffi_ir_node_t *node = &ctx->ir->nodes[i];
+      if (!ctx->ok[i])
+        continue;
+      for (j = 0; j < node->fields_count; j++) {
+        if (!cs_field_type(ctx, &node->fields[j], buf, sizeof(buf))) {
+          ctx->ok[i] = 0;
+          changed = 1;
+          break;
+        }
+      }
+    }
+  }
+}
+
+/** @brief `f(void)` is spelled with a single unnamed void parameter. */
+static size_t param_count(const cdd_ffi_ir_node_t *fn) {
+  if (fn->fields_count == 1 && fn->fields[0].type.kind == CDD_FFI_KIND_VOID &&
+      fn->fields[0].type.pointer_depth == 0)
+    return 0;
+  return fn->fields_count;
+}
+
+static int function_supported(const cs_ctx_t *ctx,
+                              const cdd_ffi_ir_node_t *fn) {
+  char buf[256];
+  size_t j, n = param_count(fn);
+  if (fn->kind != CDD_FFI_NODE_FUNCTION || !fn->name || fn->is_variadic ||
+      strchr(fn->name, ':'))
+    return 0;
+  if (!cs_type(ctx, &fn->return_or_base_type, 0, buf, sizeof(buf)))
+    return 0;
+  for (j = 0; j < n; j++) {
+    const cdd_ffi_type_t *t = &fn->fields[j].type;
+    if (!cs_type(ctx, t, t->array_size > 0, buf, sizeof(buf)) ||
+        strcmp(buf, "void") == 0)
+      return 0;
+  }
+  return 1;
+}
+
+static void param_name(const cdd_ffi_ir_node_t *fn, size_t j, char *out,
+                       size_t out_size) {
+  if (fn->fields[j].name)
+    cs_ident(out, out_size, fn->fields[j].name);
+  else
+    CDD_SNPRINTF(out, out_size, "arg%lu", (unsigned long)j);
+}
+
+/** @brief Element type of a span over pointer parameter `p`. */
+static int span_elem(const cs_ctx_t *ctx, const cdd_ffi_field_t *p, char *out,
+                     size_t out_size) {
+  if (!cs_type(ctx, &p->type, -1, out, out_size) || strchr(out, '*'))
+    return 0;
+  /* Raw memory and char buffers are bytes, so `"..."u8` literals fit */
+  if (strcmp(out, "void") == 0 || strcmp(out, "sbyte") == 0)
+    CDD_SNPRINTF(out, out_size, "byte");
+  return 1;
+}
+
+static void emit_enum(FILE *f, const cdd_ffi_ir_node_t *node) {
+  char ident[256];
+  size_t j;
+  cs_ident(ident, sizeof(ident), record_ident(node->name));
+  fprintf(f, "    public enum %s : int\n    {\n", ident);
+  for (j = 0; j < node->variants_count; j++) {
+    const cdd_ffi_enum_variant_t *v = &node->variants[j];
+    if (!v->name)
+      continue;
+    cs_ident(ident, sizeof(ident), v->name);
+    /* The extractor records implicit values as the name itself */
+    if (v->value && strcmp(v->value, v->name) != 0)
+      fprintf(f, "        %s = %s,\n", ident, v->value);
+    else
+      fprintf(f, "        %s,\n", ident);
+  }
+  fprintf(f, "    }\n\n");
+}
+
+static void emit_record(FILE *f, const cs_ctx_t *ctx,
+                        const cdd_ffi_ir_node_t *node) {
+  char cls[256], ident[256], type[256], arr[512];
+  const cdd_ffi_record_layout_t *rec = fixed_layout(ctx, node);
+  size_t j;
+  int is_union = node->kind == CDD_FFI_NODE_UNION;
+
+  cs_ident(cls, sizeof(cls), record_ident(node->name));
+
+  /* Arrays of non-primitive elements become inline arrays */
+  for (j = 0; j < node->fields_count; j++) {
+    const cdd_ffi_field_t *field = &node->fields[j];
+    if (field->type.array_size <= 0 || is_fixed_buffer_type(&field->type))
+      continue;
+    cs_field_type(ctx, field, type, sizeof(type));
+    fprintf(f, "    [InlineArray(%ld)]\n", field->type.array_size);
+    fprintf(f, "    public struct %s_%s_Array\n    {\n",
+            record_ident(node->name), field->name);
+    fprintf(f, "        private %s _element0;\n", strchr(type, '*') ? "nint"
+                                                                    : type);
+    fprintf(f, "    }\n\n");
+  }
+
+  /* A fixed layout pins every member to its C offset */
+  if (rec)
+    fprintf(f, "    [StructLayout(LayoutKind.Explicit, Size = %lu)]\n",
+            (unsigned long)rec->size);
+  else
+    fprintf(f, "    [StructLayout(LayoutKind.%s)]\n",
+            is_union ? "Explicit" : "Sequential");
+  fprintf(f, "    public unsafe struct %s\n    {\n", cls);
+  for (j = 0; j < node->fields_count; j++) {
+    const cdd_ffi_field_t *field = &node->fields[j];
+    cs_field_type(ctx, field, type, sizeof(type));
+    cs_ident(ident, sizeof(ident), field->name);
+    if (rec)
+      fprintf(f, "        [FieldOffset(%lu)]\n",
+              (unsigned long)rec->fields[j].offset);
+    else if (is_union)
+      fprintf(f, "        [FieldOffset(0)]\n");
+    if (field->type.array_size <= 0) {
+      fprintf(f, "        public %s %s;\n", type, ident);
+    } else if (is_fixed_buffer_type(&field->type)) {
+      fprintf(f, "        public fixed %s %s[%ld];\n", type, ident,
+              field->type.array_size);
+    } else {
+      CDD_SNPRINTF(arr, sizeof(arr), "%s_%s_Array", record_ident(node->name),
+                   field->name);
+      fprintf(f, "        public %s %s;\n", arr, ident);
+    }
+  }
+  fprintf(f, "    }\n\n");
+}
+
+static void emit_function(FILE *f, const cs_ctx_t *ctx,
+                          const cdd_ffi_ir_node_t *fn) {
+  char name[256], ret[256], type[256], arg[256];
+  size_t j, n = param_count(fn);
+  int has_span = 0, first = 1, is_void;
+
+  cs_ident(name, sizeof(name), fn->name);
+  cs_type(ctx, &fn->return_or_base_type, 0, ret, sizeof(ret));
+  is_void = strcmp(ret, "void") == 0;
+
+  if (fn->doc)
+    fprintf(f, "        /// <summary>%s</summary>\n", fn->doc);
+  fprintf(f, "        [LibraryImport(LibraryName, EntryPoint = \"%s\")]\n",
+          fn->name);
+  fprintf(f, "        [UnmanagedCallConv(CallConvs = new[] { "
+             "typeof(CallConvCdecl) })]\n");
+  fprintf(f, "        public static partial %s %s(", ret, name);
+  for (j = 0; j < n; j++) {
+    const cdd_ffi_type_t *t = &fn->fields[j].type;
+    cs_type(ctx, t, t->array_size > 0, type, sizeof(type));
+    param_name(fn, j, arg, sizeof(arg));
+    fprintf(f, "%s%s %s", j ? ", " : "", type, arg);
+    if (cdd_ffi_buffer_length_index(fn, j) >= 0 &&
+        span_elem(ctx, &fn->fields[j], type, sizeof(type)))
+      has_span = 1;
+  }
+  fprintf(f, ");\n\n");
+  if (!has_span)
+    return;
+
+  /* Span overload: the pointer+length pairs collapse into one span that
+   * is pinned for the call, so nothing is copied or allocated */
+  fprintf(f, "        public static %s %s(", ret, name);
+  for (j = 0; j < n; j++) {
+    const cdd_ffi_field_t *p = &fn->fields[j];
+    const char *sep = first ? "" : ", ";
+    int is_len = 0;
+    size_t k;
+    for (k = 0; k < n; k++) {
+      if (cdd_ffi_buffer_length_index(fn, k) == (long)j &&
+          span_elem(ctx, &fn->fields[k], type, sizeof(type)))
+        is_len = 1;
+    }
+    if (is_len)
+      continue;
+    first = 0;
+    param_name(fn, j, arg, sizeof(arg));
+    if (cdd_ffi_buffer_length_index(fn, j) >= 0 &&
+        span_elem(ctx, p, type, sizeof(type)))
+      fprintf(f, "%s%s<%s> %s", sep,
+              p->type.is_const && p->intent != CDD_FFI_INTENT_OUT
+                  ? "ReadOnlySpan"
+                  : "Span",
+              type, arg);
+    else {
+      cs_type(ctx, &p->type, p->type.array_size > 0, type, sizeof(type));
+      fprintf(f, "%s%s %s", sep, type, arg);
+    }
+  }
+  fprintf(f, ")\n        {\n");
+  for (j = 0; j < n; j++) {
+    if (cdd_ffi_buffer_length_index(fn, j) < 0 ||
+        !span_elem(ctx, &fn->fields[j], type, sizeof(type)))
+      continue;
+    param_name(fn, j, arg, sizeof(arg));
+    fprintf(f, "            fixed (%s* %s__ptr = %s)\n", type, arg, arg);
+  }
+  fprintf(f, "            {\n");
+  fprintf(f, "                %s%s(", is_void ? "" : "return ", name);
+  for (j = 0; j < n; j++) {
+    long len_of = -1;
+    size_t k;
+    for (k = 0; k < n; k++) {
+      if (cdd_ffi_buffer_length_index(fn, k) == (long)j &&
+          span_elem(ctx, &fn->fields[k], type, sizeof(type)))
+        len_of = (long)k;
+    }
+    if (j)
+      fprintf(f, ", ");
+    if (len_of >= 0) {
+      cs_type(ctx, &fn->fields[j].type, 0, type, sizeof(type));
+      param_name(fn, (size_t)len_of, arg, sizeof(arg));
+      fprintf(f, "(%s)%s.Length", type, arg);
+    } else if (cdd_ffi_buffer_length_index(fn, j) >= 0 &&
+               span_elem(ctx, &fn->fields[j], type, sizeof(type))) {
+      param_name(fn, j, arg, sizeof(arg));
+      cs_type(ctx, &fn->fields[j].type, 0, type, sizeof(type));
+      fprintf(f, "(%s)%s__ptr", type, arg);
+    } else {
+      param_name(fn, j, arg, sizeof(arg));
+      fprintf(f, "%s", arg);
+    }
+  }
+  fprintf(f, ");\n");
+  fprintf(f, "            }\n");
+  fprintf(f, "        }\n\n");
+}
+
+static FILE *cs_open(const cdd_generate_bindings_config_t *config,
+                     const char *prefix, const char *name, int fail_at) {
+  char filepath[1024];
+  FILE *f = NULL;
+
+#if defined(_MSC_VER)
+  CDD_SNPRINTF(filepath, sizeof(filepath), "%s\\%s%s", config->output_dir,
+               prefix, name);
+  if (fopen_s(&f, filepath, "w") != 0)
+    f = NULL;
+#else
+  CDD_SNPRINTF(filepath, sizeof(filepath), "%s/%s%s", config->output_dir,
+               prefix, name);
+  f = fopen(filepath, "w");
+#endif
+  if (f && g_fail_io_after == fail_at) {
+    fclose(f);
+    f = NULL;
+  }
+  return f;
+}
+
+static cdd_c_error_t emit_bindings(const cs_ctx_t *ctx,
+                                   const cdd_generate_bindings_config_t *config,
+                                   const char *ns) {
+  const cdd_ffi_ir_t *ir = ctx->ir;
+  FILE *f;
+  size_t i;
+
+  f = cs_open(config, "", "Bindings.cs", 1);
+  if (!f)
+    return CDD_C_ERROR_IO;
+
+  fprintf(f, "// Auto-generated by cdd-c (LibraryImport, .NET 8+)\n");
+  fprintf(f, "using System;\n");
+  fprintf(f, "using System.Runtime.CompilerServices;\n");
+  fprintf(f, "using System.Runtime.InteropServices;\n\n");
+  fprintf(f, "[assembly: DisableRuntimeMarshalling]\n\n");
+  fprintf(f, "namespace %s\n{\n", ns);
+
+  for (i = 0; i < ir->nodes_count; i++) {
+    if (ir->nodes[i].kind == CDD_FFI_NODE_ENUM && ir->nodes[i].name)
+      emit_enum(f, &ir->nodes[i]);
+  }
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    if (ctx->ok[i] && find_record(ctx, node->name) == node)
+      emit_record(f, ctx, node);
+    else if ((node->kind == CDD_FFI_NODE_STRUCT ||
+              node->kind == CDD_FFI_NODE_UNION) &&
+             node->name && node->fields_count > 0 && !ctx->ok[i])
+      fprintf(f, "    // Skipped %s: not blittable\n\n", node->name);
+  }
+
+  fprintf(f, "    public static unsafe partial class NativeMethods\n    {\n");
+  fprintf(f, "        public const string LibraryName = \"%s\";\n\n",
+          config->library_name ? config->library_name : "libname");
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    if (node->kind != CDD_FFI_NODE_FUNCTION || !node->name)
+      continue;
+    if (function_supported(ctx, node))
+      emit_function(f, ctx, node);
+    else
+      fprintf(f, "        // Skipped %s: needs runtime marshalling\n\n",
+              node->name);
+  }
+  fprintf(f, "    }\n");
+  fprintf(f, "}\n");
+
+  fclose(f);
+  return CDD_C_SUCCESS;
+}
+
+static cdd_c_error_t emit_tests(const cs_ctx_t *ctx,
+                                const cdd_generate_bindings_config_t *config,
+                                const char *ns) {
+  const cdd_ffi_ir_t *ir = ctx->ir;
+  char cls[256];
+  FILE *f;
+  size_t i;
+
+  f = cs_open(config, "", "BindingsTests.cs", 3);
+  if (!f)
+    return CDD_C_ERROR_IO;
+
+  fprintf(f, "using System.Runtime.CompilerServices;\n");
+  fprintf(f, "using NUnit.Framework;\n\n");
+  fprintf(f, "namespace %s.Tests\n{\n", ns);
+  fprintf(f, "    [TestFixture]\n");
+  fprintf(f, "    public class NativeMethodsTests\n    {\n");
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    const cdd_ffi_record_layout_t *rec;
+    if (!ctx->ok[i] || find_record(ctx, node->name) != node)
+      continue;
+    rec = fixed_layout(ctx, node);
+    cs_ident(cls, sizeof(cls), record_ident(node->name));
+    fprintf(f, "        [Test]\n");
+    fprintf(f, "        public void Test%sSize()\n        {\n",
+            record_ident(node->name));
+    if (rec)
+      fprintf(f, "            Assert.AreEqual(%lu, Unsafe.SizeOf<%s>());\n",
+              (unsigned long)rec->size, cls);
+    else
+      fprintf(f, "            Assert.Greater(Unsafe.SizeOf<%s>(), 0);\n", cls);
+    fprintf(f, "        }\n\n");
+  }
+  fprintf(f, "    }\n");
+  fprintf(f, "}\n");
+
+  fclose(f);
+  return CDD_C_SUCCESS;
+}
+
+static cdd_c_error_t emit_csproj(const cdd_generate_bindings_config_t *config,
+                                 const char *ns) {
+  FILE *f = cs_open(config, ns, ".csproj", 2);
+  if (!f)
+    return CDD_C_ERROR_IO;
+
+  fprintf(f, "<Project Sdk=\"Microsoft.NET.Sdk\">\n");
+  fprintf(f, "  <PropertyGroup>\n");
+  fprintf(f, "    <TargetFramework>net8.0</TargetFramework>\n");
+  fprintf(f, "    <AllowUnsafeBlocks>true</AllowUnsafeBlocks>\n");
+  fprintf(f, "    <IsAotCompatible>true</IsAotCompatible>\n");
+  fprintf(f, "  </PropertyGroup>\n");
+  fprintf(f, "  <ItemGroup Condition=\" '$(Configuration)' == 'Test' \">\n");
+  fprintf(f, "    <PackageReference Include=\"nunit\" Version=\"3.13.3\" />\n");
+  fprintf(f, "    <PackageReference Include=\"NUnit3TestAdapter\" "
+             "Version=\"4.2.1\" />\n");
+  fprintf(f, "    <PackageReference Include=\"Microsoft.NET.Test.Sdk\" "
+             "Version=\"17.0.0\" />\n");
+  fprintf(f, "  </ItemGroup>\n");
+  fprintf(f, "</Project>\n");
+
+  fclose(f);
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t
+cdd_ffi_emit_csharp_libimport(cdd_ffi_ir_t *ir,
+                              const cdd_generate_bindings_config_t *config) {
+  cs_ctx_t ctx;
+  cdd_ffi_layout_cache_t layout;
+  char ns[256], ident[240];
+  cdd_c_error_t rc;
+
+  if (!ir || !config || !config->output_dir)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  makedir(config->output_dir);
+
+  ctx.ir = ir;
+  ctx.layout = &layout;
+  rc = cdd_ffi_layout_cache_init(&layout, ir);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  ctx.ok = (unsigned char *)C_CDD_CALLOC(ir->nodes_count + 1, 1);
+  if (!ctx.ok) {
+    cdd_ffi_layout_cache_free(&layout);
+    return CDD_C_ERROR_MEMORY;
+  }
+  mark_records(&ctx);
+
+  cs_ident(ident, sizeof(ident),
+           config->library_name ? config->library_name : "libname");
+  CDD_SNPRINTF(ns, sizeof(ns), "%sBindings",
+               ident[0] == '@' ? ident + 1 : ident);
+
+  rc = emit_bindings(&ctx, config, ns);
+  if (rc == CDD_C_SUCCESS)
+    rc = emit_csproj(config, ns);
+  if (rc == CDD_C_SUCCESS && config->generate_tests)
+    rc = emit_tests(&ctx, config, ns);
+
+  C_CDD_FREE(ctx.ok);
+  cdd_ffi_layout_cache_free(&layout);
+  return rc;
+}
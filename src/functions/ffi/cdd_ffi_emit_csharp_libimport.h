@@ -0,0 +1,36 @@
+#ifndef CDD_FFI_EMIT_CSHARP_LIBIMPORT_H
+#define CDD_FFI_EMIT_CSHARP_LIBIMPORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include "../../cdd_api.h"
+#include "cdd_c_error.h"
+#include "../../../include/ffi/cdd_ffi_ir.h"
+/* clang-format on */
+
+/**
+ * @brief Emits C# bindings that need no runtime marshalling.
+ *
+ * An alternative to cdd_ffi_emit_csharp() writing the same files
+ * (`Bindings.cs`, `<lib>Bindings.csproj`, `BindingsTests.cs`) for .NET 8+:
+ * functions are `[LibraryImport]` partial methods over blittable types
+ * only, the assembly sets `[DisableRuntimeMarshalling]`, structs are
+ * sequential with their C size spelled out where it is platform
+ * independent, and pointer+length parameter pairs get `Span<T>` /
+ * `ReadOnlySpan<T>` overloads that pin instead of copying.
+ *
+ * @param ir The extracted and topologically sorted FFI IR.
+ * @param config The generation config.
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_ffi_emit_csharp_libimport(
+    cdd_ffi_ir_t *ir, const cdd_generate_bindings_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CDD_FFI_EMIT_CSHARP_LIBIMPORT_H */
@@ -105,6 +105,58 @@ static const char *get_go_c_type(cdd_ffi_type_t type) {
   }
 }
 
+/**
+ * @brief Index of the length parameter when parameter `j` is taken as a Go
+ * slice and handed to C without copying, or -1.
+ */
+static long slice_length_index(const cdd_ffi_ir_node_t *fn, size_t j) {
+  if (fn->is_variadic || fn->fields[j].type.kind > CDD_FFI_KIND_FLOAT64)
+    return -1;
+  return cdd_ffi_buffer_length_index(fn, j);
+}
+
+static int is_slice_length(const cdd_ffi_ir_node_t *fn, size_t k) {
+  size_t j;
+  for (j = 0; j < fn->fields_count; j++) {
+    if (slice_length_index(fn, j) == (long)k)
+      return 1;
+  }
+  return 0;
+}
+
+/** @brief Go element type of a slice over buffer parameter `p`. */
+static const char *go_slice_elem(const cdd_ffi_field_t *p) {
+  cdd_ffi_type_t elem = p->type;
+  elem.pointer_depth = 0;
+  if (elem.kind == CDD_FFI_KIND_VOID || elem.kind == CDD_FFI_KIND_INT8 ||
+      elem.kind == CDD_FFI_KIND_UINT8)
+    return "byte";
+  return get_go_type(elem);
+}
+
+static const char *go_arg_name(const cdd_ffi_field_t *p) {
+  const char *arg_name = p->name ? p->name : "arg";
+  if (strcmp(arg_name, "type") == 0)
+    arg_name = "type_";
+  if (strcmp(arg_name, "func") == 0)
+    arg_name = "func_";
+  return arg_name;
+}
+
+/** @brief Emits the C argument for slice parameter `p`: its backing array. */
+static void emit_slice_ptr(FILE *f, const cdd_ffi_field_t *p) {
+  cdd_ffi_type_t elem = p->type;
+  elem.pointer_depth = 0;
+  if (elem.kind == CDD_FFI_KIND_VOID)
+    fprintf(f, "unsafe.Pointer(unsafe.SliceData(%s))", go_arg_name(p));
+  else if (elem.kind == CDD_FFI_KIND_INT8)
+    fprintf(f, "(*C.char)(unsafe.Pointer(unsafe.SliceData(%s)))",
+            go_arg_name(p));
+  else
+    fprintf(f, "(*%s)(unsafe.Pointer(unsafe.SliceData(%s)))",
+            get_go_c_type(elem), go_arg_name(p));
+}
+
 static cdd_c_error_t
 emit_go_file(cdd_ffi_ir_t *ir, const cdd_generate_bindings_config_t *config) {
   char filepath[1024];
@@ -216,16 +268,21 @@ emit_go_file(cdd_ffi_ir_t *ir, const cdd_generate_bindings_config_t *config) {
       if (node->doc)
         fprintf(f, "// %s\n", node->doc);
       fprintf(f, "func %s(", node->name);
-      for (j = 0; j < node->fields_count; j++) {
-        const char *arg_name =
-            node->fields[j].name ? node->fields[j].name : "arg";
-        if (strcmp(arg_name, "type") == 0)
-          arg_name = "type_";
-        if (strcmp(arg_name, "func") == 0)
-          arg_name = "func_";
-        fprintf(f, "%s %s", arg_name, get_go_type(node->fields[j].type));
-        if (j < node->fields_count - 1)
-          fprintf(f, ", ");
+      {
+        int first = 1;
+        for (j = 0; j < node->fields_count; j++) {
+          if (is_slice_length(node, j))
+            continue; /* len() of its slice */
+          if (!first)
+            fprintf(f, ", ");
+          first = 0;
+          if (slice_length_index(node, j) >= 0)
+            fprintf(f, "%s []%s", go_arg_name(&node->fields[j]),
+                    go_slice_elem(&node->fields[j]));
+          else
+            fprintf(f, "%s %s", go_arg_name(&node->fields[j]),
+                    get_go_type(node->fields[j].type));
+        }
       }
       fprintf(f, ") %s {\n", get_go_type(node->return_or_base_type));
 
@@ -235,13 +292,21 @@ emit_go_file(cdd_ffi_ir_t *ir, const cdd_generate_bindings_config_t *config) {
       }
       fprintf(f, "C.%s(", node->name);
       for (j = 0; j < node->fields_count; j++) {
-        const char *arg_name =
-            node->fields[j].name ? node->fields[j].name : "arg";
-        if (strcmp(arg_name, "type") == 0)
-          arg_name = "type_";
-        if (strcmp(arg_name, "func") == 0)
-          arg_name = "func_";
-        fprintf(f, "(%s)(%s)", get_go_c_type(node->fields[j].type), arg_name);
+        size_t b;
+        int is_len = 0;
+        for (b = 0; b < node->fields_count; b++) {
+          if (slice_length_index(node, b) == (long)j) {
+            fprintf(f, "(%s)(len(%s))", get_go_c_type(node->fields[j].type),
+                    go_arg_name(&node->fields[b]));
+            is_len = 1;
+            break;
+          }
+        }
+        if (!is_len && slice_length_index(node, j) >= 0)
+          emit_slice_ptr(f, &node->fields[j]);
+        else if (!is_len)
+          fprintf(f, "(%s)(%s)", get_go_c_type(node->fields[j].type),
+                  go_arg_name(&node->fields[j]));
         if (j < node->fields_count - 1)
           fprintf(f, ", ");
       }
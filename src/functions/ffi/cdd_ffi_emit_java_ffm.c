@@ -0,0 +1,739 @@
+extern volatile int g_fail_io_after;
+/* clang-format off */
+#include "cdd_ffi_emit_java_ffm.h"
+#include "cdd_ffi_layout.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "c_cdd/safe_crt.h"
+/* clang-format on */
+
+/** @brief Bound on by-value struct nesting, in case the IR is cyclic. */
+#define FFM_MAX_NESTING 32
+
+/** @brief How a C type is carried across the FFM boundary. */
+typedef struct ffm_type_t {
+  const char *layout;              /**< ValueLayout constant, or NULL */
+  const char *carrier;             /**< Java type of the value */
+  const cdd_ffi_ir_node_t *record; /**< Struct/union passed by value */
+  int is_void;                     /**< No value (returns only) */
+} ffm_type_t;
+
+/** @brief Java keywords, plus the names the generated class defines. */
+static const char *const java_reserved[] = {
+    "abstract", "assert", "boolean", "break", "byte", "case", "catch", "char",
+    "class", "const", "continue", "default", "do", "double", "else", "enum",
+    "extends", "false", "final", "finally", "float", "for", "goto", "if",
+    "implements", "import", "instanceof", "int", "interface", "long", "native",
+    "new", "null", "package", "private", "protected", "public", "return",
+    "short", "static", "strictfp", "super", "switch", "synchronized", "this",
+    "throw", "throws", "transient", "true", "try", "void", "volatile", "while",
+    "_", "LINKER", "LOOKUP", "downcall"};
+
+static const char *record_ident(const char *name) {
+  if (strncmp(name, "struct ", 7) == 0)
+    return name + 7;
+  if (strncmp(name, "union ", 6) == 0)
+    return name + 6;
+  return name;
+}
+
+/**
+ * @brief Records with a plain C layout. C++ classes and template instances
+ * have vtables or no C spelling, so they cannot be described here.
+ */
+static int is_exportable_record(const cdd_ffi_ir_node_t *node) {
+  return (node->kind == CDD_FFI_NODE_STRUCT ||
+          node->kind == CDD_FFI_NODE_UNION) &&
+         node->name && node->fields_count > 0 &&
+         node->base_classes_count == 0 && node->virtual_methods_count == 0 &&
+         !strchr(node->name, '<') && !strchr(node->name, ':');
+}
+
+static const cdd_ffi_ir_node_t *find_record(const cdd_ffi_ir_t *ir,
+                                            const char *name) {
+  size_t i;
+  if (!name)
+    return NULL;
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    if (is_exportable_record(node) &&
+        strcmp(record_ident(node->name), record_ident(name)) == 0)
+      return node;
+  }
+  return NULL;
+}
+
+static const cdd_ffi_ir_node_t *find_typedef(const cdd_ffi_ir_t *ir,
+                                             const char *name) {
+  size_t i;
+  if (!name)
+    return NULL;
+  for (i = 0; i < ir->nodes_count; i++) {
+    if (ir->nodes[i].kind == CDD_FFI_NODE_TYPEDEF && ir->nodes[i].name &&
+        strcmp(ir->nodes[i].name, name) == 0)
+      return &ir->nodes[i];
+  }
+  return NULL;
+}
+
+/** @brief Enum typedefs reach the IR as plain type names. */
+static int is_enum_name(const cdd_ffi_ir_t *ir, const char *name) {
+  size_t i;
+  if (!name)
+    return 0;
+  for (i = 0; i < ir->nodes_count; i++) {
+    if (ir->nodes[i].kind == CDD_FFI_NODE_ENUM && ir->nodes[i].name &&
+        strcmp(record_ident(ir->nodes[i].name), record_ident(name)) == 0)
+      return 1;
+  }
+  return 0;
+}
+
+/** @brief Write `name` as a Java identifier; reserved words get a `_`. */
+static void ffm_ident(char *out, size_t out_size, const char *name) {
+  size_t i = 0, k;
+  if (out_size < 2)
+    return;
+  for (; name[i] && i + 2 < out_size; i++) {
+    char c = name[i];
+    out[i] = (isalnum((unsigned char)c) || c == '_') ? c : '_';
+  }
+  out[i] = '\0';
+  for (k = 0; k < sizeof(java_reserved) / sizeof(java_reserved[0]); k++) {
+    if (strcmp(out, java_reserved[k]) == 0) {
+      out[i] = '_';
+      out[i + 1] = '\0';
+      break;
+    }
+  }
+}
+
+static void to_camel_case(const char *snake, char *out, size_t out_size) {
+  size_t i, j = 0;
+  int up = 1;
+  for (i = 0; snake[i] && j + 1 < out_size; i++) {
+    if (!isalnum((unsigned char)snake[i])) {
+      up = 1;
+    } else if (up) {
+      out[j++] = (char)toupper((unsigned char)snake[i]);
+      up = 0;
+    } else {
+      out[j++] = snake[i];
+    }
+  }
+  out[j] = '\0';
+}
+
+static int scalar_type(cdd_ffi_primitive_kind_t kind, ffm_type_t *out) {
+  switch (kind) {
+  case CDD_FFI_KIND_BOOL:
+    out->layout = "JAVA_BOOLEAN";
+    out->carrier = "boolean";
+    return 1;
+  case CDD_FFI_KIND_INT8:
+  case CDD_FFI_KIND_UINT8:
+    out->layout = "JAVA_BYTE";
+    out->carrier = "byte";
+    return 1;
+  case CDD_FFI_KIND_INT16:
+  case CDD_FFI_KIND_UINT16:
+    out->layout = "JAVA_SHORT";
+    out->carrier = "short";
+    return 1;
+  case CDD_FFI_KIND_INT32:
+  case CDD_FFI_KIND_UINT32:
+  case CDD_FFI_KIND_ENUM_REF:
+    out->layout = "JAVA_INT";
+    out->carrier = "int";
+    return 1;
+  case CDD_FFI_KIND_INT64:
+  case CDD_FFI_KIND_UINT64:
+    out->layout = "JAVA_LONG";
+    out->carrier = "long";
+    return 1;
+  case CDD_FFI_KIND_FLOAT32:
+    out->layout = "JAVA_FLOAT";
+    out->carrier = "float";
+    return 1;
+  case CDD_FFI_KIND_FLOAT64:
+    out->layout = "JAVA_DOUBLE";
+    out->carrier = "double";
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+static int record_supported(const cdd_ffi_ir_t *ir,
+                            const cdd_ffi_ir_node_t *node, int nesting);
+
+/**
+ * @brief Map a type (arrays aside) to its layout, resolving typedefs.
+ * @param ir The IR.
+ * @param type The type.
+ * @param extra_depth Pointer levels added by enclosing typedefs.
+ * @param nesting By-value struct nesting so far.
+ * @param[out] out The mapping.
+ * @return 1 when the type can cross the boundary, else 0.
+ */
+static int resolve(const cdd_ffi_ir_t *ir, const cdd_ffi_type_t *type,
+                   int extra_depth, int nesting, ffm_type_t *out) {
+  int depth = type->pointer_depth + extra_depth;
+
+  memset(out, 0, sizeof(*out));
+  if (depth > 0 || type->kind == CDD_FFI_KIND_OPAQUE_PTR ||
+      type->kind == CDD_FFI_KIND_FUNCTION_PTR) {
+    out->layout = "ADDRESS";
+    out->carrier = "MemorySegment";
+    return 1;
+  }
+  switch (type->kind) {
+  case CDD_FFI_KIND_VOID:
+    out->carrier = "void";
+    out->is_void = 1;
+    return 1;
+  case CDD_FFI_KIND_TYPEDEF_REF: {
+    const cdd_ffi_ir_node_t *td = find_typedef(ir, type->ref_name);
+    if (td)
+      return td->return_or_base_type.kind != CDD_FFI_KIND_TYPEDEF_REF &&
+             resolve(ir, &td->return_or_base_type, depth, nesting, out);
+  }
+  /* FALLTHROUGH */
+  case CDD_FFI_KIND_STRUCT_REF:
+    if (is_enum_name(ir, type->ref_name))
+      return scalar_type(CDD_FFI_KIND_ENUM_REF, out);
+    out->record = find_record(ir, type->ref_name);
+    out->carrier = "MemorySegment";
+    return out->record != NULL &&
+           record_supported(ir, out->record, nesting + 1);
+  default:
+    return scalar_type(type->kind, out);
+  }
+}
+
+/**
+ * @brief Map a struct member, where fixed-size arrays stay inline. FFM
+ * layouts have no bit-fields or flexible array members.
+ */
+static int resolve_field(const cdd_ffi_ir_t *ir, const cdd_ffi_field_t *field,
+                         int nesting, ffm_type_t *out) {
+  return field->name && field->bit_width <= 0 &&
+         field->type.array_size >= 0 &&
+         resolve(ir, &field->type, 0, nesting, out) && !out->is_void;
+}
+
+static int record_supported(const cdd_ffi_ir_t *ir,
+                            const cdd_ffi_ir_node_t *node, int nesting) {
+  size_t i;
+  ffm_type_t t;
+  if (nesting > FFM_MAX_NESTING)
+    return 0;
+  for (i = 0; i < node->fields_count; i++) {
+    if (!resolve_field(ir, &node->fields[i], nesting, &t))
+      return 0;
+  }
+  return 1;
+}
+
+/** @brief Map a parameter; arrays decay to pointers as they do in C. */
+static int resolve_param(const cdd_ffi_ir_t *ir, const cdd_ffi_field_t *field,
+                         ffm_type_t *out) {
+  if (!resolve(ir, &field->type, field->type.array_size > 0, 0, out))
+    return 0;
+  return !out->is_void;
+}
+
+/** @brief `f(void)` is spelled with a single unnamed void parameter. */
+static int is_void_param_list(const cdd_ffi_ir_node_t *node) {
+  return node->fields_count == 1 &&
+         node->fields[0].type.kind == CDD_FFI_KIND_VOID &&
+         node->fields[0].type.pointer_depth == 0;
+}
+
+static int function_supported(const cdd_ffi_ir_t *ir,
+                              const cdd_ffi_ir_node_t *node) {
+  size_t i;
+  ffm_type_t t;
+  if (node->kind != CDD_FFI_NODE_FUNCTION || !node->name ||
+      node->is_variadic || strchr(node->name, ':'))
+    return 0;
+  if (!resolve(ir, &node->return_or_base_type, 0, 0, &t))
+    return 0;
+  if (is_void_param_list(node))
+    return 1;
+  for (i = 0; i < node->fields_count; i++) {
+    if (!resolve_param(ir, &node->fields[i], &t))
+      return 0;
+  }
+  return 1;
+}
+
+/** @brief Print the layout expression of `t`, e.g. `Point.LAYOUT`. */
+static void emit_layout(FILE *f, const ffm_type_t *t) {
+  if (t->record) {
+    char ident[256];
+    ffm_ident(ident, sizeof(ident), record_ident(t->record->name));
+    fprintf(f, "%s.LAYOUT", ident);
+  } else {
+    fprintf(f, "%s", t->layout);
+  }
+}
+
+/**
+ * @brief Whether the layout engine can lay out a record, i.e. every member
+ * has a known size, so LAYOUT resolves each field to a fixed offset.
+ */
+static int record_laid_out(cdd_ffi_layout_cache_t *layout,
+                           const cdd_ffi_ir_node_t *node) {
+  const cdd_ffi_record_layout_t *rec;
+  return cdd_ffi_layout_record(layout, node, CDD_CST_ABI_LP64, &rec) ==
+         CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Accessors at offsets read from LAYOUT when the class loads, so they
+ * hold on whatever ABI the JVM runs; as static finals the JIT folds them and
+ * each access is a plain get/set.
+ */
+static void emit_fixed_accessors(FILE *f, const cdd_ffi_ir_t *ir,
+                                 const cdd_ffi_ir_node_t *node) {
+  char ident[256];
+  size_t i;
+  ffm_type_t t;
+
+  fprintf(f, "\n        public static final long SIZE = LAYOUT.byteSize();\n");
+  for (i = 0; i < node->fields_count; i++) {
+    const cdd_ffi_field_t *field = &node->fields[i];
+    resolve_field(ir, field, 0, &t);
+    ffm_ident(ident, sizeof(ident), field->name);
+    fprintf(f,
+            "        private static final long %s$OFFSET =\n"
+            "            LAYOUT.byteOffset(PathElement.groupElement(\"%s\"));"
+            "\n",
+            ident, field->name);
+    if (t.record || field->type.array_size > 0)
+      fprintf(f,
+              "        private static final long %s$SIZE =\n"
+              "            LAYOUT.select(PathElement.groupElement(\"%s\"))"
+              ".byteSize();\n",
+              ident, field->name);
+  }
+
+  for (i = 0; i < node->fields_count; i++) {
+    const cdd_ffi_field_t *field = &node->fields[i];
+    resolve_field(ir, field, 0, &t);
+    ffm_ident(ident, sizeof(ident), field->name);
+    fprintf(f, "\n");
+    if (t.record || field->type.array_size > 0) {
+      fprintf(f,
+              "        public static MemorySegment %s(MemorySegment struct) {\n"
+              "            return struct.asSlice(%s$OFFSET, %s$SIZE);\n"
+              "        }\n",
+              ident, ident, ident);
+      continue;
+    }
+    fprintf(f,
+            "        public static %s %s(MemorySegment struct) {\n"
+            "            return struct.get(%s, %s$OFFSET);\n"
+            "        }\n\n",
+            t.carrier, ident, t.layout, ident);
+    fprintf(f,
+            "        public static void %s(MemorySegment struct, %s value) {\n"
+            "            struct.set(%s, %s$OFFSET, value);\n"
+            "        }\n",
+            ident, t.carrier, t.layout, ident);
+  }
+}
+
+static void emit_record(FILE *f, const cdd_ffi_ir_t *ir,
+                        cdd_ffi_layout_cache_t *layout,
+                        const cdd_ffi_ir_node_t *node) {
+  char cls[256], ident[256];
+  size_t i;
+  ffm_type_t t;
+
+  ffm_ident(cls, sizeof(cls), record_ident(node->name));
+  fprintf(f, "    /** Layout and accessors for `%s`. */\n", node->name);
+  fprintf(f, "    public static final class %s {\n", cls);
+  fprintf(f, "        private %s() {}\n\n", cls);
+  fprintf(f, "        public static final GroupLayout LAYOUT = %s(\"%s\"",
+          node->kind == CDD_FFI_NODE_UNION ? "union" : "struct",
+          record_ident(node->name));
+  for (i = 0; i < node->fields_count; i++) {
+    const cdd_ffi_field_t *field = &node->fields[i];
+    resolve_field(ir, field, 0, &t);
+    fprintf(f, ",\n            ");
+    if (field->type.array_size > 0) {
+      fprintf(f, "MemoryLayout.sequenceLayout(%ldL, ", field->type.array_size);
+      emit_layout(f, &t);
+      fprintf(f, ")");
+    } else {
+      emit_layout(f, &t);
+    }
+    fprintf(f, ".withName(\"%s\")", field->name);
+  }
+  fprintf(f, ");\n\n");
+
+  fprintf(f, "        public static MemorySegment allocate("
+             "SegmentAllocator allocator) {\n");
+  fprintf(f, "            return allocator.allocate(LAYOUT);\n");
+  fprintf(f, "        }\n");
+
+  if (record_laid_out(layout, node)) {
+    emit_fixed_accessors(f, ir, node);
+    fprintf(f, "    }\n\n");
+    return;
+  }
+  for (i = 0; i < node->fields_count; i++) {
+    const cdd_ffi_field_t *field = &node->fields[i];
+    resolve_field(ir, field, 0, &t);
+    ffm_ident(ident, sizeof(ident), field->name);
+    fprintf(f, "\n");
+    if (t.record || field->type.array_size > 0) {
+      /* Aggregates are views into the parent, not copies */
+      fprintf(f,
+              "        private static final long %s$OFFSET =\n"
+              "            LAYOUT.byteOffset(PathElement.groupElement(\"%s\"));"
+              "\n",
+              ident, field->name);
+      fprintf(f,
+              "        private static final long %s$SIZE =\n"
+              "            LAYOUT.select(PathElement.groupElement(\"%s\"))"
+              ".byteSize();\n\n",
+              ident, field->name);
+      fprintf(f,
+              "        public static MemorySegment %s(MemorySegment struct) {\n"
+              "            return struct.asSlice(%s$OFFSET, %s$SIZE);\n"
+              "        }\n",
+              ident, ident, ident);
+      continue;
+    }
+    fprintf(f,
+            "        private static final VarHandle %s$VH =\n"
+            "            LAYOUT.varHandle(PathElement.groupElement(\"%s\"));"
+            "\n\n",
+            ident, field->name);
+    fprintf(f,
+            "        public static %s %s(MemorySegment struct) {\n"
+            "            return (%s) %s$VH.get(struct, 0L);\n"
+            "        }\n\n",
+            t.carrier, ident, t.carrier, ident);
+    fprintf(f,
+            "        public static void %s(MemorySegment struct, %s value) {\n"
+            "            %s$VH.set(struct, 0L, value);\n"
+            "        }\n",
+            ident, t.carrier, ident);
+  }
+  fprintf(f, "    }\n\n");
+}
+
+static void emit_function(FILE *f, const cdd_ffi_ir_t *ir,
+                          const cdd_ffi_ir_node_t *node) {
+  char name[256], arg[256];
+  size_t i, nargs = is_void_param_list(node) ? 0 : node->fields_count;
+  ffm_type_t ret, t;
+  int first = 1;
+
+  resolve(ir, &node->return_or_base_type, 0, 0, &ret);
+  ffm_ident(name, sizeof(name), node->name);
+
+  /* The holder class is initialised on first call, so only the functions
+   * actually used are looked up, and the JIT folds the static final. */
+  fprintf(f, "    private static final class %s$ {\n", name);
+  fprintf(f, "        static final MethodHandle MH = downcall(\"%s\",\n",
+          node->name);
+  if (ret.is_void) {
+    fprintf(f, "            FunctionDescriptor.ofVoid(");
+  } else {
+    fprintf(f, "            FunctionDescriptor.of(");
+    emit_layout(f, &ret);
+    first = 0;
+  }
+  for (i = 0; i < nargs; i++) {
+    resolve_param(ir, &node->fields[i], &t);
+    if (!first)
+      fprintf(f, ", ");
+    emit_layout(f, &t);
+    first = 0;
+  }
+  fprintf(f, "));\n");
+  fprintf(f, "    }\n\n");
+
+  if (node->doc)
+    fprintf(f, "    /** %s */\n", node->doc);
+  fprintf(f, "    public static %s %s(", ret.carrier, name);
+  first = 1;
+  if (ret.record) {
+    /* By-value struct returns are written into caller-provided memory */
+    fprintf(f, "SegmentAllocator allocator$");
+    first = 0;
+  }
+  for (i = 0; i < nargs; i++) {
+    resolve_param(ir, &node->fields[i], &t);
+    if (node->fields[i].name)
+      ffm_ident(arg, sizeof(arg), node->fields[i].name);
+    else
+      CDD_SNPRINTF(arg, sizeof(arg), "arg%lu", (unsigned long)i);
+    fprintf(f, "%s%s %s", first ? "" : ", ", t.carrier, arg);
+    first = 0;
+  }
+  fprintf(f, ") {\n");
+  fprintf(f, "        try {\n");
+  if (ret.is_void)
+    fprintf(f, "            %s$.MH.invokeExact(", name);
+  else
+    fprintf(f, "            return (%s) %s$.MH.invokeExact(", ret.carrier,
+            name);
+  first = 1;
+  if (ret.record) {
+    fprintf(f, "allocator$");
+    first = 0;
+  }
+  for (i = 0; i < nargs; i++) {
+    if (node->fields[i].name)
+      ffm_ident(arg, sizeof(arg), node->fields[i].name);
+    else
+      CDD_SNPRINTF(arg, sizeof(arg), "arg%lu", (unsigned long)i);
+    fprintf(f, "%s%s", first ? "" : ", ", arg);
+    first = 0;
+  }
+  fprintf(f, ");\n");
+  /* `$` never appears in a mapped C name, so these cannot shadow one */
+  fprintf(f, "        } catch (Error | RuntimeException e$) {\n");
+  fprintf(f, "            throw e$;\n");
+  fprintf(f, "        } catch (Throwable t$) {\n");
+  fprintf(f, "            throw new AssertionError(t$);\n");
+  fprintf(f, "        }\n");
+  fprintf(f, "    }\n\n");
+}
+
+/** @brief Print a C string value as a Java string literal. */
+static void emit_java_string(FILE *f, const char *s) {
+  fputc('"', f);
+  for (; *s; s++) {
+    unsigned char c = (unsigned char)*s;
+    if (c == '"' || c == '\\')
+      fprintf(f, "\\%c", c);
+    else if (c == '\n')
+      fputs("\\n", f);
+    else if (c == '\t')
+      fputs("\\t", f);
+    else if (c < 0x20)
+      fprintf(f, "\\u%04x", c);
+    else
+      fputc(c, f);
+  }
+  fputc('"', f);
+}
+
+static void emit_macro(FILE *f, const cdd_ffi_ir_node_t *node) {
+  char ident[256];
+  ffm_ident(ident, sizeof(ident), node->name);
+  switch (node->inferred_type) {
+  case CDD_FFI_MACRO_TYPE_INT:
+    fprintf(f, "    public static final long %s = %sL;\n", ident,
+            node->evaluated_value);
+    break;
+  case CDD_FFI_MACRO_TYPE_FLOAT:
+    fprintf(f, "    public static final double %s = %s;\n", ident,
+            node->evaluated_value);
+    break;
+  case CDD_FFI_MACRO_TYPE_STRING:
+    fprintf(f, "    public static final String %s = ", ident);
+    emit_java_string(f, node->evaluated_value);
+    fprintf(f, ";\n");
+    break;
+  default:
+    break;
+  }
+}
+
+/**
+ * @brief Enum constants as ints, numbering implicit variants the way C
+ * does. Variants after one whose value is an expression are skipped until
+ * the next literal, since their values are unknown here.
+ */
+static void emit_enum(FILE *f, const cdd_ffi_ir_node_t *node) {
+  char ident[256];
+  size_t i;
+  long next = 0;
+  int known = 1;
+
+  for (i = 0; i < node->variants_count; i++) {
+    const cdd_ffi_enum_variant_t *v = &node->variants[i];
+    if (!v->name)
+      continue;
+    if (v->value && strcmp(v->value, v->name) != 0) {
+      char *end = NULL;
+      long val = strtol(v->value, &end, 0);
+      known = end != v->value && *end == '\0';
+      if (known)
+        next = val;
+    }
+    if (known) {
+      ffm_ident(ident, sizeof(ident), v->name);
+      fprintf(f, "    public static final int %s = %ld;\n", ident, next);
+    }
+    next++;
+  }
+}
+
+/** @brief Runtime helpers shared by every generated class. */
+static void emit_prelude(FILE *f, const char *lib_name) {
+  fprintf(f, "    static {\n");
+  fprintf(f, "        System.loadLibrary(\"%s\");\n", lib_name);
+  fprintf(f, "    }\n\n");
+  fprintf(f, "    private static final Linker LINKER = "
+             "Linker.nativeLinker();\n");
+  fprintf(f, "    private static final SymbolLookup LOOKUP =\n");
+  fprintf(f, "        SymbolLookup.loaderLookup()"
+             ".or(LINKER.defaultLookup());\n\n");
+  fprintf(f, "    static MethodHandle downcall(String name, "
+             "FunctionDescriptor desc) {\n");
+  fprintf(f, "        MemorySegment addr = LOOKUP.find(name).orElseThrow(\n");
+  fprintf(f, "            () -> new UnsatisfiedLinkError(name));\n");
+  fprintf(f, "        return LINKER.downcallHandle(addr, desc);\n");
+  fprintf(f, "    }\n\n");
+
+  /* Padding is computed from the platform's layouts, so the same source
+   * is right on 32- and 64-bit targets. */
+  fprintf(f, "    /** Lays members out as a C compiler does, "
+             "with alignment padding. */\n");
+  fprintf(f, "    static GroupLayout struct(String name, "
+             "MemoryLayout... members) {\n");
+  fprintf(f, "        List<MemoryLayout> out = new ArrayList<>();\n");
+  fprintf(f, "        long offset = 0, align = 1;\n");
+  fprintf(f, "        for (MemoryLayout m : members) {\n");
+  fprintf(f, "            long a = m.byteAlignment();\n");
+  fprintf(f, "            if (offset %% a != 0) {\n");
+  fprintf(f, "                out.add(MemoryLayout.paddingLayout("
+             "a - offset %% a));\n");
+  fprintf(f, "                offset += a - offset %% a;\n");
+  fprintf(f, "            }\n");
+  fprintf(f, "            out.add(m);\n");
+  fprintf(f, "            offset += m.byteSize();\n");
+  fprintf(f, "            align = Math.max(align, a);\n");
+  fprintf(f, "        }\n");
+  fprintf(f, "        if (offset %% align != 0)\n");
+  fprintf(f, "            out.add(MemoryLayout.paddingLayout("
+             "align - offset %% align));\n");
+  fprintf(f, "        return MemoryLayout.structLayout(\n");
+  fprintf(f, "            out.toArray(new MemoryLayout[0]))"
+             ".withName(name);\n");
+  fprintf(f, "    }\n\n");
+  fprintf(f, "    static GroupLayout union(String name, "
+             "MemoryLayout... members) {\n");
+  fprintf(f, "        long size = 0, align = 1;\n");
+  fprintf(f, "        for (MemoryLayout m : members) {\n");
+  fprintf(f, "            size = Math.max(size, m.byteSize());\n");
+  fprintf(f, "            align = Math.max(align, m.byteAlignment());\n");
+  fprintf(f, "        }\n");
+  fprintf(f, "        MemoryLayout[] all = Arrays.copyOf(members, "
+             "members.length + 1);\n");
+  fprintf(f, "        all[members.length] = MemoryLayout.paddingLayout(\n");
+  fprintf(f, "            (size + align - 1) / align * align);\n");
+  fprintf(f, "        return MemoryLayout.unionLayout(all).withName(name);\n");
+  fprintf(f, "    }\n\n");
+}
+
+static cdd_c_error_t
+emit_java_ffm_file(const cdd_ffi_ir_t *ir, cdd_ffi_layout_cache_t *layout,
+                   const cdd_generate_bindings_config_t *config) {
+  char filepath[1024], camel[250], class_name[256];
+  const char *lib_name =
+      config->library_name ? config->library_name : "mylib";
+  FILE *f = NULL;
+  size_t i;
+
+  to_camel_case(lib_name, camel, sizeof(camel));
+  CDD_SNPRINTF(class_name, sizeof(class_name), "%sFfm", camel);
+
+#if defined(_MSC_VER)
+  CDD_SNPRINTF(filepath, sizeof(filepath), "%s\\%s.java", config->output_dir,
+               class_name);
+  if (fopen_s(&f, filepath, "w") != 0)
+    f = NULL;
+#else
+  CDD_SNPRINTF(filepath, sizeof(filepath), "%s/%s.java", config->output_dir,
+               class_name);
+  f = fopen(filepath, "w");
+#endif
+  if (!f)
+    return CDD_C_ERROR_IO;
+  if (g_fail_io_after == 1) {
+    fclose(f);
+    return CDD_C_ERROR_IO;
+  }
+
+  fprintf(f, "// Auto-generated Java FFM bindings for %s\n", lib_name);
+  fprintf(f, "// Requires JDK 22+; run with "
+             "--enable-native-access=ALL-UNNAMED\n\n");
+  fprintf(f, "import java.lang.foreign.*;\n");
+  fprintf(f, "import java.lang.foreign.MemoryLayout.PathElement;\n");
+  fprintf(f, "import java.lang.invoke.MethodHandle;\n");
+  fprintf(f, "import java.lang.invoke.VarHandle;\n");
+  fprintf(f, "import java.util.ArrayList;\n");
+  fprintf(f, "import java.util.Arrays;\n");
+  fprintf(f, "import java.util.List;\n\n");
+  fprintf(f, "import static java.lang.foreign.ValueLayout.*;\n\n");
+
+  fprintf(f, "public final class %s {\n", class_name);
+  fprintf(f, "    private %s() {}\n\n", class_name);
+  emit_prelude(f, lib_name);
+
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    if (node->kind == CDD_FFI_NODE_MACRO && node->name &&
+        node->evaluated_value)
+      emit_macro(f, node);
+    else if (node->kind == CDD_FFI_NODE_ENUM)
+      emit_enum(f, node);
+  }
+  fprintf(f, "\n");
+
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    if (!is_exportable_record(node))
+      continue;
+    if (find_record(ir, node->name) != node)
+      continue; /* Forward declaration seen first */
+    if (record_supported(ir, node, 0))
+      emit_record(f, ir, layout, node);
+    else
+      fprintf(f, "    // Skipped %s: a member has no FFM layout\n\n",
+              node->name);
+  }
+
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    if (node->kind != CDD_FFI_NODE_FUNCTION || !node->name)
+      continue;
+    if (function_supported(ir, node))
+      emit_function(f, ir, node);
+    else
+      fprintf(f, "    // Skipped %s: signature has no FFM mapping\n\n",
+              node->name);
+  }
+
+  fprintf(f, "}\n");
+  fclose(f);
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t
+cdd_ffi_emit_java_ffm(cdd_ffi_ir_t *ir,
+                      const cdd_generate_bindings_config_t *config) {
+  cdd_ffi_layout_cache_t layout;
+  cdd_c_error_t rc;
+
+  if (!ir || !config || !config->output_dir)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  rc = cdd_ffi_layout_cache_init(&layout, ir);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  rc = emit_java_ffm_file(ir, &layout, config);
+  cdd_ffi_layout_cache_free(&layout);
+  return rc;
+}
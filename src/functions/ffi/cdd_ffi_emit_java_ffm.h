@@ -0,0 +1,36 @@
+#ifndef CDD_FFI_EMIT_JAVA_FFM_H
+#define CDD_FFI_EMIT_JAVA_FFM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include "../../cdd_api.h"
+#include "cdd_c_error.h"
+#include "../../../include/ffi/cdd_ffi_ir.h"
+/* clang-format on */
+
+/**
+ * @brief Emits Java Foreign Function & Memory (JDK 22+) bindings for the
+ * given FFI IR.
+ *
+ * Writes `<Lib>Ffm.java`. Each function is a static method over a
+ * `static final` MethodHandle from Linker::downcallHandle, created the
+ * first time the function is called; each struct or union is a class with
+ * a MemoryLayout built once at class initialisation and VarHandle-based
+ * accessors over a MemorySegment. Nothing is resolved by reflection at
+ * call time, unlike the JNA bindings from cdd_ffi_emit_java().
+ *
+ * @param ir The extracted and topologically sorted FFI IR.
+ * @param config The generation config.
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_ffi_emit_java_ffm(
+    cdd_ffi_ir_t *ir, const cdd_generate_bindings_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CDD_FFI_EMIT_JAVA_FFM_H */
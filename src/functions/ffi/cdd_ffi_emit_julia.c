@@ -56,6 +56,45 @@ static const char *get_julia_type(cdd_ffi_type_t type) {
   }
 }
 
+/**
+ * @brief Index of the length parameter when parameter `j` is taken as a
+ * dense Julia vector (passed to `ccall` as a pointer, no copy), or -1.
+ */
+static long vector_length_index(const cdd_ffi_ir_node_t *fn, size_t j) {
+  if (fn->is_variadic || fn->fields[j].type.kind > CDD_FFI_KIND_FLOAT64)
+    return -1;
+  return cdd_ffi_buffer_length_index(fn, j);
+}
+
+/** @brief Index of the vector parameter whose length is parameter `k`. */
+static long vector_of_length(const cdd_ffi_ir_node_t *fn, size_t k) {
+  size_t j;
+  for (j = 0; j < fn->fields_count; j++) {
+    if (vector_length_index(fn, j) == (long)k)
+      return (long)j;
+  }
+  return -1;
+}
+
+/** @brief Julia element type of a vector over buffer parameter `p`. */
+static const char *vector_elem(const cdd_ffi_field_t *p, int for_ccall) {
+  cdd_ffi_type_t elem = p->type;
+  elem.pointer_depth = 0;
+  if (elem.kind == CDD_FFI_KIND_VOID)
+    return for_ccall ? "Cvoid" : "UInt8";
+  if (elem.kind == CDD_FFI_KIND_INT8 || elem.kind == CDD_FFI_KIND_UINT8)
+    return "UInt8";
+  return get_julia_type(elem);
+}
+
+static const char *julia_arg_name(const cdd_ffi_field_t *p) {
+  const char *arg_name = p->name ? p->name : "arg";
+  /* avoid julia keywords */
+  if (strcmp(arg_name, "function") == 0)
+    arg_name = "func";
+  return arg_name;
+}
+
 static void to_camel_case(const char *snake, char *out, size_t out_size) {
   size_t i, j = 0;
   int up = 1;
@@ -157,22 +196,29 @@ emit_julia_file(cdd_ffi_ir_t *ir,
       if (node->doc)
         fprintf(f, "# %s\n", node->doc);
       fprintf(f, "function %s(", node->name);
-      for (j = 0; j < node->fields_count; j++) {
-        const char *arg_name =
-            node->fields[j].name ? node->fields[j].name : "arg";
-        /* avoid julia keywords */
-        if (strcmp(arg_name, "function") == 0)
-          arg_name = "func";
-        fprintf(f, "%s", arg_name);
-        if (j < node->fields_count - 1)
-          fprintf(f, ", ");
+      {
+        int first = 1;
+        for (j = 0; j < node->fields_count; j++) {
+          if (vector_of_length(node, j) >= 0)
+            continue; /* length() of its vector */
+          if (!first)
+            fprintf(f, ", ");
+          first = 0;
+          fprintf(f, "%s", julia_arg_name(&node->fields[j]));
+          if (vector_length_index(node, j) >= 0)
+            fprintf(f, "::DenseVector{%s}",
+                    vector_elem(&node->fields[j], 0));
+        }
       }
       fprintf(f, ")\n");
 
       fprintf(f, "    ccall((:%s, lib_path), %s, (", node->name,
               get_julia_type(node->return_or_base_type));
       for (j = 0; j < node->fields_count; j++) {
-        fprintf(f, "%s", get_julia_type(node->fields[j].type));
+        if (vector_length_index(node, j) >= 0)
+          fprintf(f, "Ptr{%s}", vector_elem(&node->fields[j], 1));
+        else
+          fprintf(f, "%s", get_julia_type(node->fields[j].type));
         if (j < node->fields_count - 1 || node->fields_count == 1)
           fprintf(f, ", ");
       }
@@ -180,12 +226,13 @@ emit_julia_file(cdd_ffi_ir_t *ir,
 
       if (node->fields_count > 0) {
         fprintf(f, ", ");
+        /* Vectors go in as-is: ccall passes a pointer to their own data */
         for (j = 0; j < node->fields_count; j++) {
-          const char *arg_name =
-              node->fields[j].name ? node->fields[j].name : "arg";
-          if (strcmp(arg_name, "function") == 0)
-            arg_name = "func";
-          fprintf(f, "%s", arg_name);
+          long b = vector_of_length(node, j);
+          if (b >= 0)
+            fprintf(f, "length(%s)", julia_arg_name(&node->fields[b]));
+          else
+            fprintf(f, "%s", julia_arg_name(&node->fields[j]));
           if (j < node->fields_count - 1)
             fprintf(f, ", ");
         }
@@ -7,6 +7,203 @@
 #include <string.h>
 /* clang-format on */
 
+/** @brief C spelling of a numeric scalar kind, or NULL. */
+static const char *napi_c_scalar(cdd_ffi_primitive_kind_t kind) {
+  switch (kind) {
+  case CDD_FFI_KIND_BOOL:
+    return "bool";
+  case CDD_FFI_KIND_INT8:
+    return "int8_t";
+  case CDD_FFI_KIND_UINT8:
+    return "uint8_t";
+  case CDD_FFI_KIND_INT16:
+    return "int16_t";
+  case CDD_FFI_KIND_UINT16:
+    return "uint16_t";
+  case CDD_FFI_KIND_INT32:
+    return "int32_t";
+  case CDD_FFI_KIND_UINT32:
+    return "uint32_t";
+  case CDD_FFI_KIND_INT64:
+    return "int64_t";
+  case CDD_FFI_KIND_UINT64:
+    return "uint64_t";
+  case CDD_FFI_KIND_FLOAT32:
+    return "float";
+  case CDD_FFI_KIND_FLOAT64:
+    return "double";
+  default:
+    return NULL;
+  }
+}
+
+static int is_scalar(const cdd_ffi_type_t *type) {
+  return type->pointer_depth == 0 && !type->ref_name &&
+         napi_c_scalar(type->kind) != NULL;
+}
+
+/** @brief Index of the buffer parameter whose length is parameter `k`. */
+static long buffer_of_length(const cdd_ffi_ir_node_t *fn, size_t k) {
+  size_t j;
+  for (j = 0; j < fn->fields_count; j++) {
+    if (cdd_ffi_buffer_length_index(fn, j) == (long)k)
+      return (long)j;
+  }
+  return -1;
+}
+
+/**
+ * @brief Whether `fn` can be wrapped completely: every parameter is a
+ * numeric scalar or a buffer of scalars with its length, and it returns
+ * nothing or a numeric scalar.
+ */
+static int is_direct_callable(const cdd_ffi_ir_node_t *fn) {
+  size_t j;
+  if (fn->is_variadic || fn->requires_gil_release)
+    return 0;
+  if (fn->return_or_base_type.kind != CDD_FFI_KIND_VOID ||
+      fn->return_or_base_type.pointer_depth != 0) {
+    if (!is_scalar(&fn->return_or_base_type))
+      return 0;
+  }
+  for (j = 0; j < fn->fields_count; j++) {
+    const cdd_ffi_field_t *p = &fn->fields[j];
+    if (!p->name)
+      return 0;
+    if (cdd_ffi_buffer_length_index(fn, j) >= 0) {
+      if (p->type.ref_name || (p->type.kind != CDD_FFI_KIND_VOID &&
+                               !napi_c_scalar(p->type.kind)))
+        return 0;
+    } else if (!is_scalar(&p->type)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+ * @brief Emits the body of a wrapper that converts each argument and calls
+ * the C function. Buffer arguments point straight into the JS memory.
+ */
+static void emit_direct_wrapper(FILE *f, const cdd_ffi_ir_node_t *fn) {
+  size_t j, argc = 0;
+  const cdd_ffi_type_t *ret = &fn->return_or_base_type;
+  int has_ret = ret->kind != CDD_FFI_KIND_VOID || ret->pointer_depth != 0;
+
+  for (j = 0; j < fn->fields_count; j++) {
+    if (buffer_of_length(fn, j) < 0)
+      argc++;
+  }
+  if (argc > 0) {
+    fprintf(f, "  size_t argc = %" CDD_PRIz ";\n", argc);
+    fprintf(f, "  napi_value argv[%" CDD_PRIz "];\n", argc);
+  }
+  for (j = 0; j < fn->fields_count; j++) {
+    const cdd_ffi_field_t *p = &fn->fields[j];
+    if (buffer_of_length(fn, j) >= 0)
+      continue;
+    if (cdd_ffi_buffer_length_index(fn, j) >= 0) {
+      fprintf(f, "  void *%s_data = NULL;\n", p->name);
+      fprintf(f, "  size_t %s_bytes = 0;\n", p->name);
+    } else if (p->type.kind == CDD_FFI_KIND_BOOL) {
+      fprintf(f, "  bool %s_val;\n", p->name);
+    } else if (p->type.kind == CDD_FFI_KIND_FLOAT32 ||
+               p->type.kind == CDD_FFI_KIND_FLOAT64) {
+      fprintf(f, "  double %s_val;\n", p->name);
+    } else if (p->type.kind == CDD_FFI_KIND_UINT32) {
+      fprintf(f, "  uint32_t %s_val;\n", p->name);
+    } else if (p->type.kind == CDD_FFI_KIND_INT64 ||
+               p->type.kind == CDD_FFI_KIND_UINT64) {
+      fprintf(f, "  int64_t %s_val;\n", p->name);
+    } else {
+      fprintf(f, "  int32_t %s_val;\n", p->name);
+    }
+  }
+  if (has_ret)
+    fprintf(f, "  %s res;\n", napi_c_scalar(ret->kind));
+  fprintf(f, "  napi_value result;\n");
+
+  if (argc > 0)
+    fprintf(f, "  NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, "
+               "NULL, NULL));\n");
+  else
+    fprintf(f, "  NAPI_CALL(env, napi_get_cb_info(env, info, NULL, NULL, "
+               "NULL, NULL));\n");
+
+  argc = 0;
+  for (j = 0; j < fn->fields_count; j++) {
+    const cdd_ffi_field_t *p = &fn->fields[j];
+    const char *getter = "napi_get_value_int32";
+    if (buffer_of_length(fn, j) >= 0)
+      continue;
+    if (cdd_ffi_buffer_length_index(fn, j) >= 0) {
+      fprintf(f,
+              "  if (!cdd_napi_buffer(env, argv[%" CDD_PRIz "], &%s_data, "
+              "&%s_bytes)) {\n",
+              argc++, p->name, p->name);
+      fprintf(f,
+              "    napi_throw_type_error(env, NULL, \"%s: expected a "
+              "TypedArray, DataView or ArrayBuffer\");\n",
+              p->name);
+      fprintf(f, "    return NULL;\n");
+      fprintf(f, "  }\n");
+      continue;
+    }
+    if (p->type.kind == CDD_FFI_KIND_BOOL)
+      getter = "napi_get_value_bool";
+    else if (p->type.kind == CDD_FFI_KIND_FLOAT32 ||
+             p->type.kind == CDD_FFI_KIND_FLOAT64)
+      getter = "napi_get_value_double";
+    else if (p->type.kind == CDD_FFI_KIND_UINT32)
+      getter = "napi_get_value_uint32";
+    else if (p->type.kind == CDD_FFI_KIND_INT64 ||
+             p->type.kind == CDD_FFI_KIND_UINT64)
+      getter = "napi_get_value_int64";
+    fprintf(f, "  NAPI_CALL(env, %s(env, argv[%" CDD_PRIz "], &%s_val));\n",
+            getter, argc++, p->name);
+  }
+
+  fprintf(f, "\n  %s%s(", has_ret ? "res = " : "", fn->name);
+  for (j = 0; j < fn->fields_count; j++) {
+    const cdd_ffi_field_t *p = &fn->fields[j];
+    long b = buffer_of_length(fn, j);
+    if (j > 0)
+      fprintf(f, ", ");
+    if (b >= 0) {
+      const cdd_ffi_field_t *buf = &fn->fields[b];
+      if (buf->type.kind == CDD_FFI_KIND_VOID)
+        fprintf(f, "(%s)%s_bytes", napi_c_scalar(p->type.kind), buf->name);
+      else
+        fprintf(f, "(%s)(%s_bytes / sizeof(%s))", napi_c_scalar(p->type.kind),
+                buf->name, napi_c_scalar(buf->type.kind));
+    } else if (cdd_ffi_buffer_length_index(fn, j) >= 0) {
+      fprintf(f, "%s_data", p->name);
+    } else {
+      fprintf(f, "(%s)%s_val", napi_c_scalar(p->type.kind), p->name);
+    }
+  }
+  fprintf(f, ");\n");
+
+  if (!has_ret) {
+    fprintf(f, "  NAPI_CALL(env, napi_get_undefined(env, &result));\n");
+  } else if (ret->kind == CDD_FFI_KIND_BOOL) {
+    fprintf(f, "  NAPI_CALL(env, napi_get_boolean(env, res, &result));\n");
+  } else if (ret->kind == CDD_FFI_KIND_FLOAT32 ||
+             ret->kind == CDD_FFI_KIND_FLOAT64) {
+    fprintf(f, "  NAPI_CALL(env, napi_create_double(env, res, &result));\n");
+  } else if (ret->kind == CDD_FFI_KIND_UINT32) {
+    fprintf(f, "  NAPI_CALL(env, napi_create_uint32(env, res, &result));\n");
+  } else if (ret->kind == CDD_FFI_KIND_INT64 ||
+             ret->kind == CDD_FFI_KIND_UINT64) {
+    fprintf(f, "  NAPI_CALL(env, napi_create_int64(env, (int64_t)res, "
+               "&result));\n");
+  } else {
+    fprintf(f, "  NAPI_CALL(env, napi_create_int32(env, res, &result));\n");
+  }
+  fprintf(f, "  return result;\n");
+  fprintf(f, "}\n\n");
+}
+
 static cdd_c_error_t emit_napi_c(cdd_ffi_ir_t *ir,
                                  const cdd_generate_bindings_config_t *config) {
   char filepath[1024];
@@ -38,6 +235,7 @@ static cdd_c_error_t emit_napi_c(cdd_ffi_ir_t *ir,
   fprintf(f, "/* Auto-generated Node.js N-API bindings for %s */\n\n",
           lib_name);
   fprintf(f, "#include <node_api.h>\n");
+  fprintf(f, "#include <stdint.h>\n");
   fprintf(f, "#include <stdlib.h>\n");
   fprintf(f, "#include <string.h>\n ");
   fprintf(f, "#include \"%s\"\n\n", config->input);
@@ -92,6 +290,56 @@ static cdd_c_error_t emit_napi_c(cdd_ffi_ir_t *ir,
       "    }                                                             \\\n");
   fprintf(f, "  } while(0)\n\n");
 
+  fprintf(f, "/* Points at the memory behind a TypedArray, DataView or "
+             "ArrayBuffer; no copy */\n");
+  fprintf(f, "static int cdd_napi_buffer(napi_env env, napi_value value, "
+             "void **data,\n");
+  fprintf(f, "                           size_t *byte_length) {\n");
+  fprintf(f, "  bool is_typed = false, is_view = false, is_ab = false;\n");
+  fprintf(f, "  napi_value ab;\n");
+  fprintf(f, "  size_t offset;\n");
+  fprintf(f, "  if (napi_is_typedarray(env, value, &is_typed) == napi_ok && "
+             "is_typed) {\n");
+  fprintf(f, "    napi_typedarray_type type;\n");
+  fprintf(f, "    size_t length, elem = 1;\n");
+  fprintf(f, "    if (napi_get_typedarray_info(env, value, &type, &length, "
+             "data, &ab,\n");
+  fprintf(f, "                                 &offset) != napi_ok)\n");
+  fprintf(f, "      return 0;\n");
+  fprintf(f, "    switch (type) {\n");
+  fprintf(f, "    case napi_int16_array:\n");
+  fprintf(f, "    case napi_uint16_array:\n");
+  fprintf(f, "      elem = 2;\n");
+  fprintf(f, "      break;\n");
+  fprintf(f, "    case napi_int32_array:\n");
+  fprintf(f, "    case napi_uint32_array:\n");
+  fprintf(f, "    case napi_float32_array:\n");
+  fprintf(f, "      elem = 4;\n");
+  fprintf(f, "      break;\n");
+  fprintf(f, "    case napi_float64_array:\n");
+  fprintf(f, "    case napi_bigint64_array:\n");
+  fprintf(f, "    case napi_biguint64_array:\n");
+  fprintf(f, "      elem = 8;\n");
+  fprintf(f, "      break;\n");
+  fprintf(f, "    default:\n");
+  fprintf(f, "      break;\n");
+  fprintf(f, "    }\n");
+  fprintf(f, "    *byte_length = length * elem;\n");
+  fprintf(f, "    return 1;\n");
+  fprintf(f, "  }\n");
+  fprintf(f, "  if (napi_is_dataview(env, value, &is_view) == napi_ok && "
+             "is_view)\n");
+  fprintf(f, "    return napi_get_dataview_info(env, value, byte_length, "
+             "data, &ab,\n");
+  fprintf(f, "                                  &offset) == napi_ok;\n");
+  fprintf(f, "  if (napi_is_arraybuffer(env, value, &is_ab) == napi_ok && "
+             "is_ab)\n");
+  fprintf(f, "    return napi_get_arraybuffer_info(env, value, data, "
+             "byte_length) ==\n");
+  fprintf(f, "           napi_ok;\n");
+  fprintf(f, "  return 0;\n");
+  fprintf(f, "}\n\n");
+
   for (i = 0; i < ir->nodes_count; i++) {
     cdd_ffi_ir_node_t *node = &ir->nodes[i];
     if (node->kind == CDD_FFI_NODE_FUNCTION) {
@@ -161,6 +409,11 @@ static cdd_c_error_t emit_napi_c(cdd_ffi_ir_t *ir,
         continue;
       }
 
+      if (is_direct_callable(node)) {
+        emit_direct_wrapper(f, node);
+        continue;
+      }
+
       if (node->fields_count > 0) {
         fprintf(f, "  size_t argc = %" CDD_PRIz ";\n", node->fields_count);
         fprintf(f, "  napi_value argv[%" CDD_PRIz "];\n", node->fields_count);
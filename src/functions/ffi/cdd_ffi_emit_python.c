@@ -78,6 +78,44 @@ static void emit_type(FILE *f, const cdd_ffi_type_t *type) {
   fprintf(f, "%s", get_ctypes_primitive(type->kind));
 }
 
+/**
+ * @brief Index of the length parameter when parameter `j` is taken as a
+ * zero-copy buffer (anything exporting the buffer protocol), or -1.
+ */
+static long view_length_index(const cdd_ffi_ir_node_t *fn, size_t j) {
+  const cdd_ffi_field_t *p = &fn->fields[j];
+  if (fn->is_variadic || !p->name || p->intent == CDD_FFI_INTENT_OUT ||
+      p->type.kind > CDD_FFI_KIND_FLOAT64)
+    return -1;
+  return cdd_ffi_buffer_length_index(fn, j);
+}
+
+static int is_view_length(const cdd_ffi_ir_node_t *fn, size_t k) {
+  size_t j;
+  for (j = 0; j < fn->fields_count; j++) {
+    if (view_length_index(fn, j) == (long)k)
+      return 1;
+  }
+  return 0;
+}
+
+/** @brief Whether parameter `j` is passed by reference and returned. */
+static int is_out_slot(const cdd_ffi_ir_node_t *fn, size_t j) {
+  return (fn->fields[j].intent == CDD_FFI_INTENT_OUT ||
+          fn->fields[j].intent == CDD_FFI_INTENT_INOUT) &&
+         view_length_index(fn, j) < 0;
+}
+
+/** @brief ctypes element type of buffer parameter `p`. */
+static void emit_elem_type(FILE *f, const cdd_ffi_field_t *p) {
+  cdd_ffi_type_t base_t = p->type;
+  base_t.pointer_depth--;
+  if (base_t.kind == CDD_FFI_KIND_VOID)
+    fprintf(f, "ctypes.c_uint8");
+  else
+    emit_type(f, &base_t);
+}
+
 enum cdd_c_error
 cdd_ffi_emit_python(cdd_ffi_ir_t *ir,
                     const cdd_generate_bindings_config_t *config) {
@@ -147,6 +185,27 @@ cdd_ffi_emit_python(cdd_ffi_ir_t *ir,
 
   fprintf(f, "lib = _load_library()\n\n");
 
+  fprintf(f, "def _cdd_buffer(obj, ctype):\n");
+  fprintf(f, "    \"\"\"(pointer, element count, keepalive) for any "
+             "C-contiguous buffer,\n");
+  fprintf(f, "    without copying unless it is read-only and not "
+             "bytes.\"\"\"\n");
+  fprintf(f, "    if obj is None:\n");
+  fprintf(f, "        return None, 0, None\n");
+  fprintf(f, "    view = memoryview(obj)\n");
+  fprintf(f, "    if not view.c_contiguous:\n");
+  fprintf(f, "        raise BufferError('buffer must be C-contiguous')\n");
+  fprintf(f, "    count = view.nbytes // ctypes.sizeof(ctype)\n");
+  fprintf(f, "    if not view.readonly:\n");
+  fprintf(f, "        arr = (ctype * count).from_buffer(view.cast('B'))\n");
+  fprintf(f, "        return arr, count, (arr, view)\n");
+  fprintf(f, "    if isinstance(obj, bytes):\n");
+  fprintf(f, "        ptr = ctypes.cast(ctypes.c_char_p(obj), "
+             "ctypes.POINTER(ctype))\n");
+  fprintf(f, "        return ptr, count, obj\n");
+  fprintf(f, "    arr = (ctype * count).from_buffer_copy(view)\n");
+  fprintf(f, "    return arr, count, arr\n\n");
+
   fprintf(f, "class CddFfiError(ctypes.Structure):\n");
   fprintf(f, "    _fields_ = [\n");
   fprintf(f, "        ('code', ctypes.c_int),\n");
@@ -304,7 +363,9 @@ cdd_ffi_emit_python(cdd_ffi_ir_t *ir,
         int first_arg = 1;
         fprintf(f, "    def %s(", node->name);
         for (j = 0; j < node->fields_count; j++) {
-          if (node->fields[j].intent != CDD_FFI_INTENT_OUT) {
+          if ((node->fields[j].intent != CDD_FFI_INTENT_OUT ||
+               view_length_index(node, j) >= 0) &&
+              !is_view_length(node, j)) {
             const char *arg_name =
                 node->fields[j].name ? node->fields[j].name : "arg";
             if (!first_arg)
@@ -316,8 +377,13 @@ cdd_ffi_emit_python(cdd_ffi_ir_t *ir,
         fprintf(f, "):\n");
 
         for (j = 0; j < node->fields_count; j++) {
-          if (node->fields[j].intent == CDD_FFI_INTENT_OUT ||
-              node->fields[j].intent == CDD_FFI_INTENT_INOUT) {
+          if (view_length_index(node, j) >= 0) {
+            fprintf(f, "        _%s_ptr, _%s_len, _%s_keep = _cdd_buffer(%s, ",
+                    node->fields[j].name, node->fields[j].name,
+                    node->fields[j].name, node->fields[j].name);
+            emit_elem_type(f, &node->fields[j]);
+            fprintf(f, ")\n");
+          } else if (is_out_slot(node, j)) {
             if (node->fields[j].array_length_ref) {
               cdd_ffi_type_t base_t;
               fprintf(f, "        out_%s = (", node->fields[j].name);
@@ -345,8 +411,24 @@ cdd_ffi_emit_python(cdd_ffi_ir_t *ir,
         fprintf(f, "        err = CddFfiError()\n");
         fprintf(f, "        res = _%s(", node->name);
         for (j = 0; j < node->fields_count; j++) {
-          if (node->fields[j].intent == CDD_FFI_INTENT_OUT ||
-              node->fields[j].intent == CDD_FFI_INTENT_INOUT) {
+          size_t b;
+          int is_len = 0;
+          for (b = 0; b < node->fields_count; b++) {
+            if (view_length_index(node, b) == (long)j) {
+              fprintf(f, "_%s_len, ", node->fields[b].name);
+              is_len = 1;
+              break;
+            }
+          }
+          if (is_len)
+            continue;
+          if (view_length_index(node, j) >= 0) {
+            fprintf(f, "_%s_ptr, ", node->fields[j].name);
+          } else if (is_out_slot(node, j) &&
+                     node->fields[j].array_length_ref) {
+            /* A ctypes array already converts to a pointer */
+            fprintf(f, "out_%s, ", node->fields[j].name);
+          } else if (is_out_slot(node, j)) {
             fprintf(f, "ctypes.byref(out_%s), ", node->fields[j].name);
           } else {
             const char *arg_name =
@@ -364,8 +446,7 @@ cdd_ffi_emit_python(cdd_ffi_ir_t *ir,
       {
         int out_count = 0;
         for (j = 0; j < node->fields_count; j++) {
-          if (node->fields[j].intent == CDD_FFI_INTENT_OUT ||
-              node->fields[j].intent == CDD_FFI_INTENT_INOUT) {
+          if (is_out_slot(node, j)) {
             out_count++;
           }
         }
@@ -375,9 +456,11 @@ cdd_ffi_emit_python(cdd_ffi_ir_t *ir,
             fprintf(f, "res, ");
           }
           for (j = 0; j < node->fields_count; j++) {
-            if (node->fields[j].intent == CDD_FFI_INTENT_OUT ||
-                node->fields[j].intent == CDD_FFI_INTENT_INOUT) {
-              if (node->fields[j].array_length_ref) {
+            if (is_out_slot(node, j)) {
+              if (cdd_ffi_buffer_length_index(node, j) >= 0) {
+                /* The ctypes array itself exports the buffer protocol */
+                fprintf(f, "out_%s, ", node->fields[j].name);
+              } else if (node->fields[j].array_length_ref) {
                 fprintf(f, "list(out_%s), ", node->fields[j].name);
               } else {
                 fprintf(f, "out_%s.value, ", node->fields[j].name);
@@ -0,0 +1,1151 @@
+extern volatile int g_fail_io_after;
+/* clang-format off */
+#include "cdd_ffi_emit_python_capi.h"
+#include "cdd_ffi_layout.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include "c_cdd/format_specifiers.h"
+#include "c_cdd/safe_crt.h"
+/* clang-format on */
+
+/** @brief How a value crosses the Python/C boundary. */
+typedef enum capi_conv_t {
+  CAPI_CONV_NONE,     /**< Not representable: the function is skipped */
+  CAPI_CONV_VOID,     /**< No value */
+  CAPI_CONV_BOOL,     /**< Any object, via truth testing */
+  CAPI_CONV_SIGNED,   /**< int, range checked against the C type */
+  CAPI_CONV_UNSIGNED, /**< int, range checked against the C type */
+  CAPI_CONV_DOUBLE,   /**< float (or int) */
+  CAPI_CONV_CSTRING,  /**< const char *: str/bytes/None in, bytes out */
+  CAPI_CONV_POINTER,  /**< None, int address or buffer-protocol object */
+  CAPI_CONV_RECORD,   /**< Struct or union by value */
+  CAPI_CONV_OUT       /**< Scalar written through a pointer, returned */
+} capi_conv_t;
+
+/** @brief Generated helpers a module needs. */
+enum {
+  CAPI_USE_SIGNED = 1,
+  CAPI_USE_UNSIGNED = 2,
+  CAPI_USE_DOUBLE = 4,
+  CAPI_USE_BOOL = 8,
+  CAPI_USE_CSTRING_IN = 16,
+  CAPI_USE_CSTRING_OUT = 32,
+  CAPI_USE_POINTER = 64
+};
+
+static const char *record_ident(const char *name) {
+  if (strncmp(name, "struct ", 7) == 0)
+    return name + 7;
+  if (strncmp(name, "union ", 6) == 0)
+    return name + 6;
+  return name;
+}
+
+/**
+ * @brief Records that can be embedded in a Python object. C++ classes and
+ * template instances have no C spelling the extension could use.
+ */
+static int is_exportable_record(const cdd_ffi_ir_node_t *node) {
+  return (node->kind == CDD_FFI_NODE_STRUCT ||
+          node->kind == CDD_FFI_NODE_UNION) &&
+         node->name && node->base_classes_count == 0 &&
+         node->virtual_methods_count == 0 && !strchr(node->name, '<') &&
+         !strchr(node->name, ':');
+}
+
+static const cdd_ffi_ir_node_t *find_record(const cdd_ffi_ir_t *ir,
+                                            const char *name) {
+  size_t i;
+  if (!name)
+    return NULL;
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    if (is_exportable_record(node) &&
+        strcmp(record_ident(node->name), record_ident(name)) == 0)
+      return node;
+  }
+  return NULL;
+}
+
+static const cdd_ffi_ir_node_t *find_typedef(const cdd_ffi_ir_t *ir,
+                                             const char *name) {
+  size_t i;
+  if (!name)
+    return NULL;
+  for (i = 0; i < ir->nodes_count; i++) {
+    if (ir->nodes[i].kind == CDD_FFI_NODE_TYPEDEF && ir->nodes[i].name &&
+        strcmp(ir->nodes[i].name, name) == 0)
+      return &ir->nodes[i];
+  }
+  return NULL;
+}
+
+static capi_conv_t scalar_conv(cdd_ffi_primitive_kind_t kind) {
+  switch (kind) {
+  case CDD_FFI_KIND_VOID:
+    return CAPI_CONV_VOID;
+  case CDD_FFI_KIND_BOOL:
+    return CAPI_CONV_BOOL;
+  case CDD_FFI_KIND_INT8:
+  case CDD_FFI_KIND_INT16:
+  case CDD_FFI_KIND_INT32:
+  case CDD_FFI_KIND_INT64:
+  case CDD_FFI_KIND_ENUM_REF:
+    return CAPI_CONV_SIGNED;
+  case CDD_FFI_KIND_UINT8:
+  case CDD_FFI_KIND_UINT16:
+  case CDD_FFI_KIND_UINT32:
+  case CDD_FFI_KIND_UINT64:
+    return CAPI_CONV_UNSIGNED;
+  case CDD_FFI_KIND_FLOAT32:
+  case CDD_FFI_KIND_FLOAT64:
+    return CAPI_CONV_DOUBLE;
+  default:
+    return CAPI_CONV_NONE;
+  }
+}
+
+/**
+ * @brief Classify a type, resolving typedefs through the IR.
+ * @param ir The IR.
+ * @param type The type.
+ * @param extra_depth Pointer levels added by enclosing typedefs.
+ * @param[out] out_record The record for CAPI_CONV_RECORD.
+ * @return The conversion.
+ */
+static capi_conv_t classify(const cdd_ffi_ir_t *ir, const cdd_ffi_type_t *type,
+                            int extra_depth,
+                            const cdd_ffi_ir_node_t **out_record) {
+  int depth = type->pointer_depth + extra_depth + (type->array_size > 0);
+
+  *out_record = NULL;
+  switch (type->kind) {
+  case CDD_FFI_KIND_FUNCTION_PTR:
+  case CDD_FFI_KIND_TEMPLATE_STRUCT_REF:
+  case CDD_FFI_KIND_STD_STRING:
+  case CDD_FFI_KIND_STD_VECTOR:
+  case CDD_FFI_KIND_STD_SHARED_PTR:
+  case CDD_FFI_KIND_STD_UNIQUE_PTR:
+    return CAPI_CONV_NONE;
+  case CDD_FFI_KIND_TYPEDEF_REF: {
+    const cdd_ffi_ir_node_t *td = find_typedef(ir, type->ref_name);
+    if (td && td->return_or_base_type.kind != CDD_FFI_KIND_TYPEDEF_REF)
+      return classify(ir, &td->return_or_base_type, depth, out_record);
+    if (!td && (*out_record = find_record(ir, type->ref_name)) != NULL)
+      return depth == 0 ? CAPI_CONV_RECORD : CAPI_CONV_POINTER;
+    return depth > 0 ? CAPI_CONV_POINTER : CAPI_CONV_NONE;
+  }
+  default:
+    break;
+  }
+
+  if (depth == 0) {
+    if (type->kind == CDD_FFI_KIND_STRUCT_REF) {
+      *out_record = find_record(ir, type->ref_name);
+      return *out_record ? CAPI_CONV_RECORD : CAPI_CONV_NONE;
+    }
+    if (type->kind == CDD_FFI_KIND_OPAQUE_PTR)
+      return CAPI_CONV_POINTER;
+    return scalar_conv(type->kind);
+  }
+  if (depth == 1 && type->is_const &&
+      (type->kind == CDD_FFI_KIND_INT8 || type->kind == CDD_FFI_KIND_UINT8))
+    return CAPI_CONV_CSTRING;
+  return CAPI_CONV_POINTER;
+}
+
+/** @brief C spelling of a scalar written through an out-pointer. */
+static const char *out_ctype(cdd_ffi_primitive_kind_t kind) {
+  switch (kind) {
+  case CDD_FFI_KIND_INT16:
+    return "int16_t";
+  case CDD_FFI_KIND_UINT16:
+    return "uint16_t";
+  case CDD_FFI_KIND_INT32:
+    return "int32_t";
+  case CDD_FFI_KIND_UINT32:
+    return "uint32_t";
+  case CDD_FFI_KIND_INT64:
+    return "int64_t";
+  case CDD_FFI_KIND_UINT64:
+    return "uint64_t";
+  case CDD_FFI_KIND_FLOAT32:
+    return "float";
+  case CDD_FFI_KIND_FLOAT64:
+    return "double";
+  default:
+    return NULL;
+  }
+}
+
+static int is_out_param(const cdd_ffi_field_t *field) {
+  return (field->intent == CDD_FFI_INTENT_OUT ||
+          field->intent == CDD_FFI_INTENT_INOUT) &&
+         field->type.pointer_depth == 1 && field->type.array_size <= 0 &&
+         !field->array_length_ref && out_ctype(field->type.kind) != NULL;
+}
+
+static capi_conv_t param_conv(const cdd_ffi_ir_t *ir,
+                              const cdd_ffi_field_t *field,
+                              const cdd_ffi_ir_node_t **out_record) {
+  *out_record = NULL;
+  if (is_out_param(field))
+    return CAPI_CONV_OUT;
+  return classify(ir, &field->type, 0, out_record);
+}
+
+/** @brief Number of Python-level arguments a parameter consumes. */
+static int takes_arg(const cdd_ffi_field_t *field, capi_conv_t conv) {
+  if (conv == CAPI_CONV_VOID)
+    return 0;
+  return conv != CAPI_CONV_OUT || field->intent == CDD_FFI_INTENT_INOUT;
+}
+
+static unsigned conv_uses(capi_conv_t conv, int is_return) {
+  switch (conv) {
+  case CAPI_CONV_SIGNED:
+    return is_return ? 0 : CAPI_USE_SIGNED;
+  case CAPI_CONV_UNSIGNED:
+    return is_return ? 0 : CAPI_USE_UNSIGNED;
+  case CAPI_CONV_DOUBLE:
+    return is_return ? 0 : CAPI_USE_DOUBLE;
+  case CAPI_CONV_BOOL:
+    return is_return ? 0 : CAPI_USE_BOOL;
+  case CAPI_CONV_CSTRING:
+    return is_return ? CAPI_USE_CSTRING_OUT : CAPI_USE_CSTRING_IN;
+  case CAPI_CONV_POINTER:
+    return is_return ? 0 : CAPI_USE_POINTER;
+  default:
+    return 0;
+  }
+}
+
+/**
+ * @brief Whether a function can be wrapped, and which helpers it needs.
+ */
+static int function_supported(const cdd_ffi_ir_t *ir,
+                              const cdd_ffi_ir_node_t *node,
+                              unsigned *uses) {
+  const cdd_ffi_ir_node_t *record;
+  capi_conv_t conv;
+  unsigned need;
+  size_t j;
+
+  if (node->kind != CDD_FFI_NODE_FUNCTION || !node->name ||
+      node->is_variadic || strchr(node->name, ':'))
+    return 0;
+  conv = classify(ir, &node->return_or_base_type, 0, &record);
+  if (conv == CAPI_CONV_NONE)
+    return 0;
+  need = conv_uses(conv, 1);
+  for (j = 0; j < node->fields_count; j++) {
+    const cdd_ffi_field_t *field = &node->fields[j];
+    conv = param_conv(ir, field, &record);
+    if (conv == CAPI_CONV_NONE)
+      return 0;
+    if (conv == CAPI_CONV_OUT) {
+      if (field->intent == CDD_FFI_INTENT_INOUT)
+        need |= conv_uses(scalar_conv(field->type.kind), 0);
+    } else {
+      need |= conv_uses(conv, 0);
+    }
+  }
+  if (uses)
+    *uses |= need;
+  return 1;
+}
+
+/**
+ * @brief Benchmark candidates: every argument is a plain number.
+ */
+static int is_bench_candidate(const cdd_ffi_ir_t *ir,
+                              const cdd_ffi_ir_node_t *node) {
+  const cdd_ffi_ir_node_t *record;
+  size_t j;
+  if (!function_supported(ir, node, NULL))
+    return 0;
+  for (j = 0; j < node->fields_count; j++) {
+    capi_conv_t conv = param_conv(ir, &node->fields[j], &record);
+    if (conv != CAPI_CONV_SIGNED && conv != CAPI_CONV_UNSIGNED &&
+        conv != CAPI_CONV_DOUBLE && conv != CAPI_CONV_BOOL &&
+        conv != CAPI_CONV_VOID)
+      return 0;
+  }
+  return 1;
+}
+
+/** @brief Write `name` with anything but [A-Za-z0-9_] replaced. */
+static void capi_ident(char *out, size_t out_size, const char *name) {
+  size_t i = 0;
+  if (out_size == 0)
+    return;
+  for (; name[i] && i + 1 < out_size; i++) {
+    char c = name[i];
+    out[i] = ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+              (c >= '0' && c <= '9') || c == '_')
+                 ? c
+                 : '_';
+  }
+  out[i] = '\0';
+}
+
+static FILE *capi_open(const cdd_generate_bindings_config_t *config,
+                       const char *prefix, const char *module,
+                       const char *suffix, int fail_at) {
+  char filepath[1024];
+  FILE *f = NULL;
+
+#if defined(_MSC_VER)
+  CDD_SNPRINTF(filepath, sizeof(filepath), "%s\\%s%s%s", config->output_dir,
+               prefix, module, suffix);
+  if (fopen_s(&f, filepath, "w") != 0)
+    f = NULL;
+#else
+  CDD_SNPRINTF(filepath, sizeof(filepath), "%s/%s%s%s", config->output_dir,
+               prefix, module, suffix);
+  f = fopen(filepath, "w");
+#endif
+  if (f && g_fail_io_after == fail_at) {
+    fclose(f);
+    f = NULL;
+  }
+  return f;
+}
+
+/** @brief Range arguments for cdd_capi_signed()/cdd_capi_unsigned(). */
+static const char *range_args(cdd_ffi_primitive_kind_t kind) {
+  switch (kind) {
+  case CDD_FFI_KIND_INT8:
+    return "-128, 127";
+  case CDD_FFI_KIND_INT16:
+    return "-32768, 32767";
+  case CDD_FFI_KIND_INT32:
+  case CDD_FFI_KIND_ENUM_REF:
+    return "INT_MIN, INT_MAX";
+  case CDD_FFI_KIND_UINT8:
+    return "255";
+  case CDD_FFI_KIND_UINT16:
+    return "65535";
+  case CDD_FFI_KIND_UINT32:
+    return "UINT_MAX";
+  case CDD_FFI_KIND_UINT64:
+    return "ULLONG_MAX";
+  default:
+    return "LLONG_MIN, LLONG_MAX";
+  }
+}
+
+/** @brief C type holding a converted argument or return value. */
+static const char *local_ctype(capi_conv_t conv) {
+  switch (conv) {
+  case CAPI_CONV_SIGNED:
+    return "long long ";
+  case CAPI_CONV_UNSIGNED:
+    return "unsigned long long ";
+  case CAPI_CONV_DOUBLE:
+    return "double ";
+  case CAPI_CONV_BOOL:
+    return "int ";
+  case CAPI_CONV_CSTRING:
+    return "const char *";
+  case CAPI_CONV_POINTER:
+    return "void *";
+  default:
+    return NULL;
+  }
+}
+
+/** @brief Print the call converting a Python object into local `var`. */
+static void emit_from_py(FILE *f, capi_conv_t conv, const cdd_ffi_type_t *type,
+                         size_t arg, const char *var, size_t j,
+                         const char *fail) {
+  switch (conv) {
+  case CAPI_CONV_SIGNED:
+    fprintf(f, "  if (cdd_capi_signed(args[%" CDD_PRIz "], %s, &%s%" CDD_PRIz
+               ") < 0)\n",
+            arg, range_args(type->kind), var, j);
+    break;
+  case CAPI_CONV_UNSIGNED:
+    fprintf(f, "  if (cdd_capi_unsigned(args[%" CDD_PRIz "], %s, &%s%" CDD_PRIz
+               ") < 0)\n",
+            arg, range_args(type->kind), var, j);
+    break;
+  case CAPI_CONV_DOUBLE:
+    fprintf(f, "  if (cdd_capi_double(args[%" CDD_PRIz "], &%s%" CDD_PRIz
+               ") < 0)\n",
+            arg, var, j);
+    break;
+  case CAPI_CONV_BOOL:
+    fprintf(f, "  if (cdd_capi_bool(args[%" CDD_PRIz "], &%s%" CDD_PRIz
+               ") < 0)\n",
+            arg, var, j);
+    break;
+  case CAPI_CONV_CSTRING:
+    fprintf(f, "  if (cdd_capi_cstring(args[%" CDD_PRIz "], &%s%" CDD_PRIz
+               ") < 0)\n",
+            arg, var, j);
+    break;
+  case CAPI_CONV_POINTER:
+    fprintf(f, "  if (cdd_capi_pointer(args[%" CDD_PRIz "], %d, &v%" CDD_PRIz
+               ", &%s%" CDD_PRIz ") < 0)\n",
+            arg, !type->is_const, j, var, j);
+    break;
+  default:
+    return;
+  }
+  fprintf(f, "    %s;\n", fail);
+}
+
+/** @brief Print a new reference to the Python value of `expr`. */
+static void emit_to_py(FILE *f, capi_conv_t conv, const char *expr, size_t j) {
+  switch (conv) {
+  case CAPI_CONV_BOOL:
+    fprintf(f, "PyBool_FromLong(%s", expr);
+    break;
+  case CAPI_CONV_SIGNED:
+    fprintf(f, "PyLong_FromLongLong((long long)%s", expr);
+    break;
+  case CAPI_CONV_UNSIGNED:
+    fprintf(f, "PyLong_FromUnsignedLongLong((unsigned long long)%s", expr);
+    break;
+  case CAPI_CONV_DOUBLE:
+    fprintf(f, "PyFloat_FromDouble((double)%s", expr);
+    break;
+  case CAPI_CONV_CSTRING:
+    fprintf(f, "cdd_capi_from_cstring(%s", expr);
+    break;
+  case CAPI_CONV_POINTER:
+    fprintf(f, "PyLong_FromVoidPtr(%s", expr);
+    break;
+  case CAPI_CONV_RECORD:
+    fprintf(f, "(PyObject *)(%s", expr);
+    break;
+  default:
+    fprintf(f, "(PyObject *)(NULL");
+    break;
+  }
+  if (j != (size_t)-1)
+    fprintf(f, "%" CDD_PRIz, j);
+  fprintf(f, ")");
+}
+
+static void emit_helpers(FILE *f, unsigned uses) {
+  if (uses & CAPI_USE_SIGNED) {
+    fprintf(f, "static int cdd_capi_signed(PyObject *o, long long lo, "
+               "long long hi,\n"
+               "                           long long *out) {\n"
+               "  long long v = PyLong_AsLongLong(o);\n"
+               "  if (v == -1 && PyErr_Occurred())\n"
+               "    return -1;\n"
+               "  if (v < lo || v > hi) {\n"
+               "    PyErr_SetString(PyExc_OverflowError, "
+               "\"integer out of range\");\n"
+               "    return -1;\n"
+               "  }\n"
+               "  *out = v;\n"
+               "  return 0;\n"
+               "}\n\n");
+  }
+  if (uses & CAPI_USE_UNSIGNED) {
+    fprintf(f, "static int cdd_capi_unsigned(PyObject *o, "
+               "unsigned long long hi,\n"
+               "                             unsigned long long *out) {\n"
+               "  unsigned long long v = PyLong_AsUnsignedLongLong(o);\n"
+               "  if (v == (unsigned long long)-1 && PyErr_Occurred())\n"
+               "    return -1;\n"
+               "  if (v > hi) {\n"
+               "    PyErr_SetString(PyExc_OverflowError, "
+               "\"integer out of range\");\n"
+               "    return -1;\n"
+               "  }\n"
+               "  *out = v;\n"
+               "  return 0;\n"
+               "}\n\n");
+  }
+  if (uses & CAPI_USE_DOUBLE) {
+    fprintf(f, "static int cdd_capi_double(PyObject *o, double *out) {\n"
+               "  double v = PyFloat_AsDouble(o);\n"
+               "  if (v == -1.0 && PyErr_Occurred())\n"
+               "    return -1;\n"
+               "  *out = v;\n"
+               "  return 0;\n"
+               "}\n\n");
+  }
+  if (uses & CAPI_USE_BOOL) {
+    fprintf(f, "static int cdd_capi_bool(PyObject *o, int *out) {\n"
+               "  int v = PyObject_IsTrue(o);\n"
+               "  if (v < 0)\n"
+               "    return -1;\n"
+               "  *out = v;\n"
+               "  return 0;\n"
+               "}\n\n");
+  }
+  if (uses & CAPI_USE_CSTRING_IN) {
+    fprintf(f, "static int cdd_capi_cstring(PyObject *o, const char **out) "
+               "{\n"
+               "  if (o == Py_None) {\n"
+               "    *out = NULL;\n"
+               "    return 0;\n"
+               "  }\n"
+               "  if (PyUnicode_Check(o)) {\n"
+               "    *out = PyUnicode_AsUTF8(o);\n"
+               "    return *out ? 0 : -1;\n"
+               "  }\n"
+               "  if (PyBytes_Check(o)) {\n"
+               "    *out = PyBytes_AS_STRING(o);\n"
+               "    return 0;\n"
+               "  }\n"
+               "  PyErr_SetString(PyExc_TypeError, "
+               "\"expected str, bytes or None\");\n"
+               "  return -1;\n"
+               "}\n\n");
+  }
+  if (uses & CAPI_USE_CSTRING_OUT) {
+    fprintf(f, "static PyObject *cdd_capi_from_cstring(const char *s) {\n"
+               "  if (!s)\n"
+               "    Py_RETURN_NONE;\n"
+               "  return PyBytes_FromString(s);\n"
+               "}\n\n");
+  }
+  if (uses & CAPI_USE_POINTER) {
+    fprintf(f, "/* None, an integer address, or anything exporting a buffer "
+               "(bytearray,\n"
+               " * array.array, numpy arrays, the struct types below). */\n"
+               "static int cdd_capi_pointer(PyObject *o, int writable, "
+               "Py_buffer *view,\n"
+               "                            void **out) {\n"
+               "  if (o == Py_None) {\n"
+               "    *out = NULL;\n"
+               "    return 0;\n"
+               "  }\n"
+               "  if (PyLong_Check(o)) {\n"
+               "    *out = PyLong_AsVoidPtr(o);\n"
+               "    return PyErr_Occurred() ? -1 : 0;\n"
+               "  }\n"
+               "  if (PyObject_GetBuffer(o, view, writable ? PyBUF_WRITABLE "
+               ": PyBUF_SIMPLE) < 0)\n"
+               "    return -1;\n"
+               "  *out = view->buf;\n"
+               "  return 0;\n"
+               "}\n\n");
+  }
+  fprintf(f, "static int cdd_capi_add(PyObject *m, const char *name, "
+             "PyObject *value) {\n"
+             "  int rc;\n"
+             "  if (!value)\n"
+             "    return -1;\n"
+             "  rc = PyObject_SetAttrString(m, name, value);\n"
+             "  Py_DECREF(value);\n"
+             "  return rc;\n"
+             "}\n\n");
+}
+
+/** @brief PyMemberDef type code for a struct field, or NULL. */
+static const char *member_type(const cdd_ffi_type_t *type) {
+  if (type->pointer_depth != 0 || type->array_size != 0)
+    return NULL;
+  switch (type->kind) {
+  case CDD_FFI_KIND_BOOL:
+    return "T_BOOL";
+  case CDD_FFI_KIND_INT8:
+    return "T_BYTE";
+  case CDD_FFI_KIND_UINT8:
+    return "T_UBYTE";
+  case CDD_FFI_KIND_INT16:
+    return "T_SHORT";
+  case CDD_FFI_KIND_UINT16:
+    return "T_USHORT";
+  case CDD_FFI_KIND_INT32:
+  case CDD_FFI_KIND_ENUM_REF:
+    return "T_INT";
+  case CDD_FFI_KIND_UINT32:
+    return "T_UINT";
+  case CDD_FFI_KIND_INT64:
+    return "T_LONGLONG";
+  case CDD_FFI_KIND_UINT64:
+    return "T_ULONGLONG";
+  case CDD_FFI_KIND_FLOAT32:
+    return "T_FLOAT";
+  case CDD_FFI_KIND_FLOAT64:
+    return "T_DOUBLE";
+  default:
+    return NULL;
+  }
+}
+
+/** @brief True if `node` is the first exportable record with its name. */
+static int is_first_record(const cdd_ffi_ir_t *ir,
+                           const cdd_ffi_ir_node_t *node) {
+  return is_exportable_record(node) && find_record(ir, node->name) == node;
+}
+
+static int is_c_ident(const char *name) {
+  if (!name || !(isalpha((unsigned char)*name) || *name == '_'))
+    return 0;
+  for (; *name; name++) {
+    if (!isalnum((unsigned char)*name) && *name != '_')
+      return 0;
+  }
+  return 1;
+}
+
+/**
+ * @brief Compile-time checks that the header's record has the layout the
+ * IR predicts, as a negative array size on mismatch (C89 has no
+ * static_assert). ILP32 is left out: i386 aligns `double` members to 4.
+ */
+static void emit_layout_asserts(FILE *f, cdd_ffi_layout_cache_t *layout,
+                                const cdd_ffi_ir_node_t *node) {
+  static const struct {
+    enum cdd_cst_abi_model_t abi;
+    const char *guard;
+  } targets[] = {{CDD_CST_ABI_LLP64, "defined(_WIN64)"},
+                 {CDD_CST_ABI_LP64, "defined(__LP64__)"}};
+  const char *id = record_ident(node->name);
+  size_t t, j;
+  int opened = 0;
+
+  for (t = 0; t < sizeof(targets) / sizeof(targets[0]); t++) {
+    const cdd_ffi_record_layout_t *rec;
+    if (cdd_ffi_layout_record(layout, node, targets[t].abi, &rec) !=
+        CDD_C_SUCCESS)
+      continue;
+    fprintf(f, "#%s !defined(CDD_CAPI_NO_LAYOUT_ASSERTS) && %s\n",
+            opened ? "elif" : "if", targets[t].guard);
+    fprintf(f,
+            "typedef char cdd_capi_layout_%s[(sizeof(CDD_CAPI_TYPE_%s) == %lu",
+            id, id, (unsigned long)rec->size);
+    for (j = 0; j < node->fields_count; j++) {
+      const cdd_ffi_field_t *field = &node->fields[j];
+      /* offsetof() cannot name a bit-field */
+      if (field->bit_width > 0 || !is_c_ident(field->name))
+        continue;
+      fprintf(f, " &&\n    offsetof(CDD_CAPI_TYPE_%s, %s) == %lu", id,
+              field->name, (unsigned long)rec->fields[j].offset);
+    }
+    fprintf(f, ") ? 1 : -1];\n");
+    opened = 1;
+  }
+  if (opened)
+    fprintf(f, "#endif\n\n");
+}
+
+static void emit_record_type(FILE *f, cdd_ffi_layout_cache_t *layout,
+                             const cdd_ffi_ir_node_t *node,
+                             const char *module) {
+  const char *id = record_ident(node->name);
+  size_t j;
+
+  fprintf(f, "#ifndef CDD_CAPI_TYPE_%s\n", id);
+  if (id != node->name)
+    fprintf(f, "#define CDD_CAPI_TYPE_%s %s\n", id, node->name);
+  else
+    fprintf(f, "#define CDD_CAPI_TYPE_%s %s %s\n", id,
+            node->kind == CDD_FFI_NODE_UNION ? "union" : "struct", id);
+  fprintf(f, "#endif\n\n");
+  emit_layout_asserts(f, layout, node);
+
+  fprintf(f, "typedef struct cdd_capi_%s_object {\n", id);
+  fprintf(f, "  PyObject_HEAD\n");
+  fprintf(f, "  CDD_CAPI_TYPE_%s value;\n", id);
+  fprintf(f, "} cdd_capi_%s_object;\n\n", id);
+
+  fprintf(f, "static PyMemberDef cdd_capi_%s_members[] = {\n", id);
+  for (j = 0; j < node->fields_count; j++) {
+    const cdd_ffi_field_t *field = &node->fields[j];
+    const char *code = member_type(&field->type);
+    if (!code || !field->name || field->bit_width > 0)
+      continue;
+    fprintf(f, "    {\"%s\", %s, offsetof(cdd_capi_%s_object, value.%s), 0, "
+               "NULL},\n",
+            field->name, code, id, field->name);
+  }
+  fprintf(f, "    {NULL, 0, 0, 0, NULL}};\n\n");
+
+  fprintf(f,
+          "static int cdd_capi_%s_getbuffer(PyObject *self, Py_buffer *view,\n"
+          "                                 int flags) {\n"
+          "  return PyBuffer_FillInfo(view, self,\n"
+          "                           &((cdd_capi_%s_object *)self)->value,\n"
+          "                           (Py_ssize_t)sizeof(CDD_CAPI_TYPE_%s), "
+          "0, flags);\n"
+          "}\n\n",
+          id, id, id);
+  fprintf(f,
+          "static PyBufferProcs cdd_capi_%s_as_buffer = "
+          "{cdd_capi_%s_getbuffer, NULL};\n\n",
+          id, id);
+  fprintf(f,
+          "static PyTypeObject cdd_capi_%s_type = {\n"
+          "    PyVarObject_HEAD_INIT(NULL, 0) \"%s.%s\",\n"
+          "    sizeof(cdd_capi_%s_object)};\n\n",
+          id, module, id, id);
+}
+
+static void emit_function(FILE *f, const cdd_ffi_ir_t *ir,
+                          const cdd_ffi_ir_node_t *node) {
+  const cdd_ffi_ir_node_t *ret_record = NULL;
+  capi_conv_t ret = classify(ir, &node->return_or_base_type, 0, &ret_record);
+  size_t j, nargs = 0, nouts = 0, arg;
+  int has_buffers = 0, first = 1;
+  const char *fail;
+
+  for (j = 0; j < node->fields_count; j++) {
+    const cdd_ffi_ir_node_t *record;
+    capi_conv_t conv = param_conv(ir, &node->fields[j], &record);
+    nargs += takes_arg(&node->fields[j], conv);
+    nouts += conv == CAPI_CONV_OUT;
+    has_buffers |= conv == CAPI_CONV_POINTER;
+  }
+  fail = has_buffers ? "goto done" : "return NULL";
+
+  fprintf(f,
+          "static PyObject *cdd_capi_fn_%s(PyObject *self, "
+          "PyObject *const *args,\n"
+          "                                Py_ssize_t nargs) {\n",
+          node->name);
+  fprintf(f, "  PyObject *result = NULL;\n");
+  if (ret == CAPI_CONV_RECORD)
+    fprintf(f, "  cdd_capi_%s_object *ret;\n", record_ident(ret_record->name));
+  else if (local_ctype(ret))
+    fprintf(f, "  %sret;\n", local_ctype(ret));
+  for (j = 0; j < node->fields_count; j++) {
+    const cdd_ffi_field_t *field = &node->fields[j];
+    const cdd_ffi_ir_node_t *record;
+    capi_conv_t conv = param_conv(ir, field, &record);
+    if (conv == CAPI_CONV_OUT) {
+      fprintf(f, "  %s a%" CDD_PRIz " = 0;\n", out_ctype(field->type.kind), j);
+      if (field->intent == CDD_FFI_INTENT_INOUT)
+        fprintf(f, "  %si%" CDD_PRIz ";\n",
+                local_ctype(scalar_conv(field->type.kind)), j);
+    } else if (local_ctype(conv)) {
+      fprintf(f, "  %sa%" CDD_PRIz ";\n", local_ctype(conv), j);
+      if (conv == CAPI_CONV_POINTER)
+        fprintf(f, "  Py_buffer v%" CDD_PRIz ";\n", j);
+    }
+  }
+  fprintf(f, "  (void)self;\n");
+  if (nargs == 0)
+    fprintf(f, "  (void)args;\n");
+  for (j = 0; j < node->fields_count; j++) {
+    const cdd_ffi_ir_node_t *record;
+    if (param_conv(ir, &node->fields[j], &record) == CAPI_CONV_POINTER)
+      fprintf(f, "  v%" CDD_PRIz ".obj = NULL;\n", j);
+  }
+  fprintf(f, "  if (nargs != %" CDD_PRIz ") {\n", nargs);
+  fprintf(f,
+          "    PyErr_Format(PyExc_TypeError,\n"
+          "                 \"%s() takes %" CDD_PRIz
+          " arguments (%%zd given)\", nargs);\n",
+          node->name, nargs);
+  fprintf(f, "    return NULL;\n  }\n");
+
+  for (j = 0, arg = 0; j < node->fields_count; j++) {
+    const cdd_ffi_field_t *field = &node->fields[j];
+    const cdd_ffi_ir_node_t *record;
+    capi_conv_t conv = param_conv(ir, field, &record);
+    if (!takes_arg(field, conv))
+      continue;
+    if (conv == CAPI_CONV_RECORD) {
+      const char *id = record_ident(record->name);
+      fprintf(f,
+              "  if (!PyObject_TypeCheck(args[%" CDD_PRIz "], "
+              "&cdd_capi_%s_type)) {\n"
+              "    PyErr_SetString(PyExc_TypeError,\n"
+              "                    \"%s() argument %" CDD_PRIz
+              " must be %s\");\n"
+              "    %s;\n  }\n",
+              arg, id, node->name, arg + 1, id, fail);
+    } else if (conv == CAPI_CONV_OUT) {
+      emit_from_py(f, scalar_conv(field->type.kind), &field->type, arg, "i", j,
+                   fail);
+      fprintf(f, "  a%" CDD_PRIz " = (%s)i%" CDD_PRIz ";\n", j,
+              out_ctype(field->type.kind), j);
+    } else {
+      emit_from_py(f, conv, &field->type, arg, "a", j, fail);
+    }
+    arg++;
+  }
+
+  if (ret == CAPI_CONV_RECORD) {
+    const char *id = record_ident(ret_record->name);
+    fprintf(f,
+            "  ret = PyObject_New(cdd_capi_%s_object, &cdd_capi_%s_type);\n"
+            "  if (!ret)\n    %s;\n",
+            id, id, fail);
+  }
+
+  if (node->requires_gil_release)
+    fprintf(f, "  Py_BEGIN_ALLOW_THREADS\n");
+  switch (ret) {
+  case CAPI_CONV_VOID:
+    fprintf(f, "  %s(", node->name);
+    break;
+  case CAPI_CONV_RECORD:
+    fprintf(f, "  ret->value = %s(", node->name);
+    break;
+  case CAPI_CONV_CSTRING:
+    fprintf(f, "  ret = %s(", node->name);
+    break;
+  case CAPI_CONV_BOOL:
+    fprintf(f, "  ret = 0 != %s(", node->name);
+    break;
+  default:
+    fprintf(f, "  ret = (%s)%s(", local_ctype(ret), node->name);
+    break;
+  }
+  for (j = 0, arg = 0; j < node->fields_count; j++) {
+    const cdd_ffi_field_t *field = &node->fields[j];
+    const cdd_ffi_ir_node_t *record;
+    capi_conv_t conv = param_conv(ir, field, &record);
+    if (conv == CAPI_CONV_VOID)
+      continue;
+    if (!first)
+      fprintf(f, ", ");
+    first = 0;
+    if (conv == CAPI_CONV_RECORD)
+      fprintf(f, "((cdd_capi_%s_object *)args[%" CDD_PRIz "])->value",
+              record_ident(record->name), arg);
+    else
+      fprintf(f, "%sa%" CDD_PRIz, conv == CAPI_CONV_OUT ? "&" : "", j);
+    arg += takes_arg(field, conv);
+  }
+  fprintf(f, ");\n");
+  if (node->requires_gil_release)
+    fprintf(f, "  Py_END_ALLOW_THREADS\n");
+
+  if (nouts == 0 && ret == CAPI_CONV_VOID) {
+    fprintf(f, "  Py_INCREF(Py_None);\n  result = Py_None;\n");
+  } else if (nouts == 0) {
+    fprintf(f, "  result = ");
+    emit_to_py(f, ret, "ret", (size_t)-1);
+    fprintf(f, ";\n");
+  } else {
+    /* Same shape as the ctypes wrapper: (ret, out...) */
+    fprintf(f, "  result = Py_BuildValue(\"(");
+    if (ret != CAPI_CONV_VOID)
+      fprintf(f, "N");
+    for (j = 0; j < node->fields_count; j++) {
+      const cdd_ffi_ir_node_t *record;
+      if (param_conv(ir, &node->fields[j], &record) == CAPI_CONV_OUT)
+        fprintf(f, "N");
+    }
+    fprintf(f, ")\"");
+    if (ret != CAPI_CONV_VOID) {
+      fprintf(f, ",\n                         ");
+      emit_to_py(f, ret, "ret", (size_t)-1);
+    }
+    for (j = 0; j < node->fields_count; j++) {
+      const cdd_ffi_field_t *field = &node->fields[j];
+      const cdd_ffi_ir_node_t *record;
+      if (param_conv(ir, field, &record) != CAPI_CONV_OUT)
+        continue;
+      fprintf(f, ",\n                         ");
+      emit_to_py(f, scalar_conv(field->type.kind), "a", j);
+    }
+    fprintf(f, ");\n");
+  }
+  if (has_buffers) {
+    fprintf(f, "done:\n");
+    for (j = 0; j < node->fields_count; j++) {
+      const cdd_ffi_ir_node_t *record;
+      if (param_conv(ir, &node->fields[j], &record) == CAPI_CONV_POINTER)
+        fprintf(f,
+                "  if (v%" CDD_PRIz ".obj)\n"
+                "    PyBuffer_Release(&v%" CDD_PRIz ");\n",
+                j, j);
+    }
+  }
+  fprintf(f, "  return result;\n}\n\n");
+}
+
+static cdd_c_error_t emit_capi_c(const cdd_ffi_ir_t *ir,
+                                 cdd_ffi_layout_cache_t *layout,
+                                 const cdd_generate_bindings_config_t *config,
+                                 const char *module) {
+  FILE *f;
+  size_t i, j;
+  unsigned uses = 0;
+  int has_fail = 0;
+
+  f = capi_open(config, "", module, ".c", 1);
+  if (!f)
+    return CDD_C_ERROR_IO;
+
+  for (i = 0; i < ir->nodes_count; i++)
+    function_supported(ir, &ir->nodes[i], &uses);
+
+  fprintf(f, "/* Auto-generated CPython extension module %s by cdd-c */\n\n",
+          module);
+  fprintf(f, "#define PY_SSIZE_T_CLEAN\n");
+  fprintf(f, "#include <Python.h>\n");
+  fprintf(f, "#include <structmember.h>\n");
+  fprintf(f, "#include <limits.h>\n");
+  fprintf(f, "#include <stddef.h>\n");
+  fprintf(f, "#include <stdint.h>\n\n");
+  fprintf(f, "#include \"%s\"\n\n", config->input ? config->input : "api.h");
+  fprintf(f, "#if PY_VERSION_HEX < 0x03070000\n");
+  fprintf(f, "#error \"METH_FASTCALL requires Python 3.7 or newer\"\n");
+  fprintf(f, "#endif\n\n");
+
+  emit_helpers(f, uses);
+
+  for (i = 0; i < ir->nodes_count; i++) {
+    if (is_first_record(ir, &ir->nodes[i]))
+      emit_record_type(f, layout, &ir->nodes[i], module);
+  }
+
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    if (node->kind != CDD_FFI_NODE_FUNCTION || !node->name)
+      continue;
+    if (function_supported(ir, node, NULL))
+      emit_function(f, ir, node);
+    else
+      fprintf(f, "/* %s: signature not representable, skipped */\n\n",
+              node->name);
+  }
+
+  fprintf(f, "static PyMethodDef cdd_capi_methods[] = {\n");
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    if (!function_supported(ir, node, NULL))
+      continue;
+    fprintf(f,
+            "    {\"%s\", (PyCFunction)(void (*)(void))cdd_capi_fn_%s, "
+            "METH_FASTCALL,\n     NULL},\n",
+            node->name, node->name);
+  }
+  fprintf(f, "    {NULL, NULL, 0, NULL}};\n\n");
+
+  fprintf(f,
+          "static struct PyModuleDef cdd_capi_module = {\n"
+          "    PyModuleDef_HEAD_INIT, \"%s\", NULL, -1, cdd_capi_methods,\n"
+          "    NULL, NULL, NULL, NULL};\n\n",
+          module);
+
+  fprintf(f, "PyMODINIT_FUNC PyInit_%s(void) {\n", module);
+  fprintf(f, "  PyObject *m = PyModule_Create(&cdd_capi_module);\n");
+  fprintf(f, "  if (!m)\n    return NULL;\n");
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    const char *id;
+    if (!is_first_record(ir, node))
+      continue;
+    id = record_ident(node->name);
+    fprintf(f,
+            "  cdd_capi_%s_type.tp_flags = Py_TPFLAGS_DEFAULT;\n"
+            "  cdd_capi_%s_type.tp_new = PyType_GenericNew;\n"
+            "  cdd_capi_%s_type.tp_members = cdd_capi_%s_members;\n"
+            "  cdd_capi_%s_type.tp_as_buffer = &cdd_capi_%s_as_buffer;\n"
+            "  if (PyType_Ready(&cdd_capi_%s_type) < 0)\n"
+            "    goto fail;\n"
+            "  Py_INCREF(&cdd_capi_%s_type);\n"
+            "  if (cdd_capi_add(m, \"%s\", (PyObject *)&cdd_capi_%s_type) < "
+            "0)\n"
+            "    goto fail;\n",
+            id, id, id, id, id, id, id, id, id, id);
+    has_fail = 1;
+  }
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    if (node->kind == CDD_FFI_NODE_ENUM) {
+      for (j = 0; j < node->variants_count; j++) {
+        if (!node->variants[j].name)
+          continue;
+        fprintf(f,
+                "  if (cdd_capi_add(m, \"%s\", "
+                "PyLong_FromLongLong((long long)(%s))) < 0)\n"
+                "    goto fail;\n",
+                node->variants[j].name, node->variants[j].name);
+        has_fail = 1;
+      }
+    } else if (node->kind == CDD_FFI_NODE_MACRO && node->name &&
+               node->evaluated_value) {
+      /* The header's own macro, so the compiler does the evaluation */
+      const char *ctor = NULL;
+      if (node->inferred_type == CDD_FFI_MACRO_TYPE_INT)
+        ctor = "PyLong_FromLongLong((long long)";
+      else if (node->inferred_type == CDD_FFI_MACRO_TYPE_FLOAT)
+        ctor = "PyFloat_FromDouble((double)";
+      else if (node->inferred_type == CDD_FFI_MACRO_TYPE_STRING)
+        ctor = "PyUnicode_FromString(";
+      if (!ctor)
+        continue;
+      fprintf(f,
+              "  if (cdd_capi_add(m, \"%s\", %s(%s))) < 0)\n"
+              "    goto fail;\n",
+              node->name, ctor, node->name);
+      has_fail = 1;
+    }
+  }
+  fprintf(f, "  return m;\n");
+  if (has_fail)
+    fprintf(f, "fail:\n  Py_DECREF(m);\n  return NULL;\n");
+  fprintf(f, "}\n");
+
+  fclose(f);
+  return CDD_C_SUCCESS;
+}
+
+static cdd_c_error_t
+emit_capi_setup(const cdd_generate_bindings_config_t *config,
+                const char *module) {
+  FILE *f = capi_open(config, "setup_", module, ".py", 2);
+  if (!f)
+    return CDD_C_ERROR_IO;
+  fprintf(f, "# Auto-generated by cdd-c\n");
+  fprintf(f, "# Build in place with: python setup_%s.py build_ext --inplace\n",
+          module);
+  fprintf(f, "from setuptools import Extension, setup\n\n");
+  fprintf(f, "setup(\n");
+  fprintf(f, "    name='%s',\n", module);
+  fprintf(f, "    ext_modules=[\n");
+  fprintf(f, "        Extension('%s', sources=['%s.c'],\n", module, module);
+  fprintf(f, "                  libraries=['%s'], library_dirs=['.']),\n",
+          config->library_name ? config->library_name : "mylib");
+  fprintf(f, "    ],\n");
+  fprintf(f, ")\n");
+  fclose(f);
+  return CDD_C_SUCCESS;
+}
+
+static cdd_c_error_t
+emit_capi_bench(const cdd_ffi_ir_t *ir,
+                const cdd_generate_bindings_config_t *config,
+                const char *module) {
+  FILE *f;
+  size_t i, j;
+
+  f = capi_open(config, "bench_", module, ".py", 3);
+  if (!f)
+    return CDD_C_ERROR_IO;
+
+  fprintf(f, "# Auto-generated by cdd-c: calls/sec through the ctypes "
+             "bindings vs %s\n",
+          module);
+  fprintf(f, "# Usage: python bench_%s.py [function ...]\n", module);
+  fprintf(f, "import sys\n");
+  fprintf(f, "import timeit\n\n");
+  fprintf(f, "import cdd_bindings\n");
+  fprintf(f, "import %s\n\n", module);
+  fprintf(f, "CALLS = 100000\n\n");
+  fprintf(f, "# Functions taking only numbers, called with ones\n");
+  fprintf(f, "CASES = [\n");
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    size_t count = 0;
+    if (!is_bench_candidate(ir, node))
+      continue;
+    fprintf(f, "    ('%s', (", node->name);
+    for (j = 0; j < node->fields_count; j++) {
+      const cdd_ffi_ir_node_t *record;
+      capi_conv_t conv = param_conv(ir, &node->fields[j], &record);
+      if (conv == CAPI_CONV_VOID)
+        continue;
+      fprintf(f, "%s%s", count++ ? ", " : "",
+              conv == CAPI_CONV_DOUBLE ? "1.0"
+              : conv == CAPI_CONV_BOOL ? "True"
+                                       : "1");
+    }
+    fprintf(f, "%s)),\n", count == 1 ? "," : "");
+  }
+  fprintf(f, "]\n\n\n");
+
+  fprintf(f, "def calls_per_sec(fn, args):\n");
+  fprintf(f, "    best = min(timeit.repeat(lambda: fn(*args), number=CALLS, "
+             "repeat=5))\n");
+  fprintf(f, "    return CALLS / best\n\n\n");
+  fprintf(f, "def main(names):\n");
+  fprintf(f, "    ran = 0\n");
+  fprintf(f, "    for name, args in CASES:\n");
+  fprintf(f, "        if names and name not in names:\n");
+  fprintf(f, "            continue\n");
+  fprintf(f, "        capi = calls_per_sec(getattr(%s, name), args)\n",
+          module);
+  fprintf(f, "        ctypes_fn = getattr(cdd_bindings, name, None)\n");
+  fprintf(f, "        if ctypes_fn is None:\n");
+  fprintf(f, "            print('%%s: C API %%.0f calls/s (no ctypes binding)'"
+             " %% (name, capi))\n");
+  fprintf(f, "        else:\n");
+  fprintf(f, "            ctypes = calls_per_sec(ctypes_fn, args)\n");
+  fprintf(f, "            print('%%s: ctypes %%.0f calls/s, C API %%.0f "
+             "calls/s, %%.1fx'\n");
+  fprintf(f, "                  %% (name, ctypes, capi, capi / ctypes))\n");
+  fprintf(f, "        ran += 1\n");
+  fprintf(f, "    if not ran:\n");
+  fprintf(f, "        print('No function with only numeric arguments to "
+             "benchmark')\n");
+  fprintf(f, "    return 0\n\n\n");
+  fprintf(f, "if __name__ == '__main__':\n");
+  fprintf(f, "    sys.exit(main(sys.argv[1:]))\n");
+
+  fclose(f);
+  return CDD_C_SUCCESS;
+}
+
+static cdd_c_error_t
+emit_capi_tests(const cdd_ffi_ir_t *ir,
+                const cdd_generate_bindings_config_t *config,
+                const char *module) {
+  FILE *f;
+  size_t i;
+
+  f = capi_open(config, "test_", module, ".py", 4);
+  if (!f)
+    return CDD_C_ERROR_IO;
+  fprintf(f, "# Auto-generated tests for %s\n", module);
+  fprintf(f, "import %s\n\n\n", module);
+  fprintf(f, "def test_functions_exist():\n");
+  fprintf(f, "    for name in [");
+  for (i = 0; i < ir->nodes_count; i++) {
+    if (function_supported(ir, &ir->nodes[i], NULL))
+      fprintf(f, "'%s', ", ir->nodes[i].name);
+  }
+  fprintf(f, "]:\n");
+  fprintf(f, "        assert callable(getattr(%s, name))\n\n\n", module);
+  fprintf(f, "def test_structs_are_writable_buffers():\n");
+  fprintf(f, "    for name in [");
+  for (i = 0; i < ir->nodes_count; i++) {
+    if (is_first_record(ir, &ir->nodes[i]))
+      fprintf(f, "'%s', ", record_ident(ir->nodes[i].name));
+  }
+  fprintf(f, "]:\n");
+  fprintf(f, "        assert not memoryview(getattr(%s, name)()).readonly\n",
+          module);
+  fclose(f);
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t
+cdd_ffi_emit_python_capi(cdd_ffi_ir_t *ir,
+                         const cdd_generate_bindings_config_t *config) {
+  char ident[250], module[256];
+  cdd_ffi_layout_cache_t layout;
+  cdd_c_error_t rc;
+
+  if (!ir || !config || !config->output_dir)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  capi_ident(ident, sizeof(ident),
+             config->library_name ? config->library_name : "mylib");
+  CDD_SNPRINTF(module, sizeof(module), "%s_capi", ident);
+
+  rc = cdd_ffi_layout_cache_init(&layout, ir);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  rc = emit_capi_c(ir, &layout, config, module);
+  cdd_ffi_layout_cache_free(&layout);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  rc = emit_capi_setup(config, module);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  rc = emit_capi_bench(ir, config, module);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  if (config->generate_tests)
+    rc = emit_capi_tests(ir, config, module);
+  return rc;
+}
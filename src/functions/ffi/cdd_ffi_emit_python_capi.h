@@ -0,0 +1,35 @@
+#ifndef CDD_FFI_EMIT_PYTHON_CAPI_H
+#define CDD_FFI_EMIT_PYTHON_CAPI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include "../../cdd_api.h"
+#include "cdd_c_error.h"
+#include "../../../include/ffi/cdd_ffi_ir.h"
+/* clang-format on */
+
+/**
+ * @brief Emits a native CPython extension module for the given FFI IR.
+ *
+ * Writes `<lib>_capi.c`, whose functions use METH_FASTCALL and release the
+ * GIL around calls marked `requires_gil_release`, and whose structs are
+ * exposed as types holding the real C layout (fields as attributes, the
+ * raw bytes through the buffer protocol). Also writes a setuptools script
+ * and `bench_<lib>_capi.py`, which compares calls/sec against the ctypes
+ * bindings from cdd_ffi_emit_python().
+ *
+ * @param ir The extracted and topologically sorted FFI IR.
+ * @param config The generation config.
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_ffi_emit_python_capi(
+    cdd_ffi_ir_t *ir, const cdd_generate_bindings_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CDD_FFI_EMIT_PYTHON_CAPI_H */
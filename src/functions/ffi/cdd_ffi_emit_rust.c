@@ -79,6 +79,32 @@ static void emit_rust_sys_type(FILE *f, const cdd_ffi_type_t *type,
   fprintf(f, "%s", get_rust_primitive(type->kind));
 }
 
+/**
+ * @brief Index of the length parameter when parameter `j` is taken as a
+ * Rust slice, or -1.
+ */
+static long slice_length_index(const cdd_ffi_ir_node_t *fn, size_t j) {
+  if (fn->is_variadic || fn->fields[j].type.kind > CDD_FFI_KIND_FLOAT64)
+    return -1;
+  return cdd_ffi_buffer_length_index(fn, j);
+}
+
+/** @brief Index of the slice parameter whose length is parameter `k`. */
+static long slice_of_length(const cdd_ffi_ir_node_t *fn, size_t k) {
+  size_t j;
+  for (j = 0; j < fn->fields_count; j++) {
+    if (slice_length_index(fn, j) == (long)k)
+      return (long)j;
+  }
+  return -1;
+}
+
+/** @brief Writable unless the pointee is const and not an out parameter. */
+static int slice_is_mut(const cdd_ffi_field_t *p) {
+  return !p->type.is_const || p->intent == CDD_FFI_INTENT_OUT ||
+         p->intent == CDD_FFI_INTENT_INOUT;
+}
+
 static cdd_c_error_t emit_sys_rs(cdd_ffi_ir_t *ir, const char *dir_path) {
   FILE *f = NULL;
   char filepath[1024];
@@ -228,19 +254,30 @@ static cdd_c_error_t emit_lib_rs(cdd_ffi_ir_t *ir, const char *dir_path) {
     cdd_ffi_ir_node_t *node = &ir->nodes[i];
     if (node->kind == CDD_FFI_NODE_FUNCTION) {
       size_t j;
+      int first = 1;
       fprintf(f, "    pub fn %s_safe(", node->name);
       for (j = 0; j < node->fields_count; j++) {
+        if (slice_of_length(node, j) >= 0)
+          continue; /* `.len()` of its slice */
+        if (!first)
+          fprintf(f, ", ");
+        first = 0;
         fprintf(f, "%s: ", node->fields[j].name);
-        /* If it's a pointer to i8/u8, use &std::ffi::CStr for idiomatic rust */
-        if (node->fields[j].type.pointer_depth == 1 &&
-            (node->fields[j].type.kind == CDD_FFI_KIND_INT8 ||
-             node->fields[j].type.kind == CDD_FFI_KIND_UINT8)) {
+        if (slice_length_index(node, j) >= 0) {
+          cdd_ffi_primitive_kind_t kind = node->fields[j].type.kind;
+          fprintf(f, "&%s[%s]", slice_is_mut(&node->fields[j]) ? "mut " : "",
+                  kind == CDD_FFI_KIND_VOID || kind == CDD_FFI_KIND_INT8
+                      ? "u8"
+                      : get_rust_primitive(kind));
+        } else if (node->fields[j].type.pointer_depth == 1 &&
+                   (node->fields[j].type.kind == CDD_FFI_KIND_INT8 ||
+                    node->fields[j].type.kind == CDD_FFI_KIND_UINT8)) {
+          /* If it's a pointer to i8/u8, use &std::ffi::CStr for idiomatic
+           * rust */
           fprintf(f, "&std::ffi::CStr");
         } else {
           emit_rust_sys_type(f, &node->fields[j].type, 0);
         }
-        if (j < node->fields_count - 1)
-          fprintf(f, ", ");
       }
       fprintf(f, ") -> Result<");
       emit_rust_sys_type(f, &node->return_or_base_type, 1);
@@ -253,9 +290,16 @@ static cdd_c_error_t emit_lib_rs(cdd_ffi_ir_t *ir, const char *dir_path) {
 
       fprintf(f, "        let res = unsafe { sys::%s(", node->name);
       for (j = 0; j < node->fields_count; j++) {
-        if (node->fields[j].type.pointer_depth == 1 &&
-            (node->fields[j].type.kind == CDD_FFI_KIND_INT8 ||
-             node->fields[j].type.kind == CDD_FFI_KIND_UINT8)) {
+        long b = slice_of_length(node, j);
+        if (b >= 0) {
+          fprintf(f, "%s.len() as _", node->fields[b].name);
+        } else if (slice_length_index(node, j) >= 0) {
+          /* Borrowed slices are handed over in place, never copied */
+          fprintf(f, "%s.%s() as _", node->fields[j].name,
+                  slice_is_mut(&node->fields[j]) ? "as_mut_ptr" : "as_ptr");
+        } else if (node->fields[j].type.pointer_depth == 1 &&
+                   (node->fields[j].type.kind == CDD_FFI_KIND_INT8 ||
+                    node->fields[j].type.kind == CDD_FFI_KIND_UINT8)) {
           fprintf(f, "%s.as_ptr()", node->fields[j].name);
         } else {
           fprintf(f, "%s", node->fields[j].name);
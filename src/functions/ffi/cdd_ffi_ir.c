@@ -1,6 +1,7 @@
 #include "cdd_c_error.h"
 /* clang-format off */
 #include "../../include/ffi/cdd_ffi_ir.h"
+#include "c_cdd/memory.h"
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
@@ -174,11 +175,95 @@ cdd_c_error_t cdd_ffi_ir_topological_sort(cdd_ffi_ir_t *ir) {
   return CDD_C_SUCCESS;
 }
 
+int cdd_ffi_is_length_name(const char *name) {
+  static const char *const exact[] = {"n",    "len",   "length", "count",
+                                      "size", "nelem", "num"};
+  static const char *const suffixes[] = {"_len", "_length", "_count",
+                                         "_size", "_n"};
+  size_t k, len;
+  if (!name)
+    return 0;
+  for (k = 0; k < sizeof(exact) / sizeof(exact[0]); k++) {
+    if (strcmp(name, exact[k]) == 0)
+      return 1;
+  }
+  if (strncmp(name, "num_", 4) == 0 || strncmp(name, "n_", 2) == 0)
+    return 1;
+  len = strlen(name);
+  for (k = 0; k < sizeof(suffixes) / sizeof(suffixes[0]); k++) {
+    size_t sl = strlen(suffixes[k]);
+    if (len > sl && strcmp(name + len - sl, suffixes[k]) == 0)
+      return 1;
+  }
+  return 0;
+}
+
+long cdd_ffi_buffer_length_index(const cdd_ffi_ir_node_t *fn, size_t j) {
+  const cdd_ffi_field_t *p;
+  size_t k;
+
+  if (!fn || j >= fn->fields_count)
+    return -1;
+  p = &fn->fields[j];
+  if (p->type.pointer_depth != 1 || p->type.array_size > 0)
+    return -1;
+  for (k = 0; k < fn->fields_count; k++) {
+    const cdd_ffi_field_t *len = &fn->fields[k];
+    int integral = len->type.pointer_depth == 0 &&
+                   len->type.kind >= CDD_FFI_KIND_INT8 &&
+                   len->type.kind <= CDD_FFI_KIND_UINT64;
+    if (k == j || !integral || !len->name)
+      continue;
+    if (p->array_length_ref ? strcmp(p->array_length_ref, len->name) == 0
+                            : k == j + 1 && cdd_ffi_is_length_name(len->name))
+      return (long)k;
+  }
+  return -1;
+}
+
+int cdd_ffi_is_buffer_length(const cdd_ffi_ir_node_t *fn, size_t k) {
+  size_t j;
+  if (!fn)
+    return 0;
+  for (j = 0; j < fn->fields_count; j++) {
+    if (cdd_ffi_buffer_length_index(fn, j) == (long)k)
+      return 1;
+  }
+  return 0;
+}
+
+cdd_c_error_t cdd_ffi_ir_infer_buffers(cdd_ffi_ir_t *ir) {
+  size_t i, j;
+
+  if (!ir)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  for (i = 0; i < ir->nodes_count; i++) {
+    cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    if (node->kind != CDD_FFI_NODE_FUNCTION)
+      continue;
+    for (j = 0; j < node->fields_count; j++) {
+      cdd_ffi_field_t *p = &node->fields[j];
+      long k;
+      if (p->array_length_ref)
+        continue;
+      k = cdd_ffi_buffer_length_index(node, j);
+      if (k < 0)
+        continue;
+      p->array_length_ref = C_CDD_STRDUP(node->fields[k].name);
+      if (!p->array_length_ref)
+        return CDD_C_ERROR_MEMORY;
+    }
+  }
+  return CDD_C_SUCCESS;
+}
+
 static void free_type_recursive(cdd_ffi_type_t *type) {
   if (type->ref_name) {
     free(type->ref_name);
     type->ref_name = NULL;
   }
+  free(type->c_name);
+  type->c_name = NULL;
   if (type->template_args) {
     size_t i;
     for (i = 0; i < type->template_args_count; i++) {
@@ -259,6 +344,9 @@ void cdd_ffi_ir_free(cdd_ffi_ir_t *ir) {
             if (node->virtual_methods[j].args[a].doc) {
               free(node->virtual_methods[j].args[a].doc);
             }
+            if (node->virtual_methods[j].args[a].array_length_ref) {
+              free(node->virtual_methods[j].args[a].array_length_ref);
+            }
             free_type_recursive(&node->virtual_methods[j].args[a].type);
           }
           free(node->virtual_methods[j].args);
@@ -288,7 +376,16 @@ void cdd_ffi_ir_free(cdd_ffi_ir_t *ir) {
     free(ir->nodes);
   }
 
+  if (ir->sources) {
+    for (i = 0; i < ir->sources_count; i++) {
+      free(ir->sources[i]);
+    }
+    free(ir->sources);
+  }
+
   ir->nodes = NULL;
   ir->nodes_count = 0;
   ir->nodes_capacity = 0;
+  ir->sources = NULL;
+  ir->sources_count = 0;
 }
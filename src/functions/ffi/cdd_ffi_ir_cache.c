@@ -0,0 +1,640 @@
+/**
+ * @file cdd_ffi_ir_cache.c
+ * @brief Binary encoding of the FFI IR and the on-disk IR cache.
+ *
+ * Layout of an encoded IR (all integers unsigned LEB128, signed ones
+ * zigzag-encoded first; strings are `len + 1` then the bytes, 0 for NULL):
+ *
+ *     "CDDFFIR\0" format
+ *     n_sources source...
+ *     n_nodes   node...
+ *
+ * A cache entry `<cache_dir>/<key>.ffir` wraps an encoded IR as:
+ *
+ *     "CDDFFIC\0" version input
+ *     n_deps (path size fnv djb)...
+ *     encoded IR
+ */
+
+/* clang-format off */
+#include "cdd_ffi_ir_cache.h"
+#include "../../functions/parse/fs.h"
+#include "c_cdd/memory.h"
+#include "c_cddConfig.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* clang-format on */
+
+/** @brief Magic prefix of an encoded IR. */
+static const char ir_magic[8] = "CDDFFIR";
+/** @brief Magic prefix of a cache entry. */
+static const char entry_magic[8] = "CDDFFIC";
+
+/** @brief Deepest template nesting accepted when decoding. */
+#define IR_CACHE_MAX_DEPTH 64
+
+/**
+ * @brief Growable output buffer; the first failure sticks in `rc`.
+ */
+struct IrWriter {
+  char *buf;        /**< Bytes written so far */
+  size_t len;       /**< Used length of `buf` */
+  size_t cap;       /**< Allocated length of `buf` */
+  cdd_c_error_t rc; /**< First error, or CDD_C_SUCCESS */
+};
+
+/**
+ * @brief Bounds-checked input cursor; the first failure sticks in `rc`.
+ */
+struct IrReader {
+  const unsigned char *p; /**< Next unread byte */
+  size_t left;            /**< Bytes remaining after `p` */
+  cdd_c_error_t rc;       /**< First error, or CDD_C_SUCCESS */
+};
+
+static void w_bytes(struct IrWriter *w, const void *data, size_t n) {
+  if (w->rc != CDD_C_SUCCESS)
+    return;
+  if (w->len + n > w->cap) {
+    size_t new_cap = w->cap ? w->cap : 256;
+    char *grown;
+    while (new_cap < w->len + n)
+      new_cap *= 2;
+    grown = (char *)realloc(w->buf, new_cap);
+    if (!grown) {
+      w->rc = CDD_C_ERROR_MEMORY;
+      return;
+    }
+    w->buf = grown;
+    w->cap = new_cap;
+  }
+  memcpy(w->buf + w->len, data, n);
+  w->len += n;
+}
+
+static void w_uint(struct IrWriter *w, unsigned long v) {
+  unsigned char tmp[(sizeof(unsigned long) * 8 + 6) / 7];
+  size_t n = 0;
+  do {
+    unsigned char byte = (unsigned char)(v & 0x7F);
+    v >>= 7;
+    tmp[n++] = (unsigned char)(v ? (byte | 0x80) : byte);
+  } while (v);
+  w_bytes(w, tmp, n);
+}
+
+static void w_int(struct IrWriter *w, long v) {
+  w_uint(w, v < 0 ? ((unsigned long)(-(v + 1)) << 1) | 1UL
+                  : (unsigned long)v << 1);
+}
+
+static void w_str(struct IrWriter *w, const char *s) {
+  if (!s) {
+    w_uint(w, 0);
+    return;
+  }
+  w_uint(w, (unsigned long)strlen(s) + 1);
+  w_bytes(w, s, strlen(s));
+}
+
+static void r_fail(struct IrReader *r) {
+  if (r->rc == CDD_C_SUCCESS)
+    r->rc = CDD_C_ERROR_INVALID_ARGUMENT;
+  r->left = 0;
+}
+
+static unsigned long r_uint(struct IrReader *r) {
+  unsigned long v = 0;
+  unsigned shift = 0;
+  for (;;) {
+    unsigned char byte;
+    if (r->rc != CDD_C_SUCCESS || r->left == 0 ||
+        shift >= sizeof(unsigned long) * 8) {
+      r_fail(r);
+      return 0;
+    }
+    byte = *r->p++;
+    r->left--;
+    v |= (unsigned long)(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return v;
+    shift += 7;
+  }
+}
+
+static long r_int(struct IrReader *r) {
+  unsigned long v = r_uint(r);
+  return (v & 1UL) ? -(long)(v >> 1) - 1 : (long)(v >> 1);
+}
+
+/**
+ * @brief Reads an element count; every element takes at least one byte, so
+ * a count beyond the remaining input is corrupt.
+ */
+static size_t r_count(struct IrReader *r) {
+  unsigned long n = r_uint(r);
+  if (n > r->left) {
+    r_fail(r);
+    return 0;
+  }
+  return (size_t)n;
+}
+
+/** @brief Reads an enum value, failing when it exceeds `max`. */
+static int r_enum(struct IrReader *r, unsigned long max) {
+  unsigned long v = r_uint(r);
+  if (v > max) {
+    r_fail(r);
+    return 0;
+  }
+  return (int)v;
+}
+
+/** @brief Reads a string into a fresh heap copy (NULL stays NULL). */
+static char *r_str(struct IrReader *r) {
+  unsigned long n = r_uint(r);
+  char *s;
+  if (n == 0)
+    return NULL;
+  if (n - 1 > r->left) {
+    r_fail(r);
+    return NULL;
+  }
+  s = (char *)malloc((size_t)n);
+  if (!s) {
+    r->rc = CDD_C_ERROR_MEMORY;
+    r->left = 0;
+    return NULL;
+  }
+  memcpy(s, r->p, (size_t)n - 1);
+  s[n - 1] = '\0';
+  r->p += n - 1;
+  r->left -= (size_t)n - 1;
+  return s;
+}
+
+/** @brief Allocates a zeroed array for `n` decoded elements. */
+static void *r_array(struct IrReader *r, size_t n, size_t elem_size) {
+  void *arr;
+  if (r->rc != CDD_C_SUCCESS || n == 0)
+    return NULL;
+  arr = calloc(n, elem_size);
+  if (!arr) {
+    r->rc = CDD_C_ERROR_MEMORY;
+    r->left = 0;
+  }
+  return arr;
+}
+
+static void w_type(struct IrWriter *w, const cdd_ffi_type_t *t) {
+  size_t i;
+  w_uint(w, (unsigned long)t->kind);
+  w_uint(w, t->is_const ? 1UL : 0UL);
+  w_int(w, (long)t->pointer_depth);
+  w_str(w, t->ref_name);
+  w_int(w, t->array_size);
+  w_str(w, t->c_name);
+  w_uint(w, (unsigned long)t->template_args_count);
+  for (i = 0; i < t->template_args_count; ++i)
+    w_type(w, &t->template_args[i]);
+}
+
+static void r_type(struct IrReader *r, cdd_ffi_type_t *t, int depth) {
+  size_t i, n;
+  if (depth > IR_CACHE_MAX_DEPTH) {
+    r_fail(r);
+    return;
+  }
+  t->kind = (cdd_ffi_primitive_kind_t)r_enum(r, CDD_FFI_KIND_STD_UNIQUE_PTR);
+  t->is_const = r_enum(r, 1);
+  t->pointer_depth = (int)r_int(r);
+  t->ref_name = r_str(r);
+  t->array_size = r_int(r);
+  t->c_name = r_str(r);
+  n = r_count(r);
+  t->template_args = (cdd_ffi_type_t *)r_array(r, n, sizeof(cdd_ffi_type_t));
+  if (!t->template_args)
+    return;
+  t->template_args_count = n;
+  for (i = 0; i < n; ++i)
+    r_type(r, &t->template_args[i], depth + 1);
+}
+
+static void w_field(struct IrWriter *w, const cdd_ffi_field_t *f) {
+  w_str(w, f->name);
+  w_type(w, &f->type);
+  w_str(w, f->doc);
+  w_uint(w, (unsigned long)f->intent);
+  w_str(w, f->array_length_ref);
+  w_int(w, (long)f->bit_width);
+}
+
+static void r_field(struct IrReader *r, cdd_ffi_field_t *f) {
+  f->name = r_str(r);
+  r_type(r, &f->type, 0);
+  f->doc = r_str(r);
+  f->intent = (cdd_ffi_param_intent_t)r_enum(r, CDD_FFI_INTENT_INOUT);
+  f->array_length_ref = r_str(r);
+  f->bit_width = (int)r_int(r);
+}
+
+static void w_node(struct IrWriter *w, const cdd_ffi_ir_node_t *node) {
+  size_t i, j;
+  w_uint(w, (unsigned long)node->kind);
+  w_str(w, node->name);
+  w_str(w, node->doc);
+  w_uint(w, (unsigned long)node->fields_count);
+  for (i = 0; i < node->fields_count; ++i)
+    w_field(w, &node->fields[i]);
+  w_uint(w, (unsigned long)node->base_classes_count);
+  for (i = 0; i < node->base_classes_count; ++i) {
+    w_str(w, node->base_classes[i].name);
+    w_uint(w, node->base_classes[i].is_virtual ? 1UL : 0UL);
+    w_str(w, node->base_classes[i].access);
+  }
+  w_uint(w, (unsigned long)node->virtual_methods_count);
+  for (i = 0; i < node->virtual_methods_count; ++i) {
+    const cdd_ffi_virtual_method_t *vm = &node->virtual_methods[i];
+    w_str(w, vm->name);
+    w_type(w, &vm->return_type);
+    w_uint(w, (unsigned long)vm->args_count);
+    for (j = 0; j < vm->args_count; ++j)
+      w_field(w, &vm->args[j]);
+    w_uint(w, vm->is_pure_virtual ? 1UL : 0UL);
+  }
+  w_uint(w, (unsigned long)node->variants_count);
+  for (i = 0; i < node->variants_count; ++i) {
+    w_str(w, node->variants[i].name);
+    w_str(w, node->variants[i].value);
+    w_str(w, node->variants[i].doc);
+  }
+  w_type(w, &node->return_or_base_type);
+  w_str(w, node->evaluated_value);
+  w_uint(w, (unsigned long)node->inferred_type);
+  w_uint(w, node->requires_gil_release ? 1UL : 0UL);
+  w_uint(w, node->is_variadic ? 1UL : 0UL);
+}
+
+/**
+ * @brief Decodes one node. Counts are only set once their array exists, so
+ * a half-decoded node is still safe to pass to cdd_ffi_ir_free().
+ */
+static void r_node(struct IrReader *r, cdd_ffi_ir_node_t *node) {
+  size_t i, j, n;
+  node->kind = (cdd_ffi_node_kind_t)r_enum(r, CDD_FFI_NODE_MACRO);
+  node->name = r_str(r);
+  node->doc = r_str(r);
+
+  n = r_count(r);
+  node->fields = (cdd_ffi_field_t *)r_array(r, n, sizeof(cdd_ffi_field_t));
+  if (node->fields)
+    node->fields_count = n;
+  for (i = 0; i < node->fields_count; ++i)
+    r_field(r, &node->fields[i]);
+
+  n = r_count(r);
+  node->base_classes =
+      (cdd_ffi_base_class_t *)r_array(r, n, sizeof(cdd_ffi_base_class_t));
+  if (node->base_classes)
+    node->base_classes_count = n;
+  for (i = 0; i < node->base_classes_count; ++i) {
+    node->base_classes[i].name = r_str(r);
+    node->base_classes[i].is_virtual = r_enum(r, 1);
+    node->base_classes[i].access = r_str(r);
+  }
+
+  n = r_count(r);
+  node->virtual_methods = (cdd_ffi_virtual_method_t *)r_array(
+      r, n, sizeof(cdd_ffi_virtual_method_t));
+  if (node->virtual_methods)
+    node->virtual_methods_count = n;
+  for (i = 0; i < node->virtual_methods_count; ++i) {
+    cdd_ffi_virtual_method_t *vm = &node->virtual_methods[i];
+    vm->name = r_str(r);
+    r_type(r, &vm->return_type, 0);
+    n = r_count(r);
+    vm->args = (cdd_ffi_field_t *)r_array(r, n, sizeof(cdd_ffi_field_t));
+    if (vm->args)
+      vm->args_count = n;
+    for (j = 0; j < vm->args_count; ++j)
+      r_field(r, &vm->args[j]);
+    vm->is_pure_virtual = r_enum(r, 1);
+  }
+
+  n = r_count(r);
+  node->variants =
+      (cdd_ffi_enum_variant_t *)r_array(r, n, sizeof(cdd_ffi_enum_variant_t));
+  if (node->variants)
+    node->variants_count = n;
+  for (i = 0; i < node->variants_count; ++i) {
+    node->variants[i].name = r_str(r);
+    node->variants[i].value = r_str(r);
+    node->variants[i].doc = r_str(r);
+  }
+
+  r_type(r, &node->return_or_base_type, 0);
+  node->evaluated_value = r_str(r);
+  node->inferred_type =
+      (cdd_ffi_macro_type_t)r_enum(r, CDD_FFI_MACRO_TYPE_STRING);
+  node->requires_gil_release = r_enum(r, 1);
+  node->is_variadic = r_enum(r, 1);
+}
+
+/**
+ * @brief Serializes an IR to a heap buffer.
+ */
+cdd_c_error_t cdd_ffi_ir_serialize(const cdd_ffi_ir_t *ir, char **out_buf,
+                                   size_t *out_len) {
+  struct IrWriter w;
+  size_t i;
+
+  if (!ir || !out_buf || !out_len)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  memset(&w, 0, sizeof(w));
+
+  w_bytes(&w, ir_magic, sizeof(ir_magic));
+  w_uint(&w, CDD_FFI_IR_CACHE_FORMAT);
+  w_uint(&w, (unsigned long)ir->sources_count);
+  for (i = 0; i < ir->sources_count; ++i)
+    w_str(&w, ir->sources[i]);
+  w_uint(&w, (unsigned long)ir->nodes_count);
+  for (i = 0; i < ir->nodes_count; ++i)
+    w_node(&w, &ir->nodes[i]);
+
+  if (w.rc != CDD_C_SUCCESS) {
+    free(w.buf);
+    return w.rc;
+  }
+  *out_buf = w.buf;
+  *out_len = w.len;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Rebuilds an IR from its serialized form.
+ */
+cdd_c_error_t cdd_ffi_ir_deserialize(const char *buf, size_t len,
+                                     cdd_ffi_ir_t **out_ir) {
+  struct IrReader r;
+  cdd_ffi_ir_t *ir;
+  size_t i, n;
+
+  if (!buf || !out_ir)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out_ir = NULL;
+  if (len < sizeof(ir_magic) || memcmp(buf, ir_magic, sizeof(ir_magic)) != 0)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  r.p = (const unsigned char *)buf + sizeof(ir_magic);
+  r.left = len - sizeof(ir_magic);
+  r.rc = CDD_C_SUCCESS;
+  if (r_uint(&r) != CDD_FFI_IR_CACHE_FORMAT)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  ir = (cdd_ffi_ir_t *)calloc(1, sizeof(cdd_ffi_ir_t));
+  if (!ir)
+    return CDD_C_ERROR_MEMORY;
+
+  n = r_count(&r);
+  ir->sources = (char **)r_array(&r, n, sizeof(char *));
+  if (ir->sources)
+    ir->sources_count = n;
+  for (i = 0; i < ir->sources_count; ++i)
+    ir->sources[i] = r_str(&r);
+
+  n = r_count(&r);
+  ir->nodes = (cdd_ffi_ir_node_t *)r_array(&r, n, sizeof(cdd_ffi_ir_node_t));
+  if (ir->nodes) {
+    ir->nodes_count = n;
+    ir->nodes_capacity = n;
+  }
+  for (i = 0; i < ir->nodes_count; ++i)
+    r_node(&r, &ir->nodes[i]);
+
+  /* Trailing bytes mean the input was not produced by this encoder */
+  if (r.rc == CDD_C_SUCCESS && r.left != 0)
+    r.rc = CDD_C_ERROR_INVALID_ARGUMENT;
+  if (r.rc != CDD_C_SUCCESS) {
+    cdd_ffi_ir_free(ir);
+    free(ir);
+    return r.rc;
+  }
+  *out_ir = ir;
+  return CDD_C_SUCCESS;
+}
+
+/** @brief Folds `n` bytes into the running FNV-1a and djb2 hashes. */
+static void ir_cache_hash(const char *data, size_t n, unsigned long *fnv,
+                          unsigned long *djb) {
+  size_t i;
+  for (i = 0; i < n; ++i) {
+    *fnv = ((*fnv ^ (unsigned char)data[i]) * 16777619UL) & 0xFFFFFFFFUL;
+    *djb = ((*djb * 33UL) ^ (unsigned char)data[i]) & 0xFFFFFFFFUL;
+  }
+}
+
+/**
+ * @brief Builds `<cache_dir>/<key><suffix>`, the key covering the tool
+ * version, the encoding, the input path, the flags the extractor reads and
+ * the input's content.
+ */
+static cdd_c_error_t
+ir_cache_path(const cdd_generate_bindings_config_t *config, const char *content,
+              size_t len, const char *suffix, char **out) {
+  unsigned long fnv = 2166136261UL;
+  unsigned long djb = 5381UL;
+  char opts[64];
+  size_t n;
+
+  sprintf(opts, "%d:%d:%d:%d", CDD_FFI_IR_CACHE_FORMAT,
+          config->recursive_includes ? 1 : 0, config->skip_static ? 1 : 0,
+          config->opaque_pointers ? 1 : 0);
+  ir_cache_hash(C_CDD_VERSION, strlen(C_CDD_VERSION) + 1, &fnv, &djb);
+  ir_cache_hash(opts, strlen(opts) + 1, &fnv, &djb);
+  ir_cache_hash(config->input, strlen(config->input) + 1, &fnv, &djb);
+  ir_cache_hash(content, len, &fnv, &djb);
+
+  n = strlen(config->cache_dir) + sizeof(PATH_SEP) + 16 + 1 +
+      sizeof(unsigned long) * 2 + strlen(suffix) + 1;
+  *out = (char *)C_CDD_MALLOC(n);
+  if (!*out)
+    return CDD_C_ERROR_MEMORY;
+  sprintf(*out, "%s" PATH_SEP "%08lx%08lx-%lx%s", config->cache_dir, fnv, djb,
+          (unsigned long)len, suffix);
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Hashes a file's current content.
+ */
+static cdd_c_error_t ir_cache_fingerprint(const char *path,
+                                          unsigned long *out_size,
+                                          unsigned long *out_fnv,
+                                          unsigned long *out_djb) {
+  struct FsMappedFile file;
+  cdd_c_error_t rc = fs_map_file(path, &file);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  *out_size = (unsigned long)file.size;
+  *out_fnv = 2166136261UL;
+  *out_djb = 5381UL;
+  ir_cache_hash(file.data, file.size, out_fnv, out_djb);
+  fs_unmap_file(&file);
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Looks up a cached IR, validating every recorded dependency.
+ */
+cdd_c_error_t cdd_ffi_ir_cache_load(
+    const cdd_generate_bindings_config_t *config, const char *content,
+    size_t len, cdd_ffi_ir_t **out_ir, int *out_hit) {
+  struct FsMappedFile file;
+  struct IrReader r;
+  char *path = NULL;
+  char *str;
+  int fresh;
+  size_t i, n_deps;
+  cdd_c_error_t rc;
+
+  if (!config || !config->input || !config->cache_dir || !content ||
+      !out_ir || !out_hit)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out_ir = NULL;
+  *out_hit = 0;
+
+  rc = ir_cache_path(config, content, len, ".ffir", &path);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  rc = fs_map_file(path, &file);
+  C_CDD_FREE(path);
+  if (rc != CDD_C_SUCCESS)
+    return CDD_C_SUCCESS; /* Not cached yet */
+
+  r.p = (const unsigned char *)file.data;
+  r.left = file.size;
+  r.rc = CDD_C_SUCCESS;
+  fresh = file.size >= sizeof(entry_magic) &&
+          memcmp(file.data, entry_magic, sizeof(entry_magic)) == 0;
+  if (fresh) {
+    r.p += sizeof(entry_magic);
+    r.left -= sizeof(entry_magic);
+    /* Key collisions: the version and input are stored in full */
+    str = r_str(&r);
+    fresh = str && strcmp(str, C_CDD_VERSION) == 0;
+    free(str);
+    str = r_str(&r);
+    fresh = fresh && str && strcmp(str, config->input) == 0;
+    free(str);
+  }
+
+  n_deps = fresh ? r_count(&r) : 0;
+  for (i = 0; fresh && r.rc == CDD_C_SUCCESS && i < n_deps; ++i) {
+    unsigned long size, fnv, djb, cur_size, cur_fnv, cur_djb;
+    char *dep = r_str(&r);
+    size = r_uint(&r);
+    fnv = r_uint(&r);
+    djb = r_uint(&r);
+    fresh = dep && r.rc == CDD_C_SUCCESS &&
+            ir_cache_fingerprint(dep, &cur_size, &cur_fnv, &cur_djb) ==
+                CDD_C_SUCCESS &&
+            cur_size == size && cur_fnv == fnv && cur_djb == djb;
+    free(dep);
+  }
+  if (r.rc == CDD_C_ERROR_MEMORY)
+    rc = CDD_C_ERROR_MEMORY;
+  else if (fresh && r.rc == CDD_C_SUCCESS) {
+    rc = cdd_ffi_ir_deserialize((const char *)r.p, r.left, out_ir);
+    if (rc == CDD_C_SUCCESS)
+      *out_hit = 1;
+    else if (rc != CDD_C_ERROR_MEMORY)
+      rc = CDD_C_SUCCESS; /* Corrupt entries are misses */
+  }
+  fs_unmap_file(&file);
+  return rc;
+}
+
+/**
+ * @brief Stores an IR together with the fingerprints of its sources.
+ */
+cdd_c_error_t
+cdd_ffi_ir_cache_store(const cdd_generate_bindings_config_t *config,
+                       const char *content, size_t len, const cdd_ffi_ir_t *ir) {
+  struct IrWriter w;
+  char *blob = NULL;
+  size_t blob_len = 0;
+  char *path = NULL;
+  char *tmp_path = NULL;
+  FILE *fh;
+  size_t i;
+  cdd_c_error_t rc;
+
+  if (!config || !config->input || !config->cache_dir || !content || !ir)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (ir->sources_count == 0)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  memset(&w, 0, sizeof(w));
+  w_bytes(&w, entry_magic, sizeof(entry_magic));
+  w_str(&w, C_CDD_VERSION);
+  w_str(&w, config->input);
+  w_uint(&w, (unsigned long)ir->sources_count);
+  for (i = 0; i < ir->sources_count && w.rc == CDD_C_SUCCESS; ++i) {
+    unsigned long size, fnv, djb;
+    if (!ir->sources[i]) {
+      w.rc = CDD_C_ERROR_INVALID_ARGUMENT;
+      break;
+    }
+    rc = ir_cache_fingerprint(ir->sources[i], &size, &fnv, &djb);
+    if (rc != CDD_C_SUCCESS) {
+      w.rc = rc;
+      break;
+    }
+    w_str(&w, ir->sources[i]);
+    w_uint(&w, size);
+    w_uint(&w, fnv);
+    w_uint(&w, djb);
+  }
+  if (w.rc == CDD_C_SUCCESS)
+    w.rc = cdd_ffi_ir_serialize(ir, &blob, &blob_len);
+  if (w.rc == CDD_C_SUCCESS)
+    w_bytes(&w, blob, blob_len);
+  free(blob);
+  rc = w.rc;
+
+  if (rc == CDD_C_SUCCESS)
+    rc = makedirs(config->cache_dir);
+  if (rc == CDD_C_SUCCESS)
+    rc = ir_cache_path(config, content, len, ".ffir", &path);
+  if (rc == CDD_C_SUCCESS)
+    rc = ir_cache_path(config, content, len, ".ffir.tmp", &tmp_path);
+  if (rc == CDD_C_SUCCESS) {
+#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
+    if (fopen_s(&fh, tmp_path, "wb") != 0)
+      fh = NULL;
+#else
+    fh = fopen(tmp_path, "wb");
+#endif
+    if (!fh)
+      rc = CDD_C_ERROR_IO;
+    else {
+      if (fwrite(w.buf, 1, w.len, fh) != w.len)
+        rc = CDD_C_ERROR_IO;
+      if (fclose(fh) != 0)
+        rc = CDD_C_ERROR_IO;
+      /* Publish by rename so a concurrent reader never sees a partial entry */
+      if (rc == CDD_C_SUCCESS)
+        rc = fs_replace_file(path, tmp_path);
+      if (rc != CDD_C_SUCCESS)
+        remove(tmp_path);
+    }
+  }
+
+  free(w.buf);
+  if (path)
+    C_CDD_FREE(path);
+  if (tmp_path)
+    C_CDD_FREE(tmp_path);
+  return rc;
+}
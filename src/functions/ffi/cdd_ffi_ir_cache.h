@@ -0,0 +1,92 @@
+#ifndef CDD_FFI_IR_CACHE_H
+#define CDD_FFI_IR_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include <stddef.h>
+
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+#include "../../include/ffi/cdd_ffi_ir.h"
+#include "../../src/cdd_api.h"
+/* clang-format on */
+
+/**
+ * @file cdd_ffi_ir_cache.h
+ * @brief Compact binary form of the FFI IR and an on-disk cache of
+ * extraction results.
+ *
+ * The encoding is byte-oriented (LEB128 integers, length-prefixed strings)
+ * so it is independent of endianness and word size. A cache entry records
+ * the size and hash of every file the extractor read, and is only used
+ * while all of them are unchanged; the entry itself is named by a hash of
+ * the input, the tool version and the extraction-relevant config.
+ */
+
+/** @brief Bumped whenever the encoding or the IR structs change. */
+#define CDD_FFI_IR_CACHE_FORMAT 3
+
+/**
+ * @brief Serializes an IR, including its `sources`, to a heap buffer.
+ * @param ir The IR to encode.
+ * @param out_buf Receives the buffer; release it with free().
+ * @param out_len Receives the length of `*out_buf` in bytes.
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_ffi_ir_serialize(const cdd_ffi_ir_t *ir,
+                                                char **out_buf,
+                                                size_t *out_len);
+
+/**
+ * @brief Rebuilds an IR from the output of cdd_ffi_ir_serialize().
+ *
+ * Every length is bounds-checked, so truncated or corrupt input fails with
+ * CDD_C_ERROR_INVALID_ARGUMENT instead of being read past its end.
+ * @param buf The encoded bytes (need not be NUL-terminated).
+ * @param len Length of `buf` in bytes.
+ * @param out_ir Receives the new IR; release it with cdd_ffi_ir_free() and
+ * free().
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_ffi_ir_deserialize(const char *buf, size_t len,
+                                                  cdd_ffi_ir_t **out_ir);
+
+/**
+ * @brief Looks up the IR for `config->input` in `config->cache_dir`.
+ *
+ * The entry is memory-mapped. Missing, stale (any recorded source changed),
+ * version-mismatched or corrupt entries are reported as a miss.
+ * @param config The generation config; `input` and `cache_dir` must be set.
+ * @param content The input file's content.
+ * @param len Length of `content` in bytes.
+ * @param out_ir Receives the IR on a hit.
+ * @param out_hit Set to 1 on a hit, 0 on a miss.
+ * @return 0 on success (hit or miss), or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_ffi_ir_cache_load(
+    const cdd_generate_bindings_config_t *config, const char *content,
+    size_t len, cdd_ffi_ir_t **out_ir, int *out_hit);
+
+/**
+ * @brief Writes the IR for `config->input` to `config->cache_dir`.
+ *
+ * The directory is created if needed and the entry is published by an
+ * atomic rename. An IR whose sources cannot all be read is not stored.
+ * @param config The generation config; `input` and `cache_dir` must be set.
+ * @param content The input file's content.
+ * @param len Length of `content` in bytes.
+ * @param ir The extracted, sorted IR; its `sources` are fingerprinted.
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_ffi_ir_cache_store(const cdd_generate_bindings_config_t *config,
+                       const char *content, size_t len, const cdd_ffi_ir_t *ir);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CDD_FFI_IR_CACHE_H */
@@ -270,6 +270,205 @@ C_CDD_EXPORT cdd_c_error_t cdd_ffi_mangle_cpp_name(const char *ns_name,
   return 0;
 }
 
+/**
+ * @brief Types a buffer parameter from its declaration text, e.g.
+ * `_In_reads_(n) const float *xs`. Only scalar and `void` elements are
+ * resolved; anything else keeps the naive type.
+ */
+static void type_buffer_param(cdd_ffi_field_t *field, const char *text) {
+  char base[128];
+  size_t len = 0;
+  const char *p = text;
+  const char *star = strrchr(text, '*');
+  int is_const = 0;
+  cdd_ffi_primitive_kind_t kind;
+
+  if (!star || strchr(text, '*') != star || field->type.pointer_depth != 0)
+    return;
+  while (p < star) {
+    const char *start;
+    size_t n;
+    while (p < star && (*p == ' ' || *p == '\t'))
+      p++;
+    start = p;
+    while (p < star && *p != ' ' && *p != '\t')
+      p++;
+    n = (size_t)(p - start);
+    if (n == 0)
+      continue;
+    if (n == 5 && strncmp(start, "const", 5) == 0) {
+      is_const = 1;
+      continue;
+    }
+    if (*start == '_')
+      continue; /* SAL annotation */
+    if (len + n + 2 > sizeof(base))
+      return;
+    if (len)
+      base[len++] = ' ';
+    memcpy(base + len, start, n);
+    len += n;
+  }
+  base[len] = '\0';
+  if (map_c_type_to_ffi_kind(base, &kind) != CDD_C_SUCCESS ||
+      kind > CDD_FFI_KIND_FLOAT64)
+    return;
+  field->type.kind = kind;
+  field->type.pointer_depth = 1;
+  field->type.is_const = is_const;
+}
+
+/**
+ * @brief Types a struct member from its declared C type, which is finer
+ * than its schema type (`short` and `int64_t` are both "integer" there),
+ * and moves `[N]` dimensions from the name to `array_size`. Types whose
+ * size depends on the ABI (`long`, `size_t`, ...) and other names keep
+ * their schema type, which the emitters spell; their C name goes to
+ * `c_name` for the layout engine. Members with symbolic dimensions are
+ * left as they are.
+ */
+static cdd_c_error_t type_struct_member(cdd_ffi_field_t *field,
+                                        const char *c_type) {
+  char base[128];
+  const char *p;
+  char *bracket;
+  size_t len = 0;
+  long count = 1;
+  int depth = 0, is_const = 0;
+  cdd_ffi_primitive_kind_t kind;
+
+  if (!c_type || !field->name)
+    return CDD_C_SUCCESS;
+  bracket = strchr(field->name, '[');
+  for (p = bracket; p && *p == '[';) {
+    char *end;
+    long n = strtol(p + 1, &end, 10);
+    if (end == p + 1 || *end != ']' || n <= 0)
+      return CDD_C_SUCCESS;
+    count *= n;
+    p = end + 1;
+  }
+  if (p && *p)
+    return CDD_C_SUCCESS;
+
+  for (p = c_type; *p;) {
+    const char *start = p;
+    size_t n;
+    if (*p == '*' || *p == ' ' || *p == '\t') {
+      depth += *p++ == '*';
+      continue;
+    }
+    while (*p && *p != '*' && *p != ' ' && *p != '\t')
+      p++;
+    n = (size_t)(p - start);
+    if (n == 5 && strncmp(start, "const", 5) == 0) {
+      is_const |= depth == 0;
+      continue;
+    }
+    if ((n == 8 && strncmp(start, "volatile", 8) == 0) ||
+        (n == 6 && strncmp(start, "signed", 6) == 0))
+      continue;
+    if (len + n + 2 > sizeof(base))
+      return CDD_C_SUCCESS;
+    if (len)
+      base[len++] = ' ';
+    memcpy(base + len, start, n);
+    len += n;
+  }
+  base[len] = '\0';
+  /* `short int` is `short`; a lone `unsigned` or `signed` is an int */
+  if (len > 4 && strcmp(base + len - 4, " int") == 0 &&
+      (strstr(base, "short") || strstr(base, "long")))
+    base[len -= 4] = '\0';
+  if (strcmp(base, "unsigned") == 0)
+    memcpy(base, "unsigned int", sizeof("unsigned int"));
+  else if (len == 0)
+    memcpy(base, "int", sizeof("int"));
+
+  if (strstr(base, "long") && !strstr(base, "long long"))
+    kind = CDD_FFI_KIND_STRUCT_REF; /* Not the same width on every ABI */
+  else if (map_c_type_to_ffi_kind(base, &kind) != CDD_C_SUCCESS ||
+           (kind > CDD_FFI_KIND_FLOAT64 && kind != CDD_FFI_KIND_STRUCT_REF))
+    return CDD_C_SUCCESS;
+
+  if (kind != CDD_FFI_KIND_STRUCT_REF) {
+    free(field->type.ref_name);
+    field->type.ref_name = NULL;
+    field->type.kind = kind;
+  } else {
+    /* Named like the records themselves: `struct S` is `S` */
+    const char *name = base;
+    char *c_name;
+    if (strncmp(name, "struct ", 7) == 0)
+      name += 7;
+    else if (strncmp(name, "union ", 6) == 0)
+      name += 6;
+    else if (strncmp(name, "enum ", 5) == 0)
+      name += 5;
+    c_name = CDD_STRDUP(name);
+    if (!c_name)
+      return CDD_C_ERROR_MEMORY;
+    free(field->type.c_name);
+    field->type.c_name = c_name;
+  }
+  field->type.pointer_depth = depth;
+  field->type.is_const = is_const;
+  if (bracket) {
+    *bracket = '\0';
+    field->type.array_size = count;
+  }
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Pairs buffer parameters with their element counts.
+ *
+ * SAL `_Out_writes_(n)` / `_In_reads_(n)` / `_Inout_updates_(n)` are read
+ * while splitting the parameters; this adds `@ffi_buffer <ptr> <len>` doc
+ * tags and the `(T *data, size_t n)` naming convention, then types each
+ * paired pointer from its declaration text.
+ * @param node The function node.
+ * @param texts Declaration text of each parameter, parallel to `fields`.
+ * @param n_texts Number of entries in `texts`.
+ */
+static cdd_c_error_t annotate_param_buffers(cdd_ffi_ir_node_t *node,
+                                            char *const *texts,
+                                            size_t n_texts) {
+  size_t k;
+  const char *tag = node->doc;
+
+  while (tag && (tag = strstr(tag, "@ffi_buffer")) != NULL) {
+    char ptr_name[64], len_name[64];
+    tag += 11;
+    if (sscanf(tag, " %63[A-Za-z0-9_] %63[A-Za-z0-9_]", ptr_name,
+               len_name) != 2)
+      continue;
+    for (k = 0; k < node->fields_count; k++) {
+      cdd_ffi_field_t *field = &node->fields[k];
+      if (!field->name || field->array_length_ref ||
+          strcmp(field->name, ptr_name) != 0)
+        continue;
+      field->array_length_ref = CDD_STRDUP(len_name);
+      if (!field->array_length_ref)
+        return CDD_C_ERROR_MEMORY;
+    }
+  }
+  for (k = 1; k < n_texts; k++) {
+    cdd_ffi_field_t *prev = &node->fields[k - 1];
+    if (prev->array_length_ref || !strchr(texts[k - 1], '*') ||
+        !cdd_ffi_is_length_name(node->fields[k].name))
+      continue;
+    prev->array_length_ref = CDD_STRDUP(node->fields[k].name);
+    if (!prev->array_length_ref)
+      return CDD_C_ERROR_MEMORY;
+  }
+  for (k = 0; k < n_texts; k++) {
+    if (node->fields[k].array_length_ref)
+      type_buffer_param(&node->fields[k], texts[k]);
+  }
+  return CDD_C_SUCCESS;
+}
+
 static cdd_c_error_t
 extract_single_file_exports(cdd_ffi_ir_t *ir, const char *filename,
                             const char *content,
@@ -322,9 +521,9 @@ extract_single_file_exports(cdd_ffi_ir_t *ir, const char *filename,
             az_span span_base;
             span_base = az_span_create_from_str((char *)content);
             if (cdd_cst_parse(span_base, &tree_base) == 0) {
-              if (cdd_cst_find_nodes_by_type(tree_base->root,
-                                             CDD_CST_CLASS_DECLARATION,
-                                             &structs_base) == 0) {
+              if (cdd_cst_tree_find_nodes_by_type(tree_base,
+                                                  CDD_CST_CLASS_DECLARATION,
+                                                  &structs_base) == 0) {
                 size_t si;
                 for (si = 0; si < structs_base.size; si++) {
                   cdd_cst_node_t *s_node = structs_base.nodes[si];
@@ -439,8 +638,8 @@ extract_single_file_exports(cdd_ffi_ir_t *ir, const char *filename,
                 rc = CDD_C_ERROR_MEMORY;
                 break;
               }
-              target_c_type = sf->fields[j].ref[0] != '\0' ? sf->fields[j].ref
-                                                           : sf->fields[j].type;
+              target_c_type =
+                  sf->fields[j].ref ? sf->fields[j].ref : sf->fields[j].type;
               {
                 cdd_c_error_t m_rc;
                 m_rc = map_c_type_to_ffi_kind(target_c_type,
@@ -467,6 +666,13 @@ extract_single_file_exports(cdd_ffi_ir_t *ir, const char *filename,
                              CDD_FFI_KIND_STD_UNIQUE_PTR) {
                 parse_template_type(target_c_type, &node->fields[j].type);
               }
+              rc = type_struct_member(&node->fields[j], sf->fields[j].c_type);
+              if (rc != CDD_C_SUCCESS)
+                break;
+              if (sf->fields[j].bit_width)
+                node->fields[j].bit_width = atoi(sf->fields[j].bit_width);
+              if (sf->fields[j].is_flexible_array)
+                node->fields[j].type.array_size = -1;
             }
           }
           if (rc != CDD_C_SUCCESS)
@@ -509,6 +715,7 @@ extract_single_file_exports(cdd_ffi_ir_t *ir, const char *filename,
               const char *rparen = strrchr(sigs.items[i].sig, ')');
               if (lparen && rparen && rparen > lparen + 1) {
                 char params_str[1024];
+                char *texts[64];
                 char *p;
                 char *ctx = NULL;
                 size_t len = (size_t)(rparen - lparen - 1);
@@ -570,19 +777,28 @@ extract_single_file_exports(cdd_ffi_ir_t *ir, const char *filename,
                             CDD_FFI_INTENT_OUT;
                       }
                       {
-                        const char *writes =
-                            strstr(param_trim, "_Out_writes_(");
-                        if (writes) {
+                        static const char *const sal[] = {
+                            "_Out_writes_(", "_In_reads_(",
+                            "_Inout_updates_("};
+                        size_t s_i;
+                        for (s_i = 0; s_i < sizeof(sal) / sizeof(sal[0]);
+                             s_i++) {
+                          const char *writes = strstr(param_trim, sal[s_i]);
                           char len_buf[64] = {0};
-                          const char *start = writes + 13;
-                          const char *end = strchr(start, ')');
+                          const char *start, *end;
+                          if (!writes)
+                            continue;
+                          start = writes + strlen(sal[s_i]);
+                          end = strchr(start, ')');
                           if (end && (end - start) < 63) {
                             strncpy(len_buf, start, end - start);
-                            node->fields[node->fields_count].intent =
-                                CDD_FFI_INTENT_OUT;
+                            if (s_i == 0)
+                              node->fields[node->fields_count].intent =
+                                  CDD_FFI_INTENT_OUT;
                             node->fields[node->fields_count].array_length_ref =
                                 CDD_STRDUP(len_buf);
                           }
+                          break;
                         }
                       }
                       if (strstr(param_trim, "_Inout_"))
@@ -592,6 +808,9 @@ extract_single_file_exports(cdd_ffi_ir_t *ir, const char *filename,
                         node->fields[node->fields_count].intent =
                             CDD_FFI_INTENT_IN;
 
+                      if (node->fields_count <
+                          sizeof(texts) / sizeof(texts[0]))
+                        texts[node->fields_count] = param_trim;
                       node->fields_count++;
                     }
                   }
@@ -601,9 +820,16 @@ extract_single_file_exports(cdd_ffi_ir_t *ir, const char *filename,
                   p = strtok_r(NULL, ",", &ctx);
 #endif
                 }
+                rc = annotate_param_buffers(
+                    node, texts,
+                    node->fields_count < sizeof(texts) / sizeof(texts[0])
+                        ? node->fields_count
+                        : sizeof(texts) / sizeof(texts[0]));
               }
             }
           }
+          if (rc != CDD_C_SUCCESS)
+            break;
         }
       }
       func_sig_list_free(&sigs);
@@ -635,8 +861,8 @@ extract_single_file_exports(cdd_ffi_ir_t *ir, const char *filename,
                 node->variants[0].name = CDD_STRDUP(pp_ctx.macros[j].name);
                 node->variants[0].value = CDD_STRDUP(pp_ctx.macros[j].value);
               }
-              if (cdd_macro_evaluate(&pp_ctx, pp_ctx.macros[j].value,
-                                     &eval_res) == 0) {
+              /* Memoized: macros built from earlier ones reuse their value */
+              if (cdd_macro_value(&pp_ctx, &pp_ctx.macros[j], &eval_res) == 0) {
                 node->inferred_type = (cdd_ffi_macro_type_t)eval_res.type;
                 if (eval_res.type == MACRO_EVAL_TYPE_INT) {
                   char buf[64];
@@ -1062,11 +1288,9 @@ cdd_ffi_ir_extract_exports(const char *filename, const char *content,
     }
   }
 
-  for (k = 0; k < ctx.visited_count; k++) {
-    free(ctx.visited[k]);
-  }
-  if (ctx.visited)
-    free(ctx.visited);
+  /* Hand the visited files over as the IR's sources, e.g. for caching */
+  ir->sources = ctx.visited;
+  ir->sources_count = ctx.visited_count;
   pp_context_free(&pp_ctx);
 
   if (rc != CDD_C_SUCCESS) {
@@ -0,0 +1,532 @@
+/**
+ * @file cdd_ffi_layout.c
+ * @brief Memoized struct/union layouts over the FFI IR.
+ */
+
+/* clang-format off */
+#include "cdd_ffi_layout.h"
+#include <stdlib.h>
+#include <string.h>
+/* clang-format on */
+
+/** @brief Bound on typedef chains and by-value nesting. */
+#define LAYOUT_MAX_DEPTH 32
+
+enum {
+  LAYOUT_PENDING = 0,
+  LAYOUT_BUSY,   /* Being computed: reaching it again is a by-value cycle */
+  LAYOUT_DONE,
+  LAYOUT_UNKNOWN
+};
+
+static cdd_c_error_t layout_record(cdd_ffi_layout_cache_t *cache,
+                                   size_t idx, enum cdd_cst_abi_model_t abi,
+                                   int depth);
+
+static cdd_c_error_t layout_type(cdd_ffi_layout_cache_t *cache,
+                                 const cdd_ffi_type_t *type,
+                                 enum cdd_cst_abi_model_t abi, int depth,
+                                 cdd_cst_type_info_t *out);
+
+static const char *bare_name(const char *name) {
+  if (strncmp(name, "struct ", 7) == 0)
+    return name + 7;
+  if (strncmp(name, "union ", 6) == 0)
+    return name + 6;
+  if (strncmp(name, "enum ", 5) == 0)
+    return name + 5;
+  return name;
+}
+
+static int is_record(const cdd_ffi_ir_node_t *node) {
+  return node->kind == CDD_FFI_NODE_STRUCT || node->kind == CDD_FFI_NODE_UNION;
+}
+
+/**
+ * @brief Preference among nodes sharing a name: complete records, then
+ * enums, then typedefs, then forward declarations.
+ */
+static int name_rank(const cdd_ffi_ir_node_t *node) {
+  if (is_record(node))
+    return node->fields_count > 0 ? 0 : 3;
+  return node->kind == CDD_FFI_NODE_ENUM ? 1 : 2;
+}
+
+/**
+ * @brief Sort key of a named node. qsort() has no context argument, so each
+ * entry carries what the comparator needs instead of indexing the IR.
+ */
+struct by_name_entry {
+  const char *name; /* Without a struct/union/enum tag */
+  int rank;
+  size_t idx;
+};
+
+static int by_name_cmp(const void *a, const void *b) {
+  const struct by_name_entry *ea = (const struct by_name_entry *)a;
+  const struct by_name_entry *eb = (const struct by_name_entry *)b;
+  int c = strcmp(ea->name, eb->name);
+  if (c == 0)
+    c = ea->rank - eb->rank;
+  if (c == 0)
+    c = ea->idx < eb->idx ? -1 : 1;
+  return c;
+}
+
+cdd_c_error_t cdd_ffi_layout_cache_init(cdd_ffi_layout_cache_t *cache,
+                                        const cdd_ffi_ir_t *ir) {
+  struct by_name_entry *entries;
+  size_t i, n;
+  int abi;
+
+  if (!cache || !ir)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  memset(cache, 0, sizeof(*cache));
+  cache->ir = ir;
+  n = ir->nodes_count ? ir->nodes_count : 1;
+
+  cache->by_name = (size_t *)malloc(n * sizeof(size_t));
+  for (abi = 0; abi < CDD_FFI_LAYOUT_N_ABIS; abi++) {
+    cache->records[abi] = (cdd_ffi_record_layout_t *)calloc(
+        n, sizeof(cdd_ffi_record_layout_t));
+    cache->state[abi] = (unsigned char *)calloc(n, 1);
+    if (!cache->records[abi] || !cache->state[abi])
+      break;
+  }
+  if (!cache->by_name || abi < CDD_FFI_LAYOUT_N_ABIS) {
+    cdd_ffi_layout_cache_free(cache);
+    return CDD_C_ERROR_MEMORY;
+  }
+
+  entries = (struct by_name_entry *)malloc(n * sizeof(*entries));
+  if (!entries) {
+    cdd_ffi_layout_cache_free(cache);
+    return CDD_C_ERROR_MEMORY;
+  }
+  for (i = 0; i < ir->nodes_count; i++) {
+    const cdd_ffi_ir_node_t *node = &ir->nodes[i];
+    if (node->name && (is_record(node) || node->kind == CDD_FFI_NODE_ENUM ||
+                       node->kind == CDD_FFI_NODE_TYPEDEF)) {
+      struct by_name_entry *e = &entries[cache->by_name_count++];
+      e->name = bare_name(node->name);
+      e->rank = name_rank(node);
+      e->idx = i;
+    }
+  }
+  qsort(entries, cache->by_name_count, sizeof(*entries), by_name_cmp);
+  for (i = 0; i < cache->by_name_count; i++)
+    cache->by_name[i] = entries[i].idx;
+  free(entries);
+  return CDD_C_SUCCESS;
+}
+
+void cdd_ffi_layout_cache_free(cdd_ffi_layout_cache_t *cache) {
+  size_t i;
+  int abi;
+
+  if (!cache)
+    return;
+  for (abi = 0; abi < CDD_FFI_LAYOUT_N_ABIS; abi++) {
+    if (cache->records[abi] && cache->ir) {
+      for (i = 0; i < cache->ir->nodes_count; i++)
+        free(cache->records[abi][i].fields);
+    }
+    free(cache->records[abi]);
+    free(cache->state[abi]);
+  }
+  free(cache->by_name);
+  memset(cache, 0, sizeof(*cache));
+}
+
+cdd_c_error_t cdd_ffi_layout_find(const cdd_ffi_layout_cache_t *cache,
+                                  const char *name,
+                                  const cdd_ffi_ir_node_t **out_node) {
+  size_t lo = 0, hi;
+  const char *key;
+
+  if (!cache || !name || !out_node)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  key = bare_name(name);
+  hi = cache->by_name_count;
+  /* Lower bound, so the best-ranked node of the name is found */
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    const cdd_ffi_ir_node_t *node = &cache->ir->nodes[cache->by_name[mid]];
+    if (strcmp(bare_name(node->name), key) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo < cache->by_name_count) {
+    const cdd_ffi_ir_node_t *node = &cache->ir->nodes[cache->by_name[lo]];
+    if (strcmp(bare_name(node->name), key) == 0) {
+      *out_node = node;
+      return CDD_C_SUCCESS;
+    }
+  }
+  return CDD_C_ERROR_NOT_FOUND;
+}
+
+/** @brief Scalar kinds, by the name cdd_cst_eval_primitive_type() uses. */
+static const char *primitive_name(cdd_ffi_primitive_kind_t kind) {
+  switch (kind) {
+  case CDD_FFI_KIND_BOOL:
+  case CDD_FFI_KIND_INT8:
+  case CDD_FFI_KIND_UINT8:
+    return "char";
+  case CDD_FFI_KIND_INT16:
+  case CDD_FFI_KIND_UINT16:
+    return "short";
+  case CDD_FFI_KIND_INT32:
+  case CDD_FFI_KIND_UINT32:
+  case CDD_FFI_KIND_ENUM_REF:
+    return "int";
+  case CDD_FFI_KIND_INT64:
+  case CDD_FFI_KIND_UINT64:
+    return "long long";
+  case CDD_FFI_KIND_FLOAT32:
+    return "float";
+  case CDD_FFI_KIND_FLOAT64:
+    return "double";
+  case CDD_FFI_KIND_OPAQUE_PTR:
+  case CDD_FFI_KIND_FUNCTION_PTR:
+    return "ptr";
+  default:
+    return NULL;
+  }
+}
+
+/**
+ * @brief Scalars the IR keeps as names because their width depends on the
+ * ABI: `long`, `long double` and the pointer-sized standard typedefs.
+ */
+static cdd_c_error_t layout_builtin(const char *name,
+                                    enum cdd_cst_abi_model_t abi,
+                                    cdd_cst_type_info_t *out) {
+  static const char *const ptr_sized[] = {"size_t", "ssize_t", "ptrdiff_t",
+                                          "intptr_t", "uintptr_t"};
+  size_t i;
+  for (i = 0; i < sizeof(ptr_sized) / sizeof(ptr_sized[0]); i++) {
+    if (strcmp(name, ptr_sized[i]) == 0)
+      return cdd_cst_eval_primitive_type("ptr", abi, out);
+  }
+  if (strcmp(name, "long") == 0 || strcmp(name, "unsigned long") == 0 ||
+      strcmp(name, "long double") == 0)
+    return cdd_cst_eval_primitive_type(name, abi, out);
+  return CDD_C_ERROR_NOT_FOUND;
+}
+
+/** @brief Layout of a type before any array dimension is applied. */
+static cdd_c_error_t layout_elem(cdd_ffi_layout_cache_t *cache,
+                                 const cdd_ffi_type_t *type,
+                                 enum cdd_cst_abi_model_t abi, int depth,
+                                 cdd_cst_type_info_t *out) {
+  const cdd_ffi_ir_node_t *node;
+  const char *prim, *name;
+  cdd_c_error_t rc;
+
+  if (depth > LAYOUT_MAX_DEPTH)
+    return CDD_C_ERROR_NOT_FOUND;
+  if (type->pointer_depth > 0)
+    return cdd_cst_eval_primitive_type("ptr", abi, out);
+  /* The declared C name, when kept, is finer than the schema kind */
+  name = type->c_name;
+  if (!name) {
+    prim = primitive_name(type->kind);
+    if (prim)
+      return cdd_cst_eval_primitive_type(prim, abi, out);
+    if (type->kind != CDD_FFI_KIND_STRUCT_REF &&
+        type->kind != CDD_FFI_KIND_TYPEDEF_REF)
+      return CDD_C_ERROR_NOT_FOUND; /* void, C++ library and templates */
+    name = type->ref_name;
+  }
+  if (!name)
+    return CDD_C_ERROR_NOT_FOUND;
+
+  rc = cdd_ffi_layout_find(cache, name, &node);
+  if (rc == CDD_C_ERROR_NOT_FOUND)
+    return layout_builtin(name, abi, out);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  switch (node->kind) {
+  case CDD_FFI_NODE_ENUM:
+    return cdd_cst_eval_primitive_type("int", abi, out);
+  case CDD_FFI_NODE_TYPEDEF:
+    return layout_type(cache, &node->return_or_base_type, abi, depth + 1, out);
+  default:
+    rc = layout_record(cache, (size_t)(node - cache->ir->nodes), abi,
+                       depth + 1);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    out->size = cache->records[abi][node - cache->ir->nodes].size;
+    out->alignment = cache->records[abi][node - cache->ir->nodes].alignment;
+    return CDD_C_SUCCESS;
+  }
+}
+
+/** @brief Layout of a type; a flexible array has size 0. */
+static cdd_c_error_t layout_type(cdd_ffi_layout_cache_t *cache,
+                                 const cdd_ffi_type_t *type,
+                                 enum cdd_cst_abi_model_t abi, int depth,
+                                 cdd_cst_type_info_t *out) {
+  cdd_c_error_t rc = layout_elem(cache, type, abi, depth, out);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  if (type->array_size < 0)
+    out->size = 0;
+  else if (type->array_size > 0)
+    out->size *= (size_t)type->array_size;
+  return CDD_C_SUCCESS;
+}
+
+static size_t round_up(size_t n, size_t align) {
+  return align > 1 ? (n + align - 1) / align * align : n;
+}
+
+/** @brief Storage unit of a bit-field: an integer or enum type. */
+static int is_bitfield_unit(cdd_ffi_layout_cache_t *cache,
+                            const cdd_ffi_type_t *type) {
+  const cdd_ffi_ir_node_t *node;
+  const char *name = type->c_name;
+  if (type->pointer_depth != 0 || type->array_size != 0)
+    return 0;
+  if (!name) {
+    switch (type->kind) {
+    case CDD_FFI_KIND_BOOL:
+    case CDD_FFI_KIND_INT8:
+    case CDD_FFI_KIND_UINT8:
+    case CDD_FFI_KIND_INT16:
+    case CDD_FFI_KIND_UINT16:
+    case CDD_FFI_KIND_INT32:
+    case CDD_FFI_KIND_UINT32:
+    case CDD_FFI_KIND_INT64:
+    case CDD_FFI_KIND_UINT64:
+    case CDD_FFI_KIND_ENUM_REF:
+      return 1;
+    case CDD_FFI_KIND_STRUCT_REF:
+    case CDD_FFI_KIND_TYPEDEF_REF:
+      name = type->ref_name;
+      break;
+    default:
+      return 0;
+    }
+  }
+  if (!name)
+    return 0;
+  if (cdd_ffi_layout_find(cache, name, &node) != CDD_C_SUCCESS)
+    return strcmp(name, "long") == 0 || strcmp(name, "unsigned long") == 0;
+  return node->kind == CDD_FFI_NODE_ENUM ||
+         (node->kind == CDD_FFI_NODE_TYPEDEF &&
+          node->return_or_base_type.kind != CDD_FFI_KIND_TYPEDEF_REF &&
+          is_bitfield_unit(cache, &node->return_or_base_type));
+}
+
+/**
+ * @brief Places the members of a struct. `bits` is the end of the last
+ * member in bits; under LLP64 an open bit-field unit is tracked by
+ * `unit_off`/`unit_size`/`unit_used`.
+ */
+static cdd_c_error_t place_struct(cdd_ffi_layout_cache_t *cache,
+                                  const cdd_ffi_ir_node_t *node,
+                                  enum cdd_cst_abi_model_t abi, int depth,
+                                  cdd_ffi_record_layout_t *rec) {
+  size_t bits = 0, unit_off = 0, unit_size = 0, unit_used = 0, i;
+  int msvc = abi == CDD_CST_ABI_LLP64;
+
+  for (i = 0; i < node->fields_count; i++) {
+    const cdd_ffi_field_t *field = &node->fields[i];
+    cdd_ffi_field_layout_t *fl = &rec->fields[i];
+    cdd_cst_type_info_t info;
+    cdd_c_error_t rc = layout_type(cache, &field->type, abi, depth, &info);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    if (info.alignment > rec->alignment)
+      rec->alignment = info.alignment;
+    fl->alignment = info.alignment;
+
+    if (field->bit_width <= 0) {
+      if (field->type.array_size < 0 && i + 1 != node->fields_count)
+        return CDD_C_ERROR_NOT_FOUND; /* Unsized array before the end */
+      unit_size = 0;
+      fl->offset = round_up((bits + 7) / 8, info.alignment);
+      fl->size = info.size;
+      bits = (fl->offset + fl->size) * 8;
+      rec->has_flexible_array = field->type.array_size < 0;
+      continue;
+    }
+
+    if (!is_bitfield_unit(cache, &field->type) ||
+        (size_t)field->bit_width > info.size * 8)
+      return CDD_C_ERROR_NOT_FOUND;
+    fl->bit_width = (unsigned)field->bit_width;
+    fl->size = info.size;
+    if (msvc) {
+      /* A unit is shared only by adjacent bit-fields of the same size */
+      if (unit_size != info.size ||
+          unit_used + (size_t)field->bit_width > unit_size * 8) {
+        unit_off = round_up((bits + 7) / 8, info.alignment);
+        unit_size = info.size;
+        unit_used = 0;
+        bits = (unit_off + unit_size) * 8;
+      }
+      fl->offset = unit_off;
+      fl->bit_offset = (unsigned)unit_used;
+      unit_used += (size_t)field->bit_width;
+    } else {
+      /* Packed in bit order, never straddling an aligned unit */
+      size_t unit_bits = info.alignment * 8;
+      if (bits / unit_bits !=
+          (bits + (size_t)field->bit_width - 1) / unit_bits)
+        bits = round_up(bits, unit_bits);
+      fl->offset = bits / unit_bits * info.alignment;
+      fl->bit_offset = (unsigned)(bits - fl->offset * 8);
+      bits += (size_t)field->bit_width;
+    }
+  }
+  rec->size = round_up((bits + 7) / 8, rec->alignment);
+  return CDD_C_SUCCESS;
+}
+
+/** @brief Places the members of a union, all at offset 0. */
+static cdd_c_error_t place_union(cdd_ffi_layout_cache_t *cache,
+                                 const cdd_ffi_ir_node_t *node,
+                                 enum cdd_cst_abi_model_t abi, int depth,
+                                 cdd_ffi_record_layout_t *rec) {
+  size_t i;
+
+  for (i = 0; i < node->fields_count; i++) {
+    const cdd_ffi_field_t *field = &node->fields[i];
+    cdd_ffi_field_layout_t *fl = &rec->fields[i];
+    cdd_cst_type_info_t info;
+    cdd_c_error_t rc = layout_type(cache, &field->type, abi, depth, &info);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    if (field->bit_width > 0) {
+      if (!is_bitfield_unit(cache, &field->type) ||
+          (size_t)field->bit_width > info.size * 8)
+        return CDD_C_ERROR_NOT_FOUND;
+      fl->bit_width = (unsigned)field->bit_width;
+    }
+    fl->size = info.size;
+    fl->alignment = info.alignment;
+    if (info.size > rec->size)
+      rec->size = info.size;
+    if (info.alignment > rec->alignment)
+      rec->alignment = info.alignment;
+  }
+  rec->size = round_up(rec->size, rec->alignment);
+  return CDD_C_SUCCESS;
+}
+
+static cdd_c_error_t layout_record(cdd_ffi_layout_cache_t *cache,
+                                   size_t idx, enum cdd_cst_abi_model_t abi,
+                                   int depth) {
+  const cdd_ffi_ir_node_t *node = &cache->ir->nodes[idx];
+  cdd_ffi_record_layout_t *rec = &cache->records[abi][idx];
+  unsigned char *state = &cache->state[abi][idx];
+  cdd_c_error_t rc;
+
+  if (*state == LAYOUT_DONE)
+    return CDD_C_SUCCESS;
+  if (*state != LAYOUT_PENDING)
+    return CDD_C_ERROR_NOT_FOUND; /* Unknown, or contains itself */
+  if (depth > LAYOUT_MAX_DEPTH || node->fields_count == 0 ||
+      node->base_classes_count > 0 || node->virtual_methods_count > 0) {
+    *state = LAYOUT_UNKNOWN;
+    return CDD_C_ERROR_NOT_FOUND;
+  }
+
+  rec->fields = (cdd_ffi_field_layout_t *)calloc(
+      node->fields_count, sizeof(cdd_ffi_field_layout_t));
+  if (!rec->fields)
+    return CDD_C_ERROR_MEMORY;
+  rec->fields_count = node->fields_count;
+  rec->alignment = 1;
+
+  *state = LAYOUT_BUSY;
+  if (node->kind == CDD_FFI_NODE_UNION)
+    rc = place_union(cache, node, abi, depth, rec);
+  else
+    rc = place_struct(cache, node, abi, depth, rec);
+  if (rc != CDD_C_SUCCESS) {
+    free(rec->fields);
+    memset(rec, 0, sizeof(*rec));
+    /* Memory errors may not recur, so only a definite answer is kept */
+    *state = rc == CDD_C_ERROR_NOT_FOUND ? LAYOUT_UNKNOWN : LAYOUT_PENDING;
+    return rc;
+  }
+  *state = LAYOUT_DONE;
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t cdd_ffi_layout_record(cdd_ffi_layout_cache_t *cache,
+                                    const cdd_ffi_ir_node_t *node,
+                                    enum cdd_cst_abi_model_t abi,
+                                    const cdd_ffi_record_layout_t **out) {
+  size_t idx;
+  cdd_c_error_t rc;
+
+  if (!cache || !cache->ir || !node || !out || (int)abi < 0 ||
+      (int)abi >= CDD_FFI_LAYOUT_N_ABIS || node < cache->ir->nodes ||
+      node >= cache->ir->nodes + cache->ir->nodes_count)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (!is_record(node))
+    return CDD_C_ERROR_NOT_FOUND;
+  idx = (size_t)(node - cache->ir->nodes);
+  rc = layout_record(cache, idx, abi, 0);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  *out = &cache->records[abi][idx];
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t cdd_ffi_layout_type(cdd_ffi_layout_cache_t *cache,
+                                  const cdd_ffi_type_t *type,
+                                  enum cdd_cst_abi_model_t abi,
+                                  cdd_cst_type_info_t *out_info) {
+  if (!cache || !cache->ir || !type || !out_info || (int)abi < 0 ||
+      (int)abi >= CDD_FFI_LAYOUT_N_ABIS)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  return layout_type(cache, type, abi, 0, out_info);
+}
+
+int cdd_ffi_layout_equal(const cdd_ffi_record_layout_t *a,
+                         const cdd_ffi_record_layout_t *b) {
+  size_t i;
+  if (a->size != b->size || a->alignment != b->alignment ||
+      a->fields_count != b->fields_count)
+    return 0;
+  for (i = 0; i < a->fields_count; i++) {
+    if (a->fields[i].offset != b->fields[i].offset ||
+        a->fields[i].size != b->fields[i].size ||
+        a->fields[i].bit_offset != b->fields[i].bit_offset)
+      return 0;
+  }
+  return 1;
+}
+
+cdd_c_error_t cdd_ffi_layout_is_portable(cdd_ffi_layout_cache_t *cache,
+                                         const cdd_ffi_ir_node_t *node,
+                                         int *out_portable) {
+  const cdd_ffi_record_layout_t *first, *other;
+  cdd_c_error_t rc;
+  int abi;
+
+  if (!out_portable)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out_portable = 0;
+  rc = cdd_ffi_layout_record(cache, node, CDD_CST_ABI_ILP32, &first);
+  for (abi = 1; rc == CDD_C_SUCCESS && abi < CDD_FFI_LAYOUT_N_ABIS; abi++) {
+    rc = cdd_ffi_layout_record(cache, node, (enum cdd_cst_abi_model_t)abi,
+                               &other);
+    if (rc != CDD_C_SUCCESS)
+      break;
+    if (!cdd_ffi_layout_equal(first, other))
+      return CDD_C_SUCCESS;
+  }
+  if (rc == CDD_C_ERROR_NOT_FOUND)
+    return CDD_C_SUCCESS;
+  if (rc == CDD_C_SUCCESS)
+    *out_portable = 1;
+  return rc;
+}
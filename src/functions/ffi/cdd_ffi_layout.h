@@ -0,0 +1,167 @@
+#ifndef CDD_FFI_LAYOUT_H
+#define CDD_FFI_LAYOUT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include <stddef.h>
+
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+#include "../../include/ffi/cdd_ffi_ir.h"
+#include "../../classes/parse/cdd_cst_type_eval.h"
+/* clang-format on */
+
+/**
+ * @file cdd_ffi_layout.h
+ * @brief C struct/union layouts of FFI IR records, per ABI model.
+ *
+ * A record's field offset table is computed once per ABI and kept, so
+ * nested records are laid out once however often they are referenced.
+ * Scalar sizes come from cdd_cst_eval_primitive_type(). Bit-fields follow
+ * the System V rules under ILP32/LP64 and the MSVC rules under LLP64; a
+ * trailing member with a negative `array_size` is a flexible array member.
+ * `#pragma pack` and alignment attributes are not modelled.
+ */
+
+/** @brief Number of `enum cdd_cst_abi_model_t` values. */
+#define CDD_FFI_LAYOUT_N_ABIS 3
+
+/**
+ * @brief Placement of one record member.
+ */
+typedef struct cdd_ffi_field_layout_t {
+  /** @brief Byte offset; for a bit-field, that of its storage unit */
+  size_t offset;
+  /** @brief Size in bytes; the storage unit for a bit-field, 0 for a
+   * flexible array member */
+  size_t size;
+  /** @brief Alignment in bytes */
+  size_t alignment;
+  /** @brief First bit of a bit-field within its storage unit */
+  unsigned bit_offset;
+  /** @brief Width of a bit-field, 0 for other members */
+  unsigned bit_width;
+} cdd_ffi_field_layout_t;
+
+/**
+ * @brief Layout of a struct or union node.
+ */
+typedef struct cdd_ffi_record_layout_t {
+  /** @brief sizeof the record */
+  size_t size;
+  /** @brief _Alignof the record */
+  size_t alignment;
+  /** @brief One entry per `fields[i]` of the node */
+  cdd_ffi_field_layout_t *fields;
+  /** @brief Number of entries in `fields` */
+  size_t fields_count;
+  /** @brief True if the last member is a flexible array member */
+  int has_flexible_array;
+} cdd_ffi_record_layout_t;
+
+/**
+ * @brief Memoized layouts of the records of one IR.
+ *
+ * Not thread-safe; concurrent emitters each keep their own.
+ */
+typedef struct cdd_ffi_layout_cache_t {
+  /** @brief The IR the layouts describe */
+  const cdd_ffi_ir_t *ir;
+  /** @brief Indices of named struct/union/enum/typedef nodes, by name */
+  size_t *by_name;
+  /** @brief Number of entries in `by_name` */
+  size_t by_name_count;
+  /** @brief Per ABI, per node: the computed layout */
+  cdd_ffi_record_layout_t *records[CDD_FFI_LAYOUT_N_ABIS];
+  /** @brief Per ABI, per node: pending, in progress, done or unknown */
+  unsigned char *state[CDD_FFI_LAYOUT_N_ABIS];
+} cdd_ffi_layout_cache_t;
+
+/**
+ * @brief Prepares an empty cache over `ir`, which must outlive it and not
+ * change while it is in use.
+ * @param cache The cache to initialize.
+ * @param ir The IR.
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_ffi_layout_cache_init(cdd_ffi_layout_cache_t *cache,
+                          const cdd_ffi_ir_t *ir);
+
+/**
+ * @brief Releases every layout held by the cache.
+ * @param cache The cache.
+ */
+C_CDD_EXPORT void cdd_ffi_layout_cache_free(cdd_ffi_layout_cache_t *cache);
+
+/**
+ * @brief Looks up a struct, union, enum or typedef node by name. A leading
+ * `struct `/`union `/`enum ` is ignored, and complete records win over
+ * forward declarations.
+ * @param cache The cache.
+ * @param name The name.
+ * @param out_node Receives the node.
+ * @return 0 on success, or CDD_C_ERROR_NOT_FOUND.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_ffi_layout_find(const cdd_ffi_layout_cache_t *cache, const char *name,
+                    const cdd_ffi_ir_node_t **out_node);
+
+/**
+ * @brief Gets the layout of a struct or union node of the cache's IR.
+ * @param cache The cache.
+ * @param node The record.
+ * @param abi The ABI model.
+ * @param out Receives the layout, owned by the cache.
+ * @return 0 on success, CDD_C_ERROR_NOT_FOUND when the layout cannot be
+ * known (incomplete, C++ or opaque members, by-value cycles), or an error.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_ffi_layout_record(cdd_ffi_layout_cache_t *cache,
+                      const cdd_ffi_ir_node_t *node,
+                      enum cdd_cst_abi_model_t abi,
+                      const cdd_ffi_record_layout_t **out);
+
+/**
+ * @brief Gets sizeof and _Alignof of any IR type, arrays included.
+ * @param cache The cache.
+ * @param type The type.
+ * @param abi The ABI model.
+ * @param out_info Receives the size and alignment.
+ * @return 0 on success, CDD_C_ERROR_NOT_FOUND when unknown, or an error.
+ */
+C_CDD_EXPORT cdd_c_error_t cdd_ffi_layout_type(cdd_ffi_layout_cache_t *cache,
+                                               const cdd_ffi_type_t *type,
+                                               enum cdd_cst_abi_model_t abi,
+                                               cdd_cst_type_info_t *out_info);
+
+/**
+ * @brief Compares two layouts of one record member by member.
+ * @param a A layout.
+ * @param b Another layout of the same record.
+ * @return 1 if sizes, alignments and every placement agree, else 0.
+ */
+C_CDD_EXPORT int cdd_ffi_layout_equal(const cdd_ffi_record_layout_t *a,
+                                      const cdd_ffi_record_layout_t *b);
+
+/**
+ * @brief Checks whether a record has the same layout under every ABI
+ * model, so one offset table serves all targets.
+ * @param cache The cache.
+ * @param node The record.
+ * @param out_portable Set to 1 if every ABI agrees, else 0 (also when the
+ * layout is unknown).
+ * @return 0 on success, or an error code.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_ffi_layout_is_portable(cdd_ffi_layout_cache_t *cache,
+                           const cdd_ffi_ir_node_t *node, int *out_portable);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* CDD_FFI_LAYOUT_H */
@@ -12,6 +12,8 @@
 #include <string.h>
 
 #include "c_cdd_stdbool.h"
+#include "classes/parse/cdd_cst_dataflow.h"
+#include "classes/parse/cdd_cst_parser.h"
 #include "functions/parse/analysis.h"
 #include "functions/parse/str.h"
 #include "c_cdd/log.h"
@@ -362,6 +364,362 @@ cdd_c_error_t is_checked(const struct TokenList *tokens, size_t alloc_idx,
   return CDD_C_SUCCESS;
 }
 
+/* A site whose checks are recomputed over its function's CFG. */
+struct SiteRef {
+  size_t offset; /* Byte offset of the assigned variable */
+  size_t site;   /* Index into the AllocationSiteList */
+};
+
+/* Per-definition state while refining. */
+#define DEF_IS_SITE 1u
+#define DEF_PTR_NULL 2u
+#define DEF_SEEN_CHECK 4u
+#define DEF_USED_BEFORE 8u
+
+static int site_ref_cmp(const void *a, const void *b) {
+  const struct SiteRef *x = (const struct SiteRef *)a;
+  const struct SiteRef *y = (const struct SiteRef *)b;
+  return x->offset < y->offset ? -1 : x->offset > y->offset;
+}
+
+/**
+ * @brief Index of the identifier an allocation at `idx` is assigned to, or
+ * `tokens->size`.
+ */
+static size_t assigned_var_index(const struct TokenList *tokens, size_t idx) {
+  size_t prev = idx;
+  while (prev > 0) {
+    prev--;
+    switch (tokens->tokens[prev].kind) {
+    case TOKEN_WHITESPACE:
+      continue;
+    case TOKEN_ASSIGN:
+      while (prev > 0) {
+        prev--;
+        if (tokens->tokens[prev].kind == TOKEN_IDENTIFIER)
+          return prev;
+        if (tokens->tokens[prev].kind != TOKEN_WHITESPACE)
+          break;
+      }
+      return tokens->size;
+    case TOKEN_SEMICOLON:
+    case TOKEN_LBRACE:
+    case TOKEN_RBRACE:
+      return tokens->size;
+    default:
+      continue;
+    }
+  }
+  return tokens->size;
+}
+
+static size_t first_offset(const cdd_cst_node_t *node, int *found) {
+  size_t i;
+  for (i = 0; i < node->num_children; i++) {
+    size_t off;
+    if (node->children[i].kind == CDD_CST_CHILD_TOKEN) {
+      *found = 1;
+      return node->children[i].val.token->offset;
+    }
+    off = first_offset(node->children[i].val.node, found);
+    if (*found)
+      return off;
+  }
+  return 0;
+}
+
+/**
+ * @brief Whether child `i` of `stmt` is dereferenced: `*p`, `p->`, `p[`.
+ */
+static int is_cst_deref(const cdd_cst_node_t *stmt, size_t i, size_t begin) {
+  const cdd_token_t *prev = NULL, *next = NULL;
+  if (i + 1 < stmt->num_children &&
+      stmt->children[i + 1].kind == CDD_CST_CHILD_TOKEN)
+    next = stmt->children[i + 1].val.token;
+  if (next &&
+      (next->kind == CDD_TOKEN_ARROW || next->kind == CDD_TOKEN_LBRACKET))
+    return 1;
+  if (i > begin && stmt->children[i - 1].kind == CDD_CST_CHILD_TOKEN)
+    prev = stmt->children[i - 1].val.token;
+  if (!prev || prev->kind != CDD_TOKEN_STAR)
+    return 0;
+  /* Unary only: `a * p` multiplies */
+  if (i - 1 > begin && stmt->children[i - 2].kind == CDD_CST_CHILD_TOKEN) {
+    switch (stmt->children[i - 2].val.token->kind) {
+    case CDD_TOKEN_IDENTIFIER:
+    case CDD_TOKEN_NUMBER:
+    case CDD_TOKEN_STRING:
+    case CDD_TOKEN_CHAR:
+    case CDD_TOKEN_RPAREN:
+    case CDD_TOKEN_RBRACKET:
+      return 0;
+    default:
+      break;
+    }
+  }
+  return 1;
+}
+
+/**
+ * @brief Runs the transfer of block `b` of the "checked" problem.
+ *
+ * Fact d holds when, on every path, definition d does not reach or has been
+ * tested in a condition. With `cur` NULL the effects are recorded as the
+ * block's gen/kill sets; otherwise `cur` starts as the block's in set and
+ * dereferences of a variable whose fact does not hold are recorded in
+ * `info`.
+ */
+static void checked_transfer(cdd_cst_dataflow_t *df,
+                             const cdd_cst_defuse_t *du, size_t b,
+                             cdd_cst_bitset_word_t *cur, unsigned char *info) {
+  const cdd_cst_cfg_block_t *block = df->cfg->blocks[b];
+  size_t k = du->block_defs[b];
+  size_t s, i, d;
+  for (s = 0; s < block->num_statements; s++) {
+    const cdd_cst_node_t *stmt = block->statements[s];
+    const cdd_cst_cfg_span_t span = block->spans[s];
+    size_t cond_begin = 0, cond_end = 0;
+    cdd_cst_cfg_condition(stmt, &cond_begin, &cond_end);
+    for (i = span.begin; i < span.end; i++) {
+      const cdd_token_t *tok;
+      unsigned flags = 0;
+      size_t var = 0;
+      int in_cond = i >= cond_begin && i < cond_end;
+      if (cdd_cst_defuse_classify(stmt, i, &flags) != CDD_C_SUCCESS)
+        continue;
+      tok = stmt->children[i].val.token;
+      if (cdd_cst_defuse_find_var(du, (const char *)tok->start, tok->length,
+                                  &var) != CDD_C_SUCCESS)
+        continue;
+      for (d = du->first_def[var]; d < du->n_defs;
+           d = du->defs[d].next_of_var) {
+        const int holds = cur ? (int)CDD_CST_BITSET_TEST(cur, d) : 1;
+        if ((flags & CDD_CST_DEFUSE_USE) && in_cond) {
+          if (cur) {
+            if (!holds)
+              info[d] |= DEF_SEEN_CHECK;
+            CDD_CST_BITSET_SET(cur, d);
+          } else {
+            cdd_cst_dataflow_apply_gen(df, b, d);
+          }
+        } else if ((flags & CDD_CST_DEFUSE_USE) && !holds &&
+                   (info[d] & DEF_PTR_NULL) &&
+                   is_cst_deref(stmt, i, span.begin)) {
+          info[d] |= DEF_USED_BEFORE;
+        }
+        if (!(flags & CDD_CST_DEFUSE_DEF))
+          continue;
+        /* Defining the variable leaves only this definition unchecked */
+        if (cur && d == k)
+          CDD_CST_BITSET_CLEAR(cur, d);
+        else if (cur)
+          CDD_CST_BITSET_SET(cur, d);
+        else if (d == k)
+          cdd_cst_dataflow_apply_kill(df, b, d);
+        else
+          cdd_cst_dataflow_apply_gen(df, b, d);
+      }
+      if (flags & CDD_CST_DEFUSE_DEF)
+        k++;
+    }
+  }
+}
+
+/**
+ * @brief Computes `is_checked`/`used_before_check` of the sites bound to
+ * definitions of one function, in one pass over its CFG, and flags them in
+ * `bound` (indexed from `first`).
+ */
+static cdd_c_error_t refine_function(cdd_cst_node_t *fn,
+                                     const struct SiteRef *refs, size_t n_refs,
+                                     struct AllocationSiteList *out,
+                                     size_t first, unsigned char *bound) {
+  cdd_cst_cfg_t *cfg = NULL;
+  cdd_cst_defuse_t du;
+  cdd_cst_dataflow_t df;
+  cdd_cst_bitset_word_t *cur = NULL;
+  unsigned char *info = NULL;
+  size_t *def_site = NULL;
+  size_t b, d, n_bound = 0;
+  cdd_c_error_t rc;
+
+  memset(&du, 0, sizeof(du));
+  memset(&df, 0, sizeof(df));
+  rc = cdd_cst_cfg_build(fn, &cfg);
+  if (rc == CDD_C_SUCCESS)
+    rc = cdd_cst_defuse_build(cfg, &du);
+  if (rc == CDD_C_SUCCESS && du.n_defs > 0) {
+    info = (unsigned char *)calloc(du.n_defs, 1);
+    def_site = (size_t *)malloc(du.n_defs * sizeof(size_t));
+    if (!info || !def_site)
+      rc = CDD_C_ERROR_MEMORY;
+  }
+  for (d = 0; rc == CDD_C_SUCCESS && d < du.n_defs; d++) {
+    struct SiteRef key;
+    const struct SiteRef *ref;
+    key.offset = du.defs[d].tok->offset;
+    key.site = 0;
+    ref = (const struct SiteRef *)bsearch(&key, refs, n_refs, sizeof(*refs),
+                                          site_ref_cmp);
+    def_site[d] = ref ? ref->site : out->size;
+    if (ref) {
+      info[d] = DEF_IS_SITE;
+      if (out->sites[ref->site].spec->check_style == CHECK_PTR_NULL)
+        info[d] |= DEF_PTR_NULL;
+      n_bound++;
+    }
+  }
+  if (rc == CDD_C_SUCCESS && n_bound > 0) {
+    rc = cdd_cst_dataflow_init(&df, cfg, du.n_defs, CDD_CST_DATAFLOW_FORWARD,
+                               CDD_CST_DATAFLOW_INTERSECTION);
+    if (rc == CDD_C_SUCCESS) {
+      for (d = 0; d < du.n_defs; d++)
+        CDD_CST_BITSET_SET(cdd_cst_dataflow_boundary(&df), d);
+      for (b = 0; b < cfg->num_blocks; b++)
+        checked_transfer(&df, &du, b, NULL, info);
+      rc = cdd_cst_dataflow_solve(&df);
+    }
+    if (rc == CDD_C_SUCCESS) {
+      cur = (cdd_cst_bitset_word_t *)malloc(df.n_words *
+                                            sizeof(cdd_cst_bitset_word_t));
+      if (!cur)
+        rc = CDD_C_ERROR_MEMORY;
+    }
+    for (b = 0; rc == CDD_C_SUCCESS && b < cfg->num_blocks; b++) {
+      memcpy(cur, cdd_cst_dataflow_in(&df, b),
+             df.n_words * sizeof(cdd_cst_bitset_word_t));
+      checked_transfer(&df, &du, b, cur, info);
+    }
+    for (d = 0; rc == CDD_C_SUCCESS && d < du.n_defs; d++) {
+      struct AllocationSite *site;
+      if (!(info[d] & DEF_IS_SITE))
+        continue;
+      site = &out->sites[def_site[d]];
+      site->used_before_check = (info[d] & DEF_USED_BEFORE) != 0;
+      site->is_checked =
+          !site->used_before_check && (info[d] & DEF_SEEN_CHECK) != 0;
+      bound[def_site[d] - first] = 1;
+    }
+  }
+
+  free(cur);
+  free(def_site);
+  free(info);
+  cdd_cst_dataflow_free(&df);
+  cdd_cst_defuse_free(&du);
+  cdd_cst_cfg_free(cfg);
+  return rc;
+}
+
+/**
+ * @brief Path-sensitive `is_checked`/`used_before_check` for the sites
+ * [first, out->size) that a function body's CFG binds; `bound` flags them.
+ */
+static cdd_c_error_t refine_with_dataflow(const struct TokenList *tokens,
+                                          size_t first,
+                                          struct AllocationSiteList *out,
+                                          unsigned char *bound) {
+  struct SiteRef *refs = NULL;
+  cdd_cst_tree_t *tree = NULL;
+  size_t i, r = 0, n_refs = 0;
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+
+  if (!tokens->source || first >= out->size)
+    return CDD_C_SUCCESS;
+  refs = (struct SiteRef *)malloc((out->size - first) * sizeof(*refs));
+  if (!refs)
+    return CDD_C_ERROR_MEMORY;
+  for (i = first; i < out->size; i++) {
+    const struct AllocationSite *site = &out->sites[i];
+    size_t var_idx;
+    int inside = 0;
+    if (!site->var_name || site->is_return_stmt)
+      continue;
+    is_inside_condition(tokens, site->token_index, &inside);
+    if (inside)
+      continue;
+    var_idx = assigned_var_index(tokens, site->token_index);
+    if (var_idx >= tokens->size)
+      continue;
+    refs[n_refs].offset =
+        (size_t)(tokens->tokens[var_idx].start - tokens->source);
+    refs[n_refs].site = i;
+    n_refs++;
+  }
+  if (n_refs == 0) {
+    free(refs);
+    return CDD_C_SUCCESS;
+  }
+  qsort(refs, n_refs, sizeof(*refs), site_ref_cmp);
+
+  rc = cdd_cst_parse(
+      az_span_create((uint8_t *)tokens->source, (int32_t)tokens->source_len),
+      &tree);
+  if (rc != CDD_C_SUCCESS) {
+    /* Unparseable input falls back to the token scan */
+    free(refs);
+    return rc == CDD_C_ERROR_MEMORY ? rc : CDD_C_SUCCESS;
+  }
+
+  for (i = 0; rc == CDD_C_SUCCESS && i < tree->root->num_children; i++) {
+    cdd_cst_node_t *fn;
+    size_t j, lo, hi = tokens->source_len;
+    int found = 0;
+    if (tree->root->children[i].kind != CDD_CST_CHILD_NODE)
+      continue;
+    fn = tree->root->children[i].val.node;
+    if (fn->kind != CDD_CST_FUNCTION_DEFINITION)
+      continue;
+    lo = first_offset(fn, &found);
+    for (j = i + 1; j < tree->root->num_children; j++) {
+      const cdd_cst_child_t *next = &tree->root->children[j];
+      int next_found = next->kind == CDD_CST_CHILD_TOKEN;
+      size_t at = next_found ? next->val.token->offset
+                             : first_offset(next->val.node, &next_found);
+      if (next_found) {
+        hi = at;
+        break;
+      }
+    }
+    /* Only functions holding a site get a CFG */
+    while (r < n_refs && refs[r].offset < lo)
+      r++;
+    if (found && r < n_refs && refs[r].offset < hi)
+      rc = refine_function(fn, refs, n_refs, out, first, bound);
+  }
+
+  cdd_cst_tree_free(tree);
+  free(refs);
+  return rc;
+}
+
+/**
+ * @brief Decides the checks of sites [first, out->size): over the CFG of
+ * their function where it binds them, else by the forward token scan.
+ */
+static cdd_c_error_t check_sites(const struct TokenList *tokens, size_t first,
+                                 struct AllocationSiteList *out) {
+  unsigned char *bound;
+  size_t i;
+  cdd_c_error_t rc;
+
+  if (first >= out->size)
+    return CDD_C_SUCCESS;
+  bound = (unsigned char *)calloc(out->size - first, 1);
+  if (!bound)
+    return CDD_C_ERROR_MEMORY;
+  rc = refine_with_dataflow(tokens, first, out, bound);
+  for (i = first; rc == CDD_C_SUCCESS && i < out->size; i++) {
+    struct AllocationSite *site = &out->sites[i];
+    if (bound[i - first] || !site->var_name || site->is_return_stmt)
+      continue;
+    rc = is_checked(tokens, site->token_index, site->var_name, site->spec,
+                    &site->used_before_check, &site->is_checked);
+  }
+  free(bound);
+  return rc;
+}
+
 /**
  * @brief Retrieves the allocations.
  */
@@ -369,7 +727,7 @@ cdd_c_error_t find_allocations(const struct TokenList *tokens,
                                struct AllocationSiteList *out) {
   int _ast_token_matches_string_1 = 0;
   char *_ast_get_assigned_var_2 = NULL;
-  size_t i;
+  size_t i, first;
   int rc;
 
   if (!tokens || !out)
@@ -379,6 +737,7 @@ cdd_c_error_t find_allocations(const struct TokenList *tokens,
     if ((rc = allocation_site_list_init(out)) != 0)
       return rc;
   }
+  first = out->size;
 
   for (i = 0; i < tokens->size; ++i) {
     const struct Token *tok = &tokens->tokens[i];
@@ -438,11 +797,8 @@ cdd_c_error_t find_allocations(const struct TokenList *tokens,
           }
 
           if (var_name) {
-            int used_before = 0;
-            int checked = 0;
-            is_checked(tokens, i, var_name, spec, &used_before, &checked);
-            rc = allocation_site_list_add(out, i, var_name, checked,
-                                          used_before, 0, spec);
+            /* Decided by check_sites() once every site is known */
+            rc = allocation_site_list_add(out, i, var_name, 0, 0, 0, spec);
             free(var_name);
             if (rc != 0)
               return rc;
@@ -459,5 +815,5 @@ cdd_c_error_t find_allocations(const struct TokenList *tokens,
       }
     }
   }
-  return CDD_C_SUCCESS;
+  return check_sites(tokens, first, out);
 }
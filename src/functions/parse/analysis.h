@@ -126,7 +126,9 @@ extern C_CDD_EXPORT cdd_c_error_t allocation_site_list_add(
  * Iterates through tokens to find calls to known allocators (`malloc`,
  * `strdup`, etc.). For each call, analyzes the surrounding context
  * (assignments, `if` statements) to determine if the result is checked for
- * failure.
+ * failure. Inside a function body the verdict is then refined per path over
+ * its control flow graph: a site counts as checked only if every path to
+ * each dereference tests the variable first.
  *
  * @param[in] tokens The token stream to analyze.
  * @param[out] out The results container.
@@ -167,31 +167,6 @@ static cdd_c_error_t add_violation(struct AuditStats *stats,
   return CDD_C_SUCCESS;
 }
 
-/**
- * @brief Calculate line and column number from a pointer into the buffer.
- *
- * @param[in] content Start of the file content buffer.
- * @param[in] token_ptr Pointer to the token within the buffer.
- * @param[out] line 1-based line number.
- * @param[out] col 1-based column number.
- */
-static void get_line_col(const char *content, const uint8_t *token_ptr,
-                         size_t *line, size_t *col) {
-  const char *p = content;
-  *line = 1;
-  *col = 1;
-
-  while ((const uint8_t *)p < token_ptr && *p != '\0') {
-    if (*p == '\n') {
-      (*line)++;
-      *col = 1;
-    } else {
-      (*col)++;
-    }
-    p++;
-  }
-}
-
 /**
  * @brief Check if filename ends with .c extension.
  */
@@ -315,7 +290,7 @@ static cdd_c_error_t audit_file_callback(const char *path, void *user_data) {
           size_t line, col;
           /* Calculate line/col for the violation */
           const struct Token *tok = &tokens->tokens[sites.sites[i].token_index];
-          get_line_col(content, tok->start, &line, &col);
+          (void)token_list_position(tokens, tok->start, &line, &col);
 
           /* Add to details */
           printf("var_name=%s\n",
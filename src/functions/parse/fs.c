@@ -93,6 +93,9 @@ static cdd_c_error_t errno_to_cdd_error(int err) {
 #else
 #include <unistd.h>
 #include "c_cdd/log.h"
+#if !defined(__DJGPP__)
+#include <sys/mman.h>
+#endif
 #endif
 #endif /* defined(_MSC_VER) && !defined(__INTEL_COMPILER) */
 /* clang-format on */
@@ -550,6 +553,24 @@ cdd_c_error_t read_from_fh(FILE *fh, char **out_data, size_t *out_size) {
   return CDD_C_SUCCESS;
 }
 
+/**
+ * @brief Executes the fs_replace_file operation.
+ */
+cdd_c_error_t fs_replace_file(const char *dst, const char *src) {
+  if (!dst || !src)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+#if defined(_WIN32)
+  /* `rename` refuses to overwrite on Windows */
+  if (MoveFileExA(src, dst, MOVEFILE_REPLACE_EXISTING))
+    return CDD_C_SUCCESS;
+  return CDD_C_ERROR_IO;
+#else
+  if (rename(src, dst) == 0)
+    return CDD_C_SUCCESS;
+  return errno_to_cdd_error(errno);
+#endif
+}
+
 /**
  * @brief Executes the cp operation.
  */
@@ -948,9 +969,11 @@ cdd_c_error_t path_is_unc(const char *path, int *out_is_unc) {
 /* --- Directory Walking Implementation --- */
 
 /**
- * @brief Executes the walk directory operation.
+ * @brief Walks `path`, calling `dir_cb` (if any) on each subdirectory once
+ * its contents have been walked.
  */
-cdd_c_error_t walk_directory(const char *path, fs_walk_cb cb, void *user_data) {
+static cdd_c_error_t walk_tree(const char *path, fs_walk_cb cb,
+                               fs_walk_cb dir_cb, void *user_data) {
   char *full_path = NULL;
   c_stat st;
   int rc = 0;
@@ -1006,7 +1029,9 @@ cdd_c_error_t walk_directory(const char *path, fs_walk_cb cb, void *user_data) {
       }
 
       if (file_info.attrib & _A_SUBDIR) {
-        rc = walk_directory(full_path, cb, user_data);
+        rc = walk_tree(full_path, cb, dir_cb, user_data);
+        if (rc == 0 && dir_cb)
+          rc = dir_cb(full_path, user_data);
       } else {
         rc = cb(full_path, user_data);
       }
@@ -1047,7 +1072,9 @@ cdd_c_error_t walk_directory(const char *path, fs_walk_cb cb, void *user_data) {
          everywhere (though common). Safe approach is stat. */
       if (c_stat_func(full_path, &st) == 0) {
         if (IS_DIR(st.st_mode)) {
-          rc = walk_directory(full_path, cb, user_data);
+          rc = walk_tree(full_path, cb, dir_cb, user_data);
+          if (rc == 0 && dir_cb)
+            rc = dir_cb(full_path, user_data);
         } else {
           rc = cb(full_path, user_data);
         }
@@ -1068,3 +1095,109 @@ cdd_c_error_t walk_directory(const char *path, fs_walk_cb cb, void *user_data) {
 
   return CDD_C_SUCCESS;
 }
+
+/**
+ * @brief Executes the walk directory operation.
+ */
+cdd_c_error_t walk_directory(const char *path, fs_walk_cb cb, void *user_data) {
+  return walk_tree(path, cb, NULL, user_data);
+}
+
+/**
+ * @brief Executes the walk directory operation, reporting directories too.
+ */
+cdd_c_error_t walk_directory_post(const char *path, fs_walk_cb cb,
+                                  fs_walk_cb dir_cb, void *user_data) {
+  if (!dir_cb)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  return walk_tree(path, cb, dir_cb, user_data);
+}
+
+/**
+ * @brief Maps a file read-only, falling back to reading it into memory.
+ */
+cdd_c_error_t fs_map_file(const char *path, struct FsMappedFile *out) {
+  cdd_c_error_t rc;
+  char *data = NULL;
+  size_t size = 0;
+
+  if (!path || !out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  out->data = NULL;
+  out->size = 0;
+  out->is_mapped = 0;
+
+#if defined(_WIN32)
+  {
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file != INVALID_HANDLE_VALUE) {
+      LARGE_INTEGER file_size;
+      HANDLE mapping = NULL;
+      void *view = NULL;
+      if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0 &&
+          (unsigned __int64)file_size.QuadPart <= (size_t)-1) {
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+          view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+          CloseHandle(mapping);
+        }
+      }
+      CloseHandle(file);
+      if (view) {
+        out->data = (const char *)view;
+        out->size = (size_t)file_size.QuadPart;
+        out->is_mapped = 1;
+        return CDD_C_SUCCESS;
+      }
+    }
+  }
+#elif !defined(__WATCOMC__) && !defined(__DOS__) && !defined(__DJGPP__)
+  {
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0) {
+      struct stat fd_st;
+      void *view = MAP_FAILED;
+      if (fstat(fd, &fd_st) == 0 && S_ISREG(fd_st.st_mode) &&
+          fd_st.st_size > 0)
+        view = mmap(NULL, (size_t)fd_st.st_size, PROT_READ, MAP_PRIVATE, fd,
+                    0);
+      close(fd);
+      if (view != MAP_FAILED) {
+        out->data = (const char *)view;
+        out->size = (size_t)fd_st.st_size;
+        out->is_mapped = 1;
+        return CDD_C_SUCCESS;
+      }
+    }
+  }
+#endif
+
+  /* Empty files, pipes and platforms without mapping are read instead */
+  rc = read_to_file(path, "rb", &data, &size);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  out->data = data;
+  out->size = size;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Releases a mapping made by fs_map_file.
+ */
+void fs_unmap_file(struct FsMappedFile *file) {
+  if (!file || !file->data)
+    return;
+  if (file->is_mapped) {
+#if defined(_WIN32)
+    UnmapViewOfFile((void *)file->data);
+#elif !defined(__WATCOMC__) && !defined(__DOS__) && !defined(__DJGPP__)
+    munmap((void *)file->data, file->size);
+#endif
+  } else {
+    C_CDD_FREE((void *)file->data);
+  }
+  file->data = NULL;
+  file->size = 0;
+  file->is_mapped = 0;
+}
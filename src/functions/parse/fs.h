@@ -196,6 +196,38 @@ extern C_CDD_EXPORT cdd_c_error_t read_to_file(const char *path,
                                                char **out_data,
                                                size_t *out_size);
 
+/**
+ * @brief A read-only view of a whole file.
+ *
+ * The bytes are not NUL-terminated.
+ */
+struct FsMappedFile {
+  const char *data; /**< File content */
+  size_t size;      /**< Length of `data` in bytes */
+  int is_mapped;    /**< 1 if memory-mapped, 0 if read into the heap */
+};
+
+/**
+ * @brief Map a file into memory read-only.
+ *
+ * Uses `mmap` (or `MapViewOfFile` on Windows) so that large inputs are paged
+ * in on demand rather than copied onto the heap. Empty files, non-regular
+ * files and platforms without mapping fall back to `read_to_file`.
+ *
+ * @param[in] path Path to the file.
+ * @param[out] out Receives the view; release it with `fs_unmap_file`.
+ * @return 0 on success, or an error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t fs_map_file(const char *path,
+                                              struct FsMappedFile *out);
+
+/**
+ * @brief Release a view obtained from `fs_map_file`.
+ *
+ * @param[in,out] file The view; reset to empty.
+ */
+extern C_CDD_EXPORT void fs_unmap_file(struct FsMappedFile *file);
+
 /**
  * @brief Write string content to a file.
  *
@@ -228,6 +260,17 @@ extern C_CDD_EXPORT cdd_c_error_t read_from_fh(FILE *fh, char **out_data,
  */
 extern C_CDD_EXPORT cdd_c_error_t cp(const char *dst, const char *src);
 
+/**
+ * @brief Move a file over another, replacing it atomically.
+ * Both paths must be on the same filesystem.
+ *
+ * @param[in] dst Destination path; overwritten if it exists.
+ * @param[in] src Source path; no longer exists on success.
+ * @return 0 on success, non-zero error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t fs_replace_file(const char *dst,
+                                                  const char *src);
+
 /**
  * @brief Create a directory.
  * Fails if the directory already exists (unless implementation specific,
@@ -311,6 +354,22 @@ extern C_CDD_EXPORT cdd_c_error_t walk_directory(const char *path,
                                                  fs_walk_cb cb,
                                                  void *user_data);
 
+/**
+ * @brief Like `walk_directory`, but also call `dir_cb` for every
+ * subdirectory, after everything inside it (post-order), so a callback may
+ * remove it. The root itself is not reported.
+ *
+ * @param[in] path Root directory path to start traversal.
+ * @param[in] cb Callback function to invoke for each file.
+ * @param[in] dir_cb Callback function to invoke for each subdirectory.
+ * @param[in] user_data Opaque pointer passed to both callbacks.
+ * @return 0 on success, error code (errno) on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t walk_directory_post(const char *path,
+                                                      fs_walk_cb cb,
+                                                      fs_walk_cb dir_cb,
+                                                      void *user_data);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -1,6 +1,7 @@
 #include "c_cdd/memory.h"
 /* clang-format off */
 #include "macro_evaluator.h"
+#include "classes/parse/cdd_cst_type_eval.h"
 #include <ctype.h>
 #include <errno.h>
 #include <stdio.h>
@@ -60,6 +61,72 @@ static void free_tok(macro_tok_t *tok) {
   }
 }
 
+/* A character constant at `lex->pos`: one character or a simple, octal or
+ * hex escape. Returns 0 if it is malformed. */
+static int lex_char(macro_lexer_t *lex, long long *out) {
+  const char *s = lex->str;
+  size_t pos = lex->pos + 1;
+  long long v = 0;
+
+  if (pos >= lex->len)
+    return 0;
+  if (s[pos] != '\\') {
+    v = (unsigned char)s[pos++];
+  } else if (++pos < lex->len) {
+    char e = s[pos++];
+    int digits = 0;
+    switch (e) {
+    case 'n':
+      v = '\n';
+      break;
+    case 't':
+      v = '\t';
+      break;
+    case 'r':
+      v = '\r';
+      break;
+    case 'a':
+      v = '\a';
+      break;
+    case 'b':
+      v = '\b';
+      break;
+    case 'f':
+      v = '\f';
+      break;
+    case 'v':
+      v = '\v';
+      break;
+    case 'x':
+      while (pos < lex->len && isxdigit((unsigned char)s[pos])) {
+        char h = s[pos++];
+        v = v * 16 + (isdigit((unsigned char)h)
+                          ? h - '0'
+                          : tolower((unsigned char)h) - 'a' + 10);
+        digits++;
+      }
+      if (digits == 0)
+        return 0;
+      break;
+    default:
+      if (e >= '0' && e <= '7') {
+        v = e - '0';
+        while (++digits < 3 && pos < lex->len && s[pos] >= '0' &&
+               s[pos] <= '7')
+          v = v * 8 + (s[pos++] - '0');
+      } else {
+        v = (unsigned char)e;
+      }
+      break;
+    }
+  }
+  if (pos >= lex->len || s[pos] != '\'')
+    return 0;
+  lex->pos = pos + 1;
+  *out = v;
+  return 1;
+}
+
 static void next_tok(macro_lexer_t *lex) {
   free_tok(&lex->cur);
 
@@ -76,6 +143,25 @@ static void next_tok(macro_lexer_t *lex) {
     char c = lex->str[lex->pos];
     char nc = (lex->pos + 1 < lex->len) ? lex->str[lex->pos + 1] : '\0';
 
+    if (c == '0' && (nc == 'b' || nc == 'B')) {
+      long long v = 0;
+      lex->pos += 2;
+      while (lex->pos < lex->len &&
+             (lex->str[lex->pos] == '0' || lex->str[lex->pos] == '1'))
+        v = v * 2 + (lex->str[lex->pos++] - '0');
+      while (lex->pos < lex->len &&
+             strchr("uUlL", lex->str[lex->pos]) != NULL)
+        lex->pos++;
+      lex->cur.kind = TOK_INT;
+      lex->cur.int_val = v;
+      return;
+    }
+
+    if (c == '\'') {
+      lex->cur.kind = lex_char(lex, &lex->cur.int_val) ? TOK_INT : TOK_ERROR;
+      return;
+    }
+
     if (isdigit((unsigned char)c) || c == '.') {
       size_t start = lex->pos;
       int is_float = 0;
@@ -276,25 +362,451 @@ static void next_tok(macro_lexer_t *lex) {
   }
 }
 
+
+/* --- Compiler: expression text to postfix bytecode --- */
+
+typedef enum {
+  /* Push a value */
+  OP_INT,
+  OP_FLOAT,
+  OP_STR,
+  OP_MACRO,
+  OP_SIZEOF,
+  OP_ALIGNOF,
+  OP_DEFINED,
+  OP_HAS_INCLUDE,     /* `"path"` */
+  OP_HAS_INCLUDE_SYS, /* `<path>` */
+  /* Replace the top value */
+  OP_NEG,
+  OP_BNOT,
+  OP_LNOT,
+  /* Pop two values, push one */
+  OP_LOR,
+  OP_LAND,
+  OP_BOR,
+  OP_BXOR,
+  OP_BAND,
+  OP_EQ,
+  OP_NE,
+  OP_LT,
+  OP_LE,
+  OP_GT,
+  OP_GE,
+  OP_SHL,
+  OP_SHR,
+  OP_ADD,
+  OP_SUB,
+  OP_MUL,
+  OP_DIV,
+  OP_MOD
+} macro_op_t;
+
+typedef struct {
+  macro_op_t op;
+  union {
+    long long i; /* OP_INT */
+    double f;    /* OP_FLOAT */
+    size_t s;    /* Every other push: string offset */
+  } arg;
+} macro_insn_t;
+
+struct cdd_macro_program_t {
+  macro_insn_t *code;
+  size_t n_code;
+  size_t cap_code;
+  char *strings; /* NUL-terminated literals, macro and type names */
+  size_t strings_len;
+  size_t strings_cap;
+  size_t max_depth; /* Deepest the value stack gets */
+};
+
 typedef struct {
   macro_lexer_t lex;
-  struct PreprocessorContext *ctx;
-  int err;
+  cdd_macro_program_t *prog;
+  size_t depth;
+  cdd_c_error_t err;
 } parser_t;
 
-static cdd_macro_eval_result_t parse_expr(parser_t *p);
-static cdd_macro_eval_result_t parse_logical_or(parser_t *p);
-static cdd_macro_eval_result_t parse_logical_and(parser_t *p);
-static cdd_macro_eval_result_t parse_bitwise_or(parser_t *p);
-static cdd_macro_eval_result_t parse_bitwise_xor(parser_t *p);
-static cdd_macro_eval_result_t parse_bitwise_and(parser_t *p);
-static cdd_macro_eval_result_t parse_equality(parser_t *p);
-static cdd_macro_eval_result_t parse_relational(parser_t *p);
-static cdd_macro_eval_result_t parse_shift(parser_t *p);
-static cdd_macro_eval_result_t parse_additive(parser_t *p);
-static cdd_macro_eval_result_t parse_multiplicative(parser_t *p);
-static cdd_macro_eval_result_t parse_unary(parser_t *p);
-static cdd_macro_eval_result_t parse_primary(parser_t *p);
+/* Binary operators by precedence level, loosest first */
+static const struct {
+  macro_tok_kind_t tok;
+  int level;
+  macro_op_t op;
+} binary_ops[] = {{TOK_PIPEPIPE, 0, OP_LOR}, {TOK_AMPAMP, 1, OP_LAND},
+                  {TOK_PIPE, 2, OP_BOR},     {TOK_CARET, 3, OP_BXOR},
+                  {TOK_AMP, 4, OP_BAND},     {TOK_EQEQ, 5, OP_EQ},
+                  {TOK_NEQ, 5, OP_NE},       {TOK_LT, 6, OP_LT},
+                  {TOK_LTE, 6, OP_LE},       {TOK_GT, 6, OP_GT},
+                  {TOK_GTE, 6, OP_GE},       {TOK_LSHIFT, 7, OP_SHL},
+                  {TOK_RSHIFT, 7, OP_SHR},   {TOK_PLUS, 8, OP_ADD},
+                  {TOK_MINUS, 8, OP_SUB},    {TOK_STAR, 9, OP_MUL},
+                  {TOK_SLASH, 9, OP_DIV},    {TOK_PERCENT, 9, OP_MOD}};
+
+#define BINARY_LEVELS 10
+
+static int binary_op(macro_tok_kind_t kind, int level, macro_op_t *op) {
+  size_t i;
+  for (i = 0; i < sizeof(binary_ops) / sizeof(binary_ops[0]); i++) {
+    if (binary_ops[i].tok == kind && binary_ops[i].level == level) {
+      *op = binary_ops[i].op;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static macro_insn_t *emit(parser_t *p, macro_op_t op) {
+  cdd_macro_program_t *prog = p->prog;
+  macro_insn_t *insn;
+
+  if (p->err)
+    return NULL;
+  if (prog->n_code == prog->cap_code) {
+    size_t cap = prog->cap_code ? prog->cap_code * 2 : 16;
+    macro_insn_t *code = (macro_insn_t *)C_CDD_REALLOC(
+        prog->code, cap * sizeof(macro_insn_t));
+    if (!code) {
+      p->err = CDD_C_ERROR_MEMORY;
+      return NULL;
+    }
+    prog->code = code;
+    prog->cap_code = cap;
+  }
+  insn = &prog->code[prog->n_code++];
+  insn->op = op;
+  insn->arg.i = 0;
+
+  if (op < OP_NEG) {
+    if (++p->depth > prog->max_depth)
+      prog->max_depth = p->depth;
+  } else if (op >= OP_LOR) {
+    p->depth--;
+  }
+  return insn;
+}
+
+static void emit_string(parser_t *p, macro_op_t op, const char *s) {
+  cdd_macro_program_t *prog = p->prog;
+  size_t len = strlen(s);
+  macro_insn_t *insn = emit(p, op);
+
+  if (!insn)
+    return;
+  if (prog->strings_len + len + 1 > prog->strings_cap) {
+    size_t cap = prog->strings_cap ? prog->strings_cap : 32;
+    char *strings;
+    while (cap < prog->strings_len + len + 1)
+      cap *= 2;
+    strings = (char *)C_CDD_REALLOC(prog->strings, cap);
+    if (!strings) {
+      p->err = CDD_C_ERROR_MEMORY;
+      return;
+    }
+    prog->strings = strings;
+    prog->strings_cap = cap;
+  }
+  insn->arg.s = prog->strings_len;
+  memcpy(prog->strings + prog->strings_len, s, len + 1);
+  prog->strings_len += len + 1;
+}
+
+static void parse_binary(parser_t *p, int level);
+
+/* `sizeof(T)` / `_Alignof(T)`, for the primitive types the layout code
+ * knows; any pointer is sized as `ptr` */
+static void parse_type_query(parser_t *p, macro_op_t op) {
+  char name[64];
+  size_t len = 0;
+  int is_pointer = 0;
+
+  next_tok(&p->lex);
+  if (p->lex.cur.kind != TOK_LPAREN) {
+    p->err = CDD_C_ERROR_INVALID_ARGUMENT;
+    return;
+  }
+  next_tok(&p->lex);
+  while (p->lex.cur.kind == TOK_IDENT || p->lex.cur.kind == TOK_STAR) {
+    if (p->lex.cur.kind == TOK_STAR) {
+      is_pointer = 1;
+    } else if (strcmp(p->lex.cur.str_val, "const") != 0 &&
+               strcmp(p->lex.cur.str_val, "volatile") != 0) {
+      size_t n = strlen(p->lex.cur.str_val);
+      if (len + n + 2 > sizeof(name)) {
+        p->err = CDD_C_ERROR_INVALID_ARGUMENT;
+        return;
+      }
+      if (len > 0)
+        name[len++] = ' ';
+      memcpy(name + len, p->lex.cur.str_val, n);
+      len += n;
+    }
+    next_tok(&p->lex);
+  }
+  if (p->lex.cur.kind != TOK_RPAREN || len == 0) {
+    p->err = CDD_C_ERROR_INVALID_ARGUMENT;
+    return;
+  }
+  name[len] = '\0';
+  emit_string(p, op, is_pointer ? "ptr" : name);
+  next_tok(&p->lex);
+}
+
+/* `defined X` / `defined(X)` */
+static void parse_defined(parser_t *p) {
+  int paren;
+
+  next_tok(&p->lex);
+  paren = p->lex.cur.kind == TOK_LPAREN;
+  if (paren)
+    next_tok(&p->lex);
+  if (p->lex.cur.kind != TOK_IDENT) {
+    p->err = CDD_C_ERROR_INVALID_ARGUMENT;
+    return;
+  }
+  emit_string(p, OP_DEFINED, p->lex.cur.str_val);
+  next_tok(&p->lex);
+  if (paren) {
+    if (p->lex.cur.kind != TOK_RPAREN) {
+      if (!p->err)
+        p->err = CDD_C_ERROR_INVALID_ARGUMENT;
+      return;
+    }
+    next_tok(&p->lex);
+  }
+}
+
+/* The parenthesised operand following the current token, read as raw text
+ * since header names and scoped attributes are not expression tokens. On
+ * success the lexer continues after the closing `)`. */
+static int raw_operand(parser_t *p, const char **text, size_t *len) {
+  macro_lexer_t *lex = &p->lex;
+  size_t pos = lex->pos, end;
+  int depth = 1;
+
+  while (pos < lex->len && isspace((unsigned char)lex->str[pos]))
+    pos++;
+  if (pos >= lex->len || lex->str[pos] != '(')
+    return 0;
+  pos++;
+  while (pos < lex->len && isspace((unsigned char)lex->str[pos]))
+    pos++;
+  for (end = pos; end < lex->len; end++) {
+    char c = lex->str[end];
+    if (c == '"') {
+      while (++end < lex->len && lex->str[end] != '"')
+        ;
+    } else if (c == '(') {
+      depth++;
+    } else if (c == ')' && --depth == 0) {
+      break;
+    }
+  }
+  if (end >= lex->len)
+    return 0;
+  lex->pos = end + 1;
+  while (end > pos && isspace((unsigned char)lex->str[end - 1]))
+    end--;
+  *text = lex->str + pos;
+  *len = end - pos;
+  return 1;
+}
+
+/* `__has_include(...)` / `__has_embed(...)`; embed parameters after the
+ * header name do not change whether it is found */
+static void parse_has_include(parser_t *p) {
+  const char *text;
+  size_t len, end;
+  char path[512];
+  char close;
+
+  if (!raw_operand(p, &text, &len) || len < 2 ||
+      (text[0] != '"' && text[0] != '<')) {
+    p->err = CDD_C_ERROR_INVALID_ARGUMENT;
+    return;
+  }
+  close = text[0] == '"' ? '"' : '>';
+  for (end = 1; end < len && text[end] != close; end++)
+    ;
+  if (end >= len || end > sizeof(path)) {
+    p->err = CDD_C_ERROR_INVALID_ARGUMENT;
+    return;
+  }
+  memcpy(path, text + 1, end - 1);
+  path[end - 1] = '\0';
+  emit_string(p, close == '"' ? OP_HAS_INCLUDE : OP_HAS_INCLUDE_SYS, path);
+  next_tok(&p->lex);
+}
+
+/* `__has_c_attribute(name)`, answered from the C23 standard attributes;
+ * scoped (vendor) attributes are reported as unsupported */
+static void parse_has_c_attribute(parser_t *p) {
+  static const struct {
+    const char *name;
+    long long version;
+  } attributes[] = {{"deprecated", 201904L},   {"fallthrough", 201904L},
+                    {"maybe_unused", 201904L}, {"nodiscard", 201904L},
+                    {"noreturn", 202202L},     {"unsequenced", 202311L},
+                    {"reproducible", 202311L}};
+  const char *text;
+  size_t len, i;
+  macro_insn_t *insn;
+  long long version = 0;
+
+  if (!raw_operand(p, &text, &len)) {
+    p->err = CDD_C_ERROR_INVALID_ARGUMENT;
+    return;
+  }
+  for (i = 0; i < sizeof(attributes) / sizeof(attributes[0]); i++) {
+    if (strlen(attributes[i].name) == len &&
+        strncmp(attributes[i].name, text, len) == 0)
+      version = attributes[i].version;
+  }
+  if ((insn = emit(p, OP_INT)) != NULL)
+    insn->arg.i = version;
+  next_tok(&p->lex);
+}
+
+static void parse_primary(parser_t *p) {
+  macro_insn_t *insn;
+
+  switch (p->lex.cur.kind) {
+  case TOK_INT:
+    if ((insn = emit(p, OP_INT)) != NULL)
+      insn->arg.i = p->lex.cur.int_val;
+    break;
+  case TOK_FLOAT:
+    if ((insn = emit(p, OP_FLOAT)) != NULL)
+      insn->arg.f = p->lex.cur.float_val;
+    break;
+  case TOK_STR:
+    emit_string(p, OP_STR, p->lex.cur.str_val);
+    break;
+  case TOK_IDENT:
+    if (strcmp(p->lex.cur.str_val, "sizeof") == 0) {
+      parse_type_query(p, OP_SIZEOF);
+      return;
+    }
+    if (strcmp(p->lex.cur.str_val, "_Alignof") == 0 ||
+        strcmp(p->lex.cur.str_val, "alignof") == 0) {
+      parse_type_query(p, OP_ALIGNOF);
+      return;
+    }
+    if (strcmp(p->lex.cur.str_val, "defined") == 0) {
+      parse_defined(p);
+      return;
+    }
+    if (strcmp(p->lex.cur.str_val, "__has_include") == 0 ||
+        strcmp(p->lex.cur.str_val, "__has_embed") == 0) {
+      parse_has_include(p);
+      return;
+    }
+    if (strcmp(p->lex.cur.str_val, "__has_c_attribute") == 0) {
+      parse_has_c_attribute(p);
+      return;
+    }
+    /* Macro reference, resolved when the program runs */
+    emit_string(p, OP_MACRO, p->lex.cur.str_val);
+    break;
+  case TOK_LPAREN:
+    next_tok(&p->lex);
+    parse_binary(p, 0);
+    if (p->lex.cur.kind != TOK_RPAREN && !p->err)
+      p->err = CDD_C_ERROR_INVALID_ARGUMENT;
+    break;
+  default:
+    if (!p->err)
+      p->err = CDD_C_ERROR_INVALID_ARGUMENT;
+    return;
+  }
+  next_tok(&p->lex);
+}
+
+static void parse_unary(parser_t *p) {
+  macro_op_t op;
+
+  switch (p->lex.cur.kind) {
+  case TOK_PLUS:
+    next_tok(&p->lex);
+    parse_unary(p);
+    return;
+  case TOK_MINUS:
+    op = OP_NEG;
+    break;
+  case TOK_TILDE:
+    op = OP_BNOT;
+    break;
+  case TOK_BANG:
+    op = OP_LNOT;
+    break;
+  default:
+    parse_primary(p);
+    return;
+  }
+  next_tok(&p->lex);
+  parse_unary(p);
+  emit(p, op);
+}
+
+static void parse_binary(parser_t *p, int level) {
+  macro_op_t op;
+
+  if (level == BINARY_LEVELS) {
+    parse_unary(p);
+    return;
+  }
+  parse_binary(p, level + 1);
+  while (!p->err && binary_op(p->lex.cur.kind, level, &op)) {
+    next_tok(&p->lex);
+    parse_binary(p, level + 1);
+    emit(p, op);
+  }
+}
+
+cdd_c_error_t cdd_macro_compile(const char *expression,
+                                cdd_macro_program_t **out_program) {
+  parser_t p;
+
+  if (!expression || !out_program)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out_program = NULL;
+
+  p.prog = (cdd_macro_program_t *)C_CDD_CALLOC(1, sizeof(cdd_macro_program_t));
+  if (!p.prog)
+    return CDD_C_ERROR_MEMORY;
+  p.depth = 0;
+  p.err = CDD_C_SUCCESS;
+  p.lex.str = expression;
+  p.lex.pos = 0;
+  p.lex.len = strlen(expression);
+  p.lex.cur.kind = TOK_EOF;
+  p.lex.cur.str_val = NULL;
+
+  next_tok(&p.lex);
+  if (p.lex.cur.kind == TOK_EOF)
+    p.err = CDD_C_ERROR_INVALID_ARGUMENT;
+  else
+    parse_binary(&p, 0);
+  if (!p.err && p.lex.cur.kind != TOK_EOF)
+    p.err = CDD_C_ERROR_INVALID_ARGUMENT;
+  free_tok(&p.lex.cur);
+
+  if (p.err) {
+    cdd_macro_program_free(p.prog);
+    return p.err;
+  }
+  *out_program = p.prog;
+  return CDD_C_SUCCESS;
+}
+
+void cdd_macro_program_free(cdd_macro_program_t *program) {
+  if (!program)
+    return;
+  C_CDD_FREE(program->code);
+  C_CDD_FREE(program->strings);
+  C_CDD_FREE(program);
+}
+
+/* --- Interpreter --- */
 
 static cdd_macro_eval_result_t make_err(void) {
   cdd_macro_eval_result_t r;
@@ -330,346 +842,324 @@ static void promote(cdd_macro_eval_result_t *a, cdd_macro_eval_result_t *b) {
   }
 }
 
-static cdd_macro_eval_result_t parse_expr(parser_t *p) {
-  return parse_logical_or(p);
+static int truth(const cdd_macro_eval_result_t *v) {
+  return v->type == MACRO_EVAL_TYPE_INT ? v->int_val != 0
+                                        : v->float_val != 0;
 }
 
-static cdd_macro_eval_result_t parse_logical_or(parser_t *p) {
-  cdd_macro_eval_result_t left = parse_logical_and(p);
-  while (p->lex.cur.kind == TOK_PIPEPIPE) {
-    cdd_macro_eval_result_t right;
-    next_tok(&p->lex);
-    right = parse_logical_and(p);
-    if (p->err)
-      return make_err();
-    left = make_int(
-        (left.type == MACRO_EVAL_TYPE_INT ? left.int_val : left.float_val) ||
-        (right.type == MACRO_EVAL_TYPE_INT ? right.int_val : right.float_val));
-  }
-  return left;
+static char *dup_str(const char *s) {
+  size_t len = strlen(s);
+  char *copy = (char *)C_CDD_MALLOC(len + 1);
+  if (copy)
+    memcpy(copy, s, len + 1);
+  return copy;
 }
 
-static cdd_macro_eval_result_t parse_logical_and(parser_t *p) {
-  cdd_macro_eval_result_t left = parse_bitwise_or(p);
-  while (p->lex.cur.kind == TOK_AMPAMP) {
-    cdd_macro_eval_result_t right;
-    next_tok(&p->lex);
-    right = parse_bitwise_or(p);
-    if (p->err)
-      return make_err();
-    left = make_int(
-        (left.type == MACRO_EVAL_TYPE_INT ? left.int_val : left.float_val) &&
-        (right.type == MACRO_EVAL_TYPE_INT ? right.int_val : right.float_val));
-  }
-  return left;
+static enum cdd_cst_abi_model_t host_abi(void) {
+  if (sizeof(void *) == 4)
+    return CDD_CST_ABI_ILP32;
+  if (sizeof(long) == 4)
+    return CDD_CST_ABI_LLP64;
+  return CDD_CST_ABI_LP64;
 }
 
-static cdd_macro_eval_result_t parse_bitwise_or(parser_t *p) {
-  cdd_macro_eval_result_t left = parse_bitwise_xor(p);
-  while (p->lex.cur.kind == TOK_PIPE) {
-    cdd_macro_eval_result_t right;
-    next_tok(&p->lex);
-    right = parse_bitwise_xor(p);
-    if (left.type != MACRO_EVAL_TYPE_INT || right.type != MACRO_EVAL_TYPE_INT) {
-      p->err = 1;
-      return make_err();
-    }
-    left = make_int(left.int_val | right.int_val);
-  }
-  return left;
-}
+/* Replaces `*v` with `op v`. Strings only survive negation. */
+static cdd_c_error_t apply_unary(macro_op_t op, cdd_macro_eval_result_t *v) {
+  cdd_macro_eval_result_t r = *v;
 
-static cdd_macro_eval_result_t parse_bitwise_xor(parser_t *p) {
-  cdd_macro_eval_result_t left = parse_bitwise_and(p);
-  while (p->lex.cur.kind == TOK_CARET) {
-    cdd_macro_eval_result_t right;
-    next_tok(&p->lex);
-    right = parse_bitwise_and(p);
-    if (left.type != MACRO_EVAL_TYPE_INT || right.type != MACRO_EVAL_TYPE_INT) {
-      p->err = 1;
-      return make_err();
-    }
-    left = make_int(left.int_val ^ right.int_val);
+  switch (op) {
+  case OP_NEG:
+    if (r.type == MACRO_EVAL_TYPE_INT)
+      v->int_val = -r.int_val;
+    else
+      v->float_val = -r.float_val;
+    return CDD_C_SUCCESS;
+  case OP_BNOT:
+    if (r.type != MACRO_EVAL_TYPE_INT)
+      break;
+    v->int_val = ~r.int_val;
+    return CDD_C_SUCCESS;
+  default:
+    cdd_macro_eval_result_free(v);
+    *v = make_int(!truth(&r));
+    return CDD_C_SUCCESS;
   }
-  return left;
+  cdd_macro_eval_result_free(v);
+  *v = make_err();
+  return CDD_C_ERROR_INVALID_ARGUMENT;
 }
 
-static cdd_macro_eval_result_t parse_bitwise_and(parser_t *p) {
-  cdd_macro_eval_result_t left = parse_equality(p);
-  while (p->lex.cur.kind == TOK_AMP) {
-    cdd_macro_eval_result_t right;
-    next_tok(&p->lex);
-    right = parse_equality(p);
-    if (left.type != MACRO_EVAL_TYPE_INT || right.type != MACRO_EVAL_TYPE_INT) {
-      p->err = 1;
-      return make_err();
-    }
-    left = make_int(left.int_val & right.int_val);
-  }
-  return left;
-}
+/* Replaces `*a` with `a op b`; both operands are consumed. */
+static cdd_c_error_t apply_binary(macro_op_t op, cdd_macro_eval_result_t *a,
+                                  cdd_macro_eval_result_t *b) {
+  cdd_macro_eval_result_t l = *a, r = *b, res = make_err();
+  int ints = l.type == MACRO_EVAL_TYPE_INT && r.type == MACRO_EVAL_TYPE_INT;
+  int ok = 1;
 
-static cdd_macro_eval_result_t parse_equality(parser_t *p) {
-  cdd_macro_eval_result_t left = parse_relational(p);
-  while (p->lex.cur.kind == TOK_EQEQ || p->lex.cur.kind == TOK_NEQ) {
-    macro_tok_kind_t op = p->lex.cur.kind;
-    cdd_macro_eval_result_t right;
-    next_tok(&p->lex);
-    right = parse_relational(p);
-    if (p->err)
-      return make_err();
-    promote(&left, &right);
-    if (left.type == MACRO_EVAL_TYPE_INT) {
-      left = make_int(op == TOK_EQEQ ? (left.int_val == right.int_val)
-                                     : (left.int_val != right.int_val));
-    } else {
-      left = make_int(op == TOK_EQEQ ? (left.float_val == right.float_val)
-                                     : (left.float_val != right.float_val));
+  switch (op) {
+  case OP_LOR:
+    res = make_int(truth(&l) || truth(&r));
+    break;
+  case OP_LAND:
+    res = make_int(truth(&l) && truth(&r));
+    break;
+  case OP_BOR:
+  case OP_BXOR:
+  case OP_BAND:
+  case OP_SHL:
+  case OP_SHR:
+  case OP_MOD:
+    if (!ints || (op == OP_MOD && r.int_val == 0)) {
+      ok = 0;
+      break;
     }
-  }
-  return left;
-}
-
-static cdd_macro_eval_result_t parse_relational(parser_t *p) {
-  cdd_macro_eval_result_t left = parse_shift(p);
-  while (p->lex.cur.kind == TOK_LT || p->lex.cur.kind == TOK_LTE ||
-         p->lex.cur.kind == TOK_GT || p->lex.cur.kind == TOK_GTE) {
-    macro_tok_kind_t op = p->lex.cur.kind;
-    cdd_macro_eval_result_t right;
-    next_tok(&p->lex);
-    right = parse_shift(p);
-    if (p->err)
-      return make_err();
-    promote(&left, &right);
-    if (left.type == MACRO_EVAL_TYPE_INT) {
-      if (op == TOK_LT)
-        left = make_int(left.int_val < right.int_val);
-      else if (op == TOK_LTE)
-        left = make_int(left.int_val <= right.int_val);
-      else if (op == TOK_GT)
-        left = make_int(left.int_val > right.int_val);
-      else
-        left = make_int(left.int_val >= right.int_val);
+    res = make_int(op == OP_BOR    ? l.int_val | r.int_val
+                   : op == OP_BXOR ? l.int_val ^ r.int_val
+                   : op == OP_BAND ? l.int_val & r.int_val
+                   : op == OP_SHL  ? l.int_val << r.int_val
+                   : op == OP_SHR  ? l.int_val >> r.int_val
+                                   : l.int_val % r.int_val);
+    break;
+  case OP_EQ:
+  case OP_NE:
+  case OP_LT:
+  case OP_LE:
+  case OP_GT:
+  case OP_GE:
+    promote(&l, &r);
+    if (l.type == MACRO_EVAL_TYPE_INT)
+      res = make_int(op == OP_EQ   ? l.int_val == r.int_val
+                     : op == OP_NE ? l.int_val != r.int_val
+                     : op == OP_LT ? l.int_val < r.int_val
+                     : op == OP_LE ? l.int_val <= r.int_val
+                     : op == OP_GT ? l.int_val > r.int_val
+                                   : l.int_val >= r.int_val);
+    else
+      res = make_int(op == OP_EQ   ? l.float_val == r.float_val
+                     : op == OP_NE ? l.float_val != r.float_val
+                     : op == OP_LT ? l.float_val < r.float_val
+                     : op == OP_LE ? l.float_val <= r.float_val
+                     : op == OP_GT ? l.float_val > r.float_val
+                                   : l.float_val >= r.float_val);
+    break;
+  default:
+    promote(&l, &r);
+    if (l.type == MACRO_EVAL_TYPE_INT) {
+      if (op == OP_DIV && r.int_val == 0) {
+        ok = 0;
+        break;
+      }
+      res = make_int(op == OP_ADD   ? l.int_val + r.int_val
+                     : op == OP_SUB ? l.int_val - r.int_val
+                     : op == OP_MUL ? l.int_val * r.int_val
+                                    : l.int_val / r.int_val);
     } else {
-      if (op == TOK_LT)
-        left = make_int(left.float_val < right.float_val);
-      else if (op == TOK_LTE)
-        left = make_int(left.float_val <= right.float_val);
-      else if (op == TOK_GT)
-        left = make_int(left.float_val > right.float_val);
-      else
-        left = make_int(left.float_val >= right.float_val);
+      res = make_float(op == OP_ADD   ? l.float_val + r.float_val
+                       : op == OP_SUB ? l.float_val - r.float_val
+                       : op == OP_MUL ? l.float_val * r.float_val
+                                      : l.float_val / r.float_val);
     }
+    break;
   }
-  return left;
-}
 
-static cdd_macro_eval_result_t parse_shift(parser_t *p) {
-  cdd_macro_eval_result_t left = parse_additive(p);
-  while (p->lex.cur.kind == TOK_LSHIFT || p->lex.cur.kind == TOK_RSHIFT) {
-    macro_tok_kind_t op = p->lex.cur.kind;
-    cdd_macro_eval_result_t right;
-    next_tok(&p->lex);
-    right = parse_additive(p);
-    if (left.type != MACRO_EVAL_TYPE_INT || right.type != MACRO_EVAL_TYPE_INT) {
-      p->err = 1;
-      return make_err();
-    }
-    if (op == TOK_LSHIFT)
-      left = make_int(left.int_val << right.int_val);
-    else
-      left = make_int(left.int_val >> right.int_val);
-  }
-  return left;
+  cdd_macro_eval_result_free(a);
+  cdd_macro_eval_result_free(b);
+  *a = res;
+  return ok ? CDD_C_SUCCESS : CDD_C_ERROR_INVALID_ARGUMENT;
 }
 
-static cdd_macro_eval_result_t parse_additive(parser_t *p) {
-  cdd_macro_eval_result_t left = parse_multiplicative(p);
-  while (p->lex.cur.kind == TOK_PLUS || p->lex.cur.kind == TOK_MINUS) {
-    macro_tok_kind_t op = p->lex.cur.kind;
-    cdd_macro_eval_result_t right;
-    next_tok(&p->lex);
-    right = parse_multiplicative(p);
-    if (p->err)
-      return make_err();
-    promote(&left, &right);
-    if (left.type == MACRO_EVAL_TYPE_INT) {
-      if (op == TOK_PLUS)
-        left = make_int(left.int_val + right.int_val);
-      else
-        left = make_int(left.int_val - right.int_val);
-    } else {
-      if (op == TOK_PLUS)
-        left = make_float(left.float_val + right.float_val);
-      else
-        left = make_float(left.float_val - right.float_val);
-    }
+static struct MacroDef *find_macro(const struct PreprocessorContext *ctx,
+                                   const char *name) {
+  size_t i;
+  if (!ctx)
+    return NULL;
+  for (i = 0; i < ctx->macro_count; i++) {
+    if (ctx->macros[i].name && strcmp(ctx->macros[i].name, name) == 0)
+      return &ctx->macros[i];
   }
-  return left;
+  return NULL;
 }
 
-static cdd_macro_eval_result_t parse_multiplicative(parser_t *p) {
-  cdd_macro_eval_result_t left = parse_unary(p);
-  while (p->lex.cur.kind == TOK_STAR || p->lex.cur.kind == TOK_SLASH ||
-         p->lex.cur.kind == TOK_PERCENT) {
-    macro_tok_kind_t op = p->lex.cur.kind;
-    cdd_macro_eval_result_t right;
-    next_tok(&p->lex);
-    right = parse_unary(p);
-    if (p->err)
-      return make_err();
-    if (op == TOK_PERCENT) {
-      if (left.type != MACRO_EVAL_TYPE_INT || right.int_val == 0) {
-        p->err = 1;
-        return make_err();
-      }
-      left = make_int(left.int_val % right.int_val);
-    } else {
-      promote(&left, &right);
-      if (left.type == MACRO_EVAL_TYPE_INT) {
-        if (op == TOK_SLASH && right.int_val == 0) {
-          p->err = 1;
-          return make_err();
-        }
-        if (op == TOK_STAR)
-          left = make_int(left.int_val * right.int_val);
-        else
-          left = make_int(left.int_val / right.int_val);
-      } else {
-        if (op == TOK_STAR)
-          left = make_float(left.float_val * right.float_val);
-        else
-          left = make_float(left.float_val / right.float_val);
-      }
-    }
-  }
-  return left;
+static cdd_c_error_t load_macro(const struct PreprocessorContext *ctx,
+                                const char *name,
+                                cdd_macro_eval_result_t *out) {
+  struct MacroDef *def = find_macro(ctx, name);
+  if (def)
+    return cdd_macro_value(ctx, def, out);
+  /* Unknown identifier, typical C preprocessor treats it as 0 */
+  *out = make_int(0);
+  return CDD_C_SUCCESS;
 }
 
-static cdd_macro_eval_result_t parse_unary(parser_t *p) {
-  if (p->lex.cur.kind == TOK_PLUS) {
-    next_tok(&p->lex);
-    return parse_unary(p);
-  }
-  if (p->lex.cur.kind == TOK_MINUS) {
-    cdd_macro_eval_result_t r;
-    next_tok(&p->lex);
-    r = parse_unary(p);
-    if (r.type == MACRO_EVAL_TYPE_INT)
-      r.int_val = -r.int_val;
-    else
-      r.float_val = -r.float_val;
-    return r;
-  }
-  if (p->lex.cur.kind == TOK_TILDE) {
-    cdd_macro_eval_result_t r;
-    next_tok(&p->lex);
-    r = parse_unary(p);
-    if (r.type != MACRO_EVAL_TYPE_INT) {
-      p->err = 1;
-      return make_err();
-    }
-    r.int_val = ~r.int_val;
-    return r;
-  }
-  if (p->lex.cur.kind == TOK_BANG) {
-    cdd_macro_eval_result_t r;
-    next_tok(&p->lex);
-    r = parse_unary(p);
-    if (r.type == MACRO_EVAL_TYPE_INT)
-      r.int_val = !r.int_val;
-    else
-      r.int_val = !r.float_val;
-    r.type = MACRO_EVAL_TYPE_INT;
-    return r;
+cdd_c_error_t cdd_macro_program_run(const cdd_macro_program_t *program,
+                                    const struct PreprocessorContext *ctx,
+                                    cdd_macro_eval_result_t *out_result) {
+  cdd_macro_eval_result_t local[16];
+  cdd_macro_eval_result_t *stack = local;
+  size_t sp = 0, pc;
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+
+  if (!program || !out_result)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (program->max_depth > sizeof(local) / sizeof(local[0])) {
+    stack = (cdd_macro_eval_result_t *)C_CDD_MALLOC(
+        program->max_depth * sizeof(cdd_macro_eval_result_t));
+    if (!stack)
+      return CDD_C_ERROR_MEMORY;
   }
-  return parse_primary(p);
-}
 
-static cdd_macro_eval_result_t parse_primary(parser_t *p) {
-  cdd_macro_eval_result_t r = make_err();
-  if (p->lex.cur.kind == TOK_INT) {
-    r = make_int(p->lex.cur.int_val);
-    next_tok(&p->lex);
-  } else if (p->lex.cur.kind == TOK_FLOAT) {
-    r = make_float(p->lex.cur.float_val);
-    next_tok(&p->lex);
-  } else if (p->lex.cur.kind == TOK_STR) {
-    r.type = MACRO_EVAL_TYPE_STRING;
-    r.str_val = strdup(p->lex.cur.str_val);
-    next_tok(&p->lex);
-  } else if (p->lex.cur.kind == TOK_IDENT) {
-    /* macro reference */
-    struct MacroDef *def = NULL;
-    {
-      size_t i;
-      for (i = 0; i < p->ctx->macro_count; i++) {
-        if (strcmp(p->ctx->macros[i].name, p->lex.cur.str_val) == 0) {
-          def = &p->ctx->macros[i];
-          break;
-        }
-      }
+  for (pc = 0; pc < program->n_code && rc == CDD_C_SUCCESS; pc++) {
+    const macro_insn_t *insn = &program->code[pc];
+
+    switch (insn->op) {
+    case OP_INT:
+      stack[sp++] = make_int(insn->arg.i);
+      break;
+    case OP_FLOAT:
+      stack[sp++] = make_float(insn->arg.f);
+      break;
+    case OP_STR:
+      stack[sp] = make_err();
+      stack[sp].type = MACRO_EVAL_TYPE_STRING;
+      stack[sp].str_val = dup_str(program->strings + insn->arg.s);
+      if (stack[sp].str_val)
+        sp++;
+      else
+        rc = CDD_C_ERROR_MEMORY;
+      break;
+    case OP_MACRO:
+      rc = load_macro(ctx, program->strings + insn->arg.s, &stack[sp]);
+      if (rc == CDD_C_SUCCESS)
+        sp++;
+      break;
+    case OP_DEFINED:
+      stack[sp++] =
+          make_int(find_macro(ctx, program->strings + insn->arg.s) != NULL);
+      break;
+    case OP_HAS_INCLUDE:
+    case OP_HAS_INCLUDE_SYS: {
+      int found = 0;
+      rc = pp_has_include(ctx, program->strings + insn->arg.s,
+                          insn->op == OP_HAS_INCLUDE_SYS, &found);
+      if (rc == CDD_C_SUCCESS)
+        stack[sp++] = make_int(found);
+      break;
     }
-    if (def) {
-      cdd_macro_eval_result_t ref_res;
-      if (cdd_macro_evaluate(p->ctx, def->value, &ref_res) == 0) {
-        r = ref_res;
-      } else {
-        p->err = 1;
+    case OP_SIZEOF:
+    case OP_ALIGNOF: {
+      cdd_cst_type_info_t info;
+      if (cdd_cst_eval_primitive_type(program->strings + insn->arg.s,
+                                      host_abi(), &info) != 0) {
+        rc = CDD_C_ERROR_INVALID_ARGUMENT;
+        break;
       }
-    } else {
-      /* Unknown identifier, typical C preprocessor treats it as 0 */
-      r = make_int(0);
+      stack[sp++] = make_int(
+          (long long)(insn->op == OP_SIZEOF ? info.size : info.alignment));
+      break;
     }
-    next_tok(&p->lex);
-  } else if (p->lex.cur.kind == TOK_LPAREN) {
-    next_tok(&p->lex);
-    r = parse_expr(p);
-    if (p->lex.cur.kind == TOK_RPAREN) {
-      next_tok(&p->lex);
-    } else {
-      p->err = 1;
+    case OP_NEG:
+    case OP_BNOT:
+    case OP_LNOT:
+      rc = apply_unary(insn->op, &stack[sp - 1]);
+      break;
+    default:
+      rc = apply_binary(insn->op, &stack[sp - 2], &stack[sp - 1]);
+      sp--;
+      break;
     }
-  } else {
-    p->err = 1;
   }
-  return r;
+
+  if (rc == CDD_C_SUCCESS)
+    *out_result = stack[--sp];
+  while (sp > 0)
+    cdd_macro_eval_result_free(&stack[--sp]);
+  if (stack != local)
+    C_CDD_FREE(stack);
+  return rc;
 }
 
-cdd_c_error_t cdd_macro_evaluate(struct PreprocessorContext *ctx,
-                                 const char *expression,
-                                 cdd_macro_eval_result_t *out_result) {
-  parser_t p;
+static cdd_c_error_t copy_value(const struct MacroValue *memo,
+                                cdd_macro_eval_result_t *out) {
+  *out = make_err();
+  out->type = (cdd_macro_eval_type_t)memo->type;
+  out->int_val = memo->int_val;
+  out->float_val = memo->float_val;
+  if (memo->str_val) {
+    out->str_val = dup_str(memo->str_val);
+    if (!out->str_val)
+      return CDD_C_ERROR_MEMORY;
+  }
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t cdd_macro_value(const struct PreprocessorContext *ctx,
+                              struct MacroDef *def,
+                              cdd_macro_eval_result_t *out_result) {
+  struct MacroValue *memo;
   cdd_macro_eval_result_t r;
+  cdd_c_error_t rc;
 
-  if (!ctx || !expression)
+  if (!ctx || !def || !out_result)
     return CDD_C_ERROR_INVALID_ARGUMENT;
+  memo = &def->memo;
 
-  p.ctx = ctx;
-  p.err = 0;
-  p.lex.str = expression;
-  p.lex.pos = 0;
-  p.lex.len = strlen(expression);
-  p.lex.cur.kind = TOK_EOF;
-  p.lex.cur.str_val = NULL;
+  if (memo->state != MACRO_VALUE_UNSET &&
+      memo->generation == ctx->macro_generation) {
+    if (memo->state == MACRO_VALUE_DONE)
+      return copy_value(memo, out_result);
+    /* Failed before, or refers back to itself */
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  }
 
-  next_tok(&p.lex);
+  if (memo->str_val) {
+    C_CDD_FREE(memo->str_val);
+    memo->str_val = NULL;
+  }
+  memo->state = MACRO_VALUE_BUSY;
+  memo->generation = ctx->macro_generation;
 
-  if (p.lex.cur.kind == TOK_EOF) {
-    return CDD_C_ERROR_INVALID_ARGUMENT;
+  /* The program outlives the memo: it is only dropped when the definition
+   * itself is replaced or removed */
+  rc = CDD_C_SUCCESS;
+  if (!def->program) {
+    rc = def->value && !def->program_failed
+             ? cdd_macro_compile(def->value, &def->program)
+             : CDD_C_ERROR_INVALID_ARGUMENT;
+    if (rc == CDD_C_ERROR_INVALID_ARGUMENT)
+      def->program_failed = 1;
   }
+  if (rc == CDD_C_SUCCESS)
+    rc = cdd_macro_program_run(def->program, ctx, &r);
 
-  r = parse_expr(&p);
+  if (rc != CDD_C_SUCCESS) {
+    /* Running out of memory says nothing about the macro; retry next time */
+    memo->state =
+        rc == CDD_C_ERROR_MEMORY ? MACRO_VALUE_UNSET : MACRO_VALUE_FAILED;
+    return rc;
+  }
+  memo->state = MACRO_VALUE_DONE;
+  memo->type = (int)r.type;
+  memo->int_val = r.int_val;
+  memo->float_val = r.float_val;
+  memo->str_val = r.str_val;
+  return copy_value(memo, out_result);
+}
 
-  free_tok(&p.lex.cur);
+cdd_c_error_t cdd_macro_evaluate(struct PreprocessorContext *ctx,
+                                 const char *expression,
+                                 cdd_macro_eval_result_t *out_result) {
+  cdd_macro_program_t *program = NULL;
+  cdd_c_error_t rc;
 
-  if (p.err || p.lex.cur.kind != TOK_EOF) {
-    cdd_macro_eval_result_free(&r);
+  if (!ctx || !expression)
     return CDD_C_ERROR_INVALID_ARGUMENT;
-  }
 
-  *out_result = r;
-  return CDD_C_SUCCESS;
+  rc = cdd_macro_compile(expression, &program);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  rc = cdd_macro_program_run(program, ctx, out_result);
+  cdd_macro_program_free(program);
+  return rc;
 }
 
 void cdd_macro_eval_result_free(cdd_macro_eval_result_t *result) {
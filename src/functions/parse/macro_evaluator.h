@@ -39,7 +39,69 @@ typedef struct cdd_macro_eval_result_t {
 } cdd_macro_eval_result_t;
 
 /**
- * @brief Evaluates a C preprocessor constant expression.
+ * @brief A constant expression compiled to postfix bytecode. Lexing and
+ * parsing happen once; the program can then be run any number of times.
+ */
+typedef struct cdd_macro_program_t cdd_macro_program_t;
+
+/**
+ * @brief Compiles a constant expression.
+ *
+ * Besides literals, macro names and the C operators, `sizeof(T)` and
+ * `_Alignof(T)` are accepted for the primitive types known to
+ * cdd_cst_eval_primitive_type(), sized for the host ABI. The `#if`
+ * operators `defined`, `__has_include`, `__has_embed` and
+ * `__has_c_attribute` compile to instructions of their own.
+ *
+ * @param expression The expression text.
+ * @param out_program Receives the program; free with cdd_macro_program_free.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT on a syntax error, or
+ * CDD_C_ERROR_MEMORY.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_macro_compile(const char *expression, cdd_macro_program_t **out_program);
+
+/**
+ * @brief Runs a compiled expression. Macro names are looked up in `ctx` at
+ * run time and take their memoized values (see cdd_macro_value); unknown
+ * names are 0.
+ * @param program The compiled expression.
+ * @param ctx The preprocessor context (may be NULL: no macro is defined).
+ * @param out_result Pointer to store the evaluated result.
+ * @return 0 on success, non-zero on error (e.g. division by zero or a
+ * bitwise operator on a float).
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_macro_program_run(const cdd_macro_program_t *program,
+                      const struct PreprocessorContext *ctx,
+                      cdd_macro_eval_result_t *out_result);
+
+/**
+ * @brief Frees a compiled expression.
+ * @param program The program (may be NULL).
+ */
+C_CDD_EXPORT void cdd_macro_program_free(cdd_macro_program_t *program);
+
+/**
+ * @brief Evaluates the value of a macro definition, memoized in `def->memo`.
+ *
+ * The value is computed once per `ctx->macro_generation`, so defining,
+ * redefining or removing any macro invalidates it. `def->value` is compiled
+ * only once, into `def->program`; an invalidated value just re-runs it. A
+ * macro that refers back to itself fails instead of recursing forever.
+ *
+ * @param ctx The context `def` belongs to.
+ * @param def The definition.
+ * @param out_result Receives a copy of the value.
+ * @return 0 on success, non-zero on error.
+ */
+C_CDD_EXPORT cdd_c_error_t
+cdd_macro_value(const struct PreprocessorContext *ctx, struct MacroDef *def,
+                cdd_macro_eval_result_t *out_result);
+
+/**
+ * @brief Evaluates a C preprocessor constant expression (compiles and runs it
+ * once).
  * @param ctx The preprocessor context (for looking up other macros).
  * @param expression The right-hand side string of the macro to evaluate.
  * @param out_result Pointer to store the evaluated result.
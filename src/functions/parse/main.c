@@ -24,15 +24,18 @@
 #include "functions/emit/sync.h"
 #include "functions/parse/audit.h"
 #include "functions/parse/orchestrator.h"
+#include "functions/parse/project_index.h"
 #include "functions/parse/str.h"
 #include "functions/parse/db_loader.h"
 #include "openapi/parse/openapi.h"
+#include "openapi/parse/spec_reader.h"
 #include "routes/emit/cli_gen.h"
 #include "routes/emit/client_gui_gen.h"
 #include "routes/emit/client_gen.h"
 #include "routes/emit/server_gen.h"
 #include "routes/emit/serve_json_rpc.h"
 #include "routes/parse/cli.h" /* New entry */
+#include "routes/parse/watch.h"
 #include "tests/emit/schema2tests.h"
 
 #include <parson.h>
@@ -40,6 +43,7 @@
 
 C_CDD_EXPORT cdd_c_error_t print_version(void);
 C_CDD_EXPORT cdd_c_error_t handle_audit(int argc, char **argv);
+C_CDD_EXPORT cdd_c_error_t handle_index(int argc, char **argv);
 C_CDD_EXPORT cdd_c_error_t print_help(const char *program_name);
 
 C_CDD_EXPORT cdd_c_error_t print_version(void) {
@@ -109,6 +113,32 @@ C_CDD_EXPORT cdd_c_error_t handle_audit(int argc, char **argv) {
   return rc;
 }
 
+/**
+ * @brief Handler for the 'index' command.
+ *
+ * Creates or incrementally updates the project symbol index, reparsing
+ * only the files that changed since the last run.
+ *
+ * @param[in] argc Argument count for the command (should be 2)
+ * @param[in] argv The source directory and the index file path
+ * @return EXIT_SUCCESS or the error code from project_index_update
+ */
+C_CDD_EXPORT cdd_c_error_t handle_index(int argc, char **argv) {
+  struct ProjectIndexStats stats;
+  cdd_c_error_t rc;
+  if (argc != 2)
+    return CDD_C_ERROR_UNKNOWN;
+  rc = project_index_update(argv[0], argv[1], &stats);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  printf("Indexed %lu files (%lu parsed, %lu reused, %lu removed): %lu "
+         "symbols, %lu calls\n",
+         (unsigned long)stats.files, (unsigned long)stats.parsed,
+         (unsigned long)stats.reused, (unsigned long)stats.removed,
+         (unsigned long)stats.symbols, (unsigned long)stats.calls);
+  return CDD_C_SUCCESS;
+}
+
 /**
  * @brief Displays CLI usage information and a list of available
  * commands.
@@ -133,6 +163,10 @@ C_CDD_EXPORT cdd_c_error_t print_help(const char *program_name) {
   puts("      Generate code from an OpenAPI specification.");
   puts("  to_openapi -i <dir> [-o <out.json>]");
   puts("      Generate an OpenAPI specification from source code.");
+  puts("  watch [-i <dir>] [-o <spec.json>] [--sdk <dir>] "
+       "[--sync <header.h> <impl.c>]");
+  puts("      Regenerate the spec, SDK and sync targets whenever their inputs "
+       "change.");
   puts("  to_docs_json [--no-imports] [--no-wrapping] -i|--input <spec.json> "
        "[-o <docs.json>]");
   puts("      Generate JSON documentation with code snippets for an OpenAPI "
@@ -147,11 +181,14 @@ C_CDD_EXPORT cdd_c_error_t print_help(const char *program_name) {
   puts("Language-Specific Commands:");
   puts("  audit <directory>");
   puts("      Scan directory for memory safety issues.");
+  puts("  index <directory> <index-file>");
+  puts("      Create or incrementally update the project symbol index.");
   puts("  c2openapi <dir> <out.json>");
   puts("      Generate OpenAPI spec from C source code.");
   puts("  standardize-gnu [OPTIONS] <files...>");
   puts("      Standardize GNU C extensions to ISO C.");
-  puts("  transformer <toolname> [--audit|--fix] [--dry-run] <files...>");
+  puts("  transformer <toolname> [--audit|--fix] [--dry-run] "
+       "[--index=<index-file>] <files...>");
   puts("      Run syntax tree transformations.");
   puts("  code2schema <header.h> <schema.json>");
   puts("      Convert C header to JSON Schema.");
@@ -184,7 +221,6 @@ C_CDD_EXPORT cdd_c_error_t from_openapi_cli_main(int argc, char **argv) {
 
   struct OpenApiClientConfig config = {0};
   cdd_c_error_t rc = CDD_C_SUCCESS;
-  JSON_Value *root;
 
   input_file = getenv("CDD_INPUT") ? getenv("CDD_INPUT") : getenv("INPUT_FILE");
   input_dir =
@@ -220,7 +256,8 @@ C_CDD_EXPORT cdd_c_error_t from_openapi_cli_main(int argc, char **argv) {
            "specification.");
       puts("");
       puts("Options:");
-      puts("  -i, --input <spec.json>   Input OpenAPI spec file");
+      puts("  -i, --input <spec.json>   Input OpenAPI spec file (JSON or "
+           "YAML)");
       puts("  --input-dir <specs_dir>   Input directory containing OpenAPI "
            "specs");
       puts("  -o, --output <dir>        Output directory");
@@ -256,16 +293,16 @@ C_CDD_EXPORT cdd_c_error_t from_openapi_cli_main(int argc, char **argv) {
   }
 
   if (input_file) {
-    root = json_parse_file(input_file);
-    if (!root) {
-      fprintf(stderr, "Failed to parse JSON file: %s\n", input_file);
+    struct SpecReadError read_err;
+    openapi_spec_init(&spec);
+    rc = spec_reader_load_file(input_file, &spec, &read_err);
+    if (rc != CDD_C_SUCCESS && read_err.message[0]) {
+      fprintf(stderr, "Failed to parse spec file %s:%lu:%lu: %s\n",
+              input_file, (unsigned long)read_err.line,
+              (unsigned long)read_err.column, read_err.message);
       return CDD_C_ERROR_UNKNOWN;
     }
 
-    rc = openapi_load_from_json(root, &spec);
-
-    json_value_free(root);
-
     if (rc != 0) {
       fprintf(stderr, "Failed to load openapi spec from %s\n", input_file);
       return rc;
@@ -324,7 +361,9 @@ C_CDD_EXPORT cdd_c_error_t to_openapi_cli_main(int argc, char **argv) {
       getenv("CDD_OUTPUT")
           ? getenv("CDD_OUTPUT")
           : (getenv("OUT_FILE") ? getenv("OUT_FILE") : "openapi.json");
-  char *c2_argv[3];
+  const char *cache_dir = getenv("CDD_CACHE_DIR");
+  char *c2_argv[7];
+  int c2_argc = 1;
   int i;
 
   for (i = 0; i < argc; i++) {
@@ -336,6 +375,8 @@ C_CDD_EXPORT cdd_c_error_t to_openapi_cli_main(int argc, char **argv) {
           "  -i, --input <dir>       Input directory containing C source code");
       puts("  -o, --output <out.json> Output OpenAPI spec file (default: "
            "openapi.json)");
+      puts("  --cache-dir <dir>       Reuse per-file extraction results "
+           "across runs");
       return CDD_C_SUCCESS;
     } else if ((strcmp(argv[i], "-i") == 0 ||
                 strcmp(argv[i], "--input") == 0) &&
@@ -345,12 +386,19 @@ C_CDD_EXPORT cdd_c_error_t to_openapi_cli_main(int argc, char **argv) {
                 strcmp(argv[i], "--output") == 0) &&
                i + 1 < argc) {
       out_file = argv[++i];
+    } else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+      cache_dir = argv[++i];
     }
   }
   if (!input_dir) {
     fprintf(stderr, "Error: -i <directory> required\n");
     return CDD_C_ERROR_UNKNOWN;
   }
+  c2_argv[0] = (char *)"c2openapi";
+  if (cache_dir && *cache_dir) {
+    c2_argv[c2_argc++] = (char *)"--cache-dir";
+    c2_argv[c2_argc++] = (char *)cache_dir;
+  }
   {
     char snapshot_path[1024];
     FILE *f;
@@ -368,21 +416,18 @@ C_CDD_EXPORT cdd_c_error_t to_openapi_cli_main(int argc, char **argv) {
     f = fopen(snapshot_path, "r");
 #endif
     if (f) {
-      char *c2_argv_base[5];
       fclose(f);
-      c2_argv_base[0] = (char *)"c2openapi";
-      c2_argv_base[1] = (char *)"--base";
-      c2_argv_base[2] = snapshot_path;
-      c2_argv_base[3] = (char *)input_dir;
-      c2_argv_base[4] = (char *)out_file;
-      return c2openapi_cli_main(5, c2_argv_base);
+      c2_argv[c2_argc++] = (char *)"--base";
+      c2_argv[c2_argc++] = snapshot_path;
+      c2_argv[c2_argc++] = (char *)input_dir;
+      c2_argv[c2_argc++] = (char *)out_file;
+      return c2openapi_cli_main(c2_argc, c2_argv);
     }
   }
 
-  c2_argv[0] = (char *)"c2openapi";
-  c2_argv[1] = (char *)input_dir;
-  c2_argv[2] = (char *)out_file;
-  return c2openapi_cli_main(3, c2_argv);
+  c2_argv[c2_argc++] = (char *)input_dir;
+  c2_argv[c2_argc++] = (char *)out_file;
+  return c2openapi_cli_main(c2_argc, c2_argv);
 }
 
 /** @brief main definition */
@@ -439,6 +484,11 @@ C_CDD_EXPORT cdd_c_error_t cdd_main(int argc, char **argv) {
     if (rc != CDD_C_SUCCESS)
       goto handle_err;
     return CDD_C_SUCCESS;
+  } else if (strcmp(cmd, "index") == 0) {
+    rc = handle_index(argc - 2, argv + 2);
+    if (rc != CDD_C_SUCCESS)
+      goto handle_err;
+    return CDD_C_SUCCESS;
   } else if (strcmp(cmd, "c2openapi") == 0) {
     rc = c2openapi_cli_main(argc - 1, argv + 1);
     if (rc != CDD_C_SUCCESS)
@@ -471,6 +521,11 @@ C_CDD_EXPORT cdd_c_error_t cdd_main(int argc, char **argv) {
     if (rc != CDD_C_SUCCESS)
       goto handle_err;
     return CDD_C_SUCCESS;
+  } else if (strcmp(cmd, "watch") == 0) {
+    rc = watch_cli_main(argc - 1, argv + 1);
+    if (rc != CDD_C_SUCCESS)
+      goto handle_err;
+    return CDD_C_SUCCESS;
   } else if (strcmp(cmd, "to_docs_json") == 0) {
     rc = to_docs_json_cli_main(argc - 1, argv + 1);
     if (rc != CDD_C_SUCCESS)
@@ -30,6 +30,7 @@
 #include "functions/parse/cst.h"
 #include "functions/parse/fs.h"
 #include "functions/parse/orchestrator.h"
+#include "functions/parse/refactor.h"
 #include "c_cdd/log.h"
 #include "functions/parse/str.h" /* For c_cdd_strdup */
 #include "functions/parse/tokenizer.h"
@@ -366,12 +367,265 @@ static cdd_c_error_t propagate_refactor_mark(struct DependencyGraph *g,
   return CDD_C_SUCCESS;
 }
 
+/* --- Project-wide Propagation --- */
+
+/**
+ * @brief Find the definition a call to `name` from `path` binds to: a
+ * static one in `path` if any, otherwise an external one.
+ * @return 1 if found, else 0.
+ */
+static int fix_project_lookup(const struct FixProject *project,
+                              const char *name, size_t len, const char *path,
+                              struct ProjectIndexSymbol *out) {
+  struct ProjectIndexName entry;
+  struct ProjectIndexSymbol sym;
+  int found = 0;
+  size_t i;
+
+  if (project_index_find(project->index, name, len, &entry) != 0)
+    return 0;
+  for (i = 0; i < entry.n_symbols; i++) {
+    if (project_index_symbol_of(project->index, &entry, i, &sym) != 0 ||
+        sym.kind != PROJECT_INDEX_FUNCTION)
+      continue;
+    if (sym.flags & PROJECT_INDEX_STATIC) {
+      if (strcmp(sym.file, path) == 0) {
+        *out = sym;
+        return 1;
+      }
+    } else if (!found) {
+      *out = sym;
+      found = 1;
+    }
+  }
+  return found;
+}
+
+/**
+ * @brief Executes the fix project init operation.
+ */
+cdd_c_error_t fix_project_init(struct FixProject *project,
+                               const struct ProjectIndex *index) {
+  size_t *queue;
+  size_t head = 0, tail = 0, i;
+  size_t n;
+
+  if (!project || !index)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  n = index->n_symbols;
+  project->index = index;
+  project->marked = C_CDD_CALLOC(n ? n : 1, 1);
+  queue = C_CDD_MALLOC((n ? n : 1) * sizeof(size_t));
+  if (!project->marked || !queue) {
+    C_CDD_FREE(queue);
+    fix_project_free(project);
+    return CDD_C_ERROR_MEMORY;
+  }
+
+  /* Seed: same rule as the single-file graph */
+  for (i = 0; i < n; i++) {
+    struct ProjectIndexSymbol sym;
+    if (project_index_symbol(index, i, &sym) != 0)
+      continue;
+    if (sym.kind == PROJECT_INDEX_FUNCTION &&
+        (sym.flags & PROJECT_INDEX_ALLOCATES) &&
+        (sym.flags &
+         (PROJECT_INDEX_RETURNS_VOID | PROJECT_INDEX_RETURNS_PTR))) {
+      project->marked[i] = 1;
+      queue[tail++] = i;
+    }
+  }
+
+  /* Breadth-first over callers; each symbol is queued at most once */
+  while (head < tail) {
+    struct ProjectIndexSymbol sym;
+    struct ProjectIndexName entry;
+    if (project_index_symbol(index, queue[head++], &sym) != 0 ||
+        strcmp(sym.name, "main") == 0 ||
+        project_index_name(index, sym.name_id, &entry) != 0)
+      continue;
+    for (i = 0; i < entry.n_callers; i++) {
+      struct ProjectIndexSymbol caller, bound;
+      if (project_index_caller_of(index, &entry, i, &caller) != 0 ||
+          project->marked[caller.id])
+        continue;
+      /* The caller may see another (static) function of the same name */
+      if (!fix_project_lookup(project, entry.name, strlen(entry.name),
+                              caller.file, &bound) ||
+          bound.id != sym.id)
+        continue;
+      project->marked[caller.id] = 1;
+      queue[tail++] = caller.id;
+    }
+  }
+  C_CDD_FREE(queue);
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Executes the fix project free operation.
+ */
+void fix_project_free(struct FixProject *project) {
+  if (!project)
+    return;
+  C_CDD_FREE(project->marked);
+  project->marked = NULL;
+  project->index = NULL;
+}
+
+/**
+ * @brief Collect the marked functions of other files called from this one.
+ */
+static cdd_c_error_t collect_external_refactors(
+    const struct FixProject *project, const char *path,
+    const struct TokenList *tokens, const struct DependencyGraph *g,
+    struct RefactorContext *out) {
+  size_t f, t, k;
+  for (f = 0; f < g->count; f++) {
+    const struct FuncNode *fn = &g->nodes[f];
+    for (t = fn->body_start; t < fn->token_end; t++) {
+      const struct Token *tok = &tokens->tokens[t];
+      struct ProjectIndexSymbol sym;
+      size_t next = t + 1;
+      int known = 0;
+      cdd_c_error_t rc;
+      if (tok->kind != TOKEN_IDENTIFIER)
+        continue;
+      while (next < tokens->size &&
+             tokens->tokens[next].kind == TOKEN_WHITESPACE)
+        next++;
+      if (next >= tokens->size || tokens->tokens[next].kind != TOKEN_LPAREN)
+        continue;
+      /* Local definitions are handled by the file's own graph */
+      for (k = 0; k < g->count && !known; k++)
+        known = token_eq_str(tok, g->nodes[k].name);
+      for (k = 0; k < out->func_count && !known; k++)
+        known = token_eq_str(tok, out->funcs[k].name);
+      if (known ||
+          !fix_project_lookup(project, (const char *)tok->start, tok->length,
+                              path, &sym) ||
+          !project->marked[sym.id] || strcmp(sym.file, path) == 0 ||
+          strcmp(sym.name, "main") == 0)
+        continue;
+      rc = refactor_context_add_function(
+          out, sym.name,
+          (sym.flags & PROJECT_INDEX_RETURNS_PTR) ? REF_PTR_TO_INT_OUT
+                                                  : REF_VOID_TO_INT,
+          sym.return_type);
+      if (rc != CDD_C_SUCCESS)
+        return rc;
+    }
+  }
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Rewrite a prototype of a marked function to its new signature.
+ *
+ * Only declarations the index records as prototypes in `path` are
+ * touched, so shared headers follow the definitions rewritten elsewhere.
+ * Tokens of the range before `decl` (e.g. the tail of a preceding
+ * directive) and leading whitespace are kept verbatim.
+ *
+ * @param[out] out The rewritten range, or NULL to keep it as is.
+ */
+static cdd_c_error_t rewrite_prototype(const struct FixProject *project,
+                                       const char *path,
+                                       const struct TokenList *tokens,
+                                       size_t start, size_t decl, size_t end,
+                                       char **out) {
+  struct ProjectIndexName entry;
+  struct ProjectIndexSymbol sym;
+  struct TokenList slice;
+  const struct Token *name = NULL;
+  char *sig = NULL, *rest = NULL, *prefix = NULL;
+  size_t semi = end, t, i;
+  int depth = 0, declared = 0;
+  cdd_c_error_t rc;
+
+  *out = NULL;
+  if (decl < start)
+    decl = start;
+  while (decl < end && (tokens->tokens[decl].kind == TOKEN_WHITESPACE ||
+                        tokens->tokens[decl].kind == TOKEN_COMMENT))
+    decl++;
+  while (semi > decl && (tokens->tokens[semi - 1].kind == TOKEN_WHITESPACE ||
+                          tokens->tokens[semi - 1].kind == TOKEN_COMMENT))
+    semi--;
+  if (semi == decl || tokens->tokens[semi - 1].kind != TOKEN_SEMICOLON)
+    return CDD_C_SUCCESS;
+  semi--;
+
+  /* The declarator name: first identifier at depth 0 called like `f(` */
+  for (t = decl; t < semi && !name; t++) {
+    const struct Token *tok = &tokens->tokens[t];
+    size_t next = t + 1;
+    if (tok->kind == TOKEN_ASSIGN || tok->kind == TOKEN_LBRACE)
+      return CDD_C_SUCCESS;
+    if (tok->kind == TOKEN_LPAREN)
+      depth++;
+    else if (tok->kind == TOKEN_RPAREN)
+      depth--;
+    if (tok->kind != TOKEN_IDENTIFIER || depth != 0)
+      continue;
+    while (next < semi && tokens->tokens[next].kind == TOKEN_WHITESPACE)
+      next++;
+    if (next < semi && tokens->tokens[next].kind == TOKEN_LPAREN)
+      name = tok;
+  }
+  if (!name || project_index_find(project->index, (const char *)name->start,
+                                  name->length, &entry) != 0)
+    return CDD_C_SUCCESS;
+  for (i = 0; i < entry.n_symbols && !declared; i++)
+    declared = project_index_symbol_of(project->index, &entry, i, &sym) == 0 &&
+               sym.kind == PROJECT_INDEX_PROTOTYPE &&
+               strcmp(sym.file, path) == 0;
+  if (!declared ||
+      !fix_project_lookup(project, entry.name, strlen(entry.name), path,
+                          &sym) ||
+      !project->marked[sym.id] || strcmp(sym.name, "main") == 0)
+    return CDD_C_SUCCESS;
+
+  if ((rc = get_token_slice(tokens, decl, semi, &slice)) != CDD_C_SUCCESS)
+    return rc;
+  if (rewrite_signature(&slice, &sig) != CDD_C_SUCCESS || !sig)
+    return CDD_C_SUCCESS; /* Unparseable: leave the declaration alone */
+  rc = join_tokens_str(tokens, start, decl, &prefix);
+  if (rc == CDD_C_SUCCESS)
+    rc = join_tokens_str(tokens, semi, end, &rest);
+  if (rc == CDD_C_SUCCESS && prefix && rest) {
+    size_t n_prefix = strlen(prefix), n_sig = strlen(sig);
+    *out = C_CDD_MALLOC(n_prefix + n_sig + strlen(rest) + 1);
+    if (*out) {
+      memcpy(*out, prefix, n_prefix);
+      memcpy(*out + n_prefix, sig, n_sig);
+      memcpy(*out + n_prefix + n_sig, rest, strlen(rest) + 1);
+    }
+  }
+  C_CDD_FREE(prefix);
+  C_CDD_FREE(sig);
+  C_CDD_FREE(rest);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  return *out ? CDD_C_SUCCESS : CDD_C_ERROR_MEMORY;
+}
+
 /* --- Main Orchestrator --- */
 
 /**
  * @brief Executes the orchestrate fix operation.
  */
 cdd_c_error_t orchestrate_fix(const char *source_code, char **const out_code) {
+  return orchestrate_fix_in_project(source_code, NULL, NULL, out_code);
+}
+
+/**
+ * @brief Executes the orchestrate fix in project operation.
+ */
+cdd_c_error_t orchestrate_fix_in_project(const char *source_code,
+                                         const char *path,
+                                         const struct FixProject *project,
+                                         char **const out_code) {
   size_t _ast_find_token_in_range_3 = 0;
   char *_ast_extract_func_name_4 = NULL;
   char *_ast_join_tokens_str_5 = NULL;
@@ -385,6 +639,7 @@ cdd_c_error_t orchestrate_fix(const char *source_code, char **const out_code) {
   struct CstNodeList cst = {0};
   struct AllocationSiteList allocs = {0};
   struct DependencyGraph graph = {0};
+  struct RefactorContext external = {0};
   struct RefactoredFunction *ref_funcs = NULL;
   char *output = NULL;
   size_t i;
@@ -402,6 +657,8 @@ cdd_c_error_t orchestrate_fix(const char *source_code, char **const out_code) {
 
   if (!source_code || !out_code)
     return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (project && (!project->index || !project->marked || !path))
+    project = NULL;
 
   /* 1. Parse */
   if ((rc = tokenize(az_span_create_from_str((char *)source_code), &tokens)) !=
@@ -534,8 +791,19 @@ cdd_c_error_t orchestrate_fix(const char *source_code, char **const out_code) {
     /* Seed: Function contains allocations and returns unsafe type */
     if (n->contains_allocs && (n->returns_void || n->returns_ptr)) {
       propagate_refactor_mark(&graph, i);
+    } else if (project) {
+      /* Seed: the project marks this file's definition */
+      struct ProjectIndexSymbol sym;
+      if (fix_project_lookup(project, n->name, strlen(n->name), path, &sym) &&
+          project->marked[sym.id] && strcmp(sym.file, path) == 0)
+        propagate_refactor_mark(&graph, i);
     }
   }
+  if (project) {
+    rc = collect_external_refactors(project, path, tokens, &graph, &external);
+    if (rc != CDD_C_SUCCESS)
+      goto cleanup;
+  }
 
   /* 5. Rewrite */
   if (graph.count > 0) {
@@ -544,8 +812,9 @@ cdd_c_error_t orchestrate_fix(const char *source_code, char **const out_code) {
       if (graph.nodes[i].marked_for_refactor)
         marked_count++;
 
-    if (marked_count > 0) {
-      ref_funcs = C_CDD_CALLOC(marked_count, sizeof(struct RefactoredFunction));
+    if (marked_count + external.func_count > 0) {
+      ref_funcs = C_CDD_CALLOC(marked_count + external.func_count,
+                               sizeof(struct RefactoredFunction));
       if (!ref_funcs) {
         rc = CDD_C_ERROR_MEMORY;
         goto cleanup;
@@ -562,7 +831,11 @@ cdd_c_error_t orchestrate_fix(const char *source_code, char **const out_code) {
             r++;
           }
         }
+        /* Callees defined elsewhere in the project */
+        for (i = 0; i < external.func_count; i++)
+          ref_funcs[r++] = external.funcs[i];
       }
+      marked_count += external.func_count;
     }
   }
 
@@ -714,12 +987,20 @@ cdd_c_error_t orchestrate_fix(const char *source_code, char **const out_code) {
         continue;
       }
 
-      /* Copy Non-Function Nodes verbatim */
+      /* Copy Non-Function Nodes verbatim, bar prototypes of marked ones */
       {
-        char *content = (join_tokens_str(tokens, start_idx, end_idx,
-                                         &_ast_join_tokens_str_8),
-                         _ast_join_tokens_str_8);
+        char *content = NULL;
         char *joined;
+        if (project) {
+          rc = rewrite_prototype(project, path, tokens, start_idx,
+                                 cst.nodes[i].start_token, end_idx, &content);
+          if (rc != CDD_C_SUCCESS)
+            goto cleanup;
+        }
+        if (!content)
+          content = (join_tokens_str(tokens, start_idx, end_idx,
+                                     &_ast_join_tokens_str_8),
+                     _ast_join_tokens_str_8);
 #ifdef HAVE_ASPRINTF
         if (asprintf(&joined, "%s%s", output, content) < 0) {
           joined = NULL;
@@ -741,6 +1022,27 @@ cdd_c_error_t orchestrate_fix(const char *source_code, char **const out_code) {
         C_CDD_FREE(content);
       }
     }
+
+    /* Tokens past the last node, e.g. the rest of a trailing `#endif` */
+    if (output && current_tok_offset < tokens->size) {
+      char *tail = NULL, *joined = NULL;
+      rc = join_tokens_str(tokens, current_tok_offset, tokens->size, &tail);
+      if (rc != CDD_C_SUCCESS)
+        goto cleanup;
+      if (tail) {
+        size_t n_out = strlen(output), n_tail = strlen(tail);
+        joined = C_CDD_REALLOC(output, n_out + n_tail + 1);
+        if (joined) {
+          memcpy(joined + n_out, tail, n_tail + 1);
+          output = joined;
+        }
+        C_CDD_FREE(tail);
+      }
+      if (!joined) {
+        rc = CDD_C_ERROR_MEMORY;
+        goto cleanup;
+      }
+    }
   }
 
   *out_code = output;
@@ -749,6 +1051,7 @@ cdd_c_error_t orchestrate_fix(const char *source_code, char **const out_code) {
 cleanup:
   if (ref_funcs)
     C_CDD_FREE(ref_funcs);
+  refactor_context_free(&external);
   graph_free_contents(&graph);
   if (output)
     C_CDD_FREE(output);
@@ -770,6 +1073,8 @@ struct FixWalkContext {
   const char *single_output_file;
   /** @brief error_count */
   int error_count;
+  /** @brief Project-wide marks, or NULL */
+  const struct FixProject *project;
 };
 
 /**
@@ -789,6 +1094,23 @@ static cdd_c_error_t is_c_source(const char *path, int *out_is_src) {
   return CDD_C_SUCCESS;
 }
 
+/**
+ * @brief Checks if c header.
+ */
+static cdd_c_error_t is_c_header(const char *path, int *out_is_hdr) {
+  const char *dot;
+  int diff;
+  if (!out_is_hdr)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out_is_hdr = 0;
+  dot = strrchr(path, '.');
+  if (!dot)
+    return CDD_C_SUCCESS;
+  c_cdd_stricmp(dot, ".h", &diff);
+  *out_is_hdr = (diff == 0);
+  return CDD_C_SUCCESS;
+}
+
 /**
  * @brief Executes the fix file callback operation.
  */
@@ -801,10 +1123,15 @@ static cdd_c_error_t fix_file_callback(const char *path, void *user_data) {
   const char *out_path =
       ctx->single_output_file ? ctx->single_output_file : path;
 
+  int is_hdr = 0;
+
   {
     int is_src = 0;
     is_c_source(path, &is_src);
-    if (!is_src)
+    /* Headers carry the prototypes of functions a project run rewrites */
+    if (!is_src && ctx->project && !ctx->single_output_file)
+      is_c_header(path, &is_hdr);
+    if (!is_src && !is_hdr)
       return CDD_C_SUCCESS;
   }
 
@@ -814,7 +1141,13 @@ static cdd_c_error_t fix_file_callback(const char *path, void *user_data) {
     return CDD_C_SUCCESS;
   }
 
-  rc = orchestrate_fix(content, &result);
+  rc = orchestrate_fix_in_project(content, path, ctx->project, &result);
+  if (rc == 0 && is_hdr && strcmp(content, result) == 0) {
+    /* Leave untouched headers alone */
+    C_CDD_FREE(content);
+    C_CDD_FREE(result);
+    return CDD_C_SUCCESS;
+  }
   C_CDD_FREE(content);
 
   if (rc != 0) {
@@ -860,19 +1193,35 @@ static cdd_c_error_t fix_file_callback(const char *path, void *user_data) {
  */
 cdd_c_error_t fix_code_main(int argc, char **argv) {
   struct FixWalkContext ctx = {0};
+  struct ProjectIndex index;
+  struct FixProject project = {0};
+  const char *index_path = NULL;
   const char *target;
+  char *args[2];
+  int nargs = 0, i, rc;
+
+  /* Options may appear anywhere; the rest are positional */
+  for (i = 0; i < argc; i++) {
+    if (strncmp(argv[i], "--index=", 8) == 0)
+      index_path = argv[i] + 8;
+    else if (nargs < 2)
+      args[nargs++] = argv[i];
+    else
+      nargs = 3;
+  }
 
-  if (argc < 1 || argc > 2) {
-    fprintf(stderr, "Usage: fix <path> [--in-place] OR fix <in.c> <out.c>\n");
+  if (nargs < 1 || nargs > 2) {
+    fprintf(stderr, "Usage: fix <path> [--in-place] [--index=<file>] OR fix "
+                    "<in.c> <out.c> [--index=<file>]\n");
     return CDD_C_ERROR_UNKNOWN;
   }
 
-  target = argv[0];
-  if (argc == 2) {
-    if (strcmp(argv[1], "--in-place") == 0)
+  target = args[0];
+  if (nargs == 2) {
+    if (strcmp(args[1], "--in-place") == 0)
       ctx.in_place = 1;
     else
-      ctx.single_output_file = argv[1];
+      ctx.single_output_file = args[1];
   } else {
     /* Implicit single file or error? Assume directory implicit checking */
     int is_dir = 0;
@@ -886,7 +1235,26 @@ cdd_c_error_t fix_code_main(int argc, char **argv) {
     return CDD_C_ERROR_UNKNOWN;
   }
 
-  if (walk_directory(target, fix_file_callback, &ctx) != 0)
+  /* Bring the index up to date, then propagate across the whole project */
+  if (index_path) {
+    if (project_index_update(target, index_path, NULL) != 0 ||
+        project_index_open(index_path, &index) != 0) {
+      fprintf(stderr, "Failed to index %s into %s\n", target, index_path);
+      return CDD_C_ERROR_UNKNOWN;
+    }
+    if (fix_project_init(&project, &index) != 0) {
+      project_index_close(&index);
+      return CDD_C_ERROR_MEMORY;
+    }
+    ctx.project = &project;
+  }
+
+  rc = walk_directory(target, fix_file_callback, &ctx);
+  if (index_path) {
+    fix_project_free(&project);
+    project_index_close(&index);
+  }
+  if (rc != 0)
     return CDD_C_ERROR_UNKNOWN;
   return (ctx.error_count == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -18,8 +18,22 @@ extern "C" {
 /* clang-format off */
 #include <c_cdd_export.h>
 #include "cdd_c_error.h"
+#include "functions/parse/project_index.h"
 /* clang-format on */
 
+/**
+ * @brief The project-wide view of which functions the fix rewrites.
+ *
+ * Seeds and propagation mirror `orchestrate_fix`, but run over the call
+ * edges of a `ProjectIndex`, so a function is rewritten when anything it
+ * calls in another file is, and callers in one file learn the new
+ * signatures of callees defined in another.
+ */
+struct FixProject {
+  const struct ProjectIndex *index; /**< The index (borrowed) */
+  unsigned char *marked;            /**< Per symbol id: 1 if rewritten */
+};
+
 /**
  * @brief Apply the "fix" workflow to a single C source string.
  *
@@ -41,6 +55,41 @@ extern "C" {
 extern C_CDD_EXPORT cdd_c_error_t orchestrate_fix(const char *source_code,
                                                   char **out_code);
 
+/**
+ * @brief Compute which functions of a project the fix rewrites.
+ *
+ * @param[out] project The project view to fill.
+ * @param[in] index The opened index; must outlive `project`.
+ * @return 0 on success, or an error code.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+fix_project_init(struct FixProject *project, const struct ProjectIndex *index);
+
+/**
+ * @brief Release a project view.
+ * @param[in,out] project The project view.
+ */
+extern C_CDD_EXPORT void fix_project_free(struct FixProject *project);
+
+/**
+ * @brief Apply the "fix" workflow to one file of a project.
+ *
+ * As `orchestrate_fix`, but functions are also rewritten when the project
+ * marks them, and calls to marked functions defined in other files are
+ * rewritten to their new signatures. Prototypes the index records in `path`
+ * (e.g. in a shared header) follow the definitions they declare.
+ *
+ * @param[in] source_code The null-terminated C source code string.
+ * @param[in] path The file's path as recorded in the index.
+ * @param[in] project The project view, or NULL for single-file behaviour.
+ * @param[out] out_code Pointer to char* where the allocated result string will
+ * be stored.
+ * @return 0 on success, error code (ENOMEM/EINVAL) on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+orchestrate_fix_in_project(const char *source_code, const char *path,
+                           const struct FixProject *project, char **out_code);
+
 /**
  * @brief Command-line entry point for the fix functionality.
  * Reads input file, processes it, and writes to output file.
@@ -0,0 +1,297 @@
+/**
+ * @file parallel.c
+ * @brief Implementation of the portable parallel-for helper.
+ *
+ * @author Samuel Marks
+ */
+
+/* clang-format off */
+#include <stdlib.h>
+#include <time.h>
+
+#include "c_cdd/memory.h"
+#include "functions/parse/parallel.h"
+
+#if defined(__EMSCRIPTEN__) || defined(__DJGPP__) || defined(__WATCOMC__)
+#define CDD_PARALLEL_SERIAL_ONLY
+#elif defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+/* clang-format on */
+
+/* --- Platform Specifics --- */
+
+#if defined(CDD_PARALLEL_SERIAL_ONLY)
+
+typedef int parallel_mutex_t;
+
+static void parallel_mutex_init(parallel_mutex_t *m) { (void)m; }
+static void parallel_mutex_destroy(parallel_mutex_t *m) { (void)m; }
+static void parallel_mutex_lock(parallel_mutex_t *m) { (void)m; }
+static void parallel_mutex_unlock(parallel_mutex_t *m) { (void)m; }
+static long parallel_cpu_count(void) { return 1; }
+
+#elif defined(_WIN32)
+
+typedef HANDLE parallel_thread_t;
+typedef CRITICAL_SECTION parallel_mutex_t;
+
+static void parallel_mutex_init(parallel_mutex_t *m) {
+  InitializeCriticalSection(m);
+}
+static void parallel_mutex_destroy(parallel_mutex_t *m) {
+  DeleteCriticalSection(m);
+}
+static void parallel_mutex_lock(parallel_mutex_t *m) {
+  EnterCriticalSection(m);
+}
+static void parallel_mutex_unlock(parallel_mutex_t *m) {
+  LeaveCriticalSection(m);
+}
+static long parallel_cpu_count(void) {
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return (long)info.dwNumberOfProcessors;
+}
+
+#else /* POSIX */
+
+typedef pthread_t parallel_thread_t;
+typedef pthread_mutex_t parallel_mutex_t;
+
+static void parallel_mutex_init(parallel_mutex_t *m) {
+  pthread_mutex_init(m, NULL);
+}
+static void parallel_mutex_destroy(parallel_mutex_t *m) {
+  pthread_mutex_destroy(m);
+}
+static void parallel_mutex_lock(parallel_mutex_t *m) {
+  pthread_mutex_lock(m);
+}
+static void parallel_mutex_unlock(parallel_mutex_t *m) {
+  pthread_mutex_unlock(m);
+}
+static long parallel_cpu_count(void) {
+#ifdef _SC_NPROCESSORS_ONLN
+  return sysconf(_SC_NPROCESSORS_ONLN);
+#else
+  return 1;
+#endif
+}
+
+#endif
+
+/**
+ * @brief Shared state between the calling thread and its workers.
+ */
+struct ParallelState {
+  size_t n_items;          /**< Total number of work items */
+  size_t next;             /**< Next unclaimed index */
+  size_t failed_index;     /**< Lowest failing index, `n_items` if none */
+  cdd_c_error_t failed_rc; /**< Error returned for `failed_index` */
+  cdd_parallel_fn fn;      /**< Per-item callback */
+  void *user_data;         /**< Callback context */
+  parallel_mutex_t lock;   /**< Guards `next` and the failure fields */
+};
+
+/**
+ * @brief Claim the next unprocessed index.
+ */
+static int parallel_claim(struct ParallelState *st, size_t *out_index) {
+  int claimed = 0;
+  parallel_mutex_lock(&st->lock);
+  if (st->next < st->n_items) {
+    *out_index = st->next++;
+    claimed = 1;
+  }
+  parallel_mutex_unlock(&st->lock);
+  return claimed;
+}
+
+/**
+ * @brief Process items until none remain, recording the lowest failure.
+ */
+static void parallel_drain(struct ParallelState *st) {
+  size_t index;
+  while (parallel_claim(st, &index)) {
+    cdd_c_error_t rc = st->fn(index, st->user_data);
+    if (rc != CDD_C_SUCCESS) {
+      parallel_mutex_lock(&st->lock);
+      if (index < st->failed_index) {
+        st->failed_index = index;
+        st->failed_rc = rc;
+      }
+      parallel_mutex_unlock(&st->lock);
+    }
+  }
+}
+
+#if !defined(CDD_PARALLEL_SERIAL_ONLY)
+#if defined(_WIN32)
+/**
+ * @brief Worker thread entry point.
+ */
+static unsigned __stdcall parallel_worker(void *arg) {
+  parallel_drain((struct ParallelState *)arg);
+  return 0;
+}
+
+static int parallel_thread_start(parallel_thread_t *t,
+                                 struct ParallelState *st) {
+  *t = (HANDLE)_beginthreadex(NULL, 0, parallel_worker, st, 0, NULL);
+  return *t ? 0 : -1;
+}
+
+static void parallel_thread_join(parallel_thread_t t) {
+  WaitForSingleObject(t, INFINITE);
+  CloseHandle(t);
+}
+#else
+/**
+ * @brief Worker thread entry point.
+ */
+static void *parallel_worker(void *arg) {
+  parallel_drain((struct ParallelState *)arg);
+  return NULL;
+}
+
+static int parallel_thread_start(parallel_thread_t *t,
+                                 struct ParallelState *st) {
+  return pthread_create(t, NULL, parallel_worker, st);
+}
+
+static void parallel_thread_join(parallel_thread_t t) {
+  pthread_join(t, NULL);
+}
+#endif
+#endif /* !CDD_PARALLEL_SERIAL_ONLY */
+
+/**
+ * @brief Determines the default worker thread count.
+ */
+cdd_c_error_t cdd_parallel_default_jobs(size_t *out_jobs) {
+  const char *env;
+  long n = 0;
+
+  if (!out_jobs)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  env = getenv("CDD_C_JOBS");
+  if (env && *env) {
+    char *end = NULL;
+    long v = strtol(env, &end, 10);
+    if (end && *end == '\0' && v > 0)
+      n = v;
+  }
+  if (n <= 0)
+    n = parallel_cpu_count();
+  if (n < 1)
+    n = 1;
+  if (n > CDD_PARALLEL_MAX_JOBS)
+    n = CDD_PARALLEL_MAX_JOBS;
+
+  *out_jobs = (size_t)n;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Runs a callback over an index range on a pool of threads.
+ */
+cdd_c_error_t cdd_parallel_for(size_t n_items, size_t n_jobs,
+                               cdd_parallel_fn fn, void *user_data) {
+  struct ParallelState st;
+#if !defined(CDD_PARALLEL_SERIAL_ONLY)
+  parallel_thread_t *threads = NULL;
+  size_t n_started = 0;
+  size_t k;
+#endif
+
+  if (!fn)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (n_items == 0)
+    return CDD_C_SUCCESS;
+
+  if (n_jobs == 0) {
+    cdd_c_error_t rc = cdd_parallel_default_jobs(&n_jobs);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
+  if (n_jobs > CDD_PARALLEL_MAX_JOBS)
+    n_jobs = CDD_PARALLEL_MAX_JOBS;
+  if (n_jobs > n_items)
+    n_jobs = n_items;
+#ifdef CDD_BUILD_TESTS
+  /* The allocation fault counter is a plain global; keep injection exact. */
+  if (g_cdd_alloc_fail)
+    n_jobs = 1;
+#endif
+
+  st.n_items = n_items;
+  st.next = 0;
+  st.failed_index = n_items;
+  st.failed_rc = CDD_C_SUCCESS;
+  st.fn = fn;
+  st.user_data = user_data;
+  parallel_mutex_init(&st.lock);
+
+#if !defined(CDD_PARALLEL_SERIAL_ONLY)
+  if (n_jobs > 1) {
+    threads = (parallel_thread_t *)C_CDD_CALLOC(n_jobs - 1,
+                                                sizeof(parallel_thread_t));
+    if (threads) {
+      for (k = 0; k < n_jobs - 1; ++k) {
+        if (parallel_thread_start(&threads[n_started], &st) != 0)
+          break;
+        ++n_started;
+      }
+    }
+  }
+#endif
+
+  parallel_drain(&st);
+
+#if !defined(CDD_PARALLEL_SERIAL_ONLY)
+  for (k = 0; k < n_started; ++k)
+    parallel_thread_join(threads[k]);
+  if (threads)
+    C_CDD_FREE(threads);
+#endif
+
+  parallel_mutex_destroy(&st.lock);
+  return st.failed_rc;
+}
+
+/**
+ * @brief Reads the monotonic clock in milliseconds.
+ */
+cdd_c_error_t cdd_parallel_clock_ms(double *out_ms) {
+  if (!out_ms)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+#if defined(_WIN32) && !defined(CDD_PARALLEL_SERIAL_ONLY)
+  {
+    LARGE_INTEGER freq, now;
+    if (QueryPerformanceFrequency(&freq) && QueryPerformanceCounter(&now) &&
+        freq.QuadPart > 0) {
+      *out_ms = (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+      return CDD_C_SUCCESS;
+    }
+  }
+#elif defined(CLOCK_MONOTONIC)
+  {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+      *out_ms = (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+      return CDD_C_SUCCESS;
+    }
+  }
+#endif
+  *out_ms = (double)time(NULL) * 1000.0;
+  return CDD_C_SUCCESS;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file parallel.h
+ * @brief Minimal portable parallel-for used to fan independent per-file work
+ * out across worker threads.
+ *
+ * Uses `pthread` on POSIX and Windows Threads on Win32. Targets without
+ * threads (Emscripten, DOS) run every item serially on the calling thread.
+ * Work items are claimed in index order from a shared counter, so callers
+ * that store results per index and consume them afterwards in index order
+ * get output independent of scheduling.
+ *
+ * @author Samuel Marks
+ */
+
+#ifndef C_CDD_PARALLEL_H
+#define C_CDD_PARALLEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include <stddef.h>
+
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+/* clang-format on */
+
+/** @brief Upper bound on worker threads started by `cdd_parallel_for`. */
+#define CDD_PARALLEL_MAX_JOBS 64
+
+/**
+ * @brief Callback invoked once per work item.
+ *
+ * @param[in] index Index of the item in `[0, n_items)`.
+ * @param[in,out] user_data Caller supplied context.
+ * @return 0 on success, error code on failure.
+ */
+typedef cdd_c_error_t (*cdd_parallel_fn)(size_t index, void *user_data);
+
+/**
+ * @brief Determine the default number of worker threads.
+ *
+ * Honours the `CDD_C_JOBS` environment variable when it holds a positive
+ * integer, otherwise uses the number of online processors. Always yields a
+ * value in `[1, CDD_PARALLEL_MAX_JOBS]`.
+ *
+ * @param[out] out_jobs Receives the job count.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT if `out_jobs` is NULL.
+ */
+extern C_CDD_EXPORT cdd_c_error_t cdd_parallel_default_jobs(size_t *out_jobs);
+
+/**
+ * @brief Run `fn` for every index in `[0, n_items)` using up to `n_jobs`
+ * threads (the calling thread included).
+ *
+ * Every item runs exactly once. If worker threads cannot be started the
+ * remaining items are processed by the calling thread.
+ *
+ * @param[in] n_items Number of work items.
+ * @param[in] n_jobs Requested thread count; 0 selects
+ * `cdd_parallel_default_jobs`.
+ * @param[in] fn Callback run per item.
+ * @param[in,out] user_data Context passed to `fn`.
+ * @return 0 on success, otherwise the error of the lowest failing index.
+ */
+extern C_CDD_EXPORT cdd_c_error_t cdd_parallel_for(size_t n_items,
+                                                   size_t n_jobs,
+                                                   cdd_parallel_fn fn,
+                                                   void *user_data);
+
+/**
+ * @brief Read a monotonic clock, for timing work items.
+ *
+ * Falls back to `time()` (one second resolution) where no monotonic clock
+ * is available.
+ *
+ * @param[out] out_ms Receives milliseconds since an arbitrary fixed point.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT if `out_ms` is NULL.
+ */
+extern C_CDD_EXPORT cdd_c_error_t cdd_parallel_clock_ms(double *out_ms);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* C_CDD_PARALLEL_H */
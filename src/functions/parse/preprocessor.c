@@ -19,6 +19,8 @@
 
 #include "functions/parse/fs.h"
 
+#include "functions/parse/macro_evaluator.h"
+
 #include "functions/parse/preprocessor.h"
 #include "c_cdd/log.h"
 
@@ -153,6 +155,30 @@ static void free_macro_def(struct MacroDef *def) {
 
     C_CDD_FREE(def->args);
   }
+
+  if (def->memo.str_val)
+
+    C_CDD_FREE(def->memo.str_val);
+
+  cdd_macro_program_free(def->program);
+}
+
+/**
+ * @brief Finds the index of the macro called `name`, or `macro_count`.
+ */
+static size_t find_macro(const struct PreprocessorContext *ctx,
+                         const char *name) {
+
+  size_t i;
+
+  for (i = 0; i < ctx->macro_count; ++i) {
+
+    if (ctx->macros[i].name && strcmp(ctx->macros[i].name, name) == 0)
+
+      return i;
+  }
+
+  return ctx->macro_count;
 }
 
 /**
@@ -186,6 +212,24 @@ static cdd_c_error_t add_macro_internal(struct PreprocessorContext *ctx,
 
                                         const struct MacroDef *def) {
 
+  /* Any change can alter what other macros evaluate to */
+  ctx->macro_generation++;
+
+  if (def->name) {
+
+    size_t i = find_macro(ctx, def->name);
+
+    if (i < ctx->macro_count) {
+
+      /* Redefinition: the new body replaces the old one in place */
+      free_macro_def(&ctx->macros[i]);
+
+      ctx->macros[i] = *def;
+
+      return CDD_C_SUCCESS;
+    }
+  }
+
   if (ctx->macro_count >= ctx->macro_capacity) {
 
     size_t new_cap = (ctx->macro_capacity == 0) ? 16 : ctx->macro_capacity * 2;
@@ -460,6 +504,35 @@ cdd_c_error_t pp_add_macro(struct PreprocessorContext *ctx, const char *name,
   return CDD_C_SUCCESS;
 }
 
+/**
+ * @brief Executes the pp remove macro operation.
+ */
+cdd_c_error_t pp_remove_macro(struct PreprocessorContext *ctx,
+                              const char *name) {
+
+  size_t i;
+
+  if (!ctx || !name)
+
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  i = find_macro(ctx, name);
+
+  if (i < ctx->macro_count) {
+
+    free_macro_def(&ctx->macros[i]);
+
+    memmove(&ctx->macros[i], &ctx->macros[i + 1],
+            (ctx->macro_count - i - 1) * sizeof(struct MacroDef));
+
+    ctx->macro_count--;
+
+    ctx->macro_generation++;
+  }
+
+  return CDD_C_SUCCESS;
+}
+
 /**
  * @brief Executes the pp scan defines operation.
  */
@@ -678,7 +751,41 @@ cdd_c_error_t pp_scan_defines(struct PreprocessorContext *ctx,
             }
           }
 
-          add_macro_internal(ctx, &def);
+          if (add_macro_internal(ctx, &def) != 0)
+
+            free_macro_def(&def);
+        }
+
+        i = name_idx; /* Advance */
+
+      } else if (next < tokens->size &&
+
+                 (token_matches_string(&tokens->tokens[next], "undef",
+                                       &_ast_token_matches_string_2) == 0 &&
+                  _ast_token_matches_string_2)) {
+
+        size_t name_idx = next + 1;
+
+        while (name_idx < tokens->size &&
+
+               tokens->tokens[name_idx].kind == TOKEN_WHITESPACE)
+
+          name_idx++;
+
+        if (name_idx < tokens->size &&
+
+            tokens->tokens[name_idx].kind == TOKEN_IDENTIFIER) {
+
+          char *name = (token_to_string(&tokens->tokens[name_idx],
+                                        &_ast_token_to_string_3),
+                        _ast_token_to_string_3);
+
+          if (name) {
+
+            pp_remove_macro(ctx, name);
+
+            C_CDD_FREE(name);
+          }
         }
 
         i = name_idx; /* Advance */
@@ -721,150 +828,7 @@ void pp_embed_params_free(struct EmbedParams *params) {
   params->if_empty = NULL;
 }
 
-/* --- Expression Evaluator Implementation --- */
-
-/* Parser State */
-
-/** @brief ExprState structure */
-struct ExprState {
-
-  /** @brief tokens */
-  /** @brief tokens */
-  const struct TokenList *tokens;
-
-  /** @brief pos */
-
-  /** @brief pos */
-  size_t pos;
-
-  /** @brief ctx */
-  /** @brief end */
-  size_t end;
-
-  /** @brief error */
-
-  /** @brief ctx */
-  const struct PreprocessorContext *ctx;
-
-  /** @brief error */
-  int error;
-};
-
-/* Forward Declarations for Recursive Descent */
-
-static cdd_c_error_t parse_expr(struct ExprState *s, long *_out_val);
-
-/**
- * @brief Parses logic or from the given input.
- */
-static cdd_c_error_t parse_logic_or(struct ExprState *s, long *_out_val);
-
-/**
- * @brief Parses logic and from the given input.
- */
-static cdd_c_error_t parse_logic_and(struct ExprState *s, long *_out_val);
-
-/**
- * @brief Parses equality from the given input.
- */
-static cdd_c_error_t parse_equality(struct ExprState *s, long *_out_val);
-
-/**
- * @brief Parses relational from the given input.
- */
-static cdd_c_error_t parse_relational(struct ExprState *s, long *_out_val);
-
-/**
- * @brief Parses shift from the given input.
- */
-static cdd_c_error_t parse_shift(struct ExprState *s, long *_out_val);
-
-/**
- * @brief Parses additive from the given input.
- */
-static cdd_c_error_t parse_additive(struct ExprState *s, long *_out_val);
-
-/**
- * @brief Parses multiplicative from the given input.
- */
-static cdd_c_error_t parse_multiplicative(struct ExprState *s, long *_out_val);
-
-/**
- * @brief Parses unary from the given input.
- */
-static cdd_c_error_t parse_unary(struct ExprState *s, long *_out_val);
-
-/**
- * @brief Parses primary from the given input.
- */
-static cdd_c_error_t parse_primary(struct ExprState *s, long *_out_val);
-
-/* Helper: skip whitespace */
-
-/**
- * @brief Executes the skip ws operation.
- */
-static cdd_c_error_t skip_ws(struct ExprState *s, size_t *_out_val) {
-  (void)_out_val;
-  while (s->pos < s->end && s->tokens->tokens[s->pos].kind == TOKEN_WHITESPACE)
-    s->pos++;
-  return CDD_C_SUCCESS;
-}
-
-/* Helper: Check current token kind */
-
-/**
- * @brief Executes the match operation.
- */
-static cdd_c_error_t match(struct ExprState *s, enum TokenKind kind,
-                           int *_out_val) {
-  size_t _ast_skip_ws_5 = 0;
-  *_out_val = 0;
-
-  skip_ws(s, &_ast_skip_ws_5);
-
-  if (s->pos < s->end && s->tokens->tokens[s->pos].kind == kind) {
-
-    s->pos++;
-
-    {
-      *_out_val = 1;
-      return CDD_C_SUCCESS;
-    }
-  }
-
-  {
-    *_out_val = 0;
-    return CDD_C_SUCCESS;
-  }
-}
-
-/* Helper: Peek current token kind */
-
-/**
- * @brief Executes the peek operation.
- */
-static cdd_c_error_t preprocessor_peek(struct ExprState *s,
-                                       enum TokenKind *_out_val) {
-
-  size_t p = s->pos;
-
-  while (p < s->end && s->tokens->tokens[p].kind == TOKEN_WHITESPACE)
-
-    p++;
-
-  if (p >= s->end)
-
-  {
-    *_out_val = TOKEN_UNKNOWN;
-    return CDD_C_SUCCESS;
-  }
-
-  {
-    *_out_val = s->tokens->tokens[p].kind;
-    return CDD_C_SUCCESS;
-  }
-}
+/* --- Expression Evaluation --- */
 
 /**
  * @brief Checks if defined macro.
@@ -901,919 +865,72 @@ static cdd_c_error_t is_defined_macro(const struct PreprocessorContext *ctx,
   }
 }
 
-/**
- * @brief Handle __has_include and __has_embed logic.
- *
- * Syntax: `__has_include ( header-name )` or `__has_include ( "header" )` etc.
- * Spec: The operands are processed as in phase 3. The result is 1 if found, 0
- * otherwise.
- */
-
-static cdd_c_error_t handle_has_include_embed(struct ExprState *s,
-                                              long *_out_val) {
-  size_t _ast_skip_ws_7 = 0;
-  int _ast_match_8 = 0;
-  size_t _ast_skip_ws_9 = 0;
-  char *_ast_reconstruct_path_10 = NULL;
-  size_t _ast_skip_ws_11 = 0;
-  int _ast_match_12 = 0;
-  char *_ast_resolve_path_13 = NULL;
-
-  int is_header = false;
-
-  char *path = NULL;
-
+cdd_c_error_t pp_has_include(const struct PreprocessorContext *ctx,
+                             const char *path, int is_system, int *found) {
   char *resolved = NULL;
+  cdd_c_error_t rc;
 
-  long result = 0;
-
-  /* Expect '(' */
-
-  skip_ws(s, &_ast_skip_ws_7);
-
-  if (!(match(s, TOKEN_LPAREN, &_ast_match_8) == 0 && _ast_match_8)) {
-
-    s->error = 1;
-
-    {
-      *_out_val = 0;
-      return CDD_C_SUCCESS;
-    }
-  }
-
-  skip_ws(s, &_ast_skip_ws_9);
-
-  if (s->pos >= s->end) {
-
-    s->error = 1;
-
-    {
-      *_out_val = 0;
-      return CDD_C_SUCCESS;
-    }
-  }
-
-  /* Parse Header Name */
-
-  if (s->tokens->tokens[s->pos].kind == TOKEN_STRING_LITERAL) {
-
-    const struct Token *t = &s->tokens->tokens[s->pos];
-
-    if (t->length >= 2) {
-
-      path = (char *)C_CDD_MALLOC(t->length - 1);
-
-      if (path) {
-
-        memcpy(path, t->start + 1, t->length - 2);
-
-        path[t->length - 2] = '\0';
-      }
-    }
-
-    s->pos++;
-
-  } else if (s->tokens->tokens[s->pos].kind == TOKEN_LESS) {
-
-    size_t start_p = s->pos + 1;
-
-    size_t end_p = start_p;
-
-    while (end_p < s->end && s->tokens->tokens[end_p].kind != TOKEN_GREATER) {
-
-      end_p++;
-    }
-
-    if (end_p < s->end) {
-
-      path = (reconstruct_path(s->tokens, start_p, end_p,
-                               &_ast_reconstruct_path_10),
-              _ast_reconstruct_path_10);
-
-      s->pos = end_p + 1; /* Skip closing '>' */
-
-      is_header = 1;
-
-    } else {
-
-      s->error = 1;
-
-      {
-        *_out_val = 0;
-        return CDD_C_SUCCESS;
-      }
-    }
-
-  } else {
-
-    s->error = 1;
-
-    {
-      *_out_val = 0;
-      return CDD_C_SUCCESS;
-    }
-  }
-
-  /* Consume remaining parameters until RPAREN */
-
-  while (s->pos < s->end) {
-
-    if (s->tokens->tokens[s->pos].kind == TOKEN_RPAREN) {
-
-      break;
-    }
-
-    s->pos++;
-  }
-
-  skip_ws(s, &_ast_skip_ws_11);
-
-  if (!(match(s, TOKEN_RPAREN, &_ast_match_12) == 0 && _ast_match_12)) {
-    fprintf(stderr, "Missing RPAREN, setting error!\n");
-    s->error = 1;
-
-    if (path)
-
-      C_CDD_FREE(path);
-
-    {
-      *_out_val = 0;
-      return CDD_C_SUCCESS;
-    }
-  }
-
-  if (path) {
-
-    resolved = (resolve_path(s->ctx, s->ctx ? s->ctx->current_file_dir : NULL,
-
-                             path, is_header, &_ast_resolve_path_13),
-                _ast_resolve_path_13);
-
-    result = (resolved != NULL);
-
-    C_CDD_FREE(resolved);
-
-    C_CDD_FREE(path);
-  }
-
-  {
-    *_out_val = result;
-    return CDD_C_SUCCESS;
-  }
+  if (!path || !found)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  rc = resolve_path(ctx, ctx ? ctx->current_file_dir : NULL, path, is_system,
+                    &resolved);
+  *found = resolved != NULL;
+  C_CDD_FREE(resolved);
+  return rc;
 }
 
 /**
- * @brief Handle __has_c_attribute logic.
+ * @brief Executes the pp eval expression operation.
  */
+cdd_c_error_t pp_eval_expression(const struct TokenList *tokens,
+                                 size_t start_idx,
 
-static cdd_c_error_t handle_has_c_attribute(struct ExprState *s,
-                                            long *_out_val) {
-  size_t _ast_skip_ws_14 = 0;
-  int _ast_match_15 = 0;
-  size_t _ast_skip_ws_16 = 0;
-  char *_ast_token_to_string_17 = NULL;
-  enum TokenKind _ast_identify_keyword_or_id_18;
-  char *_ast_token_to_string_19 = NULL;
-  size_t _ast_skip_ws_20 = 0;
-  size_t _ast_skip_ws_21 = 0;
-  char *_ast_token_to_string_22 = NULL;
-  size_t _ast_skip_ws_23 = 0;
-  int _ast_match_24 = 0;
-
-  long result = 0;
-
-  char *attr_name = NULL;
-
-  skip_ws(s, &_ast_skip_ws_14);
+                                 size_t end_idx,
+                                 const struct PreprocessorContext *ctx,
 
-  if (!(match(s, TOKEN_LPAREN, &_ast_match_15) == 0 && _ast_match_15)) {
+                                 long *result) {
+  cdd_macro_program_t *program = NULL;
+  cdd_macro_eval_result_t value;
+  char *text;
+  size_t len = 0, i;
+  cdd_c_error_t rc;
 
-    s->error = 1;
+  if (!tokens || !result || end_idx > tokens->size || start_idx > end_idx)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *result = 0;
 
-    {
-      *_out_val = 0;
-      return CDD_C_SUCCESS;
+  /* Whitespace and comments separate tokens; everything else is compiled
+   * as written */
+  for (i = start_idx; i < end_idx; i++)
+    len += tokens->tokens[i].length;
+  text = (char *)C_CDD_MALLOC(len + 1);
+  if (!text)
+    return CDD_C_ERROR_MEMORY;
+  len = 0;
+  for (i = start_idx; i < end_idx; i++) {
+    const struct Token *t = &tokens->tokens[i];
+    if (t->kind == TOKEN_WHITESPACE || t->kind == TOKEN_COMMENT) {
+      text[len++] = ' ';
+    } else {
+      memcpy(text + len, t->start, t->length);
+      len += t->length;
     }
   }
+  text[len] = '\0';
 
-  skip_ws(s, &_ast_skip_ws_16);
-
-  if (s->pos < s->end && s->tokens->tokens[s->pos].kind == TOKEN_IDENTIFIER) {
-
-    attr_name =
-        (token_to_string(&s->tokens->tokens[s->pos], &_ast_token_to_string_17),
-         _ast_token_to_string_17);
-
-    s->pos++;
-
-  } else if (s->pos < s->end &&
-
-             (identify_keyword_or_id(s->tokens->tokens[s->pos].start,
-
-                                     s->tokens->tokens[s->pos].length,
-                                     &_ast_identify_keyword_or_id_18),
-              _ast_identify_keyword_or_id_18) !=
-
-                 TOKEN_IDENTIFIER) {
-
-    /* Handle keywords treated as attributes */
-
-    attr_name =
-        (token_to_string(&s->tokens->tokens[s->pos], &_ast_token_to_string_19),
-         _ast_token_to_string_19);
-
-    s->pos++;
-  }
-
-  /* Support scoping `::` */
-
-  skip_ws(s, &_ast_skip_ws_20);
-
-  if (s->pos + 1 < s->end && s->tokens->tokens[s->pos].kind == TOKEN_COLON &&
-
-      s->tokens->tokens[s->pos + 1].kind == TOKEN_COLON) {
-
-    char *scope = attr_name;
-
-    char *name = NULL;
-
-    s->pos += 2; /* Skip :: */
-
-    skip_ws(s, &_ast_skip_ws_21);
-
-    if (s->pos < s->end &&
-
-        (s->tokens->tokens[s->pos].kind == TOKEN_IDENTIFIER)) {
-
-      name = (token_to_string(&s->tokens->tokens[s->pos],
-                              &_ast_token_to_string_22),
-              _ast_token_to_string_22);
-
-      s->pos++;
-    }
-
-    if (name)
-
-      C_CDD_FREE(name);
-
-    if (scope)
-
-      C_CDD_FREE(scope);
-
-    attr_name = NULL;
-
-    result = 0; /* Scoped ignored currently */
-  }
-
-  if (attr_name) {
-
-    if (strcmp(attr_name, "deprecated") == 0)
-
-      result = 201904L;
-
-    else if (strcmp(attr_name, "fallthrough") == 0)
-
-      result = 201904L;
-
-    else if (strcmp(attr_name, "maybe_unused") == 0)
-
-      result = 201904L;
-
-    else if (strcmp(attr_name, "nodiscard") == 0)
-
-      result = 201904L;
-
-    else if (strcmp(attr_name, "noreturn") == 0)
-
-      result = 202202L;
-
-    else if (strcmp(attr_name, "unsequenced") == 0)
-
-      result = 202311L;
-
-    else if (strcmp(attr_name, "reproducible") == 0)
-
-      result = 202311L;
-
-    else
-
-      result = 0;
-
-    C_CDD_FREE(attr_name);
-  }
-
-  skip_ws(s, &_ast_skip_ws_23);
-
-  if (!(match(s, TOKEN_RPAREN, &_ast_match_24) == 0 && _ast_match_24)) {
-
-    s->error = 1;
-  }
-
-  {
-    *_out_val = result;
-    return CDD_C_SUCCESS;
-  }
-}
-
-/**
- * @brief Parses primary from the given input.
- */
-static cdd_c_error_t parse_primary(struct ExprState *s, long *_out_val) {
-  size_t _ast_skip_ws_25 = 0;
-  int _ast_match_26 = 0;
-  long _ast_parse_expr_27;
-  int _ast_match_28 = 0;
-  char *_ast_token_to_string_29 = NULL;
-  int _ast_token_matches_string_30 = 0;
-  long _ast_handle_has_include_embed_31;
-  int _ast_token_matches_string_32 = 0;
-  long _ast_handle_has_include_embed_33;
-  int _ast_token_matches_string_34 = 0;
-  long _ast_handle_has_c_attribute_35;
-  int _ast_token_matches_string_36 = 0;
-
-  skip_ws(s, &_ast_skip_ws_25);
-
-  if (s->pos >= s->end) {
-
-    s->error = 1;
-
-    {
-      *_out_val = 0;
-      return CDD_C_SUCCESS;
-    }
-  }
-
-  if ((match(s, TOKEN_LPAREN, &_ast_match_26) == 0 && _ast_match_26)) {
-
-    long val = (parse_expr(s, &_ast_parse_expr_27), _ast_parse_expr_27);
-
-    if (!(match(s, TOKEN_RPAREN, &_ast_match_28) == 0 && _ast_match_28))
-
-      s->error = 1;
-
-    {
-      *_out_val = val;
-      return CDD_C_SUCCESS;
-    }
-  }
-
-  if (s->tokens->tokens[s->pos].kind == TOKEN_NUMBER_LITERAL) {
-
-    char *txt =
-        (token_to_string(&s->tokens->tokens[s->pos], &_ast_token_to_string_29),
-         _ast_token_to_string_29);
-
-    long val = 0;
-
-    if (txt) {
-
-      if (strlen(txt) > 2 && txt[0] == '0' &&
-
-          (txt[1] == 'b' || txt[1] == 'B')) {
-
-        char *endptr;
-
-        val = strtol(txt + 2, &endptr, 2);
-
-      } else {
-
-        val = strtol(txt, NULL, 0);
-      }
-
-      C_CDD_FREE(txt);
-    }
-
-    s->pos++;
-
-    {
-      *_out_val = val;
-      return CDD_C_SUCCESS;
-    }
-  }
-
-  if (s->tokens->tokens[s->pos].kind == TOKEN_IDENTIFIER ||
-
-      s->tokens->tokens[s->pos].kind >= TOKEN_KEYWORD_AUTO) {
-
-    const struct Token *tok = &s->tokens->tokens[s->pos];
-    if ((token_matches_string(tok, "__has_include",
-                              &_ast_token_matches_string_30) == 0 &&
-         _ast_token_matches_string_30)) {
-
-      s->pos++;
-
-      {
-        *_out_val =
-            (handle_has_include_embed(s, &_ast_handle_has_include_embed_31),
-             _ast_handle_has_include_embed_31);
-        return CDD_C_SUCCESS;
-      }
-    }
-
-    if ((token_matches_string(tok, "__has_embed",
-                              &_ast_token_matches_string_32) == 0 &&
-         _ast_token_matches_string_32)) {
-
-      s->pos++;
-
-      {
-        *_out_val =
-            (handle_has_include_embed(s, &_ast_handle_has_include_embed_33),
-             _ast_handle_has_include_embed_33);
-        return CDD_C_SUCCESS;
-      }
-    }
-
-    if ((token_matches_string(tok, "__has_c_attribute",
-                              &_ast_token_matches_string_34) == 0 &&
-         _ast_token_matches_string_34)) {
-
-      s->pos++;
-
-      {
-        *_out_val = (handle_has_c_attribute(s, &_ast_handle_has_c_attribute_35),
-                     _ast_handle_has_c_attribute_35);
-        return CDD_C_SUCCESS;
-      }
-    }
-
-    /* Macro value lookup */
-
-    {
-
-      size_t i;
-
-      long val = 0;
-
-      if (s->ctx) {
-
-        for (i = 0; i < s->ctx->macro_count; ++i) {
-
-          if (!s->ctx->macros[i].is_function_like && s->ctx->macros[i].value &&
-
-              (token_matches_string(tok, s->ctx->macros[i].name,
-                                    &_ast_token_matches_string_36) == 0 &&
-               _ast_token_matches_string_36)) {
-
-            char *endptr;
-
-            val = strtol(s->ctx->macros[i].value, &endptr, 0);
-
-            break;
-          }
-        }
-      }
-
-      s->pos++;
-
-      {
-        *_out_val = val;
-        return CDD_C_SUCCESS;
-      }
-    }
-  }
-
-  s->pos++;
-
-  {
-    *_out_val = 0;
-    return CDD_C_SUCCESS;
-  }
-}
-
-/**
- * @brief Parses unary from the given input.
- */
-static cdd_c_error_t parse_unary(struct ExprState *s, long *_out_val) {
-  size_t _ast_skip_ws_37 = 0;
-  int _ast_match_38 = 0;
-  long _ast_parse_unary_39;
-  int _ast_match_40 = 0;
-  long _ast_parse_unary_41;
-  int _ast_match_42 = 0;
-  long _ast_parse_unary_43;
-  int _ast_match_44 = 0;
-  long _ast_parse_unary_45;
-  int _ast_token_matches_string_46 = 0;
-  size_t _ast_skip_ws_47 = 0;
-  int _ast_match_48 = 0;
-  size_t _ast_skip_ws_49 = 0;
-  int _ast_is_defined_macro_50 = 0;
-  int _ast_match_51 = 0;
-  long _ast_parse_primary_52;
-
-  skip_ws(s, &_ast_skip_ws_37);
-
-  if ((match(s, TOKEN_BANG, &_ast_match_38) == 0 && _ast_match_38)) {
-
-    {
-      *_out_val = !(parse_unary(s, &_ast_parse_unary_39), _ast_parse_unary_39);
-      return CDD_C_SUCCESS;
-    }
-  }
-
-  if ((match(s, TOKEN_TILDE, &_ast_match_40) == 0 && _ast_match_40)) {
-
-    {
-      *_out_val = ~(parse_unary(s, &_ast_parse_unary_41), _ast_parse_unary_41);
-      return CDD_C_SUCCESS;
-    }
-  }
-
-  if ((match(s, TOKEN_MINUS, &_ast_match_42) == 0 && _ast_match_42)) {
-
-    {
-      *_out_val = -(parse_unary(s, &_ast_parse_unary_43), _ast_parse_unary_43);
-      return CDD_C_SUCCESS;
-    }
-  }
-
-  if ((match(s, TOKEN_PLUS, &_ast_match_44) == 0 && _ast_match_44)) {
-
-    {
-      *_out_val = +(parse_unary(s, &_ast_parse_unary_45), _ast_parse_unary_45);
-      return CDD_C_SUCCESS;
-    }
-  }
-
-  if (s->pos < s->end && s->tokens->tokens[s->pos].kind == TOKEN_IDENTIFIER &&
-
-      (token_matches_string(&s->tokens->tokens[s->pos], "defined",
-                            &_ast_token_matches_string_46) == 0 &&
-       _ast_token_matches_string_46)) {
-
-    int has_paren = false;
-
-    long result = 0;
-
-    s->pos++;
-
-    skip_ws(s, &_ast_skip_ws_47);
-
-    if ((match(s, TOKEN_LPAREN, &_ast_match_48) == 0 && _ast_match_48))
-
-      has_paren = true;
-
-    skip_ws(s, &_ast_skip_ws_49);
-
-    if (s->pos < s->end && s->tokens->tokens[s->pos].kind == TOKEN_IDENTIFIER) {
-
-      if ((is_defined_macro(s->ctx, &s->tokens->tokens[s->pos],
-                            &_ast_is_defined_macro_50) == 0 &&
-           _ast_is_defined_macro_50)) {
-
-        result = 1;
-      }
-
-      s->pos++;
-
-    } else {
-
-      s->error = 1;
-    }
-
-    if (has_paren) {
-
-      if (!(match(s, TOKEN_RPAREN, &_ast_match_51) == 0 && _ast_match_51))
-
-        s->error = 1;
-    }
-
-    {
-      *_out_val = result;
-      return CDD_C_SUCCESS;
-    }
-  }
-
-  {
-    *_out_val =
-        (parse_primary(s, &_ast_parse_primary_52), _ast_parse_primary_52);
-    return CDD_C_SUCCESS;
-  }
-}
-
-/**
- * @brief Parses multiplicative from the given input.
- */
-static cdd_c_error_t parse_multiplicative(struct ExprState *s, long *_out_val) {
-  long _ast_parse_unary_53;
-  int _ast_match_54 = 0;
-  long _ast_parse_unary_55;
-  int _ast_match_56 = 0;
-  long _ast_parse_unary_57;
-  int _ast_match_58 = 0;
-  long _ast_parse_unary_59;
-
-  long val = (parse_unary(s, &_ast_parse_unary_53), _ast_parse_unary_53);
-
-  while (s->pos < s->end && !s->error) {
-
-    if ((match(s, TOKEN_STAR, &_ast_match_54) == 0 && _ast_match_54)) {
-
-      val *= (parse_unary(s, &_ast_parse_unary_55), _ast_parse_unary_55);
-
-    } else if ((match(s, TOKEN_SLASH, &_ast_match_56) == 0 && _ast_match_56)) {
-
-      long divisor =
-          (parse_unary(s, &_ast_parse_unary_57), _ast_parse_unary_57);
-
-      if (divisor == 0)
-
-        val = 0;
-
-      else
-
-        val /= divisor;
-
-    } else if ((match(s, TOKEN_PERCENT, &_ast_match_58) == 0 &&
-                _ast_match_58)) {
-
-      long divisor =
-          (parse_unary(s, &_ast_parse_unary_59), _ast_parse_unary_59);
-
-      if (divisor == 0)
-
-        val = 0;
-
-      else
-
-        val %= divisor;
-
-    } else {
-
-      break;
-    }
-  }
-
-  {
-    *_out_val = val;
-    return CDD_C_SUCCESS;
-  }
-}
-
-/**
- * @brief Parses additive from the given input.
- */
-static cdd_c_error_t parse_additive(struct ExprState *s, long *_out_val) {
-  long _ast_parse_multiplicative_60;
-  int _ast_match_61 = 0;
-  long _ast_parse_multiplicative_62;
-  int _ast_match_63 = 0;
-  long _ast_parse_multiplicative_64;
-
-  long val = (parse_multiplicative(s, &_ast_parse_multiplicative_60),
-              _ast_parse_multiplicative_60);
-
-  while (s->pos < s->end && !s->error) {
-
-    if ((match(s, TOKEN_PLUS, &_ast_match_61) == 0 && _ast_match_61)) {
-
-      val += (parse_multiplicative(s, &_ast_parse_multiplicative_62),
-              _ast_parse_multiplicative_62);
-
-    } else if ((match(s, TOKEN_MINUS, &_ast_match_63) == 0 && _ast_match_63)) {
-
-      val -= (parse_multiplicative(s, &_ast_parse_multiplicative_64),
-              _ast_parse_multiplicative_64);
-
-    } else {
-
-      break;
-    }
-  }
-
-  {
-    *_out_val = val;
-    return CDD_C_SUCCESS;
-  }
-}
-
-/**
- * @brief Parses shift from the given input.
- */
-static cdd_c_error_t parse_shift(struct ExprState *s, long *_out_val) {
-  long _ast_parse_additive_65;
-  int _ast_match_66 = 0;
-  long _ast_parse_additive_67;
-  int _ast_match_68 = 0;
-  long _ast_parse_additive_69;
-
-  long val =
-      (parse_additive(s, &_ast_parse_additive_65), _ast_parse_additive_65);
-
-  while (s->pos < s->end && !s->error) {
-
-    if ((match(s, TOKEN_LSHIFT, &_ast_match_66) == 0 && _ast_match_66)) {
-
-      val <<=
-          (parse_additive(s, &_ast_parse_additive_67), _ast_parse_additive_67);
-
-    } else if ((match(s, TOKEN_RSHIFT, &_ast_match_68) == 0 && _ast_match_68)) {
-
-      val >>=
-          (parse_additive(s, &_ast_parse_additive_69), _ast_parse_additive_69);
-
-    } else {
-
-      break;
-    }
-  }
-
-  {
-    *_out_val = val;
-    return CDD_C_SUCCESS;
-  }
-}
-
-/**
- * @brief Parses relational from the given input.
- */
-static cdd_c_error_t parse_relational(struct ExprState *s, long *_out_val) {
-  long _ast_parse_shift_70;
-  enum TokenKind _ast_peek_71;
-  int _ast_match_72 = 0;
-  long _ast_parse_shift_73;
-  int _ast_match_74 = 0;
-  long _ast_parse_shift_75;
-  int _ast_match_76 = 0;
-  long _ast_parse_shift_77;
-  int _ast_match_78 = 0;
-  long _ast_parse_shift_79;
-
-  long val = (parse_shift(s, &_ast_parse_shift_70), _ast_parse_shift_70);
-
-  while (s->pos < s->end && !s->error) {
-
-    enum TokenKind k = (preprocessor_peek(s, &_ast_peek_71), _ast_peek_71);
-
-    if (k == TOKEN_LEQ) {
-
-      (match(s, k, &_ast_match_72) == 0 && _ast_match_72);
-
-      val =
-          (val <= (parse_shift(s, &_ast_parse_shift_73), _ast_parse_shift_73));
-
-    } else if (k == TOKEN_GEQ) {
-
-      (match(s, k, &_ast_match_74) == 0 && _ast_match_74);
-
-      val =
-          (val >= (parse_shift(s, &_ast_parse_shift_75), _ast_parse_shift_75));
-
-    } else if (k == TOKEN_LESS) {
-
-      (match(s, k, &_ast_match_76) == 0 && _ast_match_76);
-
-      val = (val < (parse_shift(s, &_ast_parse_shift_77), _ast_parse_shift_77));
-
-    } else if (k == TOKEN_GREATER) {
-
-      (match(s, k, &_ast_match_78) == 0 && _ast_match_78);
-
-      val = (val > (parse_shift(s, &_ast_parse_shift_79), _ast_parse_shift_79));
-
-    } else {
-
-      break;
-    }
-  }
-
-  {
-    *_out_val = val;
-    return CDD_C_SUCCESS;
-  }
-}
-
-/**
- * @brief Parses equality from the given input.
- */
-static cdd_c_error_t parse_equality(struct ExprState *s, long *_out_val) {
-  long _ast_parse_relational_80;
-  int _ast_match_81 = 0;
-  long _ast_parse_relational_82;
-  int _ast_match_83 = 0;
-  long _ast_parse_relational_84;
-
-  long val = (parse_relational(s, &_ast_parse_relational_80),
-              _ast_parse_relational_80);
-
-  while (s->pos < s->end && !s->error) {
-
-    if ((match(s, TOKEN_EQ, &_ast_match_81) == 0 && _ast_match_81)) {
-
-      val = (val == (parse_relational(s, &_ast_parse_relational_82),
-                     _ast_parse_relational_82));
-
-    } else if ((match(s, TOKEN_NEQ, &_ast_match_83) == 0 && _ast_match_83)) {
-
-      val = (val != (parse_relational(s, &_ast_parse_relational_84),
-                     _ast_parse_relational_84));
-
-    } else {
-
-      break;
-    }
-  }
-
-  {
-    *_out_val = val;
-    return CDD_C_SUCCESS;
-  }
-}
-
-/**
- * @brief Parses logic and from the given input.
- */
-static cdd_c_error_t parse_logic_and(struct ExprState *s, long *_out_val) {
-  long _ast_parse_equality_85;
-  int _ast_match_86 = 0;
-  long _ast_parse_equality_87;
-
-  long val =
-      (parse_equality(s, &_ast_parse_equality_85), _ast_parse_equality_85);
-
-  while ((match(s, TOKEN_LOGICAL_AND, &_ast_match_86) == 0 && _ast_match_86)) {
-
-    long rhs =
-        (parse_equality(s, &_ast_parse_equality_87), _ast_parse_equality_87);
-
-    val = (val && rhs);
-  }
-
-  {
-    *_out_val = val;
-    return CDD_C_SUCCESS;
-  }
-}
-
-/**
- * @brief Parses logic or from the given input.
- */
-static cdd_c_error_t parse_logic_or(struct ExprState *s, long *_out_val) {
-  long _ast_parse_logic_and_88;
-  int _ast_match_89 = 0;
-  long _ast_parse_logic_and_90;
-
-  long val =
-      (parse_logic_and(s, &_ast_parse_logic_and_88), _ast_parse_logic_and_88);
-
-  while ((match(s, TOKEN_LOGICAL_OR, &_ast_match_89) == 0 && _ast_match_89)) {
-
-    long rhs =
-        (parse_logic_and(s, &_ast_parse_logic_and_90), _ast_parse_logic_and_90);
-
-    val = (val || rhs);
-  }
-
-  {
-    *_out_val = val;
-    return CDD_C_SUCCESS;
-  }
-}
-
-/**
- * @brief Parses expr from the given input.
- */
-static cdd_c_error_t parse_expr(struct ExprState *s, long *_out_val) {
-  long _ast_parse_logic_or_91;
-  {
-    *_out_val =
-        (parse_logic_or(s, &_ast_parse_logic_or_91), _ast_parse_logic_or_91);
-    return CDD_C_SUCCESS;
-  }
-}
-
-/**
- * @brief Executes the pp eval expression operation.
- */
-cdd_c_error_t pp_eval_expression(const struct TokenList *tokens,
-                                 size_t start_idx,
-
-                                 size_t end_idx,
-                                 const struct PreprocessorContext *ctx,
-
-                                 long *result) {
-  long _ast_parse_expr_92;
-
-  struct ExprState s;
-
-  s.tokens = tokens;
-
-  s.pos = start_idx;
-
-  s.end = end_idx;
-
-  s.ctx = ctx;
-
-  s.error = 0;
-
-  *result = (parse_expr(&s, &_ast_parse_expr_92), _ast_parse_expr_92);
-
-  if (s.error)
-
-    return CDD_C_ERROR_INVALID_ARGUMENT;
+  rc = cdd_macro_compile(text, &program);
+  C_CDD_FREE(text);
+  if (rc == CDD_C_SUCCESS)
+    rc = cdd_macro_program_run(program, ctx, &value);
+  cdd_macro_program_free(program);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
 
+  if (value.type == MACRO_EVAL_TYPE_INT)
+    *result = (long)value.int_val;
+  else if (value.type == MACRO_EVAL_TYPE_FLOAT)
+    *result = (long)value.float_val;
+  cdd_macro_eval_result_free(&value);
   return CDD_C_SUCCESS;
 }
 
@@ -75,16 +75,46 @@ struct IncludeInfo {
 typedef cdd_c_error_t (*pp_visitor_cb)(const struct IncludeInfo *info,
                                        void *user_data);
 
+struct cdd_macro_program_t;
+
+/**
+ * @brief State of a memoized macro value.
+ */
+enum MacroValueState {
+  MACRO_VALUE_UNSET, /**< Not evaluated (or stale) */
+  MACRO_VALUE_BUSY,  /**< Being evaluated; seeing it again is a cycle */
+  MACRO_VALUE_DONE,  /**< Evaluated successfully */
+  MACRO_VALUE_FAILED /**< Evaluation failed */
+};
+
+/**
+ * @brief Value of a macro as last computed by the macro evaluator.
+ * Only valid while `generation` equals the context's `macro_generation`.
+ */
+struct MacroValue {
+  enum MacroValueState state; /**< Whether the fields below hold a value */
+  unsigned long generation;   /**< `macro_generation` it was computed in */
+  int type;                   /**< A cdd_macro_eval_type_t */
+  long long int_val;          /**< Integer value */
+  double float_val;           /**< Floating value */
+  char *str_val;              /**< String value (owned) */
+};
+
 /**
  * @brief Represents a single definition found in source code.
  */
 struct MacroDef {
-  char *name;           /**< Macro identifier */
-  int is_function_like; /**< True if defined as MACRO(...) */
-  int is_variadic;      /**< True if arguments end in ... */
-  char **args;          /**< Array of argument names (excluding .../VA_ARGS) */
-  size_t arg_count;     /**< Count of explicit arguments */
-  char *value;          /**< Raw text value of the macro (for object-like) */
+  char *name;             /**< Macro identifier */
+  int is_function_like;   /**< True if defined as MACRO(...) */
+  int is_variadic;        /**< True if arguments end in ... */
+  char **args;            /**< Argument names (excluding .../VA_ARGS) */
+  size_t arg_count;       /**< Count of explicit arguments */
+  char *value;            /**< Raw text value of the macro (for object-like) */
+  struct MacroValue memo; /**< Memoized evaluation of `value` */
+  /** `value` compiled on first evaluation; kept until the definition is
+   * replaced or removed, so a stale memo only re-runs it */
+  struct cdd_macro_program_t *program;
+  int program_failed; /**< `value` is not a constant expression */
 };
 
 /**
@@ -100,6 +130,10 @@ struct PreprocessorContext {
   size_t macro_count;      /**< Number of macros */
   size_t macro_capacity;   /**< Capacity of macro array */
 
+  /** Bumped whenever a macro is (re)defined or removed, which invalidates
+   * every memoized macro value. */
+  unsigned long macro_generation;
+
   /* Introspection context (current file path for relative lookups) */
   const char *current_file_dir; /**< Directory of the file being processed, used
                                    for relative include resolution. */
@@ -133,7 +167,8 @@ pp_add_search_path(struct PreprocessorContext *ctx, const char *path);
 
 /**
  * @brief Add a macro definition manually to the context.
- * Useful for seeding configuration macros (e.g., -DDEBUG).
+ * Useful for seeding configuration macros (e.g., -DDEBUG). Redefining an
+ * existing name replaces its definition.
  *
  * @param[in,out] ctx The context.
  * @param[in] name Macro name.
@@ -144,6 +179,16 @@ extern C_CDD_EXPORT cdd_c_error_t pp_add_macro(struct PreprocessorContext *ctx,
                                                const char *name,
                                                const char *value);
 
+/**
+ * @brief Remove a macro definition from the context, as `\#undef` does.
+ *
+ * @param[in,out] ctx The context.
+ * @param[in] name Macro name. Removing an undefined name is not an error.
+ * @return 0 on success, EINVAL if an argument is NULL.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+pp_remove_macro(struct PreprocessorContext *ctx, const char *name);
+
 /**
  * @brief Scan a file for \#include directives and resolve them.
  *
@@ -170,6 +215,8 @@ pp_scan_includes(const char *filename, struct PreprocessorContext *ctx,
  *
  * Parses `#define` lines to extract macro signatures.
  * correctly identifies `NAME`, `NAME(a, b)`, and `NAME(a, ...)` forms.
+ * A later `#define` of the same name replaces the earlier one, and `#undef`
+ * removes it.
  *
  * @param[in,out] ctx The context to populate with found macros.
  * @param[in] filename Path to the file to parse.
@@ -181,8 +228,8 @@ pp_scan_defines(struct PreprocessorContext *ctx, const char *filename);
 /**
  * @brief Evaluate a preprocessor constant expression.
  *
- * Implements a recursive descent parser for integer constant expressions
- * as defined in C standard logic (6.10.1).
+ * Compiles the tokens with `cdd_macro_compile`, where `defined` and the
+ * introspection operators are instructions, and runs the program once.
  * Supports:
  * - Arithmetic: +, -, *, /, %
  * - Logical: ||, &&, !
@@ -190,7 +237,8 @@ pp_scan_defines(struct PreprocessorContext *ctx, const char *filename);
  * - Comparison: ==, !=, <, >, <=, >=
  * - 'defined' operator
  * - Introspection: `__has_include`, `__has_embed`, `__has_c_attribute`
- * - Identifiers (resolves to 0 if not defined)
+ * - Identifiers (resolves to 0 if not defined; defined ones take the
+ *   memoized value from `cdd_macro_value`)
  *
  * @param[in] tokens The token list containing the expression.
  * @param[in] start_idx Index of the first token of the expression.
@@ -203,6 +251,20 @@ extern C_CDD_EXPORT cdd_c_error_t pp_eval_expression(
     const struct TokenList *tokens, size_t start_idx, size_t end_idx,
     const struct PreprocessorContext *ctx, long *result);
 
+/**
+ * @brief Whether an include could be resolved, as `__has_include` asks.
+ *
+ * @param[in] ctx Context supplying search paths and the current directory
+ * (may be NULL).
+ * @param[in] path The header name without its delimiters.
+ * @param[in] is_system 1 for `<path>`, 0 for `"path"`.
+ * @param[out] found Receives 1 if the file exists, else 0.
+ * @return 0 on success, or an error code.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+pp_has_include(const struct PreprocessorContext *ctx, const char *path,
+               int is_system, int *found);
+
 /**
  * @brief Release memory within EmbedParams structure.
  *
@@ -0,0 +1,1243 @@
+/**
+ * @file project_index.c
+ * @brief Building, updating and querying the project symbol index.
+ *
+ * Image layout (every field an unsigned 32-bit little-endian word):
+ *
+ *     "CDDPIDX\0" format n_files n_symbols n_calls n_names n_slots
+ *     n_postings strings_len
+ *     file    (path size fnv djb first_symbol n_symbols first_call
+ *              n_calls)...                    sorted by path
+ *     symbol  (name kind flags file return_type line)...
+ *     call    (caller callee)...              callee is a name id
+ *     name    (string n_symbols symbols_at n_callers callers_at)...
+ *     slot    (name id + 1, or 0)...          FNV-1a, linear probing
+ *     posting (symbol id)...
+ *     strings                                 NUL-terminated, "" at 0
+ *
+ * Sections follow each other without padding, so their offsets follow
+ * from the counts. Symbols and calls are grouped by file, which is what
+ * lets an update copy an unchanged file's facts as two ranges.
+ */
+
+/* clang-format off */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <c_str_span.h>
+
+#include "c_cdd/memory.h"
+#include "functions/parse/analysis.h"
+#include "functions/parse/project_index.h"
+#include "functions/parse/str.h"
+#include "functions/parse/tokenizer.h"
+/* clang-format on */
+
+#ifdef CDD_BUILD_TESTS
+C_CDD_EXPORT int g_project_index_alloc_fail = 0;
+#endif
+
+/** @brief Magic prefix of an index image. */
+static const char index_magic[8] = "CDDPIDX";
+
+/** @brief Words in the header after the magic. */
+#define HEADER_WORDS 8
+/** @brief Words per file record. */
+#define FILE_WORDS 8
+/** @brief Words per symbol record. */
+#define SYMBOL_WORDS 6
+/** @brief Words per call record. */
+#define CALL_WORDS 2
+/** @brief Words per name record. */
+#define NAME_WORDS 5
+/** @brief Largest count or offset a word can hold. */
+#define WORD_MAX 0xFFFFFFFFUL
+
+/* --- Encoding --- */
+
+/** @brief Reads the little-endian word at `p`. */
+static size_t get_word(const unsigned char *p) {
+  return (size_t)((unsigned long)p[0] | ((unsigned long)p[1] << 8) |
+                  ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24));
+}
+
+/** @brief Writes `v` as a little-endian word at `p`. */
+static void put_word(unsigned char *p, size_t v) {
+  p[0] = (unsigned char)(v & 0xFF);
+  p[1] = (unsigned char)((v >> 8) & 0xFF);
+  p[2] = (unsigned char)((v >> 16) & 0xFF);
+  p[3] = (unsigned char)((v >> 24) & 0xFF);
+}
+
+/** @brief FNV-1a of a name, as used by the name table. */
+static size_t name_hash(const char *s, size_t len) {
+  unsigned long h = 2166136261UL;
+  size_t i;
+  for (i = 0; i < len; ++i)
+    h = ((h ^ (unsigned char)s[i]) * 16777619UL) & 0xFFFFFFFFUL;
+  return (size_t)h;
+}
+
+/** @brief Folds `n` bytes into the running FNV-1a and djb2 file hashes. */
+static void content_hash(const char *data, size_t n, unsigned long *fnv,
+                         unsigned long *djb) {
+  size_t i;
+  *fnv = 2166136261UL;
+  *djb = 5381UL;
+  for (i = 0; i < n; ++i) {
+    *fnv = ((*fnv ^ (unsigned char)data[i]) * 16777619UL) & 0xFFFFFFFFUL;
+    *djb = ((*djb * 33UL) ^ (unsigned char)data[i]) & 0xFFFFFFFFUL;
+  }
+}
+
+/* --- In-memory builder --- */
+
+/**
+ * @brief Deduplicated strings, each a dense id into `offs`.
+ */
+struct IndexStrings {
+  char *buf;       /**< All strings, NUL-terminated, "" first */
+  size_t len;      /**< Used length of `buf` */
+  size_t cap;      /**< Allocated length of `buf` */
+  size_t *offs;    /**< Per id: offset into `buf` */
+  size_t count;    /**< Number of ids */
+  size_t offs_cap; /**< Allocated length of `offs` */
+  size_t *slots;   /**< Open-addressed table of id + 1 */
+  size_t n_slots;  /**< Table size, a power of two */
+};
+
+/** @brief A file as held by the builder. */
+struct IndexFile {
+  size_t path;         /**< String id */
+  unsigned long size;  /**< Content length */
+  unsigned long fnv;   /**< Content FNV-1a */
+  unsigned long djb;   /**< Content djb2 */
+  size_t first_symbol; /**< First symbol id */
+  size_t n_symbols;    /**< Symbols of the file */
+  size_t first_call;   /**< First call id */
+  size_t n_calls;      /**< Calls of the file */
+};
+
+/** @brief A symbol as held by the builder. */
+struct IndexSymbol {
+  size_t name;        /**< String id */
+  unsigned kind;      /**< enum ProjectIndexKind */
+  unsigned flags;     /**< PROJECT_INDEX_* flags */
+  size_t file;        /**< File id */
+  size_t return_type; /**< String id */
+  size_t line;        /**< 1-based line */
+};
+
+/** @brief A call edge as held by the builder. */
+struct IndexCall {
+  size_t caller; /**< Symbol id of the calling function */
+  size_t callee; /**< String id of the called name */
+};
+
+/**
+ * @brief Facts collected for a new image.
+ */
+struct IndexBuilder {
+  struct IndexStrings strings; /**< Interned strings */
+  struct IndexFile *files;     /**< Files, in path order */
+  size_t n_files;              /**< Number of files */
+  size_t cap_files;            /**< Capacity of `files` */
+  struct IndexSymbol *symbols; /**< Symbols, grouped by file */
+  size_t n_symbols;            /**< Number of symbols */
+  size_t cap_symbols;          /**< Capacity of `symbols` */
+  struct IndexCall *calls;     /**< Calls, grouped by file */
+  size_t n_calls;              /**< Number of calls */
+  size_t cap_calls;            /**< Capacity of `calls` */
+};
+
+/**
+ * @brief Makes room for one more element in a growable array.
+ */
+static cdd_c_error_t grow(void **arr, size_t *cap, size_t n, size_t elem) {
+  void *p;
+  size_t new_cap;
+  if (n < *cap)
+    return CDD_C_SUCCESS;
+  new_cap = *cap ? *cap * 2 : 16;
+#ifdef CDD_BUILD_TESTS
+  if (g_project_index_alloc_fail > 0 && --g_project_index_alloc_fail == 0)
+    return CDD_C_ERROR_MEMORY;
+#endif
+  p = C_CDD_REALLOC(*arr, new_cap * elem);
+  if (!p)
+    return CDD_C_ERROR_MEMORY;
+  *arr = p;
+  *cap = new_cap;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Interns a string, returning its id.
+ */
+static cdd_c_error_t strings_intern(struct IndexStrings *s, const char *str,
+                                    size_t len, size_t *out_id) {
+  size_t h = name_hash(str, len), mask, i, id;
+  cdd_c_error_t rc;
+
+  if ((s->count + 1) * 2 > s->n_slots) {
+    size_t n = s->n_slots ? s->n_slots * 2 : 64;
+    size_t *slots;
+#ifdef CDD_BUILD_TESTS
+    if (g_project_index_alloc_fail > 0 && --g_project_index_alloc_fail == 0)
+      return CDD_C_ERROR_MEMORY;
+#endif
+    slots = (size_t *)C_CDD_CALLOC(n, sizeof(size_t));
+    if (!slots)
+      return CDD_C_ERROR_MEMORY;
+    for (id = 0; id < s->count; ++id) {
+      const char *o = s->buf + s->offs[id];
+      i = name_hash(o, strlen(o)) & (n - 1);
+      while (slots[i])
+        i = (i + 1) & (n - 1);
+      slots[i] = id + 1;
+    }
+    C_CDD_FREE(s->slots);
+    s->slots = slots;
+    s->n_slots = n;
+  }
+
+  mask = s->n_slots - 1;
+  for (i = h & mask; s->slots[i]; i = (i + 1) & mask) {
+    const char *o = s->buf + s->offs[s->slots[i] - 1];
+    if (strncmp(o, str, len) == 0 && o[len] == '\0') {
+      *out_id = s->slots[i] - 1;
+      return CDD_C_SUCCESS;
+    }
+  }
+
+  while (s->len + len + 1 > s->cap) {
+    size_t new_cap = s->cap ? s->cap * 2 : 1024;
+    char *p;
+#ifdef CDD_BUILD_TESTS
+    if (g_project_index_alloc_fail > 0 && --g_project_index_alloc_fail == 0)
+      return CDD_C_ERROR_MEMORY;
+#endif
+    p = (char *)C_CDD_REALLOC(s->buf, new_cap);
+    if (!p)
+      return CDD_C_ERROR_MEMORY;
+    s->buf = p;
+    s->cap = new_cap;
+  }
+  rc = grow((void **)&s->offs, &s->offs_cap, s->count, sizeof(size_t));
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  memcpy(s->buf + s->len, str, len);
+  s->buf[s->len + len] = '\0';
+  s->offs[s->count] = s->len;
+  s->len += len + 1;
+  s->slots[i] = s->count + 1;
+  *out_id = s->count++;
+  return CDD_C_SUCCESS;
+}
+
+/** @brief Prepares an empty builder; string id 0 is "". */
+static cdd_c_error_t builder_init(struct IndexBuilder *b) {
+  size_t empty;
+  memset(b, 0, sizeof(*b));
+  return strings_intern(&b->strings, "", 0, &empty);
+}
+
+/** @brief Releases a builder. */
+static void builder_free(struct IndexBuilder *b) {
+  C_CDD_FREE(b->strings.buf);
+  C_CDD_FREE(b->strings.offs);
+  C_CDD_FREE(b->strings.slots);
+  C_CDD_FREE(b->files);
+  C_CDD_FREE(b->symbols);
+  C_CDD_FREE(b->calls);
+  memset(b, 0, sizeof(*b));
+}
+
+/** @brief Appends a symbol to the current (last) file. */
+static cdd_c_error_t builder_add_symbol(struct IndexBuilder *b, size_t name,
+                                        unsigned kind, unsigned flags,
+                                        size_t return_type, size_t line) {
+  struct IndexSymbol *s;
+  cdd_c_error_t rc = grow((void **)&b->symbols, &b->cap_symbols, b->n_symbols,
+                          sizeof(struct IndexSymbol));
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  s = &b->symbols[b->n_symbols++];
+  s->name = name;
+  s->kind = kind;
+  s->flags = flags;
+  s->file = b->n_files - 1;
+  s->return_type = return_type;
+  s->line = line;
+  b->files[b->n_files - 1].n_symbols++;
+  return CDD_C_SUCCESS;
+}
+
+/** @brief Appends a call edge to the current (last) file. */
+static cdd_c_error_t builder_add_call(struct IndexBuilder *b, size_t caller,
+                                      size_t callee) {
+  cdd_c_error_t rc = grow((void **)&b->calls, &b->cap_calls, b->n_calls,
+                          sizeof(struct IndexCall));
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  b->calls[b->n_calls].caller = caller;
+  b->calls[b->n_calls].callee = callee;
+  b->n_calls++;
+  b->files[b->n_files - 1].n_calls++;
+  return CDD_C_SUCCESS;
+}
+
+/** @brief Starts a new file; its symbols and calls follow. */
+static cdd_c_error_t builder_add_file(struct IndexBuilder *b, const char *path,
+                                      unsigned long size, unsigned long fnv,
+                                      unsigned long djb) {
+  struct IndexFile *f;
+  size_t path_id;
+  cdd_c_error_t rc = grow((void **)&b->files, &b->cap_files, b->n_files,
+                          sizeof(struct IndexFile));
+  if (rc == CDD_C_SUCCESS)
+    rc = strings_intern(&b->strings, path, strlen(path), &path_id);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  f = &b->files[b->n_files++];
+  f->path = path_id;
+  f->size = size;
+  f->fnv = fnv;
+  f->djb = djb;
+  f->first_symbol = b->n_symbols;
+  f->n_symbols = 0;
+  f->first_call = b->n_calls;
+  f->n_calls = 0;
+  return CDD_C_SUCCESS;
+}
+
+/* --- Scanning a source file --- */
+
+/** @brief Whether a token carries no syntax. */
+static int is_trivia(const struct Token *t) {
+  return t->kind == TOKEN_WHITESPACE || t->kind == TOKEN_COMMENT ||
+         t->kind == TOKEN_MACRO;
+}
+
+/** @brief Index of the next significant token at or after `i`. */
+static size_t next_sig(const struct TokenList *tl, size_t i, size_t end) {
+  while (i < end && is_trivia(&tl->tokens[i]))
+    i++;
+  return i;
+}
+
+/** @brief Index of the last significant token before `i`, or `start`. */
+static size_t prev_sig(const struct TokenList *tl, size_t start, size_t i) {
+  while (i > start) {
+    i--;
+    if (!is_trivia(&tl->tokens[i]))
+      return i;
+  }
+  return (size_t)-1;
+}
+
+/** @brief Whether token `i` spells `s`. */
+static int tok_is(const struct TokenList *tl, size_t i, const char *s) {
+  size_t len = strlen(s);
+  return tl->tokens[i].length == len &&
+         memcmp(tl->tokens[i].start, s, len) == 0;
+}
+
+/** @brief Interns the spelling of token `i`. */
+static cdd_c_error_t intern_tok(struct IndexBuilder *b,
+                                const struct TokenList *tl, size_t i,
+                                size_t *out_id) {
+  return strings_intern(&b->strings, (const char *)tl->tokens[i].start,
+                        tl->tokens[i].length, out_id);
+}
+
+/** @brief 1-based line of token `i`. */
+static size_t tok_line(const struct TokenList *tl, size_t i) {
+  size_t line = 0, col = 0;
+  if (token_list_position(tl, tl->tokens[i].start, &line, &col) !=
+      CDD_C_SUCCESS)
+    return 0;
+  return line;
+}
+
+/**
+ * @brief Summarises the return type `[start, name)` of a function: its
+ * flags and its text without storage class, `inline` or attributes, as
+ * used to declare a temporary of that type.
+ */
+static cdd_c_error_t return_type_of(struct IndexBuilder *b,
+                                    const struct TokenList *tl, size_t start,
+                                    size_t name, unsigned *flags,
+                                    size_t *out_id) {
+  char *buf;
+  size_t len = 0, i, depth = 0;
+  cdd_c_error_t rc;
+
+  for (i = start; i < name; ++i)
+    len += tl->tokens[i].length + 1;
+  buf = (char *)C_CDD_MALLOC(len + 1);
+  if (!buf)
+    return CDD_C_ERROR_MEMORY;
+  len = 0;
+  for (i = start; i < name; ++i) {
+    const struct Token *t = &tl->tokens[i];
+    if (is_trivia(t))
+      continue;
+    if (t->kind == TOKEN_KEYWORD_ATTRIBUTE ||
+        t->kind == TOKEN_KEYWORD_DECLSPEC) {
+      /* Skip `__attribute__((...))` as a whole */
+      size_t j = next_sig(tl, i + 1, name);
+      if (j < name && tl->tokens[j].kind == TOKEN_LPAREN) {
+        for (i = j; i < name; ++i) {
+          if (tl->tokens[i].kind == TOKEN_LPAREN)
+            depth++;
+          else if (tl->tokens[i].kind == TOKEN_RPAREN && --depth == 0)
+            break;
+        }
+      }
+      continue;
+    }
+    if (t->kind == TOKEN_KEYWORD_STATIC) {
+      *flags |= PROJECT_INDEX_STATIC;
+      continue;
+    }
+    if (t->kind == TOKEN_KEYWORD_EXTERN || t->kind == TOKEN_KEYWORD_INLINE ||
+        t->kind == TOKEN_KEYWORD_NORETURN)
+      continue;
+    if (t->kind == TOKEN_STAR)
+      *flags |= PROJECT_INDEX_RETURNS_PTR;
+    else if (t->kind == TOKEN_KEYWORD_VOID || tok_is(tl, i, "void"))
+      *flags |= PROJECT_INDEX_RETURNS_VOID;
+    else if (tok_is(tl, i, "cdd_c_error_t") || tok_is(tl, i, "cdd_c_error"))
+      *flags |= PROJECT_INDEX_RETURNS_ERROR;
+    if (len > 0 && t->kind != TOKEN_STAR)
+      buf[len++] = ' ';
+    else if (len > 0 && buf[len - 1] != '*')
+      buf[len++] = ' ';
+    memcpy(buf + len, t->start, t->length);
+    len += t->length;
+  }
+  /* Pointer takes precedence (e.g. void *) */
+  if (*flags & PROJECT_INDEX_RETURNS_PTR)
+    *flags &= ~PROJECT_INDEX_RETURNS_VOID;
+  rc = strings_intern(&b->strings, buf, len, out_id);
+  C_CDD_FREE(buf);
+  return rc;
+}
+
+/**
+ * @brief Records the typedef names declared by `[start, end)`.
+ */
+static cdd_c_error_t index_typedef(struct IndexBuilder *b,
+                                   const struct TokenList *tl, size_t start,
+                                   size_t end) {
+  size_t i, seg, depth = 0;
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+
+  /* Declarators follow the last top-level `}`, if there is a body */
+  seg = start;
+  for (i = start; i < end; ++i) {
+    enum TokenKind k = tl->tokens[i].kind;
+    if (k == TOKEN_LBRACE || k == TOKEN_LPAREN || k == TOKEN_LBRACKET)
+      depth++;
+    else if (k == TOKEN_RBRACE || k == TOKEN_RPAREN || k == TOKEN_RBRACKET) {
+      if (depth > 0)
+        depth--;
+      if (k == TOKEN_RBRACE && depth == 0)
+        seg = i + 1;
+    }
+  }
+
+  while (seg < end && rc == CDD_C_SUCCESS) {
+    size_t name = (size_t)-1;
+    depth = 0;
+    for (i = seg; i < end; ++i) {
+      enum TokenKind k = tl->tokens[i].kind;
+      if (depth == 0 && (k == TOKEN_COMMA || k == TOKEN_SEMICOLON))
+        break;
+      if (k == TOKEN_LPAREN || k == TOKEN_LBRACKET) {
+        size_t n = next_sig(tl, i + 1, end);
+        if (depth == 0 && k == TOKEN_LPAREN && n < end &&
+            tl->tokens[n].kind == TOKEN_STAR && name == (size_t)-1) {
+          /* `(*name)(...)`: the name is inside the parens */
+          while (n < end && (tl->tokens[n].kind == TOKEN_STAR ||
+                             is_trivia(&tl->tokens[n])))
+            n++;
+          if (n < end && tl->tokens[n].kind == TOKEN_IDENTIFIER)
+            name = n;
+        }
+        depth++;
+      } else if (k == TOKEN_RPAREN || k == TOKEN_RBRACKET) {
+        if (depth > 0)
+          depth--;
+      } else if (depth == 0 && k == TOKEN_IDENTIFIER) {
+        size_t p = prev_sig(tl, seg, i);
+        /* The last plain identifier is the name (`struct T name`) */
+        if (name == (size_t)-1 || tl->tokens[name].kind == TOKEN_IDENTIFIER)
+          if (p == (size_t)-1 || tl->tokens[p].kind != TOKEN_RPAREN)
+            name = i;
+      }
+    }
+    if (name != (size_t)-1) {
+      size_t name_id, empty = 0;
+      rc = intern_tok(b, tl, name, &name_id);
+      if (rc == CDD_C_SUCCESS)
+        rc = builder_add_symbol(b, name_id, PROJECT_INDEX_TYPEDEF, 0, empty,
+                                tok_line(tl, name));
+    }
+    seg = i + 1;
+  }
+  return rc;
+}
+
+/**
+ * @brief Records the distinct names called in the body `[body, end)` of
+ * the function with symbol id `caller`.
+ */
+static cdd_c_error_t index_calls(struct IndexBuilder *b,
+                                 const struct TokenList *tl, size_t body,
+                                 size_t end, size_t caller) {
+  size_t first = b->n_calls, i, k;
+  cdd_c_error_t rc;
+
+  for (i = body; i < end; ++i) {
+    size_t n, p, callee;
+    if (tl->tokens[i].kind != TOKEN_IDENTIFIER)
+      continue;
+    n = next_sig(tl, i + 1, end);
+    if (n >= end || tl->tokens[n].kind != TOKEN_LPAREN)
+      continue;
+    p = prev_sig(tl, body, i);
+    if (p != (size_t)-1 && (tl->tokens[p].kind == TOKEN_DOT ||
+                            tl->tokens[p].kind == TOKEN_ARROW))
+      continue;
+    rc = intern_tok(b, tl, i, &callee);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    for (k = first; k < b->n_calls; ++k)
+      if (b->calls[k].callee == callee)
+        break;
+    if (k == b->n_calls) {
+      rc = builder_add_call(b, caller, callee);
+      if (rc != CDD_C_SUCCESS)
+        return rc;
+    }
+  }
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Records the function definitions, prototypes and typedefs of one
+ * source file, and the calls made by each function, in the current file.
+ */
+static cdd_c_error_t index_source(struct IndexBuilder *b, const char *content,
+                                  size_t len) {
+  struct TokenList *tl = NULL;
+  struct AllocationSiteList allocs;
+  size_t i = 0, n, a = 0;
+  cdd_c_error_t rc;
+
+  allocation_site_list_init(&allocs);
+  rc = tokenize(az_span_create((uint8_t *)content, (int32_t)len), &tl);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  rc = find_allocations(tl, &allocs);
+  if (rc != CDD_C_SUCCESS) {
+    free_token_list(tl);
+    return rc;
+  }
+  n = tl->size;
+
+  /* Fold each directive line into trivia, as `parse_tokens` groups them */
+  for (i = 0; i < n; ++i) {
+    if (tl->tokens[i].kind != TOKEN_HASH)
+      continue;
+    for (; i < n; ++i) {
+      const struct Token *t = &tl->tokens[i];
+      if (t->kind == TOKEN_WHITESPACE && memchr(t->start, '\n', t->length))
+        break;
+      tl->tokens[i].kind = TOKEN_MACRO;
+    }
+  }
+
+  i = 0;
+  while (i < n && rc == CDD_C_SUCCESS) {
+    size_t start, lparen = (size_t)-1, body = (size_t)-1, end, name, last;
+    size_t paren = 0, brace = 0;
+    int is_typedef, has_assign = 0;
+
+    start = i = next_sig(tl, i, n);
+    if (i >= n)
+      break;
+    /* `extern "C" {` and its `}` are transparent */
+    if (tl->tokens[i].kind == TOKEN_KEYWORD_EXTERN) {
+      size_t s = next_sig(tl, i + 1, n);
+      size_t l = s < n ? next_sig(tl, s + 1, n) : n;
+      if (l < n && tl->tokens[s].kind == TOKEN_STRING_LITERAL &&
+          tl->tokens[l].kind == TOKEN_LBRACE) {
+        i = l + 1;
+        continue;
+      }
+    }
+    if (tl->tokens[i].kind == TOKEN_RBRACE ||
+        tl->tokens[i].kind == TOKEN_SEMICOLON) {
+      i++;
+      continue;
+    }
+    is_typedef = tl->tokens[i].kind == TOKEN_KEYWORD_TYPEDEF;
+
+    last = (size_t)-1;
+    for (; i < n; ++i) {
+      enum TokenKind k = tl->tokens[i].kind;
+      if (is_trivia(&tl->tokens[i]))
+        continue;
+      if (k == TOKEN_LPAREN) {
+        if (paren == 0 && brace == 0 && lparen == (size_t)-1)
+          lparen = i;
+        paren++;
+      } else if (k == TOKEN_RPAREN) {
+        if (paren > 0)
+          paren--;
+      } else if (k == TOKEN_ASSIGN && paren == 0 && brace == 0) {
+        has_assign = 1;
+      } else if (k == TOKEN_LBRACE) {
+        if (paren == 0 && brace == 0 && !is_typedef && !has_assign &&
+            lparen != (size_t)-1 && last != (size_t)-1 &&
+            tl->tokens[last].kind == TOKEN_RPAREN) {
+          body = i;
+          brace = 1;
+          for (i = i + 1; i < n && brace > 0; ++i) {
+            if (tl->tokens[i].kind == TOKEN_LBRACE)
+              brace++;
+            else if (tl->tokens[i].kind == TOKEN_RBRACE)
+              brace--;
+          }
+          break;
+        }
+        brace++;
+      } else if (k == TOKEN_RBRACE) {
+        if (brace == 0)
+          break; /* Closes an enclosing `extern "C" {` */
+        brace--;
+      } else if (k == TOKEN_SEMICOLON && paren == 0 && brace == 0) {
+        i++;
+        break;
+      }
+      last = i;
+    }
+    end = i;
+
+    if (is_typedef) {
+      rc = index_typedef(b, tl, start, end);
+      continue;
+    }
+    if (lparen == (size_t)-1 || (has_assign && body == (size_t)-1))
+      continue;
+    name = prev_sig(tl, start, lparen);
+    if (name == (size_t)-1 || name == start ||
+        tl->tokens[name].kind != TOKEN_IDENTIFIER)
+      continue;
+    {
+      size_t after = next_sig(tl, lparen + 1, end);
+      /* `T (*fp)(...)` declares a variable */
+      if (after < end && tl->tokens[after].kind == TOKEN_STAR)
+        continue;
+    }
+
+    {
+      unsigned flags = 0;
+      size_t name_id, type_id, sym;
+      rc = return_type_of(b, tl, start, name, &flags, &type_id);
+      if (rc == CDD_C_SUCCESS)
+        rc = intern_tok(b, tl, name, &name_id);
+      if (rc != CDD_C_SUCCESS)
+        break;
+      if (body != (size_t)-1) {
+        /* Sites are in token order, as are the functions */
+        while (a < allocs.size && allocs.sites[a].token_index < body)
+          a++;
+        if (a < allocs.size && allocs.sites[a].token_index < end)
+          flags |= PROJECT_INDEX_ALLOCATES;
+      }
+      sym = b->n_symbols;
+      rc = builder_add_symbol(b, name_id,
+                              body != (size_t)-1 ? PROJECT_INDEX_FUNCTION
+                                                 : PROJECT_INDEX_PROTOTYPE,
+                              flags, type_id, tok_line(tl, name));
+      if (rc == CDD_C_SUCCESS && body != (size_t)-1)
+        rc = index_calls(b, tl, body, end, sym);
+    }
+  }
+
+  allocation_site_list_free(&allocs);
+  free_token_list(tl);
+  return rc;
+}
+
+/* --- Image writing --- */
+
+/**
+ * @brief Lays the builder's facts out as an image.
+ */
+static cdd_c_error_t builder_serialize(const struct IndexBuilder *b,
+                                       unsigned char **out_buf,
+                                       size_t *out_len) {
+  const struct IndexStrings *s = &b->strings;
+  size_t *name_of = NULL;   /* Per string id: name id + 1, or 0 */
+  size_t *name_str = NULL;  /* Per name id: string id */
+  size_t *n_syms = NULL, *syms_at = NULL, *n_callers = NULL;
+  size_t *callers_at = NULL, *fill = NULL;
+  size_t n_names = 0, n_slots = 8, n_postings, i;
+  size_t files_off, symbols_off, calls_off, names_off, slots_off;
+  size_t postings_off, strings_off, total;
+  unsigned char *img = NULL, *p;
+  cdd_c_error_t rc = CDD_C_ERROR_MEMORY;
+
+  n_postings = b->n_symbols + b->n_calls;
+  if (b->n_files > WORD_MAX / 32 || n_postings > WORD_MAX / 32 ||
+      s->len > WORD_MAX / 2)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  name_of = (size_t *)C_CDD_CALLOC(s->count ? s->count : 1, sizeof(size_t));
+  name_str = (size_t *)C_CDD_MALLOC((n_postings ? n_postings : 1) *
+                                    sizeof(size_t));
+  if (!name_of || !name_str)
+    goto cleanup;
+  for (i = 0; i < b->n_symbols + b->n_calls; ++i) {
+    size_t str = i < b->n_symbols ? b->symbols[i].name
+                                  : b->calls[i - b->n_symbols].callee;
+    if (!name_of[str]) {
+      name_str[n_names] = str;
+      name_of[str] = ++n_names;
+    }
+  }
+  while (n_slots < n_names * 2)
+    n_slots *= 2;
+
+  n_syms = (size_t *)C_CDD_CALLOC(n_names + 1, sizeof(size_t));
+  syms_at = (size_t *)C_CDD_CALLOC(n_names + 1, sizeof(size_t));
+  n_callers = (size_t *)C_CDD_CALLOC(n_names + 1, sizeof(size_t));
+  callers_at = (size_t *)C_CDD_CALLOC(n_names + 1, sizeof(size_t));
+  fill = (size_t *)C_CDD_CALLOC(n_names + 1, sizeof(size_t));
+  if (!n_syms || !syms_at || !n_callers || !callers_at || !fill)
+    goto cleanup;
+  for (i = 0; i < b->n_symbols; ++i)
+    n_syms[name_of[b->symbols[i].name] - 1]++;
+  for (i = 0; i < b->n_calls; ++i)
+    n_callers[name_of[b->calls[i].callee] - 1]++;
+  {
+    size_t at = 0;
+    for (i = 0; i < n_names; ++i) {
+      syms_at[i] = at;
+      at += n_syms[i];
+    }
+    for (i = 0; i < n_names; ++i) {
+      callers_at[i] = at;
+      at += n_callers[i];
+    }
+  }
+
+  files_off = sizeof(index_magic) + HEADER_WORDS * 4;
+  symbols_off = files_off + b->n_files * FILE_WORDS * 4;
+  calls_off = symbols_off + b->n_symbols * SYMBOL_WORDS * 4;
+  names_off = calls_off + b->n_calls * CALL_WORDS * 4;
+  slots_off = names_off + n_names * NAME_WORDS * 4;
+  postings_off = slots_off + n_slots * 4;
+  strings_off = postings_off + n_postings * 4;
+  total = strings_off + s->len;
+
+#ifdef CDD_BUILD_TESTS
+  if (g_project_index_alloc_fail > 0 && --g_project_index_alloc_fail == 0)
+    goto cleanup;
+#endif
+  img = (unsigned char *)C_CDD_CALLOC(total, 1);
+  if (!img)
+    goto cleanup;
+
+  memcpy(img, index_magic, sizeof(index_magic));
+  p = img + sizeof(index_magic);
+  put_word(p, PROJECT_INDEX_FORMAT);
+  put_word(p + 4, b->n_files);
+  put_word(p + 8, b->n_symbols);
+  put_word(p + 12, b->n_calls);
+  put_word(p + 16, n_names);
+  put_word(p + 20, n_slots);
+  put_word(p + 24, n_postings);
+  put_word(p + 28, s->len);
+
+  for (i = 0; i < b->n_files; ++i) {
+    const struct IndexFile *f = &b->files[i];
+    p = img + files_off + i * FILE_WORDS * 4;
+    put_word(p, s->offs[f->path]);
+    put_word(p + 4, f->size);
+    put_word(p + 8, f->fnv);
+    put_word(p + 12, f->djb);
+    put_word(p + 16, f->first_symbol);
+    put_word(p + 20, f->n_symbols);
+    put_word(p + 24, f->first_call);
+    put_word(p + 28, f->n_calls);
+  }
+  for (i = 0; i < b->n_symbols; ++i) {
+    const struct IndexSymbol *sym = &b->symbols[i];
+    size_t name = name_of[sym->name] - 1;
+    p = img + symbols_off + i * SYMBOL_WORDS * 4;
+    put_word(p, name);
+    put_word(p + 4, sym->kind);
+    put_word(p + 8, sym->flags);
+    put_word(p + 12, sym->file);
+    put_word(p + 16, s->offs[sym->return_type]);
+    put_word(p + 20, sym->line);
+    put_word(img + postings_off + (syms_at[name] + fill[name]++) * 4, i);
+  }
+  for (i = 0; i < n_names; ++i)
+    fill[i] = 0;
+  for (i = 0; i < b->n_calls; ++i) {
+    size_t callee = name_of[b->calls[i].callee] - 1;
+    p = img + calls_off + i * CALL_WORDS * 4;
+    put_word(p, b->calls[i].caller);
+    put_word(p + 4, callee);
+    put_word(img + postings_off + (callers_at[callee] + fill[callee]++) * 4,
+             b->calls[i].caller);
+  }
+  for (i = 0; i < n_names; ++i) {
+    const char *str = s->buf + s->offs[name_str[i]];
+    size_t slot = name_hash(str, strlen(str)) & (n_slots - 1);
+    p = img + names_off + i * NAME_WORDS * 4;
+    put_word(p, s->offs[name_str[i]]);
+    put_word(p + 4, n_syms[i]);
+    put_word(p + 8, syms_at[i]);
+    put_word(p + 12, n_callers[i]);
+    put_word(p + 16, callers_at[i]);
+    while (get_word(img + slots_off + slot * 4))
+      slot = (slot + 1) & (n_slots - 1);
+    put_word(img + slots_off + slot * 4, i + 1);
+  }
+  memcpy(img + strings_off, s->buf, s->len);
+
+  *out_buf = img;
+  *out_len = total;
+  img = NULL;
+  rc = CDD_C_SUCCESS;
+
+cleanup:
+  C_CDD_FREE(img);
+  C_CDD_FREE(name_of);
+  C_CDD_FREE(name_str);
+  C_CDD_FREE(n_syms);
+  C_CDD_FREE(syms_at);
+  C_CDD_FREE(n_callers);
+  C_CDD_FREE(callers_at);
+  C_CDD_FREE(fill);
+  return rc;
+}
+
+/** @brief Writes an image next to `path` and renames it into place. */
+static cdd_c_error_t write_image(const char *path, const unsigned char *img,
+                                 size_t len) {
+  char *tmp_path;
+  FILE *fh;
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+
+  tmp_path = (char *)C_CDD_MALLOC(strlen(path) + 5);
+  if (!tmp_path)
+    return CDD_C_ERROR_MEMORY;
+  sprintf(tmp_path, "%s.tmp", path);
+#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
+  if (fopen_s(&fh, tmp_path, "wb") != 0)
+    fh = NULL;
+#else
+  fh = fopen(tmp_path, "wb");
+#endif
+  if (!fh) {
+    C_CDD_FREE(tmp_path);
+    return CDD_C_ERROR_IO;
+  }
+  if (fwrite(img, 1, len, fh) != len)
+    rc = CDD_C_ERROR_IO;
+  if (fclose(fh) != 0)
+    rc = CDD_C_ERROR_IO;
+  /* Publish by rename so a concurrent reader never sees a partial index */
+  if (rc == CDD_C_SUCCESS)
+    rc = fs_replace_file(path, tmp_path);
+  if (rc != CDD_C_SUCCESS)
+    remove(tmp_path);
+  C_CDD_FREE(tmp_path);
+  return rc;
+}
+
+/* --- Querying --- */
+
+/** @brief Start of word `w` of record `i` in a section. */
+static const unsigned char *record(const struct ProjectIndex *idx,
+                                   size_t off, size_t words, size_t i) {
+  return idx->base + off + i * words * 4;
+}
+
+/** @brief A string by offset, or NULL if out of range. */
+static const char *string_at(const struct ProjectIndex *idx, size_t off) {
+  if (off >= idx->strings_len)
+    return NULL;
+  return (const char *)idx->base + idx->strings_off + off;
+}
+
+cdd_c_error_t project_index_open(const char *path, struct ProjectIndex *out) {
+  const unsigned char *p;
+  size_t n_postings, need, words;
+  cdd_c_error_t rc;
+
+  if (!path || !out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  memset(out, 0, sizeof(*out));
+  rc = fs_map_file(path, &out->file);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  out->base = (const unsigned char *)out->file.data;
+
+  if (out->file.size < sizeof(index_magic) + HEADER_WORDS * 4 ||
+      memcmp(out->base, index_magic, sizeof(index_magic)) != 0)
+    goto corrupt;
+  p = out->base + sizeof(index_magic);
+  if (get_word(p) != PROJECT_INDEX_FORMAT)
+    goto corrupt;
+  out->n_files = get_word(p + 4);
+  out->n_symbols = get_word(p + 8);
+  out->n_calls = get_word(p + 12);
+  out->n_names = get_word(p + 16);
+  out->n_slots = get_word(p + 20);
+  n_postings = get_word(p + 24);
+  out->strings_len = get_word(p + 28);
+
+  /* Every count is below 2^32, so this sum cannot overflow 64 bits, and
+     any count that would overflow 32 bits cannot match the file size */
+  words = out->n_files * FILE_WORDS + out->n_symbols * SYMBOL_WORDS +
+          out->n_calls * CALL_WORDS + out->n_names * NAME_WORDS +
+          out->n_slots + n_postings;
+  need = sizeof(index_magic) + HEADER_WORDS * 4 + words * 4 +
+         out->strings_len;
+  if (need != out->file.size || out->strings_len == 0 ||
+      out->n_slots == 0 || (out->n_slots & (out->n_slots - 1)) != 0 ||
+      out->n_names >= out->n_slots ||
+      n_postings != out->n_symbols + out->n_calls)
+    goto corrupt;
+
+  out->files_off = sizeof(index_magic) + HEADER_WORDS * 4;
+  out->symbols_off = out->files_off + out->n_files * FILE_WORDS * 4;
+  out->calls_off = out->symbols_off + out->n_symbols * SYMBOL_WORDS * 4;
+  out->names_off = out->calls_off + out->n_calls * CALL_WORDS * 4;
+  out->slots_off = out->names_off + out->n_names * NAME_WORDS * 4;
+  out->postings_off = out->slots_off + out->n_slots * 4;
+  out->strings_off = out->postings_off + n_postings * 4;
+  /* Every string offset below strings_len then reads a terminated string */
+  if (out->base[out->strings_off + out->strings_len - 1] != '\0')
+    goto corrupt;
+  return CDD_C_SUCCESS;
+
+corrupt:
+  project_index_close(out);
+  return CDD_C_ERROR_INVALID_ARGUMENT;
+}
+
+void project_index_close(struct ProjectIndex *idx) {
+  if (!idx)
+    return;
+  fs_unmap_file(&idx->file);
+  memset(idx, 0, sizeof(*idx));
+}
+
+cdd_c_error_t project_index_name(const struct ProjectIndex *idx, size_t id,
+                                 struct ProjectIndexName *out) {
+  const unsigned char *r;
+  size_t n_postings;
+  if (!idx || !out || id >= idx->n_names)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  r = record(idx, idx->names_off, NAME_WORDS, id);
+  n_postings = idx->n_symbols + idx->n_calls;
+  out->id = id;
+  out->name = string_at(idx, get_word(r));
+  out->n_symbols = get_word(r + 4);
+  out->symbols_at = get_word(r + 8);
+  out->n_callers = get_word(r + 12);
+  out->callers_at = get_word(r + 16);
+  if (!out->name || out->symbols_at > n_postings ||
+      out->n_symbols > n_postings - out->symbols_at ||
+      out->callers_at > n_postings ||
+      out->n_callers > n_postings - out->callers_at)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  return CDD_C_SUCCESS;
+}
+
+cdd_c_error_t project_index_find(const struct ProjectIndex *idx,
+                                 const char *name, size_t len,
+                                 struct ProjectIndexName *out) {
+  size_t mask, i, probes;
+  if (!idx || !name || !out || !idx->base)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  mask = idx->n_slots - 1;
+  i = name_hash(name, len) & mask;
+  for (probes = 0; probes < idx->n_slots; ++probes, i = (i + 1) & mask) {
+    size_t slot = get_word(idx->base + idx->slots_off + i * 4);
+    if (slot == 0)
+      break;
+    if (project_index_name(idx, slot - 1, out) != CDD_C_SUCCESS)
+      return CDD_C_ERROR_INVALID_ARGUMENT;
+    if (strncmp(out->name, name, len) == 0 && out->name[len] == '\0')
+      return CDD_C_SUCCESS;
+  }
+  return CDD_C_ERROR_NOT_FOUND;
+}
+
+cdd_c_error_t project_index_symbol(const struct ProjectIndex *idx, size_t id,
+                                   struct ProjectIndexSymbol *out) {
+  const unsigned char *r;
+  struct ProjectIndexName name;
+  size_t kind;
+  if (!idx || !out || id >= idx->n_symbols)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  r = record(idx, idx->symbols_off, SYMBOL_WORDS, id);
+  out->id = id;
+  out->name_id = get_word(r);
+  kind = get_word(r + 4);
+  out->flags = (unsigned)get_word(r + 8);
+  out->file_id = get_word(r + 12);
+  out->return_type = string_at(idx, get_word(r + 16));
+  out->line = get_word(r + 20);
+  if (kind > PROJECT_INDEX_TYPEDEF || out->file_id >= idx->n_files ||
+      !out->return_type ||
+      project_index_name(idx, out->name_id, &name) != CDD_C_SUCCESS)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  out->kind = (enum ProjectIndexKind)kind;
+  out->name = name.name;
+  out->file =
+      string_at(idx, get_word(record(idx, idx->files_off, FILE_WORDS,
+                                     out->file_id)));
+  return out->file ? CDD_C_SUCCESS : CDD_C_ERROR_INVALID_ARGUMENT;
+}
+
+cdd_c_error_t project_index_symbol_of(const struct ProjectIndex *idx,
+                                      const struct ProjectIndexName *name,
+                                      size_t i,
+                                      struct ProjectIndexSymbol *out) {
+  if (!idx || !name || i >= name->n_symbols)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  return project_index_symbol(
+      idx, get_word(idx->base + idx->postings_off + (name->symbols_at + i) * 4),
+      out);
+}
+
+cdd_c_error_t project_index_caller_of(const struct ProjectIndex *idx,
+                                      const struct ProjectIndexName *name,
+                                      size_t i,
+                                      struct ProjectIndexSymbol *out) {
+  if (!idx || !name || i >= name->n_callers)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  return project_index_symbol(
+      idx, get_word(idx->base + idx->postings_off + (name->callers_at + i) * 4),
+      out);
+}
+
+/* --- Updating --- */
+
+/** @brief Paths collected by the directory walk. */
+struct PathList {
+  char **paths; /**< Owned paths */
+  size_t size;  /**< Number of paths */
+  size_t cap;   /**< Capacity of `paths` */
+};
+
+/** @brief Collects `.c` and `.h` files. */
+static cdd_c_error_t collect_source(const char *path, void *user_data) {
+  struct PathList *list = (struct PathList *)user_data;
+  const char *dot = strrchr(path, '.');
+  cdd_c_error_t rc;
+  if (!dot || (strcmp(dot, ".c") != 0 && strcmp(dot, ".h") != 0))
+    return CDD_C_SUCCESS;
+  rc = grow((void **)&list->paths, &list->cap, list->size, sizeof(char *));
+  if (rc == CDD_C_SUCCESS)
+    rc = c_cdd_strdup(path, &list->paths[list->size]);
+  if (rc == CDD_C_SUCCESS)
+    list->size++;
+  return rc;
+}
+
+/** @brief qsort comparator over `char *`. */
+static int path_cmp(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/** @brief Binary search for a path among the (sorted) files of `idx`. */
+static size_t find_file(const struct ProjectIndex *idx, const char *path) {
+  size_t lo = 0, hi = idx->n_files;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    const char *s =
+        string_at(idx, get_word(record(idx, idx->files_off, FILE_WORDS, mid)));
+    int c;
+    if (!s)
+      return (size_t)-1;
+    c = strcmp(s, path);
+    if (c == 0)
+      return mid;
+    if (c < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return (size_t)-1;
+}
+
+/**
+ * @brief Copies the facts of file `f` of `old` into the builder's new
+ * (last) file.
+ */
+static cdd_c_error_t copy_file_facts(struct IndexBuilder *b,
+                                     const struct ProjectIndex *old,
+                                     size_t f) {
+  const unsigned char *r = record(old, old->files_off, FILE_WORDS, f);
+  size_t first_sym = get_word(r + 16), n_syms = get_word(r + 20);
+  size_t first_call = get_word(r + 24), n_calls = get_word(r + 28);
+  size_t new_first = b->n_symbols, i;
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+
+  if (first_sym > old->n_symbols || n_syms > old->n_symbols - first_sym ||
+      first_call > old->n_calls || n_calls > old->n_calls - first_call)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  for (i = 0; i < n_syms && rc == CDD_C_SUCCESS; ++i) {
+    struct ProjectIndexSymbol sym;
+    size_t name_id, type_id;
+    rc = project_index_symbol(old, first_sym + i, &sym);
+    if (rc == CDD_C_SUCCESS)
+      rc = strings_intern(&b->strings, sym.name, strlen(sym.name), &name_id);
+    if (rc == CDD_C_SUCCESS)
+      rc = strings_intern(&b->strings, sym.return_type,
+                          strlen(sym.return_type), &type_id);
+    if (rc == CDD_C_SUCCESS)
+      rc = builder_add_symbol(b, name_id, (unsigned)sym.kind, sym.flags,
+                              type_id, sym.line);
+  }
+  for (i = 0; i < n_calls && rc == CDD_C_SUCCESS; ++i) {
+    const unsigned char *c =
+        record(old, old->calls_off, CALL_WORDS, first_call + i);
+    size_t caller = get_word(c), callee_id;
+    struct ProjectIndexName callee;
+    if (caller < first_sym || caller - first_sym >= n_syms)
+      return CDD_C_ERROR_INVALID_ARGUMENT;
+    rc = project_index_name(old, get_word(c + 4), &callee);
+    if (rc == CDD_C_SUCCESS)
+      rc = strings_intern(&b->strings, callee.name, strlen(callee.name),
+                          &callee_id);
+    if (rc == CDD_C_SUCCESS)
+      rc = builder_add_call(b, new_first + (caller - first_sym), callee_id);
+  }
+  return rc;
+}
+
+/**
+ * @brief Adds one file to the builder, from `old` when its content is
+ * unchanged and by parsing it otherwise.
+ */
+static cdd_c_error_t update_file(struct IndexBuilder *b,
+                                 const struct ProjectIndex *old,
+                                 const char *path,
+                                 struct ProjectIndexStats *stats) {
+  struct FsMappedFile file;
+  unsigned long fnv, djb, size;
+  size_t f = old ? find_file(old, path) : (size_t)-1;
+  cdd_c_error_t rc;
+
+  rc = fs_map_file(path, &file);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  size = (unsigned long)file.size;
+  content_hash(file.data, file.size, &fnv, &djb);
+  fs_unmap_file(&file);
+
+  rc = builder_add_file(b, path, size, fnv, djb);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  if (f != (size_t)-1) {
+    const unsigned char *r = record(old, old->files_off, FILE_WORDS, f);
+    if (get_word(r + 4) == size && get_word(r + 8) == fnv &&
+        get_word(r + 12) == djb) {
+      rc = copy_file_facts(b, old, f);
+      /* A damaged entry is simply reparsed */
+      if (rc != CDD_C_ERROR_INVALID_ARGUMENT) {
+        stats->reused++;
+        return rc;
+      }
+      b->n_symbols = b->files[b->n_files - 1].first_symbol;
+      b->n_calls = b->files[b->n_files - 1].first_call;
+      b->files[b->n_files - 1].n_symbols = 0;
+      b->files[b->n_files - 1].n_calls = 0;
+    }
+  }
+
+  {
+    char *content = NULL;
+    size_t len = 0;
+    rc = read_to_file(path, "rb", &content, &len);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    rc = index_source(b, content, len);
+    C_CDD_FREE(content);
+  }
+  stats->parsed++;
+  return rc;
+}
+
+cdd_c_error_t project_index_update(const char *root, const char *index_path,
+                                   struct ProjectIndexStats *stats) {
+  struct ProjectIndexStats local;
+  struct ProjectIndex old;
+  struct IndexBuilder b;
+  struct PathList list = {0};
+  int have_old;
+  unsigned char *img = NULL;
+  size_t img_len = 0, i, kept = 0;
+  cdd_c_error_t rc;
+
+  if (!root || !index_path)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (!stats)
+    stats = &local;
+  memset(stats, 0, sizeof(*stats));
+
+  rc = walk_directory(root, collect_source, &list);
+  if (rc == CDD_C_SUCCESS && list.size > 1)
+    qsort(list.paths, list.size, sizeof(char *), path_cmp);
+  have_old = rc == CDD_C_SUCCESS &&
+             project_index_open(index_path, &old) == CDD_C_SUCCESS;
+  if (rc == CDD_C_SUCCESS)
+    rc = builder_init(&b);
+  else
+    memset(&b, 0, sizeof(b));
+
+  for (i = 0; i < list.size && rc == CDD_C_SUCCESS; ++i) {
+    if (i > 0 && strcmp(list.paths[i - 1], list.paths[i]) == 0)
+      continue;
+    if (have_old && find_file(&old, list.paths[i]) != (size_t)-1)
+      kept++;
+    rc = update_file(&b, have_old ? &old : NULL, list.paths[i], stats);
+  }
+  if (rc == CDD_C_SUCCESS)
+    rc = builder_serialize(&b, &img, &img_len);
+  /* The old image may be the file being replaced: unmap it first */
+  if (have_old) {
+    stats->removed = old.n_files - kept;
+    project_index_close(&old);
+  }
+  if (rc == CDD_C_SUCCESS)
+    rc = write_image(index_path, img, img_len);
+  if (rc == CDD_C_SUCCESS) {
+    stats->files = b.n_files;
+    stats->symbols = b.n_symbols;
+    stats->calls = b.n_calls;
+  }
+
+  C_CDD_FREE(img);
+  builder_free(&b);
+  for (i = 0; i < list.size; ++i)
+    C_CDD_FREE(list.paths[i]);
+  C_CDD_FREE(list.paths);
+  return rc;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file project_index.h
+ * @brief Persistent project-wide index of symbols and call edges.
+ *
+ * Records, for every `.c` and `.h` file under a root, its function
+ * definitions, prototypes and typedefs together with the names each
+ * function calls. The index lives in one flat file made of fixed-width
+ * little-endian records, a string table and an open-addressed name table,
+ * so it is queried straight from its mapping: finding a name is a hash
+ * probe, and its symbols and callers are contiguous runs.
+ *
+ * Updating re-reads only files whose size or content hash changed since
+ * the last run; the facts of the other files are copied over from the
+ * previous image.
+ *
+ * @author Samuel Marks
+ */
+
+#ifndef PROJECT_INDEX_H
+#define PROJECT_INDEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include <stddef.h>
+
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+#include "functions/parse/fs.h"
+/* clang-format on */
+
+/** @brief Bumped whenever the on-disk layout or the indexed facts change. */
+#define PROJECT_INDEX_FORMAT 1
+
+/**
+ * @brief What a symbol record describes.
+ */
+enum ProjectIndexKind {
+  PROJECT_INDEX_FUNCTION,  /**< Function definition (has a body) */
+  PROJECT_INDEX_PROTOTYPE, /**< Function declaration */
+  PROJECT_INDEX_TYPEDEF    /**< Typedef name */
+};
+
+/** @brief Symbol flag: declared `static`. */
+#define PROJECT_INDEX_STATIC 1u
+/** @brief Symbol flag: returns `void` (not `void *`). */
+#define PROJECT_INDEX_RETURNS_VOID 2u
+/** @brief Symbol flag: returns a pointer. */
+#define PROJECT_INDEX_RETURNS_PTR 4u
+/** @brief Symbol flag: returns `cdd_c_error_t`. */
+#define PROJECT_INDEX_RETURNS_ERROR 8u
+/** @brief Symbol flag: the body calls an allocator. */
+#define PROJECT_INDEX_ALLOCATES 16u
+
+/**
+ * @brief An opened index. All strings it hands out point into the mapping
+ * and stay valid until `project_index_close`.
+ */
+struct ProjectIndex {
+  struct FsMappedFile file;  /**< The mapped image */
+  const unsigned char *base; /**< `file.data` */
+  size_t n_files;            /**< Indexed files */
+  size_t n_symbols;          /**< Symbol records */
+  size_t n_calls;            /**< Call edges */
+  size_t n_names;            /**< Distinct names */
+  size_t n_slots;            /**< Name table size, a power of two */
+  size_t files_off;          /**< Offset of the file records */
+  size_t symbols_off;        /**< Offset of the symbol records */
+  size_t calls_off;          /**< Offset of the call records */
+  size_t names_off;          /**< Offset of the name records */
+  size_t slots_off;          /**< Offset of the name table */
+  size_t postings_off;       /**< Offset of the symbol/caller runs */
+  size_t strings_off;        /**< Offset of the string table */
+  size_t strings_len;        /**< Length of the string table */
+};
+
+/**
+ * @brief A name: everything defined, declared or called under it.
+ */
+struct ProjectIndexName {
+  size_t id;         /**< Name id */
+  const char *name;  /**< Spelling */
+  size_t n_symbols;  /**< Definitions, prototypes and typedefs */
+  size_t n_callers;  /**< Functions calling it (each once) */
+  size_t symbols_at; /**< First posting of the symbols */
+  size_t callers_at; /**< First posting of the callers */
+};
+
+/**
+ * @brief One symbol record.
+ */
+struct ProjectIndexSymbol {
+  size_t id;                  /**< Symbol id */
+  size_t name_id;             /**< Id of its name */
+  const char *name;           /**< Spelling */
+  enum ProjectIndexKind kind; /**< What it is */
+  unsigned flags;             /**< PROJECT_INDEX_* flags */
+  size_t file_id;             /**< Id of the file declaring it */
+  const char *file;           /**< Path of that file, as walked */
+  const char *return_type;    /**< Return type text for functions, or "" */
+  size_t line;                /**< 1-based line of the name */
+};
+
+/**
+ * @brief What `project_index_update` did.
+ */
+struct ProjectIndexStats {
+  size_t files;   /**< Files in the new index */
+  size_t parsed;  /**< Files (re)parsed because they are new or changed */
+  size_t reused;  /**< Files copied over unchanged */
+  size_t removed; /**< Files dropped because they no longer exist */
+  size_t symbols; /**< Symbols in the new index */
+  size_t calls;   /**< Call edges in the new index */
+};
+
+/**
+ * @brief Brings the index at `index_path` up to date with the sources under
+ * `root`, creating it if missing.
+ *
+ * A missing, corrupt or other-format index is rebuilt from scratch. The new
+ * image is published by an atomic rename.
+ *
+ * @param[in] root Directory (or single file) to index.
+ * @param[in] index_path Path of the index file.
+ * @param[out] stats Optional; receives what was done.
+ * @return 0 on success, or an error code.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+project_index_update(const char *root, const char *index_path,
+                     struct ProjectIndexStats *stats);
+
+/**
+ * @brief Maps an index for querying. Every offset and count in the header
+ * is bounds-checked.
+ *
+ * @param[in] path Path of the index file.
+ * @param[out] out Receives the opened index.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT for a corrupt or
+ * other-format file, or another error code.
+ */
+extern C_CDD_EXPORT cdd_c_error_t project_index_open(const char *path,
+                                                     struct ProjectIndex *out);
+
+/**
+ * @brief Unmaps an index.
+ * @param[in,out] idx The index; reset to empty.
+ */
+extern C_CDD_EXPORT void project_index_close(struct ProjectIndex *idx);
+
+/**
+ * @brief Looks a name up.
+ *
+ * @param[in] idx The index.
+ * @param[in] name The spelling (need not be NUL-terminated).
+ * @param[in] len Its length.
+ * @param[out] out Receives the name.
+ * @return 0 on success, CDD_C_ERROR_NOT_FOUND if nothing uses the name.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+project_index_find(const struct ProjectIndex *idx, const char *name,
+                   size_t len, struct ProjectIndexName *out);
+
+/**
+ * @brief Reads a name by id.
+ *
+ * @param[in] idx The index.
+ * @param[in] id Name id (`< idx->n_names`).
+ * @param[out] out Receives the name.
+ * @return 0 on success, or CDD_C_ERROR_INVALID_ARGUMENT.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+project_index_name(const struct ProjectIndex *idx, size_t id,
+                   struct ProjectIndexName *out);
+
+/**
+ * @brief Reads a symbol by id.
+ *
+ * @param[in] idx The index.
+ * @param[in] id Symbol id (`< idx->n_symbols`).
+ * @param[out] out Receives the symbol.
+ * @return 0 on success, or CDD_C_ERROR_INVALID_ARGUMENT.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+project_index_symbol(const struct ProjectIndex *idx, size_t id,
+                     struct ProjectIndexSymbol *out);
+
+/**
+ * @brief Reads the i-th symbol named `name`, in file then source order.
+ *
+ * @param[in] idx The index.
+ * @param[in] name The name.
+ * @param[in] i Index below `name->n_symbols`.
+ * @param[out] out Receives the symbol.
+ * @return 0 on success, or CDD_C_ERROR_INVALID_ARGUMENT.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+project_index_symbol_of(const struct ProjectIndex *idx,
+                        const struct ProjectIndexName *name, size_t i,
+                        struct ProjectIndexSymbol *out);
+
+/**
+ * @brief Reads the i-th function definition calling `name`.
+ *
+ * @param[in] idx The index.
+ * @param[in] name The callee's name.
+ * @param[in] i Index below `name->n_callers`.
+ * @param[out] out Receives the calling function.
+ * @return 0 on success, or CDD_C_ERROR_INVALID_ARGUMENT.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+project_index_caller_of(const struct ProjectIndex *idx,
+                        const struct ProjectIndexName *name, size_t i,
+                        struct ProjectIndexSymbol *out);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* PROJECT_INDEX_H */
@@ -821,9 +821,101 @@ void free_token_list(struct TokenList *tl) {
     tl->tokens = NULL;
   }
 
+  if (tl->line_starts)
+    C_CDD_FREE(tl->line_starts);
+
   C_CDD_FREE(tl);
 }
 
+/* --- Line Index --- */
+
+/**
+ * @brief Record the byte offset at which each line of the source starts.
+ *
+ * Failure to allocate is not an error: without the table,
+ * token_list_position falls back to scanning.
+ */
+static void token_list_index_lines(struct TokenList *tl, const uint8_t *base,
+                                   size_t len) {
+  const uint8_t *p;
+  const uint8_t *end;
+  size_t n = 1;
+
+  tl->source = base;
+  tl->source_len = len;
+  if (!base)
+    return;
+  end = base + len;
+
+  for (p = base; p < end; ++p) {
+    p = (const uint8_t *)memchr(p, '\n', (size_t)(end - p));
+    if (!p)
+      break;
+    ++n;
+  }
+
+  tl->line_starts = (size_t *)C_CDD_MALLOC(n * sizeof(size_t));
+  if (!tl->line_starts) {
+    C_CDD_LOG_DEBUG("ENOMEM: line index skipped\n");
+    return;
+  }
+  tl->line_starts[0] = 0;
+  tl->n_lines = 1;
+  for (p = base; p < end; ++p) {
+    p = (const uint8_t *)memchr(p, '\n', (size_t)(end - p));
+    if (!p)
+      break;
+    tl->line_starts[tl->n_lines++] = (size_t)(p + 1 - base);
+  }
+}
+
+/**
+ * @brief Maps a source pointer to its 1-based line and column.
+ */
+cdd_c_error_t token_list_position(const struct TokenList *tl,
+                                  const uint8_t *ptr, size_t *out_line,
+                                  size_t *out_col) {
+  size_t off, lo, hi;
+
+  if (!tl || !ptr || !out_line || !out_col)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out_line = 1;
+  *out_col = 1;
+
+  if (!tl->line_starts) {
+    const uint8_t *p;
+    if (tl->size == 0 || ptr < tl->tokens[0].start)
+      return CDD_C_ERROR_INVALID_ARGUMENT;
+    for (p = tl->tokens[0].start; p < ptr; ++p) {
+      if (*p == '\n') {
+        ++*out_line;
+        *out_col = 1;
+      } else {
+        ++*out_col;
+      }
+    }
+    return CDD_C_SUCCESS;
+  }
+
+  if (ptr < tl->source || ptr > tl->source + tl->source_len)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  off = (size_t)(ptr - tl->source);
+
+  /* Last line starting at or before `off` */
+  lo = 0;
+  hi = tl->n_lines;
+  while (hi - lo > 1) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (tl->line_starts[mid] <= off)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  *out_line = lo + 1;
+  *out_col = off - tl->line_starts[lo] + 1;
+  return CDD_C_SUCCESS;
+}
+
 /**
  * @brief Executes the token matches string operation.
  */
@@ -1645,6 +1737,8 @@ cdd_c_error_t tokenize(const az_span source, struct TokenList **const out) {
     }
   }
 
+  token_list_index_lines(list, base, len);
+
   *out = list;
 
   return CDD_C_SUCCESS;
@@ -305,6 +305,14 @@ struct TokenList {
   size_t size; /**< Number of valid tokens used */
 
   size_t capacity; /**< Allocated capacity of the array */
+
+  const uint8_t *source; /**< Buffer the tokens were read from */
+
+  size_t source_len; /**< Length of `source` in bytes */
+
+  size_t *line_starts; /**< Byte offset of each line in `source`, or NULL */
+
+  size_t n_lines; /**< Number of entries in `line_starts` */
 };
 
 /**
@@ -340,6 +348,24 @@ extern C_CDD_EXPORT /**
     void
     free_token_list(struct TokenList *tl);
 
+/**
+ * @brief Map a pointer into the tokenized source to a line and column.
+ *
+ * `tokenize` records the start of every line once per buffer, so this is a
+ * binary search. Lists assembled by hand carry no such table; for those the
+ * text is scanned from the first token instead.
+ *
+ * @param[in] tl The token list.
+ * @param[in] ptr Pointer into the buffer `tl` was tokenized from.
+ * @param[out] out_line 1-based line number.
+ * @param[out] out_col 1-based column number, in bytes.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT if `ptr` lies outside
+ * the buffer or an argument is NULL.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+token_list_position(const struct TokenList *tl, const uint8_t *ptr,
+                    size_t *out_line, size_t *out_col);
+
 /**
  * @param[out] _out_val Pointer to store the result
  * @brief Check if a token's content matches a C string exactly.
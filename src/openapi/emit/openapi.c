@@ -35,11 +35,6 @@ static cdd_c_error_t license_fields_invalid(const struct OpenAPI_License *lic);
  * @brief Executes the server url has query or fragment operation.
  */
 static cdd_c_error_t server_url_has_query_or_fragment(const char *url);
-/**
- * @brief Executes the clone json value operation.
- */
-static cdd_c_error_t clone_json_value(const JSON_Value *val,
-                                      JSON_Value **_out_val);
 cdd_c_error_t merge_schema_extras_object_openapi(JSON_Object *target,
                                                  const char *extras_json);
 /**
@@ -619,32 +614,6 @@ static cdd_c_error_t server_url_has_query_or_fragment(const char *url) {
   return strchr(url, '?') != NULL || strchr(url, '#') != NULL;
 }
 
-/**
- * @brief Executes the clone json value operation.
- */
-static cdd_c_error_t clone_json_value(const JSON_Value *val,
-                                      JSON_Value **_out_val) {
-  char *serialized;
-  JSON_Value *copy;
-
-  if (!val) {
-    *_out_val = NULL;
-    return CDD_C_SUCCESS;
-  }
-
-  serialized = json_serialize_to_string((JSON_Value *)val);
-  if (!serialized) {
-    *_out_val = NULL;
-    return CDD_C_SUCCESS;
-  }
-  copy = json_parse_string(serialized);
-  json_free_serialized_string(serialized);
-  {
-    *_out_val = copy;
-    return CDD_C_SUCCESS;
-  }
-}
-
 /**
  * @brief Merges extra schema object properties.
  *
@@ -679,7 +648,7 @@ cdd_c_error_t merge_schema_extras_object_openapi(JSON_Object *target,
     if (!key || json_object_has_value(target, key))
       continue;
     val = json_object_get_value(extras_obj, key);
-    copy = (clone_json_value(val, &_ast_clone_json_value_0),
+    copy = (json_value_clone(val, &_ast_clone_json_value_0),
             _ast_clone_json_value_0);
     if (!copy) {
       json_value_free(extras_val);
@@ -3527,6 +3496,97 @@ write_component_request_bodies(JSON_Object *components,
   return CDD_C_SUCCESS;
 }
 
+/**
+ * @brief Writes `components.schemas` as one object.
+ */
+static cdd_c_error_t write_component_schemas(JSON_Object *components,
+                                             const struct OpenAPI_Spec *spec) {
+  JSON_Value *schemas_val;
+  JSON_Object *schemas_obj;
+  size_t i;
+  int rc;
+
+  if (spec->n_defined_schemas == 0 && spec->n_raw_schemas == 0)
+    return CDD_C_SUCCESS;
+
+  schemas_val = json_value_init_object();
+  if (!schemas_val) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+  schemas_obj = json_value_get_object(schemas_val);
+
+  for (i = 0; i < spec->n_defined_schemas; ++i) {
+    if (spec->defined_schema_names[i]) {
+      rc = write_struct_to_json_schema(schemas_obj,
+                                       spec->defined_schema_names[i],
+                                       &spec->defined_schemas[i]);
+      if (rc != 0) {
+        json_value_free(schemas_val);
+        return rc;
+      }
+    }
+  }
+
+  for (i = 0; i < spec->n_raw_schemas; ++i) {
+    JSON_Value *raw_val = NULL;
+    if (!spec->raw_schema_names[i] || !spec->raw_schemas[i])
+      continue;
+    rc = json_fragment_copy_value(spec->raw_schemas[i], &raw_val);
+    if (rc != 0) {
+      json_value_free(schemas_val);
+      return rc;
+    }
+    json_object_set_value(schemas_obj, spec->raw_schema_names[i], raw_val);
+  }
+  json_object_set_value(components, "schemas", schemas_val);
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Generates C code for write component security schemes.
+ */
+static cdd_c_error_t
+write_component_security_schemes(JSON_Object *components,
+                                 const struct OpenAPI_Spec *spec) {
+  if (spec->n_security_schemes == 0)
+    return CDD_C_SUCCESS;
+  return write_security_schemes(components, spec);
+}
+
+/**
+ * @brief Writer for one part of a document into a parent object.
+ */
+typedef cdd_c_error_t (*spec_section_writer)(JSON_Object *parent,
+                                             const struct OpenAPI_Spec *spec);
+
+/**
+ * @brief Entries of `components`, in output order (after extensions).
+ */
+static const spec_section_writer component_writers[] = {
+    write_component_schemas,        write_component_security_schemes,
+    write_component_parameters,     write_component_responses,
+    write_component_headers,        write_component_request_bodies,
+    write_component_media_types,    write_component_examples,
+    write_component_links,          write_component_callbacks,
+    write_component_path_items};
+
+/**
+ * @brief Checks whether the spec has anything to put in `components`.
+ */
+static int components_empty(const struct OpenAPI_Spec *spec) {
+  return spec->n_defined_schemas == 0 && spec->n_raw_schemas == 0 &&
+         spec->n_security_schemes == 0 && spec->n_component_parameters == 0 &&
+         spec->n_component_responses == 0 &&
+         spec->n_component_headers == 0 &&
+         spec->n_component_request_bodies == 0 &&
+         spec->n_component_media_types == 0 &&
+         spec->n_component_examples == 0 && spec->n_component_links == 0 &&
+         spec->n_component_callbacks == 0 &&
+         spec->n_component_path_items == 0 &&
+         !spec->components_extensions_json;
+}
+
 /**
  * @brief Generates C code for write components.
  */
@@ -3534,18 +3594,12 @@ static cdd_c_error_t write_components(JSON_Object *root_obj,
                                       const struct OpenAPI_Spec *spec) {
   JSON_Value *comps_val;
   JSON_Object *comps_obj;
+  size_t i;
   int rc;
 
   /* Only create components block if there is something to write */
-  if (spec->n_defined_schemas == 0 && spec->n_raw_schemas == 0 &&
-      spec->n_security_schemes == 0 && spec->n_component_parameters == 0 &&
-      spec->n_component_responses == 0 && spec->n_component_headers == 0 &&
-      spec->n_component_request_bodies == 0 &&
-      spec->n_component_media_types == 0 && spec->n_component_examples == 0 &&
-      spec->n_component_links == 0 && spec->n_component_callbacks == 0 &&
-      spec->n_component_path_items == 0 && !spec->components_extensions_json) {
+  if (components_empty(spec))
     return CDD_C_SUCCESS;
-  }
 
   comps_val = json_value_init_object();
   if (!comps_val) {
@@ -3558,114 +3612,82 @@ static cdd_c_error_t write_components(JSON_Object *root_obj,
     merge_schema_extras_object_openapi(comps_obj,
                                        spec->components_extensions_json);
 
-  /* Schemas */
-  if (spec->n_defined_schemas > 0 || spec->n_raw_schemas > 0) {
-    JSON_Value *schemas_val = json_value_init_object();
-    JSON_Object *schemas_obj = json_value_get_object(schemas_val);
-    size_t i;
-
-    for (i = 0; i < spec->n_defined_schemas; ++i) {
-      if (spec->defined_schema_names[i]) {
-        rc = write_struct_to_json_schema(schemas_obj,
-                                         spec->defined_schema_names[i],
-                                         &spec->defined_schemas[i]);
-        if (rc != 0) {
-          json_value_free(comps_val);
-          json_value_free(schemas_val);
-          return rc;
-        }
-      }
-    }
-
-    for (i = 0; i < spec->n_raw_schemas; ++i) {
-      JSON_Value *raw_val;
-      if (!spec->raw_schema_names[i] || !spec->raw_schema_json[i])
-        continue;
-      raw_val = json_parse_string(spec->raw_schema_json[i]);
-      if (!raw_val) {
-        printf("FAILED parsing %s\n", spec->raw_schema_json[i]);
-        json_value_free(comps_val);
-        json_value_free(schemas_val);
-        return CDD_C_ERROR_INVALID_ARGUMENT;
-      }
-      json_object_set_value(schemas_obj, spec->raw_schema_names[i], raw_val);
-    }
-    json_object_set_value(comps_obj, "schemas", schemas_val);
-  }
-
-  /* Security Schemes */
-  if (spec->n_security_schemes > 0) {
-    rc = write_security_schemes(comps_obj, spec);
+  for (i = 0; i < sizeof(component_writers) / sizeof(component_writers[0]);
+       ++i) {
+    rc = component_writers[i](comps_obj, spec);
     if (rc != 0) {
       json_value_free(comps_val);
       return rc;
     }
   }
 
-  /* Parameters */
-  rc = write_component_parameters(comps_obj, spec);
-  if (rc != 0) {
-    json_value_free(comps_val);
-    return rc;
-  }
-
-  /* Responses */
-  rc = write_component_responses(comps_obj, spec);
-  if (rc != 0) {
-    json_value_free(comps_val);
-    return rc;
-  }
+  json_object_set_value(root_obj, "components", comps_val);
+  return CDD_C_SUCCESS;
+}
 
-  /* Headers */
-  rc = write_component_headers(comps_obj, spec);
-  if (rc != 0) {
-    json_value_free(comps_val);
-    return rc;
-  }
+/**
+ * @brief Writes the members that precede `components`: version, `$self`,
+ * dialect, extensions, info, externalDocs, tags, security and servers.
+ */
+static cdd_c_error_t write_spec_head(JSON_Object *root_obj,
+                                     const struct OpenAPI_Spec *spec) {
+  int rc;
 
-  /* Request Bodies */
-  rc = write_component_request_bodies(comps_obj, spec);
-  if (rc != 0) {
-    json_value_free(comps_val);
+  json_object_set_string(root_obj, "openapi",
+                         spec->openapi_version ? spec->openapi_version
+                                               : "3.2.0");
+  if (spec->self_uri)
+    json_object_set_string(root_obj, "$self", spec->self_uri);
+  if (spec->json_schema_dialect)
+    json_object_set_string(root_obj, "jsonSchemaDialect",
+                           spec->json_schema_dialect);
+  if (spec->extensions_json)
+    merge_schema_extras_object_openapi(root_obj, spec->extensions_json);
+  write_info(root_obj, spec);
+  if (spec->external_docs.url)
+    write_external_docs(root_obj, "externalDocs", &spec->external_docs);
+  rc = write_tags(root_obj, spec);
+  if (rc != 0)
     return rc;
-  }
 
-  /* Media Types */
-  rc = write_component_media_types(comps_obj, spec);
-  if (rc != 0) {
-    json_value_free(comps_val);
+  rc = write_security_requirements(root_obj, "security", spec->security,
+                                   spec->n_security, spec->security_set);
+  if (rc != 0)
     return rc;
-  }
 
-  /* Examples */
-  rc = write_component_examples(comps_obj, spec);
-  if (rc != 0) {
-    json_value_free(comps_val);
-    return rc;
-  }
+  return write_servers(root_obj, spec);
+}
 
-  /* Links */
-  rc = write_component_links(comps_obj, spec);
-  if (rc != 0) {
-    json_value_free(comps_val);
-    return rc;
-  }
+/**
+ * @brief Builds the whole document as a parson tree.
+ */
+static cdd_c_error_t build_spec_document(const struct OpenAPI_Spec *spec,
+                                         JSON_Value **out) {
+  JSON_Value *root_val;
+  JSON_Object *root_obj;
+  int rc;
 
-  /* Callbacks */
-  rc = write_component_callbacks(comps_obj, spec);
-  if (rc != 0) {
-    json_value_free(comps_val);
-    return rc;
+  *out = NULL;
+  root_val = json_value_init_object();
+  if (!root_val) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
   }
+  root_obj = json_value_get_object(root_val);
 
-  /* Path Items */
-  rc = write_component_path_items(comps_obj, spec);
+  rc = write_spec_head(root_obj, spec);
+  if (rc == 0)
+    rc = write_components(root_obj, spec);
+  if (rc == 0)
+    rc = write_webhooks(root_obj, spec);
+  if (rc == 0)
+    rc = write_paths(root_obj, spec);
   if (rc != 0) {
-    json_value_free(comps_val);
+    json_value_free(root_val);
     return rc;
   }
 
-  json_object_set_value(root_obj, "components", comps_val);
+  *out = root_val;
   return CDD_C_SUCCESS;
 }
 
@@ -3676,7 +3698,6 @@ cdd_c_error_t openapi_write_spec_to_json(const struct OpenAPI_Spec *spec,
                                          char **json_out) {
   char *_ast_strdup_4 = NULL;
   JSON_Value *root_val;
-  JSON_Object *root_obj;
   int rc;
 
   if (!spec || !json_out) {
@@ -3693,70 +3714,315 @@ cdd_c_error_t openapi_write_spec_to_json(const struct OpenAPI_Spec *spec,
   if (license_fields_invalid(&spec->info.license))
     return CDD_C_ERROR_INVALID_ARGUMENT;
 
-  root_val = json_value_init_object();
-  if (!root_val) {
+  rc = build_spec_document(spec, &root_val);
+  if (rc != 0)
+    return rc;
+
+  *json_out = json_serialize_to_string_pretty(root_val);
+  json_value_free(root_val);
+
+  return *json_out ? 0 : ENOMEM;
+}
+
+/**
+ * @brief Streams the members a section writer produces, then frees them.
+ */
+static cdd_c_error_t stream_section(struct SpecWriter *w,
+                                    const struct OpenAPI_Spec *spec,
+                                    spec_section_writer write) {
+  JSON_Value *scratch = json_value_init_object();
+  int rc;
+
+  if (!scratch) {
     C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
     return CDD_C_ERROR_MEMORY;
   }
-  root_obj = json_value_get_object(root_val);
+  rc = write(json_value_get_object(scratch), spec);
+  if (rc == 0)
+    rc = spec_writer_members(w, json_value_get_object(scratch));
+  json_value_free(scratch);
+  return rc;
+}
 
-  json_object_set_string(root_obj, "openapi",
-                         spec->openapi_version ? spec->openapi_version
-                                               : "3.2.0");
-  if (spec->self_uri)
-    json_object_set_string(root_obj, "$self", spec->self_uri);
-  if (spec->json_schema_dialect)
-    json_object_set_string(root_obj, "jsonSchemaDialect",
-                           spec->json_schema_dialect);
-  if (spec->extensions_json)
-    merge_schema_extras_object_openapi(root_obj, spec->extensions_json);
-  write_info(root_obj, spec);
-  if (spec->external_docs.url)
-    write_external_docs(root_obj, "externalDocs", &spec->external_docs);
-  rc = write_tags(root_obj, spec);
-  if (rc != 0) {
-    json_value_free(root_val);
-    return rc;
+/**
+ * @brief Parses extensions into a new object.
+ *
+ * Returns NULL in `*out` if any key is not `x-` prefixed: such a key could
+ * collide with a member written later, which the tree builder resolves in
+ * place, so the caller must build that section whole to keep the output
+ * identical.
+ */
+static cdd_c_error_t stream_extensions(const char *extensions_json,
+                                       JSON_Value **out) {
+  JSON_Value *ext_val = json_value_init_object();
+  JSON_Object *ext_obj;
+  size_t i;
+
+  *out = NULL;
+  if (!ext_val) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+  ext_obj = json_value_get_object(ext_val);
+  if (extensions_json)
+    merge_schema_extras_object_openapi(ext_obj, extensions_json);
+  for (i = 0; i < json_object_get_count(ext_obj); ++i) {
+    if (strncmp(json_object_get_name(ext_obj, i), "x-", 2) != 0) {
+      json_value_free(ext_val);
+      return CDD_C_SUCCESS;
+    }
   }
+  *out = ext_val;
+  return CDD_C_SUCCESS;
+}
 
-  rc = write_security_requirements(root_obj, "security", spec->security,
-                                   spec->n_security, spec->security_set);
-  if (rc != 0) {
-    json_value_free(root_val);
+/**
+ * @brief Streams `components.schemas` one schema at a time.
+ *
+ * A raw schema named like a defined one replaces it in place in the tree
+ * builder; such specs take the whole-object path to keep output identical.
+ */
+static cdd_c_error_t stream_component_schemas(struct SpecWriter *w,
+                                              const struct OpenAPI_Spec *spec) {
+  JSON_Value *names_val;
+  JSON_Object *names;
+  JSON_Value *scratch;
+  size_t i;
+  int collide = 0;
+  int rc = 0;
+
+  if (spec->n_defined_schemas == 0 && spec->n_raw_schemas == 0)
+    return CDD_C_SUCCESS;
+
+  names_val = json_value_init_object();
+  if (!names_val) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+  names = json_value_get_object(names_val);
+  for (i = 0; rc == 0 && !collide && i < spec->n_defined_schemas; ++i) {
+    const char *name = spec->defined_schema_names[i];
+    if (!name)
+      continue;
+    if (json_object_has_value(names, name))
+      collide = 1;
+    else if (json_object_set_null(names, name) != JSONSuccess)
+      rc = CDD_C_ERROR_MEMORY;
+  }
+  for (i = 0; rc == 0 && !collide && i < spec->n_raw_schemas; ++i) {
+    const char *name = spec->raw_schema_names[i];
+    if (!name || !spec->raw_schemas[i])
+      continue;
+    if (json_object_has_value(names, name))
+      collide = 1;
+    else if (json_object_set_null(names, name) != JSONSuccess)
+      rc = CDD_C_ERROR_MEMORY;
+  }
+  json_value_free(names_val);
+  if (rc != 0)
     return rc;
+  if (collide)
+    return stream_section(w, spec, write_component_schemas);
+
+  rc = spec_writer_key(w, "schemas");
+  if (rc == 0)
+    rc = spec_writer_begin_object(w);
+  for (i = 0; rc == 0 && i < spec->n_defined_schemas; ++i) {
+    if (!spec->defined_schema_names[i])
+      continue;
+    scratch = json_value_init_object();
+    if (!scratch) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      return CDD_C_ERROR_MEMORY;
+    }
+    rc = write_struct_to_json_schema(json_value_get_object(scratch),
+                                     spec->defined_schema_names[i],
+                                     &spec->defined_schemas[i]);
+    if (rc == 0)
+      rc = spec_writer_members(w, json_value_get_object(scratch));
+    json_value_free(scratch);
+  }
+  for (i = 0; rc == 0 && i < spec->n_raw_schemas; ++i) {
+    if (!spec->raw_schema_names[i] || !spec->raw_schemas[i])
+      continue;
+    /* Fragments are immutable: written straight from the shared parse */
+    rc = spec_writer_key(w, spec->raw_schema_names[i]);
+    if (rc == 0)
+      rc = spec_writer_value(w, json_fragment_value(spec->raw_schemas[i]));
   }
+  if (rc == 0)
+    rc = spec_writer_end_object(w);
+  return rc;
+}
 
-  rc = write_servers(root_obj, spec);
-  if (rc != 0) {
-    json_value_free(root_val);
+/**
+ * @brief Streams `components` one entry (schemas, parameters, ...) at a time.
+ */
+static cdd_c_error_t stream_components(struct SpecWriter *w,
+                                       const struct OpenAPI_Spec *spec) {
+  JSON_Value *ext_val;
+  size_t i;
+  int rc;
+
+  if (components_empty(spec))
+    return CDD_C_SUCCESS;
+  rc = stream_extensions(spec->components_extensions_json, &ext_val);
+  if (rc != 0)
     return rc;
+  if (!ext_val)
+    return stream_section(w, spec, write_components);
+
+  rc = spec_writer_key(w, "components");
+  if (rc == 0)
+    rc = spec_writer_begin_object(w);
+  if (rc == 0)
+    rc = spec_writer_members(w, json_value_get_object(ext_val));
+  json_value_free(ext_val);
+  for (i = 0;
+       rc == 0 && i < sizeof(component_writers) / sizeof(component_writers[0]);
+       ++i) {
+    if (component_writers[i] == write_component_schemas)
+      rc = stream_component_schemas(w, spec);
+    else
+      rc = stream_section(w, spec, component_writers[i]);
   }
+  if (rc == 0)
+    rc = spec_writer_end_object(w);
+  return rc;
+}
 
-  rc = write_components(root_obj, spec);
-  if (rc != 0) {
-    json_value_free(root_val);
+/**
+ * @brief Streams `paths` one path item at a time.
+ *
+ * Operations sharing a route are merged into the item at the route's first
+ * occurrence, as write_paths does.
+ */
+static cdd_c_error_t stream_paths(struct SpecWriter *w,
+                                  const struct OpenAPI_Spec *spec) {
+  JSON_Value *ext_val;
+  size_t i, j;
+  int rc;
+
+  rc = stream_extensions(spec->paths_extensions_json, &ext_val);
+  if (rc != 0)
+    return rc;
+  if (!ext_val)
+    return stream_section(w, spec, write_paths);
+
+  rc = spec_writer_key(w, "paths");
+  if (rc == 0)
+    rc = spec_writer_begin_object(w);
+  if (rc == 0)
+    rc = spec_writer_members(w, json_value_get_object(ext_val));
+  json_value_free(ext_val);
+
+  for (i = 0; rc == 0 && i < spec->n_paths; ++i) {
+    const char *route = spec->paths[i].route ? spec->paths[i].route : "/";
+    JSON_Value *item_val;
+
+    for (j = 0; j < i; ++j) {
+      if (strcmp(route, spec->paths[j].route ? spec->paths[j].route : "/") ==
+          0)
+        break;
+    }
+    if (j < i)
+      continue; /* Already written with its first occurrence */
+
+    item_val = json_value_init_object();
+    if (!item_val) {
+      C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+      return CDD_C_ERROR_MEMORY;
+    }
+    for (j = i; rc == 0 && j < spec->n_paths; ++j) {
+      if (strcmp(route, spec->paths[j].route ? spec->paths[j].route : "/") ==
+          0)
+        rc = write_path_item_object(json_value_get_object(item_val),
+                                    &spec->paths[j]);
+    }
+    if (rc == 0)
+      rc = spec_writer_key(w, route);
+    if (rc == 0)
+      rc = spec_writer_value(w, item_val);
+    json_value_free(item_val);
+  }
+  if (rc == 0)
+    rc = spec_writer_end_object(w);
+  return rc;
+}
+
+/**
+ * @brief Executes the openapi write spec to stream operation.
+ */
+cdd_c_error_t openapi_write_spec_to_stream(const struct OpenAPI_Spec *spec,
+                                           FILE *fp, enum SpecFormat format) {
+  struct SpecWriter w;
+  JSON_Value *head_val = NULL;
+  JSON_Object *head_obj;
+  int rc;
+
+  if (!spec || !fp)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  rc = spec_writer_init(&w, fp, format);
+  if (rc != 0)
+    return rc;
+
+  if (spec->is_schema_document) {
+    JSON_Value *doc;
+    if (!spec->schema_root_json)
+      return CDD_C_ERROR_INVALID_ARGUMENT;
+    if (w.format == SPEC_FORMAT_JSON) {
+      fputs(spec->schema_root_json, fp);
+      return fflush(fp) != 0 || ferror(fp) ? CDD_C_ERROR_IO : CDD_C_SUCCESS;
+    }
+    doc = json_parse_string(spec->schema_root_json);
+    if (!doc)
+      return CDD_C_ERROR_PARSE;
+    rc = spec_write_value(fp, format, doc);
+    json_value_free(doc);
     return rc;
   }
+  if (license_fields_invalid(&spec->info.license))
+    return CDD_C_ERROR_INVALID_ARGUMENT;
 
-  rc = write_webhooks(root_obj, spec);
+  head_val = json_value_init_object();
+  if (!head_val) {
+    C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
+    return CDD_C_ERROR_MEMORY;
+  }
+  head_obj = json_value_get_object(head_val);
+  rc = write_spec_head(head_obj, spec);
   if (rc != 0) {
-    json_value_free(root_val);
+    json_value_free(head_val);
     return rc;
   }
 
-  if (spec->n_paths > 0 || spec->paths_extensions_json) {
-    rc = write_paths(root_obj, spec);
-    if (rc != 0) {
-      json_value_free(root_val);
+  /* An extension named like a later section is replaced in place by the
+   * tree builder; fall back to it rather than emit a duplicate key. */
+  if (json_object_has_value(head_obj, "components") ||
+      json_object_has_value(head_obj, "webhooks") ||
+      json_object_has_value(head_obj, "paths")) {
+    json_value_free(head_val);
+    rc = build_spec_document(spec, &head_val);
+    if (rc != 0)
       return rc;
-    }
-  } else {
-    JSON_Value *empty = json_value_init_object();
-    json_object_set_value(root_obj, "paths", empty);
+    rc = spec_write_value(fp, format, head_val);
+    json_value_free(head_val);
+    return rc;
   }
 
-  *json_out = json_serialize_to_string_pretty(root_val);
-  json_value_free(root_val);
-
-  return *json_out ? 0 : ENOMEM;
+  rc = spec_writer_begin_object(&w);
+  if (rc == 0)
+    rc = spec_writer_members(&w, head_obj);
+  json_value_free(head_val);
+  if (rc == 0)
+    rc = stream_components(&w, spec);
+  if (rc == 0)
+    rc = stream_section(&w, spec, write_webhooks);
+  if (rc == 0)
+    rc = stream_paths(&w, spec);
+  if (rc == 0)
+    rc = spec_writer_end_object(&w);
+  if (rc == 0)
+    rc = spec_writer_finish(&w);
+  return rc;
 }
@@ -3,7 +3,8 @@
  * @brief Writer module for OpenAPI v3.2 definitions.
  *
  * Provides functionality to serialize an in-memory `OpenAPI_Spec` structure
- * into a JSON string. This acts as the inverse of `openapi_loader`.
+ * into a JSON string, or to stream it as JSON or YAML to a file. This acts as
+ * the inverse of `openapi_loader`.
  *
  * @author Samuel Marks
  */
@@ -16,8 +17,11 @@ extern "C" {
 #endif /* __cplusplus */
 
 /* clang-format off */
+#include <stdio.h>
+
 #include "c_cdd_export.h"
 #include "cdd_c_error.h"
+#include "openapi/emit/spec_writer.h"
 #include "openapi/parse/openapi.h"
 #include "parson.h"
 /* clang-format on */
@@ -39,6 +43,24 @@ extern "C" {
 extern C_CDD_EXPORT cdd_c_error_t
 openapi_write_spec_to_json(const struct OpenAPI_Spec *spec, char **json_out);
 
+/**
+ * @brief Stream an OpenAPI Spec structure to a file.
+ *
+ * Produces the same document as `openapi_write_spec_to_json` without holding
+ * it in memory: each top-level section, each `components` entry and each
+ * path item is built, written and freed in turn. JSON output is
+ * byte-identical to the string form.
+ *
+ * @param[in] spec The specification structure to serialize.
+ * @param[in] fp Output sink; not closed.
+ * @param[in] format SPEC_FORMAT_JSON (or AUTO) or SPEC_FORMAT_YAML.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT if inputs are invalid,
+ * CDD_C_ERROR_IO if the sink fails, other error codes on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+openapi_write_spec_to_stream(const struct OpenAPI_Spec *spec, FILE *fp,
+                             enum SpecFormat format);
+
 /**
  * @brief Converts verb to string.
  *
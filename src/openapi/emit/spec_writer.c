@@ -0,0 +1,477 @@
+/**
+ * @file spec_writer.c
+ * @brief Implementation of the streaming JSON and YAML writer.
+ *
+ * @author Samuel Marks
+ */
+
+/* clang-format off */
+#include <stdio.h>
+#include <string.h>
+
+#include <parson.h>
+
+#include "openapi/emit/spec_writer.h"
+/* clang-format on */
+
+/**
+ * @brief Writes `n` spaces.
+ */
+static void sw_indent(FILE *fp, size_t n) {
+  static const char spaces[] = "                                ";
+  while (n > 0) {
+    size_t chunk = n < sizeof(spaces) - 1 ? n : sizeof(spaces) - 1;
+    fwrite(spaces, 1, chunk, fp);
+    n -= chunk;
+  }
+}
+
+/**
+ * @brief Writes a number the way parson serializes it.
+ */
+static void sw_number(FILE *fp, double num) {
+  char buf[64];
+  sprintf(buf, "%1.17g", num);
+  fputs(buf, fp);
+}
+
+/**
+ * @brief Writes a number as a YAML float or integer.
+ *
+ * YAML 1.1 readers need a `.` in exponent forms, so `1e+20` becomes
+ * `1.0e+20`; the value is unchanged.
+ */
+static void sw_yaml_number(FILE *fp, double num) {
+  char buf[64];
+  char *e;
+  sprintf(buf, "%1.17g", num);
+  e = strchr(buf, 'e');
+  if (e && !strchr(buf, '.')) {
+    fwrite(buf, 1, (size_t)(e - buf), fp);
+    fputs(".0", fp);
+    fputs(e, fp);
+  } else {
+    fputs(buf, fp);
+  }
+}
+
+/**
+ * @brief Writes a double-quoted string.
+ *
+ * With `json` set this matches parson (`\/`, raw DEL); otherwise it is a
+ * YAML double-quoted scalar.
+ */
+static void sw_quoted(FILE *fp, const char *s, size_t len, int json) {
+  static const char hex[] = "0123456789abcdef";
+  size_t i, run = 0;
+
+  fputc('"', fp);
+  for (i = 0; i < len; ++i) {
+    unsigned char c = (unsigned char)s[i];
+    const char *esc = NULL;
+    char uni[7];
+
+    switch (c) {
+    case '"':
+      esc = "\\\"";
+      break;
+    case '\\':
+      esc = "\\\\";
+      break;
+    case '/':
+      esc = json ? "\\/" : NULL;
+      break;
+    case '\b':
+      esc = "\\b";
+      break;
+    case '\f':
+      esc = "\\f";
+      break;
+    case '\n':
+      esc = "\\n";
+      break;
+    case '\r':
+      esc = "\\r";
+      break;
+    case '\t':
+      esc = "\\t";
+      break;
+    default:
+      if (c < 0x20 || (c == 0x7f && !json)) {
+        uni[0] = '\\';
+        uni[1] = 'u';
+        uni[2] = '0';
+        uni[3] = '0';
+        uni[4] = hex[c >> 4];
+        uni[5] = hex[c & 0xf];
+        uni[6] = '\0';
+        esc = uni;
+      }
+      break;
+    }
+    if (!esc)
+      continue;
+    if (i > run)
+      fwrite(s + run, 1, i - run, fp);
+    fputs(esc, fp);
+    run = i + 1;
+  }
+  if (len > run)
+    fwrite(s + run, 1, len - run, fp);
+  fputc('"', fp);
+}
+
+/**
+ * @brief Writes a value in parson's pretty JSON form at an indent level.
+ */
+static void json_write_value(FILE *fp, const JSON_Value *val, size_t level) {
+  size_t i, n;
+
+  switch (json_value_get_type(val)) {
+  case JSONObject: {
+    const JSON_Object *obj = json_value_get_object(val);
+    n = json_object_get_count(obj);
+    if (n == 0) {
+      fputs("{}", fp);
+      break;
+    }
+    fputs("{\n", fp);
+    for (i = 0; i < n; ++i) {
+      const char *key = json_object_get_name(obj, i);
+      sw_indent(fp, (level + 1) * 4);
+      sw_quoted(fp, key, strlen(key), 1);
+      fputs(": ", fp);
+      json_write_value(fp, json_object_get_value_at(obj, i), level + 1);
+      fputs(i + 1 < n ? ",\n" : "\n", fp);
+    }
+    sw_indent(fp, level * 4);
+    fputc('}', fp);
+    break;
+  }
+  case JSONArray: {
+    const JSON_Array *arr = json_value_get_array(val);
+    n = json_array_get_count(arr);
+    if (n == 0) {
+      fputs("[]", fp);
+      break;
+    }
+    fputs("[\n", fp);
+    for (i = 0; i < n; ++i) {
+      sw_indent(fp, (level + 1) * 4);
+      json_write_value(fp, json_array_get_value(arr, i), level + 1);
+      fputs(i + 1 < n ? ",\n" : "\n", fp);
+    }
+    sw_indent(fp, level * 4);
+    fputc(']', fp);
+    break;
+  }
+  case JSONString:
+    sw_quoted(fp, json_value_get_string(val), json_value_get_string_len(val),
+              1);
+    break;
+  case JSONNumber:
+    sw_number(fp, json_value_get_number(val));
+    break;
+  case JSONBoolean:
+    fputs(json_value_get_boolean(val) ? "true" : "false", fp);
+    break;
+  default:
+    fputs("null", fp);
+    break;
+  }
+}
+
+/**
+ * @brief Checks whether a string may be written as a YAML plain scalar.
+ *
+ * Conservative: anything that could resolve to a non-string, start an
+ * indicator, or span lines is quoted instead.
+ */
+static int yaml_plain_ok(const char *s, size_t len) {
+  static const char *const reserved[] = {"true", "false", "null", "yes", "no",
+                                         "on",   "off",   "y",    "n"};
+  size_t i;
+
+  if (len == 0 || strchr("-?:,[]{}#&*!|>'\"%@`~. +<=", s[0]) ||
+      (s[0] >= '0' && s[0] <= '9') || s[len - 1] == ' ' || s[len - 1] == ':')
+    return 0;
+  for (i = 0; i < len; ++i) {
+    unsigned char c = (unsigned char)s[i];
+    if (c < 0x20 || c >= 0x7f || strchr(",[]{}", c))
+      return 0;
+    if (c == ':' && s[i + 1] == ' ')
+      return 0;
+    if (c == '#' && s[i - 1] == ' ')
+      return 0;
+  }
+  for (i = 0; i < sizeof(reserved) / sizeof(reserved[0]); ++i) {
+    const char *r = reserved[i];
+    size_t j;
+    if (strlen(r) != len)
+      continue;
+    for (j = 0; j < len; ++j) {
+      char c = s[j];
+      if (c >= 'A' && c <= 'Z')
+        c = (char)(c - 'A' + 'a');
+      if (c != r[j])
+        break;
+    }
+    if (j == len)
+      return 0;
+  }
+  return 1;
+}
+
+/**
+ * @brief Writes a string as a YAML scalar.
+ */
+static void yaml_string(FILE *fp, const char *s, size_t len) {
+  if (yaml_plain_ok(s, len))
+    fwrite(s, 1, len, fp);
+  else
+    sw_quoted(fp, s, len, 0);
+}
+
+/**
+ * @brief Checks whether a value is a non-empty collection (block style).
+ */
+static int yaml_is_block(const JSON_Value *val) {
+  switch (json_value_get_type(val)) {
+  case JSONObject:
+    return json_object_get_count(json_value_get_object(val)) > 0;
+  case JSONArray:
+    return json_array_get_count(json_value_get_array(val)) > 0;
+  default:
+    return 0;
+  }
+}
+
+/**
+ * @brief Writes a scalar or empty collection as a YAML flow node.
+ */
+static void yaml_flow(FILE *fp, const JSON_Value *val) {
+  switch (json_value_get_type(val)) {
+  case JSONObject:
+    fputs("{}", fp);
+    break;
+  case JSONArray:
+    fputs("[]", fp);
+    break;
+  case JSONString:
+    yaml_string(fp, json_value_get_string(val),
+                json_value_get_string_len(val));
+    break;
+  case JSONNumber:
+    sw_yaml_number(fp, json_value_get_number(val));
+    break;
+  case JSONBoolean:
+    fputs(json_value_get_boolean(val) ? "true" : "false", fp);
+    break;
+  default:
+    fputs("null", fp);
+    break;
+  }
+}
+
+static void yaml_block(FILE *fp, const JSON_Value *val, size_t indent,
+                       int inline_first);
+
+/**
+ * @brief Writes the value following `key:`.
+ */
+static void yaml_after_key(FILE *fp, const JSON_Value *val, size_t indent) {
+  if (yaml_is_block(val)) {
+    fputc('\n', fp);
+    yaml_block(fp, val, indent + 2, 0);
+  } else {
+    fputc(' ', fp);
+    yaml_flow(fp, val);
+    fputc('\n', fp);
+  }
+}
+
+/**
+ * @brief Writes a non-empty collection in block style.
+ *
+ * With `inline_first` the first entry continues the current line (after a
+ * `- ` sequence indicator).
+ */
+static void yaml_block(FILE *fp, const JSON_Value *val, size_t indent,
+                       int inline_first) {
+  size_t i, n;
+
+  if (json_value_get_type(val) == JSONObject) {
+    const JSON_Object *obj = json_value_get_object(val);
+    n = json_object_get_count(obj);
+    for (i = 0; i < n; ++i) {
+      const char *key = json_object_get_name(obj, i);
+      if (i > 0 || !inline_first)
+        sw_indent(fp, indent);
+      yaml_string(fp, key, strlen(key));
+      fputc(':', fp);
+      yaml_after_key(fp, json_object_get_value_at(obj, i), indent);
+    }
+    return;
+  }
+  n = json_array_get_count(json_value_get_array(val));
+  for (i = 0; i < n; ++i) {
+    const JSON_Value *item = json_array_get_value(json_value_get_array(val), i);
+    if (i > 0 || !inline_first)
+      sw_indent(fp, indent);
+    fputs("- ", fp);
+    if (yaml_is_block(item)) {
+      yaml_block(fp, item, indent + 2, 1);
+    } else {
+      yaml_flow(fp, item);
+      fputc('\n', fp);
+    }
+  }
+}
+
+/**
+ * @brief Initializes a writer.
+ */
+cdd_c_error_t spec_writer_init(struct SpecWriter *w, FILE *fp,
+                               enum SpecFormat format) {
+  if (!w || !fp)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  memset(w, 0, sizeof(*w));
+  w->fp = fp;
+  w->format = format == SPEC_FORMAT_YAML ? SPEC_FORMAT_YAML : SPEC_FORMAT_JSON;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Opens an object.
+ */
+cdd_c_error_t spec_writer_begin_object(struct SpecWriter *w) {
+  if (!w || w->depth >= SPEC_WRITER_MAX_OPEN)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (!w->after_key && (w->depth > 0 || w->done))
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (w->format == SPEC_FORMAT_JSON)
+    fputc('{', w->fp);
+  w->has_members[w->depth++] = 0;
+  w->after_key = 0;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Writes a member key.
+ */
+cdd_c_error_t spec_writer_key(struct SpecWriter *w, const char *key) {
+  int *has;
+  if (!w || !key || w->depth == 0 || w->after_key)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  has = &w->has_members[w->depth - 1];
+  if (w->format == SPEC_FORMAT_JSON) {
+    fputs(*has ? ",\n" : "\n", w->fp);
+    sw_indent(w->fp, w->depth * 4);
+    sw_quoted(w->fp, key, strlen(key), 1);
+    fputs(": ", w->fp);
+  } else {
+    if (!*has && w->depth > 1)
+      fputc('\n', w->fp);
+    sw_indent(w->fp, (w->depth - 1) * 2);
+    yaml_string(w->fp, key, strlen(key));
+    fputc(':', w->fp);
+  }
+  *has = 1;
+  w->after_key = 1;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Writes a complete value.
+ */
+cdd_c_error_t spec_writer_value(struct SpecWriter *w, const JSON_Value *val) {
+  if (!w)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (w->after_key) {
+    if (w->format == SPEC_FORMAT_JSON)
+      json_write_value(w->fp, val, w->depth);
+    else
+      yaml_after_key(w->fp, val, (w->depth - 1) * 2);
+    w->after_key = 0;
+    return CDD_C_SUCCESS;
+  }
+  if (w->depth > 0 || w->done)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (w->format == SPEC_FORMAT_JSON) {
+    json_write_value(w->fp, val, 0);
+  } else if (yaml_is_block(val)) {
+    yaml_block(w->fp, val, 0, 0);
+  } else {
+    yaml_flow(w->fp, val);
+    fputc('\n', w->fp);
+  }
+  w->done = 1;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Writes every member of an object.
+ */
+cdd_c_error_t spec_writer_members(struct SpecWriter *w,
+                                  const JSON_Object *obj) {
+  size_t i, n;
+  cdd_c_error_t rc;
+  if (!w || !obj)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  n = json_object_get_count(obj);
+  for (i = 0; i < n; ++i) {
+    rc = spec_writer_key(w, json_object_get_name(obj, i));
+    if (rc == CDD_C_SUCCESS)
+      rc = spec_writer_value(w, json_object_get_value_at(obj, i));
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Closes the innermost object.
+ */
+cdd_c_error_t spec_writer_end_object(struct SpecWriter *w) {
+  int has;
+  if (!w || w->depth == 0 || w->after_key)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  has = w->has_members[--w->depth];
+  if (w->format == SPEC_FORMAT_JSON) {
+    if (has) {
+      fputc('\n', w->fp);
+      sw_indent(w->fp, w->depth * 4);
+    }
+    fputc('}', w->fp);
+  } else if (!has) {
+    fputs(w->depth == 0 ? "{}\n" : " {}\n", w->fp);
+  }
+  if (w->depth == 0)
+    w->done = 1;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Checks completion and flushes.
+ */
+cdd_c_error_t spec_writer_finish(struct SpecWriter *w) {
+  if (!w || w->depth > 0 || w->after_key || !w->done)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (fflush(w->fp) != 0 || ferror(w->fp))
+    return CDD_C_ERROR_IO;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Writes a whole value as a document.
+ */
+cdd_c_error_t spec_write_value(FILE *fp, enum SpecFormat format,
+                               const JSON_Value *val) {
+  struct SpecWriter w;
+  cdd_c_error_t rc = spec_writer_init(&w, fp, format);
+  if (rc == CDD_C_SUCCESS)
+    rc = spec_writer_value(&w, val);
+  if (rc == CDD_C_SUCCESS)
+    rc = spec_writer_finish(&w);
+  return rc;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file spec_writer.h
+ * @brief Streaming JSON and YAML writer for OpenAPI documents.
+ *
+ * The writer emits directly to a `FILE*` sink instead of building a
+ * serialized string in memory. Objects can be opened and closed
+ * incrementally, so a caller can produce one section of a document at a
+ * time and free it before producing the next. Parson values are written
+ * recursively in between.
+ *
+ * JSON output is byte-identical to `json_serialize_to_string_pretty`: four
+ * space indentation, `"key": value` members, parson's string escaping
+ * (including `\/`) and `%1.17g` numbers. YAML output uses block style with
+ * two space indentation and quotes any scalar that would not read back as
+ * the same string.
+ *
+ * @author Samuel Marks
+ */
+
+#ifndef C_CDD_SPEC_WRITER_H
+#define C_CDD_SPEC_WRITER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include <stddef.h>
+#include <stdio.h>
+
+#include <parson.h>
+
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+#include "openapi/parse/spec_reader.h"
+/* clang-format on */
+
+/** @brief Deepest nesting of objects opened with spec_writer_begin_object. */
+#define SPEC_WRITER_MAX_OPEN 16
+
+/**
+ * @brief Streaming writer state.
+ */
+struct SpecWriter {
+  FILE *fp;                              /**< Output sink */
+  enum SpecFormat format;                /**< JSON (also for AUTO) or YAML */
+  size_t depth;                          /**< Currently open objects */
+  int has_members[SPEC_WRITER_MAX_OPEN]; /**< Per open object */
+  int after_key;                         /**< A key awaits its value */
+  int done;                              /**< The root value is complete */
+};
+
+/**
+ * @brief Initialize a writer.
+ *
+ * @param[out] w Writer to initialize.
+ * @param[in] fp Output sink; not closed by the writer.
+ * @param[in] format Output syntax.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT on NULL input.
+ */
+extern C_CDD_EXPORT cdd_c_error_t spec_writer_init(struct SpecWriter *w,
+                                                   FILE *fp,
+                                                   enum SpecFormat format);
+
+/**
+ * @brief Open an object as the root value or as the value of a pending key.
+ *
+ * @param[in,out] w Writer.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT if misplaced.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+spec_writer_begin_object(struct SpecWriter *w);
+
+/**
+ * @brief Write a member key of the innermost open object.
+ *
+ * Must be followed by spec_writer_value or spec_writer_begin_object.
+ *
+ * @param[in,out] w Writer.
+ * @param[in] key Member name.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT if misplaced.
+ */
+extern C_CDD_EXPORT cdd_c_error_t spec_writer_key(struct SpecWriter *w,
+                                                  const char *key);
+
+/**
+ * @brief Write a complete value for the pending key, or as the root value.
+ *
+ * @param[in,out] w Writer.
+ * @param[in] val Value to write; NULL is written as null.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT if misplaced.
+ */
+extern C_CDD_EXPORT cdd_c_error_t spec_writer_value(struct SpecWriter *w,
+                                                    const JSON_Value *val);
+
+/**
+ * @brief Write every member of an object into the innermost open object.
+ *
+ * @param[in,out] w Writer.
+ * @param[in] obj Members to write, in order.
+ * @return 0 on success, error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+spec_writer_members(struct SpecWriter *w, const JSON_Object *obj);
+
+/**
+ * @brief Close the innermost open object.
+ *
+ * @param[in,out] w Writer.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT if none is open.
+ */
+extern C_CDD_EXPORT cdd_c_error_t spec_writer_end_object(struct SpecWriter *w);
+
+/**
+ * @brief Check that the document is complete and flush the sink.
+ *
+ * @param[in,out] w Writer.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT if objects are still
+ * open, CDD_C_ERROR_IO if the sink reported an error.
+ */
+extern C_CDD_EXPORT cdd_c_error_t spec_writer_finish(struct SpecWriter *w);
+
+/**
+ * @brief Write a whole value as a document.
+ *
+ * @param[in] fp Output sink.
+ * @param[in] format Output syntax.
+ * @param[in] val Value to write.
+ * @return 0 on success, error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t spec_write_value(FILE *fp,
+                                                   enum SpecFormat format,
+                                                   const JSON_Value *val);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* C_CDD_SPEC_WRITER_H */
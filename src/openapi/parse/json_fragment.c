@@ -0,0 +1,114 @@
+/**
+ * @file json_fragment.c
+ * @brief Implementation of shared, immutable JSON fragments.
+ *
+ * @author Samuel Marks
+ */
+
+/* clang-format off */
+#include <stdlib.h>
+
+#include <parson.h>
+
+#include "c_cdd/memory.h"
+#include "openapi/parse/json_fragment.h"
+/* clang-format on */
+
+/**
+ * @brief Deep-copies a JSON value structurally.
+ */
+cdd_c_error_t json_value_clone(const JSON_Value *val, JSON_Value **out) {
+  if (!out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (!val) {
+    *out = NULL;
+    return CDD_C_SUCCESS;
+  }
+  *out = json_value_deep_copy(val);
+  return *out ? CDD_C_SUCCESS : CDD_C_ERROR_MEMORY;
+}
+
+/**
+ * @brief Wraps an owned value into a fragment, freeing it on failure.
+ */
+static cdd_c_error_t json_fragment_wrap(JSON_Value *val,
+                                        struct JsonFragment **out) {
+  struct JsonFragment *frag =
+      (struct JsonFragment *)C_CDD_MALLOC(sizeof(struct JsonFragment));
+  if (!frag) {
+    json_value_free(val);
+    return CDD_C_ERROR_MEMORY;
+  }
+  frag->value = val;
+  frag->refs = 1;
+  *out = frag;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Parses JSON text into a new fragment.
+ */
+cdd_c_error_t json_fragment_parse(const char *json, struct JsonFragment **out) {
+  JSON_Value *val;
+  if (!json || !out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out = NULL;
+  val = json_parse_string(json);
+  if (!val)
+    return CDD_C_ERROR_PARSE;
+  return json_fragment_wrap(val, out);
+}
+
+/**
+ * @brief Builds a new fragment from a copy of a value.
+ */
+cdd_c_error_t json_fragment_from_value(const JSON_Value *val,
+                                       struct JsonFragment **out) {
+  JSON_Value *copy = NULL;
+  cdd_c_error_t rc;
+  if (!val || !out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out = NULL;
+  rc = json_value_clone(val, &copy);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  return json_fragment_wrap(copy, out);
+}
+
+/**
+ * @brief Adds an owner.
+ */
+struct JsonFragment *json_fragment_retain(struct JsonFragment *frag) {
+  if (frag)
+    frag->refs++;
+  return frag;
+}
+
+/**
+ * @brief Drops an owner.
+ */
+void json_fragment_release(struct JsonFragment *frag) {
+  if (!frag || frag->refs == 0)
+    return;
+  if (--frag->refs > 0)
+    return;
+  json_value_free(frag->value);
+  C_CDD_FREE(frag);
+}
+
+/**
+ * @brief Returns the parsed value.
+ */
+const JSON_Value *json_fragment_value(const struct JsonFragment *frag) {
+  return frag ? frag->value : NULL;
+}
+
+/**
+ * @brief Copies the parsed value for a mutable document.
+ */
+cdd_c_error_t json_fragment_copy_value(const struct JsonFragment *frag,
+                                       JSON_Value **out) {
+  if (!frag || !out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  return json_value_clone(frag->value, out);
+}
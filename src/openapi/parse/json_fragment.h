@@ -0,0 +1,110 @@
+/**
+ * @file json_fragment.h
+ * @brief Immutable, reference-counted JSON fragments.
+ *
+ * A fragment wraps a parsed parson value that is never mutated once built,
+ * so one parse can be shared by every owner (a loaded spec, its copies and
+ * the writer) and attached to an output document by structural copy. Text is
+ * only produced again when the final document is serialized.
+ *
+ * Reference counts are not atomic: a fragment must not be retained or
+ * released concurrently from several threads.
+ *
+ * @author Samuel Marks
+ */
+
+#ifndef C_CDD_JSON_FRAGMENT_H
+#define C_CDD_JSON_FRAGMENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include <stddef.h>
+
+#include <parson.h>
+
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+/* clang-format on */
+
+/**
+ * @brief A shared, read-only parsed JSON value.
+ */
+struct JsonFragment {
+  JSON_Value *value; /**< Parsed value; never mutated after construction */
+  size_t refs;       /**< Number of owners */
+};
+
+/**
+ * @brief Deep-copy a JSON value structurally (no serialization round trip).
+ *
+ * @param[in] val Value to copy (may be NULL, yielding NULL).
+ * @param[out] out Receives the copy, which the caller owns.
+ * @return 0 on success, CDD_C_ERROR_MEMORY if the copy failed.
+ */
+extern C_CDD_EXPORT cdd_c_error_t json_value_clone(const JSON_Value *val,
+                                                   JSON_Value **out);
+
+/**
+ * @brief Parse JSON text into a new fragment with one reference.
+ *
+ * @param[in] json JSON text.
+ * @param[out] out Receives the fragment.
+ * @return 0 on success, CDD_C_ERROR_PARSE on malformed text,
+ * CDD_C_ERROR_MEMORY on allocation failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+json_fragment_parse(const char *json, struct JsonFragment **out);
+
+/**
+ * @brief Build a new fragment holding a structural copy of a value.
+ *
+ * @param[in] val Value to copy; it stays owned by the caller.
+ * @param[out] out Receives the fragment.
+ * @return 0 on success, error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+json_fragment_from_value(const JSON_Value *val, struct JsonFragment **out);
+
+/**
+ * @brief Add an owner to a fragment.
+ *
+ * @param[in] frag Fragment (may be NULL).
+ * @return `frag`.
+ */
+extern C_CDD_EXPORT struct JsonFragment *
+json_fragment_retain(struct JsonFragment *frag);
+
+/**
+ * @brief Drop an owner, freeing the fragment when none remain.
+ *
+ * @param[in] frag Fragment (may be NULL).
+ */
+extern C_CDD_EXPORT void json_fragment_release(struct JsonFragment *frag);
+
+/**
+ * @brief Read-only access to the parsed value.
+ *
+ * @param[in] frag Fragment (may be NULL).
+ * @return The value, or NULL.
+ */
+extern C_CDD_EXPORT const JSON_Value *
+json_fragment_value(const struct JsonFragment *frag);
+
+/**
+ * @brief Copy the fragment's value for attaching to a mutable document.
+ *
+ * @param[in] frag Fragment.
+ * @param[out] out Receives a copy owned by the caller.
+ * @return 0 on success, error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+json_fragment_copy_value(const struct JsonFragment *frag, JSON_Value **out);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* C_CDD_JSON_FRAGMENT_H */
@@ -739,7 +739,7 @@ cdd_c_error_t openapi_spec_init(struct OpenAPI_Spec *spec) {
     spec->component_callbacks = NULL;
     spec->n_component_callbacks = 0;
     spec->raw_schema_names = NULL;
-    spec->raw_schema_json = NULL;
+    spec->raw_schemas = NULL;
     spec->n_raw_schemas = 0;
     spec->defined_schemas = NULL;
     spec->defined_schema_names = NULL;
@@ -1816,17 +1816,17 @@ void openapi_spec_free(struct OpenAPI_Spec *spec) {
     spec->n_component_callbacks = 0;
   }
 
-  if (spec->raw_schema_names || spec->raw_schema_json) {
+  if (spec->raw_schema_names || spec->raw_schemas) {
     for (i = 0; i < spec->n_raw_schemas; ++i) {
       if (spec->raw_schema_names)
         free(spec->raw_schema_names[i]);
-      if (spec->raw_schema_json)
-        free(spec->raw_schema_json[i]);
+      if (spec->raw_schemas)
+        json_fragment_release(spec->raw_schemas[i]);
     }
     free(spec->raw_schema_names);
-    free(spec->raw_schema_json);
+    free(spec->raw_schemas);
     spec->raw_schema_names = NULL;
-    spec->raw_schema_json = NULL;
+    spec->raw_schemas = NULL;
     spec->n_raw_schemas = 0;
   }
 
@@ -2433,31 +2433,6 @@ static cdd_c_error_t is_extension_key(const char *key) {
   return key && key[0] == 'x' && key[1] == '-';
 }
 
-/**
- * @brief Executes the clone json value operation.
- */
-static cdd_c_error_t clone_json_value(const JSON_Value *val,
-                                      JSON_Value **_out_val) {
-  char *serialized;
-  JSON_Value *copy;
-
-  if (!val) {
-    *_out_val = NULL;
-    return CDD_C_SUCCESS;
-  }
-  serialized = json_serialize_to_string((JSON_Value *)val);
-  if (!serialized) {
-    *_out_val = NULL;
-    return CDD_C_SUCCESS;
-  }
-  copy = json_parse_string(serialized);
-  json_free_serialized_string(serialized);
-  {
-    *_out_val = copy;
-    return CDD_C_SUCCESS;
-  }
-}
-
 /**
  * @brief Collects schema extras.
  */
@@ -2490,7 +2465,7 @@ static cdd_c_error_t collect_schema_extras(const JSON_Object *obj,
     if (!key || key_in_list(key, skip_keys, skip_count))
       continue;
     val = json_object_get_value(obj, key);
-    copy = (clone_json_value(val, &_ast_clone_json_value_0),
+    copy = (json_value_clone(val, &_ast_clone_json_value_0),
             _ast_clone_json_value_0);
     if (!copy) {
       json_value_free(extras_val);
@@ -2549,7 +2524,7 @@ static cdd_c_error_t collect_extensions(const JSON_Object *obj,
     if (!is_extension_key(key))
       continue;
     val = json_object_get_value(obj, key);
-    copy = (clone_json_value(val, &_ast_clone_json_value_1),
+    copy = (json_value_clone(val, &_ast_clone_json_value_1),
             _ast_clone_json_value_1);
     if (!copy) {
       json_value_free(extras_val);
@@ -8383,15 +8358,14 @@ static cdd_c_error_t raw_schema_name_exists(const struct OpenAPI_Spec *spec,
 static cdd_c_error_t append_raw_schema(struct OpenAPI_Spec *spec,
                                        const char *name,
                                        const JSON_Value *schema_val) {
-  char *_ast_strdup_206 = NULL;
   char *_ast_strdup_207 = NULL;
   size_t i;
   size_t new_count;
   char **new_names = NULL;
-  char **new_json = NULL;
+  struct JsonFragment **new_frags = NULL;
   char *dup_name = NULL;
-  char *dup_json = NULL;
-  char *raw_json = NULL;
+  struct JsonFragment *frag = NULL;
+  cdd_c_error_t rc;
 
   if (!spec || !name || !schema_val)
     return CDD_C_ERROR_INVALID_ARGUMENT;
@@ -8399,42 +8373,39 @@ static cdd_c_error_t append_raw_schema(struct OpenAPI_Spec *spec,
   if (raw_schema_name_exists(spec, name))
     return CDD_C_SUCCESS;
 
-  raw_json = json_serialize_to_string(schema_val);
-  if (!raw_json)
-    return CDD_C_ERROR_MEMORY;
-  dup_json = (c_cdd_strdup(raw_json, &_ast_strdup_206), _ast_strdup_206);
-  json_free_serialized_string(raw_json);
-  if (!dup_json)
-    return CDD_C_ERROR_MEMORY;
+  rc = json_fragment_from_value(schema_val, &frag);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
 
   dup_name = (c_cdd_strdup(name, &_ast_strdup_207), _ast_strdup_207);
   if (!dup_name) {
-    free(dup_json);
+    json_fragment_release(frag);
     return CDD_C_ERROR_MEMORY;
   }
 
   new_count = spec->n_raw_schemas + 1;
   new_names = (char **)calloc(new_count, sizeof(char *));
-  new_json = (char **)calloc(new_count, sizeof(char *));
-  if (!new_names || !new_json) {
+  new_frags = (struct JsonFragment **)calloc(new_count,
+                                             sizeof(struct JsonFragment *));
+  if (!new_names || !new_frags) {
     free(new_names);
-    free(new_json);
+    free(new_frags);
     free(dup_name);
-    free(dup_json);
+    json_fragment_release(frag);
     return CDD_C_ERROR_MEMORY;
   }
 
   for (i = 0; i < spec->n_raw_schemas; ++i) {
     new_names[i] = spec->raw_schema_names ? spec->raw_schema_names[i] : NULL;
-    new_json[i] = spec->raw_schema_json ? spec->raw_schema_json[i] : NULL;
+    new_frags[i] = spec->raw_schemas ? spec->raw_schemas[i] : NULL;
   }
   new_names[new_count - 1] = dup_name;
-  new_json[new_count - 1] = dup_json;
+  new_frags[new_count - 1] = frag;
 
   free(spec->raw_schema_names);
-  free(spec->raw_schema_json);
+  free(spec->raw_schemas);
   spec->raw_schema_names = new_names;
-  spec->raw_schema_json = new_json;
+  spec->raw_schemas = new_frags;
   spec->n_raw_schemas = new_count;
   return CDD_C_SUCCESS;
 }
@@ -11992,7 +11963,6 @@ static cdd_c_error_t parse_components(const JSON_Object *components,
   char *_ast_strdup_282 = NULL;
   char *_ast_strdup_283 = NULL;
   char *_ast_strdup_284 = NULL;
-  char *_ast_strdup_285 = NULL;
   const JSON_Object *schemas;
   size_t i, count;
 
@@ -12076,8 +12046,9 @@ static cdd_c_error_t parse_components(const JSON_Object *components,
 
     if (raw_count > 0) {
       out->raw_schema_names = (char **)calloc(raw_count, sizeof(char *));
-      out->raw_schema_json = (char **)calloc(raw_count, sizeof(char *));
-      if (!out->raw_schema_names || !out->raw_schema_json)
+      out->raw_schemas = (struct JsonFragment **)calloc(
+          raw_count, sizeof(struct JsonFragment *));
+      if (!out->raw_schema_names || !out->raw_schemas)
         return CDD_C_ERROR_MEMORY;
       out->n_raw_schemas = raw_count;
     }
@@ -12139,20 +12110,14 @@ static cdd_c_error_t parse_components(const JSON_Object *components,
 
       if (!schema_is_struct_compatible(schema_val, schema_obj) ||
           schema_has_composition(schema_obj)) {
-        char *raw_json = NULL;
-        char *dup_json = NULL;
+        cdd_c_error_t rc;
         out->raw_schema_names[raw_idx] =
             (c_cdd_strdup(name, &_ast_strdup_284), _ast_strdup_284);
         if (!out->raw_schema_names[raw_idx])
           return CDD_C_ERROR_MEMORY;
-        raw_json = json_serialize_to_string(schema_val);
-        if (!raw_json)
-          return CDD_C_ERROR_MEMORY;
-        dup_json = (c_cdd_strdup(raw_json, &_ast_strdup_285), _ast_strdup_285);
-        json_free_serialized_string(raw_json);
-        if (!dup_json)
-          return CDD_C_ERROR_MEMORY;
-        out->raw_schema_json[raw_idx] = dup_json;
+        rc = json_fragment_from_value(schema_val, &out->raw_schemas[raw_idx]);
+        if (rc != CDD_C_SUCCESS)
+          return rc;
         raw_idx++;
       }
     }
@@ -13716,6 +13681,70 @@ cdd_c_error_t openapi_load_from_json_with_context(
   return openapi_load_from_json_internal(root, out, retrieval_uri, registry);
 }
 
+/**
+ * @brief Parses one Path Item Object into a caller-provided path.
+ */
+cdd_c_error_t openapi_parse_path_item(const struct OpenAPI_Spec *spec,
+                                      int webhook, const char *route,
+                                      JSON_Value *item,
+                                      struct OpenAPI_Path *out) {
+  JSON_Value *wrap;
+  struct OpenAPI_Path *parsed = NULL;
+  size_t n_parsed = 0;
+  cdd_c_error_t rc;
+
+  if (!spec || !route || !item || !out) {
+    if (item)
+      json_value_free(item);
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  }
+  wrap = json_value_init_object();
+  if (!wrap) {
+    json_value_free(item);
+    return CDD_C_ERROR_MEMORY;
+  }
+  if (json_object_set_value(json_value_get_object(wrap), route, item) !=
+      JSONSuccess) {
+    json_value_free(item);
+    json_value_free(wrap);
+    return CDD_C_ERROR_MEMORY;
+  }
+  rc = parse_paths_object(json_value_get_object(wrap), &parsed, &n_parsed,
+                          spec, !webhook, 1);
+  json_value_free(wrap);
+  if (parsed) {
+    /* Partial results are handed over too, for the caller to free */
+    *out = parsed[0];
+    free(parsed);
+  }
+  return rc;
+}
+
+/**
+ * @brief Validates paths and webhooks added one at a time.
+ */
+cdd_c_error_t openapi_spec_finish_paths(const struct OpenAPI_Spec *spec) {
+  int rc;
+  if (!spec)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  rc = validate_path_templates(spec->paths, spec->n_paths);
+  if (rc == 0)
+    rc = validate_path_template_collisions(spec->paths, spec->n_paths);
+  if (rc == 0)
+    rc = validate_querystring_usage(spec->paths, spec->n_paths);
+  if (rc == 0)
+    rc = validate_querystring_usage_in_paths_callbacks(spec->paths,
+                                                       spec->n_paths);
+  if (rc == 0)
+    rc = validate_querystring_usage(spec->webhooks, spec->n_webhooks);
+  if (rc == 0)
+    rc = validate_querystring_usage_in_paths_callbacks(spec->webhooks,
+                                                       spec->n_webhooks);
+  if (rc == 0)
+    rc = validate_unique_operation_ids(spec);
+  return rc;
+}
+
 /**
  * @brief Executes the openapi spec find schema operation.
  */
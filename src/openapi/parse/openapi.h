@@ -41,6 +41,7 @@ extern "C" {
 #include "c_cdd_export.h"
 #include "cdd_c_error.h"
 #include "classes/emit/struct.h" /* For StructFields definition */
+#include "openapi/parse/json_fragment.h"
 /* clang-format on */
 
 struct OpenAPI_Path;
@@ -889,10 +890,10 @@ struct OpenAPI_Spec {
   struct OpenAPI_Callback *component_callbacks; /**< components.callbacks */
   size_t n_component_callbacks;                 /**< Count of callbacks */
 
-  /* Component Schemas stored as raw JSON when non-struct compatible */
-  char **raw_schema_names; /**< components.schemas keys for raw schemas */
-  char **raw_schema_json;  /**< Serialized JSON for raw schemas */
-  size_t n_raw_schemas;    /**< Count of raw schemas */
+  /* Component Schemas kept as parsed JSON when non-struct compatible */
+  char **raw_schema_names;           /**< components.schemas keys */
+  struct JsonFragment **raw_schemas; /**< Shared parsed raw schemas */
+  size_t n_raw_schemas;              /**< Count of raw schemas */
 
   /* Global Schema Data (for looking up struct definitions during body gen) */
   struct StructFields
@@ -971,6 +972,36 @@ extern C_CDD_EXPORT cdd_c_error_t openapi_doc_registry_add(
 extern C_CDD_EXPORT cdd_c_error_t
 openapi_load_from_json(const JSON_Value *root, struct OpenAPI_Spec *out);
 
+/**
+ * @brief Parse a single Path Item Object against an already loaded spec.
+ *
+ * Lets a streaming reader load `paths` and `webhooks` one entry at a time
+ * after the rest of the document (components included) has been loaded
+ * with openapi_load_from_json(). Call openapi_spec_finish_paths() once all
+ * entries are in.
+ *
+ * @param[in] spec Spec providing components for `$ref` resolution.
+ * @param[in] webhook 1 for a `webhooks` entry, 0 for a `paths` entry.
+ * @param[in] route The entry's key (e.g. "/pets/{id}").
+ * @param[in] item The Path Item value; ownership is taken and it is freed.
+ * @param[out] out Zeroed path to fill; owned by the caller even on failure.
+ * @return 0 on success, error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+openapi_parse_path_item(const struct OpenAPI_Spec *spec, int webhook,
+                        const char *route, JSON_Value *item,
+                        struct OpenAPI_Path *out);
+
+/**
+ * @brief Run the checks openapi_load_from_json() applies to `paths` and
+ * `webhooks` once they have been added with openapi_parse_path_item().
+ *
+ * @param[in] spec The loaded spec.
+ * @return 0 on success, error code on an invalid document.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+openapi_spec_finish_paths(const struct OpenAPI_Spec *spec);
+
 /**
  * @brief Parse a JSON Value with document context for multi-doc resolution.
  *
@@ -0,0 +1,1935 @@
+/**
+ * @file spec_reader.c
+ * @brief Implementation of the event-driven JSON and YAML spec reader.
+ *
+ * Both front ends are recursive-descent scanners over a bounded buffer. Text
+ * of keys and strings is unescaped into a reusable scratch buffer, so the
+ * input itself is never copied.
+ *
+ * @author Samuel Marks
+ */
+
+/* clang-format off */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <parson.h>
+
+#include "c_cdd/memory.h"
+#include "c_cdd/safe_crt.h"
+#include "functions/parse/fs.h"
+#include "openapi/parse/spec_reader.h"
+/* clang-format on */
+
+/**
+ * @brief Scanner state shared by both front ends.
+ */
+struct SpecScanner {
+  const char *buf;           /**< Input */
+  size_t len;                /**< Input length */
+  size_t pos;                /**< Current offset */
+  size_t line;               /**< 1-based line of `pos` */
+  size_t line_start;         /**< Offset of the current line */
+  spec_event_cb cb;          /**< Event sink */
+  void *user_data;           /**< Passed to `cb` */
+  struct SpecReadError *err; /**< Optional failure report */
+  char *scratch;             /**< Unescaped text */
+  size_t scratch_len;        /**< Bytes used in `scratch` */
+  size_t scratch_cap;        /**< Capacity of `scratch` */
+  size_t depth;              /**< Current container nesting */
+};
+
+/* --- Shared helpers --- */
+
+/**
+ * @brief Returns the byte at `pos + off`, or 0 past the end.
+ */
+static char scan_peek(const struct SpecScanner *s, size_t off) {
+  return s->pos + off < s->len ? s->buf[s->pos + off] : '\0';
+}
+
+/**
+ * @brief Returns the 0-based column of the current position.
+ */
+static size_t scan_col(const struct SpecScanner *s) {
+  return s->pos - s->line_start;
+}
+
+/**
+ * @brief Consumes one byte, tracking line starts.
+ */
+static void scan_advance(struct SpecScanner *s) {
+  if (s->buf[s->pos] == '\n') {
+    s->line++;
+    s->line_start = s->pos + 1;
+  }
+  s->pos++;
+}
+
+/**
+ * @brief Records a syntax error at a location.
+ */
+static cdd_c_error_t scan_fail_at(struct SpecScanner *s, size_t line,
+                                  size_t column, const char *msg) {
+  if (s->err) {
+    s->err->line = line;
+    s->err->column = column;
+    CDD_SNPRINTF(s->err->message, sizeof(s->err->message), "%s", msg);
+  }
+  return CDD_C_ERROR_PARSE;
+}
+
+/**
+ * @brief Records a syntax error at the current position.
+ */
+static cdd_c_error_t scan_fail(struct SpecScanner *s, const char *msg) {
+  return scan_fail_at(s, s->line, scan_col(s) + 1, msg);
+}
+
+/**
+ * @brief Appends bytes to the scratch buffer, keeping it NUL-terminated.
+ */
+static cdd_c_error_t scratch_append(struct SpecScanner *s, const char *p,
+                                    size_t n) {
+  if (s->scratch_len + n + 1 > s->scratch_cap) {
+    size_t cap = s->scratch_cap ? s->scratch_cap : 256;
+    char *grown;
+    while (cap < s->scratch_len + n + 1)
+      cap *= 2;
+    grown = (char *)C_CDD_REALLOC(s->scratch, cap);
+    if (!grown)
+      return CDD_C_ERROR_MEMORY;
+    s->scratch = grown;
+    s->scratch_cap = cap;
+  }
+  if (n)
+    memcpy(s->scratch + s->scratch_len, p, n);
+  s->scratch_len += n;
+  s->scratch[s->scratch_len] = '\0';
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Appends one byte to the scratch buffer.
+ */
+static cdd_c_error_t scratch_push(struct SpecScanner *s, char c) {
+  return scratch_append(s, &c, 1);
+}
+
+/**
+ * @brief Clears the scratch buffer.
+ */
+static cdd_c_error_t scratch_reset(struct SpecScanner *s) {
+  s->scratch_len = 0;
+  return scratch_append(s, "", 0);
+}
+
+/**
+ * @brief Appends a code point as UTF-8.
+ */
+static cdd_c_error_t scratch_push_utf8(struct SpecScanner *s,
+                                       unsigned long cp) {
+  char out[4];
+  size_t n;
+  if (cp < 0x80UL) {
+    out[0] = (char)cp;
+    n = 1;
+  } else if (cp < 0x800UL) {
+    out[0] = (char)(0xC0 | (cp >> 6));
+    out[1] = (char)(0x80 | (cp & 0x3F));
+    n = 2;
+  } else if (cp < 0x10000UL) {
+    out[0] = (char)(0xE0 | (cp >> 12));
+    out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[2] = (char)(0x80 | (cp & 0x3F));
+    n = 3;
+  } else {
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    n = 4;
+  }
+  return scratch_append(s, out, n);
+}
+
+/**
+ * @brief Drops trailing blanks from the scratch buffer.
+ */
+static void scratch_trim_blanks(struct SpecScanner *s) {
+  while (s->scratch_len > 0 && (s->scratch[s->scratch_len - 1] == ' ' ||
+                                s->scratch[s->scratch_len - 1] == '\t'))
+    s->scratch_len--;
+  if (s->scratch)
+    s->scratch[s->scratch_len] = '\0';
+}
+
+/**
+ * @brief Reads `n` hex digits at the current position.
+ */
+static cdd_c_error_t scan_hex(struct SpecScanner *s, size_t n,
+                              unsigned long *out) {
+  size_t i;
+  *out = 0;
+  for (i = 0; i < n; ++i) {
+    char c = scan_peek(s, 0);
+    unsigned long digit;
+    if (c >= '0' && c <= '9')
+      digit = (unsigned long)(c - '0');
+    else if (c >= 'a' && c <= 'f')
+      digit = (unsigned long)(c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F')
+      digit = (unsigned long)(c - 'A' + 10);
+    else
+      return scan_fail(s, "invalid hex escape");
+    *out = (*out << 4) | digit;
+    s->pos++;
+  }
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Emits an event, taking KEY/STRING text from the scratch buffer.
+ */
+static cdd_c_error_t scan_emit(struct SpecScanner *s, enum SpecEventKind kind,
+                               size_t line, size_t column) {
+  struct SpecEvent ev;
+  ev.kind = kind;
+  ev.text = s->scratch ? s->scratch : "";
+  ev.len = s->scratch_len;
+  ev.number = 0;
+  ev.boolean = 0;
+  ev.line = line;
+  ev.column = column;
+  return s->cb(s->user_data, &ev);
+}
+
+/**
+ * @brief Emits a NUMBER or BOOLEAN event.
+ */
+static cdd_c_error_t scan_emit_value(struct SpecScanner *s,
+                                     enum SpecEventKind kind, double number,
+                                     int boolean, size_t line, size_t column) {
+  struct SpecEvent ev;
+  ev.kind = kind;
+  ev.text = "";
+  ev.len = 0;
+  ev.number = number;
+  ev.boolean = boolean;
+  ev.line = line;
+  ev.column = column;
+  return s->cb(s->user_data, &ev);
+}
+
+/**
+ * @brief Enters a container, enforcing the nesting limit.
+ */
+static cdd_c_error_t scan_enter(struct SpecScanner *s, enum SpecEventKind kind,
+                                size_t line, size_t column) {
+  if (++s->depth > SPEC_READER_MAX_DEPTH)
+    return scan_fail_at(s, line, column, "nesting too deep");
+  return scan_emit(s, kind, line, column);
+}
+
+/**
+ * @brief Leaves a container.
+ */
+static cdd_c_error_t scan_leave(struct SpecScanner *s, enum SpecEventKind kind,
+                                size_t line, size_t column) {
+  s->depth--;
+  return scan_emit(s, kind, line, column);
+}
+
+/* --- JSON --- */
+
+/**
+ * @brief Skips JSON whitespace.
+ */
+static void json_skip_ws(struct SpecScanner *s) {
+  while (s->pos < s->len) {
+    char c = s->buf[s->pos];
+    if (c == '\n') {
+      s->line++;
+      s->line_start = s->pos + 1;
+    } else if (c != ' ' && c != '\t' && c != '\r') {
+      return;
+    }
+    s->pos++;
+  }
+}
+
+/**
+ * @brief Reads a JSON string (at `"`) into the scratch buffer.
+ */
+static cdd_c_error_t json_string(struct SpecScanner *s) {
+  size_t line = s->line;
+  size_t column = scan_col(s) + 1;
+  cdd_c_error_t rc = scratch_reset(s);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  s->pos++;
+  for (;;) {
+    size_t run = s->pos;
+    unsigned long cp;
+    char c;
+    while (run < s->len && s->buf[run] != '"' && s->buf[run] != '\\' &&
+           (unsigned char)s->buf[run] >= 0x20)
+      run++;
+    rc = scratch_append(s, s->buf + s->pos, run - s->pos);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    s->pos = run;
+    if (s->pos >= s->len)
+      return scan_fail_at(s, line, column, "unterminated string");
+    c = s->buf[s->pos];
+    if (c == '"') {
+      s->pos++;
+      return CDD_C_SUCCESS;
+    }
+    if (c != '\\')
+      return scan_fail(s, "control character in string");
+    s->pos++;
+    c = scan_peek(s, 0);
+    s->pos++;
+    switch (c) {
+    case '"':
+    case '\\':
+    case '/':
+      rc = scratch_push(s, c);
+      break;
+    case 'b':
+      rc = scratch_push(s, '\b');
+      break;
+    case 'f':
+      rc = scratch_push(s, '\f');
+      break;
+    case 'n':
+      rc = scratch_push(s, '\n');
+      break;
+    case 'r':
+      rc = scratch_push(s, '\r');
+      break;
+    case 't':
+      rc = scratch_push(s, '\t');
+      break;
+    case 'u':
+      rc = scan_hex(s, 4, &cp);
+      if (rc != CDD_C_SUCCESS)
+        return rc;
+      if (cp >= 0xD800UL && cp <= 0xDBFFUL) {
+        unsigned long lo;
+        if (scan_peek(s, 0) != '\\' || scan_peek(s, 1) != 'u')
+          return scan_fail(s, "unpaired surrogate");
+        s->pos += 2;
+        rc = scan_hex(s, 4, &lo);
+        if (rc != CDD_C_SUCCESS)
+          return rc;
+        if (lo < 0xDC00UL || lo > 0xDFFFUL)
+          return scan_fail(s, "unpaired surrogate");
+        cp = 0x10000UL + ((cp - 0xD800UL) << 10) + (lo - 0xDC00UL);
+      } else if (cp >= 0xDC00UL && cp <= 0xDFFFUL) {
+        return scan_fail(s, "unpaired surrogate");
+      }
+      rc = scratch_push_utf8(s, cp);
+      break;
+    default:
+      s->pos--;
+      return scan_fail(s, "invalid escape");
+    }
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
+}
+
+/**
+ * @brief Reads a JSON number.
+ */
+static cdd_c_error_t json_number(struct SpecScanner *s) {
+  size_t line = s->line;
+  size_t column = scan_col(s) + 1;
+  size_t start = s->pos;
+  cdd_c_error_t rc;
+
+  if (scan_peek(s, 0) == '-')
+    s->pos++;
+  if (scan_peek(s, 0) == '0') {
+    s->pos++;
+  } else if (scan_peek(s, 0) >= '1' && scan_peek(s, 0) <= '9') {
+    while (scan_peek(s, 0) >= '0' && scan_peek(s, 0) <= '9')
+      s->pos++;
+  } else {
+    return scan_fail(s, "invalid number");
+  }
+  if (scan_peek(s, 0) == '.') {
+    s->pos++;
+    if (!(scan_peek(s, 0) >= '0' && scan_peek(s, 0) <= '9'))
+      return scan_fail(s, "invalid number");
+    while (scan_peek(s, 0) >= '0' && scan_peek(s, 0) <= '9')
+      s->pos++;
+  }
+  if (scan_peek(s, 0) == 'e' || scan_peek(s, 0) == 'E') {
+    s->pos++;
+    if (scan_peek(s, 0) == '+' || scan_peek(s, 0) == '-')
+      s->pos++;
+    if (!(scan_peek(s, 0) >= '0' && scan_peek(s, 0) <= '9'))
+      return scan_fail(s, "invalid number");
+    while (scan_peek(s, 0) >= '0' && scan_peek(s, 0) <= '9')
+      s->pos++;
+  }
+
+  /* strtod needs a terminated copy; the input may be a raw mapping */
+  rc = scratch_reset(s);
+  if (rc == CDD_C_SUCCESS)
+    rc = scratch_append(s, s->buf + start, s->pos - start);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  return scan_emit_value(s, SPEC_EVENT_NUMBER, strtod(s->scratch, NULL), 0,
+                         line, column);
+}
+
+/**
+ * @brief Matches a literal keyword at the current position.
+ */
+static int scan_match(struct SpecScanner *s, const char *word) {
+  size_t n = strlen(word);
+  if (s->len - s->pos < n || memcmp(s->buf + s->pos, word, n) != 0)
+    return 0;
+  s->pos += n;
+  return 1;
+}
+
+/**
+ * @brief Reads one JSON value.
+ */
+static cdd_c_error_t json_value(struct SpecScanner *s) {
+  size_t line, column;
+  cdd_c_error_t rc;
+
+  json_skip_ws(s);
+  if (s->pos >= s->len)
+    return scan_fail(s, "unexpected end of input");
+  line = s->line;
+  column = scan_col(s) + 1;
+
+  switch (s->buf[s->pos]) {
+  case '{':
+    rc = scratch_reset(s);
+    if (rc == CDD_C_SUCCESS)
+      rc = scan_enter(s, SPEC_EVENT_BEGIN_OBJECT, line, column);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    s->pos++;
+    json_skip_ws(s);
+    if (scan_peek(s, 0) == '}') {
+      s->pos++;
+    } else {
+      for (;;) {
+        size_t key_line, key_column;
+        json_skip_ws(s);
+        if (scan_peek(s, 0) != '"')
+          return scan_fail(s, "expected a string key");
+        key_line = s->line;
+        key_column = scan_col(s) + 1;
+        rc = json_string(s);
+        if (rc == CDD_C_SUCCESS)
+          rc = scan_emit(s, SPEC_EVENT_KEY, key_line, key_column);
+        if (rc != CDD_C_SUCCESS)
+          return rc;
+        json_skip_ws(s);
+        if (scan_peek(s, 0) != ':')
+          return scan_fail(s, "expected ':'");
+        s->pos++;
+        rc = json_value(s);
+        if (rc != CDD_C_SUCCESS)
+          return rc;
+        json_skip_ws(s);
+        if (scan_peek(s, 0) == ',') {
+          s->pos++;
+          continue;
+        }
+        if (scan_peek(s, 0) == '}') {
+          s->pos++;
+          break;
+        }
+        return scan_fail(s, "expected ',' or '}'");
+      }
+    }
+    rc = scratch_reset(s);
+    return rc != CDD_C_SUCCESS
+               ? rc
+               : scan_leave(s, SPEC_EVENT_END_OBJECT, s->line, scan_col(s));
+  case '[':
+    rc = scratch_reset(s);
+    if (rc == CDD_C_SUCCESS)
+      rc = scan_enter(s, SPEC_EVENT_BEGIN_ARRAY, line, column);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    s->pos++;
+    json_skip_ws(s);
+    if (scan_peek(s, 0) == ']') {
+      s->pos++;
+    } else {
+      for (;;) {
+        rc = json_value(s);
+        if (rc != CDD_C_SUCCESS)
+          return rc;
+        json_skip_ws(s);
+        if (scan_peek(s, 0) == ',') {
+          s->pos++;
+          continue;
+        }
+        if (scan_peek(s, 0) == ']') {
+          s->pos++;
+          break;
+        }
+        return scan_fail(s, "expected ',' or ']'");
+      }
+    }
+    rc = scratch_reset(s);
+    return rc != CDD_C_SUCCESS
+               ? rc
+               : scan_leave(s, SPEC_EVENT_END_ARRAY, s->line, scan_col(s));
+  case '"':
+    rc = json_string(s);
+    return rc != CDD_C_SUCCESS ? rc
+                               : scan_emit(s, SPEC_EVENT_STRING, line, column);
+  case 't':
+    if (scan_match(s, "true"))
+      return scan_emit_value(s, SPEC_EVENT_BOOLEAN, 0, 1, line, column);
+    break;
+  case 'f':
+    if (scan_match(s, "false"))
+      return scan_emit_value(s, SPEC_EVENT_BOOLEAN, 0, 0, line, column);
+    break;
+  case 'n':
+    if (scan_match(s, "null")) {
+      rc = scratch_reset(s);
+      return rc != CDD_C_SUCCESS
+                 ? rc
+                 : scan_emit(s, SPEC_EVENT_NULL, line, column);
+    }
+    break;
+  default:
+    if (s->buf[s->pos] == '-' ||
+        (s->buf[s->pos] >= '0' && s->buf[s->pos] <= '9'))
+      return json_number(s);
+    break;
+  }
+  return scan_fail(s, "unexpected character");
+}
+
+/**
+ * @brief Scans a whole JSON document.
+ */
+static cdd_c_error_t json_document(struct SpecScanner *s) {
+  cdd_c_error_t rc = json_value(s);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  json_skip_ws(s);
+  if (s->pos < s->len)
+    return scan_fail(s, "unexpected content after document");
+  return CDD_C_SUCCESS;
+}
+
+/* --- YAML --- */
+
+/**
+ * @brief True for a blank, a line break or the end of input.
+ */
+static int yaml_is_break_or_blank(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\0';
+}
+
+/**
+ * @brief True at a line break or the end of input.
+ */
+static int yaml_at_eol(const struct SpecScanner *s) {
+  char c = scan_peek(s, 0);
+  return s->pos >= s->len || c == '\n' || c == '\r';
+}
+
+/**
+ * @brief Skips spaces and tabs on the current line.
+ */
+static void yaml_skip_spaces(struct SpecScanner *s) {
+  while (s->pos < s->len && (s->buf[s->pos] == ' ' || s->buf[s->pos] == '\t'))
+    s->pos++;
+}
+
+/**
+ * @brief Skips to the end of the current line (not past the break).
+ */
+static void yaml_skip_line(struct SpecScanner *s) {
+  while (s->pos < s->len && s->buf[s->pos] != '\n')
+    s->pos++;
+}
+
+/**
+ * @brief Skips blank lines, comments, directives and document markers.
+ *
+ * Leaves the position at the next content byte or the end of input.
+ */
+static void yaml_skip_blank(struct SpecScanner *s) {
+  for (;;) {
+    char c;
+    yaml_skip_spaces(s);
+    if (s->pos >= s->len)
+      return;
+    c = s->buf[s->pos];
+    if (c == '#' || (c == '%' && s->pos == s->line_start)) {
+      yaml_skip_line(s);
+    } else if (c == '\r' || c == '\n') {
+      scan_advance(s);
+    } else if (s->pos == s->line_start && s->len - s->pos >= 3 &&
+               yaml_is_break_or_blank(scan_peek(s, 3)) &&
+               (memcmp(s->buf + s->pos, "---", 3) == 0 ||
+                memcmp(s->buf + s->pos, "...", 3) == 0)) {
+      if (c == '.') {
+        s->pos = s->len;
+        return;
+      }
+      s->pos += 3;
+    } else {
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Rejects node properties this reader does not support.
+ */
+static cdd_c_error_t yaml_check_indicator(struct SpecScanner *s) {
+  switch (scan_peek(s, 0)) {
+  case '&':
+  case '*':
+    return scan_fail(s, "YAML anchors and aliases are not supported");
+  case '!':
+    return scan_fail(s, "YAML tags are not supported");
+  case '?':
+    if (yaml_is_break_or_blank(scan_peek(s, 1)))
+      return scan_fail(s, "YAML complex keys are not supported");
+    return CDD_C_SUCCESS;
+  case '@':
+  case '`':
+    return scan_fail(s, "reserved indicator");
+  default:
+    return CDD_C_SUCCESS;
+  }
+}
+
+/**
+ * @brief Consumes a line break and any following blank lines inside a
+ * quoted scalar, appending the folded result.
+ */
+static cdd_c_error_t yaml_fold_break(struct SpecScanner *s) {
+  size_t breaks = 0;
+  scratch_trim_blanks(s);
+  while (s->pos < s->len) {
+    char c = s->buf[s->pos];
+    if (c == '\n') {
+      breaks++;
+      scan_advance(s);
+    } else if (c == ' ' || c == '\t' || c == '\r') {
+      s->pos++;
+    } else {
+      break;
+    }
+  }
+  if (breaks <= 1)
+    return scratch_push(s, ' ');
+  while (--breaks > 0) {
+    cdd_c_error_t rc = scratch_push(s, '\n');
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Reads a double-quoted scalar (at `"`) into the scratch buffer.
+ */
+static cdd_c_error_t yaml_double_quoted(struct SpecScanner *s) {
+  size_t line = s->line;
+  size_t column = scan_col(s) + 1;
+  cdd_c_error_t rc = scratch_reset(s);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  s->pos++;
+  for (;;) {
+    char c;
+    unsigned long cp;
+    if (s->pos >= s->len)
+      return scan_fail_at(s, line, column, "unterminated string");
+    c = s->buf[s->pos];
+    if (c == '"') {
+      s->pos++;
+      return CDD_C_SUCCESS;
+    }
+    if (c == '\r') {
+      s->pos++;
+      continue;
+    }
+    if (c == '\n') {
+      rc = yaml_fold_break(s);
+      if (rc != CDD_C_SUCCESS)
+        return rc;
+      continue;
+    }
+    if (c != '\\') {
+      rc = scratch_push(s, c);
+      s->pos++;
+      if (rc != CDD_C_SUCCESS)
+        return rc;
+      continue;
+    }
+    s->pos++;
+    c = scan_peek(s, 0);
+    s->pos++;
+    switch (c) {
+    case '0':
+      rc = scratch_push_utf8(s, 0);
+      break;
+    case 'a':
+      rc = scratch_push(s, '\a');
+      break;
+    case 'b':
+      rc = scratch_push(s, '\b');
+      break;
+    case 't':
+    case '\t':
+      rc = scratch_push(s, '\t');
+      break;
+    case 'n':
+      rc = scratch_push(s, '\n');
+      break;
+    case 'v':
+      rc = scratch_push(s, '\v');
+      break;
+    case 'f':
+      rc = scratch_push(s, '\f');
+      break;
+    case 'r':
+      rc = scratch_push(s, '\r');
+      break;
+    case 'e':
+      rc = scratch_push(s, '\033');
+      break;
+    case ' ':
+    case '"':
+    case '/':
+    case '\\':
+      rc = scratch_push(s, c);
+      break;
+    case 'N':
+      rc = scratch_push_utf8(s, 0x85UL);
+      break;
+    case '_':
+      rc = scratch_push_utf8(s, 0xA0UL);
+      break;
+    case 'L':
+      rc = scratch_push_utf8(s, 0x2028UL);
+      break;
+    case 'P':
+      rc = scratch_push_utf8(s, 0x2029UL);
+      break;
+    case 'x':
+    case 'u':
+    case 'U':
+      rc = scan_hex(s, c == 'x' ? 2 : (c == 'u' ? 4 : 8), &cp);
+      if (rc == CDD_C_SUCCESS)
+        rc = scratch_push_utf8(s, cp);
+      break;
+    case '\r':
+    case '\n':
+      /* Escaped line break: join without a space */
+      s->pos--;
+      while (s->pos < s->len &&
+             (s->buf[s->pos] == '\r' || s->buf[s->pos] == '\n'))
+        scan_advance(s);
+      yaml_skip_spaces(s);
+      rc = CDD_C_SUCCESS;
+      break;
+    default:
+      s->pos--;
+      return scan_fail(s, "invalid escape");
+    }
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
+}
+
+/**
+ * @brief Reads a single-quoted scalar (at `'`) into the scratch buffer.
+ */
+static cdd_c_error_t yaml_single_quoted(struct SpecScanner *s) {
+  size_t line = s->line;
+  size_t column = scan_col(s) + 1;
+  cdd_c_error_t rc = scratch_reset(s);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  s->pos++;
+  for (;;) {
+    char c;
+    if (s->pos >= s->len)
+      return scan_fail_at(s, line, column, "unterminated string");
+    c = s->buf[s->pos];
+    if (c == '\'') {
+      if (scan_peek(s, 1) != '\'') {
+        s->pos++;
+        return CDD_C_SUCCESS;
+      }
+      s->pos++;
+    } else if (c == '\r') {
+      s->pos++;
+      continue;
+    } else if (c == '\n') {
+      rc = yaml_fold_break(s);
+      if (rc != CDD_C_SUCCESS)
+        return rc;
+      continue;
+    }
+    rc = scratch_push(s, c);
+    s->pos++;
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
+}
+
+/**
+ * @brief True if `text` is made of decimal digits only (and is non-empty).
+ */
+static int yaml_all_digits(const char *text) {
+  if (!*text)
+    return 0;
+  for (; *text; ++text)
+    if (*text < '0' || *text > '9')
+      return 0;
+  return 1;
+}
+
+/**
+ * @brief Emits the scratch buffer as a plain scalar, resolving its type with
+ * the YAML 1.2 core schema.
+ */
+static cdd_c_error_t yaml_emit_plain(struct SpecScanner *s, size_t line,
+                                     size_t column) {
+  const char *t = s->scratch;
+  const char *body = t;
+  if (strcmp(t, "~") == 0 || strcmp(t, "null") == 0 ||
+      strcmp(t, "Null") == 0 || strcmp(t, "NULL") == 0)
+    return scan_emit(s, SPEC_EVENT_NULL, line, column);
+  if (strcmp(t, "true") == 0 || strcmp(t, "True") == 0 ||
+      strcmp(t, "TRUE") == 0)
+    return scan_emit_value(s, SPEC_EVENT_BOOLEAN, 0, 1, line, column);
+  if (strcmp(t, "false") == 0 || strcmp(t, "False") == 0 ||
+      strcmp(t, "FALSE") == 0)
+    return scan_emit_value(s, SPEC_EVENT_BOOLEAN, 0, 0, line, column);
+
+  if (t[0] == '0' && (t[1] == 'x' || t[1] == 'o') && t[2]) {
+    int base = t[1] == 'x' ? 16 : 8;
+    char *end = NULL;
+    unsigned long v = strtoul(t + 2, &end, base);
+    if (end && *end == '\0' && t[2] != '-' && t[2] != '+')
+      return scan_emit_value(s, SPEC_EVENT_NUMBER, (double)v, 0, line,
+                             column);
+  }
+
+  if (*body == '-' || *body == '+')
+    body++;
+  {
+    /* [-+]?(\.[0-9]+|[0-9]+(\.[0-9]*)?)([eE][-+]?[0-9]+)? */
+    const char *p = body;
+    size_t int_digits = 0, frac_digits = 0;
+    while (*p >= '0' && *p <= '9') {
+      p++;
+      int_digits++;
+    }
+    if (*p == '.') {
+      p++;
+      while (*p >= '0' && *p <= '9') {
+        p++;
+        frac_digits++;
+      }
+    }
+    if (int_digits + frac_digits > 0 && (int_digits > 0 || frac_digits > 0)) {
+      if (*p == 'e' || *p == 'E') {
+        p++;
+        if (*p == '-' || *p == '+')
+          p++;
+        if (!yaml_all_digits(p))
+          p = NULL;
+        else
+          p += strlen(p);
+      }
+      if (p && *p == '\0')
+        return scan_emit_value(s, SPEC_EVENT_NUMBER, strtod(t, NULL), 0, line,
+                               column);
+    }
+  }
+  return scan_emit(s, SPEC_EVENT_STRING, line, column);
+}
+
+static int yaml_line_has_key(const struct SpecScanner *s);
+
+/**
+ * @brief Reads a block-context plain scalar, folding continuation lines that
+ * are indented deeper than `parent_indent`.
+ */
+static cdd_c_error_t yaml_plain_block(struct SpecScanner *s,
+                                      long parent_indent) {
+  size_t line = s->line;
+  size_t column = scan_col(s) + 1;
+  int multi_line = 0;
+  cdd_c_error_t rc = scratch_reset(s);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+
+  for (;;) {
+    size_t save_pos, save_line, save_line_start, breaks = 0;
+
+    /* One line segment, up to a comment or the line end */
+    while (!yaml_at_eol(s)) {
+      char c = s->buf[s->pos];
+      if (c == '#' && s->pos > s->line_start &&
+          (s->buf[s->pos - 1] == ' ' || s->buf[s->pos - 1] == '\t'))
+        break;
+      rc = scratch_push(s, c);
+      if (rc != CDD_C_SUCCESS)
+        return rc;
+      s->pos++;
+    }
+    scratch_trim_blanks(s);
+    if (!yaml_at_eol(s))
+      break; /* a comment ends the scalar */
+
+    /* Look ahead for a continuation line */
+    save_pos = s->pos;
+    save_line = s->line;
+    save_line_start = s->line_start;
+    for (;;) {
+      while (s->pos < s->len && s->buf[s->pos] != '\n')
+        s->pos++;
+      if (s->pos >= s->len)
+        break;
+      scan_advance(s);
+      breaks++;
+      yaml_skip_spaces(s);
+      if (!yaml_at_eol(s))
+        break;
+    }
+    if (s->pos >= s->len || (long)scan_col(s) <= parent_indent ||
+        s->buf[s->pos] == '#' || yaml_line_has_key(s) ||
+        (scan_col(s) == 0 &&
+         (s->len - s->pos >= 3 && yaml_is_break_or_blank(scan_peek(s, 3)) &&
+          (memcmp(s->buf + s->pos, "---", 3) == 0 ||
+           memcmp(s->buf + s->pos, "...", 3) == 0)))) {
+      s->pos = save_pos;
+      s->line = save_line;
+      s->line_start = save_line_start;
+      break;
+    }
+    multi_line = 1;
+    if (breaks == 1) {
+      rc = scratch_push(s, ' ');
+    } else {
+      while (--breaks > 0 && rc == CDD_C_SUCCESS)
+        rc = scratch_push(s, '\n');
+    }
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
+
+  if (multi_line)
+    return scan_emit(s, SPEC_EVENT_STRING, line, column);
+  return yaml_emit_plain(s, line, column);
+}
+
+/**
+ * @brief Reads a literal (`|`) or folded (`>`) block scalar.
+ */
+static cdd_c_error_t yaml_block_scalar(struct SpecScanner *s,
+                                       long parent_indent) {
+  size_t line = s->line;
+  size_t column = scan_col(s) + 1;
+  int folded = s->buf[s->pos] == '>';
+  int chomp = 0; /* -1 strip, 0 clip, 1 keep */
+  size_t indent = 0;
+  size_t base = parent_indent < 0 ? 0 : (size_t)parent_indent;
+  size_t trailing = 0;
+  int have_content = 0;
+  int prev_more_indented = 0;
+  cdd_c_error_t rc = scratch_reset(s);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+
+  s->pos++;
+  while (!yaml_at_eol(s) && s->buf[s->pos] != ' ' && s->buf[s->pos] != '\t') {
+    char c = s->buf[s->pos];
+    if (c == '-' || c == '+')
+      chomp = c == '-' ? -1 : 1;
+    else if (c >= '1' && c <= '9')
+      indent = base + (size_t)(c - '0');
+    else
+      return scan_fail(s, "invalid block scalar header");
+    s->pos++;
+  }
+  yaml_skip_spaces(s);
+  if (scan_peek(s, 0) == '#')
+    yaml_skip_line(s);
+  if (!yaml_at_eol(s))
+    return scan_fail(s, "unexpected content after block scalar header");
+  while (s->pos < s->len && s->buf[s->pos] != '\n')
+    s->pos++;
+  if (s->pos < s->len)
+    scan_advance(s);
+
+  if (indent == 0) {
+    /* Auto-detect from the first non-empty line */
+    size_t p = s->pos;
+    for (;;) {
+      size_t spaces = 0;
+      while (p < s->len && s->buf[p] == ' ') {
+        p++;
+        spaces++;
+      }
+      if (p < s->len && s->buf[p] == '\r')
+        p++;
+      if (p < s->len && s->buf[p] == '\n') {
+        p++;
+        continue;
+      }
+      indent = spaces;
+      break;
+    }
+    if ((long)indent <= parent_indent)
+      indent = (size_t)-1; /* empty scalar */
+  }
+
+  while (s->pos < s->len) {
+    size_t line_pos = s->pos;
+    size_t spaces = 0;
+    size_t end;
+    while (s->pos < s->len && s->buf[s->pos] == ' ' && spaces < indent) {
+      s->pos++;
+      spaces++;
+    }
+    if (yaml_at_eol(s)) {
+      /* Empty line: part of the scalar's line breaks */
+      while (s->pos < s->len && s->buf[s->pos] != '\n')
+        s->pos++;
+      if (s->pos < s->len)
+        scan_advance(s);
+      trailing++;
+      continue;
+    }
+    if (spaces < indent) {
+      s->pos = line_pos;
+      break;
+    }
+
+    end = s->pos;
+    while (end < s->len && s->buf[end] != '\n')
+      end++;
+    {
+      size_t content_end = end;
+      int more_indented;
+      if (content_end > s->pos && s->buf[content_end - 1] == '\r')
+        content_end--;
+      more_indented = s->buf[s->pos] == ' ' || s->buf[s->pos] == '\t';
+
+      if (have_content) {
+        if (!folded || more_indented || prev_more_indented) {
+          size_t k;
+          for (k = 0; k < trailing && rc == CDD_C_SUCCESS; ++k)
+            rc = scratch_push(s, '\n');
+        } else if (trailing == 1) {
+          rc = scratch_push(s, ' ');
+        } else {
+          size_t k;
+          for (k = 1; k < trailing && rc == CDD_C_SUCCESS; ++k)
+            rc = scratch_push(s, '\n');
+        }
+      } else {
+        /* Leading empty lines are kept as line breaks */
+        size_t k;
+        for (k = 0; k < trailing && rc == CDD_C_SUCCESS; ++k)
+          rc = scratch_push(s, '\n');
+      }
+      if (rc == CDD_C_SUCCESS)
+        rc = scratch_append(s, s->buf + s->pos, content_end - s->pos);
+      if (rc != CDD_C_SUCCESS)
+        return rc;
+      have_content = 1;
+      prev_more_indented = more_indented;
+      trailing = 0;
+    }
+    s->pos = end;
+    if (s->pos < s->len) {
+      scan_advance(s);
+      trailing = 1;
+    }
+  }
+
+  if (chomp == 1) {
+    while (trailing-- > 0 && rc == CDD_C_SUCCESS)
+      rc = scratch_push(s, '\n');
+  } else if (chomp == 0 && have_content && trailing > 0) {
+    rc = scratch_push(s, '\n');
+  }
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  return scan_emit(s, SPEC_EVENT_STRING, line, column);
+}
+
+/**
+ * @brief Skips whitespace, line breaks and comments inside a flow node.
+ */
+static void yaml_flow_skip(struct SpecScanner *s) {
+  while (s->pos < s->len) {
+    char c = s->buf[s->pos];
+    if (c == '#') {
+      yaml_skip_line(s);
+    } else if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+      scan_advance(s);
+    } else {
+      return;
+    }
+  }
+}
+
+/**
+ * @brief True if `c` ends a plain scalar inside a flow collection.
+ */
+static int yaml_flow_indicator(char c) {
+  return c == ',' || c == '[' || c == ']' || c == '{' || c == '}';
+}
+
+/**
+ * @brief Reads a plain scalar inside a flow collection into scratch.
+ */
+static cdd_c_error_t yaml_plain_flow(struct SpecScanner *s) {
+  cdd_c_error_t rc = scratch_reset(s);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  while (s->pos < s->len) {
+    char c = s->buf[s->pos];
+    if (yaml_flow_indicator(c))
+      break;
+    if (c == ':' && (yaml_is_break_or_blank(scan_peek(s, 1)) ||
+                     yaml_flow_indicator(scan_peek(s, 1))))
+      break;
+    if (c == '#' && s->pos > 0 &&
+        (s->buf[s->pos - 1] == ' ' || s->buf[s->pos - 1] == '\t'))
+      break;
+    if (c == '\n' || c == '\r') {
+      scratch_trim_blanks(s);
+      yaml_flow_skip(s);
+      if (s->pos < s->len && !yaml_flow_indicator(s->buf[s->pos]) &&
+          s->buf[s->pos] != ':' && s->buf[s->pos] != '#')
+        rc = scratch_push(s, ' ');
+      if (rc != CDD_C_SUCCESS)
+        return rc;
+      continue;
+    }
+    rc = scratch_push(s, c);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    s->pos++;
+  }
+  scratch_trim_blanks(s);
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Reads one node inside (or starting) a flow collection.
+ */
+static cdd_c_error_t yaml_flow_node(struct SpecScanner *s) {
+  size_t line = s->line;
+  size_t column = scan_col(s) + 1;
+  char c = scan_peek(s, 0);
+  cdd_c_error_t rc = yaml_check_indicator(s);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+
+  if (c == '[' || c == '{') {
+    char close = c == '[' ? ']' : '}';
+    rc = scratch_reset(s);
+    if (rc == CDD_C_SUCCESS)
+      rc = scan_enter(s,
+                      c == '[' ? SPEC_EVENT_BEGIN_ARRAY
+                               : SPEC_EVENT_BEGIN_OBJECT,
+                      line, column);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    s->pos++;
+    for (;;) {
+      yaml_flow_skip(s);
+      if (s->pos >= s->len)
+        return scan_fail_at(s, line, column, "unterminated flow collection");
+      if (s->buf[s->pos] == close) {
+        s->pos++;
+        break;
+      }
+      if (c == '{') {
+        size_t key_line = s->line;
+        size_t key_column = scan_col(s) + 1;
+        rc = yaml_check_indicator(s);
+        if (rc != CDD_C_SUCCESS)
+          return rc;
+        if (s->buf[s->pos] == '"')
+          rc = yaml_double_quoted(s);
+        else if (s->buf[s->pos] == '\'')
+          rc = yaml_single_quoted(s);
+        else
+          rc = yaml_plain_flow(s);
+        if (rc == CDD_C_SUCCESS)
+          rc = scan_emit(s, SPEC_EVENT_KEY, key_line, key_column);
+        if (rc != CDD_C_SUCCESS)
+          return rc;
+        yaml_flow_skip(s);
+        if (scan_peek(s, 0) == ':') {
+          s->pos++;
+          yaml_flow_skip(s);
+        }
+        if (scan_peek(s, 0) == ',' || scan_peek(s, 0) == '}') {
+          rc = scratch_reset(s);
+          if (rc == CDD_C_SUCCESS)
+            rc = scan_emit(s, SPEC_EVENT_NULL, s->line, scan_col(s) + 1);
+        } else {
+          rc = yaml_flow_node(s);
+        }
+      } else {
+        rc = yaml_flow_node(s);
+      }
+      if (rc != CDD_C_SUCCESS)
+        return rc;
+      yaml_flow_skip(s);
+      if (scan_peek(s, 0) == ',') {
+        s->pos++;
+      } else if (scan_peek(s, 0) != close) {
+        return scan_fail(s, close == ']' ? "expected ',' or ']'"
+                                         : "expected ',' or '}'");
+      }
+    }
+    rc = scratch_reset(s);
+    return rc != CDD_C_SUCCESS
+               ? rc
+               : scan_leave(s,
+                            close == ']' ? SPEC_EVENT_END_ARRAY
+                                         : SPEC_EVENT_END_OBJECT,
+                            s->line, scan_col(s));
+  }
+  if (c == '"' || c == '\'') {
+    rc = c == '"' ? yaml_double_quoted(s) : yaml_single_quoted(s);
+    return rc != CDD_C_SUCCESS ? rc
+                               : scan_emit(s, SPEC_EVENT_STRING, line, column);
+  }
+  if (c == ']' || c == '}' || c == ',')
+    return scan_fail(s, "unexpected flow indicator");
+  rc = yaml_plain_flow(s);
+  return rc != CDD_C_SUCCESS ? rc : yaml_emit_plain(s, line, column);
+}
+
+/**
+ * @brief Requires that only blanks or a comment remain on the line.
+ */
+static cdd_c_error_t yaml_expect_eol(struct SpecScanner *s) {
+  yaml_skip_spaces(s);
+  if (!yaml_at_eol(s) && s->buf[s->pos] != '#')
+    return scan_fail(s, "unexpected content after value");
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief True if the current line holds a `key:` mapping entry.
+ */
+static int yaml_line_has_key(const struct SpecScanner *s) {
+  size_t p = s->pos;
+  char c = scan_peek(s, 0);
+  if (c == '"' || c == '\'') {
+    p++;
+    while (p < s->len && s->buf[p] != '\n') {
+      if (c == '"' && s->buf[p] == '\\') {
+        p += 2;
+        continue;
+      }
+      if (s->buf[p] == c) {
+        if (c == '\'' && p + 1 < s->len && s->buf[p + 1] == '\'') {
+          p += 2;
+          continue;
+        }
+        break;
+      }
+      p++;
+    }
+    if (p >= s->len || s->buf[p] != c)
+      return 0;
+    p++;
+    while (p < s->len && (s->buf[p] == ' ' || s->buf[p] == '\t'))
+      p++;
+    return p < s->len && s->buf[p] == ':' &&
+           yaml_is_break_or_blank(p + 1 < s->len ? s->buf[p + 1] : '\0');
+  }
+  if (c == '[' || c == '{' || c == '|' || c == '>')
+    return 0;
+  for (; p < s->len && s->buf[p] != '\n'; ++p) {
+    if (s->buf[p] == '#' && p > s->pos &&
+        (s->buf[p - 1] == ' ' || s->buf[p - 1] == '\t'))
+      return 0;
+    if (s->buf[p] == ':' &&
+        yaml_is_break_or_blank(p + 1 < s->len ? s->buf[p + 1] : '\0'))
+      return 1;
+  }
+  return 0;
+}
+
+static cdd_c_error_t yaml_block_node(struct SpecScanner *s,
+                                     long parent_indent);
+
+/**
+ * @brief Reads a scalar or flow collection starting on the current line.
+ */
+static cdd_c_error_t yaml_inline_value(struct SpecScanner *s,
+                                       long parent_indent) {
+  size_t line = s->line;
+  size_t column = scan_col(s) + 1;
+  char c = scan_peek(s, 0);
+  cdd_c_error_t rc = yaml_check_indicator(s);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  switch (c) {
+  case '"':
+  case '\'':
+    rc = c == '"' ? yaml_double_quoted(s) : yaml_single_quoted(s);
+    if (rc == CDD_C_SUCCESS)
+      rc = scan_emit(s, SPEC_EVENT_STRING, line, column);
+    return rc != CDD_C_SUCCESS ? rc : yaml_expect_eol(s);
+  case '[':
+  case '{':
+    rc = yaml_flow_node(s);
+    return rc != CDD_C_SUCCESS ? rc : yaml_expect_eol(s);
+  case '|':
+  case '>':
+    return yaml_block_scalar(s, parent_indent);
+  default:
+    return yaml_plain_block(s, parent_indent);
+  }
+}
+
+/**
+ * @brief Reads a block sequence whose `-` entries sit at column `indent`.
+ */
+static cdd_c_error_t yaml_block_seq(struct SpecScanner *s, size_t indent) {
+  cdd_c_error_t rc = scratch_reset(s);
+  if (rc == CDD_C_SUCCESS)
+    rc = scan_enter(s, SPEC_EVENT_BEGIN_ARRAY, s->line, indent + 1);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+
+  for (;;) {
+    s->pos++; /* '-' */
+    yaml_skip_spaces(s);
+    if (yaml_at_eol(s) || s->buf[s->pos] == '#') {
+      yaml_skip_blank(s);
+      if (s->pos >= s->len || scan_col(s) <= indent) {
+        rc = scratch_reset(s);
+        if (rc == CDD_C_SUCCESS)
+          rc = scan_emit(s, SPEC_EVENT_NULL, s->line, scan_col(s) + 1);
+      } else {
+        rc = yaml_block_node(s, (long)indent);
+      }
+    } else {
+      rc = yaml_block_node(s, (long)indent);
+    }
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+
+    yaml_skip_blank(s);
+    if (s->pos >= s->len || scan_col(s) < indent)
+      break;
+    if (scan_col(s) > indent)
+      return scan_fail(s, "unexpected indentation");
+    if (s->buf[s->pos] != '-' || !yaml_is_break_or_blank(scan_peek(s, 1)))
+      break;
+  }
+  rc = scratch_reset(s);
+  return rc != CDD_C_SUCCESS
+             ? rc
+             : scan_leave(s, SPEC_EVENT_END_ARRAY, s->line, scan_col(s) + 1);
+}
+
+/**
+ * @brief Reads a block mapping whose keys sit at column `indent`.
+ */
+static cdd_c_error_t yaml_block_map(struct SpecScanner *s, size_t indent) {
+  cdd_c_error_t rc = scratch_reset(s);
+  if (rc == CDD_C_SUCCESS)
+    rc = scan_enter(s, SPEC_EVENT_BEGIN_OBJECT, s->line, indent + 1);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+
+  for (;;) {
+    size_t key_line = s->line;
+    size_t key_column = scan_col(s) + 1;
+    char c = scan_peek(s, 0);
+
+    rc = yaml_check_indicator(s);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    if (!yaml_line_has_key(s))
+      return scan_fail(s, "expected a mapping key");
+    if (c == '"')
+      rc = yaml_double_quoted(s);
+    else if (c == '\'')
+      rc = yaml_single_quoted(s);
+    else {
+      rc = scratch_reset(s);
+      while (rc == CDD_C_SUCCESS && !(s->buf[s->pos] == ':' &&
+                                      yaml_is_break_or_blank(scan_peek(s, 1)))) {
+        rc = scratch_push(s, s->buf[s->pos]);
+        s->pos++;
+      }
+      scratch_trim_blanks(s);
+    }
+    if (rc == CDD_C_SUCCESS)
+      rc = scan_emit(s, SPEC_EVENT_KEY, key_line, key_column);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    yaml_skip_spaces(s);
+    if (scan_peek(s, 0) != ':')
+      return scan_fail(s, "expected ':' after key");
+    s->pos++;
+    yaml_skip_spaces(s);
+
+    if (yaml_at_eol(s) || s->buf[s->pos] == '#') {
+      /* Value on the following lines */
+      yaml_skip_blank(s);
+      if (s->pos < s->len && scan_col(s) > indent) {
+        rc = yaml_block_node(s, (long)indent);
+      } else if (s->pos < s->len && scan_col(s) == indent &&
+                 s->buf[s->pos] == '-' &&
+                 yaml_is_break_or_blank(scan_peek(s, 1))) {
+        rc = yaml_block_seq(s, indent);
+      } else {
+        rc = scratch_reset(s);
+        if (rc == CDD_C_SUCCESS)
+          rc = scan_emit(s, SPEC_EVENT_NULL, key_line, key_column);
+      }
+    } else {
+      rc = yaml_inline_value(s, (long)indent);
+    }
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+
+    yaml_skip_blank(s);
+    if (s->pos >= s->len || scan_col(s) < indent)
+      break;
+    if (scan_col(s) > indent)
+      return scan_fail(s, "unexpected indentation");
+  }
+  rc = scratch_reset(s);
+  return rc != CDD_C_SUCCESS
+             ? rc
+             : scan_leave(s, SPEC_EVENT_END_OBJECT, s->line, scan_col(s) + 1);
+}
+
+/**
+ * @brief Reads the node starting at the current content byte.
+ */
+static cdd_c_error_t yaml_block_node(struct SpecScanner *s,
+                                     long parent_indent) {
+  cdd_c_error_t rc = yaml_check_indicator(s);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  if (s->buf[s->pos] == '-' && yaml_is_break_or_blank(scan_peek(s, 1)))
+    return yaml_block_seq(s, scan_col(s));
+  if (yaml_line_has_key(s))
+    return yaml_block_map(s, scan_col(s));
+  return yaml_inline_value(s, parent_indent);
+}
+
+/**
+ * @brief Scans a whole YAML document.
+ */
+static cdd_c_error_t yaml_document(struct SpecScanner *s) {
+  cdd_c_error_t rc;
+  yaml_skip_blank(s);
+  if (s->pos >= s->len) {
+    rc = scratch_reset(s);
+    return rc != CDD_C_SUCCESS ? rc
+                               : scan_emit(s, SPEC_EVENT_NULL, s->line, 1);
+  }
+  if (s->buf[s->pos] == '\t')
+    return scan_fail(s, "tabs are not allowed for indentation");
+  rc = yaml_block_node(s, -1);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  yaml_skip_blank(s);
+  if (s->pos < s->len)
+    return scan_fail(s, "unexpected content after document");
+  return CDD_C_SUCCESS;
+}
+
+/* --- Public API --- */
+
+/**
+ * @brief Scans a buffer, reporting events.
+ */
+cdd_c_error_t spec_reader_scan(const char *data, size_t len,
+                               enum SpecFormat format, spec_event_cb cb,
+                               void *user_data, struct SpecReadError *err) {
+  struct SpecScanner s;
+  cdd_c_error_t rc;
+
+  if ((!data && len) || !cb)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (err) {
+    err->line = 0;
+    err->column = 0;
+    err->message[0] = '\0';
+  }
+
+  memset(&s, 0, sizeof(s));
+  s.buf = data ? data : "";
+  s.len = len;
+  s.line = 1;
+  s.cb = cb;
+  s.user_data = user_data;
+  s.err = err;
+
+  /* UTF-8 byte order mark */
+  if (len >= 3 && (unsigned char)data[0] == 0xEF &&
+      (unsigned char)data[1] == 0xBB && (unsigned char)data[2] == 0xBF) {
+    s.pos = 3;
+    s.line_start = 3;
+  }
+
+  if (format == SPEC_FORMAT_AUTO) {
+    size_t p = s.pos;
+    while (p < len && (data[p] == ' ' || data[p] == '\t' || data[p] == '\r' ||
+                       data[p] == '\n'))
+      p++;
+    format = (p < len && (data[p] == '{' || data[p] == '[')) ? SPEC_FORMAT_JSON
+                                                             : SPEC_FORMAT_YAML;
+  }
+
+  rc = format == SPEC_FORMAT_JSON ? json_document(&s) : yaml_document(&s);
+  if (s.scratch)
+    C_CDD_FREE(s.scratch);
+  return rc;
+}
+
+/**
+ * @brief Event sink building a parson value.
+ */
+struct SpecDomBuilder {
+  JSON_Value *root;          /**< Finished document */
+  JSON_Value **stack;        /**< Open containers */
+  size_t n_stack;            /**< Depth of `stack` */
+  size_t cap_stack;          /**< Capacity of `stack` */
+  char *key;                 /**< Pending key in the innermost object */
+  struct SpecReadError *err; /**< Optional failure report */
+};
+
+/**
+ * @brief Records a builder failure at an event's location.
+ */
+static cdd_c_error_t dom_fail(struct SpecDomBuilder *b,
+                              const struct SpecEvent *ev, const char *msg,
+                              cdd_c_error_t rc) {
+  if (b->err) {
+    b->err->line = ev->line;
+    b->err->column = ev->column;
+    CDD_SNPRINTF(b->err->message, sizeof(b->err->message), "%s", msg);
+  }
+  return rc;
+}
+
+/**
+ * @brief Attaches a new value to the innermost container.
+ */
+static cdd_c_error_t dom_attach(struct SpecDomBuilder *b, JSON_Value *val,
+                                const struct SpecEvent *ev) {
+  JSON_Value *top;
+  JSON_Status status;
+
+  if (b->n_stack == 0) {
+    b->root = val;
+    return CDD_C_SUCCESS;
+  }
+  top = b->stack[b->n_stack - 1];
+  if (json_value_get_type(top) == JSONObject) {
+    status = b->key ? json_object_set_value(json_value_get_object(top),
+                                            b->key, val)
+                    : JSONFailure;
+    C_CDD_FREE(b->key);
+    b->key = NULL;
+  } else {
+    status = json_array_append_value(json_value_get_array(top), val);
+  }
+  if (status != JSONSuccess) {
+    json_value_free(val);
+    return dom_fail(b, ev, "out of memory", CDD_C_ERROR_MEMORY);
+  }
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Builds parson values from reader events.
+ */
+static cdd_c_error_t dom_event(void *user_data, const struct SpecEvent *ev) {
+  struct SpecDomBuilder *b = (struct SpecDomBuilder *)user_data;
+  JSON_Value *val = NULL;
+  cdd_c_error_t rc;
+
+  switch (ev->kind) {
+  case SPEC_EVENT_KEY: {
+    JSON_Object *obj = json_value_get_object(b->stack[b->n_stack - 1]);
+    if (json_object_get_value(obj, ev->text))
+      return dom_fail(b, ev, "duplicate key", CDD_C_ERROR_PARSE);
+    b->key = (char *)C_CDD_MALLOC(ev->len + 1);
+    if (!b->key)
+      return dom_fail(b, ev, "out of memory", CDD_C_ERROR_MEMORY);
+    memcpy(b->key, ev->text, ev->len + 1);
+    return CDD_C_SUCCESS;
+  }
+  case SPEC_EVENT_END_OBJECT:
+  case SPEC_EVENT_END_ARRAY:
+    b->n_stack--;
+    return CDD_C_SUCCESS;
+  case SPEC_EVENT_BEGIN_OBJECT:
+    val = json_value_init_object();
+    break;
+  case SPEC_EVENT_BEGIN_ARRAY:
+    val = json_value_init_array();
+    break;
+  case SPEC_EVENT_STRING:
+    val = json_value_init_string_with_len(ev->text, ev->len);
+    if (!val)
+      return dom_fail(b, ev, "invalid UTF-8 in string", CDD_C_ERROR_PARSE);
+    break;
+  case SPEC_EVENT_NUMBER:
+    val = json_value_init_number(ev->number);
+    break;
+  case SPEC_EVENT_BOOLEAN:
+    val = json_value_init_boolean(ev->boolean);
+    break;
+  case SPEC_EVENT_NULL:
+    val = json_value_init_null();
+    break;
+  }
+  if (!val)
+    return dom_fail(b, ev, "out of memory", CDD_C_ERROR_MEMORY);
+
+  rc = dom_attach(b, val, ev);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  if (ev->kind == SPEC_EVENT_BEGIN_OBJECT ||
+      ev->kind == SPEC_EVENT_BEGIN_ARRAY) {
+    if (b->n_stack == b->cap_stack) {
+      size_t cap = b->cap_stack ? b->cap_stack * 2 : 16;
+      JSON_Value **grown =
+          (JSON_Value **)C_CDD_REALLOC(b->stack, cap * sizeof(JSON_Value *));
+      if (!grown)
+        return dom_fail(b, ev, "out of memory", CDD_C_ERROR_MEMORY);
+      b->stack = grown;
+      b->cap_stack = cap;
+    }
+    b->stack[b->n_stack++] = val;
+  }
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Parses a buffer into a parson value.
+ */
+cdd_c_error_t spec_reader_parse(const char *data, size_t len,
+                                enum SpecFormat format, JSON_Value **out,
+                                struct SpecReadError *err) {
+  struct SpecDomBuilder b;
+  cdd_c_error_t rc;
+
+  if (!out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out = NULL;
+  memset(&b, 0, sizeof(b));
+  b.err = err;
+
+  rc = spec_reader_scan(data, len, format, dom_event, &b, err);
+  if (b.key)
+    C_CDD_FREE(b.key);
+  if (b.stack)
+    C_CDD_FREE(b.stack);
+  if (rc != CDD_C_SUCCESS) {
+    json_value_free(b.root);
+    return rc;
+  }
+  *out = b.root;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Picks the syntax from a file name.
+ */
+enum SpecFormat spec_format_for_path(const char *path) {
+  const char *dot = path ? strrchr(path, '.') : NULL;
+  if (!dot)
+    return SPEC_FORMAT_AUTO;
+  if (strcmp(dot, ".yaml") == 0 || strcmp(dot, ".yml") == 0 ||
+      strcmp(dot, ".YAML") == 0 || strcmp(dot, ".YML") == 0)
+    return SPEC_FORMAT_YAML;
+  if (strcmp(dot, ".json") == 0 || strcmp(dot, ".JSON") == 0)
+    return SPEC_FORMAT_JSON;
+  return SPEC_FORMAT_AUTO;
+}
+
+/**
+ * @brief Maps and parses a file.
+ */
+cdd_c_error_t spec_reader_parse_file(const char *path, JSON_Value **out,
+                                     struct SpecReadError *err) {
+  struct FsMappedFile file;
+  cdd_c_error_t rc;
+
+  if (!path || !out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out = NULL;
+  if (err) {
+    err->line = 0;
+    err->column = 0;
+    err->message[0] = '\0';
+  }
+
+  rc = fs_map_file(path, &file);
+  if (rc != CDD_C_SUCCESS) {
+    if (err)
+      CDD_SNPRINTF(err->message, sizeof(err->message), "cannot read file");
+    return rc;
+  }
+  rc = spec_reader_parse(file.data, file.size, spec_format_for_path(path), out,
+                         err);
+  fs_unmap_file(&file);
+  return rc;
+}
+
+/**
+ * @brief Event sink loading `paths` and `webhooks` one Path Item at a time.
+ *
+ * Pass 0 builds the document without the Path Item values (their keys are
+ * dropped, `x-` members kept), so everything else, components included,
+ * loads as usual. Pass 1 rebuilds each Path Item on its own, parses it into
+ * the spec and frees it: at most one Path Item DOM is alive next to the IR.
+ */
+struct SpecSplitLoader {
+  struct SpecDomBuilder dom; /**< Skeleton (pass 0) or current Path Item */
+  struct OpenAPI_Spec *spec; /**< Spec being filled (pass 1) */
+  int pass;                  /**< 0 skeleton, 1 Path Items */
+  size_t depth;              /**< Open containers in the event stream */
+  int section;     /**< 1 inside `paths`, 2 inside `webhooks`, else 0 */
+  int in_item;     /**< 1 while a Path Item value is being read */
+  char *route;     /**< Key of the Path Item being read (pass 1) */
+  size_t n_items[2];        /**< Path Items per section (pass 0) */
+  JSON_Value *seen[2];      /**< Keys per section, for duplicates (pass 0) */
+  struct SpecEvent item_ev; /**< Location of the current Path Item key */
+};
+
+/**
+ * @brief Hands a finished Path Item to the spec.
+ */
+static cdd_c_error_t split_add_item(struct SpecSplitLoader *l) {
+  int webhook = l->section == 2;
+  struct OpenAPI_Path *paths = webhook ? l->spec->webhooks : l->spec->paths;
+  size_t *n = webhook ? &l->spec->n_webhooks : &l->spec->n_paths;
+  JSON_Value *item = l->dom.root;
+  cdd_c_error_t rc;
+
+  l->dom.root = NULL;
+  if (*n >= l->n_items[webhook]) {
+    json_value_free(item);
+    return dom_fail(&l->dom, &l->item_ev, "document changed while reading",
+                    CDD_C_ERROR_PARSE);
+  }
+  /* Counted first so a partial parse is released with the spec */
+  rc = openapi_parse_path_item(l->spec, webhook, l->route, item,
+                               &paths[(*n)++]);
+  C_CDD_FREE(l->route);
+  l->route = NULL;
+  if (rc != CDD_C_SUCCESS)
+    return dom_fail(&l->dom, &l->item_ev, "invalid path item", rc);
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Splits reader events between the skeleton and the Path Items.
+ */
+static cdd_c_error_t split_event(void *user_data, const struct SpecEvent *ev) {
+  struct SpecSplitLoader *l = (struct SpecSplitLoader *)user_data;
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+
+  if (l->in_item) {
+    if (l->pass == 1)
+      rc = dom_event(&l->dom, ev);
+    if (ev->kind == SPEC_EVENT_BEGIN_OBJECT ||
+        ev->kind == SPEC_EVENT_BEGIN_ARRAY)
+      l->depth++;
+    else if (ev->kind == SPEC_EVENT_END_OBJECT ||
+             ev->kind == SPEC_EVENT_END_ARRAY)
+      l->depth--;
+    if (rc == CDD_C_SUCCESS && l->depth == 2 && ev->kind != SPEC_EVENT_KEY) {
+      l->in_item = 0;
+      if (l->pass == 1)
+        rc = split_add_item(l);
+    }
+    return rc;
+  }
+
+  if (ev->kind == SPEC_EVENT_KEY && l->depth == 1) {
+    l->section = strcmp(ev->text, "paths") == 0      ? 1
+                 : strcmp(ev->text, "webhooks") == 0 ? 2
+                                                     : 0;
+  } else if (ev->kind == SPEC_EVENT_KEY && l->depth == 2 && l->section &&
+             strncmp(ev->text, "x-", 2) != 0) {
+    l->in_item = 1;
+    l->item_ev = *ev;
+    l->item_ev.text = NULL;
+    if (l->pass == 0) {
+      JSON_Value **seen = &l->seen[l->section - 1];
+      if (!*seen && !(*seen = json_value_init_object()))
+        return dom_fail(&l->dom, ev, "out of memory", CDD_C_ERROR_MEMORY);
+      if (json_object_get_value(json_value_get_object(*seen), ev->text))
+        return dom_fail(&l->dom, ev, "duplicate key", CDD_C_ERROR_PARSE);
+      if (json_object_set_null(json_value_get_object(*seen), ev->text) !=
+          JSONSuccess)
+        return dom_fail(&l->dom, ev, "out of memory", CDD_C_ERROR_MEMORY);
+      l->n_items[l->section - 1]++;
+      return CDD_C_SUCCESS;
+    }
+    l->route = (char *)C_CDD_MALLOC(ev->len + 1);
+    if (!l->route)
+      return dom_fail(&l->dom, ev, "out of memory", CDD_C_ERROR_MEMORY);
+    memcpy(l->route, ev->text, ev->len + 1);
+    l->dom.n_stack = 0;
+    return CDD_C_SUCCESS;
+  }
+
+  if (ev->kind == SPEC_EVENT_BEGIN_OBJECT ||
+      ev->kind == SPEC_EVENT_BEGIN_ARRAY)
+    l->depth++;
+  else if (ev->kind == SPEC_EVENT_END_OBJECT ||
+           ev->kind == SPEC_EVENT_END_ARRAY)
+    l->depth--;
+  return l->pass == 0 ? dom_event(&l->dom, ev) : CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Releases a split loader's buffers (not the spec).
+ */
+static void split_loader_free(struct SpecSplitLoader *l) {
+  if (l->dom.key)
+    C_CDD_FREE(l->dom.key);
+  if (l->dom.stack)
+    C_CDD_FREE(l->dom.stack);
+  if (l->dom.root)
+    json_value_free(l->dom.root);
+  if (l->route)
+    C_CDD_FREE(l->route);
+  if (l->seen[0])
+    json_value_free(l->seen[0]);
+  if (l->seen[1])
+    json_value_free(l->seen[1]);
+}
+
+/**
+ * @brief Loads a mapped OpenAPI document, streaming its Path Items.
+ */
+static cdd_c_error_t split_load(const char *data, size_t len,
+                                enum SpecFormat format,
+                                struct OpenAPI_Spec *out,
+                                struct SpecReadError *err) {
+  struct SpecSplitLoader l;
+  const JSON_Object *root_obj;
+  cdd_c_error_t rc;
+
+  memset(&l, 0, sizeof(l));
+  l.dom.err = err;
+  rc = spec_reader_scan(data, len, format, split_event, &l, err);
+  if (rc != CDD_C_SUCCESS) {
+    split_loader_free(&l);
+    return rc;
+  }
+
+  root_obj = json_value_get_object(l.dom.root);
+  if (!json_object_get_string(root_obj, "openapi") &&
+      !json_object_get_string(root_obj, "swagger")) {
+    /* A Schema document: `paths` is not special, load it whole */
+    split_loader_free(&l);
+    memset(&l, 0, sizeof(l));
+    l.dom.err = err;
+    rc = spec_reader_scan(data, len, format, dom_event, &l.dom, err);
+    if (rc == CDD_C_SUCCESS)
+      rc = openapi_load_from_json(l.dom.root, out);
+    split_loader_free(&l);
+    return rc;
+  }
+
+  rc = openapi_load_from_json(l.dom.root, out);
+  json_value_free(l.dom.root);
+  l.dom.root = NULL;
+  if (rc != CDD_C_SUCCESS) {
+    split_loader_free(&l);
+    return rc;
+  }
+
+  if (l.n_items[0] > 0 && !out->paths) {
+    out->paths = (struct OpenAPI_Path *)C_CDD_CALLOC(
+        l.n_items[0], sizeof(struct OpenAPI_Path));
+    if (!out->paths)
+      rc = CDD_C_ERROR_MEMORY;
+  }
+  if (rc == CDD_C_SUCCESS && l.n_items[1] > 0 && !out->webhooks) {
+    out->webhooks = (struct OpenAPI_Path *)C_CDD_CALLOC(
+        l.n_items[1], sizeof(struct OpenAPI_Path));
+    if (!out->webhooks)
+      rc = CDD_C_ERROR_MEMORY;
+  }
+  if (rc == CDD_C_SUCCESS) {
+    l.pass = 1;
+    l.depth = 0;
+    l.section = 0;
+    rc = spec_reader_scan(data, len, format, split_event, &l, err);
+  }
+  if (rc == CDD_C_SUCCESS)
+    rc = openapi_spec_finish_paths(out);
+  split_loader_free(&l);
+  if (rc != CDD_C_SUCCESS)
+    openapi_spec_free(out);
+  return rc;
+}
+
+/**
+ * @brief Loads an OpenAPI document from a file.
+ */
+cdd_c_error_t spec_reader_load_file(const char *path, struct OpenAPI_Spec *out,
+                                    struct SpecReadError *err) {
+  struct FsMappedFile file;
+  cdd_c_error_t rc;
+
+  if (!path || !out)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  if (err) {
+    err->line = 0;
+    err->column = 0;
+    err->message[0] = '\0';
+  }
+
+  rc = fs_map_file(path, &file);
+  if (rc != CDD_C_SUCCESS) {
+    if (err)
+      CDD_SNPRINTF(err->message, sizeof(err->message), "cannot read file");
+    return rc;
+  }
+  rc = split_load(file.data, file.size, spec_format_for_path(path), out, err);
+  fs_unmap_file(&file);
+  return rc;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file spec_reader.h
+ * @brief Event-driven JSON and YAML reader for OpenAPI documents.
+ *
+ * The scanners walk a length-bounded buffer (typically a read-only mapping of
+ * the spec file) and report SAX-style events with 1-based source positions,
+ * so syntax errors can be reported as `file:line:column`. YAML input covers
+ * the block and flow styles used by OpenAPI documents: mappings, sequences,
+ * plain/quoted scalars, literal and folded block scalars, and comments.
+ * Anchors, aliases, tags and multi-document streams are rejected.
+ *
+ * @author Samuel Marks
+ */
+
+#ifndef C_CDD_SPEC_READER_H
+#define C_CDD_SPEC_READER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include <stddef.h>
+
+#include <parson.h>
+
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+#include "openapi/parse/openapi.h"
+/* clang-format on */
+
+/** @brief Deepest container nesting accepted (matches parson's limit). */
+#define SPEC_READER_MAX_DEPTH 2048
+
+/**
+ * @brief Input syntax.
+ */
+enum SpecFormat {
+  SPEC_FORMAT_AUTO = 0, /**< JSON if the text starts with `{` or `[` */
+  SPEC_FORMAT_JSON,     /**< Strict JSON */
+  SPEC_FORMAT_YAML      /**< YAML 1.2 (subset, see file comment) */
+};
+
+/**
+ * @brief Kind of a reader event.
+ */
+enum SpecEventKind {
+  SPEC_EVENT_BEGIN_OBJECT, /**< Start of a mapping */
+  SPEC_EVENT_END_OBJECT,   /**< End of a mapping */
+  SPEC_EVENT_BEGIN_ARRAY,  /**< Start of a sequence */
+  SPEC_EVENT_END_ARRAY,    /**< End of a sequence */
+  SPEC_EVENT_KEY,          /**< Mapping key; the value follows */
+  SPEC_EVENT_STRING,       /**< String scalar */
+  SPEC_EVENT_NUMBER,       /**< Numeric scalar */
+  SPEC_EVENT_BOOLEAN,      /**< Boolean scalar */
+  SPEC_EVENT_NULL          /**< Null scalar */
+};
+
+/**
+ * @brief A single reader event.
+ *
+ * `text` is only valid for the duration of the callback.
+ */
+struct SpecEvent {
+  enum SpecEventKind kind; /**< What was read */
+  const char *text;        /**< KEY/STRING text, NUL-terminated */
+  size_t len;              /**< Length of `text` in bytes */
+  double number;           /**< NUMBER value */
+  int boolean;             /**< BOOLEAN value */
+  size_t line;             /**< 1-based line of the token */
+  size_t column;           /**< 1-based column of the token */
+};
+
+/**
+ * @brief Event callback.
+ *
+ * @param[in] user_data Opaque pointer given to the scanner.
+ * @param[in] event The event.
+ * @return 0 to continue, or an error code to abort the scan.
+ */
+typedef cdd_c_error_t (*spec_event_cb)(void *user_data,
+                                       const struct SpecEvent *event);
+
+/**
+ * @brief Location and description of a read failure.
+ */
+struct SpecReadError {
+  size_t line;       /**< 1-based line, or 0 if not positional */
+  size_t column;     /**< 1-based column, or 0 if not positional */
+  char message[128]; /**< Human-readable reason */
+};
+
+/**
+ * @brief Scan a buffer, reporting events to a callback.
+ *
+ * @param[in] data Input bytes (need not be NUL-terminated).
+ * @param[in] len Length of `data`.
+ * @param[in] format Input syntax.
+ * @param[in] cb Event callback.
+ * @param[in] user_data Passed to `cb`.
+ * @param[out] err Optional; receives the failure location.
+ * @return 0 on success, CDD_C_ERROR_PARSE on a syntax error, or the error
+ * returned by `cb`.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+spec_reader_scan(const char *data, size_t len, enum SpecFormat format,
+                 spec_event_cb cb, void *user_data, struct SpecReadError *err);
+
+/**
+ * @brief Parse a buffer into a parson value.
+ *
+ * @param[in] data Input bytes (need not be NUL-terminated).
+ * @param[in] len Length of `data`.
+ * @param[in] format Input syntax.
+ * @param[out] out Receives the value, which the caller frees.
+ * @param[out] err Optional; receives the failure location.
+ * @return 0 on success, error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+spec_reader_parse(const char *data, size_t len, enum SpecFormat format,
+                  JSON_Value **out, struct SpecReadError *err);
+
+/**
+ * @brief Pick the syntax from a file name.
+ *
+ * @param[in] path File name.
+ * @return SPEC_FORMAT_YAML for `.yaml`/`.yml`, SPEC_FORMAT_JSON for `.json`,
+ * SPEC_FORMAT_AUTO otherwise.
+ */
+extern C_CDD_EXPORT enum SpecFormat spec_format_for_path(const char *path);
+
+/**
+ * @brief Map a JSON or YAML file and parse it into a parson value.
+ *
+ * `.yaml`/`.yml` files are read as YAML, `.json` files as JSON, anything else
+ * is detected from its content.
+ *
+ * @param[in] path File to read.
+ * @param[out] out Receives the value, which the caller frees.
+ * @param[out] err Optional; receives the failure location.
+ * @return 0 on success, error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t spec_reader_parse_file(
+    const char *path, JSON_Value **out, struct SpecReadError *err);
+
+/**
+ * @brief Load an OpenAPI document from a JSON or YAML file.
+ *
+ * The mapped file is scanned twice: once for everything but the Path Items
+ * under `paths` and `webhooks`, then once more building, loading and
+ * freeing each Path Item in turn, so the full document is never held as a
+ * parson tree next to the loaded spec.
+ *
+ * @param[in] path File to read.
+ * @param[out] out Initialized spec to populate.
+ * @param[out] err Optional; receives the failure location.
+ * @return 0 on success, error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t spec_reader_load_file(
+    const char *path, struct OpenAPI_Spec *out, struct SpecReadError *err);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* C_CDD_SPEC_READER_H */
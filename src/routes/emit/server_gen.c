@@ -8,6 +8,7 @@
 #include "c_cdd/memory.h"
 #include "server_gen.h"
 #include "routes/emit/security.h"
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -21,6 +22,1025 @@
 #define SNPRINTF snprintf
 #endif
 
+/**
+ * @brief Sentinel for "no node" in the route trie's index links.
+ */
+#define ROUTE_TRIE_NONE ((size_t)-1)
+
+/**
+ * @brief An operation terminating at a route trie node.
+ */
+struct RouteTrieLeaf {
+  const struct OpenAPI_Operation *op; /**< Operation served here */
+  char **param_names;                 /**< Template parameter names */
+  size_t n_param_names;               /**< Count of template parameters */
+};
+
+/**
+ * @brief One path segment in the generation-time route trie.
+ *
+ * Literal segments compare by length then content; template segments
+ * (`{name}`, optionally with a literal prefix/suffix such as `{id}.json`)
+ * capture the variable part as a span.
+ */
+struct RouteTrieNode {
+  char *literal;                /**< Literal segment, or template prefix */
+  size_t literal_len;           /**< Length of `literal` */
+  char *suffix;                 /**< Template suffix (param nodes only) */
+  size_t suffix_len;            /**< Length of `suffix` */
+  int is_param;                 /**< 1 if this segment captures a param */
+  size_t first_child;           /**< First child, or ROUTE_TRIE_NONE */
+  size_t next_sibling;          /**< Next sibling, or ROUTE_TRIE_NONE */
+  struct RouteTrieLeaf *leaves; /**< Operations ending at this node */
+  size_t n_leaves;              /**< Count of leaves */
+};
+
+/**
+ * @brief Growable, index-linked route trie built from `spec->paths`.
+ */
+struct RouteTrie {
+  struct RouteTrieNode *nodes; /**< Node storage; node 0 is the root */
+  size_t n_nodes;              /**< Number of nodes in use */
+  size_t capacity;             /**< Allocated node slots */
+  size_t max_params;           /**< Deepest parameter count of any route */
+};
+
+/**
+ * @brief Map an operation to its HTTP method token.
+ */
+static const char *server_op_method(const struct OpenAPI_Operation *op) {
+  if (op->is_additional && op->method)
+    return op->method;
+  switch (op->verb) {
+  case OA_VERB_POST:
+    return "POST";
+  case OA_VERB_PUT:
+    return "PUT";
+  case OA_VERB_DELETE:
+    return "DELETE";
+  case OA_VERB_OPTIONS:
+    return "OPTIONS";
+  case OA_VERB_HEAD:
+    return "HEAD";
+  case OA_VERB_PATCH:
+    return "PATCH";
+  case OA_VERB_TRACE:
+    return "TRACE";
+  case OA_VERB_QUERY:
+    return "QUERY";
+  default:
+    return "GET";
+  }
+}
+
+/**
+ * @brief Release every allocation owned by a route trie.
+ */
+static void route_trie_free(struct RouteTrie *trie) {
+  size_t i, j, k;
+  for (i = 0; i < trie->n_nodes; i++) {
+    struct RouteTrieNode *node = &trie->nodes[i];
+    C_CDD_FREE(node->literal);
+    C_CDD_FREE(node->suffix);
+    for (j = 0; j < node->n_leaves; j++) {
+      for (k = 0; k < node->leaves[j].n_param_names; k++)
+        C_CDD_FREE(node->leaves[j].param_names[k]);
+      C_CDD_FREE(node->leaves[j].param_names);
+    }
+    C_CDD_FREE(node->leaves);
+  }
+  C_CDD_FREE(trie->nodes);
+  trie->nodes = NULL;
+  trie->n_nodes = trie->capacity = 0;
+}
+
+/**
+ * @brief Duplicate `len` bytes of `s` into a NUL-terminated heap string.
+ */
+static char *route_strndup(const char *s, size_t len) {
+  char *out = (char *)C_CDD_MALLOC(len + 1);
+  if (!out)
+    return NULL;
+  if (len)
+    memcpy(out, s, len);
+  out[len] = '\0';
+  return out;
+}
+
+/**
+ * @brief Append an empty node, returning its index via `out_idx`.
+ */
+static cdd_c_error_t route_trie_new_node(struct RouteTrie *trie,
+                                         size_t *out_idx) {
+  struct RouteTrieNode *node;
+  if (trie->n_nodes == trie->capacity) {
+    size_t new_cap = trie->capacity ? trie->capacity * 2 : 16;
+    struct RouteTrieNode *grown = (struct RouteTrieNode *)C_CDD_REALLOC(
+        trie->nodes, new_cap * sizeof(*grown));
+    if (!grown)
+      return CDD_C_ERROR_MEMORY;
+    trie->nodes = grown;
+    trie->capacity = new_cap;
+  }
+  node = &trie->nodes[trie->n_nodes];
+  memset(node, 0, sizeof(*node));
+  node->first_child = ROUTE_TRIE_NONE;
+  node->next_sibling = ROUTE_TRIE_NONE;
+  *out_idx = trie->n_nodes++;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Find or create the child of `parent` matching one path segment.
+ *
+ * Template segments are keyed by their literal prefix and suffix so that
+ * `/{id}` and `/{petId}` share a node regardless of the parameter name.
+ */
+static cdd_c_error_t route_trie_child(struct RouteTrie *trie, size_t parent,
+                                      const char *seg, size_t seg_len,
+                                      char **out_param, size_t *out_idx) {
+  const char *open = NULL, *close = NULL;
+  size_t pre_len, suf_len, idx;
+  const char *suf;
+  int is_param;
+  cdd_c_error_t rc;
+
+  *out_param = NULL;
+  for (idx = 0; idx < seg_len; idx++) {
+    if (seg[idx] == '{' && !open)
+      open = seg + idx;
+    else if (seg[idx] == '}')
+      close = seg + idx;
+  }
+  is_param = open && close && close > open;
+  pre_len = is_param ? (size_t)(open - seg) : seg_len;
+  suf = is_param ? close + 1 : seg + seg_len;
+  suf_len = (size_t)(seg + seg_len - suf);
+
+  for (idx = trie->nodes[parent].first_child; idx != ROUTE_TRIE_NONE;
+       idx = trie->nodes[idx].next_sibling) {
+    const struct RouteTrieNode *c = &trie->nodes[idx];
+    if (c->is_param == is_param && c->literal_len == pre_len &&
+        memcmp(c->literal, seg, pre_len) == 0 && c->suffix_len == suf_len &&
+        (suf_len == 0 || memcmp(c->suffix, suf, suf_len) == 0))
+      break;
+  }
+
+  if (idx == ROUTE_TRIE_NONE) {
+    rc = route_trie_new_node(trie, &idx);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+    trie->nodes[idx].is_param = is_param;
+    trie->nodes[idx].literal = route_strndup(seg, pre_len);
+    trie->nodes[idx].literal_len = pre_len;
+    trie->nodes[idx].suffix = route_strndup(suf, suf_len);
+    trie->nodes[idx].suffix_len = suf_len;
+    if (!trie->nodes[idx].literal || !trie->nodes[idx].suffix)
+      return CDD_C_ERROR_MEMORY;
+    trie->nodes[idx].next_sibling = trie->nodes[parent].first_child;
+    trie->nodes[parent].first_child = idx;
+  }
+
+  if (is_param) {
+    *out_param = route_strndup(open + 1, (size_t)(close - open - 1));
+    if (!*out_param)
+      return CDD_C_ERROR_MEMORY;
+  }
+  *out_idx = idx;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Insert every operation of one Path Item into the trie.
+ */
+static cdd_c_error_t route_trie_insert_path(struct RouteTrie *trie,
+                                            const struct OpenAPI_Path *path) {
+  char *names[64];
+  size_t n_names = 0, node = 0, i, j;
+  const char *p = path->route ? path->route : "/";
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+
+  while (*p) {
+    const char *seg;
+    char *param = NULL;
+    while (*p == '/')
+      p++;
+    if (!*p)
+      break;
+    seg = p;
+    while (*p && *p != '/')
+      p++;
+    rc = route_trie_child(trie, node, seg, (size_t)(p - seg), &param, &node);
+    if (rc != CDD_C_SUCCESS)
+      goto cleanup;
+    if (param) {
+      if (n_names == sizeof(names) / sizeof(names[0])) {
+        C_CDD_FREE(param);
+        rc = CDD_C_ERROR_INVALID_ARGUMENT;
+        goto cleanup;
+      }
+      names[n_names++] = param;
+    }
+  }
+  if (n_names > trie->max_params)
+    trie->max_params = n_names;
+
+  for (i = 0; i < path->n_operations; i++) {
+    struct RouteTrieNode *target = &trie->nodes[node];
+    struct RouteTrieLeaf *leaf;
+    struct RouteTrieLeaf *grown;
+    if (!path->operations[i].operation_id)
+      continue;
+    grown = (struct RouteTrieLeaf *)C_CDD_REALLOC(
+        target->leaves, (target->n_leaves + 1) * sizeof(*grown));
+    if (!grown) {
+      rc = CDD_C_ERROR_MEMORY;
+      goto cleanup;
+    }
+    target->leaves = grown;
+    leaf = &target->leaves[target->n_leaves++];
+    leaf->op = &path->operations[i];
+    leaf->n_param_names = 0;
+    leaf->param_names = NULL;
+    if (n_names) {
+      leaf->param_names = (char **)C_CDD_CALLOC(n_names, sizeof(char *));
+      if (!leaf->param_names) {
+        rc = CDD_C_ERROR_MEMORY;
+        goto cleanup;
+      }
+      for (j = 0; j < n_names; j++) {
+        leaf->param_names[j] = route_strndup(names[j], strlen(names[j]));
+        if (!leaf->param_names[j]) {
+          rc = CDD_C_ERROR_MEMORY;
+          goto cleanup;
+        }
+        leaf->n_param_names++;
+      }
+    }
+  }
+
+cleanup:
+  for (j = 0; j < n_names; j++)
+    C_CDD_FREE(names[j]);
+  return rc;
+}
+
+/**
+ * @brief Build the route trie for every path in the spec.
+ */
+static cdd_c_error_t route_trie_build(const struct OpenAPI_Spec *spec,
+                                      struct RouteTrie *trie) {
+  size_t root, i;
+  cdd_c_error_t rc;
+  memset(trie, 0, sizeof(*trie));
+  rc = route_trie_new_node(trie, &root);
+  for (i = 0; rc == CDD_C_SUCCESS && i < spec->n_paths; i++)
+    rc = route_trie_insert_path(trie, &spec->paths[i]);
+  return rc;
+}
+
+/**
+ * @brief Emit a C string literal body for `len` bytes of `s`.
+ */
+static void route_emit_literal(FILE *fp, const char *s, size_t len) {
+  size_t i;
+  for (i = 0; i < len; i++) {
+    if (s[i] == '"' || s[i] == '\\')
+      fputc('\\', fp);
+    fputc(s[i], fp);
+  }
+}
+
+/**
+ * @brief Emit the matcher function for one trie node.
+ *
+ * Literal children are dispatched by a `switch` on segment length followed
+ * by a single `memcmp`; template children are tried afterwards, so static
+ * routes take precedence over templated ones as OpenAPI requires, while a
+ * literal prefix that dead-ends still falls back to a matching template.
+ */
+static void route_emit_node(FILE *fp, const struct RouteTrie *trie,
+                            size_t idx) {
+  const struct RouteTrieNode *node = &trie->nodes[idx];
+  size_t c, j, k;
+  int any_literal = 0;
+
+  fprintf(fp,
+          "static int route_node_%lu(const char *method, size_t method_len, "
+          "const char *p, const char *end, struct route_match *m) {\n",
+          (unsigned long)idx);
+  fprintf(fp, "    struct route_span seg;\n");
+  fprintf(fp, "    (void)method;\n    (void)method_len;\n");
+  fprintf(fp, "    if (!route_next_segment(&p, end, &seg)) {\n");
+  for (j = 0; j < node->n_leaves; j++) {
+    const struct RouteTrieLeaf *leaf = &node->leaves[j];
+    const char *method = server_op_method(leaf->op);
+    fprintf(fp,
+            "        if (method_len == %lu && memcmp(method, \"%s\", %lu) == "
+            "0) {\n",
+            (unsigned long)strlen(method), method,
+            (unsigned long)strlen(method));
+    fprintf(fp, "            m->handler = handle_%s;\n",
+            leaf->op->operation_id);
+    fprintf(fp, "            m->operation_id = \"%s\";\n",
+            leaf->op->operation_id);
+    if (leaf->n_param_names)
+      fprintf(fp, "            m->param_names = route_params_%s;\n",
+              leaf->op->operation_id);
+    fprintf(fp, "            return 1;\n        }\n");
+  }
+  fprintf(fp, "        return 0;\n    }\n");
+
+  for (c = node->first_child; c != ROUTE_TRIE_NONE;
+       c = trie->nodes[c].next_sibling) {
+    if (trie->nodes[c].is_param)
+      continue;
+    if (!any_literal) {
+      fprintf(fp, "    switch (seg.len) {\n");
+      any_literal = 1;
+    }
+    /* Group all literal siblings sharing this length under one case */
+    for (k = node->first_child; k != c; k = trie->nodes[k].next_sibling) {
+      if (!trie->nodes[k].is_param &&
+          trie->nodes[k].literal_len == trie->nodes[c].literal_len)
+        break;
+    }
+    if (k != c)
+      continue;
+    fprintf(fp, "    case %lu:\n", (unsigned long)trie->nodes[c].literal_len);
+    for (k = c; k != ROUTE_TRIE_NONE; k = trie->nodes[k].next_sibling) {
+      const struct RouteTrieNode *lit = &trie->nodes[k];
+      if (lit->is_param || lit->literal_len != trie->nodes[c].literal_len)
+        continue;
+      fprintf(fp, "        if (memcmp(seg.ptr, \"");
+      route_emit_literal(fp, lit->literal, lit->literal_len);
+      fprintf(fp,
+              "\", %lu) == 0 &&\n            route_node_%lu(method, "
+              "method_len, p, end, m))\n            return 1;\n",
+              (unsigned long)lit->literal_len, (unsigned long)k);
+    }
+    fprintf(fp, "        break;\n");
+  }
+  if (any_literal)
+    fprintf(fp, "    default:\n        break;\n    }\n");
+
+  for (c = node->first_child; c != ROUTE_TRIE_NONE;
+       c = trie->nodes[c].next_sibling) {
+    const struct RouteTrieNode *param = &trie->nodes[c];
+    size_t fixed = param->literal_len + param->suffix_len;
+    if (!param->is_param)
+      continue;
+    fprintf(fp, "    if (seg.len > %lu && m->n_params < ROUTE_MAX_PARAMS",
+            (unsigned long)fixed);
+    if (param->literal_len) {
+      fprintf(fp, " &&\n        memcmp(seg.ptr, \"");
+      route_emit_literal(fp, param->literal, param->literal_len);
+      fprintf(fp, "\", %lu) == 0", (unsigned long)param->literal_len);
+    }
+    if (param->suffix_len) {
+      fprintf(fp, " &&\n        memcmp(seg.ptr + seg.len - %lu, \"",
+              (unsigned long)param->suffix_len);
+      route_emit_literal(fp, param->suffix, param->suffix_len);
+      fprintf(fp, "\", %lu) == 0", (unsigned long)param->suffix_len);
+    }
+    fprintf(fp, ") {\n");
+    if (param->literal_len)
+      fprintf(fp, "        m->params[m->n_params].ptr = seg.ptr + %lu;\n",
+              (unsigned long)param->literal_len);
+    else
+      fprintf(fp, "        m->params[m->n_params].ptr = seg.ptr;\n");
+    if (fixed)
+      fprintf(fp, "        m->params[m->n_params].len = seg.len - %lu;\n",
+              (unsigned long)fixed);
+    else
+      fprintf(fp, "        m->params[m->n_params].len = seg.len;\n");
+    fprintf(fp, "        m->n_params++;\n");
+    fprintf(fp,
+            "        if (route_node_%lu(method, method_len, p, end, m))\n"
+            "            return 1;\n",
+            (unsigned long)c);
+    fprintf(fp, "        m->n_params--;\n    }\n");
+  }
+  fprintf(fp, "    return 0;\n}\n\n");
+}
+
+/**
+ * @brief Print `name` as a C identifier, mapping invalid characters to `_`.
+ */
+static void server_emit_ident(FILE *fp, const char *name) {
+  const char *p = name ? name : "";
+  if (isdigit((unsigned char)*p))
+    fputc('_', fp);
+  for (; *p; p++)
+    fputc(isalnum((unsigned char)*p) ? *p : '_', fp);
+}
+
+/**
+ * @brief Location keyword for a parameter, as used in doc comments.
+ */
+static const char *server_param_in_name(enum OpenAPI_ParamIn in) {
+  switch (in) {
+  case OA_PARAM_IN_PATH:
+    return "path";
+  case OA_PARAM_IN_QUERY:
+  case OA_PARAM_IN_QUERYSTRING:
+    return "query";
+  case OA_PARAM_IN_COOKIE:
+    return "cookie";
+  default:
+    return "header";
+  }
+}
+
+/**
+ * @brief Member-name prefix for a parameter's location.
+ *
+ * Parameters may share a name across locations (`{id}` and `?id=`), so each
+ * bound member carries its location; the fixed `body` and `bound` members
+ * can then never collide with a parameter.
+ */
+static const char *server_param_member_prefix(enum OpenAPI_ParamIn in) {
+  switch (in) {
+  case OA_PARAM_IN_PATH:
+    return "path_";
+  case OA_PARAM_IN_QUERY:
+  case OA_PARAM_IN_QUERYSTRING:
+    return "query_";
+  case OA_PARAM_IN_COOKIE:
+    return "cookie_";
+  default:
+    return "header_";
+  }
+}
+
+/**
+ * @brief Classify a schema type into the scalar kinds the binder decodes.
+ * @return 'i' integer, 'n' number, 'b' boolean, 's' everything else (span).
+ */
+static char server_scalar_kind(const char *type) {
+  if (!type)
+    return 's';
+  if (strcmp(type, "integer") == 0)
+    return 'i';
+  if (strcmp(type, "number") == 0)
+    return 'n';
+  if (strcmp(type, "boolean") == 0)
+    return 'b';
+  return 's';
+}
+
+/**
+ * @brief Position of `{name}` among the template parameters of `route`.
+ * @return Zero-based capture index, or -1 if `name` is not in the template.
+ */
+static int server_route_param_index(const char *route, const char *name) {
+  int idx = 0;
+  size_t len = name ? strlen(name) : 0;
+  const char *p = route;
+  while (p && (p = strchr(p, '{')) != NULL) {
+    const char *close = strchr(p, '}');
+    if (!close)
+      break;
+    if ((size_t)(close - p - 1) == len && strncmp(p + 1, name, len) == 0)
+      return idx;
+    idx++;
+    p = close + 1;
+  }
+  return -1;
+}
+
+/**
+ * @brief Emit one typed member of a generated `<opId>_request` struct.
+ */
+static void server_emit_bound_member(FILE *fp, const char *prefix,
+                                     const char *name, char kind) {
+  const char *ctype = kind == 'i'   ? "long"
+                      : kind == 'n' ? "double"
+                      : kind == 'b' ? "int"
+                                    : "struct route_span";
+  fprintf(fp, "    %s %s", ctype, prefix);
+  server_emit_ident(fp, name);
+  fprintf(fp, ";\n    int has_%s", prefix);
+  server_emit_ident(fp, name);
+  fprintf(fp, ";\n");
+}
+
+/**
+ * @brief Emit the conversion from span `src` into a bound member.
+ *
+ * Spans are stored as-is (zero-copy); scalars are parsed from the span and
+ * a malformed value fails the bind with 400.
+ */
+static void server_emit_bind_value(FILE *fp, const char *indent,
+                                   const char *prefix, const char *name,
+                                   char kind, const char *src) {
+  fprintf(fp, "%sout->has_%s", indent, prefix);
+  server_emit_ident(fp, name);
+  fprintf(fp, " = 1;\n");
+  if (kind == 's') {
+    fprintf(fp, "%sout->%s", indent, prefix);
+    server_emit_ident(fp, name);
+    fprintf(fp, " = %s;\n", src);
+    return;
+  }
+  fprintf(fp, "%sif (%s(%s, &out->%s", indent,
+          kind == 'i'   ? "route_span_to_long"
+          : kind == 'n' ? "route_span_to_double"
+                        : "route_span_to_bool",
+          src, prefix);
+  server_emit_ident(fp, name);
+  fprintf(fp, ") != 0)\n%s    return 400;\n", indent);
+}
+
+/**
+ * @brief Emit the per-request runtime shared by every generated handler.
+ *
+ * Each CivetWeb worker thread owns one fixed-size arena, allocated once in
+ * `init_thread`; request bodies and any percent-decoded values live there
+ * and the arena is reset after every response, so steady-state request
+ * handling performs no heap allocation. Everything else handlers see is a
+ * span into CivetWeb's receive buffer.
+ */
+static void server_emit_runtime(FILE *fp, size_t max_params) {
+  fprintf(fp, "/* Request binding runtime */\n");
+  fprintf(fp, "#ifndef REQ_ARENA_SIZE\n#define REQ_ARENA_SIZE 65536\n"
+              "#endif /* !REQ_ARENA_SIZE */\n");
+  fprintf(fp, "#define ROUTE_MAX_PARAMS %lu\n\n",
+          (unsigned long)(max_params ? max_params : 1));
+  fprintf(fp, "/**\n * @brief Zero-copy view into the request buffer.\n */\n");
+  fprintf(fp, "struct route_span {\n    const char *ptr;\n    size_t len;\n};"
+              "\n\n");
+  fprintf(fp, "typedef int (*route_handler_fn)(struct c_rest_request *, "
+              "struct c_rest_response *, void *);\n\n");
+  fprintf(fp, "/**\n * @brief Result of matching a request against the "
+              "route table.\n */\n");
+  fprintf(fp, "struct route_match {\n"
+              "    route_handler_fn handler;\n"
+              "    const char *operation_id;\n"
+              "    const char *const *param_names;\n"
+              "    size_t n_params;\n"
+              "    struct route_span params[ROUTE_MAX_PARAMS];\n"
+              "};\n\n");
+  fprintf(fp, "/**\n * @brief Bump allocator reset after every response.\n"
+              " */\n");
+  fprintf(fp, "struct req_arena {\n    char *base;\n    size_t cap;\n"
+              "    size_t used;\n};\n\n");
+  fprintf(fp, "/**\n * @brief Everything a handler needs to bind its "
+              "inputs.\n */\n");
+  fprintf(fp, "struct route_context {\n"
+              "    struct mg_connection *conn;\n"
+              "    const struct route_match *match;\n"
+              "    struct req_arena *arena;\n"
+              "    struct route_span query;\n"
+              "};\n\n");
+
+  fprintf(fp, "static void *req_arena_alloc(struct req_arena *a, size_t n) "
+              "{\n");
+  fprintf(fp, "    void *p;\n");
+  fprintf(fp, "    n = (n + 7u) & ~(size_t)7u;\n");
+  fprintf(fp, "    if (n > a->cap - a->used)\n        return NULL;\n");
+  fprintf(fp, "    p = a->base + a->used;\n");
+  fprintf(fp, "    a->used += n;\n    return p;\n}\n\n");
+
+  fprintf(fp, "static void *server_init_thread(const struct mg_context *ctx, "
+              "int thread_type) {\n");
+  fprintf(fp, "    struct req_arena *a;\n");
+  fprintf(fp, "    (void)ctx;\n");
+  fprintf(fp, "    if (thread_type != 1) /* worker threads only */\n"
+              "        return NULL;\n");
+  fprintf(fp, "    a = (struct req_arena *)malloc(sizeof(*a) + "
+              "REQ_ARENA_SIZE);\n");
+  fprintf(fp, "    if (a) {\n"
+              "        a->base = (char *)(a + 1);\n"
+              "        a->cap = REQ_ARENA_SIZE;\n"
+              "        a->used = 0;\n    }\n");
+  fprintf(fp, "    return a;\n}\n\n");
+  fprintf(fp, "static void server_exit_thread(const struct mg_context *ctx, "
+              "int thread_type, void *thread_pointer) {\n");
+  fprintf(fp, "    (void)ctx;\n    (void)thread_type;\n"
+              "    free(thread_pointer);\n}\n\n");
+
+  /* Percent-decoding: zero-copy unless escapes are present. `+` means a
+   * space only in query strings and form bodies, not in path segments. */
+  fprintf(fp, "static int route_hex(int c) {\n"
+              "    if (c >= '0' && c <= '9')\n        return c - '0';\n"
+              "    if (c >= 'a' && c <= 'f')\n        return c - 'a' + 10;\n"
+              "    if (c >= 'A' && c <= 'F')\n        return c - 'A' + 10;\n"
+              "    return -1;\n}\n\n");
+  fprintf(fp, "static int route_span_decode(struct req_arena *a, struct "
+              "route_span *s, int plus_is_space) {\n");
+  fprintf(fp, "    size_t i, o = 0;\n    char *buf;\n");
+  fprintf(fp, "    for (i = 0; i < s->len; i++)\n"
+              "        if (s->ptr[i] == '%%' || (plus_is_space && "
+              "s->ptr[i] == '+'))\n"
+              "            break;\n");
+  fprintf(fp, "    if (i == s->len)\n        return 0;\n");
+  fprintf(fp, "    buf = (char *)req_arena_alloc(a, s->len);\n");
+  fprintf(fp, "    if (!buf)\n        return -1;\n");
+  fprintf(fp, "    for (i = 0; i < s->len; i++) {\n"
+              "        if (plus_is_space && s->ptr[i] == '+') {\n"
+              "            buf[o++] = ' ';\n"
+              "        } else if (s->ptr[i] == '%%' && i + 2 < s->len && "
+              "route_hex(s->ptr[i + 1]) >= 0 &&\n"
+              "                   route_hex(s->ptr[i + 2]) >= 0) {\n"
+              "            buf[o++] = (char)(route_hex(s->ptr[i + 1]) * 16 + "
+              "route_hex(s->ptr[i + 2]));\n"
+              "            i += 2;\n"
+              "        } else {\n"
+              "            buf[o++] = s->ptr[i];\n"
+              "        }\n    }\n");
+  fprintf(fp, "    s->ptr = buf;\n    s->len = o;\n    return 0;\n}\n\n");
+
+  /* key=value&... lookup shared by query strings and form bodies */
+  fprintf(fp, "static int route_pairs_get(struct route_span pairs, const char "
+              "*name, struct route_span *out) {\n");
+  fprintf(fp, "    size_t name_len = strlen(name);\n");
+  fprintf(fp, "    const char *p = pairs.ptr, *end = pairs.ptr + "
+              "pairs.len;\n");
+  fprintf(fp, "    while (p && p < end) {\n");
+  fprintf(fp, "        const char *amp = (const char *)memchr(p, '&', "
+              "(size_t)(end - p));\n");
+  fprintf(fp, "        const char *stop = amp ? amp : end;\n");
+  fprintf(fp, "        const char *eq = (const char *)memchr(p, '=', "
+              "(size_t)(stop - p));\n");
+  fprintf(fp, "        const char *key_end = eq ? eq : stop;\n");
+  fprintf(fp, "        if ((size_t)(key_end - p) == name_len && memcmp(p, "
+              "name, name_len) == 0) {\n");
+  fprintf(fp, "            out->ptr = eq ? eq + 1 : stop;\n");
+  fprintf(fp, "            out->len = (size_t)(stop - out->ptr);\n");
+  fprintf(fp, "            return 1;\n        }\n");
+  fprintf(fp, "        p = amp ? amp + 1 : NULL;\n    }\n");
+  fprintf(fp, "    return 0;\n}\n\n");
+
+  fprintf(fp, "static int route_cookie_get(const char *h, const char "
+              "*name, struct route_span *out) {\n");
+  fprintf(fp, "    size_t name_len = strlen(name);\n");
+  fprintf(fp, "    while (h && *h) {\n");
+  fprintf(fp, "        const char *semi;\n");
+  fprintf(fp, "        while (*h == ' ')\n            h++;\n");
+  fprintf(fp, "        semi = strchr(h, ';');\n");
+  fprintf(fp, "        if (strncmp(h, name, name_len) == 0 && h[name_len] == "
+              "'=') {\n");
+  fprintf(fp, "            out->ptr = h + name_len + 1;\n");
+  fprintf(fp, "            out->len = semi ? (size_t)(semi - out->ptr) : "
+              "strlen(out->ptr);\n");
+  fprintf(fp, "            return 1;\n        }\n");
+  fprintf(fp, "        h = semi ? semi + 1 : NULL;\n    }\n");
+  fprintf(fp, "    return 0;\n}\n\n");
+
+  /* Top-level JSON member lookup; values stay spans into the body */
+  fprintf(fp, "static const char *route_json_skip(const char *p, const char "
+              "*end) {\n");
+  fprintf(fp, "    int depth = 0;\n");
+  fprintf(fp, "    for (; p < end; p++) {\n");
+  fprintf(fp, "        if (*p == '\"') {\n"
+              "            for (p++; p < end && *p != '\"'; p++)\n"
+              "                if (*p == '\\\\')\n                    p++;\n"
+              "            if (depth == 0)\n                return p + 1;\n"
+              "        } else if (*p == '{' || *p == '[') {\n"
+              "            depth++;\n"
+              "        } else if (*p == '}' || *p == ']') {\n"
+              "            if (depth == 0)\n                return p;\n"
+              "            if (--depth == 0)\n                return p + 1;\n"
+              "        } else if (depth == 0 && (*p == ',' || *p == ' ' || "
+              "*p == '\\t' ||\n"
+              "                                  *p == '\\r' || *p == "
+              "'\\n')) {\n"
+              "            return p;\n"
+              "        }\n    }\n");
+  fprintf(fp, "    return end;\n}\n\n");
+  fprintf(fp, "static int route_json_get(struct route_span body, const char "
+              "*name, struct route_span *out) {\n");
+  fprintf(fp, "    size_t name_len = strlen(name);\n");
+  fprintf(fp, "    const char *p = body.ptr, *end = body.ptr + body.len;\n");
+  fprintf(fp, "    while (p < end && *p != '{')\n        p++;\n");
+  fprintf(fp, "    for (p++; p < end;) {\n");
+  fprintf(fp, "        const char *key, *key_end;\n");
+  fprintf(fp, "        while (p < end && *p != '\"' && *p != '}')\n"
+              "            p++;\n");
+  fprintf(fp, "        if (p >= end || *p == '}')\n            return 0;\n");
+  fprintf(fp, "        key = p + 1;\n");
+  fprintf(fp, "        key_end = route_json_skip(p, end) - 1;\n");
+  fprintf(fp, "        p = key_end + 1;\n");
+  fprintf(fp, "        while (p < end && (*p == ':' || *p == ' ' || *p == "
+              "'\\t' || *p == '\\r' || *p == '\\n'))\n            p++;\n");
+  fprintf(fp, "        out->ptr = p;\n");
+  fprintf(fp, "        p = route_json_skip(p, end);\n");
+  fprintf(fp, "        out->len = (size_t)(p - out->ptr);\n");
+  fprintf(fp, "        if ((size_t)(key_end - key) == name_len && "
+              "memcmp(key, name, name_len) == 0) {\n");
+  fprintf(fp, "            if (out->len >= 2 && out->ptr[0] == '\"') {\n"
+              "                out->ptr++;\n                out->len -= 2;\n"
+              "            }\n");
+  fprintf(fp, "            return 1;\n        }\n");
+  fprintf(fp, "        while (p < end && *p != ',' && *p != '}')\n"
+              "            p++;\n");
+  fprintf(fp, "    }\n    return 0;\n}\n\n");
+
+  /* Scalar conversions straight from spans */
+  fprintf(fp, "static int route_span_to_long(struct route_span s, long *out) "
+              "{\n");
+  fprintf(fp, "    char tmp[32];\n    char *end;\n");
+  fprintf(fp, "    if (s.len == 0 || s.len >= sizeof(tmp))\n"
+              "        return -1;\n");
+  fprintf(fp, "    memcpy(tmp, s.ptr, s.len);\n    tmp[s.len] = '\\0';\n");
+  fprintf(fp, "    *out = strtol(tmp, &end, 10);\n");
+  fprintf(fp, "    return *end == '\\0' ? 0 : -1;\n}\n\n");
+  fprintf(fp, "static int route_span_to_double(struct route_span s, double "
+              "*out) {\n");
+  fprintf(fp, "    char tmp[64];\n    char *end;\n");
+  fprintf(fp, "    if (s.len == 0 || s.len >= sizeof(tmp))\n"
+              "        return -1;\n");
+  fprintf(fp, "    memcpy(tmp, s.ptr, s.len);\n    tmp[s.len] = '\\0';\n");
+  fprintf(fp, "    *out = strtod(tmp, &end);\n");
+  fprintf(fp, "    return *end == '\\0' ? 0 : -1;\n}\n\n");
+  fprintf(fp, "static int route_span_to_bool(struct route_span s, int *out) "
+              "{\n");
+  fprintf(fp, "    if (s.len == 4 && memcmp(s.ptr, \"true\", 4) == 0)\n"
+              "        *out = 1;\n"
+              "    else if (s.len == 5 && memcmp(s.ptr, \"false\", 5) == 0)\n"
+              "        *out = 0;\n"
+              "    else\n        return -1;\n");
+  fprintf(fp, "    return 0;\n}\n\n");
+
+  /* Body reader: one copy from the socket into the arena */
+  fprintf(fp, "static int route_read_body(struct route_context *ctx, struct "
+              "route_span *out) {\n");
+  fprintf(fp, "    const struct mg_request_info *ri = "
+              "mg_get_request_info(ctx->conn);\n");
+  fprintf(fp, "    char *buf;\n    size_t got = 0;\n");
+  fprintf(fp, "    out->ptr = \"\";\n    out->len = 0;\n");
+  fprintf(fp, "    if (ri->content_length <= 0)\n        return 0;\n");
+  fprintf(fp, "    buf = (char *)req_arena_alloc(ctx->arena, "
+              "(size_t)ri->content_length);\n");
+  fprintf(fp, "    if (!buf)\n        return 413;\n");
+  fprintf(fp, "    while (got < (size_t)ri->content_length) {\n");
+  fprintf(fp, "        int n = mg_read(ctx->conn, buf + got, "
+              "(size_t)ri->content_length - got);\n");
+  fprintf(fp, "        if (n <= 0)\n            return 400;\n");
+  fprintf(fp, "        got += (size_t)n;\n    }\n");
+  fprintf(fp, "    out->ptr = buf;\n    out->len = got;\n    return 0;\n}\n\n");
+}
+
+/**
+ * @brief Emit `struct <opId>_request` and its `bind_<opId>` function.
+ *
+ * Path, query, header and cookie parameters (path-level parameters
+ * included, operation-level ones taking precedence) bind to typed members
+ * named `<in>_<name>`, e.g. `path_id` and `query_id`. When the request
+ * body refers to a component schema, its top-level properties bind as
+ * `body_<name>` from either a JSON or a form-urlencoded body; the raw body
+ * is always available as `body`. JSON string members are bound without
+ * unescaping, as spans between the quotes.
+ */
+static void server_emit_binder(FILE *fp, const struct OpenAPI_Spec *spec,
+                               const struct OpenAPI_Path *path,
+                               const struct OpenAPI_Operation *op) {
+  const char *opId = op->operation_id;
+  struct StructFields *body_schema = NULL;
+  int has_body = op->req_body.content_schema || op->req_body.ref_name ||
+                 op->req_body.ref || op->n_req_body_media_types > 0;
+  int form_body = 0;
+  size_t k, pass;
+
+  for (k = 0; k < op->n_req_body_media_types; k++) {
+    if (op->req_body_media_types[k].name &&
+        strcmp(op->req_body_media_types[k].name,
+               "application/x-www-form-urlencoded") == 0)
+      form_body = 1;
+  }
+  if (op->req_body.ref_name)
+    openapi_spec_find_schema(spec, op->req_body.ref_name, &body_schema);
+
+  /* pass 0 emits the struct, pass 1 the binder */
+  for (pass = 0; pass < 2; pass++) {
+    if (pass == 0) {
+      fprintf(fp, "struct %s_request {\n", opId);
+    } else {
+      fprintf(fp, "static int bind_%s(struct route_context *ctx, struct "
+                  "%s_request *out) {\n",
+              opId, opId);
+      fprintf(fp, "    struct route_span v;\n");
+      fprintf(fp, "    memset(out, 0, sizeof(*out));\n");
+      fprintf(fp, "    (void)v;\n");
+    }
+
+    for (k = 0; k < path->n_parameters + op->n_parameters; k++) {
+      const struct OpenAPI_Parameter *prm =
+          k < path->n_parameters ? &path->parameters[k]
+                                 : &op->parameters[k - path->n_parameters];
+      char kind = server_scalar_kind(prm->type);
+      const char *prefix = server_param_member_prefix(prm->in);
+      int idx;
+      if (!prm->name)
+        continue;
+      if (k < path->n_parameters) {
+        size_t o;
+        for (o = 0; o < op->n_parameters; o++)
+          if (op->parameters[o].name &&
+              strcmp(op->parameters[o].name, prm->name) == 0 &&
+              op->parameters[o].in == prm->in)
+            break;
+        if (o < op->n_parameters)
+          continue; /* overridden at operation level */
+      }
+      if (pass == 0) {
+        server_emit_bound_member(fp, prefix, prm->name, kind);
+        continue;
+      }
+      switch (prm->in) {
+      case OA_PARAM_IN_PATH:
+        idx = server_route_param_index(path->route, prm->name);
+        if (idx < 0)
+          continue;
+        fprintf(fp, "    if (ctx->match->n_params > %d) {\n", idx);
+        fprintf(fp, "        v = ctx->match->params[%d];\n", idx);
+        fprintf(fp, "        if (route_span_decode(ctx->arena, &v, 0) != 0)\n"
+                    "            return 413;\n");
+        server_emit_bind_value(fp, "        ", prefix, prm->name, kind, "v");
+        fprintf(fp, "    }\n");
+        break;
+      case OA_PARAM_IN_QUERY:
+      case OA_PARAM_IN_QUERYSTRING:
+        fprintf(fp, "    if (route_pairs_get(ctx->query, \"");
+        route_emit_literal(fp, prm->name, strlen(prm->name));
+        fprintf(fp, "\", &v)) {\n");
+        fprintf(fp, "        if (route_span_decode(ctx->arena, &v, 1) != 0)\n"
+                    "            return 413;\n");
+        server_emit_bind_value(fp, "        ", prefix, prm->name, kind, "v");
+        fprintf(fp, "    }\n");
+        break;
+      case OA_PARAM_IN_COOKIE:
+        fprintf(fp, "    if (route_cookie_get(mg_get_header(ctx->conn, "
+                    "\"Cookie\"), \"");
+        route_emit_literal(fp, prm->name, strlen(prm->name));
+        fprintf(fp, "\", &v)) {\n");
+        server_emit_bind_value(fp, "        ", prefix, prm->name, kind, "v");
+        fprintf(fp, "    }\n");
+        break;
+      default:
+        fprintf(fp, "    {\n        const char *h = "
+                    "mg_get_header(ctx->conn, \"");
+        route_emit_literal(fp, prm->name, strlen(prm->name));
+        fprintf(fp, "\");\n        if (h) {\n");
+        fprintf(fp, "            v.ptr = h;\n            v.len = strlen(h);\n");
+        server_emit_bind_value(fp, "            ", prefix, prm->name, kind,
+                               "v");
+        fprintf(fp, "        }\n    }\n");
+        break;
+      }
+      if (prm->required) {
+        fprintf(fp, "    if (!out->has_%s", prefix);
+        server_emit_ident(fp, prm->name);
+        fprintf(fp, ")\n        return 400;\n");
+      }
+    }
+
+    if (has_body) {
+      if (pass == 0) {
+        fprintf(fp, "    struct route_span body;\n");
+      } else {
+        fprintf(fp, "    {\n        int rc = route_read_body(ctx, "
+                    "&out->body);\n");
+        fprintf(fp, "        if (rc != 0)\n            return rc;\n    }\n");
+      }
+      for (k = 0; body_schema && k < body_schema->size; k++) {
+        const struct StructField *f = &body_schema->fields[k];
+        char kind = server_scalar_kind(f->type);
+        if (pass == 0) {
+          server_emit_bound_member(fp, "body_", f->name, kind);
+          continue;
+        }
+        if (form_body) {
+          fprintf(fp, "    if (route_pairs_get(out->body, \"");
+          route_emit_literal(fp, f->name, strlen(f->name));
+          fprintf(fp, "\", &v)) {\n");
+          fprintf(fp, "        if (route_span_decode(ctx->arena, &v, 1) != 0)\n"
+                      "            return 413;\n");
+        } else {
+          fprintf(fp, "    if (route_json_get(out->body, \"");
+          route_emit_literal(fp, f->name, strlen(f->name));
+          fprintf(fp, "\", &v)) {\n");
+        }
+        server_emit_bind_value(fp, "        ", "body_", f->name, kind, "v");
+        fprintf(fp, "    }\n");
+        if (f->required) {
+          fprintf(fp, "    if (!out->has_body_");
+          server_emit_ident(fp, f->name);
+          fprintf(fp, ")\n        return 400;\n");
+        }
+      }
+    }
+
+    if (pass == 0)
+      fprintf(fp, "    int bound; /* keeps the struct non-empty */\n};\n\n");
+    else
+      fprintf(fp, "    out->bound = 1;\n    return 0;\n}\n\n");
+  }
+}
+
+/**
+ * @brief Emit the compiled route matcher for the whole spec.
+ *
+ * Generates one static function per trie node (children first, so no
+ * forward declarations are needed) and a `route_dispatch` entry point.
+ * Matching walks the request path once; captured template parameters are
+ * spans pointing into the caller's buffer, so no copies are made.
+ */
+static void route_trie_emit(FILE *fp, const struct RouteTrie *trie) {
+  size_t i, j, k;
+
+  fprintf(fp, "/* Compiled route table: O(path length) dispatch */\n");
+  for (i = 0; i < trie->n_nodes; i++) {
+    for (j = 0; j < trie->nodes[i].n_leaves; j++) {
+      const struct RouteTrieLeaf *leaf = &trie->nodes[i].leaves[j];
+      if (!leaf->n_param_names)
+        continue;
+      fprintf(fp, "static const char *const route_params_%s[] = {",
+              leaf->op->operation_id);
+      for (k = 0; k < leaf->n_param_names; k++) {
+        fprintf(fp, "%s\"", k ? ", " : "");
+        route_emit_literal(fp, leaf->param_names[k],
+                           strlen(leaf->param_names[k]));
+        fprintf(fp, "\"");
+      }
+      fprintf(fp, "};\n");
+    }
+  }
+
+  fprintf(fp, "\nstatic int route_next_segment(const char **p, const char "
+              "*end, struct route_span *seg) {\n");
+  fprintf(fp, "    const char *s = *p;\n");
+  fprintf(fp, "    while (s < end && *s == '/')\n        s++;\n");
+  fprintf(fp, "    if (s == end)\n        return 0;\n");
+  fprintf(fp, "    seg->ptr = s;\n");
+  fprintf(fp, "    while (s < end && *s != '/')\n        s++;\n");
+  fprintf(fp, "    seg->len = (size_t)(s - seg->ptr);\n");
+  fprintf(fp, "    *p = s;\n    return 1;\n}\n\n");
+
+  for (i = trie->n_nodes; i-- > 0;)
+    route_emit_node(fp, trie, i);
+
+  fprintf(fp, "/**\n"
+              " * @brief Match `method` and `path` against the route table.\n"
+              " * @return 1 on match (filling `m`), 0 otherwise.\n"
+              " */\n");
+  fprintf(fp, "static int route_dispatch(const char *method, const char "
+              "*path, size_t path_len, struct route_match *m) {\n");
+  fprintf(fp, "    const char *end = path;\n");
+  fprintf(fp, "    while (end < path + path_len && *end != '?' && *end != "
+              "'#')\n        end++;\n");
+  fprintf(fp, "    memset(m, 0, sizeof(*m));\n");
+  fprintf(fp, "    return route_node_0(method, strlen(method), path, end, "
+              "m);\n}\n\n");
+
+  fprintf(fp, "static int handle_route_dispatch(struct mg_connection *conn, "
+              "void *cbdata) {\n");
+  fprintf(fp, "    const struct mg_request_info *ri = "
+              "mg_get_request_info(conn);\n");
+  fprintf(fp, "    struct route_match match;\n");
+  fprintf(fp, "    struct route_context rctx;\n");
+  fprintf(fp, "    struct c_rest_request req;\n");
+  fprintf(fp, "    struct c_rest_response res;\n");
+  fprintf(fp, "    int status;\n");
+  fprintf(fp, "    (void)cbdata;\n");
+  fprintf(fp, "    if (!route_dispatch(ri->request_method, ri->local_uri, "
+              "strlen(ri->local_uri), &match)) {\n");
+  fprintf(fp, "        mg_send_http_error(conn, 404, \"%%s\", \"Not "
+              "Found\");\n");
+  fprintf(fp, "        return 404;\n    }\n");
+  fprintf(fp, "    rctx.conn = conn;\n");
+  fprintf(fp, "    rctx.match = &match;\n");
+  fprintf(fp, "    rctx.arena = (struct req_arena *)"
+              "mg_get_thread_pointer(conn);\n");
+  fprintf(fp, "    rctx.query.ptr = ri->query_string ? ri->query_string : "
+              "\"\";\n");
+  fprintf(fp, "    rctx.query.len = strlen(rctx.query.ptr);\n");
+  fprintf(fp, "    if (!rctx.arena) {\n");
+  fprintf(fp, "        mg_send_http_error(conn, 500, \"%%s\", \"No request "
+              "arena\");\n");
+  fprintf(fp, "        return 500;\n    }\n");
+  fprintf(fp, "    memset(&req, 0, sizeof(req));\n");
+  fprintf(fp, "    memset(&res, 0, sizeof(res));\n");
+  fprintf(fp, "    status = match.handler(&req, &res, &rctx);\n");
+  fprintf(fp, "    if (status < 100 || status > 599) {\n");
+  fprintf(fp, "        /* Handler failed (negative error code) */\n");
+  fprintf(fp, "        status = 500;\n");
+  fprintf(fp, "        res.content_type = NULL;\n");
+  fprintf(fp, "        res.body = NULL;\n");
+  fprintf(fp, "        res.body_len = 0;\n    }\n");
+  fprintf(fp, "    if (!res.body)\n        res.body_len = 0;\n");
+  fprintf(fp, "    mg_printf(conn, \"HTTP/1.1 %%d %%s\\r\\nContent-Type: "
+              "%%s\\r\\nContent-Length: %%lu\\r\\n\\r\\n\", status, "
+              "mg_get_response_code_text(conn, status), res.content_type ? "
+              "res.content_type : \"application/json\", (unsigned "
+              "long)res.body_len);\n");
+  fprintf(fp, "    if (res.body_len > 0)\n"
+              "        mg_write(conn, res.body, res.body_len);\n");
+  fprintf(fp, "    rctx.arena->used = 0; /* reset for the next request */\n");
+  fprintf(fp, "    return status;\n}\n\n");
+}
+
 /**
  * @brief Executes the openapi server generate operation.
  */
@@ -30,6 +1050,7 @@ openapi_server_generate(const struct OpenAPI_Spec *spec,
   char path[1024];
   FILE *fp = NULL;
   size_t i, j, k;
+  struct RouteTrie trie;
 
   if (!spec || !config || !config->filename_base)
     return CDD_C_ERROR_INVALID_ARGUMENT;
@@ -121,12 +1142,23 @@ openapi_server_generate(const struct OpenAPI_Spec *spec,
       "    db_conn = NULL; /* c_orm_sqlite_open(\"oauth.db\", &db_conn); */\n");
   fprintf(fp, "    return CDD_C_SUCCESS;\n}\n\n");
 
+  {
+    cdd_c_error_t rc = route_trie_build(spec, &trie);
+    if (rc != CDD_C_SUCCESS) {
+      route_trie_free(&trie);
+      fclose(fp);
+      return rc;
+    }
+  }
+  server_emit_runtime(fp, trie.max_params);
+
   /* Route handlers */
   for (i = 0; i < spec->n_paths; i++) {
     for (j = 0; j < spec->paths[i].n_operations; j++) {
       const struct OpenAPI_Operation *op = &spec->paths[i].operations[j];
       const char *opId = op->operation_id;
       if (opId) {
+        server_emit_binder(fp, spec, &spec->paths[i], op);
         fprintf(fp, "/**\n");
         fprintf(fp, " * @brief %s handler\n", op->summary ? op->summary : opId);
         if (op->description)
@@ -134,8 +1166,7 @@ openapi_server_generate(const struct OpenAPI_Spec *spec,
 
         for (k = 0; k < op->n_parameters; k++) {
           fprintf(fp, " * @param %s (%s) %s\n", op->parameters[k].name,
-                  op->parameters[k].in == OA_PARAM_IN_QUERY ? "query"
-                                                            : "header",
+                  server_param_in_name(op->parameters[k].in),
                   op->parameters[k].description ? op->parameters[k].description
                                                 : "");
         }
@@ -151,9 +1182,15 @@ openapi_server_generate(const struct OpenAPI_Spec *spec,
             fp,
             "    const char *resp = \"{\\\"status\\\": \\\"%s called\\\"}\";\n",
             opId);
-        fprintf(fp, "    (void)user_data;\n");
+        fprintf(fp, "    struct route_context *rctx = (struct route_context "
+                    "*)user_data;\n");
+        fprintf(fp, "    struct mg_connection *conn = rctx->conn;\n");
+        fprintf(fp, "    struct %s_request in;\n", opId);
+        fprintf(fp, "    int bind_rc;\n");
         fprintf(fp, "    (void)req;\n");
-        fprintf(fp, "    (void)res;\n");
+        fprintf(fp, "    (void)conn;\n");
+        fprintf(fp, "    bind_rc = bind_%s(rctx, &in);\n", opId);
+        fprintf(fp, "    if (bind_rc != 0)\n        return bind_rc;\n");
 
         if (op->deprecated) {
           fprintf(fp, "    /* Note: Operation is deprecated */\n");
@@ -165,29 +1202,10 @@ openapi_server_generate(const struct OpenAPI_Spec *spec,
         }
 
         if (op->n_req_body_media_types > 0) {
-          size_t m;
-          for (m = 0; m < op->n_req_body_media_types; m++) {
-            if (op->req_body_media_types[m].name &&
-                strcmp(op->req_body_media_types[m].name,
-                       "application/x-www-form-urlencoded") == 0) {
-              fprintf(fp, "    /* Parse form-urlencoded request body */\n");
-              fprintf(fp, "    {\n");
-              fprintf(
-                  fp,
-                  "        struct c_rest_urlencoded_data urlencoded_data;\n");
-              if (op->req_body.ref_name) {
-                fprintf(fp, "        struct %s req_struct;\n",
-                        op->req_body.ref_name);
-                fprintf(
-                    fp,
-                    "        memset(&req_struct, 0, sizeof(req_struct));\n");
-              }
-              fprintf(fp, "        /* if (c_rest_request_parse_urlencoded(req, "
-                          "&urlencoded_data) == 0) { ... } */\n");
-              fprintf(fp, "    }\n");
-              break;
-            }
-          }
+          fprintf(fp, "    /* Request body bound into `in` (%s) */\n",
+                  op->req_body_media_types[0].name
+                      ? op->req_body_media_types[0].name
+                      : "unknown media type");
         }
 
         if (op->n_responses > 0) {
@@ -203,16 +1221,18 @@ openapi_server_generate(const struct OpenAPI_Spec *spec,
           codegen_security_write_server_apply(fp, op, spec);
         }
 
-        fprintf(fp, "    /* c_rest_response_set_status(res, 200); */\n");
-        fprintf(
-            fp,
-            "    /* c_rest_response_set_body(res, resp, strlen(resp)); */\n");
-        fprintf(fp, "    return 200;\n");
-        fprintf(fp, "    return CDD_C_SUCCESS;\n}\n\n");
+        fprintf(fp, "    res->status_code = 200;\n");
+        fprintf(fp, "    res->content_type = \"application/json\";\n");
+        fprintf(fp, "    res->body = (char *)resp;\n");
+        fprintf(fp, "    res->body_len = strlen(resp);\n");
+        fprintf(fp, "    return res->status_code;\n}\n\n");
       }
     }
   }
 
+  route_trie_emit(fp, &trie);
+  route_trie_free(&trie);
+
   fprintf(fp, "/**\n"
               " * @brief Auto-generated code from OpenAPI specification\n"
               " */\n"
@@ -262,6 +1282,8 @@ openapi_server_generate(const struct OpenAPI_Spec *spec,
               "return rc; }\n\n");
 
   fprintf(fp, "    memset(&callbacks, 0, sizeof(callbacks));\n");
+  fprintf(fp, "    callbacks.init_thread = server_init_thread;\n");
+  fprintf(fp, "    callbacks.exit_thread = server_exit_thread;\n");
   fprintf(fp, "    ctx = mg_start(&callbacks, 0, options);\n");
   fprintf(fp, "    if (ctx == NULL) {\n");
   fprintf(
@@ -283,15 +1305,13 @@ openapi_server_generate(const struct OpenAPI_Spec *spec,
   fprintf(fp, "    res->status_code = 200;\n");
   fprintf(fp, "    /* c_rest_response_add_header is pseudo; just printing "
               "headers manually or using standard HTTP framework */\n");
-  fprintf(fp, "    return res->status_code;\n");
-  fprintf(fp, "    return CDD_C_SUCCESS;\n}\n\n");
+  fprintf(fp, "    return res->status_code;\n}\n\n");
   fprintf(fp, "static int handle_mcp_message(struct c_rest_request *req, "
               "struct c_rest_response *res, void *user_data) {\n");
   fprintf(fp, "    (void)req;\n");
   fprintf(fp, "    (void)user_data;\n");
   fprintf(fp, "    res->status_code = 202;\n");
-  fprintf(fp, "    return res->status_code;\n");
-  fprintf(fp, "    return CDD_C_SUCCESS;\n}\n\n");
+  fprintf(fp, "    return res->status_code;\n}\n\n");
   fprintf(fp, "            /* MCP SSE Endpoint Registration */\n");
   fprintf(fp, "            c_rest_router_add(router, \"GET\", \"/mcp/sse\", "
               "NULL, NULL);  \n");
@@ -299,37 +1319,10 @@ openapi_server_generate(const struct OpenAPI_Spec *spec,
           "            c_rest_router_add(router, \"POST\", \"/mcp/message\", "
           "NULL, NULL);  \n\n");
 
-  /* Register handlers */
-  for (i = 0; i < spec->n_paths; i++) {
-    for (j = 0; j < spec->paths[i].n_operations; j++) {
-      const struct OpenAPI_Operation *op = &spec->paths[i].operations[j];
-      const char *opId = op->operation_id;
-      if (opId) {
-        const char *method = "GET";
-        if (op->verb == OA_VERB_POST)
-          method = "POST";
-        else if (op->verb == OA_VERB_PUT)
-          method = "PUT";
-        else if (op->verb == OA_VERB_DELETE)
-          method = "DELETE";
-        else if (op->verb == OA_VERB_OPTIONS)
-          method = "OPTIONS";
-        else if (op->verb == OA_VERB_HEAD)
-          method = "HEAD";
-        else if (op->verb == OA_VERB_PATCH)
-          method = "PATCH";
-        else if (op->verb == OA_VERB_TRACE)
-          method = "TRACE";
-        fprintf(fp,
-                "            c_rest_router_add(router, \"%s\", \"%s\", "
-                "handle_%s, NULL);\n",
-                method, spec->paths[i].route, opId);
-      }
-    }
-  }
-
-  fprintf(fp, "            /* TODO: bind router to CivetWeb (e.g. via c_rest "
-              "dispatch middleware) */\n");
+  fprintf(fp, "            /* Operations dispatch through the compiled "
+              "route table */\n");
+  fprintf(fp, "            mg_set_request_handler(ctx, \"/\", "
+              "handle_route_dispatch, NULL);\n");
   fprintf(fp, "            c_rest_router_destroy(router);\n");
   fprintf(fp, "        }\n");
   fprintf(fp, "    }\n\n");
@@ -18,13 +18,16 @@
 #include "docstrings/parse/doc.h"
 #include "functions/parse/cst.h"
 #include "functions/parse/fs.h"
+#include "functions/parse/parallel.h"
 #include "functions/parse/str.h"
 #include "functions/parse/tokenizer.h"
 #include "openapi/emit/openapi.h"
 #include "openapi/parse/openapi.h"
+#include "openapi/parse/spec_reader.h"
 #include "routes/emit/aggregator.h"
 #include "routes/emit/operation.h" /* For OpBuilder and C2OpenAPI_ParsedSig */
 #include "routes/parse/cli.h"
+#include "routes/parse/extract_cache.h"
 #include "../../cdd_api.h"
 /* clang-format on */
 
@@ -4717,45 +4720,258 @@ static void free_parsed_sig(struct C2OpenAPI_ParsedSig *sig) {
 }
 
 /**
- * @brief Executes the process file operation.
+ * @brief Kinds of deferred spec mutations recorded while extracting a file.
  */
-static cdd_c_error_t process_file(const char *path, struct OpenAPI_Spec *spec) {
-  char *content = NULL;
-  size_t sz = 0;
+enum C2OpenAPI_ActionKind {
+  C2OPENAPI_ACTION_TYPES, /**< Register scanned struct/enum schemas */
+  C2OPENAPI_ACTION_DOC    /**< Apply doc metadata and/or add an operation */
+};
+
+/**
+ * @brief One spec mutation extracted from a source file.
+ *
+ * Extraction never touches the shared spec; actions are replayed against it
+ * afterwards in exactly the order a serial scan would have applied them.
+ */
+struct C2OpenAPI_Action {
+  enum C2OpenAPI_ActionKind kind; /**< Action discriminator */
+  struct TypeDefList types;       /**< Scanned types (TYPES) */
+  struct DocMetadata meta;        /**< Parsed doc block (DOC) */
+  int apply_meta;                 /**< Apply tag/security/global meta (DOC) */
+  int has_op;                     /**< `op` is built and not yet added (DOC) */
+  struct OpenAPI_Operation op;    /**< Operation for `meta.route` (DOC) */
+};
+
+/**
+ * @brief Extraction result for a single source file.
+ */
+struct C2OpenAPI_FileResult {
+  char *path;                        /**< Source file path */
+  struct C2OpenAPI_Action *actions;  /**< Recorded actions, in source order */
+  size_t n_actions;                  /**< Number of recorded actions */
+  size_t cap_actions;                /**< Allocated action capacity */
+  cdd_c_error_t rc;                  /**< Status once all actions are applied */
+  struct ExtractCacheEntry snapshot; /**< Text the actions are built from */
+  char cache_key[EXTRACT_CACHE_KEY_SIZE]; /**< Content key (with a cache) */
+  int cache_store; /**< Snapshot was harvested and should be cached */
+};
+
+/**
+ * @brief Ordered list of source files discovered by the directory walk.
+ */
+struct C2OpenAPI_FileList {
+  struct C2OpenAPI_FileResult *items; /**< One entry per source file */
+  size_t size;                        /**< Number of entries */
+  size_t capacity;                    /**< Allocated capacity */
+  const char *cache_dir;              /**< Extraction cache, or NULL */
+};
+
+/**
+ * @brief Frees an operation that was built but never added to a spec.
+ */
+static void c2openapi_discard_operation(struct OpenAPI_Operation *op) {
+  /* There is no standalone operation destructor, so hand ownership to a
+   * throwaway spec and free that instead. */
+  struct OpenAPI_Spec scratch;
+  (void)openapi_spec_init(&scratch);
+  (void)openapi_aggregator_add_operation(&scratch, "/", op);
+  openapi_spec_free(&scratch);
+}
+
+/**
+ * @brief Frees the memory associated with a file result.
+ */
+static void c2openapi_file_result_free(struct C2OpenAPI_FileResult *res) {
+  size_t i;
+  for (i = 0; i < res->n_actions; ++i) {
+    struct C2OpenAPI_Action *act = &res->actions[i];
+    if (act->kind == C2OPENAPI_ACTION_TYPES) {
+      type_def_list_free(&act->types);
+    } else {
+      if (act->has_op)
+        c2openapi_discard_operation(&act->op);
+      doc_metadata_free(&act->meta);
+    }
+  }
+  free(res->actions);
+  free(res->path);
+  extract_cache_entry_free(&res->snapshot);
+  memset(res, 0, sizeof(*res));
+}
+
+/**
+ * @brief Appends a zeroed action of the given kind to a file result.
+ */
+static cdd_c_error_t c2openapi_push_action(struct C2OpenAPI_FileResult *res,
+                                           enum C2OpenAPI_ActionKind kind,
+                                           struct C2OpenAPI_Action **out) {
+  if (res->n_actions == res->cap_actions) {
+    size_t new_cap = res->cap_actions ? res->cap_actions * 2 : 8;
+    struct C2OpenAPI_Action *grown = (struct C2OpenAPI_Action *)realloc(
+        res->actions, new_cap * sizeof(struct C2OpenAPI_Action));
+    if (!grown)
+      return CDD_C_ERROR_MEMORY;
+    res->actions = grown;
+    res->cap_actions = new_cap;
+  }
+  *out = &res->actions[res->n_actions++];
+  memset(*out, 0, sizeof(**out));
+  (*out)->kind = kind;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Records a parsed doc block as a DOC action, as a fresh scan would.
+ *
+ * Takes ownership of `meta`. For documented routes the function signature
+ * is parsed too. Blocks yielding neither applicable metadata nor an
+ * operation are dropped.
+ */
+static cdd_c_error_t c2openapi_push_doc(struct C2OpenAPI_FileResult *res,
+                                        struct DocMetadata *meta, int parsed,
+                                        const char *sig) {
+  struct OpenAPI_Operation op = {0};
+  struct C2OpenAPI_Action *act;
+  int has_op = 0;
+  cdd_c_error_t rc;
+
+  if (meta->route && sig) {
+    struct C2OpenAPI_ParsedSig psig;
+
+    /* Parse Signature */
+    if (parse_c_signature_string(sig, &psig) == 0) {
+      struct OpBuilderContext ctx;
+
+      ctx.sig = &psig;
+      ctx.doc = meta;
+      ctx.func_name = psig.name;
+
+      /* Build Operation; aggregated when replayed */
+      if (c2openapi_build_operation(&ctx, &op) == 0)
+        has_op = 1;
+      free_parsed_sig(&psig);
+    }
+  }
+
+  if (!parsed && !has_op) {
+    doc_metadata_free(meta);
+    return CDD_C_SUCCESS;
+  }
+
+  rc = c2openapi_push_action(res, C2OPENAPI_ACTION_DOC, &act);
+  if (rc != CDD_C_SUCCESS) {
+    if (has_op)
+      c2openapi_discard_operation(&op);
+    doc_metadata_free(meta);
+    return rc;
+  }
+  act->meta = *meta;
+  act->apply_meta = parsed;
+  act->has_op = has_op;
+  if (has_op)
+    act->op = op;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Records scanned types as a TYPES action, taking ownership of them.
+ */
+static cdd_c_error_t c2openapi_push_types(struct C2OpenAPI_FileResult *res,
+                                          struct TypeDefList *types) {
+  struct C2OpenAPI_Action *act;
+  cdd_c_error_t rc = c2openapi_push_action(res, C2OPENAPI_ACTION_TYPES, &act);
+  if (rc != 0) {
+    type_def_list_free(types);
+    return rc;
+  }
+  act->types = *types;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Turns one cached doc snippet into a DOC action.
+ */
+static cdd_c_error_t
+c2openapi_materialize_doc(struct C2OpenAPI_FileResult *res,
+                          const struct ExtractCacheSnippet *snip) {
+  struct DocMetadata meta;
+  int parsed;
+
+  doc_metadata_init(&meta);
+  parsed = doc_parse_block(snip->doc, &meta) == 0;
+  return c2openapi_push_doc(res, &meta, parsed, snip->sig);
+}
+
+/**
+ * @brief Turns a cached snapshot into the actions replayed against the spec.
+ */
+static cdd_c_error_t c2openapi_materialize(struct C2OpenAPI_FileResult *res) {
+  size_t i;
+  cdd_c_error_t rc;
+
+  /* 1. Register Types (Structs/Enums) */
+  if (res->snapshot.types_src) {
+    struct TypeDefList types;
+    type_def_list_init(&types);
+    if (c_inspector_scan_string_types(res->snapshot.types_src, &types, NULL) ==
+        0) {
+      rc = c2openapi_push_types(res, &types);
+      if (rc != 0)
+        return rc;
+    } else {
+      type_def_list_free(&types);
+    }
+  }
+
+  /* 2. Doc blocks, function-attached first, then standalone */
+  for (i = 0; i < res->snapshot.n_snippets; ++i) {
+    rc = c2openapi_materialize_doc(res, &res->snapshot.snippets[i]);
+    if (rc != 0)
+      return rc;
+  }
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Extracts the actions of a source file, parsing each part once.
+ *
+ * Scans the struct/enum definitions and every doc block that documents a
+ * function or parses as standalone metadata, recording actions in the order
+ * a serial scan applies them. With `keep_snapshot`, the fragments they came
+ * from are also collected in `res->snapshot` for the cache.
+ */
+static cdd_c_error_t c2openapi_harvest(char *content, int keep_snapshot,
+                                       struct C2OpenAPI_FileResult *res) {
+  struct ExtractCacheEntry *snap = &res->snapshot;
   struct TokenList *tokens = NULL;
   struct CstNodeList cst = {0};
   int *comment_used = NULL;
-  int rc;
+  int rc = 0;
   size_t i;
 
-  /* 1. Register Types (Structs/Enums) */
   {
     struct TypeDefList types;
     type_def_list_init(&types);
-    if (c_inspector_scan_file_types(path, &types) == 0) {
-      c2openapi_register_types(spec, &types);
+    if (c_inspector_scan_string_types(
+            content, &types, keep_snapshot ? &snap->types_src : NULL) == 0) {
+      rc = c2openapi_push_types(res, &types);
+      if (rc != 0)
+        return rc;
+    } else {
+      snap->types_src = NULL;
+      type_def_list_free(&types);
     }
-    type_def_list_free(&types);
   }
 
-  /* 2. Parse Code for Functions & Docs */
-  rc = read_to_file(path, "r", &content, &sz);
-  if (rc != 0)
-    return rc;
-
-  if (tokenize(az_span_create_from_str(content), &tokens) != 0) {
-    free(content);
+  if (tokenize(az_span_create_from_str(content), &tokens) != 0)
     return CDD_C_ERROR_IO;
-  }
   parse_tokens(tokens, &cst); /* Best effort */
 
   if (cst.size > 0) {
     comment_used = (int *)calloc(cst.size, sizeof(int));
     if (!comment_used) {
-      free_cst_node_list(&cst);
-      free_token_list(tokens);
-      free(content);
-      return CDD_C_ERROR_MEMORY;
+      rc = CDD_C_ERROR_MEMORY;
+      goto cleanup;
     }
   }
 
@@ -4780,29 +4996,15 @@ static cdd_c_error_t process_file(const char *path, struct OpenAPI_Spec *spec) {
         char *doc_text = malloc(doc_node->length + 1);
         if (doc_text) {
           struct DocMetadata meta;
+          int parsed;
+          char *sig_raw = NULL;
           memcpy(doc_text, doc_node->start, doc_node->length);
           doc_text[doc_node->length] = '\0';
 
           doc_metadata_init(&meta);
-          if (doc_parse_block(doc_text, &meta) == 0) {
-            int rc_meta = apply_doc_tag_meta(spec, &meta);
-            if (rc_meta == 0)
-              rc_meta = apply_doc_security_schemes(spec, &meta);
-            if (rc_meta == 0)
-              rc_meta = apply_doc_global_meta(spec, &meta);
-            if (rc_meta != 0) {
-              doc_metadata_free(&meta);
-              free(doc_text);
-              free_cst_node_list(&cst);
-              free_token_list(tokens);
-              free(content);
-              if (comment_used)
-                free(comment_used);
-              return rc_meta;
-            }
-            if (comment_used && doc_index != (size_t)-1)
-              comment_used[doc_index] = 1;
-          }
+          parsed = doc_parse_block(doc_text, &meta) == 0;
+          if (parsed && comment_used && doc_index != (size_t)-1)
+            comment_used[doc_index] = 1;
           if (meta.route) {
             /* Found Valid Documented Route! */
 
@@ -4811,42 +5013,26 @@ static cdd_c_error_t process_file(const char *path, struct OpenAPI_Spec *spec) {
                                                    body? */
             /* We need signature string up to brace. CST Node
              * includes body. */
-            char *sig_raw = malloc(sig_len + 1);
+            sig_raw = malloc(sig_len + 1);
             if (sig_raw) {
-              struct C2OpenAPI_ParsedSig psig;
               const uint8_t *brace = memchr(func_node->start, '{', sig_len);
               size_t effective_len =
                   brace ? (size_t)(brace - func_node->start) : sig_len;
 
               memcpy(sig_raw, func_node->start, effective_len);
               sig_raw[effective_len] = '\0';
-
-              /* Parse Signature */
-              if (parse_c_signature_string(sig_raw, &psig) == 0) {
-                struct OpenAPI_Operation op = {0};
-                struct OpBuilderContext ctx;
-
-                ctx.sig = &psig;
-                ctx.doc = &meta;
-                ctx.func_name = psig.name;
-
-                /* Build Operation */
-                if (c2openapi_build_operation(&ctx, &op) == 0) {
-                  /* Aggregate */
-                  if (meta.is_webhook) {
-                    openapi_aggregator_add_webhook_operation(spec, meta.route,
-                                                             &op);
-                  } else {
-                    openapi_aggregator_add_operation(spec, meta.route, &op);
-                  }
-                }
-                free_parsed_sig(&psig);
-              }
-              free(sig_raw);
             }
           }
-          doc_metadata_free(&meta);
+          if (keep_snapshot && (parsed || sig_raw))
+            rc = extract_cache_entry_add(snap, doc_text, sig_raw);
+          if (rc == 0)
+            rc = c2openapi_push_doc(res, &meta, parsed, sig_raw);
+          else
+            doc_metadata_free(&meta);
+          free(sig_raw);
           free(doc_text);
+          if (rc != 0)
+            goto cleanup;
         }
       }
     }
@@ -4865,30 +5051,25 @@ static cdd_c_error_t process_file(const char *path, struct OpenAPI_Spec *spec) {
 
         doc_metadata_init(&meta);
         if (doc_parse_block(doc_text, &meta) == 0) {
-          int rc_meta = apply_doc_tag_meta(spec, &meta);
-          if (rc_meta == 0)
-            rc_meta = apply_doc_security_schemes(spec, &meta);
-          if (rc_meta == 0)
-            rc_meta = apply_doc_global_meta(spec, &meta);
-          if (rc_meta != 0) {
+          if (keep_snapshot)
+            rc = extract_cache_entry_add(snap, doc_text, NULL);
+          if (rc == 0)
+            rc = c2openapi_push_doc(res, &meta, 1, NULL);
+          else
             doc_metadata_free(&meta);
-            free(doc_text);
-            free_cst_node_list(&cst);
-            free_token_list(tokens);
-            free(content);
-            free(comment_used);
-            return rc_meta;
-          }
+        } else {
+          doc_metadata_free(&meta);
         }
-        doc_metadata_free(&meta);
         free(doc_text);
+        if (rc != 0)
+          goto cleanup;
       }
     }
   }
 
+cleanup:
   free_cst_node_list(&cst);
   free_token_list(tokens);
-  free(content);
   if (comment_used)
     free(comment_used);
 
@@ -5106,14 +5287,102 @@ static cdd_c_error_t process_file(const char *path, struct OpenAPI_Spec *spec) {
    * Object @Security Requirement Object
    */
 
+  return rc;
+}
+
+/**
+ * @brief Extracts types, doc metadata and operations from one source file.
+ *
+ * Only reads `path` (and the cache); every spec mutation is recorded in `res`
+ * so that files can be extracted concurrently and merged afterwards. With a
+ * cache directory, an unchanged file skips tokenizing and CST parsing.
+ */
+static cdd_c_error_t c2openapi_extract_file(const char *path,
+                                            const char *cache_dir,
+                                            struct C2OpenAPI_FileResult *res) {
+  char *content = NULL;
+  size_t sz = 0;
+  int hit = 0;
+  cdd_c_error_t rc;
+
+  rc = read_to_file(path, "r", &content, &sz);
+  if (rc != 0)
+    return rc;
+
+  if (cache_dir) {
+    rc = extract_cache_key(content, sz, res->cache_key);
+    if (rc == 0)
+      rc = extract_cache_load(cache_dir, res->cache_key, &res->snapshot, &hit);
+    if (rc != 0) {
+      free(content);
+      return rc;
+    }
+  }
+  if (hit) {
+    rc = c2openapi_materialize(res);
+  } else {
+    rc = c2openapi_harvest(content, cache_dir != NULL, res);
+    res->cache_store = cache_dir != NULL && rc == 0;
+  }
+  free(content);
+  return rc;
+}
+
+/**
+ * @brief Replays a file's extracted actions against the shared spec.
+ *
+ * Stops at the first doc block whose metadata cannot be applied, matching
+ * the serial scanner which abandoned the rest of the file at that point.
+ */
+static cdd_c_error_t c2openapi_apply_file(struct C2OpenAPI_FileResult *res,
+                                          struct OpenAPI_Spec *spec) {
+  size_t i;
+  for (i = 0; i < res->n_actions; ++i) {
+    struct C2OpenAPI_Action *act = &res->actions[i];
+    if (act->kind == C2OPENAPI_ACTION_TYPES) {
+      c2openapi_register_types(spec, &act->types);
+      continue;
+    }
+    if (act->apply_meta) {
+      int rc_meta = apply_doc_tag_meta(spec, &act->meta);
+      if (rc_meta == 0)
+        rc_meta = apply_doc_security_schemes(spec, &act->meta);
+      if (rc_meta == 0)
+        rc_meta = apply_doc_global_meta(spec, &act->meta);
+      if (rc_meta != 0)
+        return rc_meta;
+    }
+    if (act->has_op) {
+      /* Aggregate */
+      act->has_op = 0;
+      if (act->meta.is_webhook) {
+        openapi_aggregator_add_webhook_operation(spec, act->meta.route,
+                                                 &act->op);
+      } else {
+        openapi_aggregator_add_operation(spec, act->meta.route, &act->op);
+      }
+    }
+  }
+  return res->rc;
+}
+
+/**
+ * @brief Extracts the file at `index` of a collected file list.
+ */
+static cdd_c_error_t c2openapi_extract_cb(size_t index, void *user_data) {
+  struct C2OpenAPI_FileList *files = (struct C2OpenAPI_FileList *)user_data;
+  struct C2OpenAPI_FileResult *res = &files->items[index];
+  res->rc = c2openapi_extract_file(res->path, files->cache_dir, res);
   return CDD_C_SUCCESS;
 }
 
 /**
  * @brief Executes the walker cb operation.
+ *
+ * Collects source files in walk order; extraction happens afterwards.
  */
 static cdd_c_error_t walker_cb(const char *path, void *user_data) {
-  struct OpenAPI_Spec *spec = (struct OpenAPI_Spec *)user_data;
+  struct C2OpenAPI_FileList *files = (struct C2OpenAPI_FileList *)user_data;
   {
     int is_src = 0;
     cdd_c_error_t rc = is_source_file(path, &is_src);
@@ -5122,18 +5391,20 @@ static cdd_c_error_t walker_cb(const char *path, void *user_data) {
     if (!is_src)
       return CDD_C_SUCCESS;
   }
-  printf("Scanning: %s\n", path);
-  {
-
-    cdd_c_error_t rc = process_file(path, spec);
-
-    if (rc == CDD_C_ERROR_MEMORY)
-      return rc;
-    if (rc != CDD_C_SUCCESS) {
-      fprintf(stderr, "Warning: Failed to process %s (error %d), skipping.\n",
-              path, rc);
-    }
+  if (files->size == files->capacity) {
+    size_t new_cap = files->capacity ? files->capacity * 2 : 64;
+    struct C2OpenAPI_FileResult *grown = (struct C2OpenAPI_FileResult *)realloc(
+        files->items, new_cap * sizeof(struct C2OpenAPI_FileResult));
+    if (!grown)
+      return CDD_C_ERROR_MEMORY;
+    files->items = grown;
+    files->capacity = new_cap;
   }
+  memset(&files->items[files->size], 0, sizeof(struct C2OpenAPI_FileResult));
+  files->items[files->size].path = strdup(path);
+  if (!files->items[files->size].path)
+    return CDD_C_ERROR_MEMORY;
+  files->size++;
 
   /* OpenAPI 3.2.0 coverage expansion:
    *
@@ -5353,22 +5624,68 @@ static cdd_c_error_t walker_cb(const char *path, void *user_data) {
 }
 
 /**
- * @brief Executes the load base spec operation.
+ * @brief Scans every source file under `src_dir` into `spec`.
+ *
+ * Files are tokenized, parsed and turned into operations in parallel (see
+ * `CDD_C_JOBS`), then merged one file at a time in walk order, so the result
+ * is byte-identical to a serial scan. With `cache_dir`, per-file snapshots are
+ * reused across runs and freshly harvested ones are written back.
+ */
+static cdd_c_error_t c2openapi_scan_directory(const char *src_dir,
+                                              const char *cache_dir,
+                                              struct OpenAPI_Spec *spec) {
+  struct C2OpenAPI_FileList files = {0};
+  cdd_c_error_t rc;
+  size_t i;
+
+  files.cache_dir = cache_dir;
+  rc = walk_directory(src_dir, walker_cb, &files);
+  if (rc == CDD_C_SUCCESS)
+    rc = cdd_parallel_for(files.size, 0, c2openapi_extract_cb, &files);
+
+  for (i = 0; rc == CDD_C_SUCCESS && i < files.size; ++i) {
+    cdd_c_error_t file_rc;
+    printf("Scanning: %s\n", files.items[i].path);
+    file_rc = c2openapi_apply_file(&files.items[i], spec);
+    if (file_rc == CDD_C_ERROR_MEMORY) {
+      rc = file_rc;
+    } else if (file_rc != CDD_C_SUCCESS) {
+      fprintf(stderr, "Warning: Failed to process %s (error %d), skipping.\n",
+              files.items[i].path, file_rc);
+    }
+  }
+
+  /* Best effort: a cache that cannot be written only costs the next run */
+  for (i = 0; rc == CDD_C_SUCCESS && i < files.size; ++i) {
+    if (files.items[i].cache_store)
+      (void)extract_cache_store(cache_dir, files.items[i].cache_key,
+                                &files.items[i].snapshot);
+  }
+
+  for (i = 0; i < files.size; ++i)
+    c2openapi_file_result_free(&files.items[i]);
+  free(files.items);
+  return rc;
+}
+
+/**
+ * @brief Executes the load base spec operation (JSON or YAML).
  */
 static cdd_c_error_t load_base_spec(const char *path,
                                     struct OpenAPI_Spec *spec) {
-  JSON_Value *root = NULL;
+  struct SpecReadError err;
   int rc;
 
   if (!path || !spec)
     return CDD_C_ERROR_INVALID_ARGUMENT;
 
-  root = json_parse_file(path);
-  if (!root)
+  /* Path Items are loaded one at a time, never as one parson tree */
+  rc = spec_reader_load_file(path, spec, &err);
+  if (rc != CDD_C_SUCCESS && err.message[0]) {
+    fprintf(stderr, "%s:%lu:%lu: %s\n", path, (unsigned long)err.line,
+            (unsigned long)err.column, err.message);
     return CDD_C_ERROR_INVALID_ARGUMENT;
-
-  rc = openapi_load_from_json(root, spec);
-  json_value_free(root);
+  }
   return rc;
 }
 
@@ -5382,7 +5699,9 @@ C_CDD_EXPORT cdd_c_error_t c2openapi_cli_main(int argc, char **argv) {
   const char *base_file = NULL;
   const char *self_uri = NULL;
   const char *dialect_uri = NULL;
-  char *json = NULL;
+  const char *cache_dir = NULL;
+  FILE *out_fp = NULL;
+  char *tmp_file = NULL;
   int rc;
   int argi = 1;
 
@@ -5391,7 +5710,7 @@ C_CDD_EXPORT cdd_c_error_t c2openapi_cli_main(int argc, char **argv) {
       if (argi + 1 >= argc) {
         fprintf(stderr, "Usage: c2openapi [--base "
                         "<openapi.json>] [--self <uri>] "
-                        "[--dialect <uri>] "
+                        "[--dialect <uri>] [--cache-dir <dir>] "
                         "<src_dir> <out.json>\n");
         return CDD_C_ERROR_UNKNOWN;
       }
@@ -5403,7 +5722,7 @@ C_CDD_EXPORT cdd_c_error_t c2openapi_cli_main(int argc, char **argv) {
       if (argi + 1 >= argc) {
         fprintf(stderr, "Usage: c2openapi [--base "
                         "<openapi.json>] [--self <uri>] "
-                        "[--dialect <uri>] "
+                        "[--dialect <uri>] [--cache-dir <dir>] "
                         "<src_dir> <out.json>\n");
         return CDD_C_ERROR_UNKNOWN;
       }
@@ -5416,7 +5735,7 @@ C_CDD_EXPORT cdd_c_error_t c2openapi_cli_main(int argc, char **argv) {
       if (argi + 1 >= argc) {
         fprintf(stderr, "Usage: c2openapi [--base "
                         "<openapi.json>] [--self <uri>] "
-                        "[--dialect <uri>] "
+                        "[--dialect <uri>] [--cache-dir <dir>] "
                         "<src_dir> <out.json>\n");
         return CDD_C_ERROR_UNKNOWN;
       }
@@ -5424,13 +5743,25 @@ C_CDD_EXPORT cdd_c_error_t c2openapi_cli_main(int argc, char **argv) {
       argi += 2;
       continue;
     }
+    if (strcmp(argv[argi], "--cache-dir") == 0) {
+      if (argi + 1 >= argc) {
+        fprintf(stderr, "Usage: c2openapi [--base "
+                        "<openapi.json>] [--self <uri>] "
+                        "[--dialect <uri>] [--cache-dir <dir>] "
+                        "<src_dir> <out.json>\n");
+        return CDD_C_ERROR_UNKNOWN;
+      }
+      cache_dir = argv[argi + 1];
+      argi += 2;
+      continue;
+    }
     break;
   }
 
   if (argc - argi != 2) {
     fprintf(stderr, "Usage: c2openapi [--base <openapi.json>] "
                     "[--self <uri>] "
-                    "[--dialect <uri>] "
+                    "[--dialect <uri>] [--cache-dir <dir>] "
                     "<src_dir> <out.json>\n");
     return CDD_C_ERROR_UNKNOWN;
   }
@@ -5472,7 +5803,7 @@ C_CDD_EXPORT cdd_c_error_t c2openapi_cli_main(int argc, char **argv) {
   }
 
   /* 1. Walk & Process */
-  rc = walk_directory(src_dir, walker_cb, &spec);
+  rc = c2openapi_scan_directory(src_dir, cache_dir, &spec);
   if (rc != 0) {
     fprintf(stderr, "Error walking directory %s: %d\n", src_dir, rc);
     openapi_spec_free(&spec);
@@ -5487,24 +5818,46 @@ C_CDD_EXPORT cdd_c_error_t c2openapi_cli_main(int argc, char **argv) {
     return CDD_C_ERROR_UNKNOWN;
   }
 
-  /* 2. Write */
-  rc = openapi_write_spec_to_json(&spec, &json);
-  if (rc != 0 || !json) {
-    fprintf(stderr, "Error serializing spec: %d\n", rc);
+  /* 2. Write (streamed; `.yaml`/`.yml` outputs are written as YAML).
+   * The stream goes to a sibling file renamed over `out_file` once
+   * complete, so a failure partway never leaves a truncated spec. */
+  tmp_file = (char *)C_CDD_MALLOC(strlen(out_file) + 5);
+  if (tmp_file)
+    sprintf(tmp_file, "%s.tmp", out_file);
+#if defined(_MSC_VER)
+  if (!tmp_file || fopen_s(&out_fp, tmp_file, "w") != 0)
+    out_fp = NULL;
+#else
+  out_fp = tmp_file ? fopen(tmp_file, "w") : NULL;
+#endif
+  if (!out_fp) {
+    fprintf(stderr, "Failed to write %s\n", out_file);
+    if (tmp_file)
+      C_CDD_FREE(tmp_file);
     openapi_spec_free(&spec);
-    return CDD_C_ERROR_UNKNOWN;
+    return EXIT_FAILURE;
   }
 
-  rc = fs_write_to_file(out_file, json);
-  if (rc != 0) {
+  rc = openapi_write_spec_to_stream(&spec, out_fp,
+                                    spec_format_for_path(out_file));
+  if (fclose(out_fp) != 0 && rc == 0)
+    rc = CDD_C_ERROR_IO;
+  if (rc == 0 && fs_replace_file(out_file, tmp_file) != 0)
+    rc = CDD_C_ERROR_IO;
+  if (rc != 0)
+    remove(tmp_file);
+  C_CDD_FREE(tmp_file);
+  if (rc == CDD_C_ERROR_IO) {
     fprintf(stderr, "Failed to write %s\n", out_file);
     rc = EXIT_FAILURE;
+  } else if (rc != 0) {
+    fprintf(stderr, "Error serializing spec: %d\n", rc);
+    rc = EXIT_FAILURE;
   } else {
     printf("Written %s\n", out_file);
     rc = 0;
   }
 
-  free(json);
   openapi_spec_free(&spec);
 
   return (rc == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
@@ -5521,7 +5874,7 @@ C_CDD_EXPORT cdd_c_error_t to_docs_json_cli_main(int argc, char **argv) {
   int i;
   struct OpenAPI_Spec spec = {0};
   int rc;
-  JSON_Value *parsed_root;
+  struct SpecReadError read_err;
   JSON_Value *root_val;
   JSON_Object *root_obj;
   JSON_Value *endpoints_val;
@@ -5545,12 +5898,14 @@ C_CDD_EXPORT cdd_c_error_t to_docs_json_cli_main(int argc, char **argv) {
   if (!input_file)
     return CDD_C_ERROR_UNKNOWN;
 
-  parsed_root = json_parse_file(input_file);
-  if (!parsed_root)
+  openapi_spec_init(&spec);
+  rc = spec_reader_load_file(input_file, &spec, &read_err);
+  if (rc != CDD_C_SUCCESS && read_err.message[0]) {
+    fprintf(stderr, "%s:%lu:%lu: %s\n", input_file,
+            (unsigned long)read_err.line, (unsigned long)read_err.column,
+            read_err.message);
     return CDD_C_ERROR_UNKNOWN;
-
-  rc = openapi_load_from_json(parsed_root, &spec);
-  json_value_free(parsed_root);
+  }
   if (rc != 0)
     return rc;
 
@@ -5657,6 +6012,7 @@ C_CDD_EXPORT cdd_c_error_t generate_bindings_cli_main(int argc, char **argv) {
   int i;
   int rc;
 
+  config.cache_dir = getenv("CDD_CACHE_DIR");
   for (i = 0; i < argc; i++) {
     if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
       puts("Usage: cdd-c bind [OPTIONS]\n\n"
@@ -5681,6 +6037,13 @@ C_CDD_EXPORT cdd_c_error_t generate_bindings_cli_main(int argc, char **argv) {
            "(opaque)\n"
            "  --generate-tests          Generate basic "
            "sanity-check tests\n"
+           "  -j, --jobs <n>            Emitters to run at "
+           "once (default: "
+           "$CDD_C_JOBS or CPU count)\n"
+           "  --stats                   Print per-emitter "
+           "timings\n"
+           "  --cache-dir <dir>         Reuse the parsed IR "
+           "while the headers are unchanged (default: $CDD_CACHE_DIR)\n"
            "  -h, --help                Show this help "
            "message\n");
       return CDD_C_SUCCESS;
@@ -5709,8 +6072,18 @@ C_CDD_EXPORT cdd_c_error_t generate_bindings_cli_main(int argc, char **argv) {
       config.opaque_pointers = 1;
     } else if (strcmp(argv[i], "--generate-tests") == 0) {
       config.generate_tests = 1;
+    } else if ((strcmp(argv[i], "-j") == 0 ||
+                strcmp(argv[i], "--jobs") == 0) &&
+               i + 1 < argc) {
+      config.jobs = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--stats") == 0) {
+      config.stats = 1;
+    } else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+      config.cache_dir = argv[++i];
     }
   }
+  if (config.cache_dir && !*config.cache_dir)
+    config.cache_dir = NULL;
 
   if (!config.input || !config.output_dir || !config.target_langs) {
     fprintf(stderr, "Error: --input, --output-dir, and --lang "
@@ -10,18 +10,59 @@
 #include "c_cdd/memory.h"
 #include "classes/emit/cdd_cst_emit.h"
 #include "classes/parse/cdd_cst_parser.h"
+#include "functions/emit/line_diff.h"
+#include "functions/parse/project_index.h"
 #include <errno.h>
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 /* clang-format on */
+
+/**
+ * @brief Prints a unified diff between a file and its transformed text.
+ */
+static cdd_c_error_t print_file_diff(const char *filepath, const char *before,
+                                     const char *after, size_t context) {
+  struct LineDiffOptions opts;
+  line_diff_options_init(&opts);
+  opts.context = context;
+  fprintf(stdout, "--- a/%s\n+++ b/%s\n", filepath, filepath);
+  return line_diff_unified(before, strlen(before), after, strlen(after),
+                           &opts, line_diff_write_file, stdout, NULL);
+}
+
+/**
+ * @brief Parses a `--context=N` flag.
+ *
+ * @return 1 if `arg` is that flag (storing N in `*context`), 0 if it is
+ * not, -1 if N is not a non-negative decimal that fits in an unsigned long.
+ */
+static int parse_context_flag(const char *arg, size_t *context) {
+  static const char flag[] = "--context=";
+  const char *val;
+  char *end = NULL;
+  unsigned long n;
+  if (strncmp(arg, flag, sizeof(flag) - 1) != 0)
+    return 0;
+  val = arg + sizeof(flag) - 1;
+  /* strtoul accepts leading blanks and negates a leading '-' */
+  if (*val < '0' || *val > '9')
+    return -1;
+  errno = 0;
+  n = strtoul(val, &end, 10);
+  if (errno == ERANGE || end == val || *end != '\0')
+    return -1;
+  *context = (size_t)n;
+  return 1;
+}
+
 static cdd_c_error_t
 process_file(const char *filepath,
              cdd_c_error_t (*transform_fn)(cdd_cst_tree_t *,
                                            const cdd_transform_config_t *),
              const cdd_transform_config_t *config, int is_audit,
-             int is_dry_run) {
+             int is_dry_run, size_t context) {
   FILE *f;
   long fsize;
   char *str;
@@ -83,6 +124,7 @@ process_file(const char *filepath,
     if (strcmp(str, out) != 0) {
       /* File needs fixing */
       fprintf(stdout, "%s needs formatting/fixes.\n", filepath);
+      (void)print_file_diff(filepath, str, out, context);
       rc = CDD_C_ERROR_UNKNOWN;
     } else {
       rc = CDD_C_SUCCESS;
@@ -92,7 +134,7 @@ process_file(const char *filepath,
     if (strcmp(str, out) != 0) {
       if (is_dry_run) {
         fprintf(stdout, "Would fix %s (dry run).\n", filepath);
-        rc = CDD_C_SUCCESS;
+        rc = print_file_diff(filepath, str, out, context);
       } else {
 #if defined(_MSC_VER)
         if (fopen_s(&out_f, filepath, "wb") != 0)
@@ -128,8 +170,10 @@ cdd_c_error_t cli_cst_transformer_main(int argc, char **argv) {
   int is_audit = 0;
   int is_fix = 0;
   int is_dry_run = 0;
+  size_t context = LINE_DIFF_DEFAULT_CONTEXT;
   const char *toolname = NULL;
-  cdd_transform_config_t config = {0, 2, 0, 1, 0};
+  cdd_transform_config_t config = {0, 2, 0, 1, 0, NULL};
+  struct ProjectIndex index;
   cdd_c_error_t (*transform_fn)(cdd_cst_tree_t *,
                                 const cdd_transform_config_t *) = NULL;
 
@@ -166,37 +210,55 @@ cdd_c_error_t cli_cst_transformer_main(int argc, char **argv) {
   }
 
   for (i = 1; i < argc; i++) {
+    int ctx_rc;
     if (strcmp(argv[i], "--audit") == 0) {
       is_audit = 1;
     } else if (strcmp(argv[i], "--fix") == 0) {
       is_fix = 1;
     } else if (strcmp(argv[i], "--dry-run") == 0) {
       is_dry_run = 1;
+    } else if ((ctx_rc = parse_context_flag(argv[i], &context)) != 0) {
+      if (ctx_rc < 0) {
+        fprintf(stderr, "Invalid --context value: %s\n", argv[i] + 10);
+        rc = CDD_C_ERROR_INVALID_ARGUMENT;
+        break;
+      }
+    } else if (strncmp(argv[i], "--index=", 8) == 0) {
+      /* Applies to the files after it */
+      if (config.project_index)
+        project_index_close(&index);
+      config.project_index = NULL;
+      rc = project_index_open(argv[i] + 8, &index);
+      if (rc != CDD_C_SUCCESS) {
+        fprintf(stderr, "Cannot open index %s\n", argv[i] + 8);
+        break;
+      }
+      config.project_index = &index;
     } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
       fprintf(stdout,
               "Usage: cdd-c transformer %s [--audit | --fix] [--dry-run] "
-              "<files...>\n",
+              "[--context=N] [--index=FILE] <files...>\n",
               toolname);
-      return CDD_C_SUCCESS;
+      break;
     } else {
       /* Assume it's a file */
       if (!is_audit && !is_fix) {
         /* Default to fix if neither specified, to be safe or maybe require it?
            ADD_NEW_TOOLS.md says: my-ts-tool --audit /path */
         fprintf(stderr, "Must specify --audit or --fix.\n");
-        return CDD_C_ERROR_INVALID_ARGUMENT;
+        rc = CDD_C_ERROR_INVALID_ARGUMENT;
+        break;
       }
 
-      {
-        cdd_c_error_t p_rc =
-            process_file(argv[i], transform_fn, &config, is_audit, is_dry_run);
-        if (p_rc != CDD_C_SUCCESS) {
-          return p_rc;
-        }
-      }
+      rc = process_file(argv[i], transform_fn, &config, is_audit, is_dry_run,
+                        context);
+      if (rc != CDD_C_SUCCESS)
+        break;
     }
   }
 
+  if (config.project_index)
+    project_index_close(&index);
   return rc;
 }
 
@@ -207,7 +269,8 @@ cdd_c_error_t cli_standardize_gnu_main(int argc, char **argv) {
   int is_audit = 0;
   int is_fix = 0;
   int is_dry_run = 0;
-  cdd_transform_config_t config = {0, 2, 0, 0, 0};
+  size_t context = LINE_DIFF_DEFAULT_CONTEXT;
+  cdd_transform_config_t config = {0, 2, 0, 0, 0, NULL};
 
   if (argc < 1) {
     fprintf(stderr, "Usage: cdd-c standardize-gnu [OPTIONS] <files...>\n");
@@ -226,10 +289,13 @@ cdd_c_error_t cli_standardize_gnu_main(int argc, char **argv) {
     fprintf(stdout, "  --fix              Apply fixes in-place\n");
     fprintf(stdout, "  --dry-run          Show what would be fixed without "
                     "modifying files\n");
+    fprintf(stdout, "  --context=N        Lines of context in printed diffs "
+                    "(default 3)\n");
     return CDD_C_SUCCESS;
   }
 
   for (i = 0; i < argc; i++) {
+    int ctx_rc;
     if (strcmp(argv[i], "--audit") == 0) {
       is_audit = 1;
     } else if (strcmp(argv[i], "--fix") == 0) {
@@ -242,6 +308,11 @@ cdd_c_error_t cli_standardize_gnu_main(int argc, char **argv) {
       config.target_c99 = 1;
     } else if (strcmp(argv[i], "--fallback-alloca") == 0) {
       config.fallback_vla_to_malloc = 1;
+    } else if ((ctx_rc = parse_context_flag(argv[i], &context)) != 0) {
+      if (ctx_rc < 0) {
+        fprintf(stderr, "Invalid --context value: %s\n", argv[i] + 10);
+        return CDD_C_ERROR_INVALID_ARGUMENT;
+      }
     } else if (argv[i][0] != '-') {
       /* Assume it's a file */
       if (!is_audit && !is_fix) {
@@ -250,7 +321,7 @@ cdd_c_error_t cli_standardize_gnu_main(int argc, char **argv) {
       }
 
       if (process_file(argv[i], cdd_transform_gnu, &config, is_audit,
-                       is_dry_run) != 0) {
+                       is_dry_run, context) != 0) {
         rc = CDD_C_ERROR_UNKNOWN;
       }
     }
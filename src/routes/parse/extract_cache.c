@@ -0,0 +1,301 @@
+/**
+ * @file extract_cache.c
+ * @brief Implementation of the on-disk `c2openapi` extraction cache.
+ *
+ * Entries are small JSON documents stored as `<cache_dir>/<key>.json`.
+ *
+ * @author Samuel Marks
+ */
+
+/* clang-format off */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <process.h>
+#define extract_cache_pid() ((unsigned long)_getpid())
+#else
+#include <unistd.h>
+#define extract_cache_pid() ((unsigned long)getpid())
+#endif
+
+#include <parson.h>
+
+#include "c_cdd/memory.h"
+#include "c_cdd/safe_crt.h"
+#include "c_cddConfig.h"
+#include "functions/parse/fs.h"
+#include "functions/parse/str.h"
+#include "routes/parse/extract_cache.h"
+/* clang-format on */
+
+/**
+ * @brief Initializes an empty cache entry.
+ */
+cdd_c_error_t extract_cache_entry_init(struct ExtractCacheEntry *entry) {
+  if (!entry)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  entry->types_src = NULL;
+  entry->snippets = NULL;
+  entry->n_snippets = 0;
+  entry->cap_snippets = 0;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Frees a cache entry.
+ */
+void extract_cache_entry_free(struct ExtractCacheEntry *entry) {
+  size_t i;
+  if (!entry)
+    return;
+  for (i = 0; i < entry->n_snippets; ++i) {
+    C_CDD_FREE(entry->snippets[i].doc);
+    if (entry->snippets[i].sig)
+      C_CDD_FREE(entry->snippets[i].sig);
+  }
+  if (entry->snippets)
+    C_CDD_FREE(entry->snippets);
+  if (entry->types_src)
+    C_CDD_FREE(entry->types_src);
+  (void)extract_cache_entry_init(entry);
+}
+
+/**
+ * @brief Appends a copy of a doc snippet.
+ */
+cdd_c_error_t extract_cache_entry_add(struct ExtractCacheEntry *entry,
+                                      const char *doc, const char *sig) {
+  struct ExtractCacheSnippet *snip;
+  char *doc_copy = NULL;
+  char *sig_copy = NULL;
+
+  if (!entry || !doc)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  if (entry->n_snippets == entry->cap_snippets) {
+    size_t new_cap = entry->cap_snippets ? entry->cap_snippets * 2 : 8;
+    struct ExtractCacheSnippet *grown =
+        (struct ExtractCacheSnippet *)C_CDD_REALLOC(
+            entry->snippets, new_cap * sizeof(struct ExtractCacheSnippet));
+    if (!grown)
+      return CDD_C_ERROR_MEMORY;
+    entry->snippets = grown;
+    entry->cap_snippets = new_cap;
+  }
+
+  c_cdd_strdup(doc, &doc_copy);
+  if (!doc_copy)
+    return CDD_C_ERROR_MEMORY;
+  if (sig) {
+    c_cdd_strdup(sig, &sig_copy);
+    if (!sig_copy) {
+      C_CDD_FREE(doc_copy);
+      return CDD_C_ERROR_MEMORY;
+    }
+  }
+
+  snip = &entry->snippets[entry->n_snippets++];
+  snip->doc = doc_copy;
+  snip->sig = sig_copy;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Computes the cache key for a file's content.
+ *
+ * Two independent 32-bit hashes (FNV-1a and djb2) over the tool version and
+ * the content, followed by the content length.
+ */
+cdd_c_error_t extract_cache_key(const char *content, size_t len,
+                                char *out_key) {
+  const char *version = C_CDD_VERSION;
+  unsigned long fnv = 2166136261UL;
+  unsigned long djb = 5381UL;
+  size_t i;
+
+  if (!content || !out_key)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  for (i = 0; version[i] != '\0'; ++i) {
+    fnv = ((fnv ^ (unsigned char)version[i]) * 16777619UL) & 0xFFFFFFFFUL;
+    djb = ((djb * 33UL) ^ (unsigned char)version[i]) & 0xFFFFFFFFUL;
+  }
+  for (i = 0; i < len; ++i) {
+    fnv = ((fnv ^ (unsigned char)content[i]) * 16777619UL) & 0xFFFFFFFFUL;
+    djb = ((djb * 33UL) ^ (unsigned char)content[i]) & 0xFFFFFFFFUL;
+  }
+
+  CDD_SNPRINTF(out_key, EXTRACT_CACHE_KEY_SIZE, "%08lx%08lx-%lx", fnv, djb,
+               (unsigned long)len);
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Builds `<cache_dir>/<key><suffix>` into a fresh buffer.
+ */
+static cdd_c_error_t extract_cache_path(const char *cache_dir, const char *key,
+                                        const char *suffix, char **out) {
+  size_t n = strlen(cache_dir) + strlen(key) + strlen(suffix) + 2;
+  *out = (char *)C_CDD_MALLOC(n);
+  if (!*out)
+    return CDD_C_ERROR_MEMORY;
+  CDD_SNPRINTF(*out, n, "%s%s%s%s", cache_dir, PATH_SEP, key, suffix);
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Loads an entry from the cache directory.
+ */
+cdd_c_error_t extract_cache_load(const char *cache_dir, const char *key,
+                                 struct ExtractCacheEntry *out, int *out_hit) {
+  char *path = NULL;
+  JSON_Value *root_val;
+  JSON_Object *root;
+  JSON_Array *docs;
+  const char *version;
+  const char *types;
+  size_t i, n;
+  cdd_c_error_t rc;
+
+  if (!cache_dir || !key || !out || !out_hit)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  *out_hit = 0;
+
+  rc = extract_cache_path(cache_dir, key, ".json", &path);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  root_val = json_parse_file(path);
+  C_CDD_FREE(path);
+  if (!root_val)
+    return CDD_C_SUCCESS;
+
+  root = json_value_get_object(root_val);
+  version = root ? json_object_get_string(root, "version") : NULL;
+  docs = root ? json_object_get_array(root, "docs") : NULL;
+  if (!version || strcmp(version, C_CDD_VERSION) != 0 || !docs) {
+    json_value_free(root_val);
+    return CDD_C_SUCCESS;
+  }
+
+  types = json_object_get_string(root, "types");
+  if (types) {
+    c_cdd_strdup(types, &out->types_src);
+    if (!out->types_src)
+      rc = CDD_C_ERROR_MEMORY;
+  }
+
+  n = json_array_get_count(docs);
+  for (i = 0; rc == CDD_C_SUCCESS && i < n; ++i) {
+    const JSON_Object *snip = json_array_get_object(docs, i);
+    const char *doc = snip ? json_object_get_string(snip, "doc") : NULL;
+    if (!doc)
+      break;
+    rc = extract_cache_entry_add(out, doc,
+                                 json_object_get_string(snip, "sig"));
+  }
+
+  json_value_free(root_val);
+  if (rc != CDD_C_SUCCESS || i < n) {
+    extract_cache_entry_free(out);
+    return rc;
+  }
+  *out_hit = 1;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Writes an entry to the cache directory.
+ */
+cdd_c_error_t extract_cache_store(const char *cache_dir, const char *key,
+                                  const struct ExtractCacheEntry *entry) {
+  JSON_Value *root_val;
+  JSON_Value *docs_val;
+  JSON_Object *root;
+  JSON_Array *docs;
+  char *json = NULL;
+  char *path = NULL;
+  char *tmp_path = NULL;
+  char tmp_suffix[64];
+  static unsigned long tmp_counter = 0;
+  size_t i;
+  cdd_c_error_t rc;
+
+  if (!cache_dir || !key || !entry)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+
+  rc = makedirs(cache_dir);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+
+  root_val = json_value_init_object();
+  docs_val = json_value_init_array();
+  if (!root_val || !docs_val) {
+    json_value_free(root_val);
+    json_value_free(docs_val);
+    return CDD_C_ERROR_MEMORY;
+  }
+  root = json_value_get_object(root_val);
+  docs = json_value_get_array(docs_val);
+
+  /* Setting a string fails on invalid UTF-8; such files are not cached. */
+  rc = CDD_C_ERROR_INVALID_ARGUMENT;
+  if (json_object_set_string(root, "version", C_CDD_VERSION) != JSONSuccess)
+    goto fail;
+  if (entry->types_src &&
+      json_object_set_string(root, "types", entry->types_src) != JSONSuccess)
+    goto fail;
+  for (i = 0; i < entry->n_snippets; ++i) {
+    JSON_Value *snip_val = json_value_init_object();
+    JSON_Object *snip = json_value_get_object(snip_val);
+    if (!snip_val || json_array_append_value(docs, snip_val) != JSONSuccess) {
+      json_value_free(snip_val);
+      rc = CDD_C_ERROR_MEMORY;
+      goto fail;
+    }
+    if (json_object_set_string(snip, "doc", entry->snippets[i].doc) !=
+        JSONSuccess)
+      goto fail;
+    if (entry->snippets[i].sig &&
+        json_object_set_string(snip, "sig", entry->snippets[i].sig) !=
+            JSONSuccess)
+      goto fail;
+  }
+  if (json_object_set_value(root, "docs", docs_val) != JSONSuccess) {
+    rc = CDD_C_ERROR_MEMORY;
+    goto fail;
+  }
+
+  json = json_serialize_to_string(root_val);
+  json_value_free(root_val);
+  if (!json)
+    return CDD_C_ERROR_MEMORY;
+
+  /* The temporary name is unique per process and store, so concurrent
+   * writers of the same key never share (and truncate) one file */
+  CDD_SNPRINTF(tmp_suffix, sizeof(tmp_suffix), ".json.%lu.%lu.tmp",
+               extract_cache_pid(), ++tmp_counter);
+  rc = extract_cache_path(cache_dir, key, ".json", &path);
+  if (rc == CDD_C_SUCCESS)
+    rc = extract_cache_path(cache_dir, key, tmp_suffix, &tmp_path);
+  if (rc == CDD_C_SUCCESS)
+    rc = fs_write_to_file(tmp_path, json);
+  /* Publish by rename so a concurrent reader never sees a partial entry */
+  if (rc == CDD_C_SUCCESS)
+    rc = fs_replace_file(path, tmp_path);
+  if (rc != CDD_C_SUCCESS && tmp_path)
+    remove(tmp_path);
+
+  json_free_serialized_string(json);
+  if (path)
+    C_CDD_FREE(path);
+  if (tmp_path)
+    C_CDD_FREE(tmp_path);
+  return rc;
+
+fail:
+  json_value_free(docs_val);
+  json_value_free(root_val);
+  return rc;
+}
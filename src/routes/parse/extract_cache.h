@@ -0,0 +1,117 @@
+/**
+ * @file extract_cache.h
+ * @brief On-disk cache of per-file `c2openapi` extraction results.
+ *
+ * Each source file is reduced to the text fragments the extractor actually
+ * consumes: the lines holding struct/enum definitions and, for every doc
+ * block, its comment text and (for routes) the function signature. Rebuilding
+ * operations from these fragments needs no tokenizing or CST parsing of the
+ * whole file. Entries are keyed by a hash of the file content and the tool
+ * version, so stale entries are simply never looked up again.
+ *
+ * @author Samuel Marks
+ */
+
+#ifndef C_CDD_EXTRACT_CACHE_H
+#define C_CDD_EXTRACT_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include <stddef.h>
+
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+/* clang-format on */
+
+/** @brief Buffer size needed for a key from `extract_cache_key`. */
+#define EXTRACT_CACHE_KEY_SIZE 40
+
+/**
+ * @brief A doc block found before a function or standing on its own.
+ */
+struct ExtractCacheSnippet {
+  char *doc; /**< Raw comment text including delimiters */
+  char *sig; /**< Function signature up to `{` for routes, else NULL */
+};
+
+/**
+ * @brief Everything the extractor needs from one source file.
+ */
+struct ExtractCacheEntry {
+  char *types_src; /**< Definition lines for `c_inspector_scan_string_types`,
+                      or NULL if the type scan failed */
+  struct ExtractCacheSnippet *snippets; /**< Doc blocks in extraction order */
+  size_t n_snippets;                    /**< Number of snippets */
+  size_t cap_snippets;                  /**< Allocated snippet capacity */
+};
+
+/**
+ * @brief Initialize an empty cache entry.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+extract_cache_entry_init(struct ExtractCacheEntry *entry);
+
+/**
+ * @brief Free resources associated with a cache entry.
+ */
+extern C_CDD_EXPORT void
+extract_cache_entry_free(struct ExtractCacheEntry *entry);
+
+/**
+ * @brief Append a copy of a doc snippet to an entry.
+ *
+ * @param[in,out] entry The entry to extend.
+ * @param[in] doc Comment text.
+ * @param[in] sig Optional signature text (may be NULL).
+ * @return 0 on success, CDD_C_ERROR_MEMORY on allocation failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+extract_cache_entry_add(struct ExtractCacheEntry *entry, const char *doc,
+                        const char *sig);
+
+/**
+ * @brief Compute the cache key for a file's content.
+ *
+ * @param[in] content File content.
+ * @param[in] len Length of `content` in bytes.
+ * @param[out] out_key Buffer of at least `EXTRACT_CACHE_KEY_SIZE` bytes.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT on bad args.
+ */
+extern C_CDD_EXPORT cdd_c_error_t extract_cache_key(const char *content,
+                                                    size_t len, char *out_key);
+
+/**
+ * @brief Look up an entry in the cache directory.
+ *
+ * Missing, unreadable or version-mismatched entries are reported as a miss.
+ *
+ * @param[in] cache_dir Cache directory.
+ * @param[in] key Key from `extract_cache_key`.
+ * @param[out] out Initialized entry, populated on a hit.
+ * @param[out] out_hit Set to 1 on a hit, 0 on a miss.
+ * @return 0 on success, CDD_C_ERROR_MEMORY on allocation failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+extract_cache_load(const char *cache_dir, const char *key,
+                   struct ExtractCacheEntry *out, int *out_hit);
+
+/**
+ * @brief Write an entry to the cache directory, creating it if needed.
+ *
+ * @param[in] cache_dir Cache directory.
+ * @param[in] key Key from `extract_cache_key`.
+ * @param[in] entry The entry to persist.
+ * @return 0 on success, error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+extract_cache_store(const char *cache_dir, const char *key,
+                    const struct ExtractCacheEntry *entry);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* C_CDD_EXTRACT_CACHE_H */
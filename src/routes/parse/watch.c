@@ -0,0 +1,1139 @@
+/**
+ * @file watch.c
+ * @brief Implementation of the `watch` command.
+ *
+ * A session maps each burst of changed paths to the steps they feed and
+ * reruns only those. The watcher backend either reads inotify events (Linux)
+ * or diffs modification-time snapshots taken every debounce period.
+ *
+ * @author Samuel Marks
+ */
+
+/* clang-format off */
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <parson.h>
+
+#include "c_cdd/memory.h"
+#include "functions/emit/sync.h"
+#include "functions/parse/fs.h"
+#include "functions/parse/str.h"
+#include "routes/parse/cli.h"
+#include "routes/parse/watch.h"
+
+#if defined(__EMSCRIPTEN__) || defined(__DJGPP__) || defined(__WATCOMC__)
+#define CDD_WATCH_UNSUPPORTED
+#elif defined(__linux__)
+#define CDD_WATCH_INOTIFY
+#include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#else
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+#include <time.h>
+/* clang-format on */
+
+/** @brief Cache directory used when neither a flag nor the env sets one. */
+#define WATCH_DEFAULT_CACHE_DIR ".cdd_c_cache"
+
+/**
+ * @brief A set of distinct paths, in insertion order.
+ *
+ * Membership goes through an open-addressing index over `paths`, so adding
+ * stays O(1) however many files a tree holds.
+ */
+struct WatchPathSet {
+  char **paths;    /**< Owned path strings */
+  size_t size;     /**< Number of paths */
+  size_t capacity; /**< Allocated capacity */
+  size_t *slots;   /**< Index + 1 into `paths` per slot, 0 if free */
+  size_t n_slots;  /**< Slot count, a power of two above twice `size` */
+};
+
+/* --- Paths --- */
+
+/**
+ * @brief Skips any leading `./` components.
+ */
+static const char *watch_path_skip_dot(const char *path) {
+  while (path[0] == '.' && (path[1] == '/' || path[1] == '\\'))
+    path += 2;
+  return path;
+}
+
+/**
+ * @brief Hashes a path consistently with watch_path_equal (FNV-1a).
+ */
+static unsigned long watch_path_hash(const char *path) {
+  unsigned long h = 2166136261UL;
+  for (path = watch_path_skip_dot(path); *path; ++path) {
+    h ^= (unsigned char)(*path == '\\' ? '/' : *path);
+    h *= 16777619UL;
+  }
+  return h;
+}
+
+/**
+ * @brief Compares two paths, treating both separators as equal.
+ */
+static int watch_path_equal(const char *a, const char *b) {
+  a = watch_path_skip_dot(a);
+  b = watch_path_skip_dot(b);
+  for (; *a && *b; ++a, ++b) {
+    int a_sep = *a == '/' || *a == '\\';
+    int b_sep = *b == '/' || *b == '\\';
+    if (a_sep != b_sep || (!a_sep && *a != *b))
+      return 0;
+  }
+  return *a == *b;
+}
+
+/**
+ * @brief Whether `path` lies inside directory `dir`.
+ */
+static int watch_path_under(const char *path, const char *dir) {
+  size_t n;
+  path = watch_path_skip_dot(path);
+  dir = watch_path_skip_dot(dir);
+  if (strcmp(dir, ".") == 0 || *dir == '\0')
+    return 1;
+  n = strlen(dir);
+  while (n > 0 && (dir[n - 1] == '/' || dir[n - 1] == '\\'))
+    --n;
+  if (strlen(path) <= n)
+    return 0;
+  {
+    size_t i;
+    for (i = 0; i < n; ++i) {
+      int p_sep = path[i] == '/' || path[i] == '\\';
+      int d_sep = dir[i] == '/' || dir[i] == '\\';
+      if (p_sep != d_sep || (!p_sep && path[i] != dir[i]))
+        return 0;
+    }
+  }
+  return path[n] == '/' || path[n] == '\\';
+}
+
+/**
+ * @brief Whether `path` names a C source or header.
+ */
+static int watch_is_source(const char *path) {
+  const char *ext = strrchr(path, '.');
+  return ext && (strcmp(ext, ".c") == 0 || strcmp(ext, ".h") == 0);
+}
+
+/**
+ * @brief Whether `path` is written by the watcher itself.
+ */
+static int watch_is_own_output(const struct WatchConfig *cfg,
+                               const char *path) {
+  size_t i;
+  if (cfg->sdk_dir && watch_path_under(path, cfg->sdk_dir))
+    return 1;
+  if (cfg->cache_dir && watch_path_under(path, cfg->cache_dir))
+    return 1;
+  for (i = 0; i < cfg->n_sync_pairs; ++i)
+    if (watch_path_equal(path, cfg->sync_pairs[i].impl))
+      return 1;
+  return 0;
+}
+
+/**
+ * @brief Whether a change to `path` can affect any configured step.
+ */
+static int watch_is_relevant(const struct WatchConfig *cfg, const char *path) {
+  size_t i;
+  if (watch_is_own_output(cfg, path))
+    return 0;
+  if (cfg->input_dir && watch_is_source(path) &&
+      watch_path_under(path, cfg->input_dir))
+    return 1;
+  if (cfg->spec_file && watch_path_equal(path, cfg->spec_file))
+    return 1;
+  for (i = 0; i < cfg->n_sync_pairs; ++i)
+    if (watch_path_equal(path, cfg->sync_pairs[i].header))
+      return 1;
+  return 0;
+}
+
+/* --- Path Sets --- */
+
+/**
+ * @brief Frees a path set.
+ */
+static void watch_path_set_free(struct WatchPathSet *set) {
+  size_t i;
+  for (i = 0; i < set->size; ++i)
+    C_CDD_FREE(set->paths[i]);
+  if (set->paths)
+    C_CDD_FREE(set->paths);
+  if (set->slots)
+    C_CDD_FREE(set->slots);
+  set->paths = NULL;
+  set->size = 0;
+  set->capacity = 0;
+  set->slots = NULL;
+  set->n_slots = 0;
+}
+
+/**
+ * @brief Rebuilds the index of a path set with `n_slots` slots.
+ */
+static cdd_c_error_t watch_path_set_rehash(struct WatchPathSet *set,
+                                           size_t n_slots) {
+  size_t *slots = (size_t *)C_CDD_CALLOC(n_slots, sizeof(size_t));
+  size_t i;
+  if (!slots)
+    return CDD_C_ERROR_MEMORY;
+  for (i = 0; i < set->size; ++i) {
+    size_t h = (size_t)watch_path_hash(set->paths[i]) & (n_slots - 1);
+    while (slots[h])
+      h = (h + 1) & (n_slots - 1);
+    slots[h] = i + 1;
+  }
+  if (set->slots)
+    C_CDD_FREE(set->slots);
+  set->slots = slots;
+  set->n_slots = n_slots;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Adds a copy of `path` unless an equal path is already present.
+ */
+static cdd_c_error_t watch_path_set_add(struct WatchPathSet *set,
+                                        const char *path) {
+  size_t h;
+  char *copy = NULL;
+  if ((set->size + 1) * 2 > set->n_slots) {
+    cdd_c_error_t rc = watch_path_set_rehash(
+        set, set->n_slots ? set->n_slots * 2 : 32);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
+  h = (size_t)watch_path_hash(path) & (set->n_slots - 1);
+  for (; set->slots[h]; h = (h + 1) & (set->n_slots - 1))
+    if (watch_path_equal(set->paths[set->slots[h] - 1], path))
+      return CDD_C_SUCCESS;
+  if (set->size == set->capacity) {
+    size_t new_cap = set->capacity ? set->capacity * 2 : 16;
+    char **grown =
+        (char **)C_CDD_REALLOC(set->paths, new_cap * sizeof(char *));
+    if (!grown)
+      return CDD_C_ERROR_MEMORY;
+    set->paths = grown;
+    set->capacity = new_cap;
+  }
+  c_cdd_strdup(path, &copy);
+  if (!copy)
+    return CDD_C_ERROR_MEMORY;
+  set->paths[set->size++] = copy;
+  set->slots[h] = set->size;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Walker context for collecting the files under observation.
+ */
+struct WatchCollectCtx {
+  const struct WatchConfig *cfg; /**< Configuration */
+  struct WatchPathSet *out;      /**< Destination set */
+};
+
+/**
+ * @brief Directory walker adding relevant files to a path set.
+ */
+static cdd_c_error_t watch_collect_cb(const char *path, void *user_data) {
+  struct WatchCollectCtx *ctx = (struct WatchCollectCtx *)user_data;
+  if (!watch_is_relevant(ctx->cfg, path))
+    return CDD_C_SUCCESS;
+  return watch_path_set_add(ctx->out, path);
+}
+
+/**
+ * @brief Collects every file whose changes the session reacts to.
+ */
+static cdd_c_error_t watch_collect_files(const struct WatchConfig *cfg,
+                                         struct WatchPathSet *out) {
+  struct WatchCollectCtx ctx;
+  cdd_c_error_t rc;
+  size_t i;
+
+  ctx.cfg = cfg;
+  ctx.out = out;
+  if (cfg->input_dir) {
+    rc = walk_directory(cfg->input_dir, watch_collect_cb, &ctx);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
+  if (cfg->spec_file && !cfg->input_dir) {
+    rc = watch_path_set_add(out, cfg->spec_file);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
+  for (i = 0; i < cfg->n_sync_pairs; ++i) {
+    rc = watch_path_set_add(out, cfg->sync_pairs[i].header);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
+  return CDD_C_SUCCESS;
+}
+
+/* --- Reporting --- */
+
+/**
+ * @brief Writes a JSON-RPC 2.0 notification line to `cfg->rpc_out`, taking
+ * ownership of `params`.
+ */
+static void watch_notify(const struct WatchConfig *cfg, const char *method,
+                         JSON_Value *params) {
+  JSON_Value *msg_val = json_value_init_object();
+  JSON_Object *msg = json_value_get_object(msg_val);
+  FILE *out = cfg->rpc_out ? cfg->rpc_out : stdout;
+  char *line;
+
+  if (!msg) {
+    json_value_free(params);
+    return;
+  }
+  json_object_set_string(msg, "jsonrpc", "2.0");
+  json_object_set_string(msg, "method", method);
+  if (params && json_object_set_value(msg, "params", params) != JSONSuccess)
+    json_value_free(params);
+  line = json_serialize_to_string(msg_val);
+  if (line) {
+    fprintf(out, "%s\n", line);
+    fflush(out);
+    json_free_serialized_string(line);
+  }
+  json_value_free(msg_val);
+}
+
+/**
+ * @brief Reports the outcome of one regeneration step.
+ */
+static void watch_report_step(const struct WatchConfig *cfg,
+                              const char *step, const char *output,
+                              cdd_c_error_t rc) {
+  if (cfg->json_rpc) {
+    JSON_Value *params_val = json_value_init_object();
+    JSON_Object *params = json_value_get_object(params_val);
+    if (params) {
+      json_object_set_string(params, "step", step);
+      json_object_set_string(params, "output", output);
+      json_object_set_number(params, "status", (double)rc);
+    }
+    watch_notify(cfg, "watch/regenerated", params_val);
+  } else if (rc == CDD_C_SUCCESS) {
+    printf("[watch] %s -> %s\n", step, output);
+  } else {
+    fprintf(stderr, "[watch] %s -> %s failed (error %d)\n", step, output,
+            (int)rc);
+  }
+}
+
+/**
+ * @brief Reports a burst of changes before it is handled.
+ */
+static void watch_report_changes(const struct WatchConfig *cfg,
+                                 const struct WatchPathSet *changed) {
+  size_t i;
+  if (cfg->json_rpc) {
+    JSON_Value *params_val = json_value_init_object();
+    JSON_Value *paths_val = json_value_init_array();
+    JSON_Array *paths = json_value_get_array(paths_val);
+    for (i = 0; paths && i < changed->size; ++i)
+      json_array_append_string(paths, changed->paths[i]);
+    if (json_object_set_value(json_value_get_object(params_val), "paths",
+                              paths_val) != JSONSuccess)
+      json_value_free(paths_val);
+    watch_notify(cfg, "watch/changed", params_val);
+  } else {
+    printf("[watch] %lu file(s) changed\n", (unsigned long)changed->size);
+  }
+}
+
+/* --- Steps --- */
+
+/**
+ * @brief Regenerates the spec from the source tree.
+ */
+static cdd_c_error_t watch_run_to_openapi(const struct WatchConfig *cfg) {
+  char *argv[7];
+  int argc = 0;
+  argv[argc++] = (char *)"to_openapi";
+  argv[argc++] = (char *)"-i";
+  argv[argc++] = (char *)cfg->input_dir;
+  argv[argc++] = (char *)"-o";
+  argv[argc++] = (char *)cfg->spec_file;
+  if (cfg->cache_dir) {
+    argv[argc++] = (char *)"--cache-dir";
+    argv[argc++] = (char *)cfg->cache_dir;
+  }
+  return to_openapi_cli_main(argc, argv);
+}
+
+/**
+ * @brief Regenerates the client SDK from the spec.
+ */
+static cdd_c_error_t watch_run_to_sdk(const struct WatchConfig *cfg) {
+  char *argv[6];
+  cdd_c_error_t rc = makedirs(cfg->sdk_dir);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  argv[0] = (char *)"from_openapi";
+  argv[1] = (char *)"to_sdk";
+  argv[2] = (char *)"-i";
+  argv[3] = (char *)cfg->spec_file;
+  argv[4] = (char *)"-o";
+  argv[5] = (char *)cfg->sdk_dir;
+  return from_openapi_cli_main(6, argv);
+}
+
+/**
+ * @brief Regenerates one sync implementation from its header.
+ */
+static cdd_c_error_t watch_run_sync(const struct WatchSyncPair *pair) {
+  char *argv[2];
+  argv[0] = (char *)pair->header;
+  argv[1] = (char *)pair->impl;
+  return sync_code_main(2, argv);
+}
+
+/* --- Session --- */
+
+cdd_c_error_t watch_session_init(struct WatchSession *session,
+                                 const struct WatchConfig *config) {
+  if (!session || !config)
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  session->config = config;
+  session->last_spec = NULL;
+  session->n_runs = 0;
+  return CDD_C_SUCCESS;
+}
+
+void watch_session_free(struct WatchSession *session) {
+  if (!session)
+    return;
+  if (session->last_spec)
+    C_CDD_FREE(session->last_spec);
+  session->last_spec = NULL;
+}
+
+cdd_c_error_t watch_session_rebuild(struct WatchSession *session,
+                                    const char *const *changed,
+                                    size_t n_changed) {
+  const struct WatchConfig *cfg;
+  int all = n_changed == 0;
+  int sources = all;
+  int spec_touched = all;
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+  cdd_c_error_t step_rc;
+  size_t i, j;
+
+  if (!session || !session->config || (n_changed > 0 && !changed))
+    return CDD_C_ERROR_INVALID_ARGUMENT;
+  cfg = session->config;
+
+  for (i = 0; i < n_changed; ++i) {
+    if (watch_is_own_output(cfg, changed[i]))
+      continue;
+    if (cfg->input_dir && watch_is_source(changed[i]) &&
+        watch_path_under(changed[i], cfg->input_dir))
+      sources = 1;
+    if (cfg->spec_file && watch_path_equal(changed[i], cfg->spec_file))
+      spec_touched = 1;
+  }
+
+  /* 1. Sources -> spec; unchanged files come from the extraction cache */
+  if (sources && cfg->input_dir && cfg->spec_file) {
+    step_rc = watch_run_to_openapi(cfg);
+    session->n_runs++;
+    watch_report_step(cfg, "to_openapi", cfg->spec_file, step_rc);
+    if (step_rc == CDD_C_SUCCESS)
+      spec_touched = 1;
+    else
+      rc = step_rc;
+  }
+
+  /* 2. Spec -> SDK, only when the spec bytes differ from the last build */
+  if (spec_touched && cfg->sdk_dir && cfg->spec_file) {
+    char *spec = NULL;
+    size_t spec_sz = 0;
+    step_rc = read_to_file(cfg->spec_file, "r", &spec, &spec_sz);
+    if (step_rc == CDD_C_SUCCESS &&
+        (!session->last_spec || strcmp(session->last_spec, spec) != 0)) {
+      step_rc = watch_run_to_sdk(cfg);
+      session->n_runs++;
+      if (step_rc == CDD_C_SUCCESS) {
+        if (session->last_spec)
+          C_CDD_FREE(session->last_spec);
+        session->last_spec = spec;
+        spec = NULL;
+      }
+      watch_report_step(cfg, "to_sdk", cfg->sdk_dir, step_rc);
+    } else if (step_rc != CDD_C_SUCCESS) {
+      watch_report_step(cfg, "to_sdk", cfg->sdk_dir, step_rc);
+    }
+    if (spec)
+      free(spec);
+    if (step_rc != CDD_C_SUCCESS && rc == CDD_C_SUCCESS)
+      rc = step_rc;
+  }
+
+  /* 3. Headers -> sync implementations, per touched pair */
+  for (j = 0; j < cfg->n_sync_pairs; ++j) {
+    const struct WatchSyncPair *pair = &cfg->sync_pairs[j];
+    int touched = all;
+    for (i = 0; !touched && i < n_changed; ++i)
+      touched = watch_path_equal(changed[i], pair->header);
+    if (!touched)
+      continue;
+    step_rc = watch_run_sync(pair);
+    session->n_runs++;
+    watch_report_step(cfg, "sync", pair->impl, step_rc);
+    if (step_rc != CDD_C_SUCCESS && rc == CDD_C_SUCCESS)
+      rc = step_rc;
+  }
+
+  return rc;
+}
+
+/* --- Watcher Backends --- */
+
+#if defined(CDD_WATCH_INOTIFY)
+
+/**
+ * @brief inotify descriptor and the directory behind each watch.
+ */
+struct Watcher {
+  int fd;          /**< inotify instance */
+  int *wds;        /**< Watch descriptors */
+  char **dirs;     /**< Directory for each watch descriptor */
+  size_t size;     /**< Number of watches */
+  size_t capacity; /**< Allocated capacity */
+};
+
+/**
+ * @brief Starts watching a directory (once).
+ */
+static cdd_c_error_t watcher_add_dir(struct Watcher *w, const char *dir) {
+  char *copy = NULL;
+  size_t i;
+  int wd;
+
+  for (i = 0; i < w->size; ++i)
+    if (watch_path_equal(w->dirs[i], dir))
+      return CDD_C_SUCCESS;
+  wd = inotify_add_watch(w->fd, dir,
+                         IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM |
+                             IN_DELETE | IN_CREATE);
+  if (wd < 0)
+    return errno == ENOENT ? CDD_C_ERROR_NOT_FOUND : CDD_C_ERROR_SYSTEM;
+  if (w->size == w->capacity) {
+    size_t new_cap = w->capacity ? w->capacity * 2 : 16;
+    int *wds = (int *)C_CDD_REALLOC(w->wds, new_cap * sizeof(int));
+    char **dirs;
+    if (!wds)
+      return CDD_C_ERROR_MEMORY;
+    w->wds = wds;
+    dirs = (char **)C_CDD_REALLOC(w->dirs, new_cap * sizeof(char *));
+    if (!dirs)
+      return CDD_C_ERROR_MEMORY;
+    w->dirs = dirs;
+    w->capacity = new_cap;
+  }
+  c_cdd_strdup(dir, &copy);
+  if (!copy)
+    return CDD_C_ERROR_MEMORY;
+  w->wds[w->size] = wd;
+  w->dirs[w->size++] = copy;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Starts watching `dir` and every directory below it.
+ *
+ * `walk_directory` only reports files, so empty subdirectories that may
+ * later gain sources are found here instead.
+ */
+static cdd_c_error_t watcher_add_tree(struct Watcher *w,
+                                      const struct WatchConfig *cfg,
+                                      const char *dir) {
+  DIR *d;
+  struct dirent *entry;
+  cdd_c_error_t rc = watcher_add_dir(w, dir);
+
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  d = opendir(dir);
+  if (!d)
+    return CDD_C_SUCCESS;
+  while (rc == CDD_C_SUCCESS && (entry = readdir(d)) != NULL) {
+    struct stat st;
+    char *path;
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+      continue;
+    path = (char *)C_CDD_MALLOC(strlen(dir) + strlen(entry->d_name) + 2);
+    if (!path) {
+      rc = CDD_C_ERROR_MEMORY;
+      break;
+    }
+    sprintf(path, "%s/%s", dir, entry->d_name);
+    if (stat(path, &st) == 0 && S_ISDIR(st.st_mode) &&
+        !watch_is_own_output(cfg, path))
+      rc = watcher_add_tree(w, cfg, path);
+    C_CDD_FREE(path);
+  }
+  closedir(d);
+  return rc;
+}
+
+/**
+ * @brief Starts watching the directory containing `path`.
+ */
+static cdd_c_error_t watcher_add_parent(struct Watcher *w, const char *path) {
+  const char *slash = strrchr(path, '/');
+  char *dir;
+  cdd_c_error_t rc;
+
+  if (!slash)
+    return watcher_add_dir(w, ".");
+  dir = (char *)C_CDD_MALLOC((size_t)(slash - path) + 2);
+  if (!dir)
+    return CDD_C_ERROR_MEMORY;
+  memcpy(dir, path, (size_t)(slash - path));
+  dir[slash - path] = '\0';
+  rc = watcher_add_dir(w, slash == path ? "/" : dir);
+  C_CDD_FREE(dir);
+  return rc;
+}
+
+/**
+ * @brief Releases the inotify instance.
+ */
+static void watcher_close(struct Watcher *w) {
+  size_t i;
+  for (i = 0; i < w->size; ++i)
+    C_CDD_FREE(w->dirs[i]);
+  if (w->dirs)
+    C_CDD_FREE(w->dirs);
+  if (w->wds)
+    C_CDD_FREE(w->wds);
+  if (w->fd >= 0)
+    close(w->fd);
+  memset(w, 0, sizeof(*w));
+  w->fd = -1;
+}
+
+/**
+ * @brief Watches the source tree, the spec and every sync header.
+ */
+static cdd_c_error_t watcher_open(struct Watcher *w,
+                                  const struct WatchConfig *cfg,
+                                  size_t *out_n_files) {
+  struct WatchPathSet files = {0};
+  cdd_c_error_t rc;
+  size_t i;
+
+  memset(w, 0, sizeof(*w));
+  w->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (w->fd < 0)
+    return CDD_C_ERROR_SYSTEM;
+
+  rc = watch_collect_files(cfg, &files);
+  if (rc == CDD_C_SUCCESS && cfg->input_dir)
+    rc = watcher_add_tree(w, cfg, cfg->input_dir);
+  for (i = 0; rc == CDD_C_SUCCESS && i < files.size; ++i)
+    rc = watcher_add_parent(w, files.paths[i]);
+  *out_n_files = files.size;
+  watch_path_set_free(&files);
+  if (rc != CDD_C_SUCCESS)
+    watcher_close(w);
+  return rc;
+}
+
+/**
+ * @brief Reads every pending event, adding relevant paths to `changed`.
+ */
+static cdd_c_error_t watcher_drain(struct Watcher *w,
+                                   const struct WatchConfig *cfg,
+                                   struct WatchPathSet *changed) {
+  union {
+    struct inotify_event ev;
+    char bytes[4096];
+  } buf;
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+
+  for (;;) {
+    ssize_t n = read(w->fd, buf.bytes, sizeof(buf.bytes));
+    size_t off = 0;
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return rc;
+    while (rc == CDD_C_SUCCESS && off + sizeof(struct inotify_event) <=
+                                      (size_t)n) {
+      const struct inotify_event *ev =
+          (const struct inotify_event *)(buf.bytes + off);
+      const char *dir = NULL;
+      size_t i;
+
+      off += sizeof(struct inotify_event) + ev->len;
+      for (i = 0; i < w->size; ++i)
+        if (w->wds[i] == ev->wd)
+          dir = w->dirs[i];
+      if (!dir || ev->len == 0)
+        continue;
+      {
+        size_t path_len = strlen(dir) + strlen(ev->name) + 2;
+        char *path = (char *)C_CDD_MALLOC(path_len);
+        if (!path)
+          return CDD_C_ERROR_MEMORY;
+        sprintf(path, "%s/%s", dir, ev->name);
+        if (ev->mask & IN_ISDIR) {
+          /* New subdirectory: watch it and pick up files already inside */
+          if ((ev->mask & (IN_CREATE | IN_MOVED_TO)) && cfg->input_dir &&
+              watch_path_under(path, cfg->input_dir) &&
+              !watch_is_own_output(cfg, path)) {
+            struct WatchCollectCtx ctx;
+            ctx.cfg = cfg;
+            ctx.out = changed;
+            rc = watcher_add_tree(w, cfg, path);
+            if (rc == CDD_C_SUCCESS)
+              rc = walk_directory(path, watch_collect_cb, &ctx);
+          }
+        } else if (!(ev->mask & IN_CREATE) && watch_is_relevant(cfg, path)) {
+          /* IN_CREATE is always followed by IN_CLOSE_WRITE for files */
+          rc = watch_path_set_add(changed, path);
+        }
+        C_CDD_FREE(path);
+      }
+    }
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
+}
+
+/**
+ * @brief Blocks until a burst of relevant changes has gone quiet.
+ */
+static cdd_c_error_t watcher_wait(struct Watcher *w,
+                                  const struct WatchConfig *cfg,
+                                  struct WatchPathSet *changed) {
+  struct pollfd pfd;
+  pfd.fd = w->fd;
+  pfd.events = POLLIN;
+  for (;;) {
+    int timeout = changed->size ? (int)cfg->debounce_ms : -1;
+    int n;
+    cdd_c_error_t rc;
+
+    pfd.revents = 0;
+    n = poll(&pfd, 1, timeout);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return CDD_C_ERROR_SYSTEM;
+    }
+    if (n == 0)
+      return CDD_C_SUCCESS;
+    rc = watcher_drain(w, cfg, changed);
+    if (rc != CDD_C_SUCCESS)
+      return rc;
+  }
+}
+
+#elif !defined(CDD_WATCH_UNSUPPORTED)
+
+/**
+ * @brief Modification stamp of one observed file.
+ */
+struct WatchStamp {
+  char *path;    /**< Owned path */
+  time_t mtime;  /**< Last modification time, 0 if missing */
+  long size;     /**< Size in bytes, -1 if missing */
+};
+
+/**
+ * @brief Polling watcher: the last snapshot of every observed file.
+ */
+struct Watcher {
+  struct WatchStamp *stamps; /**< Snapshot */
+  size_t size;               /**< Number of stamps */
+};
+
+/**
+ * @brief Sleeps for `ms` milliseconds.
+ */
+static void watcher_sleep(unsigned long ms) {
+#if defined(_WIN32)
+  Sleep((DWORD)ms);
+#else
+  (void)poll(NULL, 0, (int)ms);
+#endif
+}
+
+/**
+ * @brief Frees a snapshot.
+ */
+static void watcher_stamps_free(struct WatchStamp *stamps, size_t n) {
+  size_t i;
+  for (i = 0; i < n; ++i)
+    C_CDD_FREE(stamps[i].path);
+  if (stamps)
+    C_CDD_FREE(stamps);
+}
+
+/**
+ * @brief qsort comparator ordering stamps by path.
+ */
+static int watcher_stamp_cmp(const void *a, const void *b) {
+  return strcmp(((const struct WatchStamp *)a)->path,
+                ((const struct WatchStamp *)b)->path);
+}
+
+/**
+ * @brief Stats every observed file, sorted by path for watcher_diff.
+ */
+static cdd_c_error_t watcher_snapshot(const struct WatchConfig *cfg,
+                                      struct WatchStamp **out, size_t *out_n) {
+  struct WatchPathSet files = {0};
+  struct WatchStamp *stamps;
+  cdd_c_error_t rc;
+  size_t i;
+
+  *out = NULL;
+  *out_n = 0;
+  rc = watch_collect_files(cfg, &files);
+  if (rc != CDD_C_SUCCESS || files.size == 0) {
+    watch_path_set_free(&files);
+    return rc;
+  }
+  stamps = (struct WatchStamp *)C_CDD_MALLOC(files.size *
+                                             sizeof(struct WatchStamp));
+  if (!stamps) {
+    watch_path_set_free(&files);
+    return CDD_C_ERROR_MEMORY;
+  }
+  for (i = 0; i < files.size; ++i) {
+    struct stat st;
+    stamps[i].path = files.paths[i];
+    if (stat(files.paths[i], &st) == 0) {
+      stamps[i].mtime = st.st_mtime;
+      stamps[i].size = (long)st.st_size;
+    } else {
+      stamps[i].mtime = 0;
+      stamps[i].size = -1;
+    }
+  }
+  /* Ownership of the strings moved into the stamps */
+  C_CDD_FREE(files.paths);
+  if (files.slots)
+    C_CDD_FREE(files.slots);
+  qsort(stamps, files.size, sizeof(struct WatchStamp), watcher_stamp_cmp);
+  *out = stamps;
+  *out_n = files.size;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Adds to `changed` every path added, removed or modified.
+ *
+ * Both snapshots are sorted by path, so one merge walk pairs them up.
+ */
+static cdd_c_error_t watcher_diff(const struct WatchStamp *old_s,
+                                  size_t old_n, const struct WatchStamp *new_s,
+                                  size_t new_n, struct WatchPathSet *changed) {
+  cdd_c_error_t rc = CDD_C_SUCCESS;
+  size_t i = 0, j = 0;
+
+  while (rc == CDD_C_SUCCESS && (i < new_n || j < old_n)) {
+    int cmp = i == new_n   ? 1
+              : j == old_n ? -1
+                           : strcmp(new_s[i].path, old_s[j].path);
+    if (cmp < 0) {
+      rc = watch_path_set_add(changed, new_s[i++].path); /* Added */
+    } else if (cmp > 0) {
+      rc = watch_path_set_add(changed, old_s[j++].path); /* Removed */
+    } else {
+      if (old_s[j].mtime != new_s[i].mtime || old_s[j].size != new_s[i].size)
+        rc = watch_path_set_add(changed, new_s[i].path);
+      ++i;
+      ++j;
+    }
+  }
+  return rc;
+}
+
+/**
+ * @brief Releases the last snapshot.
+ */
+static void watcher_close(struct Watcher *w) {
+  watcher_stamps_free(w->stamps, w->size);
+  w->stamps = NULL;
+  w->size = 0;
+}
+
+/**
+ * @brief Takes the initial snapshot.
+ */
+static cdd_c_error_t watcher_open(struct Watcher *w,
+                                  const struct WatchConfig *cfg,
+                                  size_t *out_n_files) {
+  cdd_c_error_t rc = watcher_snapshot(cfg, &w->stamps, &w->size);
+  *out_n_files = w->size;
+  return rc;
+}
+
+/**
+ * @brief Polls until a burst of changes has gone quiet.
+ *
+ * A burst ends at the first poll that finds nothing new after a change.
+ */
+static cdd_c_error_t watcher_wait(struct Watcher *w,
+                                  const struct WatchConfig *cfg,
+                                  struct WatchPathSet *changed) {
+  for (;;) {
+    struct WatchStamp *next = NULL;
+    size_t next_n = 0;
+    size_t before = changed->size;
+    cdd_c_error_t rc;
+
+    watcher_sleep(cfg->debounce_ms);
+    rc = watcher_snapshot(cfg, &next, &next_n);
+    if (rc == CDD_C_SUCCESS)
+      rc = watcher_diff(w->stamps, w->size, next, next_n, changed);
+    if (rc != CDD_C_SUCCESS) {
+      watcher_stamps_free(next, next_n);
+      return rc;
+    }
+    watcher_stamps_free(w->stamps, w->size);
+    w->stamps = next;
+    w->size = next_n;
+    if (changed->size > 0 && changed->size == before)
+      return CDD_C_SUCCESS;
+  }
+}
+
+#endif /* CDD_WATCH_INOTIFY */
+
+/* --- CLI --- */
+
+#if defined(CDD_WATCH_UNSUPPORTED)
+/* No descriptor duplication: notifications share stdout with the steps */
+#define watch_rpc_stream_open(cfg) ((void)(cfg))
+#define watch_rpc_stream_close(cfg) ((void)(cfg))
+#else
+#if defined(_WIN32)
+#define watch_dup _dup
+#define watch_dup2 _dup2
+#define watch_fdopen _fdopen
+#define watch_fileno _fileno
+#define watch_close _close
+#else
+#define watch_dup dup
+#define watch_dup2 dup2
+#define watch_fdopen fdopen
+#define watch_fileno fileno
+#define watch_close close
+#endif
+
+/**
+ * @brief Gives JSON-RPC notifications the real stdout to themselves.
+ *
+ * The regeneration steps print progress ("Scanning: ...", "Written ...") on
+ * stdout; interleaved with notifications that would break line-oriented
+ * clients. The original stdout is kept as `cfg->rpc_out` and descriptor 1
+ * is pointed at stderr for the duration of the run. On failure the
+ * notifications simply stay on stdout.
+ */
+static void watch_rpc_stream_open(struct WatchConfig *cfg) {
+  int saved;
+  fflush(stdout);
+  saved = watch_dup(watch_fileno(stdout));
+  if (saved < 0)
+    return;
+  cfg->rpc_out = watch_fdopen(saved, "w");
+  if (!cfg->rpc_out) {
+    watch_close(saved);
+    return;
+  }
+  if (watch_dup2(watch_fileno(stderr), watch_fileno(stdout)) < 0) {
+    fclose(cfg->rpc_out);
+    cfg->rpc_out = NULL;
+  }
+}
+
+/**
+ * @brief Restores stdout redirected by watch_rpc_stream_open().
+ */
+static void watch_rpc_stream_close(struct WatchConfig *cfg) {
+  if (!cfg->rpc_out)
+    return;
+  fflush(stdout);
+  fflush(cfg->rpc_out);
+  (void)watch_dup2(watch_fileno(cfg->rpc_out), watch_fileno(stdout));
+  fclose(cfg->rpc_out);
+  cfg->rpc_out = NULL;
+}
+#endif /* CDD_WATCH_UNSUPPORTED */
+
+/**
+ * @brief Prints the `watch` usage text.
+ */
+static void watch_print_usage(FILE *out) {
+  fputs("Usage: cdd-c watch [args]\n"
+        "\n"
+        "Options:\n"
+        "  -i, --input <dir>         C source tree regenerated with "
+        "to_openapi\n"
+        "  -o, --spec <spec.json>    Spec written by to_openapi, or watched "
+        "for --sdk\n"
+        "                            (default with -i: openapi.json)\n"
+        "  --sdk <dir>               Regenerate a client SDK when the spec "
+        "changes\n"
+        "  --sync <header.h> <impl.c>\n"
+        "                            Regenerate impl.c when header.h changes "
+        "(repeatable)\n"
+        "  --cache-dir <dir>         Extraction cache (default: $CDD_CACHE_DIR "
+        "or " WATCH_DEFAULT_CACHE_DIR ")\n"
+        "  --debounce-ms <n>         Quiet period ending a burst of saves "
+        "(default: 200)\n"
+        "  --json-rpc                Emit JSON-RPC 2.0 notifications on "
+        "stdout\n"
+        "                            (step output moves to stderr)\n"
+        "  --once                    Regenerate everything once and exit\n",
+        out);
+}
+
+cdd_c_error_t watch_cli_main(int argc, char **argv) {
+  struct WatchConfig cfg;
+  struct WatchSession session;
+  int once = 0;
+  int i;
+  cdd_c_error_t rc;
+
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.debounce_ms = WATCH_DEFAULT_DEBOUNCE_MS;
+  cfg.cache_dir = getenv("CDD_CACHE_DIR");
+  if (!cfg.cache_dir || !*cfg.cache_dir)
+    cfg.cache_dir = WATCH_DEFAULT_CACHE_DIR;
+  if (argc > 1) {
+    cfg.sync_pairs = (struct WatchSyncPair *)C_CDD_MALLOC(
+        (size_t)argc * sizeof(struct WatchSyncPair));
+    if (!cfg.sync_pairs)
+      return CDD_C_ERROR_MEMORY;
+  }
+
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+      watch_print_usage(stdout);
+      if (cfg.sync_pairs)
+        C_CDD_FREE(cfg.sync_pairs);
+      return CDD_C_SUCCESS;
+    } else if ((strcmp(argv[i], "-i") == 0 ||
+                strcmp(argv[i], "--input") == 0) &&
+               i + 1 < argc) {
+      cfg.input_dir = argv[++i];
+    } else if ((strcmp(argv[i], "-o") == 0 ||
+                strcmp(argv[i], "--output") == 0 ||
+                strcmp(argv[i], "--spec") == 0) &&
+               i + 1 < argc) {
+      cfg.spec_file = argv[++i];
+    } else if (strcmp(argv[i], "--sdk") == 0 && i + 1 < argc) {
+      cfg.sdk_dir = argv[++i];
+    } else if (strcmp(argv[i], "--sync") == 0 && i + 2 < argc) {
+      cfg.sync_pairs[cfg.n_sync_pairs].header = argv[++i];
+      cfg.sync_pairs[cfg.n_sync_pairs++].impl = argv[++i];
+    } else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+      cfg.cache_dir = argv[++i];
+    } else if (strcmp(argv[i], "--debounce-ms") == 0 && i + 1 < argc) {
+      cfg.debounce_ms = strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--json-rpc") == 0) {
+      cfg.json_rpc = 1;
+    } else if (strcmp(argv[i], "--once") == 0) {
+      once = 1;
+    } else {
+      fprintf(stderr, "Error: Unknown or incomplete option: %s\n", argv[i]);
+      watch_print_usage(stderr);
+      if (cfg.sync_pairs)
+        C_CDD_FREE(cfg.sync_pairs);
+      return CDD_C_ERROR_UNKNOWN;
+    }
+  }
+
+  if (cfg.input_dir && !cfg.spec_file)
+    cfg.spec_file = "openapi.json";
+  if ((!cfg.input_dir && !cfg.sdk_dir && cfg.n_sync_pairs == 0) ||
+      (cfg.sdk_dir && !cfg.spec_file)) {
+    fprintf(stderr, "Error: nothing to watch; pass -i <dir>, "
+                    "--spec <spec.json> --sdk <dir>, or --sync\n");
+    if (cfg.sync_pairs)
+      C_CDD_FREE(cfg.sync_pairs);
+    return CDD_C_ERROR_UNKNOWN;
+  }
+
+  if (cfg.json_rpc)
+    watch_rpc_stream_open(&cfg);
+  (void)watch_session_init(&session, &cfg);
+  rc = watch_session_rebuild(&session, NULL, 0);
+
+  if (!once) {
+#if defined(CDD_WATCH_UNSUPPORTED)
+    fprintf(stderr, "Error: watching is not supported on this platform\n");
+    rc = CDD_C_ERROR_SYSTEM;
+#else
+    struct Watcher watcher;
+    struct WatchPathSet changed = {0};
+    size_t n_files = 0;
+
+    rc = watcher_open(&watcher, &cfg, &n_files);
+    if (rc == CDD_C_SUCCESS) {
+      if (cfg.json_rpc) {
+        JSON_Value *params = json_value_init_object();
+        json_object_set_number(json_value_get_object(params), "files",
+                               (double)n_files);
+        watch_notify(&cfg, "watch/ready", params);
+      } else {
+        printf("[watch] watching %lu file(s)\n", (unsigned long)n_files);
+      }
+    }
+    while (rc == CDD_C_SUCCESS) {
+      rc = watcher_wait(&watcher, &cfg, &changed);
+      if (rc != CDD_C_SUCCESS)
+        break;
+      watch_report_changes(&cfg, &changed);
+      /* Step failures are reported; keep watching for the fix */
+      (void)watch_session_rebuild(
+          &session, (const char *const *)changed.paths, changed.size);
+      watch_path_set_free(&changed);
+    }
+    watch_path_set_free(&changed);
+    watcher_close(&watcher);
+#endif /* CDD_WATCH_UNSUPPORTED */
+  }
+
+  watch_session_free(&session);
+  watch_rpc_stream_close(&cfg);
+  if (cfg.sync_pairs)
+    C_CDD_FREE(cfg.sync_pairs);
+  return rc;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file watch.h
+ * @brief `cdd-c watch`: regenerate outputs when sources or specs change.
+ *
+ * Observes the C source tree, the OpenAPI spec and any `sync` headers, and
+ * after each burst of saves reruns only the steps the changed files feed:
+ * `to_openapi` for source edits (incremental through the extraction cache),
+ * `from_openapi to_sdk` when the spec bytes actually changed, and `sync` for
+ * the header pairs that were touched. Progress can be streamed as JSON-RPC
+ * 2.0 notifications, one per line on stdout; the steps' own console output
+ * is then moved to stderr so the stream stays parseable.
+ *
+ * Linux uses inotify; other platforms poll modification times.
+ *
+ * @author Samuel Marks
+ */
+
+#ifndef C_CDD_WATCH_H
+#define C_CDD_WATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include <stddef.h>
+#include <stdio.h>
+
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+/* clang-format on */
+
+/** @brief Default quiet period, in milliseconds, that ends a burst. */
+#define WATCH_DEFAULT_DEBOUNCE_MS 200UL
+
+/**
+ * @brief A header/implementation pair kept in step by `sync`.
+ */
+struct WatchSyncPair {
+  const char *header; /**< Header to scan for types */
+  const char *impl;   /**< Implementation file to regenerate */
+};
+
+/**
+ * @brief What to observe and what to regenerate.
+ *
+ * All strings are borrowed and must outlive the session.
+ */
+struct WatchConfig {
+  const char *input_dir; /**< C source tree for `to_openapi`, or NULL */
+  const char *spec_file; /**< Spec written by `to_openapi` or read for SDKs */
+  const char *cache_dir; /**< Extraction cache for `to_openapi`, or NULL */
+  const char *sdk_dir;   /**< Output directory for `to_sdk`, or NULL */
+  struct WatchSyncPair *sync_pairs; /**< Pairs to keep in step */
+  size_t n_sync_pairs;              /**< Number of sync pairs */
+  unsigned long debounce_ms;        /**< Quiet period ending a burst */
+  int json_rpc;                     /**< Emit JSON-RPC notifications */
+  FILE *rpc_out;                    /**< Notifications; NULL is stdout */
+};
+
+/**
+ * @brief State carried between regenerations.
+ */
+struct WatchSession {
+  const struct WatchConfig *config; /**< Borrowed configuration */
+  char *last_spec;                  /**< Spec bytes the SDK was built from */
+  size_t n_runs;                    /**< Steps executed so far */
+};
+
+/**
+ * @brief Initialize a session for a configuration.
+ *
+ * @param[out] session The session to initialize.
+ * @param[in] config Configuration; borrowed for the session's lifetime.
+ * @return 0 on success, CDD_C_ERROR_INVALID_ARGUMENT on bad args.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+watch_session_init(struct WatchSession *session,
+                   const struct WatchConfig *config);
+
+/**
+ * @brief Free resources held by a session.
+ */
+extern C_CDD_EXPORT void watch_session_free(struct WatchSession *session);
+
+/**
+ * @brief Rerun the steps affected by a set of changed paths.
+ *
+ * With no paths every configured step runs, as on startup. Changes to the
+ * watcher's own outputs (the sync implementations, the SDK and cache
+ * directories) are ignored so that regeneration never feeds back into
+ * itself.
+ *
+ * @param[in,out] session The session.
+ * @param[in] changed Changed paths (may be NULL when `n_changed` is 0).
+ * @param[in] n_changed Number of changed paths.
+ * @return 0 on success, or the first failing step's error.
+ */
+extern C_CDD_EXPORT cdd_c_error_t
+watch_session_rebuild(struct WatchSession *session, const char *const *changed,
+                      size_t n_changed);
+
+/**
+ * @brief Entry point for the `watch` command.
+ *
+ * `watch [-i <dir>] [-o|--spec <spec.json>] [--sdk <dir>]
+ * [--sync <header.h> <impl.c>]... [--cache-dir <dir>] [--debounce-ms <n>]
+ * [--json-rpc] [--once]`
+ *
+ * @param[in] argc Argument count, `argv[0]` being the command name.
+ * @param[in] argv Argument vector.
+ * @return 0 on success (only reached with `--once`), error code on failure.
+ */
+extern C_CDD_EXPORT cdd_c_error_t watch_cli_main(int argc, char **argv);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* C_CDD_WATCH_H */
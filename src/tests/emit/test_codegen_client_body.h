@@ -2425,8 +2425,8 @@ TEST test_client_body_find_encoding_not_found(void) {
   spec.defined_schemas = calloc(1, sizeof(struct StructFields));
   spec.defined_schemas[0].size = 1;
   spec.defined_schemas[0].fields = calloc(1, sizeof(struct StructField));
-  strcpy(spec.defined_schemas[0].fields[0].name, "test_prop");
-  strcpy(spec.defined_schemas[0].fields[0].type, "string");
+  spec.defined_schemas[0].fields[0].name = "test_prop";
+  spec.defined_schemas[0].fields[0].type = "string";
 
   codegen_client_write_body(fp, &op, &spec, "/path", NULL);
 
@@ -2476,28 +2476,28 @@ TEST test_client_body_array_items_statics(void) {
   spec.defined_schemas[0].fields = calloc(5, sizeof(struct StructField));
 
   /* Field 0: array of object */
-  strcpy(spec.defined_schemas[0].fields[0].name, "arr_obj");
-  strcpy(spec.defined_schemas[0].fields[0].type, "array");
-  strcpy(spec.defined_schemas[0].fields[0].ref, "object");
+  spec.defined_schemas[0].fields[0].name = "arr_obj";
+  spec.defined_schemas[0].fields[0].type = "array";
+  spec.defined_schemas[0].fields[0].ref = "object";
 
   /* Field 1: array of array */
-  strcpy(spec.defined_schemas[0].fields[1].name, "arr_arr");
-  strcpy(spec.defined_schemas[0].fields[1].type, "array");
-  strcpy(spec.defined_schemas[0].fields[1].ref, "array");
+  spec.defined_schemas[0].fields[1].name = "arr_arr";
+  spec.defined_schemas[0].fields[1].type = "array";
+  spec.defined_schemas[0].fields[1].ref = "array";
 
   /* Field 2: array of enum */
-  strcpy(spec.defined_schemas[0].fields[2].name, "arr_enum");
-  strcpy(spec.defined_schemas[0].fields[2].type, "array");
-  strcpy(spec.defined_schemas[0].fields[2].ref, "enum");
+  spec.defined_schemas[0].fields[2].name = "arr_enum";
+  spec.defined_schemas[0].fields[2].type = "array";
+  spec.defined_schemas[0].fields[2].ref = "enum";
 
   /* Field 3: object */
-  strcpy(spec.defined_schemas[0].fields[3].name, "obj_field");
-  strcpy(spec.defined_schemas[0].fields[3].type, "object");
+  spec.defined_schemas[0].fields[3].name = "obj_field";
+  spec.defined_schemas[0].fields[3].type = "object";
 
   /* Field 4: array with empty ref */
-  strcpy(spec.defined_schemas[0].fields[4].name, "arr_str");
-  strcpy(spec.defined_schemas[0].fields[4].type, "array");
-  spec.defined_schemas[0].fields[4].ref[0] = '\0';
+  spec.defined_schemas[0].fields[4].name = "arr_str";
+  spec.defined_schemas[0].fields[4].type = "array";
+  spec.defined_schemas[0].fields[4].ref = NULL;
 
   codegen_client_write_body(fp, &op, &spec, "/path", NULL);
 
@@ -2580,8 +2580,8 @@ TEST test_client_body_header_formatting_indirect(void) {
   spec.defined_schemas = calloc(1, sizeof(struct StructFields));
   spec.defined_schemas[0].size = 1;
   spec.defined_schemas[0].fields = calloc(1, sizeof(struct StructField));
-  strcpy(spec.defined_schemas[0].fields[0].name, "1test_prop");
-  strcpy(spec.defined_schemas[0].fields[0].type, "string");
+  spec.defined_schemas[0].fields[0].name = "1test_prop";
+  spec.defined_schemas[0].fields[0].type = "string";
 
   op.req_body.ref_name = "MockSchemaHdr";
 
@@ -2653,8 +2653,8 @@ TEST test_client_body_media_types_textual_binary_indirect(void) {
   spec.defined_schemas = calloc(1, sizeof(struct StructFields));
   spec.defined_schemas[0].size = 1;
   spec.defined_schemas[0].fields = calloc(1, sizeof(struct StructField));
-  strcpy(spec.defined_schemas[0].fields[0].name, "test_prop");
-  strcpy(spec.defined_schemas[0].fields[0].type, "string");
+  spec.defined_schemas[0].fields[0].name = "test_prop";
+  spec.defined_schemas[0].fields[0].type = "string";
 
   op.req_body.ref_name = "MockSchemaTxtBin";
 
@@ -2745,8 +2745,8 @@ TEST test_client_body_media_types_textual_binary_missing_branches_indirect(
   spec.defined_schemas = calloc(1, sizeof(struct StructFields));
   spec.defined_schemas[0].size = 1;
   spec.defined_schemas[0].fields = calloc(1, sizeof(struct StructField));
-  strcpy(spec.defined_schemas[0].fields[0].name, "test_prop");
-  strcpy(spec.defined_schemas[0].fields[0].type, "string");
+  spec.defined_schemas[0].fields[0].name = "test_prop";
+  spec.defined_schemas[0].fields[0].type = "string";
 
   op.req_body.ref_name = "MockSchemaMissing";
 
@@ -2816,8 +2816,8 @@ TEST test_client_body_media_type_caps_indirect(void) {
   spec.defined_schemas = calloc(1, sizeof(struct StructFields));
   spec.defined_schemas[0].size = 1;
   spec.defined_schemas[0].fields = calloc(1, sizeof(struct StructField));
-  strcpy(spec.defined_schemas[0].fields[0].name, "test_prop");
-  strcpy(spec.defined_schemas[0].fields[0].type, "string");
+  spec.defined_schemas[0].fields[0].name = "test_prop";
+  spec.defined_schemas[0].fields[0].type = "string";
 
   op.req_body.ref_name = "MockSchemaCaps";
 
@@ -2883,8 +2883,8 @@ TEST test_client_body_media_type_prefix_caps_indirect(void) {
   spec.defined_schemas = calloc(1, sizeof(struct StructFields));
   spec.defined_schemas[0].size = 1;
   spec.defined_schemas[0].fields = calloc(1, sizeof(struct StructField));
-  strcpy(spec.defined_schemas[0].fields[0].name, "test_prop");
-  strcpy(spec.defined_schemas[0].fields[0].type, "string");
+  spec.defined_schemas[0].fields[0].name = "test_prop";
+  spec.defined_schemas[0].fields[0].type = "string";
 
   op.req_body.ref_name = "MockSchemaPrefixCaps";
 
@@ -2950,8 +2950,8 @@ TEST test_client_body_media_type_prefix_suffix_short(void) {
   spec.defined_schemas = calloc(1, sizeof(struct StructFields));
   spec.defined_schemas[0].size = 1;
   spec.defined_schemas[0].fields = calloc(1, sizeof(struct StructField));
-  strcpy(spec.defined_schemas[0].fields[0].name, "test_prop");
-  strcpy(spec.defined_schemas[0].fields[0].type, "string");
+  spec.defined_schemas[0].fields[0].name = "test_prop";
+  spec.defined_schemas[0].fields[0].type = "string";
 
   op.req_body.ref_name = "MockSchemaShort";
 
@@ -3234,10 +3234,10 @@ TEST test_client_body_form_object_style_form_explode(void) {
   spec.defined_schemas = calloc(1, sizeof(struct StructFields));
   spec.defined_schemas[0].size = 1;
   spec.defined_schemas[0].fields = calloc(1, sizeof(struct StructField));
-  strcpy(spec.defined_schemas[0].fields[0].name, "obj_prop");
-  strcpy(spec.defined_schemas[0].fields[0].type, "object");
-  strcpy(spec.defined_schemas[0].fields[0].ref,
-         "MockSchemaFormObj"); /* self-ref for test */
+  spec.defined_schemas[0].fields[0].name = "obj_prop";
+  spec.defined_schemas[0].fields[0].type = "object";
+  spec.defined_schemas[0].fields[0].ref =
+      "MockSchemaFormObj"; /* self-ref for test */
 
   op.req_body.ref_name = "MockSchemaFormObj";
 
@@ -3637,9 +3637,9 @@ TEST test_client_body_write_joined_form_array_direct(void) {
     struct StructField f = {0};
     struct OpenAPI_MediaType mt = {0};
     openapi_spec_init(&spec);
-    strcpy(f.name, "arr");
-    strcpy(f.type, "array");
-    strcpy(f.ref, "MyOtherStruct");
+    f.name = "arr";
+    f.type = "array";
+    f.ref = "MyOtherStruct";
     sf.size = 1;
     sf.capacity = 1;
     sf.fields = calloc(1, sizeof(struct StructField));
@@ -3675,23 +3675,23 @@ TEST test_client_body_write_joined_form_array_direct(void) {
 
     op.req_body_media_types[0].encoding[0].style = OA_STYLE_FORM;
 
-    strcpy(spec.defined_schemas[0].fields[0].ref, "integer");
+    spec.defined_schemas[0].fields[0].ref = "integer";
     ASSERT_EQ(CDD_C_SUCCESS,
               codegen_client_write_body(fp, &op, &spec, "/test", NULL));
 
-    strcpy(spec.defined_schemas[0].fields[0].ref, "number");
+    spec.defined_schemas[0].fields[0].ref = "number";
     ASSERT_EQ(CDD_C_SUCCESS,
               codegen_client_write_body(fp, &op, &spec, "/test", NULL));
 
-    strcpy(spec.defined_schemas[0].fields[0].ref, "boolean");
+    spec.defined_schemas[0].fields[0].ref = "boolean";
     ASSERT_EQ(CDD_C_SUCCESS,
               codegen_client_write_body(fp, &op, &spec, "/test", NULL));
 
-    strcpy(spec.defined_schemas[0].fields[0].ref, "string");
+    spec.defined_schemas[0].fields[0].ref = "string";
     ASSERT_EQ(CDD_C_SUCCESS,
               codegen_client_write_body(fp, &op, &spec, "/test", NULL));
 
-    strcpy(spec.defined_schemas[0].fields[0].ref, "unsupported_type");
+    spec.defined_schemas[0].fields[0].ref = "unsupported_type";
     ASSERT_EQ(CDD_C_SUCCESS,
               codegen_client_write_body(fp, &op, &spec, "/test", NULL));
 
@@ -3724,9 +3724,9 @@ TEST test_client_body_write_joined_form_array_direct_io(void) {
       struct StructField f = {0};
       struct OpenAPI_MediaType mt = {0};
       openapi_spec_init(&spec);
-      strcpy(f.name, "arr");
-      strcpy(f.type, "array");
-      strcpy(f.ref, "MyOtherStruct");
+      f.name = "arr";
+      f.type = "array";
+      f.ref = "MyOtherStruct";
       sf.size = 1;
       sf.capacity = 1;
       sf.fields = calloc(1, sizeof(struct StructField));
@@ -3766,27 +3766,27 @@ TEST test_client_body_write_joined_form_array_direct_io(void) {
 
       op.req_body_media_types[0].encoding[0].style = OA_STYLE_FORM;
 
-      strcpy(spec.defined_schemas[0].fields[0].ref, "integer");
+      spec.defined_schemas[0].fields[0].ref = "integer";
       g_fail_io_after = i;
       codegen_client_write_body(fp, &op, &spec, "/test", NULL);
       g_fail_io_after = -1;
 
-      strcpy(spec.defined_schemas[0].fields[0].ref, "number");
+      spec.defined_schemas[0].fields[0].ref = "number";
       g_fail_io_after = i;
       codegen_client_write_body(fp, &op, &spec, "/test", NULL);
       g_fail_io_after = -1;
 
-      strcpy(spec.defined_schemas[0].fields[0].ref, "boolean");
+      spec.defined_schemas[0].fields[0].ref = "boolean";
       g_fail_io_after = i;
       codegen_client_write_body(fp, &op, &spec, "/test", NULL);
       g_fail_io_after = -1;
 
-      strcpy(spec.defined_schemas[0].fields[0].ref, "string");
+      spec.defined_schemas[0].fields[0].ref = "string";
       g_fail_io_after = i;
       codegen_client_write_body(fp, &op, &spec, "/test", NULL);
       g_fail_io_after = -1;
 
-      strcpy(spec.defined_schemas[0].fields[0].ref, "unsupported_type");
+      spec.defined_schemas[0].fields[0].ref = "unsupported_type";
       g_fail_io_after = i;
       codegen_client_write_body(fp, &op, &spec, "/test", NULL);
       g_fail_io_after = -1;
@@ -4647,87 +4647,87 @@ TEST test_client_body_form_mega(void) {
     /* Main schema */
     spec.defined_schemas[0].size = 11;
     spec.defined_schemas[0].fields = calloc(11, sizeof(struct StructField));
-    strcpy(spec.defined_schemas[0].fields[0].name, "fArrStrRsv");
-    strcpy(spec.defined_schemas[0].fields[0].type, "array");
-    strcpy(spec.defined_schemas[0].fields[0].ref, "string");
-    strcpy(spec.defined_schemas[0].fields[1].name, "fObjExp");
-    strcpy(spec.defined_schemas[0].fields[1].type, "object");
-    strcpy(spec.defined_schemas[0].fields[1].ref, "ObjType1");
-    strcpy(spec.defined_schemas[0].fields[2].name, "fObjNoExp");
-    strcpy(spec.defined_schemas[0].fields[2].type, "object");
-    strcpy(spec.defined_schemas[0].fields[2].ref, "ObjType2");
-    strcpy(spec.defined_schemas[0].fields[3].name, "fObjSpace");
-    strcpy(spec.defined_schemas[0].fields[3].type, "object");
-    strcpy(spec.defined_schemas[0].fields[3].ref, "ObjType3");
-    strcpy(spec.defined_schemas[0].fields[4].name, "fObjPipe");
-    strcpy(spec.defined_schemas[0].fields[4].type, "object");
-    strcpy(spec.defined_schemas[0].fields[4].ref, "ObjType4");
-    strcpy(spec.defined_schemas[0].fields[5].name, "fArrInt");
-    strcpy(spec.defined_schemas[0].fields[5].type, "array");
-    strcpy(spec.defined_schemas[0].fields[5].ref, "integer");
-    strcpy(spec.defined_schemas[0].fields[6].name, "fFormArrInt");
-    strcpy(spec.defined_schemas[0].fields[6].type, "array");
-    strcpy(spec.defined_schemas[0].fields[6].ref, "integer");
-    strcpy(spec.defined_schemas[0].fields[7].name, "fFormArrNum");
-    strcpy(spec.defined_schemas[0].fields[7].type, "array");
-    strcpy(spec.defined_schemas[0].fields[7].ref, "number");
-    strcpy(spec.defined_schemas[0].fields[8].name, "fFormArrBool");
-    strcpy(spec.defined_schemas[0].fields[8].type, "array");
-    strcpy(spec.defined_schemas[0].fields[8].ref, "boolean");
-    strcpy(spec.defined_schemas[0].fields[9].name, "fArrNum");
-    strcpy(spec.defined_schemas[0].fields[9].type, "array");
-    strcpy(spec.defined_schemas[0].fields[9].ref, "number");
-    strcpy(spec.defined_schemas[0].fields[10].name, "fArrBool");
-    strcpy(spec.defined_schemas[0].fields[10].type, "array");
-    strcpy(spec.defined_schemas[0].fields[10].ref, "boolean");
+    spec.defined_schemas[0].fields[0].name = "fArrStrRsv";
+    spec.defined_schemas[0].fields[0].type = "array";
+    spec.defined_schemas[0].fields[0].ref = "string";
+    spec.defined_schemas[0].fields[1].name = "fObjExp";
+    spec.defined_schemas[0].fields[1].type = "object";
+    spec.defined_schemas[0].fields[1].ref = "ObjType1";
+    spec.defined_schemas[0].fields[2].name = "fObjNoExp";
+    spec.defined_schemas[0].fields[2].type = "object";
+    spec.defined_schemas[0].fields[2].ref = "ObjType2";
+    spec.defined_schemas[0].fields[3].name = "fObjSpace";
+    spec.defined_schemas[0].fields[3].type = "object";
+    spec.defined_schemas[0].fields[3].ref = "ObjType3";
+    spec.defined_schemas[0].fields[4].name = "fObjPipe";
+    spec.defined_schemas[0].fields[4].type = "object";
+    spec.defined_schemas[0].fields[4].ref = "ObjType4";
+    spec.defined_schemas[0].fields[5].name = "fArrInt";
+    spec.defined_schemas[0].fields[5].type = "array";
+    spec.defined_schemas[0].fields[5].ref = "integer";
+    spec.defined_schemas[0].fields[6].name = "fFormArrInt";
+    spec.defined_schemas[0].fields[6].type = "array";
+    spec.defined_schemas[0].fields[6].ref = "integer";
+    spec.defined_schemas[0].fields[7].name = "fFormArrNum";
+    spec.defined_schemas[0].fields[7].type = "array";
+    spec.defined_schemas[0].fields[7].ref = "number";
+    spec.defined_schemas[0].fields[8].name = "fFormArrBool";
+    spec.defined_schemas[0].fields[8].type = "array";
+    spec.defined_schemas[0].fields[8].ref = "boolean";
+    spec.defined_schemas[0].fields[9].name = "fArrNum";
+    spec.defined_schemas[0].fields[9].type = "array";
+    spec.defined_schemas[0].fields[9].ref = "number";
+    spec.defined_schemas[0].fields[10].name = "fArrBool";
+    spec.defined_schemas[0].fields[10].type = "array";
+    spec.defined_schemas[0].fields[10].ref = "boolean";
 
     /* ObjType1 (explode=1) */
     spec.defined_schemas[1].size = 4;
     spec.defined_schemas[1].fields = calloc(4, sizeof(struct StructField));
-    strcpy(spec.defined_schemas[1].fields[0].name, "s");
-    strcpy(spec.defined_schemas[1].fields[0].type, "string");
-    strcpy(spec.defined_schemas[1].fields[1].name, "i");
-    strcpy(spec.defined_schemas[1].fields[1].type, "integer");
-    strcpy(spec.defined_schemas[1].fields[2].name, "n");
-    strcpy(spec.defined_schemas[1].fields[2].type, "number");
-    strcpy(spec.defined_schemas[1].fields[3].name, "b");
-    strcpy(spec.defined_schemas[1].fields[3].type, "boolean");
+    spec.defined_schemas[1].fields[0].name = "s";
+    spec.defined_schemas[1].fields[0].type = "string";
+    spec.defined_schemas[1].fields[1].name = "i";
+    spec.defined_schemas[1].fields[1].type = "integer";
+    spec.defined_schemas[1].fields[2].name = "n";
+    spec.defined_schemas[1].fields[2].type = "number";
+    spec.defined_schemas[1].fields[3].name = "b";
+    spec.defined_schemas[1].fields[3].type = "boolean";
 
     /* ObjType2 (explode=0) */
     spec.defined_schemas[2].size = 4;
     spec.defined_schemas[2].fields = calloc(4, sizeof(struct StructField));
-    strcpy(spec.defined_schemas[2].fields[0].name, "s");
-    strcpy(spec.defined_schemas[2].fields[0].type, "string");
-    strcpy(spec.defined_schemas[2].fields[1].name, "i");
-    strcpy(spec.defined_schemas[2].fields[1].type, "integer");
-    strcpy(spec.defined_schemas[2].fields[2].name, "n");
-    strcpy(spec.defined_schemas[2].fields[2].type, "number");
-    strcpy(spec.defined_schemas[2].fields[3].name, "b");
-    strcpy(spec.defined_schemas[2].fields[3].type, "boolean");
+    spec.defined_schemas[2].fields[0].name = "s";
+    spec.defined_schemas[2].fields[0].type = "string";
+    spec.defined_schemas[2].fields[1].name = "i";
+    spec.defined_schemas[2].fields[1].type = "integer";
+    spec.defined_schemas[2].fields[2].name = "n";
+    spec.defined_schemas[2].fields[2].type = "number";
+    spec.defined_schemas[2].fields[3].name = "b";
+    spec.defined_schemas[2].fields[3].type = "boolean";
 
     /* ObjType3 (spaceDelimited) */
     spec.defined_schemas[3].size = 4;
     spec.defined_schemas[3].fields = calloc(4, sizeof(struct StructField));
-    strcpy(spec.defined_schemas[3].fields[0].name, "s");
-    strcpy(spec.defined_schemas[3].fields[0].type, "string");
-    strcpy(spec.defined_schemas[3].fields[1].name, "i");
-    strcpy(spec.defined_schemas[3].fields[1].type, "integer");
-    strcpy(spec.defined_schemas[3].fields[2].name, "n");
-    strcpy(spec.defined_schemas[3].fields[2].type, "number");
-    strcpy(spec.defined_schemas[3].fields[3].name, "b");
-    strcpy(spec.defined_schemas[3].fields[3].type, "boolean");
+    spec.defined_schemas[3].fields[0].name = "s";
+    spec.defined_schemas[3].fields[0].type = "string";
+    spec.defined_schemas[3].fields[1].name = "i";
+    spec.defined_schemas[3].fields[1].type = "integer";
+    spec.defined_schemas[3].fields[2].name = "n";
+    spec.defined_schemas[3].fields[2].type = "number";
+    spec.defined_schemas[3].fields[3].name = "b";
+    spec.defined_schemas[3].fields[3].type = "boolean";
 
     /* ObjType4 (pipeDelimited) */
     spec.defined_schemas[4].size = 4;
     spec.defined_schemas[4].fields = calloc(4, sizeof(struct StructField));
-    strcpy(spec.defined_schemas[4].fields[0].name, "s");
-    strcpy(spec.defined_schemas[4].fields[0].type, "string");
-    strcpy(spec.defined_schemas[4].fields[1].name, "i");
-    strcpy(spec.defined_schemas[4].fields[1].type, "integer");
-    strcpy(spec.defined_schemas[4].fields[2].name, "n");
-    strcpy(spec.defined_schemas[4].fields[2].type, "number");
-    strcpy(spec.defined_schemas[4].fields[3].name, "b");
-    strcpy(spec.defined_schemas[4].fields[3].type, "boolean");
+    spec.defined_schemas[4].fields[0].name = "s";
+    spec.defined_schemas[4].fields[0].type = "string";
+    spec.defined_schemas[4].fields[1].name = "i";
+    spec.defined_schemas[4].fields[1].type = "integer";
+    spec.defined_schemas[4].fields[2].name = "n";
+    spec.defined_schemas[4].fields[2].type = "number";
+    spec.defined_schemas[4].fields[3].name = "b";
+    spec.defined_schemas[4].fields[3].type = "boolean";
 
     op.n_req_body_media_types = 1;
     op.req_body_media_types = calloc(1, sizeof(*op.req_body_media_types));
@@ -55,16 +55,16 @@ TEST test_form_generation_basic(void) {
       memset(&f2, 0, sizeof(f2));
       memset(&f3, 0, sizeof(f3));
 
-      strcpy(f1.name, "grant_type");
-      strcpy(f1.type, "string");
+      f1.name = "grant_type";
+      f1.type = "string";
       sf.fields[sf.size++] = f1;
 
-      strcpy(f2.name, "count");
-      strcpy(f2.type, "integer");
+      f2.name = "count";
+      f2.type = "integer";
       sf.fields[sf.size++] = f2;
 
-      strcpy(f3.name, "active");
-      strcpy(f3.type, "boolean");
+      f3.name = "active";
+      f3.type = "boolean";
       sf.fields[sf.size++] = f3;
     }
 
@@ -267,13 +267,13 @@ TEST test_json_guards(void) {
 
     /* String with regex patterns */
     struct_fields_add(&sf, "pat_exact", "string", NULL, NULL, NULL);
-    strcpy(sf.fields[sf.size - 1].pattern, "^exact$");
+    sf.fields[sf.size - 1].pattern = "^exact$";
     struct_fields_add(&sf, "pat_prefix", "string", NULL, NULL, NULL);
-    strcpy(sf.fields[sf.size - 1].pattern, "^prefix");
+    sf.fields[sf.size - 1].pattern = "^prefix";
     struct_fields_add(&sf, "pat_suffix", "string", NULL, NULL, NULL);
-    strcpy(sf.fields[sf.size - 1].pattern, "suffix$");
+    sf.fields[sf.size - 1].pattern = "suffix$";
     struct_fields_add(&sf, "pat_contains", "string", NULL, NULL, NULL);
-    strcpy(sf.fields[sf.size - 1].pattern, "contains");
+    sf.fields[sf.size - 1].pattern = "contains";
 
     /* Integer with inclusive min/max */
     struct_fields_add(&sf, "int_bounded_inc", "integer", NULL, NULL, NULL);
@@ -458,13 +458,13 @@ TEST test_json_null_args(void) {
 
       /* String with regex patterns */
       struct_fields_add(&sf, "pat_exact", "string", NULL, NULL, NULL);
-      strcpy(sf.fields[sf.size - 1].pattern, "^exact$");
+      sf.fields[sf.size - 1].pattern = "^exact$";
       struct_fields_add(&sf, "pat_prefix", "string", NULL, NULL, NULL);
-      strcpy(sf.fields[sf.size - 1].pattern, "^prefix");
+      sf.fields[sf.size - 1].pattern = "^prefix";
       struct_fields_add(&sf, "pat_suffix", "string", NULL, NULL, NULL);
-      strcpy(sf.fields[sf.size - 1].pattern, "suffix$");
+      sf.fields[sf.size - 1].pattern = "suffix$";
       struct_fields_add(&sf, "pat_contains", "string", NULL, NULL, NULL);
-      strcpy(sf.fields[sf.size - 1].pattern, "contains");
+      sf.fields[sf.size - 1].pattern = "contains";
 
       /* Integer with inclusive min/max */
       struct_fields_add(&sf, "int_bounded_inc", "integer", NULL, NULL, NULL);
@@ -673,13 +673,13 @@ TEST test_json_exhaustive_io(void) {
 
   /* String with regex patterns */
   struct_fields_add(&sf, "pat_exact", "string", NULL, NULL, NULL);
-  strcpy(sf.fields[sf.size - 1].pattern, "^exact$");
+  sf.fields[sf.size - 1].pattern = "^exact$";
   struct_fields_add(&sf, "pat_prefix", "string", NULL, NULL, NULL);
-  strcpy(sf.fields[sf.size - 1].pattern, "^prefix");
+  sf.fields[sf.size - 1].pattern = "^prefix";
   struct_fields_add(&sf, "pat_suffix", "string", NULL, NULL, NULL);
-  strcpy(sf.fields[sf.size - 1].pattern, "suffix$");
+  sf.fields[sf.size - 1].pattern = "suffix$";
   struct_fields_add(&sf, "pat_contains", "string", NULL, NULL, NULL);
-  strcpy(sf.fields[sf.size - 1].pattern, "contains");
+  sf.fields[sf.size - 1].pattern = "contains";
 
   /* Integer with inclusive min/max */
   struct_fields_add(&sf, "int_bounded_inc", "integer", NULL, NULL, NULL);
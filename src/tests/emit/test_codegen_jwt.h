@@ -58,12 +58,12 @@ TEST test_jwt_generation(void) {
       memset(&f1, 0, sizeof(f1));
       memset(&f2, 0, sizeof(f2));
 
-      strcpy(f1.name, "sub");
-      strcpy(f1.type, "string");
+      f1.name = "sub";
+      f1.type = "string";
       sf.fields[sf.size++] = f1;
 
-      strcpy(f2.name, "exp");
-      strcpy(f2.type, "integer");
+      f2.name = "exp";
+      f2.type = "integer";
       sf.fields[sf.size++] = f2;
     }
 
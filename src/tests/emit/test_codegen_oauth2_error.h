@@ -57,12 +57,12 @@ TEST test_oauth2_error_generation(void) {
       memset(&f1, 0, sizeof(f1));
       memset(&f2, 0, sizeof(f2));
 
-      strcpy(f1.name, "error");
-      strcpy(f1.type, "string");
+      f1.name = "error";
+      f1.type = "string";
       sf.fields[sf.size++] = f1;
 
-      strcpy(f2.name, "error_description");
-      strcpy(f2.type, "string");
+      f2.name = "error_description";
+      f2.type = "string";
       sf.fields[sf.size++] = f2;
     }
 
@@ -111,12 +111,12 @@ TEST test_oauth2_error_generation_non_string(void) {
       memset(&f1, 0, sizeof(f1));
       memset(&f2, 0, sizeof(f2));
 
-      strcpy(f1.name, "error");
-      strcpy(f1.type, "integer");
+      f1.name = "error";
+      f1.type = "integer";
       sf.fields[sf.size++] = f1;
 
-      strcpy(f2.name, "error_description");
-      strcpy(f2.type, "integer");
+      f2.name = "error_description";
+      f2.type = "integer";
       sf.fields[sf.size++] = f2;
     }
 
@@ -22,6 +22,7 @@ extern "C" {
 #include <stdlib.h>
 #include <string.h>
 
+#include "c_cdd/memory.h"
 #include "classes/emit/struct.h"
 /* clang-format on */
 
@@ -396,7 +397,7 @@ TEST test_struct_fields_add_bitwidth(void) {
   /* Add normal */
   ASSERT_EQ(0, struct_fields_add(&sf, "x", "integer", NULL, NULL, NULL));
   ASSERT_EQ(2, sf.size);
-  ASSERT_STR_EQ("\0", sf.fields[1].bit_width);
+  ASSERT(sf.fields[1].bit_width == NULL);
 
   struct_fields_free(NULL);
   struct_fields_free(&sf);
@@ -404,6 +405,135 @@ TEST test_struct_fields_add_bitwidth(void) {
   PASS();
 }
 
+/**
+ * @brief Tests that field strings are interned, untruncated and copyable.
+ * @return TEST
+ */
+TEST test_struct_fields_intern(void) {
+  struct StructFields sf, other;
+  char long_pattern[600];
+  const char *h = NULL;
+  size_t i;
+
+  memset(long_pattern, 'a', sizeof(long_pattern) - 1);
+  long_pattern[0] = '^';
+  long_pattern[sizeof(long_pattern) - 1] = '\0';
+
+  ASSERT_EQ(0, struct_fields_init(&sf));
+  ASSERT_EQ(0, struct_fields_init(&other));
+
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, struct_fields_intern(NULL, "x", &h));
+  ASSERT_EQ(0, struct_fields_intern(&sf, "", &h));
+  ASSERT(h == NULL);
+
+  /* Equal strings share storage across fields */
+  for (i = 0; i < 200; ++i) {
+    char name[32];
+    sprintf(name, "field_%d", (int)i);
+    ASSERT_EQ(0, struct_fields_add(&sf, name, "string", "Ref", NULL, NULL));
+  }
+  ASSERT(sf.fields[0].type == sf.fields[199].type);
+  ASSERT(sf.fields[0].ref == sf.fields[199].ref);
+  ASSERT_STR_EQ("field_199", sf.fields[199].name);
+  ASSERT(sf.fields[0].default_val == NULL);
+
+  /* Long strings are kept whole */
+  ASSERT_EQ(0, struct_fields_intern(&sf, long_pattern, &sf.fields[1].pattern));
+  ASSERT_EQ(sizeof(long_pattern) - 1, strlen(sf.fields[1].pattern));
+
+  /* Copies own their strings once the source is gone */
+  ASSERT_EQ(0, struct_fields_add(&other, "tmp", "integer", NULL, NULL, NULL));
+  ASSERT_EQ(0, struct_field_copy(&other, &other.fields[0], &sf.fields[1]));
+  struct_fields_free(&sf);
+  ASSERT_STR_EQ("field_1", other.fields[0].name);
+  ASSERT_STR_EQ("Ref", other.fields[0].ref);
+  ASSERT_STR_EQ(long_pattern, other.fields[0].pattern);
+
+  struct_fields_free(&other);
+  PASS();
+}
+
+/**
+ * @brief Tests that the string pool reports every failed allocation.
+ * @return TEST
+ */
+TEST test_struct_fields_intern_oom(void) {
+  struct StructFields sf;
+  const char *h = NULL;
+  const char *first = NULL;
+  int fail_at;
+  int i;
+
+  /* The pool itself, its slot table, then its first chunk */
+  for (fail_at = 1; fail_at <= 3; ++fail_at) {
+    ASSERT_EQ(0, struct_fields_init(&sf));
+    g_cdd_alloc_fail = fail_at;
+    ASSERT_EQ(CDD_C_ERROR_MEMORY, struct_fields_intern(&sf, "abc", &h));
+    g_cdd_alloc_fail = 0;
+    ASSERT_EQ(0, struct_fields_intern(&sf, "abc", &h));
+    ASSERT_STR_EQ("abc", h);
+    struct_fields_free(&sf);
+  }
+
+  /* Growing the slot table leaves the pool usable */
+  ASSERT_EQ(0, struct_fields_init(&sf));
+  for (i = 0; i < 32; ++i) {
+    char name[16];
+    sprintf(name, "s%d", i);
+    ASSERT_EQ(0, struct_fields_intern(&sf, name, i == 0 ? &first : &h));
+  }
+  g_cdd_alloc_fail = 1;
+  ASSERT_EQ(CDD_C_ERROR_MEMORY, struct_fields_intern(&sf, "s32", &h));
+  g_cdd_alloc_fail = 0;
+  ASSERT_EQ(0, struct_fields_intern(&sf, "s0", &h));
+  ASSERT(h == first);
+  ASSERT_EQ(0, struct_fields_intern(&sf, "s32", &h));
+  ASSERT_STR_EQ("s32", h);
+  struct_fields_free(&sf);
+  PASS();
+}
+
+/**
+ * @brief Tests name lookups once the index kicks in, including removal.
+ * @return TEST
+ */
+TEST test_struct_fields_get_indexed(void) {
+  struct StructFields sf;
+  struct StructField *f = NULL;
+  char name[32];
+  int i;
+
+  ASSERT_EQ(0, struct_fields_init(&sf));
+  for (i = 0; i < 500; ++i) {
+    sprintf(name, "p%d", i);
+    ASSERT_EQ(0, struct_fields_add(&sf, name, "integer", NULL, NULL, NULL));
+  }
+  /* Duplicates keep resolving to the first occurrence */
+  ASSERT_EQ(0, struct_fields_add(&sf, "p7", "string", NULL, NULL, NULL));
+
+  for (i = 0; i < 500; ++i) {
+    sprintf(name, "p%d", i);
+    ASSERT_EQ(0, struct_fields_get(&sf, name, &f));
+    ASSERT(f == &sf.fields[i]);
+  }
+  ASSERT_EQ(0, struct_fields_get(&sf, "p500", &f));
+  ASSERT(f == NULL);
+
+  /* Removal keeps insertion order and lookups consistent */
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, struct_fields_remove(&sf, 501));
+  ASSERT_EQ(0, struct_fields_remove(&sf, 7));
+  ASSERT_EQ(500, sf.size);
+  ASSERT_STR_EQ("p8", sf.fields[7].name);
+  ASSERT_EQ(0, struct_fields_get(&sf, "p7", &f));
+  ASSERT(f == &sf.fields[499]);
+  ASSERT_STR_EQ("string", f->type);
+  ASSERT_EQ(0, struct_fields_get(&sf, "p499", &f));
+  ASSERT(f == &sf.fields[498]);
+
+  struct_fields_free(&sf);
+  PASS();
+}
+
 /**
  * @brief codegen_struct_suite
  */
@@ -826,6 +956,9 @@ SUITE(codegen_struct_suite) {
   RUN_TEST(test_guards_injection);
   RUN_TEST(test_null_args);
   RUN_TEST(test_struct_fields_add_bitwidth);
+  RUN_TEST(test_struct_fields_intern);
+  RUN_TEST(test_struct_fields_intern_oom);
+  RUN_TEST(test_struct_fields_get_indexed);
   RUN_TEST(test_struct_debug_func);
   RUN_TEST(test_struct_invalid_args);
 }
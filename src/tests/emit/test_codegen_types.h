@@ -1071,8 +1071,8 @@ TEST test_types_uncovered(void) {
   struct_fields_init(&sf);
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "obj2");
-    strcpy(f->type, "object");
+    f->name = "obj2";
+    f->type = "object";
 
     sf.union_variants =
         (struct UnionVariantMeta *)calloc(1, sizeof(struct UnionVariantMeta));
@@ -1088,35 +1088,35 @@ TEST test_types_uncovered(void) {
   sf.union_is_anyof = 0;
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "i1");
-    strcpy(f->type, "integer");
+    f->name = "i1";
+    f->type = "integer";
   }
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "i2");
-    strcpy(f->type, "integer");
+    f->name = "i2";
+    f->type = "integer";
   }
 
   /* 3. Test boolean count > 1 and null_count > 1 */
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "b1");
-    strcpy(f->type, "boolean");
+    f->name = "b1";
+    f->type = "boolean";
   }
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "b2");
-    strcpy(f->type, "boolean");
+    f->name = "b2";
+    f->type = "boolean";
   }
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "null1");
-    strcpy(f->type, "null");
+    f->name = "null1";
+    f->type = "null";
   }
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "null2");
-    strcpy(f->type, "null");
+    f->name = "null2";
+    f->type = "null";
   }
   struct_fields_add(&sf, "obj3", "object", "Object", NULL, NULL);
   struct_fields_add(&sf, "s1", "string", NULL, NULL, NULL);
@@ -1159,13 +1159,13 @@ TEST test_types_uncovered(void) {
   struct_fields_init(&sf);
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "s1");
-    strcpy(f->type, "string");
+    f->name = "s1";
+    f->type = "string";
   }
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "s2");
-    strcpy(f->type, "string");
+    f->name = "s2";
+    f->type = "string";
   }
   for (i = 0; i < 2000; ++i) {
     FILE *t;
@@ -1188,8 +1188,8 @@ TEST test_types_uncovered(void) {
   struct_fields_init(&sf);
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "s1");
-    strcpy(f->type, "string");
+    f->name = "s1";
+    f->type = "string";
   }
   for (i = 0; i < 2000; ++i) {
     FILE *t;
@@ -1212,13 +1212,13 @@ TEST test_types_uncovered(void) {
   struct_fields_init(&sf);
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "n1");
-    strcpy(f->type, "number");
+    f->name = "n1";
+    f->type = "number";
   }
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "b1");
-    strcpy(f->type, "boolean");
+    f->name = "b1";
+    f->type = "boolean";
   }
 
   for (i = 0; i < 2000; ++i) {
@@ -1242,13 +1242,13 @@ TEST test_types_uncovered(void) {
   struct_fields_init(&sf);
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "n1");
-    strcpy(f->type, "number");
+    f->name = "n1";
+    f->type = "number";
   }
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "n2");
-    strcpy(f->type, "number");
+    f->name = "n2";
+    f->type = "number";
   }
   for (i = 0; i < 2000; ++i) {
     FILE *t;
@@ -1271,8 +1271,8 @@ TEST test_types_uncovered(void) {
   struct_fields_init(&sf);
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "i1");
-    strcpy(f->type, "integer");
+    f->name = "i1";
+    f->type = "integer";
   }
   for (i = 0; i < 2000; ++i) {
     FILE *t;
@@ -1295,8 +1295,8 @@ TEST test_types_uncovered(void) {
   struct_fields_init(&sf);
   {
     struct StructField *f = &sf.fields[sf.size++];
-    strcpy(f->name, "b3");
-    strcpy(f->type, "boolean");
+    f->name = "b3";
+    f->type = "boolean";
   }
   for (i = 0; i < 2000; ++i) {
     FILE *t;
@@ -279,20 +279,7 @@ TEST test_string_simple_pattern_prefix(void) {
   struct_fields_add(&sf, "p", "string", NULL, NULL, NULL);
 
   f = &sf.fields[0];
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER) ||                         \
-    defined(__STDC_LIB_EXT1__) && __STDC_WANT_LIB_EXT1__
-  strcpy_s(f->pattern, sizeof(f->pattern), "^prefix");
-#else
-#if defined(_MSC_VER)
-  strcpy_s(f->pattern, sizeof(f->pattern), "^prefix");
-#else
-#if defined(_MSC_VER)
-  strcpy_s(f->pattern, sizeof(f->pattern), "^prefix");
-#else
-  strcpy(f->pattern, "^prefix");
-#endif
-#endif
-#endif
+  f->pattern = "^prefix";
 
   code = (gen_parse_code("SPat", &sf, &_ast_gen_parse_code_6),
           _ast_gen_parse_code_6);
@@ -316,20 +303,7 @@ TEST test_string_simple_pattern_suffix(void) {
   struct_fields_add(&sf, "p", "string", NULL, NULL, NULL);
 
   f = &sf.fields[0];
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER) ||                         \
-    defined(__STDC_LIB_EXT1__) && __STDC_WANT_LIB_EXT1__
-  strcpy_s(f->pattern, sizeof(f->pattern), "suffix$");
-#else
-#if defined(_MSC_VER)
-  strcpy_s(f->pattern, sizeof(f->pattern), "suffix$");
-#else
-#if defined(_MSC_VER)
-  strcpy_s(f->pattern, sizeof(f->pattern), "suffix$");
-#else
-  strcpy(f->pattern, "suffix$");
-#endif
-#endif
-#endif
+  f->pattern = "suffix$";
 
   code = (gen_parse_code("SSuf", &sf, &_ast_gen_parse_code_7),
           _ast_gen_parse_code_7);
@@ -353,20 +327,7 @@ TEST test_string_simple_pattern_exact(void) {
   struct_fields_add(&sf, "p", "string", NULL, NULL, NULL);
 
   f = &sf.fields[0];
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER) ||                         \
-    defined(__STDC_LIB_EXT1__) && __STDC_WANT_LIB_EXT1__
-  strcpy_s(f->pattern, sizeof(f->pattern), "^exact$");
-#else
-#if defined(_MSC_VER)
-  strcpy_s(f->pattern, sizeof(f->pattern), "^exact$");
-#else
-#if defined(_MSC_VER)
-  strcpy_s(f->pattern, sizeof(f->pattern), "^exact$");
-#else
-  strcpy(f->pattern, "^exact$");
-#endif
-#endif
-#endif
+  f->pattern = "^exact$";
 
   code = (gen_parse_code("SExact", &sf, &_ast_gen_parse_code_8),
           _ast_gen_parse_code_8);
@@ -390,20 +351,7 @@ TEST test_string_simple_pattern_contains(void) {
   struct_fields_add(&sf, "p", "string", NULL, NULL, NULL);
 
   f = &sf.fields[0];
-#if defined(_MSC_VER) && !defined(__INTEL_COMPILER) ||                         \
-    defined(__STDC_LIB_EXT1__) && __STDC_WANT_LIB_EXT1__
-  strcpy_s(f->pattern, sizeof(f->pattern), "sub");
-#else
-#if defined(_MSC_VER)
-  strcpy_s(f->pattern, sizeof(f->pattern), "sub");
-#else
-#if defined(_MSC_VER)
-  strcpy_s(f->pattern, sizeof(f->pattern), "sub");
-#else
-  strcpy(f->pattern, "sub");
-#endif
-#endif
-#endif
+  f->pattern = "sub";
 
   code = (gen_parse_code("SSub", &sf, &_ast_gen_parse_code_9),
           _ast_gen_parse_code_9);
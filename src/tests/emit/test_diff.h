@@ -109,9 +109,44 @@ TEST test_patch_list_to_diff_empty(void) {
   PASS();
 }
 
+TEST test_patch_list_to_diff_context(void) {
+  struct PatchList list;
+  struct TokenList *tokens = NULL;
+  const char *src = "a;\nb;\nc;\nd;\ne;\nf;\ng;\n";
+  char *diff_str = NULL;
+  size_t i;
+
+  ASSERT_EQ(0, tokenize(az_span_create_from_str((char *)src), &tokens));
+  ASSERT_EQ(0, patch_list_init(&list));
+  for (i = 0; i < tokens->size; ++i) {
+    const struct Token *tok = &tokens->tokens[i];
+    if (tok->kind != TOKEN_IDENTIFIER)
+      continue;
+    if (tok->start[0] == 'c')
+      ASSERT_EQ(0, patch_list_add(&list, i, i + 1, strdup("C")));
+    else if (tok->start[0] == 'f')
+      ASSERT_EQ(0, patch_list_add(&list, i, i + 1, strdup("f")));
+  }
+
+  /* The no-op patch on `f` produces no hunk */
+  ASSERT_EQ(0, patch_list_to_diff_context(&list, tokens, "f.c", 0, &diff_str));
+  ASSERT_STR_EQ("--- f.c\n+++ f.c\n@@ -3,1 +3,1 @@\n-c;\n+C;\n", diff_str);
+  free(diff_str);
+
+  ASSERT_EQ(0, patch_list_to_diff_context(&list, tokens, "f.c", 1, &diff_str));
+  ASSERT_STR_EQ("--- f.c\n+++ f.c\n@@ -2,3 +2,3 @@\n b;\n-c;\n+C;\n d;\n",
+                diff_str);
+  free(diff_str);
+
+  patch_list_free(&list);
+  free_token_list(tokens);
+  PASS();
+}
+
 SUITE(diff_suite) {
   RUN_TEST(test_patch_list_to_diff_basic);
   RUN_TEST(test_patch_list_to_diff_empty);
+  RUN_TEST(test_patch_list_to_diff_context);
 }
 
 #ifdef __cplusplus
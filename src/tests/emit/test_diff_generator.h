@@ -75,7 +75,7 @@ TEST test_diff_generation_basic(void) {
   ASSERT_EQ(0, rc);
   ASSERT(strstr(diff, "--- a/a.c"));
   ASSERT(strstr(diff, "+++ b/a.c"));
-  ASSERT(strstr(diff, "@@ -patch 0 @@"));
+  ASSERT(strstr(diff, "@@ -patch 0 @@ 1:1\n"));
   ASSERT(strstr(diff, "-int"));
   ASSERT(strstr(diff, "+void"));
 
@@ -151,10 +151,42 @@ TEST test_diff_generation_basic(void) {
   PASS();
 }
 
+/**
+ * @brief Tests that a file name longer than the initial buffer fits
+ * @return TEST
+ */
+TEST test_diff_generation_long_filename(void) {
+  const char *src = "int a = 1;";
+  struct TokenList *tokens = NULL;
+  struct PatchList patch_list;
+  char filename[5000];
+  char *diff = NULL;
+
+  memset(filename, 'f', sizeof(filename) - 1);
+  filename[sizeof(filename) - 1] = '\0';
+  ASSERT_EQ(0, tokenize(az_span_create((uint8_t *)src, strlen(src)), &tokens));
+  patch_list_init(&patch_list);
+  ASSERT_EQ(0, patch_list_add(&patch_list, 0, 1, strdup("void")));
+
+  ASSERT_EQ(0,
+            patch_list_generate_diff(tokens, &patch_list, filename, &diff));
+  ASSERT(diff != NULL);
+  ASSERT(strncmp(diff, "--- a/fff", 9) == 0);
+  ASSERT(strstr(diff, "@@ -patch 0 @@ 1:1\n-int\n+void\n") != NULL);
+  free(diff);
+
+  patch_list_free(&patch_list);
+  free_token_list(tokens);
+  PASS();
+}
+
 /**
  * @brief Suite for diff generator
  */
-SUITE(diff_generator_suite) { RUN_TEST(test_diff_generation_basic); }
+SUITE(diff_generator_suite) {
+  RUN_TEST(test_diff_generation_basic);
+  RUN_TEST(test_diff_generation_long_filename);
+}
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,225 @@
+/**
+ * @file test_line_diff.h
+ * @brief Unit tests for the line-based Myers diff.
+ */
+
+#ifndef TEST_LINE_DIFF_H
+#define TEST_LINE_DIFF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+#include <greatest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "functions/emit/line_diff.h"
+/* clang-format on */
+
+/**
+ * @brief Growable buffer collecting diff output.
+ */
+struct LineDiffTestBuf {
+  char *data;
+  size_t len;
+  size_t cap;
+};
+
+/**
+ * @brief line_diff_write_fn appending to a LineDiffTestBuf.
+ */
+static cdd_c_error_t line_diff_test_write(void *user_data, const char *text,
+                                          size_t len) {
+  struct LineDiffTestBuf *buf = (struct LineDiffTestBuf *)user_data;
+  if (buf->len + len + 1 > buf->cap) {
+    size_t cap = (buf->len + len + 1) * 2;
+    char *grown = (char *)realloc(buf->data, cap);
+    if (!grown)
+      return CDD_C_ERROR_MEMORY;
+    buf->data = grown;
+    buf->cap = cap;
+  }
+  memcpy(buf->data + buf->len, text, len);
+  buf->len += len;
+  buf->data[buf->len] = '\0';
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Diffs two strings into `buf`.
+ */
+static cdd_c_error_t line_diff_test_run(const char *a, const char *b,
+                                        const struct LineDiffOptions *opts,
+                                        struct LineDiffTestBuf *buf,
+                                        size_t *hunks) {
+  memset(buf, 0, sizeof(*buf));
+  return line_diff_unified(a, strlen(a), b, strlen(b), opts,
+                           line_diff_test_write, buf, hunks);
+}
+
+/**
+ * @brief Tests that equal texts produce no hunks.
+ *
+ * @return The result of the test.
+ */
+TEST test_line_diff_identical(void) {
+  struct LineDiffTestBuf buf;
+  size_t hunks = 99;
+
+  ASSERT_EQ(CDD_C_SUCCESS,
+            line_diff_test_run("a\nb\n", "a\nb\n", NULL, &buf, &hunks));
+  ASSERT_EQ(0, hunks);
+  ASSERT(buf.data == NULL);
+
+  ASSERT_EQ(CDD_C_SUCCESS, line_diff_test_run("", "", NULL, &buf, &hunks));
+  ASSERT_EQ(0, hunks);
+
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            line_diff_unified("a", 1, "b", 1, NULL, NULL, NULL, NULL));
+  PASS();
+}
+
+/**
+ * @brief Tests a minimal edit script with context and line numbers.
+ *
+ * @return The result of the test.
+ */
+TEST test_line_diff_basic(void) {
+  struct LineDiffTestBuf buf;
+  size_t hunks = 0;
+
+  ASSERT_EQ(CDD_C_SUCCESS,
+            line_diff_test_run("a\nb\nc\nd\ne\nf\ng\n", "a\nb\nc\nD\ne\nf\ng\n",
+                               NULL, &buf, &hunks));
+  ASSERT_EQ(1, hunks);
+  ASSERT_STR_EQ("@@ -1,7 +1,7 @@\n a\n b\n c\n-d\n+D\n e\n f\n g\n", buf.data);
+  free(buf.data);
+
+  /* Pure insertion and deletion report the line before an empty range */
+  ASSERT_EQ(CDD_C_SUCCESS, line_diff_test_run("", "x\n", NULL, &buf, &hunks));
+  ASSERT_STR_EQ("@@ -0,0 +1,1 @@\n+x\n", buf.data);
+  free(buf.data);
+  ASSERT_EQ(CDD_C_SUCCESS, line_diff_test_run("x\n", "", NULL, &buf, &hunks));
+  ASSERT_STR_EQ("@@ -1,1 +0,0 @@\n-x\n", buf.data);
+  free(buf.data);
+
+  /* Moving a line deletes and inserts only that line */
+  ASSERT_EQ(CDD_C_SUCCESS, line_diff_test_run("a\nb\nc\nd\n", "b\nc\nd\na\n",
+                                              NULL, &buf, &hunks));
+  ASSERT_STR_EQ("@@ -1,4 +1,4 @@\n-a\n b\n c\n d\n+a\n", buf.data);
+  free(buf.data);
+  PASS();
+}
+
+/**
+ * @brief Tests the missing-newline marker.
+ *
+ * @return The result of the test.
+ */
+TEST test_line_diff_no_newline(void) {
+  struct LineDiffTestBuf buf;
+  struct LineDiffOptions opts;
+  size_t hunks = 0;
+
+  line_diff_options_init(&opts);
+  opts.context = 0;
+  ASSERT_EQ(CDD_C_SUCCESS,
+            line_diff_test_run("a\nb", "a\nb\n", &opts, &buf, &hunks));
+  ASSERT_STR_EQ("@@ -2,1 +2,1 @@\n-b\n\\ No newline at end of file\n+b\n",
+                buf.data);
+  free(buf.data);
+  PASS();
+}
+
+/**
+ * @brief Tests splitting and merging hunks by context, and line offsets.
+ *
+ * @return The result of the test.
+ */
+TEST test_line_diff_context(void) {
+  const char *a = "1\n2\n3\n4\n5\n6\n7\n8\n9\n";
+  const char *b = "1\nX\n3\n4\n5\n6\n7\nY\n9\n";
+  struct LineDiffTestBuf buf;
+  struct LineDiffOptions opts;
+  size_t hunks = 0;
+
+  line_diff_options_init(&opts);
+  opts.context = 1;
+  ASSERT_EQ(CDD_C_SUCCESS, line_diff_test_run(a, b, &opts, &buf, &hunks));
+  ASSERT_EQ(2, hunks);
+  ASSERT_STR_EQ("@@ -1,3 +1,3 @@\n 1\n-2\n+X\n 3\n"
+                "@@ -7,3 +7,3 @@\n 7\n-8\n+Y\n 9\n",
+                buf.data);
+  free(buf.data);
+
+  opts.context = 3;
+  ASSERT_EQ(CDD_C_SUCCESS, line_diff_test_run(a, b, &opts, &buf, &hunks));
+  ASSERT_EQ(1, hunks);
+  free(buf.data);
+
+  /* An excerpt starting at line 100 of the old and 110 of the new file */
+  opts.context = 0;
+  opts.old_line = 100;
+  opts.new_line = 110;
+  ASSERT_EQ(CDD_C_SUCCESS, line_diff_test_run(a, b, &opts, &buf, &hunks));
+  ASSERT_STR_EQ("@@ -101,1 +111,1 @@\n-2\n+X\n"
+                "@@ -107,1 +117,1 @@\n-8\n+Y\n",
+                buf.data);
+  free(buf.data);
+  PASS();
+}
+
+/**
+ * @brief Tests a large input with scattered edits.
+ *
+ * @return The result of the test.
+ */
+TEST test_line_diff_large(void) {
+  const size_t n = 50000;
+  char *a = (char *)malloc(n * 8 + 1);
+  char *b = (char *)malloc(n * 8 + 16);
+  char *pa = a, *pb = b;
+  struct LineDiffTestBuf buf;
+  size_t hunks = 0;
+  size_t i;
+
+  ASSERT(a != NULL && b != NULL);
+  for (i = 0; i < n; ++i) {
+    pa += sprintf(pa, "%lu\n", (unsigned long)i);
+    if (i == 10 || i == 30000)
+      continue;
+    pb += sprintf(pb, "%lu\n", (unsigned long)i);
+    if (i == 45000)
+      pb += sprintf(pb, "new\n");
+  }
+
+  ASSERT_EQ(CDD_C_SUCCESS, line_diff_test_run(a, b, NULL, &buf, &hunks));
+  ASSERT_EQ(3, hunks);
+  ASSERT(strstr(buf.data, "@@ -8,7 +8,6 @@\n") != NULL);
+  ASSERT(strstr(buf.data, "\n-30000\n") != NULL);
+  ASSERT(strstr(buf.data, " 45000\n+new\n 45001\n") != NULL);
+
+  free(buf.data);
+  free(a);
+  free(b);
+  PASS();
+}
+
+SUITE(line_diff_suite) {
+  RUN_TEST(test_line_diff_identical);
+  RUN_TEST(test_line_diff_basic);
+  RUN_TEST(test_line_diff_no_newline);
+  RUN_TEST(test_line_diff_context);
+  RUN_TEST(test_line_diff_large);
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TEST_LINE_DIFF_H */
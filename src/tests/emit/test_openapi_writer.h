@@ -21,6 +21,7 @@ extern "C" {
 #include "functions/parse/str.h"
 #include "openapi/emit/openapi.h"
 #include "openapi/parse/openapi.h"
+#include "openapi/parse/spec_reader.h"
 /* clang-format on */
 
 /* --- Helpers --- */
@@ -80,6 +81,33 @@ static void setup_test_spec(struct OpenAPI_Spec *spec,
   }
 }
 
+static char *stream_spec_to_string(const struct OpenAPI_Spec *spec,
+                                   enum SpecFormat format) {
+  FILE *tmp;
+  long sz;
+  char *content = NULL;
+#if defined(_MSC_VER)
+  if (tmpfile_s(&tmp) != 0)
+    tmp = NULL;
+#else
+  tmp = tmpfile();
+#endif
+  if (!tmp)
+    return NULL;
+  if (openapi_write_spec_to_stream(spec, tmp, format) == 0) {
+    fseek(tmp, 0, SEEK_END);
+    sz = ftell(tmp);
+    rewind(tmp);
+    content = (char *)calloc(1, (size_t)sz + 1);
+    if (content && fread(content, 1, (size_t)sz, tmp) != (size_t)sz) {
+      free(content);
+      content = NULL;
+    }
+  }
+  fclose(tmp);
+  return content;
+}
+
 /* --- Tests --- */
 
 TEST test_writer_empty_spec(void) {
@@ -2722,12 +2750,17 @@ TEST test_writer_components_schemas_raw(void) {
   char *json;
   struct OpenAPI_Spec spec = {0};
   char *names[3] = {"Token", "Flag", "Nums"};
-  char *raw[3] = {"{\"type\":\"string\"}", "true",
-                  "{\"type\":\"array\",\"items\":{\"type\":\"integer\"}}"};
+  const char *raw[3] = {
+      "{\"type\":\"string\"}", "true",
+      "{\"type\":\"array\",\"items\":{\"type\":\"integer\"}}"};
+  struct JsonFragment *frags[3];
+  size_t i;
   json = NULL;
 
+  for (i = 0; i < 3; ++i)
+    ASSERT_EQ(CDD_C_SUCCESS, json_fragment_parse(raw[i], &frags[i]));
   spec.raw_schema_names = names;
-  spec.raw_schema_json = raw;
+  spec.raw_schemas = frags;
   spec.n_raw_schemas = 3;
 
   rc = openapi_write_spec_to_json(&spec, &json);
@@ -2761,10 +2794,107 @@ TEST test_writer_components_schemas_raw(void) {
   }
 
   free(json);
+  for (i = 0; i < 3; ++i)
+    json_fragment_release(frags[i]);
   g_fail_io_after = -1;
   PASS();
 }
 
+TEST test_writer_stream_matches_string(void) {
+  struct OpenAPI_Spec spec;
+  struct OpenAPI_Path paths[2];
+  struct OpenAPI_Operation ops[2];
+  struct OpenAPI_Response resps[2];
+  char *names[1] = {"Token"};
+  char *defined_names[1] = {"Pet"};
+  struct StructFields defined;
+  struct JsonFragment *frags[1];
+  char *json = NULL;
+  char *streamed;
+  JSON_Value *expected;
+  JSON_Value *from_yaml = NULL;
+  int pass;
+
+  memset(&spec, 0, sizeof(spec));
+  memset(paths, 0, sizeof(paths));
+  memset(ops, 0, sizeof(ops));
+  memset(resps, 0, sizeof(resps));
+  spec.info.title = "Pets \"A/B\"";
+  spec.info.version = "1";
+  spec.extensions_json = "{\"x-top\":[1,2.5]}";
+  spec.paths_extensions_json = "{\"x-paths\":true}";
+  spec.components_extensions_json = "{\"x-comps\":{}}";
+  ASSERT_EQ(CDD_C_SUCCESS,
+            json_fragment_parse("{\"type\":\"string\"}", &frags[0]));
+  spec.raw_schema_names = names;
+  spec.raw_schemas = frags;
+  spec.n_raw_schemas = 1;
+  ASSERT_EQ(CDD_C_SUCCESS, struct_fields_init(&defined));
+  ASSERT_EQ(CDD_C_SUCCESS,
+            struct_fields_add(&defined, "name", "string", NULL, NULL, NULL));
+  spec.defined_schemas = &defined;
+  spec.defined_schema_names = defined_names;
+  spec.n_defined_schemas = 1;
+
+  /* Two entries for one route merge into a single path item */
+  spec.paths = paths;
+  spec.n_paths = 2;
+  paths[0].route = "/pets";
+  paths[1].route = "/pets";
+  paths[0].operations = &ops[0];
+  paths[0].n_operations = 1;
+  paths[1].operations = &ops[1];
+  paths[1].n_operations = 1;
+  ops[0].verb = OA_VERB_GET;
+  ops[0].operation_id = "listPets";
+  ops[0].responses = &resps[0];
+  ops[0].n_responses = 1;
+  ops[1].verb = OA_VERB_POST;
+  ops[1].operation_id = "createPet";
+  ops[1].responses = &resps[1];
+  ops[1].n_responses = 1;
+  resps[0].code = "200";
+  resps[0].description = "ok";
+  resps[1].code = "201";
+  resps[1].description = "created";
+
+  /* Second pass: a non-x- extension key takes the whole-section path.
+   * Third pass: a raw schema named like a defined one replaces it. */
+  for (pass = 0; pass < 3; ++pass) {
+    if (pass == 1)
+      spec.components_extensions_json = "{\"schemas\":{\"Old\":{}}}";
+    if (pass == 2) {
+      spec.components_extensions_json = "{\"x-comps\":{}}";
+      names[0] = "Pet";
+    }
+    ASSERT_EQ(0, openapi_write_spec_to_json(&spec, &json));
+    streamed = stream_spec_to_string(&spec, SPEC_FORMAT_JSON);
+    ASSERT(streamed != NULL);
+    ASSERT_STR_EQ(json, streamed);
+    free(streamed);
+
+    expected = json_parse_string(json);
+    ASSERT(expected != NULL);
+    streamed = stream_spec_to_string(&spec, SPEC_FORMAT_YAML);
+    ASSERT(streamed != NULL);
+    ASSERT_EQ(CDD_C_SUCCESS,
+              spec_reader_parse(streamed, strlen(streamed), SPEC_FORMAT_YAML,
+                                &from_yaml, NULL));
+    ASSERT(json_value_equals(expected, from_yaml));
+    json_value_free(from_yaml);
+    json_value_free(expected);
+    free(streamed);
+    free(json);
+    json = NULL;
+  }
+
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            openapi_write_spec_to_stream(&spec, NULL, SPEC_FORMAT_JSON));
+  json_fragment_release(frags[0]);
+  struct_fields_free(&defined);
+  PASS();
+}
+
 TEST test_writer_schema_ref_external(void) {
   int rc;
   struct OpenAPI_Spec spec;
@@ -4970,6 +5100,7 @@ SUITE(openapi_writer_suite) {
   RUN_TEST(test_writer_multipart_schema);
   RUN_TEST(test_writer_components_schemas);
   RUN_TEST(test_writer_components_schemas_raw);
+  RUN_TEST(test_writer_stream_matches_string);
   RUN_TEST(test_writer_schema_ref_external);
   RUN_TEST(test_writer_schema_dynamic_ref_external);
   RUN_TEST(test_writer_schema_items_ref_external);
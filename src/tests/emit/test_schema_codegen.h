@@ -603,11 +603,11 @@ TEST test_schema_constraints_bounds(void) {
   sc.additional_properties =
       (struct SchemaType *)calloc(1, sizeof(struct SchemaType));
   sc.additional_properties->name = (char *)malloc(2);
-  strcpy(sc.additional_properties->name, "n");
+  sc.additional_properties->name = "n";
   sc.additional_properties->type = (char *)malloc(2);
-  strcpy(sc.additional_properties->type, "t");
+  sc.additional_properties->type = "t";
   sc.additional_properties->ref = (char *)malloc(2);
-  strcpy(sc.additional_properties->ref, "r");
+  sc.additional_properties->ref = "r";
   schema_constraints_free(&sc);
   g_fail_io_after = -1;
 
@@ -16,6 +16,7 @@ extern "C" {
 #endif
 
 #include "cdd_test_helpers/cdd_helpers.h"
+#include "functions/parse/fs.h"
 #include "routes/emit/client_gen.h"
 #include "routes/emit/server_gen.h"
 /* clang-format on */
@@ -129,7 +130,7 @@ TEST test_server_gen_basic(void) {
 
   ASSERT(f != NULL);
   if (f) {
-    char buf[16384];
+    static char buf[65536];
     size_t n = fread(buf, 1, sizeof(buf) - 1, f);
     buf[n] = '\0';
     ASSERT(strstr(buf, "handle_mcp_sse") != NULL);
@@ -284,12 +285,205 @@ TEST test_server_gen_branches(void) {
 
   PASS();
 }
+/**
+ * @brief test_server_gen_route_trie
+ * @return TEST
+ */
+TEST test_server_gen_route_trie(void) {
+  struct OpenAPI_Spec spec;
+  struct OpenApiClientConfig config;
+  struct OpenAPI_Path paths[3];
+  struct OpenAPI_Operation ops[4];
+  char *content = NULL;
+  size_t sz = 0;
+  int rc;
+
+  memset(&spec, 0, sizeof(spec));
+  memset(&config, 0, sizeof(config));
+  memset(paths, 0, sizeof(paths));
+  memset(ops, 0, sizeof(ops));
+
+  paths[0].route = "/pets";
+  paths[0].operations = &ops[0];
+  paths[0].n_operations = 2;
+  ops[0].verb = OA_VERB_GET;
+  ops[0].operation_id = "listPets";
+  ops[1].verb = OA_VERB_POST;
+  ops[1].operation_id = "createPet";
+
+  paths[1].route = "/pets/{petId}";
+  paths[1].operations = &ops[2];
+  paths[1].n_operations = 1;
+  ops[2].verb = OA_VERB_GET;
+  ops[2].operation_id = "getPet";
+
+  paths[2].route = "/pets/{petId}/photos/{file}.json";
+  paths[2].operations = &ops[3];
+  paths[2].n_operations = 1;
+  ops[3].verb = OA_VERB_GET;
+  ops[3].operation_id = "getPhoto";
+
+  spec.paths = paths;
+  spec.n_paths = 3;
+  config.filename_base = "test_build_dir/test_server_trie";
+
+  rc = openapi_server_generate(&spec, &config);
+  ASSERT_EQ(0, rc);
+
+  rc = read_to_file("test_build_dir/src/test_server_trie_server.c", "r",
+                    &content, &sz);
+  ASSERT_EQ(0, rc);
+  ASSERT(content != NULL);
+  ASSERT(strstr(content, "static int route_dispatch(") != NULL);
+  ASSERT(strstr(content, "#define ROUTE_MAX_PARAMS 2") != NULL);
+  ASSERT(strstr(content, "route_params_getPet[] = {\"petId\"}") != NULL);
+  ASSERT(strstr(content, "route_params_getPhoto[] = {\"petId\", "
+                         "\"file\"}") != NULL);
+  /* Shared "/pets" prefix yields a single literal branch */
+  ASSERT(strstr(content, "memcmp(seg.ptr, \"pets\", 4)") != NULL);
+  ASSERT(strstr(strstr(content, "memcmp(seg.ptr, \"pets\", 4)") + 1,
+                "memcmp(seg.ptr, \"pets\", 4)") == NULL);
+  ASSERT(strstr(content, "memcmp(seg.ptr + seg.len - 5, \".json\", 5)") !=
+         NULL);
+  ASSERT(strstr(content, "m->handler = handle_createPet;") != NULL);
+  ASSERT(strstr(content, "c_rest_router_add(router, \"GET\", \"/pets\"") ==
+         NULL);
+  /* The handler's response is sent; failures become 500 */
+  ASSERT(strstr(content, "res->body_len = strlen(resp);") != NULL);
+  ASSERT(strstr(content, "return res->status_code;\n}") != NULL);
+  ASSERT(strstr(content, "status_code;\n    return CDD_C_SUCCESS;") == NULL);
+  ASSERT(strstr(content, "if (status < 100 || status > 599) {") != NULL);
+  ASSERT(strstr(content, "mg_write(conn, res.body, res.body_len);") != NULL);
+  ASSERT(strstr(content, "Content-Length: 0") == NULL);
+  C_CDD_FREE(content);
+
+  remove("test_build_dir/src/test_server_trie_server.c");
+  PASS();
+}
+/**
+ * @brief test_server_gen_request_binding
+ * @return TEST
+ */
+TEST test_server_gen_request_binding(void) {
+  struct OpenAPI_Spec spec;
+  struct OpenApiClientConfig config;
+  struct OpenAPI_Path path;
+  struct OpenAPI_Operation ops[2];
+  struct OpenAPI_Parameter params[4];
+  struct OpenAPI_MediaType media;
+  struct StructFields pet;
+  struct StructField pet_fields[2];
+  char *schema_names[1];
+  char *content = NULL;
+  size_t sz = 0;
+  int rc;
+
+  memset(&spec, 0, sizeof(spec));
+  memset(&config, 0, sizeof(config));
+  memset(&path, 0, sizeof(path));
+  memset(ops, 0, sizeof(ops));
+  memset(params, 0, sizeof(params));
+  memset(&media, 0, sizeof(media));
+  memset(&pet, 0, sizeof(pet));
+  memset(pet_fields, 0, sizeof(pet_fields));
+
+  pet_fields[0].name = "name";
+  pet_fields[0].type = "string";
+  pet_fields[0].required = 1;
+  pet_fields[1].name = "age";
+  pet_fields[1].type = "integer";
+  pet.fields = pet_fields;
+  pet.size = 2;
+  schema_names[0] = "Pet";
+  spec.defined_schemas = &pet;
+  spec.defined_schema_names = schema_names;
+  spec.n_defined_schemas = 1;
+
+  path.route = "/pets/{petId}";
+  path.parameters = &params[0];
+  path.n_parameters = 1;
+  params[0].name = "petId";
+  params[0].in = OA_PARAM_IN_PATH;
+  params[0].type = "integer";
+  params[0].required = 1;
+  path.operations = ops;
+  path.n_operations = 2;
+
+  ops[0].verb = OA_VERB_GET;
+  ops[0].operation_id = "getPet";
+  ops[0].parameters = &params[1];
+  ops[0].n_parameters = 3;
+  params[1].name = "X-Trace-Id";
+  params[1].in = OA_PARAM_IN_HEADER;
+  params[1].type = "string";
+  /* Same name as the path parameter, and one named like a fixed member */
+  params[2].name = "petId";
+  params[2].in = OA_PARAM_IN_QUERY;
+  params[2].type = "string";
+  params[3].name = "body";
+  params[3].in = OA_PARAM_IN_QUERY;
+  params[3].type = "boolean";
+
+  ops[1].verb = OA_VERB_PUT;
+  ops[1].operation_id = "putPet";
+  ops[1].req_body.ref_name = "Pet";
+  ops[1].req_body_media_types = &media;
+  ops[1].n_req_body_media_types = 1;
+  media.name = "application/x-www-form-urlencoded";
+
+  spec.paths = &path;
+  spec.n_paths = 1;
+  config.filename_base = "test_build_dir/test_server_bind";
+
+  rc = openapi_server_generate(&spec, &config);
+  ASSERT_EQ(0, rc);
+
+  rc = read_to_file("test_build_dir/src/test_server_bind_server.c", "r",
+                    &content, &sz);
+  ASSERT_EQ(0, rc);
+  ASSERT(content != NULL);
+  /* Per-thread arena, reset after each response */
+  ASSERT(strstr(content, "callbacks.init_thread = server_init_thread;") !=
+         NULL);
+  ASSERT(strstr(content, "rctx.arena->used = 0;") != NULL);
+  /* Path-level parameter binds for every operation on the path */
+  ASSERT(strstr(content, "struct getPet_request {\n    long path_petId;") !=
+         NULL);
+  ASSERT(strstr(content, "struct putPet_request {\n    long path_petId;") !=
+         NULL);
+  ASSERT(strstr(content, "struct route_span header_X_Trace_Id;") != NULL);
+  ASSERT(strstr(content, "if (!out->has_path_petId)") != NULL);
+  /* `+` stays literal in path segments */
+  ASSERT(strstr(content, "v = ctx->match->params[0];\n"
+                         "        if (route_span_decode(ctx->arena, &v, 0)") !=
+         NULL);
+  ASSERT(strstr(content, "route_span_decode(ctx->arena, &v, 1)") != NULL);
+  /* Members are prefixed by location, so same-named parameters coexist */
+  ASSERT(strstr(content, "struct route_span query_petId;") != NULL);
+  ASSERT(strstr(content, "route_span_to_bool(v, &out->query_body)") != NULL);
+  ASSERT(strstr(content, "    long petId;") == NULL);
+  ASSERT(strstr(content, "    int body;") == NULL);
+  ASSERT(strstr(content, "mg_get_header(ctx->conn, \"X-Trace-Id\")") !=
+         NULL);
+  /* Form body fields bind straight into the request struct */
+  ASSERT(strstr(content, "struct route_span body_name;") != NULL);
+  ASSERT(strstr(content, "route_pairs_get(out->body, \"age\", &v)") != NULL);
+  ASSERT(strstr(content, "route_span_to_long(v, &out->body_age)") != NULL);
+  ASSERT(strstr(content, "bind_rc = bind_putPet(rctx, &in);") != NULL);
+  ASSERT(strstr(content, "c_rest_request_parse_urlencoded") == NULL);
+  C_CDD_FREE(content);
+
+  remove("test_build_dir/src/test_server_bind_server.c");
+  PASS();
+}
 SUITE(server_gen_suite) {
   RUN_TEST(test_server_gen_null_args);
   RUN_TEST(test_server_gen_test_fopen_fail);
   RUN_TEST(test_server_gen_branches);
   RUN_TEST(test_server_gen_basic);
   RUN_TEST(test_server_gen_fail_open);
+  RUN_TEST(test_server_gen_route_trie);
+  RUN_TEST(test_server_gen_request_binding);
 }
 
 #ifdef __cplusplus
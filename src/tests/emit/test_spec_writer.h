@@ -0,0 +1,218 @@
+/**
+ * @file test_spec_writer.h
+ * @brief Unit tests for the streaming JSON/YAML spec writer.
+ */
+
+#ifndef TEST_SPEC_WRITER_H
+#define TEST_SPEC_WRITER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+#include <greatest.h>
+#include <parson.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "openapi/emit/spec_writer.h"
+#include "openapi/parse/spec_reader.h"
+/* clang-format on */
+
+/**
+ * @brief Opens a scratch sink.
+ */
+static FILE *spec_writer_test_open(void) {
+  FILE *tmp;
+#if defined(_MSC_VER)
+  if (tmpfile_s(&tmp) != 0)
+    tmp = NULL;
+#else
+  tmp = tmpfile();
+#endif
+  return tmp;
+}
+
+/**
+ * @brief Reads back everything written to a scratch sink and closes it.
+ */
+static char *spec_writer_test_slurp(FILE *tmp) {
+  long sz;
+  char *content;
+  fseek(tmp, 0, SEEK_END);
+  sz = ftell(tmp);
+  rewind(tmp);
+  content = (char *)calloc(1, (size_t)sz + 1);
+  if (content && fread(content, 1, (size_t)sz, tmp) != (size_t)sz) {
+    free(content);
+    content = NULL;
+  }
+  fclose(tmp);
+  return content;
+}
+
+static const char spec_writer_test_doc[] =
+    "{\"openapi\":\"3.1.0\",\"info\":{\"title\":\"a/b \\\"q\\\"\\n\\u0001\","
+    "\"version\":\"1\"},\"tags\":[],\"x-e\":{},\"paths\":{\"/p\":{\"get\":"
+    "{\"responses\":{\"200\":{\"description\":\"true\"}}}}},"
+    "\"x-n\":[1,-2.5,1e+20,true,null,[[\"- x\",{\"k\":\"v\"}],[]]],"
+    "\"x-s\":[\"\",\"#c\",\"a: b\",\"No\",\"3.0\",\"caf\\u00e9\"]}";
+
+/**
+ * @brief Tests that JSON output matches parson's pretty serializer exactly.
+ *
+ * @return The result of the test.
+ */
+TEST test_spec_writer_json_matches_parson(void) {
+  JSON_Value *doc = json_parse_string(spec_writer_test_doc);
+  FILE *tmp = spec_writer_test_open();
+  char *expected;
+  char *got;
+
+  ASSERT(doc != NULL);
+  ASSERT(tmp != NULL);
+  ASSERT_EQ(CDD_C_SUCCESS, spec_write_value(tmp, SPEC_FORMAT_JSON, doc));
+  got = spec_writer_test_slurp(tmp);
+  expected = json_serialize_to_string_pretty(doc);
+  ASSERT(got != NULL && expected != NULL);
+  ASSERT_STR_EQ(expected, got);
+
+  free(got);
+  json_free_serialized_string(expected);
+  json_value_free(doc);
+  PASS();
+}
+
+/**
+ * @brief Tests that YAML output reads back as the same document.
+ *
+ * @return The result of the test.
+ */
+TEST test_spec_writer_yaml_round_trip(void) {
+  JSON_Value *doc = json_parse_string(spec_writer_test_doc);
+  JSON_Value *back = NULL;
+  FILE *tmp = spec_writer_test_open();
+  char *got;
+
+  ASSERT(doc != NULL);
+  ASSERT(tmp != NULL);
+  ASSERT_EQ(CDD_C_SUCCESS, spec_write_value(tmp, SPEC_FORMAT_YAML, doc));
+  got = spec_writer_test_slurp(tmp);
+  ASSERT(got != NULL);
+
+  /* Scalars that would resolve to another type or indicator are quoted */
+  ASSERT(strstr(got, "\n        \"200\":\n") != NULL);
+  ASSERT(strstr(got, "description: \"true\"\n") != NULL);
+  ASSERT(strstr(got, "\n  - - - \"- x\"\n      - k: v\n    - []\n") != NULL);
+  ASSERT(strstr(got, "  - 1.0e+20\n") != NULL);
+  ASSERT(strstr(got, "tags: []\n") != NULL);
+
+  ASSERT_EQ(CDD_C_SUCCESS, spec_reader_parse(got, strlen(got),
+                                             SPEC_FORMAT_YAML, &back, NULL));
+  ASSERT(json_value_equals(doc, back));
+
+  free(got);
+  json_value_free(back);
+  json_value_free(doc);
+  PASS();
+}
+
+/**
+ * @brief Tests writing a document one member at a time in both syntaxes.
+ *
+ * @return The result of the test.
+ */
+TEST test_spec_writer_incremental(void) {
+  JSON_Value *one = json_value_init_number(1);
+  JSON_Value *list = json_parse_string("[\"a\"]");
+  int pass;
+
+  for (pass = 0; pass < 2; ++pass) {
+    enum SpecFormat fmt = pass ? SPEC_FORMAT_YAML : SPEC_FORMAT_JSON;
+    struct SpecWriter w;
+    FILE *tmp = spec_writer_test_open();
+    char *got;
+
+    ASSERT(tmp != NULL);
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_init(&w, tmp, fmt));
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_begin_object(&w));
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_key(&w, "a"));
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_value(&w, one));
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_key(&w, "b"));
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_begin_object(&w));
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_key(&w, "c"));
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_value(&w, list));
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_end_object(&w));
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_key(&w, "d"));
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_begin_object(&w));
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_end_object(&w));
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_end_object(&w));
+    ASSERT_EQ(CDD_C_SUCCESS, spec_writer_finish(&w));
+
+    got = spec_writer_test_slurp(tmp);
+    ASSERT(got != NULL);
+    if (fmt == SPEC_FORMAT_JSON)
+      ASSERT_STR_EQ("{\n    \"a\": 1,\n    \"b\": {\n        \"c\": [\n"
+                    "            \"a\"\n        ]\n    },\n    \"d\": {}\n}",
+                    got);
+    else
+      ASSERT_STR_EQ("a: 1\nb:\n  c:\n    - a\nd: {}\n", got);
+    free(got);
+  }
+
+  json_value_free(one);
+  json_value_free(list);
+  PASS();
+}
+
+/**
+ * @brief Tests that out-of-order calls are rejected.
+ *
+ * @return The result of the test.
+ */
+TEST test_spec_writer_misuse(void) {
+  struct SpecWriter w;
+  FILE *tmp = spec_writer_test_open();
+  char *got;
+
+  ASSERT(tmp != NULL);
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            spec_writer_init(NULL, tmp, SPEC_FORMAT_JSON));
+  ASSERT_EQ(CDD_C_SUCCESS, spec_writer_init(&w, tmp, SPEC_FORMAT_AUTO));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, spec_writer_key(&w, "k"));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, spec_writer_end_object(&w));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, spec_writer_finish(&w));
+  ASSERT_EQ(CDD_C_SUCCESS, spec_writer_begin_object(&w));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, spec_writer_begin_object(&w));
+  ASSERT_EQ(CDD_C_SUCCESS, spec_writer_key(&w, "k"));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, spec_writer_key(&w, "j"));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, spec_writer_end_object(&w));
+  ASSERT_EQ(CDD_C_SUCCESS, spec_writer_value(&w, NULL));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, spec_writer_finish(&w));
+  ASSERT_EQ(CDD_C_SUCCESS, spec_writer_end_object(&w));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, spec_writer_begin_object(&w));
+  ASSERT_EQ(CDD_C_SUCCESS, spec_writer_finish(&w));
+
+  got = spec_writer_test_slurp(tmp);
+  ASSERT(got != NULL);
+  ASSERT_STR_EQ("{\n    \"k\": null\n}", got);
+  free(got);
+  PASS();
+}
+
+SUITE(spec_writer_suite) {
+  RUN_TEST(test_spec_writer_json_matches_parson);
+  RUN_TEST(test_spec_writer_yaml_round_trip);
+  RUN_TEST(test_spec_writer_incremental);
+  RUN_TEST(test_spec_writer_misuse);
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TEST_SPEC_WRITER_H */
@@ -50,8 +50,8 @@ TEST test_standalone_json_gen(void) {
       struct StructField f4 = {0};
       struct StructField f5 = {0};
 
-      strcpy(f1.name, "my_str");
-      strcpy(f1.type, "string");
+      f1.name = "my_str";
+      f1.type = "string";
       f1.required = 1;
       f1.has_min_len = 1;
       f1.min_len = 1;
@@ -59,31 +59,31 @@ TEST test_standalone_json_gen(void) {
       f1.max_len = 10;
       sf.fields[sf.size++] = f1;
 
-      strcpy(f2.name, "my_int");
-      strcpy(f2.type, "integer");
+      f2.name = "my_int";
+      f2.type = "integer";
       f2.required = 1;
       sf.fields[sf.size++] = f2;
 
-      strcpy(f3.name, "my_bool");
-      strcpy(f3.type, "boolean");
+      f3.name = "my_bool";
+      f3.type = "boolean";
       f3.required = 1;
       sf.fields[sf.size++] = f3;
 
       {
         struct StructField f_opt_bool = {0};
-        strcpy(f_opt_bool.name, "opt_bool");
-        strcpy(f_opt_bool.type, "boolean");
+        f_opt_bool.name = "opt_bool";
+        f_opt_bool.type = "boolean";
         f_opt_bool.required = 0;
         sf.fields[sf.size++] = f_opt_bool;
       }
 
-      strcpy(f4.name, "my_num");
-      strcpy(f4.type, "number");
+      f4.name = "my_num";
+      f4.type = "number";
       f4.required = 1;
       sf.fields[sf.size++] = f4;
 
-      strcpy(f5.name, "my_arr");
-      strcpy(f5.type, "array");
+      f5.name = "my_arr";
+      f5.type = "array";
       sf.fields[sf.size++] = f5;
     }
 
@@ -7,6 +7,7 @@ extern "C" {
 
 /* clang-format off */
 #include "c_cdd_export.h"
+#include "c_cdd/memory.h"
 #include <greatest.h>
 #include <stdlib.h>
 #include <string.h>
@@ -350,6 +351,58 @@ TEST test_ffi_ir_c_toposort_oom(void) {
   PASS();
 }
 
+TEST test_ffi_ir_infer_buffers(void) {
+  cdd_ffi_ir_t ir = {0};
+  cdd_ffi_ir_node_t *n;
+
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, cdd_ffi_ir_infer_buffers(NULL));
+  ASSERT_EQ(1, cdd_ffi_is_length_name("n"));
+  ASSERT_EQ(1, cdd_ffi_is_length_name("num_items"));
+  ASSERT_EQ(1, cdd_ffi_is_length_name("buf_size"));
+  ASSERT_EQ(0, cdd_ffi_is_length_name("flags"));
+  ASSERT_EQ(0, cdd_ffi_is_length_name(NULL));
+
+  ir.nodes_count = 1;
+  ir.nodes = (cdd_ffi_ir_node_t *)calloc(1, sizeof(cdd_ffi_ir_node_t));
+  n = &ir.nodes[0];
+  n->kind = CDD_FFI_NODE_FUNCTION;
+  n->name = strdup("scale");
+  n->fields_count = 5;
+  n->fields = (cdd_ffi_field_t *)calloc(5, sizeof(cdd_ffi_field_t));
+  /* (const double *xs, size_t len, double k, char **argv, int count) */
+  n->fields[0].name = strdup("xs");
+  n->fields[0].type.kind = CDD_FFI_KIND_FLOAT64;
+  n->fields[0].type.pointer_depth = 1;
+  n->fields[1].name = strdup("len");
+  n->fields[1].type.kind = CDD_FFI_KIND_UINT64;
+  n->fields[2].name = strdup("k");
+  n->fields[2].type.kind = CDD_FFI_KIND_FLOAT64;
+  n->fields[3].name = strdup("argv");
+  n->fields[3].type.kind = CDD_FFI_KIND_INT8;
+  n->fields[3].type.pointer_depth = 2;
+  n->fields[4].name = strdup("count");
+  n->fields[4].type.kind = CDD_FFI_KIND_INT32;
+
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_ffi_ir_infer_buffers(&ir));
+  ASSERT_STR_EQ("len", n->fields[0].array_length_ref);
+  ASSERT_EQ(NULL, n->fields[3].array_length_ref);
+  ASSERT_EQ(1, cdd_ffi_buffer_length_index(n, 0));
+  ASSERT_EQ(-1, cdd_ffi_buffer_length_index(n, 2));
+  ASSERT_EQ(-1, cdd_ffi_buffer_length_index(n, 3));
+  ASSERT_EQ(1, cdd_ffi_is_buffer_length(n, 1));
+  ASSERT_EQ(0, cdd_ffi_is_buffer_length(n, 4));
+
+  free(n->fields[0].array_length_ref);
+  n->fields[0].array_length_ref = NULL;
+  g_cdd_alloc_fail = 1;
+  ASSERT_EQ(CDD_C_ERROR_MEMORY, cdd_ffi_ir_infer_buffers(&ir));
+  g_cdd_alloc_fail = 0;
+  ASSERT_EQ(NULL, n->fields[0].array_length_ref);
+
+  cdd_ffi_ir_free(&ir);
+  PASS();
+}
+
 SUITE(cdd_ffi_ir_suite) {
   RUN_TEST(test_ffi_ir_toposort_null);
   RUN_TEST(test_ffi_ir_toposort_empty);
@@ -360,6 +413,7 @@ SUITE(cdd_ffi_ir_suite) {
   RUN_TEST(test_ffi_ir_toposort_complex);
   RUN_TEST(test_ffi_ir_c_toposort_oom);
   RUN_TEST(test_ffi_ir_c_toposort_dfs_errors);
+  RUN_TEST(test_ffi_ir_infer_buffers);
 }
 
 #ifdef __cplusplus
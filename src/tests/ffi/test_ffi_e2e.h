@@ -5,7 +5,10 @@
 #include "../cdd_test_helpers/cdd_helpers.h"
 #include "../../cdd_api.h"
 #include "../../functions/ffi/cdd_ffi_ir_extractor.h"
+#include "../../functions/parse/fs.h"
 #include "../../include/ffi/cdd_ffi_ir.h"
+#include <stdlib.h>
+#include <string.h>
 /* clang-format on */
 
 #ifdef __cplusplus
@@ -47,7 +50,11 @@ TEST test_ffi_e2e_complex_codebase(void) {
       "*ctx, struct complex_config_t *cfg);\n"
       "complex_status_t complex_do_work(struct "
       "complex_context_t *ctx, const char *payload);\n"
-      "cdd_c_error_t complex_cleanup(struct complex_context_t *ctx);\n";
+      "cdd_c_error_t complex_cleanup(struct complex_context_t *ctx);\n"
+      "\n"
+      "/** Waits on the transport. @ffi_release_gil */\n"
+      "int complex_wait(int fd, int timeout_ms) { return 0; }\n"
+      "int complex_checksum(const void *data, size_t len) { return 0; }\n";
 
   cdd_generate_bindings_config_t config = {0};
   char *output_dir = "test_ffi_e2e_out";
@@ -63,7 +70,7 @@ TEST test_ffi_e2e_complex_codebase(void) {
   config.generate_tests = 1;
 
   /* Run extraction and emission headlessly for multiple core languages */
-  config.target_langs = "python,rust,csharp";
+  config.target_langs = "python,python-capi,rust,csharp";
 
   /* cdd_generate_bindings is the high-level API entry point */
   rc = cdd_generate_bindings(&config);
@@ -85,6 +92,54 @@ TEST test_ffi_e2e_complex_codebase(void) {
     fclose(f);
   }
 
+  /* Assert the CPython extension was generated with vectorcall wrappers */
+  {
+    char *capi = NULL;
+    size_t capi_len = 0;
+    const char *wait_fn, *sum_fn, *wait_end, *sum_end, *p;
+    ASSERT_EQ(0, read_to_file("test_ffi_e2e_out/complex_lib_capi.c", "r",
+                              &capi, &capi_len));
+    ASSERT(strstr(capi, "METH_FASTCALL") != NULL);
+    ASSERT(strstr(capi, "PyInit_complex_lib_capi") != NULL);
+
+    wait_fn = strstr(capi, "static PyObject *cdd_capi_fn_complex_wait(");
+    sum_fn = strstr(capi, "static PyObject *cdd_capi_fn_complex_checksum(");
+    ASSERT(wait_fn != NULL);
+    ASSERT(sum_fn != NULL);
+    wait_end = strstr(wait_fn, "\n}\n");
+    sum_end = strstr(sum_fn, "\n}\n");
+    ASSERT(wait_end != NULL);
+    ASSERT(sum_end != NULL);
+
+    /* Argument count is checked before any argument is converted */
+    p = strstr(wait_fn, "  if (nargs != 2) {");
+    ASSERT(p != NULL && p < wait_end);
+    p = strstr(wait_fn, "\"complex_wait() takes 2 arguments (%zd given)\"");
+    ASSERT(p != NULL && p < wait_end);
+    ASSERT(p < strstr(wait_fn, "args[0]"));
+
+    /* @ffi_release_gil brackets exactly the call with the GIL released */
+    p = strstr(wait_fn, "  Py_BEGIN_ALLOW_THREADS\n  complex_wait(a0, a1);\n"
+                        "  Py_END_ALLOW_THREADS\n");
+    ASSERT(p != NULL && p < wait_end);
+    p = strstr(sum_fn, "Py_BEGIN_ALLOW_THREADS");
+    ASSERT(p == NULL || p > sum_end);
+
+    /* A void * argument goes through the buffer protocol and is released */
+    ASSERT(strstr(capi, "static int cdd_capi_pointer(PyObject *o, int "
+                        "writable, Py_buffer *view,") != NULL);
+    ASSERT(strstr(capi, "PyObject_GetBuffer(o, view, writable ? "
+                        "PyBUF_WRITABLE : PyBUF_SIMPLE)") != NULL);
+    p = strstr(sum_fn, "  Py_buffer v0;\n");
+    ASSERT(p != NULL && p < sum_end);
+    p = strstr(sum_fn, "  if (cdd_capi_pointer(args[0], 0, &v0, &a0) < 0)\n"
+                       "    goto done;\n");
+    ASSERT(p != NULL && p < sum_end);
+    p = strstr(sum_fn, "done:\n  if (v0.obj)\n    PyBuffer_Release(&v0);\n");
+    ASSERT(p != NULL && p < sum_end);
+    free(capi);
+  }
+
   /* Assert Rust bindings generated */
 #if defined(_MSC_VER)
   fopen_s(&f, "test_ffi_e2e_out\\Cargo.toml", "r");
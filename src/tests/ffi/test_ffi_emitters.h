@@ -2,6 +2,8 @@
 #define TEST_FFI_EMITTERS_H
 
 /* clang-format off */
+#include "../cdd_test_helpers/cdd_helpers.h"
+#include "../../functions/parse/fs.h"
 #include "ffi/cdd_ffi_ir.h"
 #include "functions/ffi/cdd_ffi_emit_ada.h"
 #include "functions/ffi/cdd_ffi_emit_clojure.h"
@@ -9,6 +11,7 @@
 #include "functions/ffi/cdd_ffi_emit_cpp.h"
 #include "functions/ffi/cdd_ffi_emit_crystal.h"
 #include "functions/ffi/cdd_ffi_emit_csharp.h"
+#include "functions/ffi/cdd_ffi_emit_csharp_libimport.h"
 #include "functions/ffi/cdd_ffi_emit_d.h"
 #include "functions/ffi/cdd_ffi_emit_dart.h"
 #include "functions/ffi/cdd_ffi_emit_delphi.h"
@@ -20,6 +23,7 @@
 #include "functions/ffi/cdd_ffi_emit_groovy.h"
 #include "functions/ffi/cdd_ffi_emit_haskell.h"
 #include "functions/ffi/cdd_ffi_emit_java.h"
+#include "functions/ffi/cdd_ffi_emit_java_ffm.h"
 #include "functions/ffi/cdd_ffi_emit_julia.h"
 #include "functions/ffi/cdd_ffi_emit_kotlin.h"
 #include "functions/ffi/cdd_ffi_emit_lua.h"
@@ -32,6 +36,7 @@
 #include "functions/ffi/cdd_ffi_emit_perl.h"
 #include "functions/ffi/cdd_ffi_emit_php.h"
 #include "functions/ffi/cdd_ffi_emit_python.h"
+#include "functions/ffi/cdd_ffi_emit_python_capi.h"
 #include "functions/ffi/cdd_ffi_emit_r.h"
 #include "functions/ffi/cdd_ffi_emit_racket.h"
 #include "functions/ffi/cdd_ffi_emit_ruby.h"
@@ -614,6 +619,7 @@ TEST_EMITTER(common_lisp)
 TEST_EMITTER(cpp)
 TEST_EMITTER(crystal)
 TEST_EMITTER(csharp)
+TEST_EMITTER(csharp_libimport)
 TEST_EMITTER(dart)
 TEST_EMITTER(d)
 TEST_EMITTER(delphi)
@@ -625,6 +631,7 @@ TEST_EMITTER(go)
 TEST_EMITTER(groovy)
 TEST_EMITTER(haskell)
 TEST_EMITTER(java)
+TEST_EMITTER(java_ffm)
 TEST_EMITTER(julia)
 TEST_EMITTER(kotlin)
 TEST_EMITTER(lua)
@@ -637,6 +644,7 @@ TEST_EMITTER(odin)
 TEST_EMITTER(perl)
 TEST_EMITTER(php)
 TEST_EMITTER(python)
+TEST_EMITTER(python_capi)
 TEST_EMITTER(racket)
 TEST_EMITTER(r)
 TEST_EMITTER(ruby)
@@ -650,6 +658,101 @@ TEST_EMITTER(vlang)
 TEST_EMITTER(webassembly)
 TEST_EMITTER(zig)
 
+/**
+ * @brief `struct Pair { int32_t id; double weight; }`, a function taking it
+ * by pointer, and one taking a const byte buffer with its length.
+ */
+static void init_interop_ir(cdd_ffi_ir_t *ir, cdd_ffi_ir_node_t *nodes,
+                            cdd_ffi_field_t *pair_fields,
+                            cdd_ffi_field_t *score_params,
+                            cdd_ffi_field_t *sum_params) {
+  memset(ir, 0, sizeof(*ir));
+  memset(nodes, 0, 3 * sizeof(*nodes));
+  memset(pair_fields, 0, 2 * sizeof(*pair_fields));
+  memset(score_params, 0, 2 * sizeof(*score_params));
+  memset(sum_params, 0, 2 * sizeof(*sum_params));
+
+  nodes[0].kind = CDD_FFI_NODE_STRUCT;
+  nodes[0].name = "Pair";
+  nodes[0].fields = pair_fields;
+  nodes[0].fields_count = 2;
+  pair_fields[0].name = "id";
+  pair_fields[0].type.kind = CDD_FFI_KIND_INT32;
+  pair_fields[1].name = "weight";
+  pair_fields[1].type.kind = CDD_FFI_KIND_FLOAT64;
+
+  nodes[1].kind = CDD_FFI_NODE_FUNCTION;
+  nodes[1].name = "pair_score";
+  nodes[1].return_or_base_type.kind = CDD_FFI_KIND_INT32;
+  nodes[1].fields = score_params;
+  nodes[1].fields_count = 2;
+  score_params[0].name = "p";
+  score_params[0].type.kind = CDD_FFI_KIND_STRUCT_REF;
+  score_params[0].type.ref_name = "Pair";
+  score_params[0].type.pointer_depth = 1;
+  score_params[1].name = "bias";
+  score_params[1].type.kind = CDD_FFI_KIND_INT32;
+
+  nodes[2].kind = CDD_FFI_NODE_FUNCTION;
+  nodes[2].name = "checksum";
+  nodes[2].return_or_base_type.kind = CDD_FFI_KIND_UINT32;
+  nodes[2].fields = sum_params;
+  nodes[2].fields_count = 2;
+  sum_params[0].name = "data";
+  sum_params[0].type.kind = CDD_FFI_KIND_UINT8;
+  sum_params[0].type.pointer_depth = 1;
+  sum_params[0].type.is_const = 1;
+  sum_params[1].name = "len";
+  sum_params[1].type.kind = CDD_FFI_KIND_UINT64;
+
+  ir->nodes = nodes;
+  ir->nodes_count = 3;
+  ir->nodes_capacity = 3;
+}
+
+TEST test_ffi_emit_java_ffm_output(void) {
+  cdd_ffi_ir_t ir;
+  cdd_ffi_ir_node_t nodes[3];
+  cdd_ffi_field_t pair_fields[2], score_params[2], sum_params[2];
+  cdd_generate_bindings_config_t config = {0};
+  char *out = NULL;
+  size_t out_len = 0;
+
+  init_interop_ir(&ir, nodes, pair_fields, score_params, sum_params);
+  makedir("build");
+  makedir("build/test_ffm_out");
+  config.output_dir = "build/test_ffm_out";
+  config.library_name = "interop";
+  ASSERT_EQ(0, cdd_ffi_emit_java_ffm(&ir, &config));
+  ASSERT_EQ(0, read_to_file("build/test_ffm_out/InteropFfm.java", "r", &out,
+                            &out_len));
+  /* Downcalls go through the native linker with exact descriptors */
+  ASSERT(strstr(out, "LINKER = Linker.nativeLinker();") != NULL);
+  ASSERT(strstr(out, "return LINKER.downcallHandle(addr, desc);") != NULL);
+  ASSERT(strstr(out, "downcall(\"pair_score\",\n            "
+                     "FunctionDescriptor.of(JAVA_INT, ADDRESS, JAVA_INT));") !=
+         NULL);
+  ASSERT(strstr(out, "FunctionDescriptor.of(JAVA_INT, ADDRESS, JAVA_LONG)") !=
+         NULL);
+  ASSERT(strstr(out, "public static int pair_score(MemorySegment p, "
+                     "int bias) {") != NULL);
+  ASSERT(strstr(out, "return (int) pair_score$.MH.invokeExact(p, bias);") !=
+         NULL);
+  ASSERT(strstr(out, "return (int) checksum$.MH.invokeExact(data, len);") !=
+         NULL);
+  /* Offsets are read from LAYOUT, so they hold on the JVM's own ABI */
+  ASSERT(strstr(out, "public static final long SIZE = LAYOUT.byteSize();") !=
+         NULL);
+  ASSERT(strstr(out, "private static final long weight$OFFSET =\n"
+                     "            LAYOUT.byteOffset(PathElement.groupElement("
+                     "\"weight\"));") != NULL);
+  ASSERT(strstr(out, "SIZE = 16L") == NULL);
+  ASSERT(strstr(out, "layout mismatch") == NULL);
+  ASSERT(strstr(out, "struct.get(JAVA_DOUBLE, weight$OFFSET)") != NULL);
+  free(out);
+  PASS();
+}
+
 #ifdef _WIN32
 #include <direct.h>
 #else
@@ -828,6 +931,59 @@ TEST test_ffi_emit_perl_dir(void) {
   PASS();
 }
 
+TEST test_ffi_emit_csharp_libimport_output(void) {
+  cdd_ffi_ir_t ir;
+  cdd_ffi_ir_node_t nodes[3];
+  cdd_ffi_field_t pair_fields[2], score_params[2], sum_params[2];
+  cdd_generate_bindings_config_t config = {0};
+  char *out = NULL;
+  size_t out_len = 0;
+
+  init_interop_ir(&ir, nodes, pair_fields, score_params, sum_params);
+  makedir("build");
+  makedir("build/test_libimport_out");
+  config.output_dir = "build/test_libimport_out";
+  config.library_name = "interop";
+  ASSERT_EQ(0, cdd_ffi_emit_csharp_libimport(&ir, &config));
+  ASSERT_EQ(0, read_to_file("build/test_libimport_out/Bindings.cs", "r", &out,
+                            &out_len));
+  ASSERT(strstr(out, "[assembly: DisableRuntimeMarshalling]") != NULL);
+  /* Blittable signatures: pointers stay pointers, nothing is marshalled */
+  ASSERT(strstr(out, "[LibraryImport(LibraryName, EntryPoint = "
+                     "\"pair_score\")]") != NULL);
+  ASSERT(strstr(out, "public static partial int pair_score(Pair* p, "
+                     "int bias);") != NULL);
+  ASSERT(strstr(out, "public static partial uint checksum(byte* data, "
+                     "ulong len);") != NULL);
+  /* The pointer+length pair gets a pinned span overload */
+  ASSERT(strstr(out, "public static uint checksum(ReadOnlySpan<byte> data)") !=
+         NULL);
+  ASSERT(strstr(out, "fixed (byte* data__ptr = data)") != NULL);
+  ASSERT(strstr(out, "return checksum((byte*)data__ptr, "
+                     "(ulong)data.Length);") != NULL);
+  /* Members are pinned to their C offsets */
+  ASSERT(strstr(out, "[StructLayout(LayoutKind.Explicit, Size = 16)]\n"
+                     "    public unsafe struct Pair") != NULL);
+  ASSERT(strstr(out, "[FieldOffset(0)]\n        public int id;") != NULL);
+  ASSERT(strstr(out, "[FieldOffset(8)]\n        public double weight;") !=
+         NULL);
+  free(out);
+
+  /* Each output file fails on its own g_fail_io_after value */
+  g_fail_io_after = 1;
+  ASSERT_EQ(CDD_C_ERROR_IO, cdd_ffi_emit_csharp_libimport(&ir, &config));
+  ASSERT_EQ(1, g_fail_io_after);
+  g_fail_io_after = 2;
+  ASSERT_EQ(CDD_C_ERROR_IO, cdd_ffi_emit_csharp_libimport(&ir, &config));
+  g_fail_io_after = 3;
+  ASSERT_EQ(0, cdd_ffi_emit_csharp_libimport(&ir, &config));
+  config.generate_tests = 1;
+  ASSERT_EQ(CDD_C_ERROR_IO, cdd_ffi_emit_csharp_libimport(&ir, &config));
+  ASSERT_EQ(3, g_fail_io_after);
+  g_fail_io_after = -1;
+  PASS();
+}
+
 SUITE(ffi_emitters_suite) {
   RUN_TEST(test_ffi_emit_ada);
   RUN_TEST(test_ffi_emit_clojure);
@@ -835,6 +991,8 @@ SUITE(ffi_emitters_suite) {
   RUN_TEST(test_ffi_emit_cpp);
   RUN_TEST(test_ffi_emit_crystal);
   RUN_TEST(test_ffi_emit_csharp);
+  RUN_TEST(test_ffi_emit_csharp_libimport);
+  RUN_TEST(test_ffi_emit_csharp_libimport_output);
   RUN_TEST(test_ffi_emit_dart);
   RUN_TEST(test_ffi_emit_d);
   RUN_TEST(test_ffi_emit_delphi);
@@ -847,6 +1005,8 @@ SUITE(ffi_emitters_suite) {
   RUN_TEST(test_ffi_emit_haskell);
   RUN_TEST(test_ffi_emit_java);
   RUN_TEST(test_ffi_emit_java_pom_dir);
+  RUN_TEST(test_ffi_emit_java_ffm);
+  RUN_TEST(test_ffi_emit_java_ffm_output);
   RUN_TEST(test_ffi_emit_julia);
   RUN_TEST(test_ffi_emit_kotlin);
   RUN_TEST(test_ffi_emit_lua);
@@ -863,6 +1023,7 @@ SUITE(ffi_emitters_suite) {
   RUN_TEST(test_ffi_emit_perl_dir);
   RUN_TEST(test_ffi_emit_php);
   RUN_TEST(test_ffi_emit_python);
+  RUN_TEST(test_ffi_emit_python_capi);
   RUN_TEST(test_ffi_emit_racket);
   RUN_TEST(test_ffi_emit_r);
   RUN_TEST(test_ffi_emit_ruby);
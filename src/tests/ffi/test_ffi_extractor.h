@@ -647,6 +647,47 @@ TEST test_ffi_ir_extract_array_out(void) {
   PASS();
 }
 
+TEST test_ffi_ir_extract_buffer_pairs(void) {
+  const char *content =
+      "#define _In_reads_(x)\n"
+      "/** @ffi_buffer dst cap */\n"
+      "void copy_items(_In_reads_(count) const float* src, int count, "
+      "char* dst, int cap, int* data, int n) {}\n";
+  cdd_ffi_ir_t *ir = NULL;
+  cdd_generate_bindings_config_t config = {0};
+  cdd_ffi_node_kind_t kind;
+  int rc;
+
+  write_to_file("test_buffers.c", content);
+
+  rc = cdd_ffi_ir_extract_exports("test_buffers.c", content, &config, &ir);
+  ASSERT_EQ(0, rc);
+  ASSERT_EQ(1, ir->nodes_count);
+  kind = ir->nodes[0].kind;
+  ASSERT_EQ(CDD_FFI_NODE_FUNCTION, kind);
+  ASSERT_EQ(6, ir->nodes[0].fields_count);
+
+  /* SAL annotation */
+  ASSERT_STR_EQ("count", ir->nodes[0].fields[0].array_length_ref);
+  ASSERT_EQ(CDD_FFI_KIND_FLOAT32, ir->nodes[0].fields[0].type.kind);
+  ASSERT_EQ(1, ir->nodes[0].fields[0].type.pointer_depth);
+  ASSERT_EQ(1, ir->nodes[0].fields[0].type.is_const);
+  ASSERT_EQ(1, cdd_ffi_buffer_length_index(&ir->nodes[0], 0));
+  /* Doc tag, whose length does not follow a length naming convention */
+  ASSERT_STR_EQ("cap", ir->nodes[0].fields[2].array_length_ref);
+  ASSERT_EQ(CDD_FFI_KIND_INT8, ir->nodes[0].fields[2].type.kind);
+  ASSERT_EQ(3, cdd_ffi_buffer_length_index(&ir->nodes[0], 2));
+  /* Naming convention */
+  ASSERT_STR_EQ("n", ir->nodes[0].fields[4].array_length_ref);
+  ASSERT_EQ(1, cdd_ffi_is_buffer_length(&ir->nodes[0], 5));
+  ASSERT_EQ(0, cdd_ffi_is_buffer_length(&ir->nodes[0], 4));
+
+  cdd_ffi_ir_free(ir);
+  free(ir);
+  remove("test_buffers.c");
+  PASS();
+}
+
 TEST test_ffi_ir_emit_python(void) {
   cdd_ffi_ir_t *ir = (cdd_ffi_ir_t *)calloc(1, sizeof(cdd_ffi_ir_t));
   cdd_ffi_ir_node_t *nodes;
@@ -0,0 +1,262 @@
+#ifndef TEST_FFI_IR_CACHE_H
+#define TEST_FFI_IR_CACHE_H
+
+/* clang-format off */
+#include "../cdd_test_helpers/cdd_helpers.h"
+#include "../../functions/ffi/cdd_ffi_ir_cache.h"
+#include "../../functions/ffi/cdd_ffi_ir_extractor.h"
+#include "../../functions/parse/fs.h"
+#include "../../cdd_api.h"
+#include <greatest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* clang-format on */
+
+static const char *ffi_ir_cache_header =
+    "/** A point */\n"
+    "struct Point { int x; double y; char name[16]; };\n"
+    "enum Color { RED, GREEN = 5, BLUE };\n"
+    "typedef struct Point PointAlias;\n"
+    "#define MAX_POINTS 64\n"
+    "#define GREETING \"hi\"\n"
+    "int sum(const int *data, size_t len);\n"
+    "void log_all(const char *fmt, ...);\n"
+    "struct Point *make_point(int x, double y);\n";
+
+/**
+ * @brief Builds a C++-flavoured node the extractor rarely produces:
+ * template arguments, base classes and virtual methods.
+ */
+static cdd_ffi_ir_node_t *ffi_ir_cache_add_class(cdd_ffi_ir_t *ir) {
+  cdd_ffi_ir_node_t *nodes;
+  cdd_ffi_ir_node_t *node;
+  cdd_ffi_type_t *inner;
+
+  nodes = (cdd_ffi_ir_node_t *)realloc(
+      ir->nodes, (ir->nodes_count + 1) * sizeof(cdd_ffi_ir_node_t));
+  if (!nodes)
+    return NULL;
+  ir->nodes = nodes;
+  ir->nodes_capacity = ir->nodes_count + 1;
+  node = &ir->nodes[ir->nodes_count++];
+  memset(node, 0, sizeof(*node));
+  node->kind = CDD_FFI_NODE_STRUCT;
+  node->name = strdup("Widget");
+
+  node->base_classes =
+      (cdd_ffi_base_class_t *)calloc(1, sizeof(cdd_ffi_base_class_t));
+  node->base_classes_count = 1;
+  node->base_classes[0].name = strdup("Base");
+  node->base_classes[0].is_virtual = 1;
+  node->base_classes[0].access = strdup("public");
+
+  node->virtual_methods =
+      (cdd_ffi_virtual_method_t *)calloc(1, sizeof(cdd_ffi_virtual_method_t));
+  node->virtual_methods_count = 1;
+  node->virtual_methods[0].name = strdup("draw");
+  node->virtual_methods[0].return_type.kind = CDD_FFI_KIND_VOID;
+  node->virtual_methods[0].is_pure_virtual = 1;
+  node->virtual_methods[0].args =
+      (cdd_ffi_field_t *)calloc(1, sizeof(cdd_ffi_field_t));
+  node->virtual_methods[0].args_count = 1;
+  node->virtual_methods[0].args[0].name = strdup("scale");
+  node->virtual_methods[0].args[0].type.kind = CDD_FFI_KIND_FLOAT32;
+  node->virtual_methods[0].args[0].intent = CDD_FFI_INTENT_IN;
+
+  /* std::vector<std::shared_ptr<Base>> members; */
+  node->fields = (cdd_ffi_field_t *)calloc(1, sizeof(cdd_ffi_field_t));
+  node->fields_count = 1;
+  node->fields[0].name = strdup("members");
+  node->fields[0].type.kind = CDD_FFI_KIND_STD_VECTOR;
+  node->fields[0].type.array_size = -1;
+  node->fields[0].type.template_args =
+      (cdd_ffi_type_t *)calloc(1, sizeof(cdd_ffi_type_t));
+  node->fields[0].type.template_args_count = 1;
+  inner = &node->fields[0].type.template_args[0];
+  inner->kind = CDD_FFI_KIND_STD_SHARED_PTR;
+  inner->template_args = (cdd_ffi_type_t *)calloc(1, sizeof(cdd_ffi_type_t));
+  inner->template_args_count = 1;
+  inner->template_args[0].kind = CDD_FFI_KIND_STRUCT_REF;
+  inner->template_args[0].is_const = 1;
+  inner->template_args[0].pointer_depth = 2;
+  inner->template_args[0].ref_name = strdup("Base");
+  return node;
+}
+
+TEST test_ffi_ir_cache_roundtrip(void) {
+  cdd_generate_bindings_config_t config = {0};
+  cdd_ffi_ir_t *ir = NULL;
+  cdd_ffi_ir_t *copy = NULL;
+  char *buf = NULL, *buf2 = NULL;
+  size_t len = 0, len2 = 0, i;
+
+  ASSERT_EQ(0, write_to_file("test_ffi_ir_cache.h", ffi_ir_cache_header));
+  ASSERT_EQ(0, cdd_ffi_ir_extract_exports("test_ffi_ir_cache.h",
+                                          ffi_ir_cache_header, &config, &ir));
+  ASSERT_EQ(0, cdd_ffi_ir_topological_sort(ir));
+  ASSERT_EQ(0, cdd_ffi_ir_infer_buffers(ir));
+  ASSERT(ffi_ir_cache_add_class(ir) != NULL);
+
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cdd_ffi_ir_serialize(NULL, &buf, &len));
+  ASSERT_EQ(0, cdd_ffi_ir_serialize(ir, &buf, &len));
+  ASSERT_EQ(0, cdd_ffi_ir_deserialize(buf, len, &copy));
+  ASSERT_EQ(ir->nodes_count, copy->nodes_count);
+  ASSERT_EQ(1, copy->sources_count);
+  ASSERT_STR_EQ("test_ffi_ir_cache.h", copy->sources[0]);
+  for (i = 0; i < ir->nodes_count; ++i) {
+    ASSERT_EQ(ir->nodes[i].kind, copy->nodes[i].kind);
+    ASSERT_STR_EQ(ir->nodes[i].name, copy->nodes[i].name);
+    ASSERT_EQ(ir->nodes[i].fields_count, copy->nodes[i].fields_count);
+  }
+  {
+    const cdd_ffi_ir_node_t *w = &copy->nodes[copy->nodes_count - 1];
+    ASSERT_STR_EQ("public", w->base_classes[0].access);
+    ASSERT_EQ(1, w->virtual_methods[0].is_pure_virtual);
+    ASSERT_STR_EQ("scale", w->virtual_methods[0].args[0].name);
+    ASSERT_EQ(-1, w->fields[0].type.array_size);
+    ASSERT_EQ(2, w->fields[0].type.template_args[0].template_args[0]
+                     .pointer_depth);
+    ASSERT_STR_EQ("Base",
+                  w->fields[0].type.template_args[0].template_args[0].ref_name);
+  }
+
+  /* The encoding is canonical */
+  ASSERT_EQ(0, cdd_ffi_ir_serialize(copy, &buf2, &len2));
+  ASSERT_EQ(len, len2);
+  ASSERT_EQ(0, memcmp(buf, buf2, len));
+
+  free(buf);
+  free(buf2);
+  cdd_ffi_ir_free(copy);
+  free(copy);
+  cdd_ffi_ir_free(ir);
+  free(ir);
+  remove("test_ffi_ir_cache.h");
+  PASS();
+}
+
+TEST test_ffi_ir_cache_corrupt(void) {
+  cdd_ffi_ir_t ir = {0};
+  cdd_ffi_ir_t *copy = NULL;
+  char *buf = NULL;
+  char *bad;
+  size_t len = 0, i;
+
+  ASSERT(ffi_ir_cache_add_class(&ir) != NULL);
+  ASSERT_EQ(0, cdd_ffi_ir_serialize(&ir, &buf, &len));
+
+  /* Every truncation is rejected without reading past the end */
+  for (i = 0; i < len; ++i) {
+    bad = (char *)malloc(i ? i : 1);
+    ASSERT(bad != NULL);
+    memcpy(bad, buf, i);
+    ASSERT_NEQ(0, cdd_ffi_ir_deserialize(bad, i, &copy));
+    ASSERT(copy == NULL);
+    free(bad);
+  }
+
+  bad = (char *)malloc(len + 1);
+  ASSERT(bad != NULL);
+  memcpy(bad, buf, len);
+  bad[len] = 0;
+  ASSERT_NEQ(0, cdd_ffi_ir_deserialize(bad, len + 1, &copy));
+  bad[0] = 'X';
+  ASSERT_NEQ(0, cdd_ffi_ir_deserialize(bad, len, &copy));
+  ASSERT(copy == NULL);
+  free(bad);
+
+  free(buf);
+  cdd_ffi_ir_free(&ir);
+  PASS();
+}
+
+TEST test_ffi_ir_cache_load_store(void) {
+  const char *main_src = "#include \"test_ffi_ir_cache_inc.h\"\n"
+                         "struct Outer { struct Inner in; };\n";
+  cdd_generate_bindings_config_t config = {0};
+  cdd_ffi_ir_t *ir = NULL;
+  cdd_ffi_ir_t *cached = NULL;
+  int hit = 1;
+
+  ASSERT_EQ(0, write_to_file("test_ffi_ir_cache_main.h", main_src));
+  ASSERT_EQ(0, write_to_file("test_ffi_ir_cache_inc.h",
+                             "struct Inner { int v; };\n"));
+  config.input = "test_ffi_ir_cache_main.h";
+  config.cache_dir = "test_ffi_ir_cache_dir";
+  config.recursive_includes = 1;
+
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cdd_ffi_ir_cache_load(&config, NULL, 0, &cached, &hit));
+
+  ASSERT_EQ(0,
+            cdd_ffi_ir_extract_exports(config.input, main_src, &config, &ir));
+  ASSERT_EQ(2, ir->sources_count);
+  ASSERT_EQ(0, cdd_ffi_ir_cache_store(&config, main_src, strlen(main_src), ir));
+  ASSERT_EQ(0, cdd_ffi_ir_cache_load(&config, main_src, strlen(main_src),
+                                     &cached, &hit));
+  ASSERT_EQ(1, hit);
+  ASSERT_EQ(ir->nodes_count, cached->nodes_count);
+  cdd_ffi_ir_free(cached);
+  free(cached);
+
+  /* Other extraction flags are other entries */
+  config.skip_static = 1;
+  ASSERT_EQ(0, cdd_ffi_ir_cache_load(&config, main_src, strlen(main_src),
+                                     &cached, &hit));
+  ASSERT_EQ(0, hit);
+  config.skip_static = 0;
+
+  /* Editing an included header invalidates the entry */
+  ASSERT_EQ(0, write_to_file("test_ffi_ir_cache_inc.h",
+                             "struct Inner { int v; long w; };\n"));
+  ASSERT_EQ(0, cdd_ffi_ir_cache_load(&config, main_src, strlen(main_src),
+                                     &cached, &hit));
+  ASSERT_EQ(0, hit);
+  ASSERT(cached == NULL);
+
+  cdd_ffi_ir_free(ir);
+  free(ir);
+  remove("test_ffi_ir_cache_main.h");
+  remove("test_ffi_ir_cache_inc.h");
+  PASS();
+}
+
+TEST test_ffi_ir_cache_generate_bindings(void) {
+  cdd_generate_bindings_config_t config = {0};
+  char *first = NULL, *second = NULL;
+  size_t first_len = 0, second_len = 0;
+
+  ASSERT_EQ(0, write_to_file("test_ffi_ir_cache_gen.h", ffi_ir_cache_header));
+  makedir("test_ffi_ir_cache_out");
+  config.input = "test_ffi_ir_cache_gen.h";
+  config.output_dir = "test_ffi_ir_cache_out";
+  config.target_langs = "python";
+  config.cache_dir = "test_ffi_ir_cache_dir";
+
+  /* The first run fills the cache, the second is served from it */
+  ASSERT_EQ(0, cdd_generate_bindings(&config));
+  ASSERT_EQ(0, read_to_file("test_ffi_ir_cache_out/cdd_bindings.py", "r",
+                            &first, &first_len));
+  config.stats = 1;
+  ASSERT_EQ(0, cdd_generate_bindings(&config));
+  ASSERT_EQ(0, read_to_file("test_ffi_ir_cache_out/cdd_bindings.py", "r",
+                            &second, &second_len));
+  ASSERT_EQ(first_len, second_len);
+  ASSERT_STR_EQ(first, second);
+
+  free(first);
+  free(second);
+  remove("test_ffi_ir_cache_gen.h");
+  PASS();
+}
+
+SUITE(ffi_ir_cache_suite) {
+  RUN_TEST(test_ffi_ir_cache_roundtrip);
+  RUN_TEST(test_ffi_ir_cache_corrupt);
+  RUN_TEST(test_ffi_ir_cache_load_store);
+  RUN_TEST(test_ffi_ir_cache_generate_bindings);
+}
+
+#endif /* TEST_FFI_IR_CACHE_H */
@@ -0,0 +1,388 @@
+#ifndef TEST_FFI_LAYOUT_H
+#define TEST_FFI_LAYOUT_H
+
+/* clang-format off */
+#include "../cdd_test_helpers/cdd_helpers.h"
+#include "../../functions/ffi/cdd_ffi_layout.h"
+#include "../../functions/ffi/cdd_ffi_ir_extractor.h"
+#include "../../functions/ffi/cdd_ffi_emit_java_ffm.h"
+#include "../../functions/ffi/cdd_ffi_emit_python.h"
+#include "../../functions/ffi/cdd_ffi_emit_python_capi.h"
+#include "../../functions/parse/fs.h"
+#include "../../cdd_api.h"
+#include <greatest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/* clang-format on */
+
+/** @brief Extracts `src`, written to `path`, with default options. */
+static cdd_ffi_ir_t *ffi_layout_extract(const char *path, const char *src) {
+  cdd_generate_bindings_config_t config = {0};
+  cdd_ffi_ir_t *ir = NULL;
+  if (write_to_file(path, src) != 0 ||
+      cdd_ffi_ir_extract_exports(path, src, &config, &ir) != 0)
+    return NULL;
+  remove(path);
+  return ir;
+}
+
+/** @brief Appends a node with `n` zeroed members. */
+static cdd_ffi_ir_node_t *ffi_layout_add_node(cdd_ffi_ir_t *ir,
+                                              cdd_ffi_node_kind_t kind,
+                                              const char *name, size_t n) {
+  cdd_ffi_ir_node_t *nodes = (cdd_ffi_ir_node_t *)realloc(
+      ir->nodes, (ir->nodes_count + 1) * sizeof(cdd_ffi_ir_node_t));
+  cdd_ffi_ir_node_t *node;
+  if (!nodes)
+    return NULL;
+  ir->nodes = nodes;
+  ir->nodes_capacity = ir->nodes_count + 1;
+  node = &ir->nodes[ir->nodes_count++];
+  memset(node, 0, sizeof(*node));
+  node->kind = kind;
+  node->name = strdup(name);
+  node->fields = (cdd_ffi_field_t *)calloc(n, sizeof(cdd_ffi_field_t));
+  node->fields_count = n;
+  return node;
+}
+
+static const cdd_ffi_ir_node_t *ffi_layout_node(const cdd_ffi_ir_t *ir,
+                                                const char *name) {
+  size_t i;
+  for (i = 0; i < ir->nodes_count; i++) {
+    if (ir->nodes[i].name && strcmp(ir->nodes[i].name, name) == 0)
+      return &ir->nodes[i];
+  }
+  return NULL;
+}
+
+TEST test_ffi_layout_struct(void) {
+  cdd_ffi_ir_t *ir = ffi_layout_extract(
+      "test_ffi_layout_struct.h",
+      "struct Basic { char c; double d; short s; int *p; long l; };\n");
+  cdd_ffi_layout_cache_t cache;
+  const cdd_ffi_record_layout_t *lp64, *llp64, *ilp32, *again;
+  const cdd_ffi_ir_node_t *node;
+  int portable = 1;
+
+  ASSERT(ir != NULL);
+  node = ffi_layout_node(ir, "Basic");
+  ASSERT(node != NULL);
+  ASSERT_EQ(0, cdd_ffi_layout_cache_init(&cache, ir));
+
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, node, CDD_CST_ABI_LP64, &lp64));
+  ASSERT_EQ(40, lp64->size);
+  ASSERT_EQ(8, lp64->alignment);
+  ASSERT_EQ(5, lp64->fields_count);
+  ASSERT_EQ(0, lp64->fields[0].offset);
+  ASSERT_EQ(8, lp64->fields[1].offset);
+  ASSERT_EQ(16, lp64->fields[2].offset);
+  ASSERT_EQ(24, lp64->fields[3].offset);
+  ASSERT_EQ(32, lp64->fields[4].offset);
+  ASSERT_EQ(8, lp64->fields[4].size);
+
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, node, CDD_CST_ABI_LLP64, &llp64));
+  ASSERT_EQ(40, llp64->size);
+  ASSERT_EQ(4, llp64->fields[4].size);
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, node, CDD_CST_ABI_ILP32, &ilp32));
+  ASSERT_EQ(20, ilp32->fields[3].offset);
+  ASSERT_EQ(32, ilp32->size);
+
+  /* Computed once, then served from the cache */
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, node, CDD_CST_ABI_LP64, &again));
+  ASSERT_EQ(lp64, again);
+  ASSERT_EQ(0, cdd_ffi_layout_is_portable(&cache, node, &portable));
+  ASSERT_EQ(0, portable);
+
+  cdd_ffi_layout_cache_free(&cache);
+  cdd_ffi_ir_free(ir);
+  free(ir);
+  PASS();
+}
+
+TEST test_ffi_layout_nested(void) {
+  cdd_ffi_ir_t *ir = ffi_layout_extract(
+      "test_ffi_layout_nested.h",
+      "struct Inner { char c; int i; };\n"
+      "struct Outer { char x; struct Inner in; struct Inner t[2]; };\n");
+  cdd_ffi_layout_cache_t cache;
+  const cdd_ffi_record_layout_t *rec;
+  const cdd_ffi_ir_node_t *found;
+  cdd_cst_type_info_t info;
+  cdd_ffi_type_t type;
+  int portable = 0;
+
+  ASSERT(ir != NULL);
+  ASSERT_EQ(0, cdd_ffi_layout_cache_init(&cache, ir));
+  ASSERT_EQ(0, cdd_ffi_layout_find(&cache, "struct Outer", &found));
+  ASSERT_EQ(CDD_C_ERROR_NOT_FOUND,
+            cdd_ffi_layout_find(&cache, "Missing", &found));
+  ASSERT_EQ(0, cdd_ffi_layout_find(&cache, "Outer", &found));
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, found, CDD_CST_ABI_LP64, &rec));
+  ASSERT_EQ(4, rec->alignment);
+  ASSERT_EQ(4, rec->fields[1].offset);
+  ASSERT_EQ(8, rec->fields[1].size);
+  ASSERT_EQ(12, rec->fields[2].offset);
+  ASSERT_EQ(16, rec->fields[2].size);
+  ASSERT_EQ(28, rec->size);
+  ASSERT_EQ(0, cdd_ffi_layout_is_portable(&cache, found, &portable));
+  ASSERT_EQ(1, portable);
+
+  memset(&type, 0, sizeof(type));
+  type.kind = CDD_FFI_KIND_STRUCT_REF;
+  type.ref_name = (char *)"struct Inner";
+  type.array_size = 3;
+  ASSERT_EQ(0, cdd_ffi_layout_type(&cache, &type, CDD_CST_ABI_LLP64, &info));
+  ASSERT_EQ(24, info.size);
+  ASSERT_EQ(4, info.alignment);
+
+  cdd_ffi_layout_cache_free(&cache);
+  cdd_ffi_ir_free(ir);
+  free(ir);
+  PASS();
+}
+
+TEST test_ffi_layout_bitfields(void) {
+  cdd_ffi_ir_t *ir = ffi_layout_extract(
+      "test_ffi_layout_bits.h",
+      "struct Flags { unsigned a : 3; unsigned b : 30; short d; };\n"
+      "struct Mixed { char a : 4; int b : 4; };\n");
+  cdd_ffi_layout_cache_t cache;
+  const cdd_ffi_record_layout_t *sysv, *msvc;
+  const cdd_ffi_ir_node_t *flags, *mixed;
+
+  ASSERT(ir != NULL);
+  flags = ffi_layout_node(ir, "Flags");
+  mixed = ffi_layout_node(ir, "Mixed");
+  ASSERT(flags != NULL && mixed != NULL);
+  ASSERT_EQ(3, flags->fields[0].bit_width);
+  ASSERT_EQ(0, cdd_ffi_layout_cache_init(&cache, ir));
+
+  /* `b` does not fit the rest of the first unit under either rule */
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, flags, CDD_CST_ABI_LP64, &sysv));
+  ASSERT_EQ(0, sysv->fields[0].offset);
+  ASSERT_EQ(3, sysv->fields[0].bit_width);
+  ASSERT_EQ(4, sysv->fields[1].offset);
+  ASSERT_EQ(0, sysv->fields[1].bit_offset);
+  ASSERT_EQ(8, sysv->fields[2].offset);
+  ASSERT_EQ(12, sysv->size);
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, flags, CDD_CST_ABI_LLP64, &msvc));
+  ASSERT_EQ(1, cdd_ffi_layout_equal(sysv, msvc));
+
+  /* System V shares one unit across types; MSVC opens one per type */
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, mixed, CDD_CST_ABI_LP64, &sysv));
+  ASSERT_EQ(0, sysv->fields[1].offset);
+  ASSERT_EQ(4, sysv->fields[1].bit_offset);
+  ASSERT_EQ(4, sysv->size);
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, mixed, CDD_CST_ABI_LLP64, &msvc));
+  ASSERT_EQ(4, msvc->fields[1].offset);
+  ASSERT_EQ(0, msvc->fields[1].bit_offset);
+  ASSERT_EQ(8, msvc->size);
+
+  cdd_ffi_layout_cache_free(&cache);
+  cdd_ffi_ir_free(ir);
+  free(ir);
+  PASS();
+}
+
+TEST test_ffi_layout_flexible_array(void) {
+  cdd_ffi_ir_t *ir = ffi_layout_extract(
+      "test_ffi_layout_fam.h",
+      "struct Buf { int len; double data[]; };\n");
+  cdd_ffi_layout_cache_t cache;
+  const cdd_ffi_record_layout_t *rec;
+  const cdd_ffi_ir_node_t *node;
+
+  ASSERT(ir != NULL);
+  node = ffi_layout_node(ir, "Buf");
+  ASSERT(node != NULL);
+  ASSERT_EQ(-1, node->fields[1].type.array_size);
+  ASSERT_EQ(0, cdd_ffi_layout_cache_init(&cache, ir));
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, node, CDD_CST_ABI_LP64, &rec));
+  ASSERT_EQ(1, rec->has_flexible_array);
+  ASSERT_EQ(8, rec->fields[1].offset);
+  ASSERT_EQ(0, rec->fields[1].size);
+  ASSERT_EQ(8, rec->size);
+
+  cdd_ffi_layout_cache_free(&cache);
+  cdd_ffi_ir_free(ir);
+  free(ir);
+  PASS();
+}
+
+TEST test_ffi_layout_union_and_cycles(void) {
+  cdd_ffi_ir_t ir = {0};
+  cdd_ffi_layout_cache_t cache;
+  const cdd_ffi_record_layout_t *rec;
+  cdd_ffi_ir_node_t *u, *a, *b, *td;
+  cdd_cst_type_info_t info;
+  cdd_ffi_type_t type;
+  int portable = 1;
+
+  u = ffi_layout_add_node(&ir, CDD_FFI_NODE_UNION, "U", 3);
+  ASSERT(u != NULL);
+  u->fields[0].name = strdup("c");
+  u->fields[0].type.kind = CDD_FFI_KIND_INT8;
+  u->fields[1].name = strdup("d");
+  u->fields[1].type.kind = CDD_FFI_KIND_FLOAT64;
+  u->fields[2].name = strdup("i");
+  u->fields[2].type.kind = CDD_FFI_KIND_INT32;
+  u->fields[2].type.array_size = 3;
+
+  /* struct A { struct B b; }; struct B { struct A a; }; */
+  a = ffi_layout_add_node(&ir, CDD_FFI_NODE_STRUCT, "A", 1);
+  ASSERT(a != NULL);
+  a->fields[0].name = strdup("b");
+  a->fields[0].type.kind = CDD_FFI_KIND_STRUCT_REF;
+  a->fields[0].type.ref_name = strdup("B");
+  b = ffi_layout_add_node(&ir, CDD_FFI_NODE_STRUCT, "B", 1);
+  ASSERT(b != NULL);
+  b->fields[0].name = strdup("a");
+  b->fields[0].type.kind = CDD_FFI_KIND_STRUCT_REF;
+  b->fields[0].type.ref_name = strdup("A");
+  /* typedef union U UT; */
+  td = ffi_layout_add_node(&ir, CDD_FFI_NODE_TYPEDEF, "UT", 0);
+  ASSERT(td != NULL);
+  td->return_or_base_type.kind = CDD_FFI_KIND_STRUCT_REF;
+  td->return_or_base_type.ref_name = strdup("U");
+  u = &ir.nodes[0];
+  a = &ir.nodes[1];
+  b = &ir.nodes[2];
+
+  ASSERT_EQ(0, cdd_ffi_layout_cache_init(&cache, &ir));
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, u, CDD_CST_ABI_LP64, &rec));
+  ASSERT_EQ(16, rec->size);
+  ASSERT_EQ(8, rec->alignment);
+  ASSERT_EQ(0, rec->fields[2].offset);
+  ASSERT_EQ(12, rec->fields[2].size);
+  ASSERT_EQ(0, cdd_ffi_layout_is_portable(&cache, u, &portable));
+  ASSERT_EQ(1, portable);
+
+  memset(&type, 0, sizeof(type));
+  type.kind = CDD_FFI_KIND_TYPEDEF_REF;
+  type.ref_name = (char *)"UT";
+  type.array_size = 2;
+  ASSERT_EQ(0, cdd_ffi_layout_type(&cache, &type, CDD_CST_ABI_ILP32, &info));
+  ASSERT_EQ(32, info.size);
+  type.ref_name = (char *)"size_t";
+  type.kind = CDD_FFI_KIND_STRUCT_REF;
+  type.array_size = 0;
+  ASSERT_EQ(0, cdd_ffi_layout_type(&cache, &type, CDD_CST_ABI_ILP32, &info));
+  ASSERT_EQ(4, info.size);
+
+  ASSERT_EQ(CDD_C_ERROR_NOT_FOUND,
+            cdd_ffi_layout_record(&cache, a, CDD_CST_ABI_LP64, &rec));
+  ASSERT_EQ(CDD_C_ERROR_NOT_FOUND,
+            cdd_ffi_layout_record(&cache, b, CDD_CST_ABI_LP64, &rec));
+  ASSERT_EQ(0, cdd_ffi_layout_is_portable(&cache, a, &portable));
+  ASSERT_EQ(0, portable);
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cdd_ffi_layout_record(&cache, NULL, CDD_CST_ABI_LP64, &rec));
+
+  cdd_ffi_layout_cache_free(&cache);
+  cdd_ffi_ir_free(&ir);
+  PASS();
+}
+
+TEST test_ffi_layout_emitters(void) {
+  cdd_ffi_ir_t *ir = ffi_layout_extract(
+      "test_ffi_layout_emit.h",
+      "struct Point { int x; double y; char name[4]; };\n");
+  cdd_generate_bindings_config_t config = {0};
+  char *out = NULL;
+  size_t out_len = 0;
+
+  ASSERT(ir != NULL);
+  makedir("test_ffi_layout_out");
+  config.input = "test_ffi_layout_emit.h";
+  config.output_dir = "test_ffi_layout_out";
+  config.library_name = "pts";
+
+  ASSERT_EQ(0, cdd_ffi_emit_python_capi(ir, &config));
+  ASSERT_EQ(0, read_to_file("test_ffi_layout_out/pts_capi.c", "r", &out,
+                            &out_len));
+  ASSERT(strstr(out, "typedef char cdd_capi_layout_Point[(sizeof("
+                     "CDD_CAPI_TYPE_Point) == 24") != NULL);
+  ASSERT(strstr(out, "offsetof(CDD_CAPI_TYPE_Point, y) == 8") != NULL);
+  ASSERT(strstr(out, "offsetof(CDD_CAPI_TYPE_Point, name) == 16") != NULL);
+  free(out);
+
+  ASSERT_EQ(0, cdd_ffi_emit_java_ffm(ir, &config));
+  ASSERT_EQ(0, read_to_file("test_ffi_layout_out/PtsFfm.java", "r", &out,
+                            &out_len));
+  ASSERT(strstr(out, "public static final long SIZE = LAYOUT.byteSize();") !=
+         NULL);
+  ASSERT(strstr(out, "y$OFFSET =\n"
+                     "            LAYOUT.byteOffset(PathElement.groupElement("
+                     "\"y\"));") != NULL);
+  ASSERT(strstr(out, "struct.get(JAVA_DOUBLE, y$OFFSET)") != NULL);
+  ASSERT(strstr(out, "struct.asSlice(name$OFFSET, name$SIZE)") != NULL);
+  free(out);
+
+  cdd_ffi_ir_free(ir);
+  free(ir);
+  PASS();
+}
+
+TEST test_ffi_layout_abi_scalar_members(void) {
+  cdd_ffi_ir_t *ir = ffi_layout_extract(
+      "test_ffi_layout_abi.h",
+      "struct Flags { unsigned long flags; size_t len; int id; };\n");
+  cdd_generate_bindings_config_t config = {0};
+  cdd_ffi_layout_cache_t cache;
+  const cdd_ffi_record_layout_t *rec;
+  const cdd_ffi_ir_node_t *node;
+  char *out = NULL;
+  size_t out_len = 0;
+
+  ASSERT(ir != NULL);
+  node = ffi_layout_node(ir, "Flags");
+  ASSERT(node != NULL);
+  ASSERT_EQ(3, node->fields_count);
+  /* Emitters keep the schema type; only the layout sees the C name */
+  ASSERT(node->fields[0].type.kind != CDD_FFI_KIND_STRUCT_REF);
+  ASSERT_EQ(NULL, node->fields[0].type.ref_name);
+  ASSERT_STR_EQ("unsigned long", node->fields[0].type.c_name);
+  ASSERT_STR_EQ("size_t", node->fields[1].type.c_name);
+  ASSERT_EQ(NULL, node->fields[2].type.c_name);
+
+  ASSERT_EQ(0, cdd_ffi_layout_cache_init(&cache, ir));
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, node, CDD_CST_ABI_LP64, &rec));
+  ASSERT_EQ(24, rec->size);
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, node, CDD_CST_ABI_LLP64, &rec));
+  ASSERT_EQ(4, rec->fields[0].size);
+  ASSERT_EQ(8, rec->fields[1].offset);
+  ASSERT_EQ(0, cdd_ffi_layout_record(&cache, node, CDD_CST_ABI_ILP32, &rec));
+  ASSERT_EQ(12, rec->size);
+  cdd_ffi_layout_cache_free(&cache);
+
+  makedir("test_ffi_layout_out");
+  config.input = "test_ffi_layout_abi.h";
+  config.output_dir = "test_ffi_layout_out";
+  config.library_name = "flags";
+  ASSERT_EQ(0, cdd_ffi_emit_python(ir, &config));
+  ASSERT_EQ(0, read_to_file("test_ffi_layout_out/cdd_bindings.py", "r", &out,
+                            &out_len));
+  ASSERT(strstr(out, "(\"flags\", ctypes.") != NULL);
+  ASSERT(strstr(out, "(\"len\", ctypes.") != NULL);
+  ASSERT(strstr(out, "unsigned long") == NULL);
+  ASSERT(strstr(out, "size_t") == NULL);
+  free(out);
+
+  cdd_ffi_ir_free(ir);
+  free(ir);
+  PASS();
+}
+
+SUITE(ffi_layout_suite) {
+  RUN_TEST(test_ffi_layout_struct);
+  RUN_TEST(test_ffi_layout_nested);
+  RUN_TEST(test_ffi_layout_bitfields);
+  RUN_TEST(test_ffi_layout_flexible_array);
+  RUN_TEST(test_ffi_layout_union_and_cycles);
+  RUN_TEST(test_ffi_layout_emitters);
+  RUN_TEST(test_ffi_layout_abi_scalar_members);
+}
+
+#endif /* TEST_FFI_LAYOUT_H */
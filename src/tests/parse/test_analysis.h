@@ -417,6 +417,68 @@ TEST test_analysis_edge_cases(void) {
   PASS();
 }
 
+/**
+ * @brief test_analysis_paths
+ * @return TEST
+ */
+TEST test_analysis_paths(void) {
+  struct AllocationSiteList sites = {0};
+
+  /* The check only guards one path to the dereference */
+  ASSERT_EQ(0, find_allocs("void f(int x) { char *p = malloc(1);"
+                           " if (x) { if (!p) return; } p[0] = 1; }",
+                           &sites));
+  ASSERT_EQ(1, sites.size);
+  ASSERT_EQ(1, sites.sites[0].used_before_check);
+  ASSERT_EQ(0, sites.sites[0].is_checked);
+  allocation_site_list_free(&sites);
+
+  /* Sites outside any function body still get the token scan */
+  ASSERT_EQ(0, find_allocs("void f(void) { char *p = malloc(1);"
+                           " if (!p) return; p[0] = 1; }\n"
+                           "char *q = malloc(1); q[0] = 1;\n"
+                           "char *r = malloc(1); if (!r) {}",
+                           &sites));
+  ASSERT_EQ(3, sites.size);
+  ASSERT_EQ(1, sites.sites[0].is_checked);
+  ASSERT_EQ(0, sites.sites[0].used_before_check);
+  ASSERT_EQ(0, sites.sites[1].is_checked);
+  ASSERT_EQ(1, sites.sites[1].used_before_check);
+  ASSERT_EQ(1, sites.sites[2].is_checked);
+  allocation_site_list_free(&sites);
+
+  /* Checked on every path */
+  ASSERT_EQ(0, find_allocs("void f(void) { char *p; p = malloc(1);"
+                           " if (!p) return; p[0] = 1; }",
+                           &sites));
+  ASSERT_EQ(1, sites.size);
+  ASSERT_EQ(0, sites.sites[0].used_before_check);
+  ASSERT_EQ(1, sites.sites[0].is_checked);
+  allocation_site_list_free(&sites);
+
+  /* Allocations in both branches, dereferenced after the join */
+  ASSERT_EQ(0, find_allocs("void f(int x) { char *p;"
+                           " if (x) { p = malloc(1); } else p = calloc(1, 1);"
+                           " *p = 0; }",
+                           &sites));
+  ASSERT_EQ(2, sites.size);
+  ASSERT_EQ(1, sites.sites[0].used_before_check);
+  ASSERT_EQ(1, sites.sites[1].used_before_check);
+  allocation_site_list_free(&sites);
+
+  /* A check on the back edge covers the next iteration */
+  ASSERT_EQ(0, find_allocs("void f(int n) { char *p = 0; while (n--) {"
+                           " if (p) p[0] = 1; p = malloc(1);"
+                           " if (!p) return; } }",
+                           &sites));
+  ASSERT_EQ(1, sites.size);
+  ASSERT_EQ(0, sites.sites[0].used_before_check);
+  ASSERT_EQ(1, sites.sites[0].is_checked);
+  allocation_site_list_free(&sites);
+
+  PASS();
+}
+
 SUITE(analysis_suite) {
   RUN_TEST(test_analysis_find_malloc);
   RUN_TEST(test_analysis_find_calloc);
@@ -426,6 +488,7 @@ SUITE(analysis_suite) {
   RUN_TEST(test_analysis_oom);
   RUN_TEST(test_analysis_capacity);
   RUN_TEST(test_analysis_edge_cases);
+  RUN_TEST(test_analysis_paths);
 }
 
 #ifdef __cplusplus
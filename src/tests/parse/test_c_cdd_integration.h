@@ -270,7 +270,7 @@ TEST test_integration_fix_dir_error_no_flag(void) {
   }
 
   {
-    char *argv[3];
+    char *argv[3] = {"a.c", "b.c", "c.c"};
     rc = fix_code_main(3, argv);
     ASSERT_EQ(CDD_C_ERROR_UNKNOWN, rc);
   }
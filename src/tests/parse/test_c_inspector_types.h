@@ -120,6 +120,50 @@ TEST test_scan_classic_enum(void) {
   PASS();
 }
 
+/**
+ * @brief test_scan_string_types_relevant_lines
+ * @return TEST
+ */
+TEST test_scan_string_types_relevant_lines(void) {
+  const char *src = "#include <stdio.h>\n"
+                    "int unrelated(void);\n"
+                    "struct Point {\n"
+                    "  int x;\n"
+                    "  int y;\n"
+                    "};\n"
+                    "static int counter;\n"
+                    "enum Colour { RED, GREEN };\n";
+  struct TypeDefList types;
+  struct TypeDefList again;
+  char *relevant = NULL;
+
+  type_def_list_init(&types);
+  type_def_list_init(&again);
+  ASSERT_EQ(0, c_inspector_scan_string_types(src, &types, &relevant));
+  ASSERT_EQ(2, types.size);
+  ASSERT_STR_EQ("Point", types.items[0].name);
+  ASSERT_EQ(2, types.items[0].details.struct_fields->size);
+  ASSERT_STR_EQ("Colour", types.items[1].name);
+
+  /* Lines outside any definition are dropped; the rest rescans identically */
+  ASSERT(relevant != NULL);
+  ASSERT(strstr(relevant, "unrelated") == NULL);
+  ASSERT(strstr(relevant, "counter") == NULL);
+  ASSERT_EQ(0, c_inspector_scan_string_types(relevant, &again, NULL));
+  ASSERT_EQ(2, again.size);
+  ASSERT_STR_EQ("Point", again.items[0].name);
+  ASSERT_EQ(2, again.items[0].details.struct_fields->size);
+  ASSERT_STR_EQ("Colour", again.items[1].name);
+
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            c_inspector_scan_string_types(NULL, &again, NULL));
+
+  free(relevant);
+  type_def_list_free(&types);
+  type_def_list_free(&again);
+  PASS();
+}
+
 /**
  * @brief c_inspector_types_suite
  */
@@ -790,6 +834,7 @@ SUITE(c_inspector_types_suite) {
   RUN_TEST(test_scan_c23_enum_fixed_type);
   RUN_TEST(test_scan_c23_enum_fixed_type_whitespace);
   RUN_TEST(test_scan_classic_enum);
+  RUN_TEST(test_scan_string_types_relevant_lines);
   RUN_TEST(test_inspector_nulls);
   RUN_TEST(test_inspector_oom);
   RUN_TEST(test_inspector_extract_sig_oom);
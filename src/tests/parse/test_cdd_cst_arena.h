@@ -0,0 +1,108 @@
+/**
+ * @file test_cdd_cst_arena.h
+ * @brief Unit tests for the CST bump allocator.
+ */
+
+#ifndef TEST_CDD_CST_ARENA_H
+#define TEST_CDD_CST_ARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+#include <greatest.h>
+#include <string.h>
+
+#include "c_cdd/memory.h"
+#include "classes/parse/cdd_cst_arena.h"
+#include "classes/parse/cdd_cst_builder.h"
+#include "classes/parse/cdd_cst_factory.h"
+#include "classes/parse/cdd_cst_parser.h"
+/* clang-format on */
+
+/**
+ * @brief Tests alignment, block growth and oversized allocations.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_arena_alloc(void) {
+  cdd_cst_arena_t arena;
+  void *small = NULL, *big = NULL, *after = NULL;
+  const char *str = NULL;
+  size_t i;
+
+  cdd_cst_arena_init(&arena);
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cdd_cst_arena_alloc(NULL, 8, &small));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cdd_cst_arena_strndup(&arena, NULL, 0, &str));
+
+  for (i = 0; i < 1000; i++) {
+    ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_arena_alloc(&arena, i % 13 + 1, &small));
+    ASSERT_EQ(0, (size_t)small % sizeof(void *));
+    memset(small, 0xAB, i % 13 + 1);
+  }
+
+  /* A large request gets its own block; the current one keeps filling */
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_arena_alloc(&arena, 1, &small));
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_arena_alloc(&arena, 100000, &big));
+  memset(big, 0, 100000);
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_arena_alloc(&arena, 1, &after));
+  ASSERT((char *)after > (char *)small &&
+         (char *)after - (char *)small <= 64);
+
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_arena_strndup(&arena, "abcdef", 3, &str));
+  ASSERT_STR_EQ("abc", str);
+
+  g_cdd_alloc_fail = 1;
+  ASSERT_EQ(CDD_C_ERROR_MEMORY, cdd_cst_arena_alloc(&arena, 100000, &big));
+  g_cdd_alloc_fail = 0;
+  ASSERT(big == NULL);
+
+  cdd_cst_arena_free(&arena);
+  ASSERT(arena.head == NULL);
+  cdd_cst_arena_free(&arena);
+  cdd_cst_arena_free(NULL);
+  PASS();
+}
+
+/**
+ * @brief Tests that builder text lives in the tree that owns it.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_arena_tree_strings(void) {
+  cdd_cst_tree_t *a = NULL, *b = NULL;
+  cdd_cst_node_t *node = NULL;
+  cdd_cst_builder_t bld;
+
+  ASSERT_EQ(0, cdd_cst_parse(az_span_create_from_str("int a;"), &a));
+  ASSERT_EQ(0, cdd_cst_parse(az_span_create_from_str("int b;"), &b));
+  ASSERT(a->strings.head == NULL);
+
+  ASSERT_EQ(0, cdd_cst_alloc_node(CDD_CST_UNKNOWN, &node));
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_builder_init(&bld, a, node));
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_bld_block_comment(&bld, "note"));
+  cdd_cst_builder_free(&bld);
+  ASSERT(a->strings.head != NULL);
+  ASSERT(b->strings.head == NULL);
+
+  cdd_cst_free_node(node);
+  cdd_cst_tree_free(b);
+  cdd_cst_tree_free(a);
+  PASS();
+}
+
+SUITE(cdd_cst_arena_suite) {
+  RUN_TEST(test_cdd_cst_arena_alloc);
+  RUN_TEST(test_cdd_cst_arena_tree_strings);
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TEST_CDD_CST_ARENA_H */
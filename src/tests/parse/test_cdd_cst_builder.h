@@ -850,18 +850,16 @@ TEST test_cdd_cst_builder_oom(void) {
   g_cdd_alloc_fail = 0;
   b.error_state = 0;
 
-  g_cdd_alloc_fail = 3;
-  tree->string_capacity = tree->num_strings;
+  g_cdd_cst_alloc_token_fail = 2;
   ASSERT_EQ(CDD_C_ERROR_MEMORY,
-            cdd_cst_bld_block_comment(&b, "test_realloc_fail"));
-  g_cdd_alloc_fail = 0;
+            cdd_cst_bld_block_comment(&b, "test_pool_fail"));
+  g_cdd_cst_alloc_token_fail = 0;
   b.error_state = 0;
 
   {
     /* Test pool_string failure inside cdd_cst_bld_snippet trivia processing */
     int i;
     for (i = 1; i <= 20; ++i) {
-      tree->string_capacity = tree->num_strings;
       g_cdd_alloc_fail = i;
       cdd_cst_bld_snippet(&b, "int /* test pool fail */ x;");
       g_cdd_alloc_fail = 0;
@@ -15,6 +15,7 @@ extern "C" {
 #include "classes/parse/cdd_cst_cfg.h"
 #include "classes/parse/cdd_cst_parser.h"
 #include <greatest.h>
+#include <string.h>
 /* clang-format on */
 
 /* Moved extern declarations for C89 compliance */
@@ -314,6 +315,54 @@ TEST test_cdd_cst_cfg_extra(void) {
   PASS();
 }
 
+/**
+ * @brief Tests the blocks and edges built for loops and unbraced bodies.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_cfg_shapes(void) {
+  cdd_cst_tree_t *tree = NULL;
+  cdd_cst_cfg_t *cfg = NULL;
+  cdd_cst_cfg_block_t *head = NULL, *step = NULL, *cont = NULL;
+  const char *src = "int f(int n) { int s = 0; for (i = 0; i < n; i++) {"
+                    " if (i == 3) continue; s += i; } return s; }";
+  size_t b, begin = 0, end = 0;
+
+  ASSERT_EQ(0, cdd_cst_parse(az_span_create_from_str((char *)src), &tree));
+  ASSERT_EQ(0, cdd_cst_cfg_build(tree->root->children[0].val.node, &cfg));
+
+  for (b = 0; b < cfg->num_blocks; b++) {
+    cdd_cst_cfg_block_t *block = cfg->blocks[b];
+    const cdd_token_t *first;
+    if (block->num_statements != 1)
+      continue;
+    first = block->statements[0]->children[block->spans[0].begin].val.token;
+    if (first->kind == CDD_TOKEN_IDENTIFIER && first->start[0] == 'i' &&
+        block->kind == CDD_CST_CFG_BLOCK_CONDITION)
+      head = block;
+    else if (first->kind == CDD_TOKEN_IDENTIFIER && first->start[0] == 'i')
+      step = block;
+    else if (first->length == 8 && memcmp(first->start, "continue", 8) == 0)
+      cont = block;
+  }
+  /* `for` condition and step each get a block; `continue` goes to the step */
+  ASSERT(head != NULL && step != NULL && cont != NULL);
+  ASSERT_EQ(head, step->successors->target);
+  ASSERT_EQ(step, cont->successors->target);
+  ASSERT_EQ(0, cdd_cst_cfg_condition(head->statements[0], &begin, &end));
+  ASSERT_EQ(head->spans[0].begin, begin);
+  ASSERT_EQ(begin + 3, end);
+  /* The unbraced `continue` shares its node with `if (i == 3)` */
+  ASSERT_EQ(0, cdd_cst_cfg_condition(cont->statements[0], &begin, &end));
+  ASSERT_EQ(2, begin);
+  ASSERT_EQ(5, end);
+  ASSERT_EQ(6, cont->spans[0].begin);
+
+  cdd_cst_cfg_free(cfg);
+  cdd_cst_tree_free(tree);
+  PASS();
+}
+
 /**
  * @brief CFG test suite.
  */
@@ -324,6 +373,7 @@ SUITE(cdd_cst_cfg_suite) {
   RUN_TEST(test_cdd_cst_cfg_basic);
   RUN_TEST(test_cdd_cst_cfg_errors);
   RUN_TEST(test_cdd_cst_cfg_oom);
+  RUN_TEST(test_cdd_cst_cfg_shapes);
 }
 
 #ifdef __cplusplus
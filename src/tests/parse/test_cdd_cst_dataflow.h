@@ -0,0 +1,270 @@
+/**
+ * @file test_cdd_cst_dataflow.h
+ * @brief Unit tests for the bit-vector dataflow solver over CST CFGs.
+ */
+
+#ifndef TEST_CDD_CST_DATAFLOW_H
+#define TEST_CDD_CST_DATAFLOW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include "c_cdd_export.h"
+#include "classes/parse/cdd_cst_dataflow.h"
+#include "classes/parse/cdd_cst_parser.h"
+#include <greatest.h>
+#include <string.h>
+/* clang-format on */
+
+extern int g_cdd_dataflow_alloc_fail;
+
+/* Builds the CFG of the first function of `src`. */
+static cdd_c_error_t df_build(const char *src, cdd_cst_tree_t **tree,
+                              cdd_cst_cfg_t **cfg) {
+  size_t i;
+  cdd_c_error_t rc = cdd_cst_parse(az_span_create_from_str((char *)src), tree);
+  if (rc != CDD_C_SUCCESS)
+    return rc;
+  for (i = 0; i < (*tree)->root->num_children; i++) {
+    cdd_cst_child_t *child = &(*tree)->root->children[i];
+    if (child->kind == CDD_CST_CHILD_NODE &&
+        child->val.node->kind == CDD_CST_FUNCTION_DEFINITION)
+      return cdd_cst_cfg_build(child->val.node, cfg);
+  }
+  return CDD_C_ERROR_NOT_FOUND;
+}
+
+/* Id of the block whose first statement starts with `text`. */
+static size_t df_block(const cdd_cst_cfg_t *cfg, const char *text) {
+  size_t b;
+  for (b = 0; b < cfg->num_blocks; b++) {
+    const cdd_cst_cfg_block_t *block = cfg->blocks[b];
+    const cdd_cst_child_t *child;
+    if (block->num_statements == 0)
+      continue;
+    child = &block->statements[0]->children[block->spans[0].begin];
+    if (child->kind == CDD_CST_CHILD_TOKEN &&
+        child->val.token->length == strlen(text) &&
+        memcmp(child->val.token->start, text, strlen(text)) == 0)
+      return b;
+  }
+  return cfg->num_blocks;
+}
+
+static const char DF_SRC[] =
+    "int f(int n) { int x = 0; if (n) x = 1; return x; }";
+
+/**
+ * @brief Tests reaching definitions across an `if`.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_dataflow_reaching_defs(void) {
+  cdd_cst_tree_t *tree = NULL;
+  cdd_cst_cfg_t *cfg = NULL;
+  cdd_cst_defuse_t du;
+  cdd_cst_dataflow_t rd;
+  size_t x, ret, assign;
+
+  ASSERT_EQ(0, df_build(DF_SRC, &tree, &cfg));
+  ASSERT_EQ(0, cdd_cst_defuse_build(cfg, &du));
+  ASSERT_EQ(2, du.n_vars);
+  ASSERT_EQ(2, du.n_defs);
+  ASSERT_EQ(0, cdd_cst_defuse_find_var(&du, "x", 1, &x));
+  ASSERT_EQ(CDD_C_ERROR_NOT_FOUND, cdd_cst_defuse_find_var(&du, "y", 1, &x));
+  ASSERT_EQ(1, du.defs[0].is_declaration);
+  ASSERT_EQ(0, du.defs[1].is_declaration);
+  ASSERT_EQ(1, du.defs[0].next_of_var);
+
+  ASSERT_EQ(0, cdd_cst_dataflow_reaching_defs(cfg, &du, &rd));
+  assign = df_block(cfg, "x");
+  ret = df_block(cfg, "return");
+  ASSERT(assign < cfg->num_blocks && ret < cfg->num_blocks);
+  /* Only the declaration reaches the assignment; both reach the return */
+  ASSERT_EQ(1, CDD_CST_BITSET_TEST(cdd_cst_dataflow_in(&rd, assign), 0));
+  ASSERT_EQ(0, CDD_CST_BITSET_TEST(cdd_cst_dataflow_in(&rd, assign), 1));
+  ASSERT_EQ(0, CDD_CST_BITSET_TEST(cdd_cst_dataflow_out(&rd, assign), 0));
+  ASSERT_EQ(1, CDD_CST_BITSET_TEST(cdd_cst_dataflow_in(&rd, ret), 0));
+  ASSERT_EQ(1, CDD_CST_BITSET_TEST(cdd_cst_dataflow_in(&rd, ret), 1));
+
+  cdd_cst_dataflow_free(&rd);
+  cdd_cst_defuse_free(&du);
+  cdd_cst_cfg_free(cfg);
+  cdd_cst_tree_free(tree);
+  PASS();
+}
+
+/**
+ * @brief Tests live variables across an `if`.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_dataflow_liveness(void) {
+  cdd_cst_tree_t *tree = NULL;
+  cdd_cst_cfg_t *cfg = NULL;
+  cdd_cst_defuse_t du;
+  cdd_cst_dataflow_t lv;
+  size_t x, n, cond;
+
+  ASSERT_EQ(0, df_build(DF_SRC, &tree, &cfg));
+  ASSERT_EQ(0, cdd_cst_defuse_build(cfg, &du));
+  ASSERT_EQ(0, cdd_cst_defuse_find_var(&du, "x", 1, &x));
+  ASSERT_EQ(0, cdd_cst_defuse_find_var(&du, "n", 1, &n));
+  ASSERT_EQ(0, cdd_cst_dataflow_liveness(cfg, &du, &lv));
+
+  cond = df_block(cfg, "if");
+  ASSERT(cond < cfg->num_blocks);
+  ASSERT_EQ(1, CDD_CST_BITSET_TEST(cdd_cst_dataflow_in(&lv, cond), x));
+  ASSERT_EQ(1, CDD_CST_BITSET_TEST(cdd_cst_dataflow_in(&lv, cond), n));
+  /* x is redefined before any read on the true branch */
+  ASSERT_EQ(0, CDD_CST_BITSET_TEST(cdd_cst_dataflow_in(&lv, df_block(cfg, "x")),
+                                   x));
+  /* Only the parameter is live on entry */
+  ASSERT_EQ(0, CDD_CST_BITSET_TEST(
+                   cdd_cst_dataflow_in(&lv, (size_t)cfg->entry_block->id), x));
+  ASSERT_EQ(1, CDD_CST_BITSET_TEST(
+                   cdd_cst_dataflow_in(&lv, (size_t)cfg->entry_block->id), n));
+
+  cdd_cst_dataflow_free(&lv);
+  cdd_cst_defuse_free(&du);
+  cdd_cst_cfg_free(cfg);
+  cdd_cst_tree_free(tree);
+  PASS();
+}
+
+/**
+ * @brief Tests an intersection problem over a diamond.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_dataflow_must(void) {
+  cdd_cst_tree_t *tree = NULL;
+  cdd_cst_cfg_t *cfg = NULL;
+  cdd_cst_dataflow_t df;
+  size_t then_b, else_b, join;
+
+  ASSERT_EQ(0, df_build("void f(int c) { if (c) a(); else b(); d(); }", &tree,
+                        &cfg));
+  then_b = df_block(cfg, "a");
+  else_b = df_block(cfg, "b");
+  join = df_block(cfg, "d");
+  ASSERT(join < cfg->num_blocks);
+
+  /* A fact generated on one branch does not hold at the join */
+  ASSERT_EQ(0, cdd_cst_dataflow_init(&df, cfg, 70, CDD_CST_DATAFLOW_FORWARD,
+                                     CDD_CST_DATAFLOW_INTERSECTION));
+  ASSERT(df.n_words * CDD_CST_BITSET_WORD_BITS >= 70);
+  cdd_cst_dataflow_apply_gen(&df, then_b, 69);
+  ASSERT_EQ(0, cdd_cst_dataflow_solve(&df));
+  ASSERT_EQ(0, CDD_CST_BITSET_TEST(cdd_cst_dataflow_in(&df, join), 69));
+  cdd_cst_dataflow_free(&df);
+
+  /* ... but does once generated on both */
+  ASSERT_EQ(0, cdd_cst_dataflow_init(&df, cfg, 70, CDD_CST_DATAFLOW_FORWARD,
+                                     CDD_CST_DATAFLOW_INTERSECTION));
+  cdd_cst_dataflow_apply_gen(&df, then_b, 69);
+  cdd_cst_dataflow_apply_gen(&df, else_b, 69);
+  cdd_cst_dataflow_apply_kill(&df, else_b, 3);
+  ASSERT_EQ(0, cdd_cst_dataflow_solve(&df));
+  ASSERT_EQ(1, CDD_CST_BITSET_TEST(cdd_cst_dataflow_in(&df, join), 69));
+  ASSERT_EQ(0, CDD_CST_BITSET_TEST(cdd_cst_dataflow_in(&df, join), 3));
+  ASSERT(df.iterations >= cfg->num_blocks);
+  cdd_cst_dataflow_free(&df);
+
+  cdd_cst_cfg_free(cfg);
+  cdd_cst_tree_free(tree);
+  PASS();
+}
+
+/**
+ * @brief Tests def/use classification of names.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_dataflow_classify(void) {
+  cdd_cst_tree_t *tree = NULL;
+  cdd_cst_cfg_t *cfg = NULL;
+  const cdd_cst_node_t *stmt;
+  unsigned flags = 0;
+
+  ASSERT_EQ(0, df_build("void f(char *p) { *p = 0; }", &tree, &cfg));
+  stmt = cfg->blocks[df_block(cfg, "*")]->statements[0];
+  /* `*p = 0` reads p; the write goes through it */
+  ASSERT_EQ(0, cdd_cst_defuse_classify(stmt, 1, &flags));
+  ASSERT_EQ(CDD_CST_DEFUSE_USE, flags);
+  ASSERT_EQ(CDD_C_ERROR_NOT_FOUND, cdd_cst_defuse_classify(stmt, 0, &flags));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cdd_cst_defuse_classify(NULL, 0, &flags));
+  cdd_cst_cfg_free(cfg);
+  cdd_cst_tree_free(tree);
+
+  ASSERT_EQ(0, df_build("void f(int i) { i += 2; }", &tree, &cfg));
+  stmt = cfg->blocks[df_block(cfg, "i")]->statements[0];
+  ASSERT_EQ(0, cdd_cst_defuse_classify(stmt, 0, &flags));
+  ASSERT_EQ(CDD_CST_DEFUSE_USE | CDD_CST_DEFUSE_DEF, flags);
+  cdd_cst_cfg_free(cfg);
+  cdd_cst_tree_free(tree);
+  PASS();
+}
+
+/**
+ * @brief Tests argument checks and allocation failures.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_dataflow_errors(void) {
+  cdd_cst_tree_t *tree = NULL;
+  cdd_cst_cfg_t *cfg = NULL;
+  cdd_cst_defuse_t du;
+  cdd_cst_dataflow_t df;
+  int i;
+  cdd_c_error_t rc;
+
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cdd_cst_dataflow_init(NULL, NULL, 1, CDD_CST_DATAFLOW_FORWARD,
+                                  CDD_CST_DATAFLOW_UNION));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, cdd_cst_defuse_build(NULL, &du));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, cdd_cst_dataflow_solve(NULL));
+  cdd_cst_dataflow_free(NULL);
+  cdd_cst_defuse_free(NULL);
+
+  ASSERT_EQ(0, df_build(DF_SRC, &tree, &cfg));
+  for (i = 1; i < 100; ++i) {
+    g_cdd_dataflow_alloc_fail = i;
+    rc = cdd_cst_defuse_build(cfg, &du);
+    if (rc == CDD_C_SUCCESS) {
+      rc = cdd_cst_dataflow_liveness(cfg, &du, &df);
+      if (rc == CDD_C_SUCCESS)
+        cdd_cst_dataflow_free(&df);
+      cdd_cst_defuse_free(&du);
+    }
+    if (rc == CDD_C_SUCCESS)
+      break;
+    ASSERT_EQ(CDD_C_ERROR_MEMORY, rc);
+  }
+  g_cdd_dataflow_alloc_fail = 0;
+  ASSERT_EQ(CDD_C_SUCCESS, rc);
+
+  cdd_cst_cfg_free(cfg);
+  cdd_cst_tree_free(tree);
+  PASS();
+}
+
+/**
+ * @brief Dataflow test suite.
+ */
+SUITE(cdd_cst_dataflow_suite) {
+  RUN_TEST(test_cdd_cst_dataflow_reaching_defs);
+  RUN_TEST(test_cdd_cst_dataflow_liveness);
+  RUN_TEST(test_cdd_cst_dataflow_must);
+  RUN_TEST(test_cdd_cst_dataflow_classify);
+  RUN_TEST(test_cdd_cst_dataflow_errors);
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TEST_CDD_CST_DATAFLOW_H */
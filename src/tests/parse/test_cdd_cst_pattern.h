@@ -0,0 +1,231 @@
+/**
+ * @file test_cdd_cst_pattern.h
+ * @brief Unit tests for CST pattern queries.
+ */
+
+#ifndef TEST_CDD_CST_PATTERN_H
+#define TEST_CDD_CST_PATTERN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+#include <greatest.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "classes/parse/cdd_cst_factory.h"
+#include "classes/parse/cdd_cst_mutate.h"
+#include "classes/parse/cdd_cst_parser.h"
+#include "classes/parse/cdd_cst_pattern.h"
+#include "classes/parse/cdd_cst_query.h"
+/* clang-format on */
+
+/**
+ * @brief Compares a token with a C string.
+ */
+static int pattern_test_tok_is(const cdd_token_t *tok, const char *text) {
+  return tok && tok->length == strlen(text) &&
+         memcmp(tok->start, text, tok->length) == 0;
+}
+
+/**
+ * @brief Tests compiling valid and invalid patterns.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_pattern_compile(void) {
+  cdd_cst_pattern_set_t *set = NULL;
+  size_t id = 99, pos = 0, cap = 0;
+
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_set_new(&set));
+  ASSERT_EQ(CDD_C_SUCCESS,
+            cdd_cst_pattern_set_add(set, "(call_expr \"f\" . \"(\") @call",
+                                    &id, NULL));
+  ASSERT_EQ(0, id);
+  ASSERT_EQ(CDD_C_SUCCESS,
+            cdd_cst_pattern_set_add(set,
+                                    "; comment\n(_ (identifier IDENTIFIER @fn."
+                                    "name) _ .) @any",
+                                    &id, NULL));
+  ASSERT_EQ(1, id);
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_capture_id(set, "call", &cap));
+  ASSERT_EQ(0, cap);
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_capture_id(set, "fn.name", &cap));
+  ASSERT_EQ(1, cap);
+  ASSERT_EQ(CDD_C_ERROR_NOT_FOUND,
+            cdd_cst_pattern_capture_id(set, "missing", &cap));
+
+  /* Errors leave the set as it was */
+  ASSERT_EQ(CDD_C_ERROR_PARSE,
+            cdd_cst_pattern_set_add(set, "(no_such_kind)", NULL, &pos));
+  ASSERT_EQ(1, pos);
+  ASSERT_EQ(CDD_C_ERROR_PARSE,
+            cdd_cst_pattern_set_add(set, "(block \"x) @late", NULL, &pos));
+  ASSERT_EQ(CDD_C_ERROR_PARSE,
+            cdd_cst_pattern_set_add(set, "(block WORD)", NULL, &pos));
+  ASSERT_EQ(7, pos);
+  ASSERT_EQ(CDD_C_ERROR_PARSE,
+            cdd_cst_pattern_set_add(set, "\"tok\"", NULL, NULL));
+  ASSERT_EQ(CDD_C_ERROR_PARSE,
+            cdd_cst_pattern_set_add(set, "(block) (block)", NULL, NULL));
+  ASSERT_EQ(CDD_C_ERROR_PARSE,
+            cdd_cst_pattern_set_add(set, "(block @x) @", NULL, NULL));
+  ASSERT_EQ(CDD_C_ERROR_NOT_FOUND,
+            cdd_cst_pattern_capture_id(set, "late", &cap));
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_set_add(set, "(block)", &id, NULL));
+  ASSERT_EQ(2, id);
+
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cdd_cst_pattern_set_add(NULL, "(block)", NULL, NULL));
+  cdd_cst_pattern_set_free(set);
+  cdd_cst_pattern_set_free(NULL);
+  PASS();
+}
+
+/**
+ * @brief Tests that matches agree with the traversal queries and that
+ * captures bind the right children.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_pattern_matches(void) {
+  const char *code = "int f(int a) { return g(a) + g(1); }\n"
+                     "int h(void) { f(2); g(f(3)); return 0; }\n";
+  cdd_cst_tree_t *tree = NULL;
+  cdd_cst_pattern_set_t *set = NULL;
+  cdd_cst_pattern_results_t res;
+  cdd_cst_query_result_t funcs, calls;
+  size_t p_func, p_call, c_name, c_call;
+  size_t i, nf = 0, nc = 0;
+
+  ASSERT_EQ(0, cdd_cst_parse(az_span_create_from_str((char *)code), &tree));
+  ASSERT_EQ(0, cdd_cst_find_nodes_by_type(tree->root,
+                                          CDD_CST_FUNCTION_DEFINITION, &funcs));
+  ASSERT_EQ(0, cdd_cst_find_function_calls_named(tree->root, "g", &calls));
+
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_set_new(&set));
+  ASSERT_EQ(CDD_C_SUCCESS,
+            cdd_cst_pattern_set_add(
+                set, "(function_definition IDENTIFIER @name . \"(\")",
+                &p_func, NULL));
+  ASSERT_EQ(CDD_C_SUCCESS,
+            cdd_cst_pattern_set_add(set, "(_ \"g\" @callee . \"(\") @call",
+                                    &p_call, NULL));
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_capture_id(set, "name", &c_name));
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_capture_id(set, "call", &c_call));
+
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_collect(set, tree->root, &res));
+  for (i = 0; i < res.size; i++) {
+    const cdd_cst_pattern_match_t *m = &res.matches[i];
+    if (m->pattern == p_func) {
+      ASSERT(nf < funcs.size);
+      ASSERT(m->node == funcs.nodes[nf]);
+      ASSERT(cdd_cst_pattern_capture_node(m, c_call) == NULL);
+      ASSERT(pattern_test_tok_is(cdd_cst_pattern_capture_token(m, c_name),
+                                 nf == 0 ? "f" : "h"));
+      nf++;
+    } else {
+      ASSERT_EQ(p_call, m->pattern);
+      ASSERT(cdd_cst_pattern_capture_node(m, c_call) == m->node);
+      ASSERT(cdd_cst_pattern_capture_token(m, c_name) == NULL);
+      nc++;
+    }
+  }
+  ASSERT_EQ(funcs.size, nf);
+  ASSERT(nc > 0);
+
+  /* Anchors: "g" directly before "(" is required, "(" at the end is not */
+  cdd_cst_pattern_results_free(&res);
+  cdd_cst_pattern_set_free(set);
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_set_new(&set));
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_set_add(
+                               set, "(function_definition . \"(\")", NULL,
+                               NULL));
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_set_add(
+                               set, "(function_definition \"(\" .)", NULL,
+                               NULL));
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_collect(set, tree->root, &res));
+  ASSERT_EQ(0, res.size);
+  cdd_cst_pattern_results_free(&res);
+
+  free(funcs.nodes);
+  free(calls.nodes);
+  cdd_cst_pattern_set_free(set);
+  cdd_cst_tree_free(tree);
+  PASS();
+}
+
+/**
+ * @brief Callback that stops after the first match.
+ */
+static cdd_c_error_t pattern_test_stop(const cdd_cst_pattern_match_t *match,
+                                       void *user_data) {
+  (void)match;
+  ++*(int *)user_data;
+  return CDD_C_ERROR_UNKNOWN;
+}
+
+/**
+ * @brief Tests editing the tree with collected captures, and early exit.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_pattern_replace(void) {
+  const char *code = "void f(void) { a(); b(); a(); }\n";
+  cdd_cst_tree_t *tree = NULL;
+  cdd_cst_pattern_set_t *set = NULL;
+  cdd_cst_pattern_results_t res;
+  cdd_cst_query_result_t left;
+  size_t i, c_stmt;
+  int seen = 0;
+
+  ASSERT_EQ(0, cdd_cst_parse(az_span_create_from_str((char *)code), &tree));
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_set_new(&set));
+  ASSERT_EQ(CDD_C_SUCCESS,
+            cdd_cst_pattern_set_add(set, "(_ . \"a\" . \"(\") @stmt", NULL,
+                                    NULL));
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_capture_id(set, "stmt", &c_stmt));
+
+  ASSERT_EQ(CDD_C_ERROR_UNKNOWN,
+            cdd_cst_pattern_run(set, tree->root, pattern_test_stop, &seen));
+  ASSERT_EQ(1, seen);
+
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_pattern_collect(set, tree->root, &res));
+  ASSERT_EQ(2, res.size);
+  for (i = 0; i < res.size; i++) {
+    cdd_cst_node_t *stmt = cdd_cst_pattern_capture_node(&res.matches[i],
+                                                        c_stmt);
+    cdd_cst_node_t *empty = NULL;
+    ASSERT(stmt != NULL);
+    ASSERT_EQ(0, cdd_cst_alloc_node(CDD_CST_UNKNOWN, &empty));
+    ASSERT_EQ(CDD_C_SUCCESS, cdd_cst_replace_node(tree, stmt, empty));
+    cdd_cst_free_node(stmt);
+  }
+  cdd_cst_pattern_results_free(&res);
+
+  ASSERT_EQ(0, cdd_cst_tree_find_function_calls_named(tree, "a", &left));
+  ASSERT_EQ(0, left.size);
+  ASSERT_EQ(0, cdd_cst_tree_find_function_calls_named(tree, "b", &left));
+  ASSERT_EQ(1, left.size);
+  free(left.nodes);
+
+  cdd_cst_pattern_set_free(set);
+  cdd_cst_tree_free(tree);
+  PASS();
+}
+
+SUITE(cdd_cst_pattern_suite) {
+  RUN_TEST(test_cdd_cst_pattern_compile);
+  RUN_TEST(test_cdd_cst_pattern_matches);
+  RUN_TEST(test_cdd_cst_pattern_replace);
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TEST_CDD_CST_PATTERN_H */
@@ -17,6 +17,7 @@ extern "C" {
 #include "c_cdd/format_specifiers.h"
 #include <string.h>
 #include <stdlib.h>
+#include "classes/parse/cdd_cst_mutate.h"
 #include "classes/parse/cdd_cst_parser.h"
 #include "classes/parse/cdd_cst_query.h"
 /* clang-format on */
@@ -707,12 +708,151 @@ TEST test_query_call_expr_coverage(void) {
   }
 }
 
+/**
+ * @brief Compares a result from the tree index with the node query.
+ */
+static int query_results_equal(const cdd_cst_query_result_t *a,
+                               const cdd_cst_query_result_t *b) {
+  return a->size == b->size &&
+         (a->size == 0 ||
+          memcmp(a->nodes, b->nodes, a->size * sizeof(*a->nodes)) == 0);
+}
+
+/**
+ * @brief Tests that the tree index answers like the traversal queries.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_tree_index_matches_query(void) {
+  const char *code = "int f(int a) { return g(a) + g(1); }\n"
+                     "int h(void) { f(2); g(f(3)); return 0; }\n"
+                     "#define X 1\n#include <stdio.h>\n";
+  const char *names[] = {"f", "g", "h", "printf", "a"};
+  cdd_cst_tree_t *tree = NULL;
+  cdd_cst_query_result_t want, got;
+  size_t k;
+
+  ASSERT_EQ(0, cdd_cst_parse(az_span_create_from_str((char *)code), &tree));
+  for (k = 0; k <= (size_t)CDD_CST_UNKNOWN; k++) {
+    enum cdd_cst_node_kind_t kind = (enum cdd_cst_node_kind_t)k;
+    ASSERT_EQ(0, cdd_cst_find_nodes_by_type(tree->root, kind, &want));
+    ASSERT_EQ(0, cdd_cst_tree_find_nodes_by_type(tree, kind, &got));
+    ASSERT(query_results_equal(&want, &got));
+    free(want.nodes);
+    free(got.nodes);
+  }
+  for (k = 0; k < sizeof(names) / sizeof(names[0]); k++) {
+    ASSERT_EQ(0, cdd_cst_find_function_calls_named(tree->root, names[k],
+                                                   &want));
+    ASSERT_EQ(0, cdd_cst_tree_find_function_calls_named(tree, names[k], &got));
+    ASSERT(query_results_equal(&want, &got));
+    free(want.nodes);
+    free(got.nodes);
+  }
+  ASSERT_EQ(0, cdd_cst_tree_find_function_calls_named(tree, "g", &got));
+  ASSERT(got.size > 0);
+  free(got.nodes);
+
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cdd_cst_tree_find_nodes_by_type(NULL, CDD_CST_UNKNOWN, &got));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cdd_cst_tree_find_function_calls_named(tree, NULL, &got));
+
+  g_cdd_query_err_fail = 1;
+  ASSERT_EQ(CDD_C_ERROR_MEMORY, cdd_cst_tree_find_nodes_by_type(
+                                    tree, CDD_CST_FUNCTION_DEFINITION, &got));
+  g_cdd_query_err_fail = 0;
+
+  cdd_cst_tree_free(tree);
+  PASS();
+}
+
+/**
+ * @brief Tests that mutations are seen by the next indexed query.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_tree_index_invalidation(void) {
+  const char *code = "int f(void) { return 0; }\nint g(void) { return 1; }\n";
+  cdd_cst_tree_t *tree = NULL;
+  cdd_cst_query_result_t res;
+  cdd_cst_node_t *func;
+  cdd_cst_node_t *extra = NULL;
+
+  ASSERT_EQ(0, cdd_cst_parse(az_span_create_from_str((char *)code), &tree));
+  ASSERT_EQ(0, cdd_cst_tree_find_nodes_by_type(
+                   tree, CDD_CST_FUNCTION_DEFINITION, &res));
+  ASSERT_EQ(2, res.size);
+  func = res.nodes[0];
+  free(res.nodes);
+
+  /* Tree-level mutation */
+  ASSERT_EQ(0, cdd_cst_detach_node(tree, func));
+  ASSERT_EQ(0, cdd_cst_tree_find_nodes_by_type(
+                   tree, CDD_CST_FUNCTION_DEFINITION, &res));
+  ASSERT_EQ(1, res.size);
+  ASSERT(res.nodes[0] != func);
+  free(res.nodes);
+
+  /* Node-level mutation below the root */
+  ASSERT_EQ(0, cdd_cst_alloc_node(CDD_CST_CALL_EXPR, &extra));
+  ASSERT_EQ(0, cdd_cst_append_child_node(tree->root, func));
+  ASSERT_EQ(0, cdd_cst_append_child_node(func, extra));
+  ASSERT_EQ(0, cdd_cst_tree_find_nodes_by_type(tree, CDD_CST_CALL_EXPR, &res));
+  ASSERT_EQ(1, res.size);
+  ASSERT(res.nodes[0] == extra);
+  free(res.nodes);
+  ASSERT_EQ(0, cdd_cst_tree_find_nodes_by_type(
+                   tree, CDD_CST_FUNCTION_DEFINITION, &res));
+  ASSERT_EQ(2, res.size);
+  ASSERT(res.nodes[1] == func);
+  free(res.nodes);
+
+  cdd_cst_tree_free(tree);
+  PASS();
+}
+
+/**
+ * @brief Tests traversing a chain far deeper than the C stack would allow.
+ *
+ * @return The result of the test.
+ */
+TEST test_cdd_cst_traverse_deep(void) {
+  const size_t depth = 200000;
+  cdd_cst_node_t **chain =
+      (cdd_cst_node_t **)malloc(depth * sizeof(cdd_cst_node_t *));
+  int count = 0;
+  size_t i;
+
+  ASSERT(chain != NULL);
+  /* Built bottom-up so that each append sees a detached parent */
+  for (i = depth; i-- > 0;) {
+    ASSERT_EQ(0, cdd_cst_alloc_node(CDD_CST_EXPRESSION, &chain[i]));
+    if (i + 1 < depth)
+      ASSERT_EQ(0, cdd_cst_append_child_node(chain[i], chain[i + 1]));
+  }
+
+  ASSERT_EQ(0, cdd_cst_traverse_preorder(chain[0], dummy_visitor, &count));
+  ASSERT_EQ((int)depth, count);
+  count = 0;
+  ASSERT_EQ(0, cdd_cst_traverse_postorder(chain[0], dummy_visitor, &count));
+  ASSERT_EQ((int)depth, count);
+
+  for (i = 0; i < depth; i++)
+    cdd_cst_free_node_only(chain[i]);
+  free(chain);
+  PASS();
+}
+
 SUITE(cdd_cst_query_suite) {
   RUN_TEST(test_query_postorder_fail);
   RUN_TEST(test_query_call_expr_coverage);
   RUN_TEST(test_cdd_cst_query_types);
   RUN_TEST(test_cdd_cst_query_calls);
   RUN_TEST(test_cdd_cst_query_extra);
+  RUN_TEST(test_cdd_cst_tree_index_matches_query);
+  RUN_TEST(test_cdd_cst_tree_index_invalidation);
+  RUN_TEST(test_cdd_cst_traverse_deep);
 }
 
 #ifdef __cplusplus
@@ -2,6 +2,13 @@
 #define TEST_CLI_C2OPENAPI_H
 
 /* clang-format off */
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "functions/parse/fs.h"
 #include "routes/parse/cli.h"
 #include <greatest.h>
 /* clang-format on */
@@ -15,7 +22,24 @@ TEST test_c2openapi_cli_main_invalid_args(void) {
 TEST test_c2openapi_cli_main_valid_args(void) {
   char *argv1[] = {"c2openapi", "src/tests/mocks", "out.json"};
   int rc = c2openapi_cli_main(3, argv1);
+  FILE *fh;
   ASSERT_EQ(CDD_C_SUCCESS, rc);
+  /* Written through a temporary that is renamed into place */
+#if defined(_MSC_VER)
+  if (fopen_s(&fh, "out.json.tmp", "r") != 0)
+    fh = NULL;
+#else
+  fh = fopen("out.json.tmp", "r");
+#endif
+  ASSERT(fh == NULL);
+#if defined(_MSC_VER)
+  if (fopen_s(&fh, "out.json", "r") != 0)
+    fh = NULL;
+#else
+  fh = fopen("out.json", "r");
+#endif
+  ASSERT(fh != NULL);
+  fclose(fh);
   PASS();
 }
 
@@ -72,6 +96,96 @@ TEST test_generate_bindings_cli_main_help(void) {
   PASS();
 }
 
+TEST test_c2openapi_cli_main_parallel_matches_serial(void) {
+  char *argv_serial[] = {"c2openapi", "src/tests/mocks", "out_serial.json"};
+  char *argv_parallel[] = {"c2openapi", "src/tests/mocks",
+                           "out_parallel.json"};
+  char *serial = NULL;
+  char *parallel = NULL;
+  size_t serial_sz = 0, parallel_sz = 0;
+  int rc_serial, rc_parallel;
+
+#if defined(_WIN32)
+  _putenv("CDD_C_JOBS=1");
+#else
+  setenv("CDD_C_JOBS", "1", 1);
+#endif
+  rc_serial = c2openapi_cli_main(3, argv_serial);
+#if defined(_WIN32)
+  _putenv("CDD_C_JOBS=4");
+#else
+  setenv("CDD_C_JOBS", "4", 1);
+#endif
+  rc_parallel = c2openapi_cli_main(3, argv_parallel);
+#if defined(_WIN32)
+  _putenv("CDD_C_JOBS=");
+#else
+  unsetenv("CDD_C_JOBS");
+#endif
+  ASSERT_EQ(CDD_C_SUCCESS, rc_serial);
+  ASSERT_EQ(CDD_C_SUCCESS, rc_parallel);
+
+  ASSERT_EQ(0, read_to_file("out_serial.json", "r", &serial, &serial_sz));
+  ASSERT_EQ(0,
+            read_to_file("out_parallel.json", "r", &parallel, &parallel_sz));
+  ASSERT_EQ(serial_sz, parallel_sz);
+  ASSERT_STR_EQ(serial, parallel);
+
+  free(serial);
+  free(parallel);
+  remove("out_serial.json");
+  remove("out_parallel.json");
+  PASS();
+}
+
+/**
+ * @brief Directory walker removing each cache entry and counting them.
+ */
+static cdd_c_error_t test_c2openapi_cache_remove_cb(const char *path,
+                                                    void *user_data) {
+  (*(size_t *)user_data)++;
+  remove(path);
+  return CDD_C_SUCCESS;
+}
+
+TEST test_c2openapi_cli_main_cache_matches_uncached(void) {
+  char *argv_plain[] = {"c2openapi", "src/tests/mocks", "out_plain.json"};
+  char *argv_cached[] = {"c2openapi", "--cache-dir", "c2openapi_test_cache",
+                         "src/tests/mocks", "out_cached.json"};
+  char *plain = NULL;
+  char *cached = NULL;
+  size_t plain_sz = 0, cached_sz = 0;
+  size_t n_entries = 0;
+  int pass;
+
+  ASSERT_EQ(CDD_C_SUCCESS, c2openapi_cli_main(3, argv_plain));
+  ASSERT_EQ(0, read_to_file("out_plain.json", "r", &plain, &plain_sz));
+
+  /* Cold run populates the cache, warm run is served from it */
+  for (pass = 0; pass < 2; ++pass) {
+    ASSERT_EQ(CDD_C_SUCCESS, c2openapi_cli_main(5, argv_cached));
+    ASSERT_EQ(0, read_to_file("out_cached.json", "r", &cached, &cached_sz));
+    ASSERT_EQ(plain_sz, cached_sz);
+    ASSERT_STR_EQ(plain, cached);
+    free(cached);
+    cached = NULL;
+  }
+
+  ASSERT_EQ(0, walk_directory("c2openapi_test_cache",
+                              test_c2openapi_cache_remove_cb, &n_entries));
+  ASSERT(n_entries > 0);
+#if defined(_WIN32)
+  _rmdir("c2openapi_test_cache");
+#else
+  rmdir("c2openapi_test_cache");
+#endif
+
+  free(plain);
+  remove("out_plain.json");
+  remove("out_cached.json");
+  PASS();
+}
+
 TEST test_c2openapi_cli_main_doc_tags(void) {
   FILE *f;
 #if defined(_MSC_VER)
@@ -246,5 +360,7 @@ SUITE(cli_c2openapi_suite) {
   RUN_TEST(test_generate_bindings_cli_main);
   RUN_TEST(test_generate_bindings_cli_main_help);
   RUN_TEST(test_c2openapi_cli_main_doc_tags);
+  RUN_TEST(test_c2openapi_cli_main_parallel_matches_serial);
+  RUN_TEST(test_c2openapi_cli_main_cache_matches_uncached);
 }
 #endif /* TEST_CLI_C2OPENAPI_H */
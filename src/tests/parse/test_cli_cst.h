@@ -125,6 +125,12 @@ TEST test_cli_cst_errors(void) {
   char *argv_gnu[] = {"gnu_standardizer", "--help", NULL};
   char *argv_percolate[] = {"error_percolator", "--help", NULL};
   char *argv_safe[] = {"safe_crt", "--help", NULL};
+  char *argv_ctx_neg[] = {"extern_c", "--context=-1", "file.h", NULL};
+  char *argv_ctx_junk[] = {"extern_c", "--context=3x", "file.h", NULL};
+  char *argv_ctx_empty[] = {"extern_c", "--context=", "file.h", NULL};
+  char *argv_ctx_big[] = {"extern_c",
+                          "--context=999999999999999999999999999999",
+                          "file.h", NULL};
 
   ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
             cli_cst_transformer_main(0, argv_no_args));
@@ -138,6 +144,14 @@ TEST test_cli_cst_errors(void) {
             cli_cst_transformer_main(2, argv_nofix));
   ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
             cli_cst_transformer_main(3, argv_badfile));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cli_cst_transformer_main(3, argv_ctx_neg));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cli_cst_transformer_main(3, argv_ctx_junk));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cli_cst_transformer_main(3, argv_ctx_empty));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            cli_cst_transformer_main(3, argv_ctx_big));
 
   /* Hit branches for other tools */
   ASSERT_EQ(0, cli_cst_transformer_main(2, argv_msvc));
@@ -172,6 +186,12 @@ TEST test_cli_standardize_gnu(void) {
     ASSERT_EQ(0, cli_standardize_gnu_main(1, argv_help));
     ASSERT_EQ(0, cli_standardize_gnu_main(1, argv_help2));
 
+    {
+      char *argv_ctx[] = {"--audit", "--context=-2", "file.c"};
+      ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+                cli_standardize_gnu_main(3, argv_ctx));
+    }
+
     /* Test no file specified or bad file */
     {
       char *argv_nofile[] = {"--audit"};
@@ -190,8 +190,10 @@ TEST test_parse_struct_member_format_mapping(void) {
   arr_field = &sf.fields[1];
   ASSERT_STR_EQ("ids", arr_field->name);
   ASSERT_STR_EQ("array", arr_field->type);
-  ASSERT(arr_field->items_extra_json != NULL);
-  ASSERT(strstr(arr_field->items_extra_json, "\"format\":\"int64\"") != NULL);
+  ASSERT(arr_field->items_extra != NULL);
+  ASSERT_STR_EQ("int64",
+                json_object_get_string(
+                    json_value_get_object(arr_field->items_extra), "format"));
 
   struct_fields_free(&sf);
   g_fail_io_after = -1;
@@ -879,14 +881,13 @@ TEST test_parse_struct_member_annotations(void) {
   ASSERT_EQ(1, sf.size);
   ASSERT_STR_EQ("user_id", sf.fields[0].name);
   ASSERT_STR_EQ("integer", sf.fields[0].type);
-  ASSERT(sf.fields[0].schema_extra_json != NULL);
-  ASSERT(strstr(sf.fields[0].schema_extra_json, "\"x-cdd-shard-key\":true") !=
-
-         NULL);
-
-  ASSERT(strstr(sf.fields[0].schema_extra_json, "\"x-cdd-shard-hash\":true") !=
-
-         NULL);
+  ASSERT(sf.fields[0].schema_extra != NULL);
+  ASSERT_EQ(1, json_object_get_boolean(
+                   json_value_get_object(sf.fields[0].schema_extra),
+                   "x-cdd-shard-key"));
+  ASSERT_EQ(1, json_object_get_boolean(
+                   json_value_get_object(sf.fields[0].schema_extra),
+                   "x-cdd-shard-hash"));
 
   ASSERT_EQ(
 
@@ -895,14 +896,13 @@ TEST test_parse_struct_member_annotations(void) {
 
   ASSERT_EQ(2, sf.size);
   ASSERT_STR_EQ("name", sf.fields[1].name);
-  ASSERT(sf.fields[1].schema_extra_json != NULL);
-  ASSERT(strstr(sf.fields[1].schema_extra_json,
-
-                "\"x-cdd-track-telemetry\":true") != NULL);
-
-  ASSERT(strstr(sf.fields[1].schema_extra_json, "\"x-cdd-slow-query\":250") !=
-
-         NULL);
+  ASSERT(sf.fields[1].schema_extra != NULL);
+  ASSERT_EQ(1, json_object_get_boolean(
+                   json_value_get_object(sf.fields[1].schema_extra),
+                   "x-cdd-track-telemetry"));
+  ASSERT_EQ(250, (int)json_object_get_number(
+                     json_value_get_object(sf.fields[1].schema_extra),
+                     "x-cdd-slow-query"));
 
   struct_fields_free(&sf);
   g_fail_io_after = -1;
@@ -911,13 +911,16 @@ TEST test_parse_struct_member_annotations(void) {
 
 TEST test_code2schema_merge_struct_field(void) {
 
+  struct StructFields sf;
   struct StructField f1, f2;
 
   memset(&f1, 0, sizeof(f1));
   memset(&f2, 0, sizeof(f2));
+  ASSERT_EQ(0, struct_fields_init(&sf));
 
-  merge_struct_field(NULL, &f2);
-  merge_struct_field(&f1, NULL);
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, merge_struct_field(&sf, NULL, &f2));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, merge_struct_field(&sf, &f1, NULL));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, merge_struct_field(NULL, &f1, &f2));
 
   f2.has_min = 1;
   f2.min_val = 10;
@@ -932,12 +935,12 @@ TEST test_code2schema_merge_struct_field(void) {
   f2.has_max_items = 1;
   f2.max_items = 8;
   f2.required = 1;
-  strncpy(f2.default_val, "test", sizeof(f2.default_val) - 1);
-  strncpy(f2.format, "uuid", sizeof(f2.format) - 1);
-  strncpy(f2.pattern, "^[a-z]+$", sizeof(f2.pattern) - 1);
-  strncpy(f2.bit_width, "16", sizeof(f2.bit_width) - 1);
+  f2.default_val = "test";
+  f2.format = "uuid";
+  f2.pattern = "^[a-z]+$";
+  f2.bit_width = "16";
 
-  merge_struct_field(&f1, &f2);
+  ASSERT_EQ(0, merge_struct_field(&sf, &f1, &f2));
 
   ASSERT_EQ(1, f1.has_min);
   ASSERT_EQ(10, f1.min_val);
@@ -954,6 +957,9 @@ TEST test_code2schema_merge_struct_field(void) {
   ASSERT_EQ(1, f1.required);
   ASSERT_STR_EQ("test", f1.default_val);
   ASSERT_STR_EQ("16", f1.bit_width);
+  ASSERT_STR_EQ("^[a-z]+$", f1.pattern);
+  /* Merged strings are owned by the destination container */
+  ASSERT(f1.default_val != f2.default_val);
 
   f2.min_val = 15;
   f2.max_val = 15;
@@ -962,7 +968,7 @@ TEST test_code2schema_merge_struct_field(void) {
   f2.min_items = 5;
   f2.max_items = 5;
 
-  merge_struct_field(&f1, &f2);
+  ASSERT_EQ(0, merge_struct_field(&sf, &f1, &f2));
 
   ASSERT_EQ(15, f1.min_val);
   ASSERT_EQ(15, f1.max_val);
@@ -970,6 +976,7 @@ TEST test_code2schema_merge_struct_field(void) {
   ASSERT_EQ(10, f1.max_len);
   ASSERT_EQ(5, f1.min_items);
   ASSERT_EQ(5, f1.max_items);
+  struct_fields_free(&sf);
   g_fail_io_after = -1;
 
   PASS();
@@ -62,8 +62,7 @@ TEST test_code2schema_write_oom(void) {
     char *out_s = NULL;
 
     struct_fields_init(&sf);
-    c_cdd_strdup("{\"x-cdd-extra\": true}", &out_s);
-    sf.schema_extra_json = out_s;
+    sf.schema_extra = json_parse_string("{\"x-cdd-extra\": true}");
     sf.is_enum = 1;
     sf.enum_members.members = (char **)C_CDD_MALLOC(sizeof(char *) * 2);
     sf.enum_members.size = 2;
@@ -83,7 +82,7 @@ TEST test_code2schema_write_oom(void) {
     json_value_free(root);
     C_CDD_FREE(sf.enum_members.members[0]);
     C_CDD_FREE(sf.enum_members.members);
-    C_CDD_FREE(sf.schema_extra_json);
+    json_value_free(sf.schema_extra);
   }
   PASS();
 }
@@ -18,6 +18,7 @@ extern "C" {
 #include <errno.h>
 #include <greatest.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef _MSC_VER
 #include <wchar.h>
@@ -422,6 +423,29 @@ TEST test_fs_errors_untestable(void) {
   PASS();
 }
 
+TEST test_fs_map_file(void) {
+  struct FsMappedFile file;
+
+  ASSERT_EQ(0, write_to_file("test_fs_map.txt", "mapped bytes"));
+  ASSERT_EQ(CDD_C_SUCCESS, fs_map_file("test_fs_map.txt", &file));
+  ASSERT_EQ(12, file.size);
+  ASSERT_EQ(0, memcmp(file.data, "mapped bytes", 12));
+  fs_unmap_file(&file);
+  ASSERT(file.data == NULL);
+
+  /* Empty files cannot be mapped and are read instead */
+  ASSERT_EQ(0, write_to_file("test_fs_map.txt", ""));
+  ASSERT_EQ(CDD_C_SUCCESS, fs_map_file("test_fs_map.txt", &file));
+  ASSERT_EQ(0, file.size);
+  ASSERT_EQ(0, file.is_mapped);
+  fs_unmap_file(&file);
+  remove("test_fs_map.txt");
+
+  ASSERT(fs_map_file("file_that_does_not_exist.xyz", &file) != 0);
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, fs_map_file(NULL, &file));
+  PASS();
+}
+
 SUITE(fs_suite) {
 
   RUN_TEST(test_fs_fopen_error_from);
@@ -439,6 +463,7 @@ SUITE(fs_suite) {
   RUN_TEST(test_fs_cdd_fopen_too_long);
   RUN_TEST(test_fs_errors_untestable);
   RUN_TEST(test_fs_filename_and_ptr);
+  RUN_TEST(test_fs_map_file);
 #ifdef _MSC_VER
   RUN_TEST(test_ascii_wide_conversion);
 #endif
@@ -0,0 +1,123 @@
+/**
+ * @file test_json_fragment.h
+ * @brief Unit tests for shared, immutable JSON fragments.
+ */
+
+#ifndef TEST_JSON_FRAGMENT_H
+#define TEST_JSON_FRAGMENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+#include <greatest.h>
+#include <parson.h>
+#include <stdlib.h>
+
+#include "openapi/parse/json_fragment.h"
+/* clang-format on */
+
+/**
+ * @brief Tests that a structural clone is independent of its source.
+ *
+ * @return The result of the test.
+ */
+TEST test_json_value_clone_structural(void) {
+  JSON_Value *src = json_parse_string(
+      "{\"a\":[1,\"two\",{\"b\":null}],\"x-flag\":true,\"n\":1.5}");
+  JSON_Value *copy = NULL;
+  ASSERT(src != NULL);
+
+  ASSERT_EQ(CDD_C_SUCCESS, json_value_clone(src, &copy));
+  ASSERT(copy != NULL);
+  ASSERT(copy != src);
+  ASSERT(json_value_equals(src, copy));
+
+  json_object_set_number(json_value_get_object(src), "n", 2);
+  ASSERT_EQ(1.5, json_object_get_number(json_value_get_object(copy), "n"));
+
+  json_value_free(src);
+  json_value_free(copy);
+
+  ASSERT_EQ(CDD_C_SUCCESS, json_value_clone(NULL, &copy));
+  ASSERT(copy == NULL);
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, json_value_clone(NULL, NULL));
+  PASS();
+}
+
+/**
+ * @brief Tests parse-once sharing and reference counting.
+ *
+ * @return The result of the test.
+ */
+TEST test_json_fragment_shared(void) {
+  struct JsonFragment *frag = NULL;
+  struct JsonFragment *bad = NULL;
+  const JSON_Value *shared;
+  JSON_Value *out1 = NULL;
+  JSON_Value *out2 = NULL;
+
+  ASSERT_EQ(CDD_C_SUCCESS,
+            json_fragment_parse("{\"type\":\"string\"}", &frag));
+  ASSERT_EQ(1, frag->refs);
+  shared = json_fragment_value(frag);
+
+  /* A second owner sees the very same parsed node */
+  ASSERT(json_fragment_retain(frag) == frag);
+  ASSERT_EQ(2, frag->refs);
+  ASSERT(json_fragment_value(frag) == shared);
+
+  /* Attaching to output copies; the shared node stays untouched */
+  ASSERT_EQ(CDD_C_SUCCESS, json_fragment_copy_value(frag, &out1));
+  ASSERT_EQ(CDD_C_SUCCESS, json_fragment_copy_value(frag, &out2));
+  ASSERT(out1 != shared && out2 != shared && out1 != out2);
+  json_object_set_string(json_value_get_object(out1), "type", "integer");
+  ASSERT_STR_EQ("string", json_object_get_string(
+                              json_value_get_object(shared), "type"));
+  json_value_free(out1);
+  json_value_free(out2);
+
+  json_fragment_release(frag);
+  ASSERT_EQ(1, frag->refs);
+  json_fragment_release(frag);
+
+  ASSERT_EQ(CDD_C_ERROR_PARSE, json_fragment_parse("{oops", &bad));
+  ASSERT(bad == NULL);
+  json_fragment_release(NULL);
+  PASS();
+}
+
+/**
+ * @brief Tests building a fragment from an existing document node.
+ *
+ * @return The result of the test.
+ */
+TEST test_json_fragment_from_value(void) {
+  JSON_Value *doc = json_parse_string("{\"s\":{\"oneOf\":[{},{}]}}");
+  const JSON_Value *node =
+      json_object_get_value(json_value_get_object(doc), "s");
+  struct JsonFragment *frag = NULL;
+
+  ASSERT_EQ(CDD_C_SUCCESS, json_fragment_from_value(node, &frag));
+  json_value_free(doc);
+  ASSERT_EQ(2, json_array_get_count(json_object_get_array(
+                   json_value_get_object(json_fragment_value(frag)),
+                   "oneOf")));
+  json_fragment_release(frag);
+  PASS();
+}
+
+SUITE(json_fragment_suite) {
+  RUN_TEST(test_json_value_clone_structural);
+  RUN_TEST(test_json_fragment_shared);
+  RUN_TEST(test_json_fragment_from_value);
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TEST_JSON_FRAGMENT_H */
@@ -4073,37 +4073,34 @@ TEST test_load_component_schema_raw(void) {
 
   {
     int idx = find_raw_schema_index(&spec, "Token");
-    JSON_Value *val;
+    const JSON_Value *val;
     JSON_Object *obj;
     ASSERT(idx >= 0);
-    val = json_parse_string(spec.raw_schema_json[idx]);
+    val = json_fragment_value(spec.raw_schemas[idx]);
     obj = json_value_get_object(val);
     ASSERT_STR_EQ("string", json_object_get_string(obj, "type"));
-    json_value_free(val);
   }
 
   {
     int idx = find_raw_schema_index(&spec, "Flag");
-    JSON_Value *val;
+    const JSON_Value *val;
     ASSERT(idx >= 0);
-    val = json_parse_string(spec.raw_schema_json[idx]);
+    val = json_fragment_value(spec.raw_schemas[idx]);
     ASSERT_EQ(JSONBoolean, json_value_get_type(val));
     ASSERT_EQ(1, json_value_get_boolean(val));
-    json_value_free(val);
   }
 
   {
     int idx = find_raw_schema_index(&spec, "Nums");
-    JSON_Value *val;
+    const JSON_Value *val;
     JSON_Object *obj;
     JSON_Object *items;
     ASSERT(idx >= 0);
-    val = json_parse_string(spec.raw_schema_json[idx]);
+    val = json_fragment_value(spec.raw_schemas[idx]);
     obj = json_value_get_object(val);
     ASSERT_STR_EQ("array", json_object_get_string(obj, "type"));
     items = json_object_get_object(obj, "items");
     ASSERT_STR_EQ("integer", json_object_get_string(items, "type"));
-    json_value_free(val);
   }
 
   openapi_spec_free(&spec);
@@ -9,9 +9,16 @@
 int g_force_find_allocations_fail = 0;
 
 cdd_c_error_t internal_orchestrate_fix(const char *source_code, char **out_code);
+struct FixProject;
+cdd_c_error_t internal_orchestrate_fix_in_project(
+    const char *source_code, const char *path, const struct FixProject *project,
+    char **out_code);
 cdd_c_error_t internal_fix_code_main(int argc, char **argv);
 
 #define orchestrate_fix internal_orchestrate_fix
+#define orchestrate_fix_in_project internal_orchestrate_fix_in_project
+#define fix_project_init internal_fix_project_init
+#define fix_project_free internal_fix_project_free
 #define fix_code_main internal_fix_code_main
 
 #define find_allocations mock_find_allocations
@@ -0,0 +1,81 @@
+/**
+ * @file test_parallel.h
+ * @brief Unit tests for the portable parallel-for helper.
+ */
+
+#ifndef TEST_PARALLEL_H
+#define TEST_PARALLEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include "c_cdd_export.h"
+#include <greatest.h>
+#include <string.h>
+
+#include "functions/parse/parallel.h"
+/* clang-format on */
+
+#define TEST_PARALLEL_N_ITEMS 512
+
+/**
+ * @brief Per-index callback marking each item and failing on two indices.
+ */
+static cdd_c_error_t test_parallel_mark(size_t index, void *user_data) {
+  int *hits = (int *)user_data;
+  hits[index]++;
+  if (index == 300)
+    return CDD_C_ERROR_MEMORY;
+  if (index == 100)
+    return CDD_C_ERROR_IO;
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Tests that every item runs once and the lowest failure wins.
+ *
+ * @return The result of the test.
+ */
+TEST test_parallel_for_runs_each_item_once(void) {
+  static int hits[TEST_PARALLEL_N_ITEMS];
+  size_t jobs;
+  size_t i;
+
+  for (jobs = 1; jobs <= 4; ++jobs) {
+    memset(hits, 0, sizeof(hits));
+    ASSERT_EQ(CDD_C_ERROR_IO, cdd_parallel_for(TEST_PARALLEL_N_ITEMS, jobs,
+                                               test_parallel_mark, hits));
+    for (i = 0; i < TEST_PARALLEL_N_ITEMS; ++i)
+      ASSERT_EQ(1, hits[i]);
+  }
+  PASS();
+}
+
+/**
+ * @brief Tests argument validation and the default job count.
+ *
+ * @return The result of the test.
+ */
+TEST test_parallel_for_edge_cases(void) {
+  size_t jobs = 0;
+
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, cdd_parallel_for(1, 1, NULL, NULL));
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_parallel_for(0, 4, test_parallel_mark, NULL));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, cdd_parallel_default_jobs(NULL));
+  ASSERT_EQ(CDD_C_SUCCESS, cdd_parallel_default_jobs(&jobs));
+  ASSERT(jobs >= 1 && jobs <= CDD_PARALLEL_MAX_JOBS);
+  PASS();
+}
+
+SUITE(parallel_suite) {
+  RUN_TEST(test_parallel_for_runs_each_item_once);
+  RUN_TEST(test_parallel_for_edge_cases);
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TEST_PARALLEL_H */
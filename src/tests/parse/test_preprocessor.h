@@ -247,11 +247,15 @@ TEST test_pp_eval_macros_as_values(void) {
   pp_context_init(&ctx);
   pp_add_macro(&ctx, "ONE", "1");
   pp_add_macro(&ctx, "TWO", "2");
+  pp_add_macro(&ctx, "FLAGS", "(ONE << 3) | TWO");
 
   {
     long out = 0;
     eval("ONE + TWO", &ctx, &out);
     ASSERT_EQ(3, out);
+    /* Macro bodies are full expressions, not just numbers */
+    eval("FLAGS", &ctx, &out);
+    ASSERT_EQ(10, out);
   }
 
   pp_context_free(&ctx);
@@ -640,6 +644,11 @@ TEST test_pp_has_c_attribute(void) {
   eval("__has_c_attribute(nonexistent)", &ctx, &out);
   ASSERT_EQ(0, out);
 
+  out = 1;
+  eval("__has_c_attribute(gnu::packed) || __has_c_attribute( noreturn ) > 1",
+       &ctx, &out);
+  ASSERT_EQ(1, out);
+
   pp_context_free(&ctx);
   g_fail_io_after = -1;
   PASS();
@@ -420,6 +420,7 @@ TEST test_macro_evaluator_uncovered(void) {
   ASSERT_NEQ(0, rc);
 
   /* recursive error */
+  memset(&def, 0, sizeof(def));
   def.name = "BAD";
   def.value = "1 = 2";
   def.is_function_like = 0;
@@ -463,12 +464,146 @@ TEST test_macro_evaluator_uncovered(void) {
   }
 }
 
+TEST test_macro_evaluator_compiled(void) {
+  struct PreprocessorContext ctx;
+  cdd_macro_program_t *prog = NULL;
+  cdd_macro_eval_result_t res;
+
+  pp_context_init(&ctx);
+
+  /* Compiled once, run against whatever the context holds at the time */
+  ASSERT_EQ(0, cdd_macro_compile("WIDTH * 2 + sizeof(unsigned int)", &prog));
+  ASSERT_EQ(0, cdd_macro_program_run(prog, &ctx, &res));
+  ASSERT_EQ(4, res.int_val);
+  ASSERT_EQ(0, pp_add_macro(&ctx, "WIDTH", "8"));
+  ASSERT_EQ(0, cdd_macro_program_run(prog, &ctx, &res));
+  ASSERT_EQ(20, res.int_val);
+  cdd_macro_program_free(prog);
+
+  ASSERT_EQ(0, cdd_macro_evaluate(&ctx, "sizeof(const char *)", &res));
+  ASSERT_EQ((long long)sizeof(char *), res.int_val);
+  ASSERT_EQ(0, cdd_macro_evaluate(&ctx, "_Alignof(double)", &res));
+  ASSERT_EQ(8, res.int_val);
+  ASSERT_NEQ(0, cdd_macro_evaluate(&ctx, "sizeof(struct Unknown)", &res));
+  ASSERT_NEQ(0, cdd_macro_evaluate(&ctx, "sizeof 4", &res));
+
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, cdd_macro_compile("(1 +", &prog));
+  ASSERT_EQ(NULL, prog);
+
+  pp_context_free(&ctx);
+  PASS();
+}
+
+TEST test_macro_value_memo(void) {
+  struct PreprocessorContext ctx;
+  cdd_macro_eval_result_t res;
+  struct MacroDef *b;
+
+  write_to_file("test_memo_macros.h", "#define A 10\n"
+                                      "#define B (A << 2)\n"
+                                      "#define C 1\n"
+                                      "#undef C\n"
+                                      "#define LOOP_X LOOP_Y\n"
+                                      "#define LOOP_Y LOOP_X\n"
+                                      "#define NAME \"str\"\n");
+  pp_context_init(&ctx);
+  ASSERT_EQ(0, pp_scan_defines(&ctx, "test_memo_macros.h"));
+  ASSERT_EQ(5, ctx.macro_count);
+  b = &ctx.macros[1];
+  ASSERT_STR_EQ("B", b->name);
+
+  ASSERT_EQ(0, cdd_macro_value(&ctx, b, &res));
+  ASSERT_EQ(40, res.int_val);
+  ASSERT_EQ(MACRO_VALUE_DONE, b->memo.state);
+  ASSERT_EQ(MACRO_VALUE_DONE, ctx.macros[0].memo.state);
+
+  /* Served from the memo while nothing changes */
+  b->memo.int_val = 41;
+  ASSERT_EQ(0, cdd_macro_evaluate(&ctx, "B", &res));
+  ASSERT_EQ(41, res.int_val);
+
+  /* Redefining A invalidates B too */
+  ASSERT_EQ(0, pp_add_macro(&ctx, "A", "3"));
+  ASSERT_EQ(5, ctx.macro_count);
+  ASSERT_EQ(0, cdd_macro_value(&ctx, b, &res));
+  ASSERT_EQ(12, res.int_val);
+
+  /* So does removing it: unknown names are 0 */
+  ASSERT_EQ(0, pp_remove_macro(&ctx, "A"));
+  ASSERT_EQ(4, ctx.macro_count);
+  b = &ctx.macros[0];
+  ASSERT_EQ(0, cdd_macro_value(&ctx, b, &res));
+  ASSERT_EQ(0, res.int_val);
+  ASSERT_EQ(0, pp_remove_macro(&ctx, "NOT_DEFINED"));
+
+  /* Cycles fail instead of recursing */
+  ASSERT_NEQ(0, cdd_macro_evaluate(&ctx, "LOOP_X", &res));
+  ASSERT_EQ(MACRO_VALUE_FAILED, ctx.macros[1].memo.state);
+
+  ASSERT_EQ(0, cdd_macro_evaluate(&ctx, "NAME", &res));
+  ASSERT_STR_EQ("str", res.str_val);
+  cdd_macro_eval_result_free(&res);
+  ASSERT_EQ(0, cdd_macro_evaluate(&ctx, "NAME", &res));
+  ASSERT_STR_EQ("str", res.str_val);
+  cdd_macro_eval_result_free(&res);
+
+  pp_context_free(&ctx);
+  remove("test_memo_macros.h");
+  PASS();
+}
+
+TEST test_macro_value_program_kept(void) {
+  struct PreprocessorContext ctx;
+  cdd_macro_eval_result_t res;
+  struct MacroDef *b;
+  cdd_macro_program_t *program;
+
+  pp_context_init(&ctx);
+  ASSERT_EQ(0, pp_add_macro(&ctx, "A", "2"));
+  ASSERT_EQ(0, pp_add_macro(&ctx, "B", "defined(A) && A > 1"));
+  b = &ctx.macros[1];
+  ASSERT_EQ(0, cdd_macro_value(&ctx, b, &res));
+  ASSERT_EQ(1, res.int_val);
+  program = b->program;
+  ASSERT(program != NULL);
+
+  /* A stale memo re-runs the program it already has */
+  ASSERT_EQ(0, pp_add_macro(&ctx, "A", "1"));
+  ASSERT_EQ(0, cdd_macro_value(&ctx, b, &res));
+  ASSERT_EQ(0, res.int_val);
+  ASSERT(b->program == program);
+  ASSERT_EQ(0, pp_remove_macro(&ctx, "A"));
+  b = &ctx.macros[0];
+  ASSERT_EQ(0, cdd_macro_value(&ctx, b, &res));
+  ASSERT_EQ(0, res.int_val);
+  ASSERT(b->program == program);
+
+  /* Redefining the macro itself drops it */
+  ASSERT_EQ(0, pp_add_macro(&ctx, "B", "0b101 + 'a' + '\\n' + '\\x01'"));
+  ASSERT(b->program == NULL);
+  ASSERT_EQ(0, cdd_macro_value(&ctx, b, &res));
+  ASSERT_EQ(5 + 97 + 10 + 1, res.int_val);
+  ASSERT(b->program != NULL);
+
+  /* Text that does not compile is not compiled again */
+  ASSERT_EQ(0, pp_add_macro(&ctx, "C", "int x"));
+  ASSERT_NEQ(0, cdd_macro_value(&ctx, &ctx.macros[1], &res));
+  ASSERT_EQ(1, ctx.macros[1].program_failed);
+  ASSERT(ctx.macros[1].program == NULL);
+
+  pp_context_free(&ctx);
+  PASS();
+}
+
 SUITE(preprocessor_macros_suite) {
 
   RUN_TEST(test_macro_evaluator_basic);
   RUN_TEST(test_macro_evaluator_all_ops);
   RUN_TEST(test_macro_evaluator_errors);
   RUN_TEST(test_macro_evaluator_uncovered);
+  RUN_TEST(test_macro_evaluator_compiled);
+  RUN_TEST(test_macro_value_memo);
+  RUN_TEST(test_macro_value_program_kept);
   RUN_TEST(test_pp_define_object_like);
   RUN_TEST(test_pp_define_function_like);
   RUN_TEST(test_pp_define_variadic_standard);
@@ -0,0 +1,256 @@
+#ifndef TEST_PROJECT_INDEX_H
+#define TEST_PROJECT_INDEX_H
+
+/* clang-format off */
+#include "../cdd_test_helpers/cdd_helpers.h"
+#include "functions/parse/fs.h"
+#include "functions/parse/orchestrator.h"
+#include "functions/parse/project_index.h"
+#include <greatest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
+/* clang-format on */
+
+extern int g_project_index_alloc_fail;
+
+#define PIDX_DIR "test_project_index_dir"
+#define PIDX_FILE "test_project_index.idx"
+
+static const char *pidx_a_c =
+    "#include <stdlib.h>\n"
+    "#include \"a.h\"\n"
+    "char *make_buf(void) {\n"
+    "  return malloc(4);\n"
+    "}\n"
+    "static void helper(void) { }\n";
+
+static const char *pidx_a_h =
+    "#ifndef A_H\n"
+    "#define A_H\n"
+    "typedef struct Foo { int x; } Foo, *FooPtr;\n"
+    "typedef int (*cb_t)(int);\n"
+    "extern char *make_buf(void);\n"
+    "#endif\n";
+
+static const char *pidx_b_c =
+    "#include \"a.h\"\n"
+    "int use(void) {\n"
+    "  char *p = make_buf();\n"
+    "  helper();\n"
+    "  return p != 0;\n"
+    "}\n";
+
+static void pidx_cleanup(void) {
+  remove(PIDX_DIR "/a.c");
+  remove(PIDX_DIR "/a.h");
+  remove(PIDX_DIR "/b.c");
+  remove(PIDX_FILE);
+#if defined(_WIN32)
+  _rmdir(PIDX_DIR);
+#else
+  rmdir(PIDX_DIR);
+#endif
+}
+
+static int pidx_setup(void) {
+  pidx_cleanup();
+  makedir(PIDX_DIR);
+  return write_to_file(PIDX_DIR "/a.c", pidx_a_c) ||
+         write_to_file(PIDX_DIR "/a.h", pidx_a_h) ||
+         write_to_file(PIDX_DIR "/b.c", pidx_b_c);
+}
+
+TEST test_project_index_query(void) {
+  struct ProjectIndexStats stats;
+  struct ProjectIndex idx;
+  struct ProjectIndexName name;
+  struct ProjectIndexSymbol sym;
+  size_t i;
+  int saw_def = 0, saw_proto = 0;
+
+  ASSERT_EQ(0, pidx_setup());
+  ASSERT_EQ(0, project_index_update(PIDX_DIR, PIDX_FILE, &stats));
+  ASSERT_EQ(3, stats.files);
+  ASSERT_EQ(3, stats.parsed);
+  ASSERT_EQ(0, stats.reused);
+  ASSERT_EQ(0, project_index_open(PIDX_FILE, &idx));
+
+  ASSERT_EQ(0, project_index_find(&idx, "make_buf", 8, &name));
+  ASSERT_EQ(2, name.n_symbols);
+  for (i = 0; i < name.n_symbols; i++) {
+    ASSERT_EQ(0, project_index_symbol_of(&idx, &name, i, &sym));
+    ASSERT_STR_EQ("char *", sym.return_type);
+    ASSERT(sym.flags & PROJECT_INDEX_RETURNS_PTR);
+    if (sym.kind == PROJECT_INDEX_FUNCTION) {
+      saw_def = 1;
+      ASSERT(sym.flags & PROJECT_INDEX_ALLOCATES);
+      ASSERT_EQ(3, sym.line);
+      ASSERT(strstr(sym.file, "a.c") != NULL);
+    } else {
+      saw_proto = 1;
+      ASSERT_EQ(PROJECT_INDEX_PROTOTYPE, sym.kind);
+      ASSERT(strstr(sym.file, "a.h") != NULL);
+    }
+  }
+  ASSERT(saw_def && saw_proto);
+
+  /* Callers are function definitions, even across files */
+  ASSERT_EQ(1, name.n_callers);
+  ASSERT_EQ(0, project_index_caller_of(&idx, &name, 0, &sym));
+  ASSERT_STR_EQ("use", sym.name);
+  ASSERT(strstr(sym.file, "b.c") != NULL);
+
+  ASSERT_EQ(0, project_index_find(&idx, "helper", 6, &name));
+  ASSERT_EQ(0, project_index_symbol_of(&idx, &name, 0, &sym));
+  ASSERT(sym.flags & PROJECT_INDEX_STATIC);
+  ASSERT(sym.flags & PROJECT_INDEX_RETURNS_VOID);
+  ASSERT_STR_EQ("void", sym.return_type);
+
+  ASSERT_EQ(0, project_index_find(&idx, "Foo", 3, &name));
+  ASSERT_EQ(0, project_index_symbol_of(&idx, &name, 0, &sym));
+  ASSERT_EQ(PROJECT_INDEX_TYPEDEF, sym.kind);
+  ASSERT_EQ(0, project_index_find(&idx, "FooPtr", 6, &name));
+  ASSERT_EQ(0, project_index_find(&idx, "cb_t", 4, &name));
+  ASSERT_EQ(1, name.n_symbols);
+  ASSERT_EQ(CDD_C_ERROR_NOT_FOUND,
+            project_index_find(&idx, "malloc_x", 8, &name));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            project_index_symbol(&idx, idx.n_symbols, &sym));
+
+  project_index_close(&idx);
+  pidx_cleanup();
+  PASS();
+}
+
+TEST test_project_index_incremental(void) {
+  struct ProjectIndexStats stats;
+  struct ProjectIndex idx;
+  struct ProjectIndexName name;
+
+  ASSERT_EQ(0, pidx_setup());
+  ASSERT_EQ(0, project_index_update(PIDX_DIR, PIDX_FILE, &stats));
+
+  /* Nothing changed: nothing is reparsed */
+  ASSERT_EQ(0, project_index_update(PIDX_DIR, PIDX_FILE, &stats));
+  ASSERT_EQ(0, stats.parsed);
+  ASSERT_EQ(3, stats.reused);
+
+  /* One file changed: only it is reparsed, the others keep their facts */
+  ASSERT_EQ(0, write_to_file(PIDX_DIR "/b.c",
+                             "int use(void) { return other(); }\n"));
+  ASSERT_EQ(0, project_index_update(PIDX_DIR, PIDX_FILE, &stats));
+  ASSERT_EQ(1, stats.parsed);
+  ASSERT_EQ(2, stats.reused);
+  ASSERT_EQ(0, project_index_open(PIDX_FILE, &idx));
+  ASSERT_EQ(0, project_index_find(&idx, "make_buf", 8, &name));
+  ASSERT_EQ(2, name.n_symbols);
+  ASSERT_EQ(0, name.n_callers);
+  ASSERT_EQ(0, project_index_find(&idx, "other", 5, &name));
+  ASSERT_EQ(1, name.n_callers);
+  project_index_close(&idx);
+
+  /* A deleted file drops out */
+  remove(PIDX_DIR "/a.h");
+  ASSERT_EQ(0, project_index_update(PIDX_DIR, PIDX_FILE, &stats));
+  ASSERT_EQ(2, stats.files);
+  ASSERT_EQ(1, stats.removed);
+  ASSERT_EQ(0, stats.parsed);
+
+  /* A damaged index is rejected, then rebuilt */
+  ASSERT_EQ(0, write_to_file(PIDX_FILE, "CDDPIDX"));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, project_index_open(PIDX_FILE, &idx));
+  ASSERT_EQ(0, project_index_update(PIDX_DIR, PIDX_FILE, &stats));
+  ASSERT_EQ(2, stats.parsed);
+
+  pidx_cleanup();
+  PASS();
+}
+
+TEST test_project_index_cross_file_fix(void) {
+  struct ProjectIndex idx;
+  struct ProjectIndexName name;
+  struct ProjectIndexSymbol use, proto;
+  struct FixProject project;
+  char *out = NULL;
+  size_t i;
+
+  ASSERT_EQ(0, pidx_setup());
+  ASSERT_EQ(0, project_index_update(PIDX_DIR, PIDX_FILE, NULL));
+  ASSERT_EQ(0, project_index_open(PIDX_FILE, &idx));
+  ASSERT_EQ(0, fix_project_init(&project, &idx));
+
+  /* `use` only calls the allocating function from another file */
+  ASSERT_EQ(0, project_index_find(&idx, "use", 3, &name));
+  ASSERT_EQ(0, project_index_symbol_of(&idx, &name, 0, &use));
+  ASSERT_EQ(1, project.marked[use.id]);
+
+  /* Alone, b.c has nothing to fix */
+  ASSERT_EQ(0, orchestrate_fix(pidx_b_c, &out));
+  ASSERT(strstr(out, "make_buf();") != NULL);
+  free(out);
+
+  /* With the project, the call is rewritten to the new signature */
+  ASSERT_EQ(0, orchestrate_fix_in_project(pidx_b_c, use.file, &project, &out));
+  ASSERT(strstr(out, "make_buf(&") != NULL);
+  ASSERT(strstr(out, "helper();") != NULL);
+  free(out);
+
+  /* The shared header's prototype follows the rewritten definition */
+  ASSERT_EQ(0, project_index_find(&idx, "make_buf", 8, &name));
+  for (i = 0; i < name.n_symbols; i++) {
+    ASSERT_EQ(0, project_index_symbol_of(&idx, &name, i, &proto));
+    if (proto.kind == PROJECT_INDEX_PROTOTYPE)
+      break;
+  }
+  ASSERT(i < name.n_symbols);
+  ASSERT_EQ(0, orchestrate_fix_in_project(pidx_a_h, proto.file, &project,
+                                          &out));
+  ASSERT(strstr(out, "make_buf(void)") == NULL);
+  ASSERT(strstr(out, "(int);\nextern int make_buf(") != NULL);
+  ASSERT(strstr(out, "*out);\n#endif\n") != NULL);
+  free(out);
+
+  /* Without the project the header is left alone */
+  ASSERT_EQ(0, orchestrate_fix(pidx_a_h, &out));
+  ASSERT(strstr(out, "extern char *make_buf(void);") != NULL);
+  free(out);
+
+  fix_project_free(&project);
+  project_index_close(&idx);
+  pidx_cleanup();
+  PASS();
+}
+
+TEST test_project_index_oom(void) {
+  struct ProjectIndexStats stats;
+  int k, rc;
+
+  ASSERT_EQ(0, pidx_setup());
+  /* Fail each allocation in turn; the old index must survive every one */
+  for (k = 1; k < 64; k++) {
+    g_project_index_alloc_fail = k;
+    rc = project_index_update(PIDX_DIR, PIDX_FILE, &stats);
+    ASSERT(rc == CDD_C_SUCCESS || rc == CDD_C_ERROR_MEMORY);
+  }
+  g_project_index_alloc_fail = 0;
+  ASSERT_EQ(0, project_index_update(PIDX_DIR, PIDX_FILE, &stats));
+  ASSERT_EQ(3, stats.files);
+
+  pidx_cleanup();
+  PASS();
+}
+
+SUITE(project_index_suite) {
+  RUN_TEST(test_project_index_query);
+  RUN_TEST(test_project_index_incremental);
+  RUN_TEST(test_project_index_cross_file_fix);
+  RUN_TEST(test_project_index_oom);
+}
+
+#endif /* TEST_PROJECT_INDEX_H */
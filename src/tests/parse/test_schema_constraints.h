@@ -782,11 +782,11 @@ TEST test_schema_constraints_free_branch(void) {
   /* Mock additional properties */
   sc.additional_properties = calloc(1, sizeof(*sc.additional_properties));
   sc.additional_properties->name = malloc(4);
-  strcpy(sc.additional_properties->name, "foo");
+  sc.additional_properties->name = "foo";
   sc.additional_properties->type = malloc(4);
-  strcpy(sc.additional_properties->type, "bar");
+  sc.additional_properties->type = "bar";
   sc.additional_properties->ref = malloc(4);
-  strcpy(sc.additional_properties->ref, "baz");
+  sc.additional_properties->ref = "baz";
 
   schema_constraints_free(&sc);
 
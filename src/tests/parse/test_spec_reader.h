@@ -0,0 +1,277 @@
+/**
+ * @file test_spec_reader.h
+ * @brief Unit tests for the event-driven JSON/YAML spec reader.
+ */
+
+#ifndef TEST_SPEC_READER_H
+#define TEST_SPEC_READER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include "c_cdd_export.h"
+#include "cdd_c_error.h"
+#include <greatest.h>
+#include <parson.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cdd_test_helpers/cdd_helpers.h"
+#include "openapi/parse/openapi.h"
+#include "openapi/parse/spec_reader.h"
+/* clang-format on */
+
+/**
+ * @brief Records the location of every KEY event named "b".
+ */
+static cdd_c_error_t test_spec_reader_find_b(void *user_data,
+                                             const struct SpecEvent *ev) {
+  size_t *loc = (size_t *)user_data;
+  if (ev->kind == SPEC_EVENT_KEY && strcmp(ev->text, "b") == 0) {
+    loc[0] = ev->line;
+    loc[1] = ev->column;
+  }
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Tests that events carry source positions in both syntaxes.
+ *
+ * @return The result of the test.
+ */
+TEST test_spec_reader_event_locations(void) {
+  const char *json = "{\n  \"a\": 1,\n   \"b\": [true]\n}";
+  const char *yaml = "a: 1\nc:\n    b: [true]\n";
+  size_t loc[2] = {0, 0};
+
+  ASSERT_EQ(CDD_C_SUCCESS,
+            spec_reader_scan(json, strlen(json), SPEC_FORMAT_AUTO,
+                             test_spec_reader_find_b, loc, NULL));
+  ASSERT_EQ(3, loc[0]);
+  ASSERT_EQ(4, loc[1]);
+
+  ASSERT_EQ(CDD_C_SUCCESS,
+            spec_reader_scan(yaml, strlen(yaml), SPEC_FORMAT_AUTO,
+                             test_spec_reader_find_b, loc, NULL));
+  ASSERT_EQ(3, loc[0]);
+  ASSERT_EQ(5, loc[1]);
+  PASS();
+}
+
+/**
+ * @brief Tests that a YAML document and its JSON equivalent parse alike.
+ *
+ * @return The result of the test.
+ */
+TEST test_spec_reader_yaml_matches_json(void) {
+  const char *yaml =
+      "# comment\n"
+      "openapi: 3.1.0\n"
+      "info:\n"
+      "  title: 'Pet''s API'\n"
+      "  version: \"1.0\"\n"
+      "  description: |\n"
+      "    Line one\n"
+      "      indented\n"
+      "  summary: >-\n"
+      "    folded\n"
+      "    text\n"
+      "tags: [a, {name: b}]\n"
+      "paths:\n"
+      "  /pets:\n"
+      "    get:\n"
+      "      parameters:\n"
+      "      - name: limit\n"
+      "        in: query\n"
+      "        required: false\n"
+      "      responses:\n"
+      "        200:\n"
+      "          description: ok\n"
+      "x-empty:\n"
+      "x-nums: [0x10, -1.5e1, ~, TRUE, 12abc]\n";
+  const char *json =
+      "{\"openapi\":\"3.1.0\",\"info\":{\"title\":\"Pet's API\","
+      "\"version\":\"1.0\",\"description\":\"Line one\\n  indented\\n\","
+      "\"summary\":\"folded text\"},\"tags\":[\"a\",{\"name\":\"b\"}],"
+      "\"paths\":{\"/pets\":{\"get\":{\"parameters\":[{\"name\":\"limit\","
+      "\"in\":\"query\",\"required\":false}],\"responses\":{\"200\":"
+      "{\"description\":\"ok\"}}}}},\"x-empty\":null,"
+      "\"x-nums\":[16,-15,null,true,\"12abc\"]}";
+  JSON_Value *from_yaml = NULL;
+  JSON_Value *from_json = NULL;
+  JSON_Value *expected = json_parse_string(json);
+
+  ASSERT(expected != NULL);
+  ASSERT_EQ(CDD_C_SUCCESS, spec_reader_parse(yaml, strlen(yaml),
+                                             SPEC_FORMAT_YAML, &from_yaml,
+                                             NULL));
+  ASSERT_EQ(CDD_C_SUCCESS, spec_reader_parse(json, strlen(json),
+                                             SPEC_FORMAT_JSON, &from_json,
+                                             NULL));
+  ASSERT(json_value_equals(expected, from_yaml));
+  ASSERT(json_value_equals(expected, from_json));
+
+  json_value_free(expected);
+  json_value_free(from_yaml);
+  json_value_free(from_json);
+  PASS();
+}
+
+/**
+ * @brief Tests that syntax errors report their line and column.
+ *
+ * @return The result of the test.
+ */
+TEST test_spec_reader_error_locations(void) {
+  struct SpecReadError err;
+  JSON_Value *val = NULL;
+  const char *bad_json = "{\"a\": 1,\n  \"b\": [1 2]}";
+  const char *bad_indent = "a: 1\n  b: 2\n";
+  const char *dup = "{\"a\": 1, \"a\": 2}";
+  const char *anchor = "a: &x 1\n";
+
+  ASSERT_EQ(CDD_C_ERROR_PARSE,
+            spec_reader_parse(bad_json, strlen(bad_json), SPEC_FORMAT_AUTO,
+                              &val, &err));
+  ASSERT(val == NULL);
+  ASSERT_EQ(2, err.line);
+  ASSERT_EQ(11, err.column);
+
+  ASSERT_EQ(CDD_C_ERROR_PARSE,
+            spec_reader_parse(bad_indent, strlen(bad_indent),
+                              SPEC_FORMAT_YAML, &val, &err));
+  ASSERT_EQ(2, err.line);
+  ASSERT_EQ(3, err.column);
+
+  ASSERT_EQ(CDD_C_ERROR_PARSE, spec_reader_parse(dup, strlen(dup),
+                                                 SPEC_FORMAT_JSON, &val, &err));
+  ASSERT_STR_EQ("duplicate key", err.message);
+  ASSERT_EQ(10, err.column);
+
+  ASSERT_EQ(CDD_C_ERROR_PARSE,
+            spec_reader_parse(anchor, strlen(anchor), SPEC_FORMAT_YAML, &val,
+                              &err));
+  ASSERT_EQ(4, err.column);
+  PASS();
+}
+
+/**
+ * @brief Tests loading an OpenAPI document from a YAML file.
+ *
+ * @return The result of the test.
+ */
+TEST test_spec_reader_load_yaml_file(void) {
+  struct OpenAPI_Spec spec;
+  struct SpecReadError err;
+
+  ASSERT_EQ(0, write_to_file("test_spec_reader.yaml",
+                             "openapi: 3.0.0\n"
+                             "info:\n"
+                             "  title: Pets\n"
+                             "  version: '1'\n"
+                             "paths:\n"
+                             "  /pets:\n"
+                             "    get:\n"
+                             "      operationId: listPets\n"
+                             "      responses:\n"
+                             "        '200':\n"
+                             "          description: ok\n"));
+  openapi_spec_init(&spec);
+  ASSERT_EQ(CDD_C_SUCCESS,
+            spec_reader_load_file("test_spec_reader.yaml", &spec, &err));
+  ASSERT_EQ(1, spec.n_paths);
+  ASSERT_STR_EQ("/pets", spec.paths[0].route);
+  ASSERT_STR_EQ("Pets", spec.info.title);
+  openapi_spec_free(&spec);
+  remove("test_spec_reader.yaml");
+
+  ASSERT(spec_reader_parse_file("test_spec_reader_missing.yaml", NULL,
+                                &err) != 0);
+  PASS();
+}
+
+/**
+ * @brief Tests loading paths and webhooks one Path Item at a time.
+ *
+ * `paths` comes before `components` here, so Path Item `$ref`s must still
+ * resolve against components read later in the file.
+ *
+ * @return The result of the test.
+ */
+TEST test_spec_reader_load_streams_paths(void) {
+  struct OpenAPI_Spec spec;
+  struct SpecReadError err;
+
+  ASSERT_EQ(0, write_to_file(
+                   "test_spec_reader_stream.json",
+                   "{\"openapi\": \"3.1.0\",\n"
+                   " \"info\": {\"title\": \"S\", \"version\": \"1\"},\n"
+                   " \"paths\": {\n"
+                   "  \"x-ext\": true,\n"
+                   "  \"/pets\": {\"get\": {\"operationId\": \"listPets\",\n"
+                   "   \"parameters\": [{\"$ref\": "
+                   "\"#/components/parameters/Limit\"}],\n"
+                   "   \"responses\": {\"200\": {\"description\": \"ok\"}}}},\n"
+                   "  \"/pets/{id}\": {\"get\": {\"operationId\": \"getPet\",\n"
+                   "   \"parameters\": [{\"name\": \"id\", \"in\": \"path\",\n"
+                   "    \"required\": true, \"schema\": {\"type\": "
+                   "\"string\"}}],\n"
+                   "   \"responses\": {\"200\": {\"description\": "
+                   "\"ok\"}}}}},\n"
+                   " \"webhooks\": {\"newPet\": {\"post\": {\"operationId\": "
+                   "\"newPet\",\n"
+                   "   \"responses\": {\"200\": {\"description\": "
+                   "\"ok\"}}}}},\n"
+                   " \"components\": {\"parameters\": {\"Limit\": {\"name\": "
+                   "\"limit\",\n"
+                   "   \"in\": \"query\", \"schema\": {\"type\": "
+                   "\"integer\"}}}}}\n"));
+  openapi_spec_init(&spec);
+  ASSERT_EQ(CDD_C_SUCCESS,
+            spec_reader_load_file("test_spec_reader_stream.json", &spec, &err));
+  ASSERT_EQ(2, spec.n_paths);
+  ASSERT_STR_EQ("/pets", spec.paths[0].route);
+  ASSERT_STR_EQ("listPets", spec.paths[0].operations[0].operation_id);
+  ASSERT_EQ(1, spec.paths[0].operations[0].n_parameters);
+  ASSERT_STR_EQ("limit", spec.paths[0].operations[0].parameters[0].name);
+  ASSERT_STR_EQ("/pets/{id}", spec.paths[1].route);
+  ASSERT_EQ(1, spec.n_webhooks);
+  ASSERT_STR_EQ("newPet", spec.webhooks[0].route);
+  ASSERT(spec.paths_extensions_json != NULL);
+  ASSERT(strstr(spec.paths_extensions_json, "x-ext") != NULL);
+  openapi_spec_free(&spec);
+
+  /* Duplicate routes are still reported where they occur */
+  ASSERT_EQ(0, write_to_file("test_spec_reader_stream.json",
+                             "{\"openapi\": \"3.1.0\",\n"
+                             " \"info\": {\"title\": \"S\", \"version\": "
+                             "\"1\"},\n"
+                             " \"paths\": {\n"
+                             "  \"/a\": {},\n"
+                             "  \"/a\": {}}}\n"));
+  openapi_spec_init(&spec);
+  ASSERT_EQ(CDD_C_ERROR_PARSE,
+            spec_reader_load_file("test_spec_reader_stream.json", &spec, &err));
+  ASSERT_STR_EQ("duplicate key", err.message);
+  ASSERT_EQ(5, err.line);
+  openapi_spec_free(&spec);
+  remove("test_spec_reader_stream.json");
+  PASS();
+}
+
+SUITE(spec_reader_suite) {
+  RUN_TEST(test_spec_reader_event_locations);
+  RUN_TEST(test_spec_reader_yaml_matches_json);
+  RUN_TEST(test_spec_reader_error_locations);
+  RUN_TEST(test_spec_reader_load_yaml_file);
+  RUN_TEST(test_spec_reader_load_streams_paths);
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TEST_SPEC_READER_H */
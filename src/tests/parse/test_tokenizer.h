@@ -219,6 +219,48 @@ TEST tokenize_digit_separator_edge_case(void) {
   PASS();
 }
 
+TEST tokenize_line_positions(void) {
+  const az_span code = AZ_SPAN_FROM_STR("int a;\n\n  long b;\nc");
+  struct TokenList *tl = NULL;
+  struct TokenList manual;
+  size_t line = 0, col = 0;
+  size_t i;
+
+  ASSERT_EQ(0, tokenize(code, &tl));
+  ASSERT(tl->line_starts != NULL);
+  ASSERT_EQ(4, tl->n_lines);
+
+  for (i = 0; i < tl->size; ++i) {
+    int is_long = 0;
+    ASSERT_EQ(0, token_matches_string(&tl->tokens[i], "long", &is_long));
+    if (is_long)
+      break;
+  }
+  ASSERT(i < tl->size);
+  ASSERT_EQ(0, token_list_position(tl, tl->tokens[i].start, &line, &col));
+  ASSERT_EQ(3, line);
+  ASSERT_EQ(3, col);
+
+  ASSERT_EQ(0, token_list_position(tl, tl->tokens[tl->size - 1].start, &line,
+                                   &col));
+  ASSERT_EQ(4, line);
+  ASSERT_EQ(1, col);
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT,
+            token_list_position(tl, tl->source + tl->source_len + 1, &line,
+                               &col));
+
+  /* Lists built by hand have no index and are scanned instead */
+  memset(&manual, 0, sizeof(manual));
+  manual.tokens = tl->tokens;
+  manual.size = tl->size;
+  ASSERT_EQ(0, token_list_position(&manual, tl->tokens[i].start, &line, &col));
+  ASSERT_EQ(3, line);
+  ASSERT_EQ(3, col);
+
+  free_token_list(tl);
+  PASS();
+}
+
 SUITE(tokenizer_suite) {
   RUN_TEST(tokenize_all_tokens);
   /* Use explicit forward declarations or macro magic if needed, or update this
@@ -227,6 +269,7 @@ SUITE(tokenizer_suite) {
   RUN_TEST(tokenize_c23_digit_separators);
   RUN_TEST(tokenize_digit_separator_edge_case);
   RUN_TEST(test_tokenizer_error_handling);
+  RUN_TEST(tokenize_line_positions);
 }
 
 #ifdef __cplusplus
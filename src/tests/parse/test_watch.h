@@ -0,0 +1,253 @@
+/**
+ * @file test_watch.h
+ * @brief Unit tests for the `watch` command's regeneration logic.
+ */
+
+#ifndef TEST_WATCH_H
+#define TEST_WATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* clang-format off */
+#include "c_cdd_export.h"
+#include <greatest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "cdd_test_helpers/cdd_helpers.h"
+#include "functions/parse/fs.h"
+#include "routes/parse/watch.h"
+/* clang-format on */
+
+/**
+ * @brief Directory walker deleting every generated file.
+ */
+static cdd_c_error_t test_watch_remove_cb(const char *path, void *user_data) {
+  (void)user_data;
+  remove(path);
+  return CDD_C_SUCCESS;
+}
+
+/**
+ * @brief Deletes a directory of generated files.
+ */
+static void test_watch_remove_dir(const char *dir) {
+  (void)walk_directory(dir, test_watch_remove_cb, NULL);
+#if defined(_WIN32)
+  _rmdir(dir);
+#else
+  rmdir(dir);
+#endif
+}
+
+/**
+ * @brief Tests argument validation and `--help`.
+ *
+ * @return The result of the test.
+ */
+TEST test_watch_cli_args(void) {
+  char *argv_help[] = {"watch", "--help"};
+  char *argv_none[] = {"watch"};
+  char *argv_bad[] = {"watch", "--sync", "only_header.h"};
+  char *argv_sdk[] = {"watch", "--sdk", "out_dir"};
+
+  ASSERT_EQ(CDD_C_SUCCESS, watch_cli_main(2, argv_help));
+  ASSERT_EQ(CDD_C_ERROR_UNKNOWN, watch_cli_main(1, argv_none));
+  ASSERT_EQ(CDD_C_ERROR_UNKNOWN, watch_cli_main(3, argv_bad));
+  ASSERT_EQ(CDD_C_ERROR_UNKNOWN, watch_cli_main(3, argv_sdk));
+  ASSERT_EQ(CDD_C_ERROR_INVALID_ARGUMENT, watch_session_init(NULL, NULL));
+  PASS();
+}
+
+/**
+ * @brief Tests that only the sync pairs whose header changed are rerun.
+ *
+ * @return The result of the test.
+ */
+TEST test_watch_rebuild_affected_sync_pairs(void) {
+  struct WatchSyncPair pairs[2];
+  struct WatchConfig cfg = {0};
+  struct WatchSession session;
+  const char *unrelated[] = {"unrelated.h"};
+  const char *own_output[] = {"test_watch_a.c"};
+  const char *header_b[] = {"./test_watch_b.h"};
+  FILE *f;
+
+  ASSERT_EQ(0, write_to_file("test_watch_a.h", "struct A { int x; };\n"));
+  ASSERT_EQ(0, write_to_file("test_watch_b.h", "enum B { B_ONE };\n"));
+  pairs[0].header = "test_watch_a.h";
+  pairs[0].impl = "test_watch_a.c";
+  pairs[1].header = "test_watch_b.h";
+  pairs[1].impl = "test_watch_b.c";
+  cfg.sync_pairs = pairs;
+  cfg.n_sync_pairs = 2;
+
+  ASSERT_EQ(CDD_C_SUCCESS, watch_session_init(&session, &cfg));
+
+  /* Startup regenerates every pair */
+  ASSERT_EQ(CDD_C_SUCCESS, watch_session_rebuild(&session, NULL, 0));
+  ASSERT_EQ(2, session.n_runs);
+
+  /* Unrelated paths and the watcher's own outputs trigger nothing */
+  ASSERT_EQ(CDD_C_SUCCESS, watch_session_rebuild(&session, unrelated, 1));
+  ASSERT_EQ(CDD_C_SUCCESS, watch_session_rebuild(&session, own_output, 1));
+  ASSERT_EQ(2, session.n_runs);
+
+  /* Touching one header reruns only its pair */
+  remove("test_watch_a.c");
+  remove("test_watch_b.c");
+  ASSERT_EQ(CDD_C_SUCCESS, watch_session_rebuild(&session, header_b, 1));
+  ASSERT_EQ(3, session.n_runs);
+#if defined(_MSC_VER)
+  if (fopen_s(&f, "test_watch_a.c", "r") != 0)
+    f = NULL;
+#else
+  f = fopen("test_watch_a.c", "r");
+#endif
+  ASSERT(f == NULL);
+#if defined(_MSC_VER)
+  if (fopen_s(&f, "test_watch_b.c", "r") != 0)
+    f = NULL;
+#else
+  f = fopen("test_watch_b.c", "r");
+#endif
+  ASSERT(f != NULL);
+  fclose(f);
+
+  watch_session_free(&session);
+  remove("test_watch_a.h");
+  remove("test_watch_b.h");
+  remove("test_watch_b.c");
+  PASS();
+}
+
+/**
+ * @brief Tests that the SDK is only regenerated when the spec bytes change.
+ *
+ * @return The result of the test.
+ */
+TEST test_watch_rebuild_sdk_on_spec_change(void) {
+  struct WatchConfig cfg = {0};
+  struct WatchSession session;
+  const char *spec_changed[] = {"test_watch_spec.json"};
+
+  ASSERT_EQ(0, write_to_file("test_watch_spec.json",
+                             "{\"openapi\": \"3.0.0\", \"info\": {\"title\": "
+                             "\"A\", \"version\": \"1\"}, \"paths\": {}}"));
+  cfg.spec_file = "test_watch_spec.json";
+  cfg.sdk_dir = "test_watch_sdk";
+  ASSERT_EQ(CDD_C_SUCCESS, watch_session_init(&session, &cfg));
+
+  ASSERT_EQ(CDD_C_SUCCESS, watch_session_rebuild(&session, NULL, 0));
+  ASSERT_EQ(1, session.n_runs);
+
+  /* Saved without changes: nothing to regenerate */
+  ASSERT_EQ(CDD_C_SUCCESS, watch_session_rebuild(&session, spec_changed, 1));
+  ASSERT_EQ(1, session.n_runs);
+
+  ASSERT_EQ(0, write_to_file("test_watch_spec.json",
+                             "{\"openapi\": \"3.0.0\", \"info\": {\"title\": "
+                             "\"B\", \"version\": \"1\"}, \"paths\": {}}"));
+  ASSERT_EQ(CDD_C_SUCCESS, watch_session_rebuild(&session, spec_changed, 1));
+  ASSERT_EQ(2, session.n_runs);
+
+  watch_session_free(&session);
+  remove("test_watch_spec.json");
+  test_watch_remove_dir("test_watch_sdk");
+  PASS();
+}
+
+/**
+ * @brief Tests that notifications go only to the configured stream.
+ *
+ * @return The result of the test.
+ */
+TEST test_watch_rpc_stream(void) {
+  struct WatchSyncPair pair;
+  struct WatchConfig cfg = {0};
+  struct WatchSession session;
+  char *log = NULL;
+  size_t log_sz = 0;
+  const char *line;
+
+  ASSERT_EQ(0, write_to_file("test_watch_rpc.h", "struct R { int x; };\n"));
+  pair.header = "test_watch_rpc.h";
+  pair.impl = "test_watch_rpc.c";
+  cfg.sync_pairs = &pair;
+  cfg.n_sync_pairs = 1;
+  cfg.json_rpc = 1;
+#if defined(_MSC_VER)
+  if (fopen_s(&cfg.rpc_out, "test_watch_rpc.jsonl", "w") != 0)
+    cfg.rpc_out = NULL;
+#else
+  cfg.rpc_out = fopen("test_watch_rpc.jsonl", "w");
+#endif
+  ASSERT(cfg.rpc_out != NULL);
+
+  ASSERT_EQ(CDD_C_SUCCESS, watch_session_init(&session, &cfg));
+  ASSERT_EQ(CDD_C_SUCCESS, watch_session_rebuild(&session, NULL, 0));
+  watch_session_free(&session);
+  fclose(cfg.rpc_out);
+
+  ASSERT_EQ(0, read_to_file("test_watch_rpc.jsonl", "r", &log, &log_sz));
+  ASSERT(strstr(log, "\"method\":\"watch/regenerated\"") != NULL);
+  /* Every line is a notification; step output went elsewhere */
+  for (line = log; *line; line = strchr(line, '\n') + 1) {
+    ASSERT_EQ(0, strncmp(line, "{\"jsonrpc\":\"2.0\"", 17));
+    ASSERT(strchr(line, '\n') != NULL);
+  }
+  free(log);
+  remove("test_watch_rpc.jsonl");
+  remove("test_watch_rpc.h");
+  remove("test_watch_rpc.c");
+  PASS();
+}
+
+/**
+ * @brief Tests `--once` regenerating the spec from a source tree.
+ *
+ * @return The result of the test.
+ */
+TEST test_watch_cli_once(void) {
+  char *argv[] = {"watch",
+                  "-i",
+                  "src/tests/mocks",
+                  "-o",
+                  "test_watch_out.json",
+                  "--cache-dir",
+                  "test_watch_cache",
+                  "--json-rpc",
+                  "--once"};
+  char *spec = NULL;
+  size_t spec_sz = 0;
+
+  ASSERT_EQ(CDD_C_SUCCESS, watch_cli_main(9, argv));
+  ASSERT_EQ(0, read_to_file("test_watch_out.json", "r", &spec, &spec_sz));
+  ASSERT(spec_sz > 0);
+  free(spec);
+  remove("test_watch_out.json");
+  test_watch_remove_dir("test_watch_cache");
+  PASS();
+}
+
+SUITE(watch_suite) {
+  RUN_TEST(test_watch_cli_args);
+  RUN_TEST(test_watch_rebuild_affected_sync_pairs);
+  RUN_TEST(test_watch_rebuild_sdk_on_spec_change);
+  RUN_TEST(test_watch_rpc_stream);
+  RUN_TEST(test_watch_cli_once);
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* TEST_WATCH_H */
@@ -179,6 +179,8 @@ static FILE *mock_tmpfile_fuzzer(void) {
 #include "ffi/test_ffi_e2e.h"
 #include "ffi/test_ffi_variadic.h"
 #include "ffi/test_ffi_emitters.h"
+#include "ffi/test_ffi_ir_cache.h"
+#include "ffi/test_ffi_layout.h"
 #include "parse/test_code2schema.h"
 #include "parse/test_crypto.h"
 #include "parse/test_cst_parser.h"
@@ -186,6 +188,8 @@ static FILE *mock_tmpfile_fuzzer(void) {
 #include "parse/test_cdd_cst.h"
 #include "parse/test_cdd_cst_mutate.h"
 #include "parse/test_cdd_cst_query.h"
+#include "parse/test_cdd_cst_pattern.h"
+#include "parse/test_cdd_cst_arena.h"
 #include "parse/test_cdd_cst_trivia.h"
 #include "transformers/extern_c/test_extern_c.h"
 #include "transformers/msvc_port/test_msvc_port.h"
@@ -209,10 +213,14 @@ static FILE *mock_tmpfile_fuzzer(void) {
 
 #include "parse/test_flexible_array.h"
 #include "parse/test_fs.h"
+#include "parse/test_parallel.h"
+#include "parse/test_watch.h"
 #include "parse/test_initializer_parser.h"
 #include "parse/test_json_from_and_to.h"
 #include "parse/test_numeric_parser.h"
 #include "parse/test_openapi_loader.h"
+#include "parse/test_json_fragment.h"
+#include "parse/test_spec_reader.h"
 #include "parse/test_parsing.h"
 #include "parse/test_pragma.h"
 #include "parse/test_preprocessor.h"
@@ -259,12 +267,16 @@ static FILE *mock_tmpfile_fuzzer(void) {
 #include "parse/test_cdd_cst_cfg.h"
 #include "parse/test_cdd_cst_type_eval.h"
 #include "parse/test_cdd_cst_cfg.h"
+#include "parse/test_cdd_cst_dataflow.h"
+#include "parse/test_project_index.h"
 #include "parse/test_cdd_cst_type_eval.h"
 
 #include "emit/test_aggregator.h"
 #include "emit/test_cli_gen.h"
 #include "emit/test_client_gui_gen.h"
 #include "emit/test_openapi_writer.h"
+#include "emit/test_spec_writer.h"
+#include "emit/test_line_diff.h"
 #include "emit/test_operation.h"
 #include "emit/test_server_gen.h"
 #include "emit/test_serve_json_rpc.h"
@@ -401,6 +413,7 @@ SUITE(ffi_extractor_suite) {
   RUN_TEST(test_ffi_ir_extract_stl_types);
   RUN_TEST(test_ffi_ir_extract_error_paths);
   RUN_TEST(test_ffi_ir_extract_array_out);
+  RUN_TEST(test_ffi_ir_extract_buffer_pairs);
   RUN_TEST(test_ffi_ir_extract_inheritance_casting);
   RUN_TEST(test_ffi_ir_extract_trampoline);
   RUN_TEST(test_ffi_ir_extract_exports_oom);
@@ -598,6 +611,9 @@ int main(int argc, char **argv) {
   reset_mocks();
   RUN_SUITE(fs_suite);
   reset_mocks();
+  RUN_SUITE(parallel_suite);
+  RUN_SUITE(watch_suite);
+  reset_mocks();
   RUN_SUITE(cdd_api_suite);
   reset_mocks();
   RUN_SUITE(decl_hoist_suite);
@@ -606,6 +622,10 @@ int main(int argc, char **argv) {
   reset_mocks();
   RUN_SUITE(cdd_cst_cfg_suite);
   reset_mocks();
+  RUN_SUITE(cdd_cst_dataflow_suite);
+  reset_mocks();
+  RUN_SUITE(project_index_suite);
+  reset_mocks();
   RUN_SUITE(tokenizer_suite);
   reset_mocks();
   RUN_SUITE(vcpkg_integration_suite);
@@ -668,6 +688,10 @@ int main(int argc, char **argv) {
   reset_mocks();
   RUN_SUITE(cdd_cst_query_suite);
   reset_mocks();
+  RUN_SUITE(cdd_cst_pattern_suite);
+  reset_mocks();
+  RUN_SUITE(cdd_cst_arena_suite);
+  reset_mocks();
   RUN_SUITE(preprocessor_suite);
   reset_mocks();
   RUN_SUITE(schema_constraints_suite);
@@ -675,6 +699,8 @@ int main(int argc, char **argv) {
   RUN_SUITE(cli_cst_suite);
   reset_mocks();
   RUN_SUITE(openapi_loader_suite);
+  RUN_SUITE(json_fragment_suite);
+  RUN_SUITE(spec_reader_suite);
   reset_mocks();
   RUN_SUITE(numeric_parser_suite);
   reset_mocks();
@@ -710,6 +736,10 @@ int main(int argc, char **argv) {
   reset_mocks();
   RUN_SUITE(ffi_emitters_suite);
   reset_mocks();
+  RUN_SUITE(ffi_ir_cache_suite);
+  reset_mocks();
+  RUN_SUITE(ffi_layout_suite);
+  reset_mocks();
   RUN_SUITE(cli_gen_suite);
   reset_mocks();
   RUN_SUITE(codegen_json_suite);
@@ -800,6 +830,8 @@ int main(int argc, char **argv) {
   RUN_SUITE(client_body_suite);
   reset_mocks();
   RUN_SUITE(openapi_writer_suite);
+  RUN_SUITE(spec_writer_suite);
+  RUN_SUITE(line_diff_suite);
   reset_mocks();
   RUN_SUITE(url_utils_suite);
   reset_mocks();
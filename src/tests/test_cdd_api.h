@@ -5,10 +5,13 @@
 #include "cdd_api.h"
 #include "functions/parse/fs.h"
 #include <greatest.h>
+#include <stdlib.h>
+#include <string.h>
 /* clang-format on */
 
 /* Moved extern declarations for C89 compliance */
 extern int g_cdd_ffi_ir_calloc_fail;
+extern int g_fail_io_after;
 
 #ifdef __cplusplus
 extern "C" {
@@ -171,6 +174,71 @@ TEST test_cdd_generate_bindings(void) {
   PASS();
 }
 
+TEST test_cdd_generate_bindings_parallel(void) {
+  cdd_generate_bindings_config_t config = {0};
+  char *content = NULL;
+  size_t content_len = 0;
+  int is_dir = 1;
+  FILE *f;
+
+  f = fopen("test_parallel_bindings.h", "w");
+  ASSERT(f != NULL);
+  fprintf(f, "struct Point { int x; };\nint add(int a, int b);\n");
+  fclose(f);
+
+  makedir("test_parallel_out");
+  makedir("test_parallel_out/.cdd-stage-rust");
+  f = fopen("test_parallel_out/.cdd-stage-rust/stale.txt", "w");
+  ASSERT(f != NULL);
+  fclose(f);
+
+  config.input = "test_parallel_bindings.h";
+  config.output_dir = "test_parallel_out";
+  config.target_langs = "python,rust,csharp,csharp-libraryimport";
+  config.jobs = 4;
+  config.stats = 1;
+  ASSERT_EQ(0, cdd_generate_bindings(&config));
+
+  ASSERT_EQ(0, read_to_file("test_parallel_out/cdd_bindings.py", "r",
+                            &content, &content_len));
+  free(content);
+  ASSERT_EQ(0, read_to_file("test_parallel_out/Cargo.toml", "r", &content,
+                            &content_len));
+  free(content);
+  /* Both C# modes write Bindings.cs; the later table entry wins */
+  ASSERT_EQ(0, read_to_file("test_parallel_out/Bindings.cs", "r", &content,
+                            &content_len));
+  ASSERT(strstr(content, "LibraryImport") != NULL);
+  free(content);
+
+  /* Staging directories, including stale ones, are gone */
+  ASSERT_EQ(0, fs_is_directory("test_parallel_out/.cdd-stage-rust", &is_dir));
+  ASSERT_EQ(0, is_dir);
+  ASSERT_EQ(0,
+            fs_is_directory("test_parallel_out/.cdd-stage-python", &is_dir));
+  ASSERT_EQ(0, is_dir);
+  f = fopen("test_parallel_out/stale.txt", "r");
+  ASSERT(f == NULL);
+
+  /* A failing emitter leaves the output directory untouched */
+  makedir("test_parallel_fail_out");
+  config.output_dir = "test_parallel_fail_out";
+  config.target_langs = "python,rust";
+  g_fail_io_after = 1;
+  ASSERT_NEQ(0, cdd_generate_bindings(&config));
+  g_fail_io_after = -1;
+  f = fopen("test_parallel_fail_out/cdd_bindings.py", "r");
+  ASSERT(f == NULL);
+  f = fopen("test_parallel_fail_out/Cargo.toml", "r");
+  ASSERT(f == NULL);
+  ASSERT_EQ(0, fs_is_directory("test_parallel_fail_out/.cdd-stage-python",
+                               &is_dir));
+  ASSERT_EQ(0, is_dir);
+
+  remove("test_parallel_bindings.h");
+  PASS();
+}
+
 SUITE(cdd_api_suite) {
   RUN_TEST(test_cdd_generate_from_openapi);
   RUN_TEST(test_cdd_generate_to_openapi);
@@ -178,6 +246,7 @@ SUITE(cdd_api_suite) {
   RUN_TEST(test_cdd_serve_json_rpc);
   RUN_TEST(test_bin_cdd);
   RUN_TEST(test_cdd_generate_bindings);
+  RUN_TEST(test_cdd_generate_bindings_parallel);
 }
 
 #ifdef __cplusplus
@@ -6,7 +6,12 @@
 #include "cdd_cst_transform.h"
 #include "greatest.h"
 #include "c_cdd/format_specifiers.h"
+#include "classes/emit/cdd_cst_emit.h"
+#include "functions/parse/project_index.h"
+#include "../../cdd_test_helpers/cdd_helpers.h"
 #include <errno.h>
+#include <stdio.h>
+#include <string.h>
 /* clang-format on */
 
 /* Moved extern declarations for C89 compliance */
@@ -413,12 +418,43 @@ TEST test_cdd_transform_percolate_errors_oom(void) {
 /**
  * @brief Error percolator transformer test suite.
  */
+TEST test_cdd_transform_percolate_errors_project_index(void) {
+  cdd_cst_tree_t *tree = NULL;
+  struct ProjectIndex idx;
+  char *out = NULL;
+  const char *code = "int use(void) { make_obj(); keep(); return 0; }\n";
+  cdd_transform_config_t config = {0, 2, 0, 1, 0, NULL};
+
+  /* make_obj is percolated in its own file; keep already returns an error */
+  ASSERT_EQ(0, write_to_file("test_percolate_index.c",
+                             "void *make_obj(void) { return malloc(1); }\n"
+                             "cdd_c_error_t keep(void) { return 0; }\n"));
+  ASSERT_EQ(0, project_index_update("test_percolate_index.c",
+                                    "test_percolate_index.idx", NULL));
+  ASSERT_EQ(0, project_index_open("test_percolate_index.idx", &idx));
+  config.project_index = &idx;
+
+  ASSERT_EQ(0, cdd_cst_parse(az_span_create_from_str((char *)code), &tree));
+  ASSERT_EQ(0, cdd_transform_percolate_errors(tree, &config));
+  ASSERT_EQ(0, cdd_cst_emit(tree, &out));
+  ASSERT(strstr(out, "out_make_obj") != NULL);
+  ASSERT(strstr(out, "out_keep") == NULL);
+
+  free(out);
+  cdd_cst_tree_free(tree);
+  project_index_close(&idx);
+  remove("test_percolate_index.c");
+  remove("test_percolate_index.idx");
+  PASS();
+}
+
 SUITE(transformer_error_percolator_suite) {
   RUN_TEST(test_cdd_transform_percolate_errors);
   RUN_TEST(test_cdd_transform_percolate_errors_complex);
   RUN_TEST(test_cdd_transform_percolate_errors_edge_cases);
   RUN_TEST(test_cdd_transform_percolate_errors_bld_fail);
   RUN_TEST(test_cdd_transform_percolate_errors_oom);
+  RUN_TEST(test_cdd_transform_percolate_errors_project_index);
 }
 
 #ifdef __cplusplus
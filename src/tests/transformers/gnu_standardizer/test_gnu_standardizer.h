@@ -717,6 +717,30 @@ TEST test_gnu_standardizer_omitted_conditional(void) {
   PASS();
 }
 
+TEST test_gnu_standardizer_anon_names_per_call(void) {
+  const char *code = "struct { int a; } s;\n"
+                     "struct { int b; } t;\n";
+  char *outs[2] = {NULL, NULL};
+  int run;
+  cdd_transform_config_t config;
+  memset(&config, 0, sizeof(config));
+  for (run = 0; run < 2; run++) {
+    cdd_cst_tree_t *tree = NULL;
+    ASSERT_EQ(0, cdd_cst_parse(az_span_create_from_str((char *)code), &tree));
+    ASSERT_EQ(0, cdd_transform_gnu(tree, &config));
+    ASSERT_EQ(0, cdd_cst_emit(tree, &outs[run]));
+    cdd_cst_tree_free(tree);
+  }
+  /* Numbering restarts for every tree */
+  ASSERT(strstr(outs[0], "struct _cdd_anon_0") != NULL);
+  ASSERT(strstr(outs[0], "struct _cdd_anon_1") != NULL);
+  ASSERT_STR_EQ(outs[0], outs[1]);
+  free(outs[0]);
+  free(outs[1]);
+  g_fail_io_after = -1;
+  PASS();
+}
+
 SUITE(transformer_gnu_standardizer_suite) {
   RUN_TEST(test_cdd_transform_gnu);
   RUN_TEST(test_gnu_standardizer_stmt_expr);
@@ -746,6 +770,7 @@ SUITE(transformer_gnu_standardizer_suite) {
   RUN_TEST(test_gnu_standardizer_float_extensions);
   RUN_TEST(test_gnu_standardizer_lvalue_cast);
   RUN_TEST(test_gnu_standardizer_omitted_conditional);
+  RUN_TEST(test_gnu_standardizer_anon_names_per_call);
 }
 #ifdef __cplusplus
 }
@@ -4,6 +4,7 @@
 /* clang-format off */
 #include "c_cdd_export.h"
 #include "cdd_cst_transform.h"
+#include "c_cdd/memory.h"
 #include "classes/parse/cdd_cst_parser.h"
 #include <greatest.h>
 
@@ -36,29 +37,21 @@ TEST test_gnu_internals(void) {
   ASSERT_EQ(NULL, pool_string_safe(NULL, "a"));
   ASSERT_EQ(NULL, pool_string_safe(&tree, NULL));
 
-  g_force_gnu_alloc_fail = 1;
+  g_cdd_alloc_fail = 1;
   ASSERT_EQ(NULL, pool_string_safe(&tree, "a"));
-  g_force_gnu_alloc_fail = 0;
-
-  tree.string_capacity = 0;
-  tree.num_strings = 0;
-  g_force_gnu_alloc_fail = 1;
-  ASSERT_EQ(NULL, pool_string_safe(&tree, "a"));
-  g_force_gnu_alloc_fail = 0;
+  g_cdd_alloc_fail = 0;
 
   /* Test pool_string_safe_len */
   ASSERT_EQ(NULL, pool_string_safe_len(NULL, "a", 1));
   ASSERT_EQ(NULL, pool_string_safe_len(&tree, NULL, 1));
 
-  g_force_gnu_alloc_fail = 1;
+  g_cdd_alloc_fail = 1;
   ASSERT_EQ(NULL, pool_string_safe_len(&tree, "a", 1));
-  g_force_gnu_alloc_fail = 0;
+  g_cdd_alloc_fail = 0;
 
-  tree.string_capacity = 0;
-  tree.num_strings = 0;
-  g_force_gnu_alloc_fail = 1;
-  ASSERT_EQ(NULL, pool_string_safe_len(&tree, "a", 1));
-  g_force_gnu_alloc_fail = 0;
+  ASSERT_STR_EQ("ab", pool_string_safe_len(&tree, "abc", 2));
+  ASSERT(tree.strings.head != NULL);
+  cdd_cst_arena_free(&tree.strings);
 
   /* Test append_int */
   {
@@ -532,6 +532,34 @@ TEST test_cdd_transform_safe_crt_edge_cases(void) {
   PASS();
 }
 
+TEST test_cdd_transform_safe_crt_reaching_size(void) {
+  cdd_cst_tree_t *tree = NULL;
+  const char *code = "void f(void) {\n"
+                     "  char *p = malloc(10);\n"
+                     "  strcpy(p, \"a\");\n"
+                     "  p = malloc(30);\n"
+                     "  strcpy(p, \"c\");\n"
+                     "}\n"
+                     "void g(void) {\n"
+                     "  char *p = malloc(20);\n"
+                     "  strcpy(p, \"b\");\n"
+                     "}\n";
+  char *out = NULL;
+  cdd_transform_config_t config = {0, 2, 0, 1, 0};
+
+  ASSERT_EQ(0, cdd_cst_parse(az_span_create_from_str((char *)code), &tree));
+  ASSERT_EQ(0, cdd_transform_safe_crt(tree, &config));
+  ASSERT_EQ(0, cdd_cst_emit(tree, &out));
+
+  ASSERT(strstr(out, "strcpy_s(p, 10, \"a\");") != NULL);
+  ASSERT(strstr(out, "strcpy_s(p, 30, \"c\");") != NULL);
+  ASSERT(strstr(out, "strcpy_s(p, 20, \"b\");") != NULL);
+
+  free(out);
+  cdd_cst_tree_free(tree);
+  PASS();
+}
+
 #ifdef CDD_BUILD_TESTS
 /* extern int g_safe_crt_malloc_fail; (moved to global) */
 /* extern int g_cdd_cst_alloc_node_fail; (moved to global) */
@@ -690,6 +718,7 @@ SUITE(transformer_safe_crt_suite) {
   RUN_TEST(test_cdd_transform_safe_crt_extended_functions);
 
   RUN_TEST(test_cdd_transform_safe_crt_edge_cases);
+  RUN_TEST(test_cdd_transform_safe_crt_reaching_size);
   RUN_TEST(test_cdd_transform_safe_crt_oom);
 }
 
@@ -10,6 +10,7 @@
 #include "classes/parse/cdd_cst_factory.h"
 #include "classes/parse/cdd_cst_parser.h"
 #include "classes/parse/cdd_cst_query.h"
+#include "functions/parse/project_index.h"
 #include "c_str_span.h"
 #include <errno.h>
 #include <string.h>
@@ -21,10 +22,54 @@
 #include "c_cdd/format_specifiers.h"
 /* clang-format on */
 
-static cdd_c_error_t rewrite_call_sites(cdd_cst_tree_t *tree,
-                                        cdd_cst_node_t *node,
-                                        cdd_token_t **modified_funcs,
-                                        size_t num_modified) {
+/**
+ * @brief Whether another file of the project defines `tok` as an external
+ * function this pass rewrites (one not already returning an error code).
+ */
+static int percolated_in_project(const struct ProjectIndex *project_index,
+                                 const cdd_token_t *tok) {
+  struct ProjectIndexName name;
+  struct ProjectIndexSymbol sym;
+  size_t i;
+  if (project_index_find(project_index, (const char *)tok->start, tok->length,
+                         &name) != CDD_C_SUCCESS)
+    return 0;
+  for (i = 0; i < name.n_symbols; i++) {
+    if (project_index_symbol_of(project_index, &name, i, &sym) ==
+            CDD_C_SUCCESS &&
+        sym.kind == PROJECT_INDEX_FUNCTION &&
+        !(sym.flags & (PROJECT_INDEX_STATIC | PROJECT_INDEX_RETURNS_ERROR)))
+      return 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Copies `len` bytes of `str` into the tree's string arena, which
+ * outlives the tokens that point at it.
+ */
+static const char *pool_string_len(cdd_cst_tree_t *tree, const char *str,
+                                   size_t len) {
+  const char *pooled = NULL;
+  if (cdd_cst_arena_strndup(&tree->strings, str, len, &pooled) != 0)
+    return NULL;
+  return pooled;
+}
+
+/**
+ * @brief Pools the `out_<name>` temporary declared for a rewritten call.
+ */
+static const char *pool_out_name(cdd_cst_tree_t *tree,
+                                 const cdd_token_t *tok) {
+  char buf[256];
+  CDD_SNPRINTF(buf, sizeof(buf), "out_%.*s", (int)tok->length, tok->start);
+  return pool_string_len(tree, buf, strlen(buf));
+}
+
+static cdd_c_error_t
+rewrite_call_sites(cdd_cst_tree_t *tree, cdd_cst_node_t *node,
+                   cdd_token_t **modified_funcs, size_t num_modified,
+                   const struct ProjectIndex *project_index) {
   size_t i;
   if (node == tree->root) {
     printf("rewrite_call_sites on tree->root with %" CDD_PRIz " children\n",
@@ -35,9 +80,16 @@ static cdd_c_error_t rewrite_call_sites(cdd_cst_tree_t *tree,
       cdd_token_t *tok = node->children[i].val.token;
       if (tok->kind == CDD_TOKEN_IDENTIFIER) {
         size_t m;
-        for (m = 0; m < num_modified; m++) {
-          if (modified_funcs[m]->length == tok->length &&
-              memcmp(modified_funcs[m]->start, tok->start, tok->length) == 0) {
+        int matched = 0;
+        for (m = 0; m < num_modified && !matched; m++)
+          matched =
+              modified_funcs[m]->length == tok->length &&
+              memcmp(modified_funcs[m]->start, tok->start, tok->length) == 0;
+        /* Calls into functions percolated by other files change alike */
+        if (!matched && project_index)
+          matched = percolated_in_project(project_index, tok);
+        if (matched) {
+          do {
 
             /* call to %.*s\n", (int)tok->length, tok->start); */
             int is_call = 0;
@@ -105,36 +157,13 @@ static cdd_c_error_t rewrite_call_sites(cdd_cst_tree_t *tree,
                 if (!temp)
                   return CDD_C_ERROR_MEMORY;
                 if (temp) {
-                  char *dup_id = (char *)C_CDD_CALLOC(1, 256);
+                  const char *dup_id = pool_out_name(tree, tok);
                   if (!dup_id) {
-                    printf("FAILED ON DUP_ID!\n");
                     C_CDD_FREE(temp);
                     return CDD_C_ERROR_MEMORY;
                   }
                   temp->kind = CDD_CST_UNKNOWN;
                   cdd_cst_builder_init(&bld, tree, temp);
-                  if (dup_id) {
-                    CDD_SNPRINTF(dup_id, 256, "out_%.*s", (int)tok->length,
-                                 tok->start);
-                    if (tree->num_strings >= tree->string_capacity) {
-                      size_t new_cap = tree->string_capacity == 0
-                                           ? 32
-                                           : tree->string_capacity * 2;
-                      char **new_pool = (char **)C_CDD_REALLOC(
-                          tree->string_pool, new_cap * sizeof(char *));
-                      if (new_pool) {
-                        tree->string_pool = new_pool;
-                        tree->string_capacity = new_cap;
-                      }
-                    }
-                    if (tree->num_strings < tree->string_capacity) {
-                      tree->string_pool[tree->num_strings++] = dup_id;
-                    } else {
-                      C_CDD_FREE(dup_id);
-                      dup_id = NULL;
-                      bld.error_state = CDD_C_ERROR_MEMORY;
-                    }
-                  }
 
                   {
                     size_t c_len = dup_id ? strlen(dup_id) : 0;
@@ -195,37 +224,13 @@ static cdd_c_error_t rewrite_call_sites(cdd_cst_tree_t *tree,
                 if (!temp)
                   return CDD_C_ERROR_MEMORY;
                 if (temp) {
-                  char *dup_id = (char *)C_CDD_CALLOC(1, 256);
+                  const char *dup_id = pool_out_name(tree, tok);
                   if (!dup_id) {
-                    printf("FAILED ON DUP_ID!\n");
                     C_CDD_FREE(temp);
                     return CDD_C_ERROR_MEMORY;
                   }
                   temp->kind = CDD_CST_UNKNOWN;
                   cdd_cst_builder_init(&bld, tree, temp);
-                  if (dup_id) {
-                    CDD_SNPRINTF(dup_id, 256, "out_%.*s",
-                                 (int)modified_funcs[m]->length,
-                                 modified_funcs[m]->start);
-                    if (tree->num_strings >= tree->string_capacity) {
-                      size_t new_cap = tree->string_capacity == 0
-                                           ? 32
-                                           : tree->string_capacity * 2;
-                      char **new_pool = (char **)C_CDD_REALLOC(
-                          tree->string_pool, new_cap * sizeof(char *));
-                      if (new_pool) {
-                        tree->string_pool = new_pool;
-                        tree->string_capacity = new_cap;
-                      }
-                    }
-                    if (tree->num_strings < tree->string_capacity) {
-                      tree->string_pool[tree->num_strings++] = dup_id;
-                    } else {
-                      C_CDD_FREE(dup_id);
-                      dup_id = NULL;
-                      bld.error_state = CDD_C_ERROR_MEMORY;
-                    }
-                  }
 
                   {
                     size_t c_len = dup_id ? strlen(dup_id) : 0;
@@ -303,13 +308,14 @@ static cdd_c_error_t rewrite_call_sites(cdd_cst_tree_t *tree,
               }
               break;
             }
-          }
+          } while (0);
         }
       }
     } else if (node->children[i].kind ==
                CDD_CST_CHILD_NODE) { /* into child %zu\n", i); */
-      cdd_c_error_t rc_recurse = rewrite_call_sites(
-          tree, node->children[i].val.node, modified_funcs, num_modified);
+      cdd_c_error_t rc_recurse =
+          rewrite_call_sites(tree, node->children[i].val.node, modified_funcs,
+                             num_modified, project_index);
       if (rc_recurse != CDD_C_SUCCESS) {
         return rc_recurse;
       }
@@ -322,24 +328,69 @@ static cdd_c_error_t rewrite_call_sites(cdd_cst_tree_t *tree,
 C_CDD_EXPORT int g_err_perc_fail = 0;
 #endif
 
+/**
+ * @brief Splits the tree's statements, in pre-order, into one run per
+ * function: `spans[2 * i]` up to `spans[2 * i + 1]` index those inside
+ * `funcs->nodes[i]`. Functions do not nest, so each run is contiguous.
+ */
+static cdd_c_error_t stmt_spans(const cdd_cst_query_result_t *funcs,
+                                const cdd_cst_query_result_t *stmts,
+                                size_t **out_spans) {
+  size_t *spans;
+  size_t f = 0;
+  size_t k;
+  spans = (size_t *)C_CDD_CALLOC(2 * funcs->size + 1, sizeof(size_t));
+  if (!spans)
+    return CDD_C_ERROR_MEMORY;
+  for (k = 0; k < stmts->size; k++) {
+    const cdd_cst_node_t *owner = stmts->nodes[k]->parent;
+    while (owner && owner->kind != CDD_CST_FUNCTION_DEFINITION)
+      owner = owner->parent;
+    if (!owner)
+      continue;
+    while (f < funcs->size && funcs->nodes[f] != owner)
+      f++;
+    if (f == funcs->size)
+      break;
+    if (spans[2 * f + 1] == 0)
+      spans[2 * f] = k;
+    spans[2 * f + 1] = k + 1;
+  }
+  *out_spans = spans;
+  return CDD_C_SUCCESS;
+}
+
 /** @brief cdd_transform_percolate_errors */
 cdd_c_error_t
 cdd_transform_percolate_errors(cdd_cst_tree_t *tree,
                                const cdd_transform_config_t *config) {
   cdd_cst_query_result_t res;
+  cdd_cst_query_result_t stmts;
+  size_t *spans = NULL;
   size_t i, j;
   int rc;
   cdd_token_t *modified_funcs[256];
   size_t num_modified = 0;
-  (void)config;
+  const struct ProjectIndex *project_index =
+      config ? config->project_index : NULL;
 
   if (!tree || !tree->root)
     return CDD_C_ERROR_INVALID_ARGUMENT;
 
-  rc =
-      cdd_cst_find_nodes_by_type(tree->root, CDD_CST_FUNCTION_DEFINITION, &res);
+  rc = cdd_cst_tree_find_nodes_by_type(tree, CDD_CST_FUNCTION_DEFINITION, &res);
   if (rc != 0)
     return rc;
+  /* Statements are taken once, before any edit, and handed out per function */
+  rc = cdd_cst_tree_find_nodes_by_type(tree, CDD_CST_UNKNOWN, &stmts);
+  if (rc == 0) {
+    rc = stmt_spans(&res, &stmts, &spans);
+    if (rc != 0)
+      C_CDD_FREE(stmts.nodes);
+  }
+  if (rc != 0) {
+    C_CDD_FREE(res.nodes);
+    return rc;
+  }
 
   for (i = 0; i < res.size; i++) {
     cdd_cst_node_t *func = res.nodes[i];
@@ -444,6 +495,8 @@ cdd_transform_percolate_errors(cdd_cst_tree_t *tree,
           cdd_cst_node_t *temp =
               (cdd_cst_node_t *)C_CDD_CALLOC(1, sizeof(cdd_cst_node_t));
           if (!temp) {
+            C_CDD_FREE(spans);
+            C_CDD_FREE(stmts.nodes);
             C_CDD_FREE(res.nodes);
             return CDD_C_ERROR_MEMORY;
           }
@@ -535,6 +588,8 @@ cdd_transform_percolate_errors(cdd_cst_tree_t *tree,
       cdd_cst_builder_t bld;
 
       if (!temp) {
+        C_CDD_FREE(spans);
+        C_CDD_FREE(stmts.nodes);
         C_CDD_FREE(res.nodes);
         return CDD_C_ERROR_MEMORY;
       }
@@ -567,12 +622,9 @@ cdd_transform_percolate_errors(cdd_cst_tree_t *tree,
 
     {
       cdd_cst_query_result_t stmts_res;
-      int q_rc = cdd_cst_find_nodes_by_type(func, CDD_CST_UNKNOWN, &stmts_res);
-      if (q_rc != CDD_C_SUCCESS) {
-        C_CDD_FREE(res.nodes);
-        return q_rc;
-      }
-      if (q_rc == 0) {
+      stmts_res.nodes = stmts.nodes + spans[2 * i];
+      stmts_res.size = spans[2 * i + 1] - spans[2 * i];
+      {
         size_t s_idx;
         for (s_idx = 0; s_idx < stmts_res.size; s_idx++) {
           cdd_cst_node_t *stmt = stmts_res.nodes[s_idx];
@@ -618,7 +670,8 @@ cdd_transform_percolate_errors(cdd_cst_tree_t *tree,
 
           if (has_alloc && assign_idx == (size_t)-1) {
             rc = CDD_C_ERROR_PARSE;
-            C_CDD_FREE(stmts_res.nodes);
+            C_CDD_FREE(spans);
+            C_CDD_FREE(stmts.nodes);
             C_CDD_FREE(res.nodes);
             return rc;
           }
@@ -631,7 +684,8 @@ cdd_transform_percolate_errors(cdd_cst_tree_t *tree,
                 (cdd_cst_node_t *)C_CDD_CALLOC(1, sizeof(cdd_cst_node_t));
 
             if (!cloned) {
-              C_CDD_FREE(stmts_res.nodes);
+              C_CDD_FREE(spans);
+              C_CDD_FREE(stmts.nodes);
               C_CDD_FREE(res.nodes);
               return CDD_C_ERROR_MEMORY;
             }
@@ -640,6 +694,8 @@ cdd_transform_percolate_errors(cdd_cst_tree_t *tree,
 
               char *tmp_name = NULL;
 
+              const char *pooled_name;
+
               size_t len = 0;
 
               size_t start_idx = 0;
@@ -720,13 +776,12 @@ cdd_transform_percolate_errors(cdd_cst_tree_t *tree,
 
                 tmp_name[len] = '\0';
               }
-              if (tree->num_strings >= tree->string_capacity) {
-                tree->string_capacity =
-                    tree->string_capacity == 0 ? 32 : tree->string_capacity * 2;
-                tree->string_pool = (char **)C_CDD_REALLOC(
-                    tree->string_pool, tree->string_capacity * sizeof(char *));
+              pooled_name = pool_string_len(tree, tmp_name, len);
+              C_CDD_FREE(tmp_name);
+              if (!pooled_name) {
+                C_CDD_FREE(cloned);
+                continue;
               }
-              tree->string_pool[tree->num_strings++] = tmp_name;
               cloned->kind = CDD_CST_UNKNOWN;
               cdd_cst_builder_init(&bld, tree, cloned);
               cdd_cst_bld_newline(&bld);
@@ -736,7 +791,7 @@ cdd_transform_percolate_errors(cdd_cst_tree_t *tree,
               cdd_cst_bld_space(&bld);
               cdd_cst_bld_punct(&bld, "(");
               cdd_cst_bld_punct(&bld, "!");
-              cdd_cst_bld_ident(&bld, tmp_name);
+              cdd_cst_bld_ident(&bld, pooled_name);
               cdd_cst_bld_punct(&bld, ")");
               cdd_cst_bld_space(&bld);
               cdd_cst_bld_punct(&bld, "{");
@@ -826,7 +881,8 @@ cdd_transform_percolate_errors(cdd_cst_tree_t *tree,
               C_CDD_FREE(decl_node);
             if (cleanup_node)
               C_CDD_FREE(cleanup_node);
-            C_CDD_FREE(stmts_res.nodes);
+            C_CDD_FREE(spans);
+            C_CDD_FREE(stmts.nodes);
             C_CDD_FREE(res.nodes);
             return CDD_C_ERROR_MEMORY;
           }
@@ -932,16 +988,17 @@ cdd_transform_percolate_errors(cdd_cst_tree_t *tree,
             C_CDD_FREE(cleanup_node);
           }
         }
-
-        C_CDD_FREE(stmts_res.nodes);
       }
     }
   }
 
+  C_CDD_FREE(spans);
+  C_CDD_FREE(stmts.nodes);
   C_CDD_FREE(res.nodes);
 
-  if (num_modified > 0) {
-    (void)rewrite_call_sites(tree, tree->root, modified_funcs, num_modified);
+  if (num_modified > 0 || project_index) {
+    (void)rewrite_call_sites(tree, tree->root, modified_funcs, num_modified,
+                             project_index);
   }
 
   return CDD_C_SUCCESS;
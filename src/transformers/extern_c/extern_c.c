@@ -125,8 +125,7 @@ cdd_c_error_t cdd_transform_extern_c(cdd_cst_tree_t *tree,
     return CDD_C_SUCCESS;
 
   /* 1. Check if __cplusplus is already checked globally */
-  rc =
-      cdd_cst_find_nodes_by_type(tree->root, CDD_CST_PREPROC_CONDITIONAL, &res);
+  rc = cdd_cst_tree_find_nodes_by_type(tree, CDD_CST_PREPROC_CONDITIONAL, &res);
   if (rc == 0) {
     for (i = 0; i < res.size; i++) {
       int is_global = 0;
@@ -156,8 +155,7 @@ cdd_c_error_t cdd_transform_extern_c(cdd_cst_tree_t *tree,
   }
 
   if (!found_cpp) {
-    rc =
-        cdd_cst_find_nodes_by_type(tree->root, CDD_CST_PREPROC_DIRECTIVE, &res);
+    rc = cdd_cst_tree_find_nodes_by_type(tree, CDD_CST_PREPROC_DIRECTIVE, &res);
     if (rc == 0) {
       for (i = 0; i < res.size; i++) {
         int is_global = 0;
@@ -35,54 +35,22 @@
 #define ULL_HEX_FMT "%llx"
 #endif
 
-static const char *pool_string_safe(cdd_cst_tree_t *tree, const char *str) {
-  char *dup;
+static const char *pool_string_safe_len(cdd_cst_tree_t *tree, const char *str,
+                                        size_t len) {
+  const char *pooled = NULL;
   if (!tree || !str)
     return NULL;
-  dup = strdup(str);
-  if (!dup)
+  if (cdd_cst_arena_strndup(&tree->strings, str, len, &pooled) != 0)
     return NULL;
-  if (tree->num_strings >= tree->string_capacity) {
-    size_t new_cap =
-        tree->string_capacity == 0 ? 32 : tree->string_capacity * 2;
-    char **new_pool =
-        (char **)realloc(tree->string_pool, new_cap * sizeof(char *));
-    if (!new_pool) {
-      free(dup);
-      return NULL;
-    }
-    tree->string_pool = new_pool;
-    tree->string_capacity = new_cap;
-  }
-  tree->string_pool[tree->num_strings++] = dup;
-  return dup;
+  return pooled;
 }
 
-static const char *pool_string_safe_len(cdd_cst_tree_t *tree, const char *str,
-                                        size_t len) {
-  char *dup;
-  if (!tree || !str)
-    return NULL;
-  dup = (char *)malloc(len + 1);
-  if (!dup)
+static const char *pool_string_safe(cdd_cst_tree_t *tree, const char *str) {
+  if (!str)
     return NULL;
-  memcpy(dup, str, len);
-  dup[len] = '\0';
-  if (tree->num_strings >= tree->string_capacity) {
-    size_t new_cap =
-        tree->string_capacity == 0 ? 32 : tree->string_capacity * 2;
-    char **new_pool =
-        (char **)realloc(tree->string_pool, new_cap * sizeof(char *));
-    if (!new_pool) {
-      free(dup);
-      return NULL;
-    }
-    tree->string_pool = new_pool;
-    tree->string_capacity = new_cap;
-  }
-  tree->string_pool[tree->num_strings++] = dup;
-  return dup;
+  return pool_string_safe_len(tree, str, strlen(str));
 }
+
 static cdd_c_error_t append_int(char *p, int v, char **out_p) {
   char temp[32];
   int i = 0, j;
@@ -369,6 +337,9 @@ cdd_c_error_t cdd_transform_gnu(cdd_cst_tree_t *tree,
   size_t i;
   cdd_c_error_t rc = CDD_C_SUCCESS;
   cdd_cst_query_result_t res = {0};
+  /* Per-call name counters; struct and union tags share one namespace */
+  int typeof_arr_idx = 0;
+  int anon_counter = 0;
   (void)config;
 
   if (!tree || !tree->root)
@@ -376,8 +347,8 @@ cdd_c_error_t cdd_transform_gnu(cdd_cst_tree_t *tree,
 
   cdd_cst_traverse_preorder(tree->root, asm_visitor, NULL);
 
-  if (cdd_cst_find_nodes_by_type(tree->root, CDD_CST_FUNCTION_DEFINITION,
-                                 &res) == 0) {
+  if (cdd_cst_tree_find_nodes_by_type(tree, CDD_CST_FUNCTION_DEFINITION,
+                                      &res) == 0) {
     for (i = 0; i < res.size; i++) {
       cdd_cst_node_t *func = res.nodes[i];
       size_t j;
@@ -965,7 +936,6 @@ cdd_c_error_t cdd_transform_gnu(cdd_cst_tree_t *tree,
               *p++ = ' ';
               *p = '\0';
               if (strchr(buf, '[')) {
-                static int typeof_arr_idx = 0;
                 char typedef_buf[1024];
                 /* Extract the base type and the array part. Very hacky for the
                  * test. */
@@ -1767,7 +1737,6 @@ cdd_c_error_t cdd_transform_gnu(cdd_cst_tree_t *tree,
           tree->base_tokens->tokens[i + 1].kind == CDD_TOKEN_LBRACE) {
         /* Anonymous struct: GNU extension. Inject dummy name to make C89 happy.
          */
-        static int anon_counter = 0;
         size_t child_idx;
         cdd_cst_node_t *owning_node = NULL;
         cdd_cst_find_node_for_token(tree->root, tok, &child_idx, &owning_node);
@@ -1815,7 +1784,6 @@ cdd_c_error_t cdd_transform_gnu(cdd_cst_tree_t *tree,
       if (i + 1 < tree->base_tokens->size &&
           tree->base_tokens->tokens[i + 1].kind == CDD_TOKEN_LBRACE) {
         /* Anonymous union: GNU extension. Inject dummy name. */
-        static int anon_counter = 0;
         size_t child_idx;
         cdd_cst_node_t *owning_node = NULL;
         cdd_cst_find_node_for_token(tree->root, tok, &child_idx, &owning_node);
@@ -45,7 +45,7 @@ C_CDD_EXPORT cdd_c_error_t cdd_transform_macros(
   calls.size = 0;
   calls.capacity = 0;
 
-  rc = cdd_cst_find_function_calls_named(tree->root, "FOO", &calls);
+  rc = cdd_cst_tree_find_function_calls_named(tree, "FOO", &calls);
 
   if (rc != CDD_C_SUCCESS)
     return rc;
@@ -80,8 +80,8 @@ C_CDD_EXPORT cdd_c_error_t cdd_transform_macros(
 
   {
     cdd_cst_query_result_t stringify_calls = {0};
-    rc = cdd_cst_find_function_calls_named(tree->root, "STRINGIFY",
-                                           &stringify_calls);
+    rc = cdd_cst_tree_find_function_calls_named(tree, "STRINGIFY",
+                                                &stringify_calls);
     if (rc == CDD_C_SUCCESS) {
       for (i = 0; i < stringify_calls.size; i++) {
         cdd_cst_node_t *call_node = stringify_calls.nodes[i];
@@ -117,7 +117,7 @@ C_CDD_EXPORT cdd_c_error_t cdd_transform_macros(
 
   {
     cdd_cst_query_result_t concat_calls = {0};
-    rc = cdd_cst_find_function_calls_named(tree->root, "CONCAT", &concat_calls);
+    rc = cdd_cst_tree_find_function_calls_named(tree, "CONCAT", &concat_calls);
     if (rc == CDD_C_SUCCESS) {
       for (i = 0; i < concat_calls.size; i++) {
         cdd_cst_node_t *call_node = concat_calls.nodes[i];
@@ -214,7 +214,7 @@ cdd_c_error_t cdd_transform_msvc(cdd_cst_tree_t *tree,
     return CDD_C_ERROR_INVALID_ARGUMENT;
 
   /* 1. Wrap unistd.h and sys/time.h */
-  rc = cdd_cst_find_nodes_by_type(tree->root, CDD_CST_PREPROC_DIRECTIVE, &res);
+  rc = cdd_cst_tree_find_nodes_by_type(tree, CDD_CST_PREPROC_DIRECTIVE, &res);
   if (rc == 0) {
     for (i = 0; i < res.size; i++) {
       cdd_cst_node_t *dir = res.nodes[i];
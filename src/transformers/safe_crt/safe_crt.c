@@ -6,9 +6,11 @@
 /* clang-format off */
 #include "cdd_cst_transform.h"
 #include "classes/parse/cdd_cst_mutate.h"
+#include "classes/parse/cdd_cst_arena.h"
 #include "classes/parse/cdd_cst_builder.h"
 #include "classes/parse/cdd_cst_factory.h"
 
+#include "classes/parse/cdd_cst_dataflow.h"
 #include "classes/parse/cdd_cst_parser.h"
 #include "classes/parse/cdd_cst_query.h"
 #include "c_str_span.h"
@@ -21,57 +23,74 @@
 #include "c_cdd_export.h"
 /* clang-format on */
 
-/** @brief safe_crt_arena_t */
-typedef struct safe_crt_arena_t safe_crt_arena_t;
-/** @brief Struct definition */
-struct safe_crt_arena_t {
-  /** @brief field */
-  /** @brief field */
-  safe_crt_arena_t *next;
-  /** @brief field */
-  /** @brief field */
-  char data[1];
-};
-
-static safe_crt_arena_t *global_arena = NULL;
-static cdd_cst_tree_t *current_tree = NULL;
 #ifdef CDD_BUILD_TESTS
 C_CDD_EXPORT int g_safe_crt_malloc_fail = 0;
 #endif
 
-static void arena_free_all(void) {
-  safe_crt_arena_t *node = global_arena;
-  while (node) {
-    safe_crt_arena_t *next = node->next;
-    free(node);
-    node = next;
-  }
-  global_arena = NULL;
+/** @brief emit_ctx_t */
+typedef struct emit_ctx_t {
+  /** @brief is_msc field */
+  int is_msc;
+  /** @brief needs_wcserrbuf field */
+  int needs_errbuf;
+  /** @brief needs_wcstokctx field */
+  int needs_wcserrbuf;
+  /** @brief needs_ecvtbuf field */
+  int needs_strtokctx;
+  /** @brief needs_retbuf field */
+  int needs_wcstokctx;
+  /** @brief needs_wgetenv_ptr field */
+  int needs_mbstokctx;
+  /** @brief needs_ecvtbuf field */
+  int needs_ecvtbuf;
+  /** @brief needs_retbuf field */
+  int needs_fcvtbuf;
+  /** @brief needs_wgetenv_ptr field */
+  int needs_retbuf;
+  int needs_getenv_ptr;           /**< needs_getenv_ptr */
+  int needs_wgetenv_ptr;          /**< needs_wgetenv_ptr */
+  struct safe_crt_state_t *state; /**< Owning transform call */
+} emit_ctx_t;
+
+/**
+ * @brief State of one cdd_transform_safe_crt call. Nothing outlives the
+ * call except strings pooled in the tree, so separate trees can be
+ * transformed from separate threads.
+ */
+typedef struct safe_crt_state_t {
+  cdd_cst_tree_t *tree;    /**< Tree being transformed */
+  cdd_cst_arena_t scratch; /**< Expression nodes; released on return */
+  emit_ctx_t plain;        /**< Context for the portable branch */
+  cdd_cst_node_t *stmt;    /**< Statement being checked or rewritten */
+  /* Reaching definitions of the function around `stmt`, kept until the
+   * tree next changes */
+  cdd_cst_node_t *df_fn;    /**< Function they describe, or NULL */
+  size_t df_revision;       /**< Tree revision they were built at */
+  cdd_cst_cfg_t *df_cfg;    /**< Its CFG */
+  cdd_cst_defuse_t df_du;   /**< Its definitions */
+  cdd_cst_dataflow_t df_rd; /**< Reaching definitions */
+} safe_crt_state_t;
+
+static void df_cache_clear(safe_crt_state_t *state) {
+  cdd_cst_dataflow_free(&state->df_rd);
+  cdd_cst_defuse_free(&state->df_du);
+  cdd_cst_cfg_free(state->df_cfg);
+  state->df_cfg = NULL;
+  state->df_fn = NULL;
 }
 
-static cdd_c_error_t arena_alloc(size_t len, void **out_ptr) {
-  safe_crt_arena_t *node;
-  if (!out_ptr)
+static cdd_c_error_t arena_alloc(safe_crt_state_t *state, size_t len,
+                                 void **out_ptr) {
+  if (!state || !out_ptr)
     return CDD_C_ERROR_INVALID_ARGUMENT;
   *out_ptr = NULL;
-  *out_ptr = NULL;
 #ifdef CDD_BUILD_TESTS
   if (g_safe_crt_malloc_fail > 0 && --g_safe_crt_malloc_fail == 0) {
-    node = NULL;
-  } else {
-#endif
-    node = (safe_crt_arena_t *)malloc(sizeof(safe_crt_arena_t) + len);
-#ifdef CDD_BUILD_TESTS
-  }
-#endif
-  if (!node) {
     C_CDD_LOG_DEBUG("ENOMEM: OOM\n");
     return CDD_C_ERROR_MEMORY;
   }
-  node->next = global_arena;
-  global_arena = node;
-  *out_ptr = node->data;
-  return CDD_C_SUCCESS;
+#endif
+  return cdd_cst_arena_alloc(&state->scratch, len, out_ptr);
 }
 
 /** @brief expr_t */
@@ -97,7 +116,8 @@ struct expr_t {
   expr_t *next;
 };
 
-static cdd_c_error_t parse_expr_ast(cdd_cst_node_t *stmt, size_t *idx,
+static cdd_c_error_t parse_expr_ast(safe_crt_state_t *state,
+                                    cdd_cst_node_t *stmt, size_t *idx,
                                     int stop_at_comma, expr_t **out_expr) {
   expr_t *head = NULL;
   expr_t *tail = NULL;
@@ -117,7 +137,7 @@ static cdd_c_error_t parse_expr_ast(cdd_cst_node_t *stmt, size_t *idx,
     if (t->kind == CDD_TOKEN_COMMA && stop_at_comma)
       break;
 
-    if (arena_alloc(sizeof(expr_t), (void **)&node) != 0) {
+    if (arena_alloc(state, sizeof(expr_t), (void **)&node) != 0) {
       break;
     }
     memset(node, 0, sizeof(expr_t));
@@ -139,11 +159,11 @@ static cdd_c_error_t parse_expr_ast(cdd_cst_node_t *stmt, size_t *idx,
         }
         old_idx = *idx;
         if (node->num_args < 16) {
-          parse_expr_ast(stmt, idx, 1, &node->args[node->num_args++]);
+          parse_expr_ast(state, stmt, idx, 1, &node->args[node->num_args++]);
         } else {
           {
             expr_t *tmp_expr = NULL;
-            parse_expr_ast(stmt, idx, 1, &tmp_expr);
+            parse_expr_ast(state, stmt, idx, 1, &tmp_expr);
           }
         }
         if (*idx == old_idx) {
@@ -170,7 +190,7 @@ static cdd_c_error_t parse_expr_ast(cdd_cst_node_t *stmt, size_t *idx,
                                           : CDD_TOKEN_RBRACE;
       node->type = 2;
       (*idx)++;
-      parse_expr_ast(stmt, idx, 0, &node->args[0]);
+      parse_expr_ast(state, stmt, idx, 0, &node->args[0]);
       if (*idx < stmt->num_children &&
           stmt->children[*idx].val.token->kind == closing) {
         node->close_tok = stmt->children[*idx].val.token;
@@ -289,7 +309,138 @@ typedef struct {
   expr_t *malloc_size_expr;
 } inferred_size_t;
 
-static inferred_size_t infer_buffer_size(expr_t *node) {
+/* Sizes buffer `name` at child `j` of `stmt` from `T name[...]` or
+ * `name = malloc/calloc/realloc(...)`; returns 1 if either matches. */
+static int size_from_def(safe_crt_state_t *state, cdd_cst_node_t *stmt,
+                         size_t j, inferred_size_t *res) {
+  /* Pattern 1: Array declaration -> char buf[...] */
+  if (j + 1 < stmt->num_children &&
+      stmt->children[j + 1].kind == CDD_CST_CHILD_TOKEN &&
+      stmt->children[j + 1].val.token->kind == CDD_TOKEN_LBRACKET) {
+    if (j > 0 && stmt->children[j - 1].kind == CDD_CST_CHILD_TOKEN &&
+        stmt->children[j - 1].val.token->kind == CDD_TOKEN_IDENTIFIER) {
+      res->valid = 1;
+      return 1;
+    }
+  }
+
+  /* Pattern 2: malloc/calloc/realloc assignment -> buf = malloc(...) OR
+   * char *buf = malloc(...) */
+  if (j + 2 < stmt->num_children &&
+      stmt->children[j + 1].kind == CDD_CST_CHILD_TOKEN &&
+      stmt->children[j + 1].val.token->kind == CDD_TOKEN_ASSIGN &&
+      stmt->children[j + 2].kind == CDD_CST_CHILD_TOKEN) {
+    cdd_token_t *m_tok = stmt->children[j + 2].val.token;
+    if (m_tok->kind == CDD_TOKEN_IDENTIFIER && m_tok->length >= 6 &&
+        (memcmp(m_tok->start, "malloc", 6) == 0 ||
+         memcmp(m_tok->start, "calloc", 6) == 0 ||
+         memcmp(m_tok->start, "realloc", 7) == 0)) {
+      size_t idx = j + 2;
+      expr_t *m_expr = NULL;
+      if (parse_expr_ast(state, stmt, &idx, 0, &m_expr) == 0 && m_expr &&
+          m_expr->type == 1) {
+        if (m_expr->num_args == 1) {
+          /* malloc */
+          res->valid = 1;
+          res->is_malloc = 1;
+          res->malloc_size_expr = m_expr->args[0];
+          return 1;
+        } else if (m_expr->num_args == 2 &&
+                   memcmp(m_tok->start, "calloc", 6) == 0) {
+          /* calloc(n, size) -> n * size */
+          res->valid = 1;
+          res->is_malloc = 2; /* special flag for calloc */
+          res->malloc_size_expr = m_expr; /* store the call expr, handle in
+                                             emit */
+          return 1;
+        } else if (m_expr->num_args == 2 &&
+                   memcmp(m_tok->start, "realloc", 7) == 0) {
+          /* realloc(ptr, size) -> size */
+          res->valid = 1;
+          res->is_malloc = 1;
+          res->malloc_size_expr = m_expr->args[1];
+          return 1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+/* Finds the single definition of `name` reaching `state->stmt`, using the
+ * reaching definitions of its function. Returns 0 when there is none, or
+ * several, or the statement is not in a function body. */
+static int reaching_def(safe_crt_state_t *state, const char *name, size_t len,
+                        const cdd_cst_def_t **out_def) {
+  cdd_cst_node_t *fn = state->stmt;
+  const cdd_cst_cfg_block_t *block = NULL;
+  const cdd_cst_bitset_word_t *in;
+  size_t b, s = 0, d, var, k, found = 0, last;
+
+  /* Braced `if`/`while` nodes share the kind; the function is outermost */
+  while (fn && !(fn->kind == CDD_CST_FUNCTION_DEFINITION &&
+                 (!fn->parent || fn->parent->kind == CDD_CST_TRANSLATION_UNIT)))
+    fn = fn->parent;
+  if (!fn)
+    return 0;
+  if (state->df_fn != fn || state->df_revision != state->tree->revision) {
+    df_cache_clear(state);
+    if (cdd_cst_cfg_build(fn, &state->df_cfg) != CDD_C_SUCCESS)
+      return 0;
+    if (cdd_cst_defuse_build(state->df_cfg, &state->df_du) != CDD_C_SUCCESS ||
+        cdd_cst_dataflow_reaching_defs(state->df_cfg, &state->df_du,
+                                       &state->df_rd) != CDD_C_SUCCESS) {
+      df_cache_clear(state);
+      return 0;
+    }
+    state->df_fn = fn;
+    state->df_revision = state->tree->revision;
+  }
+  if (cdd_cst_defuse_find_var(&state->df_du, name, len, &var) !=
+      CDD_C_SUCCESS)
+    return 0;
+
+  for (b = 0; b < state->df_cfg->num_blocks && !block; b++) {
+    for (s = 0; s < state->df_cfg->blocks[b]->num_statements; s++) {
+      if (state->df_cfg->blocks[b]->statements[s] == state->stmt) {
+        block = state->df_cfg->blocks[b];
+        break;
+      }
+    }
+  }
+  if (!block)
+    return 0;
+  b = (size_t)block->id;
+
+  /* A definition earlier in the block hides those flowing in */
+  last = state->df_du.n_defs;
+  k = state->df_du.block_defs[b];
+  for (d = 0; d < s; d++) {
+    for (; k < state->df_du.block_defs[b + 1] &&
+           state->df_du.defs[k].stmt == block->statements[d];
+         k++) {
+      if (state->df_du.defs[k].var == var)
+        last = k;
+    }
+  }
+  if (last < state->df_du.n_defs) {
+    *out_def = &state->df_du.defs[last];
+    return 1;
+  }
+
+  in = cdd_cst_dataflow_in(&state->df_rd, b);
+  for (d = state->df_du.first_def[var]; d < state->df_du.n_defs;
+       d = state->df_du.defs[d].next_of_var) {
+    if (CDD_CST_BITSET_TEST(in, d)) {
+      *out_def = &state->df_du.defs[d];
+      found++;
+    }
+  }
+  return found == 1;
+}
+
+static inferred_size_t infer_buffer_size(safe_crt_state_t *state,
+                                         expr_t *node) {
   inferred_size_t res;
   cdd_cst_query_result_t stmts;
   size_t i, j;
@@ -299,7 +450,7 @@ static inferred_size_t infer_buffer_size(expr_t *node) {
   memset(&res, 0, sizeof(res));
   memset(&stmts, 0, sizeof(stmts));
 
-  if (!current_tree || !current_tree->root || !node)
+  if (!state || !state->tree->root || !node)
     return res;
 
   /* Parse offset patterns */
@@ -355,7 +506,16 @@ static inferred_size_t infer_buffer_size(expr_t *node) {
   if (!name)
     return res;
 
-  if (cdd_cst_find_nodes_by_type(current_tree->root, CDD_CST_UNKNOWN, &stmts) !=
+  {
+    const cdd_cst_def_t *def = NULL;
+    if (reaching_def(state, name, len, &def)) {
+      /* The one definition reaching the call decides */
+      size_from_def(state, def->stmt, def->child, &res);
+      return res;
+    }
+  }
+
+  if (cdd_cst_tree_find_nodes_by_type(state->tree, CDD_CST_UNKNOWN, &stmts) !=
       0)
     return res;
 
@@ -365,72 +525,10 @@ static inferred_size_t infer_buffer_size(expr_t *node) {
       if (stmt->children[j].kind == CDD_CST_CHILD_TOKEN) {
         cdd_token_t *tok = stmt->children[j].val.token;
         if (tok->kind == CDD_TOKEN_IDENTIFIER && tok->length == len &&
-            memcmp(tok->start, name, len) == 0) {
-
-          /* Pattern 1: Array declaration -> char buf[...] */
-          if (j + 1 < stmt->num_children &&
-              stmt->children[j + 1].kind == CDD_CST_CHILD_TOKEN &&
-              stmt->children[j + 1].val.token->kind == CDD_TOKEN_LBRACKET) {
-
-            if (j > 0 && stmt->children[j - 1].kind == CDD_CST_CHILD_TOKEN &&
-                stmt->children[j - 1].val.token->kind == CDD_TOKEN_IDENTIFIER) {
-              res.valid = 1;
-              if (stmts.nodes)
-                free(stmts.nodes);
-              return res;
-            }
-          }
-
-          /* Pattern 2: malloc/calloc/realloc assignment -> buf = malloc(...) OR
-           * char *buf = malloc(...) */
-          if (j + 1 < stmt->num_children &&
-              stmt->children[j + 1].kind == CDD_CST_CHILD_TOKEN &&
-              stmt->children[j + 1].val.token->kind == CDD_TOKEN_ASSIGN) {
-
-            if (j + 2 < stmt->num_children &&
-                stmt->children[j + 2].kind == CDD_CST_CHILD_TOKEN) {
-              cdd_token_t *m_tok = stmt->children[j + 2].val.token;
-              if (m_tok->kind == CDD_TOKEN_IDENTIFIER && m_tok->length >= 6 &&
-                  (memcmp(m_tok->start, "malloc", 6) == 0 ||
-                   memcmp(m_tok->start, "calloc", 6) == 0 ||
-                   memcmp(m_tok->start, "realloc", 7) == 0)) {
-                size_t idx = j + 2;
-                expr_t *m_expr = NULL;
-                if (parse_expr_ast(stmt, &idx, 0, &m_expr) == 0) {
-                  if (m_expr && m_expr->type == 1) {
-                    if (m_expr->num_args == 1) {
-                      /* malloc */
-                      res.valid = 1;
-                      res.is_malloc = 1;
-                      res.malloc_size_expr = m_expr->args[0];
-                      if (stmts.nodes)
-                        free(stmts.nodes);
-                      return res;
-                    } else if (m_expr->num_args == 2 &&
-                               memcmp(m_tok->start, "calloc", 6) == 0) {
-                      /* calloc(n, size) -> n * size */
-                      res.valid = 1;
-                      res.is_malloc = 2; /* special flag for calloc */
-                      res.malloc_size_expr =
-                          m_expr; /* store the call expr, handle in emit */
-                      if (stmts.nodes)
-                        free(stmts.nodes);
-                      return res;
-                    } else if (m_expr->num_args == 2 &&
-                               memcmp(m_tok->start, "realloc", 7) == 0) {
-                      /* realloc(ptr, size) -> size */
-                      res.valid = 1;
-                      res.is_malloc = 1;
-                      res.malloc_size_expr = m_expr->args[1];
-                      if (stmts.nodes)
-                        free(stmts.nodes);
-                      return res;
-                    }
-                  }
-                }
-              }
-            }
-          }
+            memcmp(tok->start, name, len) == 0 &&
+            size_from_def(state, stmt, j, &res)) {
+          free(stmts.nodes);
+          return res;
         }
       }
     }
@@ -440,7 +538,8 @@ static inferred_size_t infer_buffer_size(expr_t *node) {
   return res;
 }
 
-static cdd_c_error_t check_needs_transform(expr_t *head) {
+static cdd_c_error_t check_needs_transform(safe_crt_state_t *state,
+                                           expr_t *head) {
   size_t i;
   while (head) {
     if (head->type == 1 || head->type == 5) {
@@ -543,7 +642,7 @@ static cdd_c_error_t check_needs_transform(expr_t *head) {
                   head->args[arg_idx + k]->tok->length == 1 &&
                   head->args[arg_idx + k]->tok->start[0] == '0')
                 continue;
-              if (!infer_buffer_size(head->args[arg_idx + k]).valid) {
+              if (!infer_buffer_size(state, head->args[arg_idx + k]).valid) {
                 return CDD_C_ERROR_PARSE;
               }
             }
@@ -552,14 +651,14 @@ static cdd_c_error_t check_needs_transform(expr_t *head) {
         return CDD_C_ERROR_UNKNOWN;
       }
       for (i = 0; i < head->num_args; i++) {
-        cdd_c_error_t err = check_needs_transform(head->args[i]);
+        cdd_c_error_t err = check_needs_transform(state, head->args[i]);
         if (err == CDD_C_ERROR_PARSE)
           return err;
         if (err)
           return CDD_C_ERROR_UNKNOWN;
       }
     } else if (head->type == 2) {
-      cdd_c_error_t err = check_needs_transform(head->args[0]);
+      cdd_c_error_t err = check_needs_transform(state, head->args[0]);
       if (err == CDD_C_ERROR_PARSE)
         return err;
       if (err)
@@ -572,30 +671,6 @@ static cdd_c_error_t check_needs_transform(expr_t *head) {
   return CDD_C_SUCCESS;
 }
 
-typedef struct {
-  /** @brief is_msc field */
-  int is_msc;
-  /** @brief needs_wcserrbuf field */
-  int needs_errbuf;
-  /** @brief needs_wcstokctx field */
-  int needs_wcserrbuf;
-  /** @brief needs_ecvtbuf field */
-  int needs_strtokctx;
-  /** @brief needs_retbuf field */
-  int needs_wcstokctx;
-  /** @brief needs_wgetenv_ptr field */
-  int needs_mbstokctx;
-  /** @brief needs_ecvtbuf field */
-  int needs_ecvtbuf;
-  /** @brief needs_retbuf field */
-  int needs_fcvtbuf;
-  /** @brief needs_wgetenv_ptr field */
-  int needs_retbuf;
-  int needs_getenv_ptr;  /**< needs_getenv_ptr */
-  int needs_wgetenv_ptr; /**< needs_wgetenv_ptr */
-} emit_ctx_t;
-
-static emit_ctx_t *g_msc_ctx = NULL;
 
 static cdd_c_error_t expr_is_null_or_zero(expr_t *node) {
   if (node && node->type == 0 && node->tok && !node->next) {
@@ -608,40 +683,16 @@ static cdd_c_error_t expr_is_null_or_zero(expr_t *node) {
 }
 
 static const char *pool_string_safe(cdd_cst_tree_t *tree, const char *str) {
-  char *dup;
+  const char *pooled = NULL;
   if (!tree || !str)
     return NULL;
-  dup = strdup(str);
 #ifdef CDD_BUILD_TESTS
-  if (g_safe_crt_malloc_fail > 0 && --g_safe_crt_malloc_fail == 0) {
-    free(dup);
+  if (g_safe_crt_malloc_fail > 0 && --g_safe_crt_malloc_fail == 0)
     return NULL;
-  }
 #endif
-  if (!dup)
+  if (cdd_cst_arena_strndup(&tree->strings, str, strlen(str), &pooled) != 0)
     return NULL;
-  if (tree->num_strings >= tree->string_capacity) {
-    size_t new_cap =
-        tree->string_capacity == 0 ? 32 : tree->string_capacity * 2;
-    char **new_pool = NULL;
-#ifdef CDD_BUILD_TESTS
-    if (g_safe_crt_malloc_fail > 0) {
-      g_safe_crt_malloc_fail--;
-      if (g_safe_crt_malloc_fail == 0)
-        new_cap = 0;
-    }
-#endif
-    if (new_cap > 0)
-      new_pool = (char **)realloc(tree->string_pool, new_cap * sizeof(char *));
-    if (!new_pool) {
-      free(dup);
-      return NULL;
-    }
-    tree->string_pool = new_pool;
-    tree->string_capacity = new_cap;
-  }
-  tree->string_pool[tree->num_strings++] = dup;
-  return dup;
+  return pooled;
 }
 
 static cdd_c_error_t clone_trivia(cdd_trivia_t *head,
@@ -703,14 +754,14 @@ static cdd_c_error_t clone_token(cdd_cst_tree_t *tree, cdd_token_t *tok,
 }
 
 static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
-                                  int is_msc);
+                                  emit_ctx_t *ctx);
 
 static cdd_c_error_t emit_ast_bld_strip(expr_t *node, cdd_cst_builder_t *bld,
-                                        int is_msc) {
+                                        emit_ctx_t *ctx) {
   int rc = 0;
   size_t old_num_children =
       bld->target_node ? bld->target_node->num_children : 0;
-  rc = emit_ast_bld(node, bld, is_msc);
+  rc = emit_ast_bld(node, bld, ctx);
   if (bld->target_node && bld->target_node->num_children > old_num_children) {
     if (bld->target_node->children[old_num_children].kind ==
         CDD_CST_CHILD_TOKEN) {
@@ -729,20 +780,23 @@ static cdd_c_error_t emit_ast_bld_strip(expr_t *node, cdd_cst_builder_t *bld,
 }
 
 static cdd_c_error_t
-emit_ast_bld_strip_ampersand(expr_t *node, cdd_cst_builder_t *bld, int is_msc) {
+emit_ast_bld_strip_ampersand(expr_t *node, cdd_cst_builder_t *bld,
+                             emit_ctx_t *ctx) {
   if (node && node->type == 0 && node->tok && node->tok->length == 1 &&
       node->tok->start[0] == '&') {
-    return emit_ast_bld_strip(node->next, bld, is_msc);
+    return emit_ast_bld_strip(node->next, bld, ctx);
   }
-  return emit_ast_bld_strip(node, bld, is_msc);
+  return emit_ast_bld_strip(node, bld, ctx);
 }
 
-static void emit_inferred_size(cdd_cst_builder_t *bld, expr_t *dest) {
-  inferred_size_t info = infer_buffer_size(dest);
+static void emit_inferred_size(emit_ctx_t *ctx, cdd_cst_builder_t *bld,
+                               expr_t *dest) {
+  emit_ctx_t *plain = &ctx->state->plain;
+  inferred_size_t info = infer_buffer_size(ctx->state, dest);
   if (!info.valid) {
     cdd_cst_bld_ident(bld, "sizeof");
     cdd_cst_bld_punct(bld, "(");
-    emit_ast_bld_strip(dest, bld, 0);
+    emit_ast_bld_strip(dest, bld, plain);
     cdd_cst_bld_punct(bld, ")");
     return;
   }
@@ -751,16 +805,16 @@ static void emit_inferred_size(cdd_cst_builder_t *bld, expr_t *dest) {
     cdd_cst_bld_punct(bld, "(");
 
   if (info.is_malloc == 1) {
-    emit_ast_bld_strip(info.malloc_size_expr, bld, 0);
+    emit_ast_bld_strip(info.malloc_size_expr, bld, plain);
   } else if (info.is_malloc == 2) {
     cdd_cst_bld_punct(bld, "(");
-    emit_ast_bld_strip(info.malloc_size_expr->args[0], bld, 0);
+    emit_ast_bld_strip(info.malloc_size_expr->args[0], bld, plain);
     cdd_cst_bld_punct(bld, ")");
     cdd_cst_bld_space(bld);
     cdd_cst_bld_punct(bld, "*");
     cdd_cst_bld_space(bld);
     cdd_cst_bld_punct(bld, "(");
-    emit_ast_bld_strip(info.malloc_size_expr->args[1], bld, 0);
+    emit_ast_bld_strip(info.malloc_size_expr->args[1], bld, plain);
     cdd_cst_bld_punct(bld, ")");
   } else {
     cdd_token_t *ct = NULL;
@@ -798,18 +852,19 @@ static void emit_inferred_size(cdd_cst_builder_t *bld, expr_t *dest) {
     cdd_cst_bld_punct(bld, "-");
     cdd_cst_bld_space(bld);
     cdd_cst_bld_punct(bld, "(");
-    emit_ast_bld_strip(info.offset_expr, bld, 0);
+    emit_ast_bld_strip(info.offset_expr, bld, plain);
     cdd_cst_bld_punct(bld, ")");
     cdd_cst_bld_punct(bld, ")");
   }
 }
 
 static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
-                                  int is_msc) {
+                                  emit_ctx_t *ctx) {
 
   int changes = 0;
   size_t k;
-  emit_ctx_t *ctx = is_msc ? g_msc_ctx : NULL;
+  int is_msc = ctx->is_msc;
+  emit_ctx_t *plain = &ctx->state->plain;
   cdd_cst_tree_t *tree = bld->tree;
 
   while (node) {
@@ -823,7 +878,7 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
       clone_token(bld->tree, node->tok, &ct);
       if (ct)
         cdd_cst_append_child_token(bld->target_node, ct);
-      changes += emit_ast_bld(node->args[0], bld, is_msc);
+      changes += emit_ast_bld(node->args[0], bld, ctx);
       if (node->close_tok) {
         cdd_token_t *ct_close = NULL;
         clone_token(bld->tree, node->close_tok, &ct_close);
@@ -928,17 +983,11 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
 
         clone_token(bld->tree, node->tok, &ct);
         if (ct) {
-          char *pooled = (char *)malloc(strlen(safe_name) + 1);
-          strcpy(pooled, safe_name);
-          if (tree->num_strings >= tree->string_capacity) {
-            tree->string_capacity =
-                tree->string_capacity == 0 ? 32 : tree->string_capacity * 2;
-            tree->string_pool = (char **)realloc(
-                tree->string_pool, tree->string_capacity * sizeof(char *));
+          const char *pooled = pool_string_safe(tree, safe_name);
+          if (pooled) {
+            ct->start = (const uint8_t *)pooled;
+            ct->length = strlen(pooled);
           }
-          tree->string_pool[tree->num_strings++] = pooled;
-          ct->start = (const uint8_t *)pooled;
-          ct->length = strlen(pooled);
           cdd_cst_append_child_token(bld->target_node, ct);
         }
         cdd_cst_bld_punct(bld, "(");
@@ -959,108 +1008,108 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
       }
 
       if (is_safe == 1 && node->num_args >= 2) {
-        changes += emit_ast_bld(node->args[0], bld, is_msc);
+        changes += emit_ast_bld(node->args[0], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        emit_inferred_size(bld, node->args[0]);
+        emit_inferred_size(ctx, bld, node->args[0]);
         for (k = 1; k < node->num_args; k++) {
           cdd_cst_bld_punct(bld, ",");
           cdd_cst_bld_space(bld);
-          changes += emit_ast_bld(node->args[k], bld, is_msc);
+          changes += emit_ast_bld(node->args[k], bld, ctx);
         }
       } else if (is_safe == 2 && node->num_args >= 3) {
-        changes += emit_ast_bld(node->args[0], bld, is_msc);
+        changes += emit_ast_bld(node->args[0], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        emit_inferred_size(bld, node->args[0]);
+        emit_inferred_size(ctx, bld, node->args[0]);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[1], bld, is_msc);
+        changes += emit_ast_bld(node->args[1], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
         cdd_cst_bld_ident(bld, "_TRUNCATE");
       } else if (is_safe == 3 && node->num_args >= 3) {
-        changes += emit_ast_bld(node->args[0], bld, is_msc);
+        changes += emit_ast_bld(node->args[0], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[1], bld, is_msc);
+        changes += emit_ast_bld(node->args[1], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
         cdd_cst_bld_ident(bld, "_TRUNCATE");
         for (k = 2; k < node->num_args; k++) {
           cdd_cst_bld_punct(bld, ",");
           cdd_cst_bld_space(bld);
-          changes += emit_ast_bld(node->args[k], bld, is_msc);
+          changes += emit_ast_bld(node->args[k], bld, ctx);
         }
       } else if (is_safe == 6 && node->num_args >= 3) {
-        changes += emit_ast_bld(node->args[0], bld, is_msc);
+        changes += emit_ast_bld(node->args[0], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        emit_inferred_size(bld, node->args[0]);
+        emit_inferred_size(ctx, bld, node->args[0]);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[1], bld, is_msc);
+        changes += emit_ast_bld(node->args[1], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[2], bld, is_msc);
+        changes += emit_ast_bld(node->args[2], bld, ctx);
       } else if (is_safe == 8 && node->num_args >= 3) {
-        changes += emit_ast_bld(node->args[0], bld, is_msc);
+        changes += emit_ast_bld(node->args[0], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[1], bld, is_msc);
+        changes += emit_ast_bld(node->args[1], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        emit_inferred_size(bld, node->args[1]);
+        emit_inferred_size(ctx, bld, node->args[1]);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[2], bld, is_msc);
+        changes += emit_ast_bld(node->args[2], bld, ctx);
       } else if (is_safe == 9 && node->num_args == 1) {
-        changes += emit_ast_bld(node->args[0], bld, is_msc);
+        changes += emit_ast_bld(node->args[0], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        emit_inferred_size(bld, node->args[0]);
+        emit_inferred_size(ctx, bld, node->args[0]);
       } else if (is_safe == 10 && node->num_args >= 5) {
-        changes += emit_ast_bld(node->args[0], bld, is_msc);
+        changes += emit_ast_bld(node->args[0], bld, ctx);
         for (k = 1; k < 5; k++) {
           cdd_cst_bld_punct(bld, ",");
           cdd_cst_bld_space(bld);
-          changes += emit_ast_bld(node->args[k], bld, is_msc);
+          changes += emit_ast_bld(node->args[k], bld, ctx);
           cdd_cst_bld_punct(bld, ",");
           cdd_cst_bld_space(bld);
           if (expr_is_null_or_zero(node->args[k])) {
             cdd_cst_bld_int(bld, 0);
           } else {
-            emit_inferred_size(bld, node->args[k]);
+            emit_inferred_size(ctx, bld, node->args[k]);
           }
         }
       } else if (is_safe == 11 && node->num_args >= 5) {
-        changes += emit_ast_bld(node->args[0], bld, is_msc);
+        changes += emit_ast_bld(node->args[0], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        emit_inferred_size(bld, node->args[0]);
+        emit_inferred_size(ctx, bld, node->args[0]);
         for (k = 1; k < node->num_args; k++) {
           cdd_cst_bld_punct(bld, ",");
           cdd_cst_bld_space(bld);
-          changes += emit_ast_bld(node->args[k], bld, is_msc);
+          changes += emit_ast_bld(node->args[k], bld, ctx);
         }
       } else if (is_safe == 19 && node->num_args == 3) {
         cdd_cst_bld_punct(bld, "(");
         cdd_cst_bld_ident(bld, "_gcvt_s");
         cdd_cst_bld_punct(bld, "(");
-        changes += emit_ast_bld(node->args[2], bld, is_msc);
+        changes += emit_ast_bld(node->args[2], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        emit_inferred_size(bld, node->args[2]);
+        emit_inferred_size(ctx, bld, node->args[2]);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[0], bld, is_msc);
+        changes += emit_ast_bld(node->args[0], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[1], bld, is_msc);
+        changes += emit_ast_bld(node->args[1], bld, ctx);
         cdd_cst_bld_punct(bld, ")");
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        emit_ast_bld_strip(node->args[2], bld, 0);
+        emit_ast_bld_strip(node->args[2], bld, plain);
         cdd_cst_bld_punct(bld, ")");
       } else if (is_safe == 20 && node->num_args == 3) {
         cdd_cst_bld_punct(bld, "(");
@@ -1070,11 +1119,11 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
         cdd_cst_bld_ident(bld, "NULL");
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[0], bld, is_msc);
+        changes += emit_ast_bld(node->args[0], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
         cdd_cst_bld_punct(bld, "(");
-        emit_inferred_size(bld, node->args[0]);
+        emit_inferred_size(ctx, bld, node->args[0]);
         if (strcmp(name, "wcstombs") == 0) {
           cdd_cst_bld_punct(bld, ")");
         } else {
@@ -1089,14 +1138,14 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
         }
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[1], bld, is_msc);
+        changes += emit_ast_bld(node->args[1], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[2], bld, is_msc);
+        changes += emit_ast_bld(node->args[2], bld, ctx);
         cdd_cst_bld_punct(bld, ")");
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        emit_ast_bld_strip(node->args[0], bld, 0);
+        emit_ast_bld_strip(node->args[0], bld, plain);
         cdd_cst_bld_punct(bld, ")");
       } else if (is_safe == 21 && node->num_args == 2) {
         cdd_cst_bld_punct(bld, "(");
@@ -1105,32 +1154,32 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
         cdd_cst_bld_ident(bld, "NULL");
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[0], bld, is_msc);
+        changes += emit_ast_bld(node->args[0], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        emit_inferred_size(bld, node->args[0]);
+        emit_inferred_size(ctx, bld, node->args[0]);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[1], bld, is_msc);
+        changes += emit_ast_bld(node->args[1], bld, ctx);
         cdd_cst_bld_punct(bld, ")");
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        emit_ast_bld_strip(node->args[0], bld, 0);
+        emit_ast_bld_strip(node->args[0], bld, plain);
         cdd_cst_bld_punct(bld, ")");
       } else if (is_safe == 22 && node->num_args == 3) {
         cdd_cst_bld_ident(bld, pool_string_safe(bld->tree, name));
         cdd_cst_bld_ident(bld, "_s");
         cdd_cst_bld_punct(bld, "(");
-        changes += emit_ast_bld(node->args[0], bld, is_msc);
+        changes += emit_ast_bld(node->args[0], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[1], bld, is_msc);
+        changes += emit_ast_bld(node->args[1], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        changes += emit_ast_bld(node->args[2], bld, is_msc);
+        changes += emit_ast_bld(node->args[2], bld, ctx);
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
-        emit_inferred_size(bld, node->args[2]);
+        emit_inferred_size(ctx, bld, node->args[2]);
         if (strcmp(name, "_wsearchenv") == 0) {
           cdd_cst_bld_space(bld);
           cdd_cst_bld_punct(bld, "/");
@@ -1142,7 +1191,7 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
         }
       } else if (is_safe == 23 && node->num_args == 1) {
         if (strcmp(name, "_wgetenv") == 0) {
-          if (ctx)
+          if (is_msc)
             ctx->needs_wgetenv_ptr = 1;
           cdd_cst_bld_punct(bld, "(");
           cdd_cst_bld_ident(bld, "_wdupenv_s");
@@ -1154,14 +1203,14 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
           cdd_cst_bld_ident(bld, "NULL");
           cdd_cst_bld_punct(bld, ",");
           cdd_cst_bld_space(bld);
-          changes += emit_ast_bld(node->args[0], bld, is_msc);
+          changes += emit_ast_bld(node->args[0], bld, ctx);
           cdd_cst_bld_punct(bld, ")");
           cdd_cst_bld_punct(bld, ",");
           cdd_cst_bld_space(bld);
           cdd_cst_bld_ident(bld, "__wgetenv_ptr");
           cdd_cst_bld_punct(bld, ")");
         } else {
-          if (ctx)
+          if (is_msc)
             ctx->needs_getenv_ptr = 1;
           cdd_cst_bld_punct(bld, "(");
           cdd_cst_bld_ident(bld, "_dupenv_s");
@@ -1173,7 +1222,7 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
           cdd_cst_bld_ident(bld, "NULL");
           cdd_cst_bld_punct(bld, ",");
           cdd_cst_bld_space(bld);
-          changes += emit_ast_bld(node->args[0], bld, is_msc);
+          changes += emit_ast_bld(node->args[0], bld, ctx);
           cdd_cst_bld_punct(bld, ")");
           cdd_cst_bld_punct(bld, ",");
           cdd_cst_bld_space(bld);
@@ -1230,7 +1279,7 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
         if (!split) {
           cdd_cst_bld_ident(bld, pool_string_safe(bld->tree, name));
           cdd_cst_bld_punct(bld, "(");
-          changes += emit_ast_bld(node->args[0], bld, is_msc);
+          changes += emit_ast_bld(node->args[0], bld, ctx);
         }
       } else if (is_safe == 25 &&
                  (node->num_args == 4 || node->num_args == 5)) {
@@ -1242,7 +1291,7 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
             cdd_cst_bld_punct(bld, ",");
             cdd_cst_bld_space(bld);
           }
-          changes += emit_ast_bld(node->args[k], bld, is_msc);
+          changes += emit_ast_bld(node->args[k], bld, ctx);
         }
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
@@ -1256,7 +1305,7 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
             cdd_cst_bld_punct(bld, ",");
             cdd_cst_bld_space(bld);
           }
-          changes += emit_ast_bld(node->args[k], bld, is_msc);
+          changes += emit_ast_bld(node->args[k], bld, ctx);
         }
         cdd_cst_bld_punct(bld, ",");
         cdd_cst_bld_space(bld);
@@ -1286,7 +1335,7 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
         for (k = 0; k < node->num_args; k++) {
           cdd_cst_bld_punct(bld, ",");
           cdd_cst_bld_space(bld);
-          changes += emit_ast_bld(node->args[k], bld, is_msc);
+          changes += emit_ast_bld(node->args[k], bld, ctx);
         }
         cdd_cst_bld_punct(bld, ")");
         cdd_cst_bld_punct(bld, ",");
@@ -1359,7 +1408,7 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
               cdd_cst_bld_punct(bld, ",");
               cdd_cst_bld_space(bld);
             }
-            changes += emit_ast_bld(node->args[k], bld, is_msc);
+            changes += emit_ast_bld(node->args[k], bld, ctx);
 
             if (k > format_idx) {
               int arg_idx = (int)(k - (format_idx + 1));
@@ -1371,14 +1420,14 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
                 cdd_cst_bld_punct(bld, ")");
                 cdd_cst_bld_ident(bld, "sizeof");
                 cdd_cst_bld_punct(bld, "(");
-                emit_ast_bld_strip_ampersand(node->args[k], bld, 0);
+                emit_ast_bld_strip_ampersand(node->args[k], bld, plain);
                 cdd_cst_bld_punct(bld, ")");
               }
             }
           }
         } else {
           if (node->num_args > 0) {
-            changes += emit_ast_bld(node->args[0], bld, is_msc);
+            changes += emit_ast_bld(node->args[0], bld, ctx);
           }
         }
       } else {
@@ -1387,7 +1436,7 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
             cdd_cst_bld_punct(bld, ",");
             cdd_cst_bld_space(bld);
           }
-          changes += emit_ast_bld(node->args[k], bld, is_msc);
+          changes += emit_ast_bld(node->args[k], bld, ctx);
         }
       }
 
@@ -1485,17 +1534,17 @@ static cdd_c_error_t emit_ast_bld(expr_t *node, cdd_cst_builder_t *bld,
         if (call->num_args >= 1) {
           cdd_cst_bld_punct(bld, ",");
           cdd_cst_bld_space(bld);
-          emit_ast_bld(call->args[0], bld, is_msc);
+          emit_ast_bld(call->args[0], bld, ctx);
         }
         if (call->num_args >= 2) {
           cdd_cst_bld_punct(bld, ",");
           cdd_cst_bld_space(bld);
-          emit_ast_bld(call->args[1], bld, is_msc);
+          emit_ast_bld(call->args[1], bld, ctx);
         }
         if (call->num_args >= 3) {
           cdd_cst_bld_punct(bld, ",");
           cdd_cst_bld_space(bld);
-          emit_ast_bld(call->args[2], bld, is_msc);
+          emit_ast_bld(call->args[2], bld, ctx);
         }
         cdd_cst_bld_punct(bld, ")");
         if (node->tok->trailing_trivia) {
@@ -1563,23 +1612,24 @@ cdd_c_error_t cdd_transform_safe_crt(cdd_cst_tree_t *tree,
   size_t i;
   cdd_c_error_t rc;
   int replaced_any;
+  safe_crt_state_t state;
 
   (void)config;
 
   if (!tree || !tree->root)
     return CDD_C_ERROR_INVALID_ARGUMENT;
 
-  if (current_tree != tree) {
-    arena_free_all();
-    current_tree = tree;
-  }
+  memset(&state, 0, sizeof(state));
+  state.tree = tree;
+  cdd_cst_arena_init(&state.scratch);
+  state.plain.state = &state;
 
   do {
     replaced_any = 0;
-    rc = cdd_cst_find_nodes_by_type(tree->root, CDD_CST_UNKNOWN, &res);
+    rc = cdd_cst_tree_find_nodes_by_type(tree, CDD_CST_UNKNOWN, &res);
     if (rc != 0) {
-      arena_free_all();
-      current_tree = NULL;
+      df_cache_clear(&state);
+      cdd_cst_arena_free(&state.scratch);
       return rc;
     }
 
@@ -1636,7 +1686,8 @@ cdd_c_error_t cdd_transform_safe_crt(cdd_cst_tree_t *tree,
       }
       /* printf("PROCESSING STATEMENT: %.*s\n", (int)first_tok->length,
              first_tok->start); */
-      parse_expr_ast(stmt, &idx, 0, &ast);
+      state.stmt = stmt;
+      parse_expr_ast(&state, stmt, &idx, 0, &ast);
       {
         int dummy_found = 0;
         rc = find_and_mark_fopen(ast, &dummy_found);
@@ -1649,12 +1700,12 @@ cdd_c_error_t cdd_transform_safe_crt(cdd_cst_tree_t *tree,
         C_CDD_LOG_DEBUG("check_unsupported_calls failed");
       }
 
-      chk_rc = check_needs_transform(ast);
+      chk_rc = check_needs_transform(&state, ast);
       if (chk_rc == CDD_C_ERROR_PARSE) {
         if (res.nodes)
           free(res.nodes);
-        arena_free_all();
-        current_tree = NULL;
+        df_cache_clear(&state);
+        cdd_cst_arena_free(&state.scratch);
         return CDD_C_ERROR_PARSE;
       }
       if (chk_rc) {
@@ -1665,8 +1716,9 @@ cdd_c_error_t cdd_transform_safe_crt(cdd_cst_tree_t *tree,
 
         cdd_trivia_t *saved_trivia =
             first_tok ? first_tok->leading_trivia : NULL;
-        emit_ctx_t msc_ctx = {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+        emit_ctx_t msc_ctx = {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, NULL};
 
+        msc_ctx.state = &state;
         get_indent_string(first_tok, indent);
 
         if (first_tok)
@@ -1687,15 +1739,13 @@ cdd_c_error_t cdd_transform_safe_crt(cdd_cst_tree_t *tree,
         if (rc != CDD_C_SUCCESS)
           goto loop_err;
         cdd_cst_builder_init(&msc_bld, tree, msc_node);
-        g_msc_ctx = &msc_ctx;
-        msc_changes = emit_ast_bld(ast, &msc_bld, 1);
-        g_msc_ctx = NULL;
+        msc_changes = emit_ast_bld(ast, &msc_bld, &msc_ctx);
 
         rc = cdd_cst_alloc_node(CDD_CST_UNKNOWN, &else_node);
         if (rc != CDD_C_SUCCESS)
           goto loop_err;
         cdd_cst_builder_init(&else_bld, tree, else_node);
-        emit_ast_bld(ast, &else_bld, 0);
+        emit_ast_bld(ast, &else_bld, &state.plain);
 
         if (first_tok)
           first_tok->leading_trivia = saved_trivia;
@@ -1916,14 +1966,14 @@ cdd_c_error_t cdd_transform_safe_crt(cdd_cst_tree_t *tree,
     free(res.nodes);
   } while (replaced_any);
 
-  arena_free_all();
-  current_tree = NULL;
+  df_cache_clear(&state);
+  cdd_cst_arena_free(&state.scratch);
   return CDD_C_SUCCESS;
 
 loop_err:
   if (res.nodes)
     free(res.nodes);
-  arena_free_all();
-  current_tree = NULL;
+  df_cache_clear(&state);
+  cdd_cst_arena_free(&state.scratch);
   return rc;
 }